@@ -0,0 +1,394 @@
+package cmd
+
+import (
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"runtime"
+	"slices"
+	"sync"
+	"syscall"
+	"text/tabwriter"
+	"time"
+
+	pion "github.com/pion/webrtc/v4"
+	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/streaming"
+	"github.com/spf13/cobra"
+)
+
+const benchStreamID = "bench"
+
+// benchOptions configures a streaming load test.
+type benchOptions struct {
+	bitrateKbps int
+	fps         int
+	gop         int
+	webrtcPeers int
+	rtspPeers   int
+	warmup      time.Duration
+	duration    time.Duration
+}
+
+// CreateBenchCmd creates the bench command.
+func CreateBenchCmd() *cobra.Command {
+	var opts benchOptions
+
+	cmd := &cobra.Command{
+		Use:   "bench",
+		Short: "Load-test the streaming server",
+		Long: `Starts the streaming server in-process, pushes a synthetic H264 RTSP producer at the given bitrate ` +
+			`and attaches WebRTC and RTSP viewers. Reports CPU, allocations, send latency percentiles and drops ` +
+			`per viewer. Viewers run in the same process, so CPU and allocation figures include their receive path.`,
+		Run: func(_ *cobra.Command, _ []string) {
+			logging.Initialize(logging.Config{Level: "warn", Format: "text"})
+
+			report, err := runBench(opts)
+			if err != nil {
+				fmt.Fprintln(os.Stderr, "bench failed:", err)
+				os.Exit(1)
+			}
+			report.print(os.Stdout)
+		},
+	}
+
+	cmd.Flags().IntVar(&opts.bitrateKbps, "bitrate", 8000, "Producer bitrate in kbit/s")
+	cmd.Flags().IntVar(&opts.fps, "fps", 30, "Producer frame rate")
+	cmd.Flags().IntVar(&opts.gop, "gop", 60, "Frames per GOP (IDR interval)")
+	cmd.Flags().IntVar(&opts.webrtcPeers, "webrtc", 4, "Number of WebRTC viewers")
+	cmd.Flags().IntVar(&opts.rtspPeers, "rtsp", 1, "Number of RTSP viewers")
+	cmd.Flags().DurationVar(&opts.warmup, "warmup", 2*time.Second, "Time to settle before measuring")
+	cmd.Flags().DurationVar(&opts.duration, "duration", 20*time.Second, "Measurement duration")
+	return cmd
+}
+
+// viewerStats collects latency and loss for one viewer during the
+// measurement window. Latency is the time from the producer writing a packet
+// to the viewer reading it.
+type viewerStats struct {
+	mu        sync.Mutex
+	recording bool
+	latencies []time.Duration
+	first     uint32 // lowest producer packet index received
+	last      uint32 // highest producer packet index received
+}
+
+// record accounts for a received synthetic packet. Packets without the bench
+// trailer (parameter sets injected by the hub) are ignored.
+func (s *viewerStats) record(payload []byte, now time.Time) {
+	if len(payload) < benchStampSize || payload[0]&0x1F != 28 {
+		return
+	}
+	stamp := payload[len(payload)-benchStampSize:]
+	sent := time.Unix(0, int64(binary.BigEndian.Uint64(stamp)))
+	index := binary.BigEndian.Uint32(stamp[8:])
+
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if !s.recording {
+		return
+	}
+	if len(s.latencies) == 0 || index < s.first {
+		s.first = index
+	}
+	s.last = max(s.last, index)
+	s.latencies = append(s.latencies, now.Sub(sent))
+}
+
+func (s *viewerStats) setRecording(recording bool) {
+	s.mu.Lock()
+	s.recording = recording
+	s.mu.Unlock()
+}
+
+type benchViewer struct {
+	name   string
+	kind   string
+	stats  *viewerStats
+	closer io.Closer
+}
+
+// startWebRTCViewer connects a recvonly pion peer through the WebRTC manager,
+// the same path a browser takes.
+func startWebRTCViewer(manager *streaming.WebRTCManager, streamID string, stats *viewerStats) (io.Closer, error) {
+	m := &pion.MediaEngine{}
+	if err := m.RegisterDefaultCodecs(); err != nil {
+		return nil, err
+	}
+	pc, err := pion.NewAPI(pion.WithMediaEngine(m)).NewPeerConnection(pion.Configuration{})
+	if err != nil {
+		return nil, err
+	}
+	if _, err := pc.AddTransceiverFromKind(pion.RTPCodecTypeVideo, pion.RTPTransceiverInit{
+		Direction: pion.RTPTransceiverDirectionRecvonly,
+	}); err != nil {
+		_ = pc.Close()
+		return nil, err
+	}
+
+	connected := make(chan struct{})
+	var once sync.Once
+	pc.OnConnectionStateChange(func(state pion.PeerConnectionState) {
+		if state == pion.PeerConnectionStateConnected {
+			once.Do(func() { close(connected) })
+		}
+	})
+	pc.OnTrack(func(track *pion.TrackRemote, _ *pion.RTPReceiver) {
+		buf := make([]byte, 1500)
+		for {
+			n, _, err := track.Read(buf)
+			if err != nil {
+				return
+			}
+			if n > 12 {
+				stats.record(rtpPayload(buf[:n]), time.Now())
+			}
+		}
+	})
+
+	offer, err := pc.CreateOffer(nil)
+	if err != nil {
+		_ = pc.Close()
+		return nil, err
+	}
+	gathered := pion.GatheringCompletePromise(pc)
+	if err := pc.SetLocalDescription(offer); err != nil {
+		_ = pc.Close()
+		return nil, err
+	}
+	<-gathered
+
+	answer, err := manager.CreateConsumer(streamID, pc.LocalDescription().SDP)
+	if err != nil {
+		_ = pc.Close()
+		return nil, err
+	}
+	if err := pc.SetRemoteDescription(pion.SessionDescription{Type: pion.SDPTypeAnswer, SDP: answer}); err != nil {
+		_ = pc.Close()
+		return nil, err
+	}
+
+	select {
+	case <-connected:
+		return pc, nil
+	case <-time.After(10 * time.Second):
+		_ = pc.Close()
+		return nil, errors.New("WebRTC viewer did not connect")
+	}
+}
+
+// rtpPayload returns the payload of a marshalled RTP packet without
+// allocating a packet.
+func rtpPayload(b []byte) []byte {
+	offset := 12 + int(b[0]&0x0F)*4
+	if b[0]&0x10 != 0 && len(b) >= offset+4 {
+		offset += 4 + int(binary.BigEndian.Uint16(b[offset+2:]))*4
+	}
+	if offset > len(b) {
+		return nil
+	}
+	end := len(b)
+	if b[0]&0x20 != 0 {
+		end -= int(b[len(b)-1])
+	}
+	if end < offset {
+		return nil
+	}
+	return b[offset:end]
+}
+
+// benchSample is a process resource snapshot.
+type benchSample struct {
+	at      time.Time
+	cpu     time.Duration
+	mallocs uint64
+	bytes   uint64
+	sent    uint32
+}
+
+func takeBenchSample(producer *benchProducer) benchSample {
+	var usage syscall.Rusage
+	_ = syscall.Getrusage(syscall.RUSAGE_SELF, &usage)
+	var mem runtime.MemStats
+	runtime.ReadMemStats(&mem)
+
+	return benchSample{
+		at:      time.Now(),
+		cpu:     time.Duration(usage.Utime.Nano() + usage.Stime.Nano()),
+		mallocs: mem.Mallocs,
+		bytes:   mem.TotalAlloc,
+		sent:    producer.sent.Load(),
+	}
+}
+
+func runBench(opts benchOptions) (*benchReport, error) {
+	if opts.fps <= 0 || opts.gop <= 0 || opts.bitrateKbps <= 0 {
+		return nil, errors.New("bitrate, fps and gop must be positive")
+	}
+
+	logger := logging.GetLogger("bench")
+	hub := streaming.NewHub(logger)
+	server := streaming.NewServer(hub, logger)
+	if err := server.Start("127.0.0.1:0"); err != nil {
+		return nil, err
+	}
+	defer func() { _ = server.Stop() }()
+
+	manager := streaming.NewWebRTCManager(hub, streaming.WebRTCConfig{}, logger)
+	defer manager.Stop()
+
+	addr := server.Addr().String()
+	producer, err := startBenchProducer(addr, benchStreamID, opts.bitrateKbps*1000, opts.fps, opts.gop)
+	if err != nil {
+		return nil, fmt.Errorf("start producer: %w", err)
+	}
+	defer producer.Close()
+
+	viewers := make([]*benchViewer, 0, opts.webrtcPeers+opts.rtspPeers)
+	defer func() {
+		for _, viewer := range viewers {
+			_ = viewer.closer.Close()
+		}
+	}()
+
+	for i := range opts.webrtcPeers {
+		stats := &viewerStats{}
+		closer, err := startWebRTCViewer(manager, benchStreamID, stats)
+		if err != nil {
+			return nil, fmt.Errorf("start WebRTC viewer %d: %w", i, err)
+		}
+		viewers = append(viewers, &benchViewer{name: fmt.Sprintf("webrtc-%d", i), kind: "webrtc", stats: stats, closer: closer})
+	}
+	for i := range opts.rtspPeers {
+		stats := &viewerStats{}
+		closer, err := startRTSPViewer(addr, benchStreamID, stats)
+		if err != nil {
+			return nil, fmt.Errorf("start RTSP viewer %d: %w", i, err)
+		}
+		viewers = append(viewers, &benchViewer{name: fmt.Sprintf("rtsp-%d", i), kind: "rtsp", stats: stats, closer: closer})
+	}
+
+	time.Sleep(opts.warmup)
+
+	for _, viewer := range viewers {
+		viewer.stats.setRecording(true)
+	}
+	start := takeBenchSample(producer)
+	time.Sleep(opts.duration)
+	end := takeBenchSample(producer)
+	for _, viewer := range viewers {
+		viewer.stats.setRecording(false)
+	}
+
+	return newBenchReport(opts, viewers, start, end), nil
+}
+
+// benchReport summarizes a load test.
+type benchReport struct {
+	opts      benchOptions
+	elapsed   time.Duration
+	sent      uint32
+	cpu       time.Duration
+	mallocs   uint64
+	bytes     uint64
+	viewers   []viewerResult
+	summaries []viewerResult
+}
+
+type viewerResult struct {
+	name     string
+	kind     string
+	received int
+	dropped  int
+	p50      time.Duration
+	p90      time.Duration
+	p99      time.Duration
+	max      time.Duration
+}
+
+func newBenchReport(opts benchOptions, viewers []*benchViewer, start, end benchSample) *benchReport {
+	report := &benchReport{
+		opts:    opts,
+		elapsed: end.at.Sub(start.at),
+		sent:    end.sent - start.sent,
+		cpu:     end.cpu - start.cpu,
+		mallocs: end.mallocs - start.mallocs,
+		bytes:   end.bytes - start.bytes,
+	}
+
+	byKind := make(map[string][]time.Duration)
+	drops := make(map[string]int)
+	counts := make(map[string]int)
+	for _, viewer := range viewers {
+		viewer.stats.mu.Lock()
+		latencies := slices.Clone(viewer.stats.latencies)
+		var dropped int
+		if len(latencies) > 0 {
+			dropped = max(int(viewer.stats.last-viewer.stats.first+1)-len(latencies), 0)
+		} else {
+			dropped = int(report.sent)
+		}
+		viewer.stats.mu.Unlock()
+
+		report.viewers = append(report.viewers, summarizeLatencies(viewer.name, viewer.kind, latencies, dropped))
+		byKind[viewer.kind] = append(byKind[viewer.kind], latencies...)
+		drops[viewer.kind] += dropped
+		counts[viewer.kind]++
+	}
+	for _, kind := range []string{"webrtc", "rtsp"} {
+		if counts[kind] > 0 {
+			report.summaries = append(report.summaries, summarizeLatencies("all", kind, byKind[kind], drops[kind]))
+		}
+	}
+	return report
+}
+
+func summarizeLatencies(name, kind string, latencies []time.Duration, dropped int) viewerResult {
+	result := viewerResult{name: name, kind: kind, received: len(latencies), dropped: dropped}
+	if len(latencies) == 0 {
+		return result
+	}
+	slices.Sort(latencies)
+	percentile := func(p float64) time.Duration {
+		return latencies[int(float64(len(latencies)-1)*p)]
+	}
+	result.p50 = percentile(0.50)
+	result.p90 = percentile(0.90)
+	result.p99 = percentile(0.99)
+	result.max = latencies[len(latencies)-1]
+	return result
+}
+
+func (r *benchReport) print(w io.Writer) {
+	seconds := r.elapsed.Seconds()
+	peers := max(len(r.viewers), 1)
+	cpuPercent := r.cpu.Seconds() / seconds * 100
+	forwarded := 0
+	for _, viewer := range r.viewers {
+		forwarded += viewer.received
+	}
+
+	fmt.Fprintf(w, "Producer:    %d kbit/s, %d fps, GOP %d, %d packets (%.0f/s)\n",
+		r.opts.bitrateKbps, r.opts.fps, r.opts.gop, r.sent, float64(r.sent)/seconds)
+	fmt.Fprintf(w, "Viewers:     %d WebRTC, %d RTSP, measured for %s\n",
+		r.opts.webrtcPeers, r.opts.rtspPeers, r.elapsed.Round(time.Millisecond))
+	fmt.Fprintf(w, "CPU:         %.1f%% of one core, %.2f%% per viewer\n", cpuPercent, cpuPercent/float64(peers))
+	fmt.Fprintf(w, "Allocations: %.0f/s, %.1f KiB/s, %.2f per forwarded packet\n",
+		float64(r.mallocs)/seconds, float64(r.bytes)/1024/seconds, float64(r.mallocs)/float64(max(forwarded, 1)))
+	fmt.Fprintln(w)
+
+	tw := tabwriter.NewWriter(w, 0, 0, 2, ' ', 0)
+	fmt.Fprintln(tw, "VIEWER\tTYPE\tRECEIVED\tDROPPED\tP50\tP90\tP99\tMAX")
+	for _, result := range slices.Concat(r.viewers, r.summaries) {
+		fmt.Fprintf(tw, "%s\t%s\t%d\t%d\t%s\t%s\t%s\t%s\n",
+			result.name, result.kind, result.received, result.dropped,
+			formatLatency(result.p50), formatLatency(result.p90), formatLatency(result.p99), formatLatency(result.max))
+	}
+	_ = tw.Flush()
+}
+
+func formatLatency(d time.Duration) string {
+	return d.Round(time.Microsecond).String()
+}
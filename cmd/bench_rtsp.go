@@ -0,0 +1,298 @@
+package cmd
+
+import (
+	"bufio"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"net"
+	"net/textproto"
+	"strconv"
+	"strings"
+	"sync/atomic"
+	"time"
+
+	"github.com/pion/rtp"
+)
+
+// benchSPSPPS are the parameter sets announced by the synthetic producer.
+// The hub injects them before every IDR, like for a real FFmpeg stream.
+const benchSPSPPS = "Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA=="
+
+// benchStampSize is the trailer appended to every synthetic packet payload:
+// send time (unix nanoseconds) followed by the producer's packet index.
+const benchStampSize = 12
+
+// benchPayloadSize is the RTP payload size of synthetic packets.
+const benchPayloadSize = 1200
+
+// rtspClient is a minimal RTSP/1.0 client over one TCP connection with
+// interleaved RTP, just enough to push to and play from the streaming server.
+type rtspClient struct {
+	conn    net.Conn
+	reader  *bufio.Reader
+	cseq    int
+	session string
+}
+
+func dialRTSP(addr string) (*rtspClient, error) {
+	conn, err := net.DialTimeout("tcp", addr, 5*time.Second)
+	if err != nil {
+		return nil, err
+	}
+	return &rtspClient{conn: conn, reader: bufio.NewReaderSize(conn, 64<<10)}, nil
+}
+
+// request sends an RTSP request and returns the response headers and body.
+func (c *rtspClient) request(method, url string, headers map[string]string, body string) (textproto.MIMEHeader, string, error) {
+	c.cseq++
+
+	var b strings.Builder
+	fmt.Fprintf(&b, "%s %s RTSP/1.0\r\nCSeq: %d\r\n", method, url, c.cseq)
+	if c.session != "" {
+		fmt.Fprintf(&b, "Session: %s\r\n", c.session)
+	}
+	for key, value := range headers {
+		fmt.Fprintf(&b, "%s: %s\r\n", key, value)
+	}
+	if body != "" {
+		fmt.Fprintf(&b, "Content-Length: %d\r\n", len(body))
+	}
+	b.WriteString("\r\n")
+	b.WriteString(body)
+
+	if _, err := io.WriteString(c.conn, b.String()); err != nil {
+		return nil, "", err
+	}
+
+	tp := textproto.NewReader(c.reader)
+	status, err := tp.ReadLine()
+	if err != nil {
+		return nil, "", err
+	}
+	header, err := tp.ReadMIMEHeader()
+	if err != nil && !errors.Is(err, io.EOF) {
+		return nil, "", err
+	}
+	if !strings.HasPrefix(status, "RTSP/1.0 200") {
+		return nil, "", fmt.Errorf("%s %s: %s", method, url, status)
+	}
+
+	var respBody []byte
+	if length, _ := strconv.Atoi(header.Get("Content-Length")); length > 0 {
+		respBody = make([]byte, length)
+		if _, err := io.ReadFull(c.reader, respBody); err != nil {
+			return nil, "", err
+		}
+	}
+
+	if session := header.Get("Session"); session != "" {
+		c.session, _, _ = strings.Cut(session, ";")
+	}
+	return header, string(respBody), nil
+}
+
+// readFrame reads the next interleaved frame, skipping anything else the
+// server sends on the connection.
+func (c *rtspClient) readFrame(buf []byte) (channel byte, frame []byte, err error) {
+	for {
+		marker, err := c.reader.ReadByte()
+		if err != nil {
+			return 0, nil, err
+		}
+		if marker != '$' {
+			continue
+		}
+
+		var header [3]byte
+		if _, err := io.ReadFull(c.reader, header[:]); err != nil {
+			return 0, nil, err
+		}
+		size := int(binary.BigEndian.Uint16(header[1:]))
+		if size > len(buf) {
+			buf = make([]byte, size)
+		}
+		if _, err := io.ReadFull(c.reader, buf[:size]); err != nil {
+			return 0, nil, err
+		}
+		return header[0], buf[:size], nil
+	}
+}
+
+func (c *rtspClient) Close() error {
+	return c.conn.Close()
+}
+
+// benchProducer pushes a synthetic H264 stream to the streaming server, as
+// FFmpeg does with ANNOUNCE/RECORD. Frames are FU-A fragmented; the first
+// frame of each GOP is an IDR.
+type benchProducer struct {
+	client  *rtspClient
+	bitrate int // bits per second
+	fps     int
+	gop     int
+	sent    atomic.Uint32
+	done    chan struct{}
+}
+
+func startBenchProducer(addr, streamID string, bitrate, fps, gop int) (*benchProducer, error) {
+	client, err := dialRTSP(addr)
+	if err != nil {
+		return nil, err
+	}
+
+	url := "rtsp://" + addr + "/" + streamID
+	sdp := "v=0\r\n" +
+		"o=- 0 0 IN IP4 127.0.0.1\r\n" +
+		"s=videonode bench\r\n" +
+		"c=IN IP4 127.0.0.1\r\n" +
+		"t=0 0\r\n" +
+		"m=video 0 RTP/AVP 96\r\n" +
+		"a=rtpmap:96 H264/90000\r\n" +
+		"a=fmtp:96 packetization-mode=1;profile-level-id=42e01f;sprop-parameter-sets=" + benchSPSPPS + "\r\n" +
+		"a=control:trackID=0\r\n"
+
+	steps := []struct {
+		method, url string
+		headers     map[string]string
+		body        string
+	}{
+		{"OPTIONS", url, nil, ""},
+		{"ANNOUNCE", url, map[string]string{"Content-Type": "application/sdp"}, sdp},
+		{"SETUP", url + "/trackID=0", map[string]string{"Transport": "RTP/AVP/TCP;unicast;interleaved=0-1;mode=record"}, ""},
+		{"RECORD", url, nil, ""},
+	}
+	for _, step := range steps {
+		if _, _, err := client.request(step.method, step.url, step.headers, step.body); err != nil {
+			_ = client.Close()
+			return nil, err
+		}
+	}
+
+	p := &benchProducer{
+		client:  client,
+		bitrate: bitrate,
+		fps:     fps,
+		gop:     gop,
+		done:    make(chan struct{}),
+	}
+	go func() { _, _ = io.Copy(io.Discard, client.reader) }() // drain RTCP
+	go p.run()
+	return p, nil
+}
+
+func (p *benchProducer) run() {
+	ticker := time.NewTicker(time.Second / time.Duration(p.fps))
+	defer ticker.Stop()
+
+	frameBytes := max(p.bitrate/8/p.fps, benchPayloadSize)
+	packet := rtp.Packet{Header: rtp.Header{Version: 2, PayloadType: 96, SSRC: 0x5eed}}
+	payload := make([]byte, benchPayloadSize)
+	buf := make([]byte, 4+12+benchPayloadSize)
+
+	for frame := 0; ; frame++ {
+		select {
+		case <-p.done:
+			return
+		case <-ticker.C:
+		}
+
+		nalType := byte(1) // non-IDR slice
+		if frame%p.gop == 0 {
+			nalType = 5
+		}
+		packet.Timestamp = uint32(frame * 90000 / p.fps)
+
+		fragments := (frameBytes + benchPayloadSize - 1) / benchPayloadSize
+		for i := range fragments {
+			fuHeader := nalType
+			if i == 0 {
+				fuHeader |= 0x80
+			}
+			if i == fragments-1 {
+				fuHeader |= 0x40
+			}
+			payload[0] = 0x60 | 28 // FU-A indicator, NRI 3
+			payload[1] = fuHeader
+
+			index := p.sent.Add(1)
+			stamp := payload[len(payload)-benchStampSize:]
+			binary.BigEndian.PutUint64(stamp, uint64(time.Now().UnixNano()))
+			binary.BigEndian.PutUint32(stamp[8:], index)
+
+			packet.SequenceNumber++
+			packet.Marker = i == fragments-1
+			packet.Payload = payload
+
+			n, err := packet.MarshalTo(buf[4:])
+			if err != nil {
+				return
+			}
+			buf[0] = '$'
+			buf[1] = 0
+			binary.BigEndian.PutUint16(buf[2:], uint16(n))
+			if _, err := p.client.conn.Write(buf[:4+n]); err != nil {
+				return
+			}
+		}
+	}
+}
+
+// Close stops the producer and disconnects it.
+func (p *benchProducer) Close() {
+	close(p.done)
+	_ = p.client.Close()
+}
+
+// startRTSPViewer plays the stream over RTSP with interleaved TCP.
+func startRTSPViewer(addr, streamID string, stats *viewerStats) (io.Closer, error) {
+	client, err := dialRTSP(addr)
+	if err != nil {
+		return nil, err
+	}
+
+	url := "rtsp://" + addr + "/" + streamID
+	_, sdp, err := client.request("DESCRIBE", url, map[string]string{"Accept": "application/sdp"}, "")
+	if err != nil {
+		_ = client.Close()
+		return nil, err
+	}
+
+	control := "trackID=0"
+	for line := range strings.Lines(sdp) {
+		if value, found := strings.CutPrefix(strings.TrimSpace(line), "a=control:"); found && value != "*" {
+			control = value
+			break
+		}
+	}
+	setupURL := control
+	if !strings.HasPrefix(control, "rtsp://") {
+		setupURL = url + "/" + control
+	}
+
+	if _, _, err := client.request("SETUP", setupURL, map[string]string{"Transport": "RTP/AVP/TCP;unicast;interleaved=0-1"}, ""); err != nil {
+		_ = client.Close()
+		return nil, err
+	}
+	if _, _, err := client.request("PLAY", url, nil, ""); err != nil {
+		_ = client.Close()
+		return nil, err
+	}
+
+	go func() {
+		buf := make([]byte, 64<<10)
+		var packet rtp.Packet
+		for {
+			channel, frame, err := client.readFrame(buf)
+			if err != nil {
+				return
+			}
+			if channel != 0 || packet.Unmarshal(frame) != nil {
+				continue
+			}
+			stats.record(packet.Payload, time.Now())
+		}
+	}()
+	return client, nil
+}
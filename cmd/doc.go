@@ -1,2 +1,2 @@
-// Package cmd implements CLI subcommands for encoder validation and stream management.
+// Package cmd implements CLI subcommands for encoder validation, stream management and load testing.
 package cmd
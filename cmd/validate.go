@@ -13,16 +13,20 @@ func CreateValidateEncodersCmd() *cobra.Command {
 		Use:   "validate-encoders",
 		Short: "Validate hardware encoder availability",
 		Long: `This command tests hardware encoders (H.264 and H.265) to determine which ones actually work ` +
-			`on the current system. Results are saved to streams.toml.`,
+			`on the current system. Results are saved to streams.toml.\n\n` +
+			`Encoders are tested in parallel. Results are reused for encoders whose FFmpeg version, ` +
+			`kernel driver and device haven't changed since the last run, unless --force is given.`,
 		Run: func(cmd *cobra.Command, _ []string) {
 			quiet, _ := cmd.Flags().GetBool("quiet")
+			force, _ := cmd.Flags().GetBool("force")
 			// Create validation service for encoder validation
 			streamStore := store.NewTOML("streams.toml")
 			validationService := streams.NewValidationService(streamStore)
-			encoders.RunValidateCommandWithOptions(validationService, quiet)
+			encoders.RunValidateCommandWithOptions(validationService, quiet, force)
 		},
 	}
 
 	cmd.Flags().BoolP("quiet", "q", false, "Suppress detailed validation progress output")
+	cmd.Flags().BoolP("force", "f", false, "Re-test all encoders, ignoring cached results")
 	return cmd
 }
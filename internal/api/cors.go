@@ -10,10 +10,11 @@ import (
 
 // CORSConfig holds CORS configuration.
 type CORSConfig struct {
-	AllowOrigin  string
-	AllowMethods []string
-	AllowHeaders []string
-	MaxAge       int
+	AllowOrigin   string
+	AllowMethods  []string
+	AllowHeaders  []string
+	ExposeHeaders []string
+	MaxAge        int
 }
 
 // DefaultCORSConfig returns permissive CORS config for internal tools.
@@ -22,7 +23,9 @@ func DefaultCORSConfig() CORSConfig {
 		AllowOrigin:  "*",
 		AllowMethods: []string{"GET", "POST", "PUT", "DELETE", "OPTIONS", "PATCH"},
 		AllowHeaders: []string{"Content-Type", "Authorization", "X-Requested-With", "Accept", "Origin"},
-		MaxAge:       86400,
+		// WHEP and bundle sessions are addressed by their Location header
+		ExposeHeaders: []string{"Location"},
+		MaxAge:        86400,
 	}
 }
 
@@ -31,6 +34,7 @@ func NewCORSMiddleware(config CORSConfig) func(huma.Context, func(huma.Context))
 	// Pre-compute header values
 	allowMethods := strings.Join(config.AllowMethods, ", ")
 	allowHeaders := strings.Join(config.AllowHeaders, ", ")
+	exposeHeaders := strings.Join(config.ExposeHeaders, ", ")
 	maxAge := strconv.Itoa(config.MaxAge)
 
 	return func(ctx huma.Context, next func(huma.Context)) {
@@ -38,6 +42,9 @@ func NewCORSMiddleware(config CORSConfig) func(huma.Context, func(huma.Context))
 		ctx.SetHeader("Access-Control-Allow-Origin", config.AllowOrigin)
 		ctx.SetHeader("Access-Control-Allow-Methods", allowMethods)
 		ctx.SetHeader("Access-Control-Allow-Headers", allowHeaders)
+		if exposeHeaders != "" {
+			ctx.SetHeader("Access-Control-Expose-Headers", exposeHeaders)
+		}
 		ctx.SetHeader("Access-Control-Max-Age", maxAge)
 
 		// Handle preflight OPTIONS requests
@@ -38,7 +38,7 @@ type DeviceResolutionInput struct {
 // DeviceCaptureBody represents the request body for device capture.
 type DeviceCaptureBody struct {
 	Resolution string  `json:"resolution,omitempty" example:"1920x1080" doc:"Optional resolution"`
-	Delay      float64 `json:"delay,omitempty" example:"2.0" doc:"Delay before capture in seconds"`
+	Delay      float64 `json:"delay,omitempty" example:"2.0" doc:"Delay before direct capture in seconds. Not applied to devices with a running stream, whose latest keyframe is used"`
 }
 
 // DeviceCaptureInput combines path parameters and request body.
@@ -185,9 +185,8 @@ func translateCapabilities(caps uint32) []string {
 	return capabilities
 }
 
-// GetDevicesData fetches the list of available video devices.
-func GetDevicesData() (models.DeviceData, error) {
-	detector := devices.NewDetector()
+// GetDevicesData fetches the list of available video devices from detector.
+func GetDevicesData(detector devices.DeviceDetector) (models.DeviceData, error) {
 	deviceList, err := detector.FindDevices()
 	if err != nil {
 		return models.DeviceData{}, fmt.Errorf("failed to find devices: %w", err)
@@ -213,9 +212,8 @@ func GetDevicesData() (models.DeviceData, error) {
 	}, nil
 }
 
-// GetDeviceCapabilities fetches all capabilities for a specific device.
-func GetDeviceCapabilities(devicePath string) (models.DeviceCapabilitiesData, error) {
-	detector := devices.NewDetector()
+// GetDeviceCapabilities fetches all capabilities for a specific device from detector.
+func GetDeviceCapabilities(detector devices.DeviceDetector, devicePath string) (models.DeviceCapabilitiesData, error) {
 	deviceFormats, err := detector.GetDeviceFormats(devicePath)
 	if err != nil {
 		return models.DeviceCapabilitiesData{}, fmt.Errorf("failed to get device formats: %w", err)
@@ -258,7 +256,7 @@ func (s *Server) registerDeviceRoutes() {
 		Security:    withAuth(),
 		Errors:      []int{401, 500},
 	}, func(_ context.Context, _ *struct{}) (*models.DeviceResponse, error) {
-		data, err := GetDevicesData()
+		data, err := GetDevicesData(s.deviceDetector)
 		if err != nil {
 			return nil, huma.Error500InternalServerError("Failed to get devices", err)
 		}
@@ -283,7 +281,7 @@ func (s *Server) registerDeviceRoutes() {
 			return nil, huma.Error404NotFound("Device not found", err)
 		}
 
-		data, err := GetDeviceCapabilities(devicePath)
+		data, err := GetDeviceCapabilities(s.deviceDetector, devicePath)
 		if err != nil {
 			return nil, huma.Error500InternalServerError("Failed to get device capabilities", err)
 		}
@@ -314,8 +312,7 @@ func (s *Server) registerDeviceRoutes() {
 			return nil, huma.Error400BadRequest("Invalid format name", err)
 		}
 
-		detector := devices.NewDetector()
-		resolutions, err := detector.GetDeviceResolutions(devicePath, pixelFormat)
+		resolutions, err := s.deviceDetector.GetDeviceResolutions(devicePath, pixelFormat)
 		if err != nil {
 			return nil, huma.Error500InternalServerError("Failed to get device resolutions", err)
 		}
@@ -367,8 +364,7 @@ func (s *Server) registerDeviceRoutes() {
 			return nil, huma.Error400BadRequest("Invalid height parameter", err)
 		}
 
-		detector := devices.NewDetector()
-		framerates, err := detector.GetDeviceFramerates(devicePath, pixelFormat, uint32(width), uint32(height))
+		framerates, err := s.deviceDetector.GetDeviceFramerates(devicePath, pixelFormat, uint32(width), uint32(height))
 		if err != nil {
 			return nil, huma.Error500InternalServerError("Failed to get device framerates", err)
 		}
@@ -398,12 +394,12 @@ func (s *Server) registerDeviceRoutes() {
 		Method:        http.MethodPost,
 		Path:          "/api/devices/{device_id}/capture",
 		Summary:       "Capture Screenshot",
-		Description:   "Capture a screenshot from the device. Results are sent via SSE events.",
+		Description:   "Capture a screenshot from the device. Devices with a running stream are served from the stream's latest keyframe, without the delay; others, and streams that can't supply a keyframe, are captured directly. Results are sent via SSE events.",
 		Tags:          []string{"devices"},
 		DefaultStatus: http.StatusAccepted, // 202 Accepted
 		Security:      withAuth(),
 		Errors:        []int{401, 404},
-	}, func(_ context.Context, input *DeviceCaptureInput) (*models.CaptureResponse, error) {
+	}, func(ctx context.Context, input *DeviceCaptureInput) (*models.CaptureResponse, error) {
 		// Resolve device ID to device path
 		devicePath, err := resolveDevicePath(input.DeviceID)
 		if err != nil {
@@ -415,18 +411,36 @@ func (s *Server) registerDeviceRoutes() {
 			return nil, huma.Error404NotFound(fmt.Sprintf("Device %s does not exist", devicePath), nil)
 		}
 
+		// A running stream owns the device: snapshot its latest keyframe instead
+		// of competing with it for the capture hardware
+		var streamID string
+		if s.options.StreamingHub != nil {
+			streamID = s.deviceStream(ctx, input.DeviceID)
+		}
+
 		// Trigger capture asynchronously and send results via SSE
 		go func() {
-			// Use config default delay if none provided in request
-			delay := input.Body.Delay
-			if delay == 0 {
-				delay = float64(s.options.CaptureDefaultDelayMs) / 1000.0
-			}
-
-			fmt.Printf("API capture with delay: %.1f seconds\n", delay)
 			timestamp := time.Now().Format(time.RFC3339)
 
-			imageBytes, captureErr := capture.ToBytes(devicePath, delay)
+			var imageBytes []byte
+			var captureErr error
+			if streamID != "" {
+				imageBytes, captureErr = s.streamSnapshot(context.Background(), streamID, 0)
+				if captureErr != nil {
+					// e.g. a codec that can't be decoded, or no keyframe in time
+					fmt.Printf("Stream snapshot failed for %s, capturing directly: %s\n", streamID, captureErr.Error())
+				}
+			}
+			if streamID == "" || captureErr != nil {
+				// Use config default delay if none provided in request
+				delay := input.Body.Delay
+				if delay == 0 {
+					delay = float64(s.options.CaptureDefaultDelayMs) / 1000.0
+				}
+
+				fmt.Printf("API capture with delay: %.1f seconds\n", delay)
+				imageBytes, captureErr = capture.ToBytes(devicePath, delay)
+			}
 
 			if captureErr != nil {
 				// Log the capture error
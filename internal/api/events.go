@@ -9,9 +9,14 @@ import (
 	"github.com/danielgtaylor/huma/v2"
 	"github.com/danielgtaylor/huma/v2/sse"
 	"github.com/smazurov/videonode/internal/events"
+	"github.com/smazurov/videonode/internal/metrics"
 	"github.com/smazurov/videonode/internal/metrics/exporters"
 )
 
+// eventsQueueSize is how many events a client of the events stream may fall
+// behind before the oldest are dropped.
+const eventsQueueSize = 64
+
 // registerSSERoutes registers the native Huma SSE endpoint.
 func (s *Server) registerSSERoutes() {
 	// Register SSE endpoint with event type mapping
@@ -41,19 +46,22 @@ func (s *Server) registerSSERoutes() {
 
 		return eventTypes
 	}(), func(ctx context.Context, _ *struct{}, send sse.Sender) {
-		// Create event channel for this connection
-		eventCh := make(chan any, 10)
+		// Bounded queue for this connection, drops the oldest event when the
+		// client falls behind
+		queue := events.NewQueue(eventsQueueSize, func() {
+			metrics.IncrementSSEDroppedEvents("events")
+		})
 
 		// Subscribe to all event types using event bus
 		unsubscribers := []func(){
-			events.SubscribeToChannel[events.CaptureSuccessEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.CaptureErrorEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.DeviceDiscoveryEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.StreamCreatedEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.StreamUpdatedEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.StreamDeletedEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.StreamStateChangedEvent](s.eventBus, eventCh),
-			events.SubscribeToChannel[events.StreamMetricsEvent](s.eventBus, eventCh),
+			events.SubscribeToQueue[events.CaptureSuccessEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.CaptureErrorEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.DeviceDiscoveryEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.StreamCreatedEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.StreamUpdatedEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.StreamDeletedEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.StreamStateChangedEvent](s.eventBus, queue),
+			events.SubscribeToQueue[events.StreamMetricsEvent](s.eventBus, queue),
 		}
 		defer func() {
 			for _, unsub := range unsubscribers {
@@ -71,17 +79,30 @@ func (s *Server) registerSSERoutes() {
 			return
 		}
 
+		// Metrics batches are deltas, so start from a full one. Subscribing
+		// first means no batch after the snapshot is missed.
+		if exporter := s.options.SSEExporter; exporter != nil {
+			if err := send.Data(exporter.Snapshot()); err != nil {
+				return
+			}
+		}
+
 		// Keep connection alive and forward events
+		var batch []any
 		for {
 			select {
 			case <-ctx.Done():
 				return
-			case event := <-eventCh:
-				// Send event using Huma's SSE sender with error handling
-				if err := send.Data(event); err != nil {
-					// Connection failed, clean up and exit
-					return
+			case <-queue.Ready():
+				batch = queue.Drain(batch[:0])
+				for _, event := range batch {
+					// Send event using Huma's SSE sender with error handling
+					if err := send.Data(event); err != nil {
+						// Connection failed, clean up and exit
+						return
+					}
 				}
+				clear(batch)
 			}
 		}
 	})
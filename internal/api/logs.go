@@ -9,8 +9,16 @@ import (
 	"github.com/danielgtaylor/huma/v2/sse"
 	"github.com/smazurov/videonode/internal/events"
 	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/metrics"
 )
 
+// logStreamInput selects where a log stream resumes. Both fields carry the
+// sequence number of the last entry the client has; the larger one wins.
+type logStreamInput struct {
+	Since       uint64 `query:"since" doc:"Only send entries after this sequence number"`
+	LastEventID uint64 `header:"Last-Event-ID" doc:"Sequence number of the last received entry, set by reconnecting EventSource clients"`
+}
+
 // registerLogRoutes registers the log streaming SSE endpoint.
 func (s *Server) registerLogRoutes() {
 	// Register SSE endpoint for log streaming
@@ -19,7 +27,7 @@ func (s *Server) registerLogRoutes() {
 		Method:      http.MethodGet,
 		Path:        "/api/logs/stream",
 		Summary:     "Log Stream",
-		Description: "Real-time log streaming via Server-Sent Events. Sends historical logs first, then streams new logs.",
+		Description: "Real-time log streaming via Server-Sent Events. Sends buffered logs after the given sequence number first, then streams new logs. Each message ID is the entry's sequence number.",
 		Tags:        []string{"logs"},
 		Security:    withAuth(),
 		Errors:      []int{401},
@@ -27,42 +35,60 @@ func (s *Server) registerLogRoutes() {
 		return map[string]any{
 			"message": events.LogEntryEvent{},
 		}
-	}(), func(ctx context.Context, _ *struct{}, send sse.Sender) {
-		// First, send all historical logs from the ring buffer
+	}(), func(ctx context.Context, input *logStreamInput, send sse.Sender) {
 		buffer := logging.GetBuffer()
-		if buffer != nil {
-			entries := buffer.ReadAll()
-			for _, entry := range entries {
-				event := events.LogEntryEvent{
-					Timestamp:  entry.Timestamp.Format(time.RFC3339Nano),
-					Level:      entry.Level,
-					Module:     entry.Module,
-					Message:    entry.Message,
-					Attributes: entry.Attributes,
-				}
-				if err := send.Data(event); err != nil {
-					return
-				}
-			}
+		if buffer == nil {
+			return
 		}
 
-		// Create event channel for this connection
-		eventCh := make(chan any, 100) // Larger buffer for logs
-
-		// Subscribe to log events
-		unsubscribe := events.SubscribeToChannel[events.LogEntryEvent](s.eventBus, eventCh)
+		// Subscribe before the first read so no entry falls between the two
+		wake, unsubscribe := buffer.Subscribe()
 		defer unsubscribe()
 
-		// Stream new log entries as they arrive
+		cursor := max(input.Since, input.LastEventID)
+		if cursor > buffer.Last() {
+			// Cursor from before a restart, sequence numbers started over
+			cursor = 0
+		}
+		resumed := cursor > 0
+
+		// The ring buffer is the queue: each pass sends what was written
+		// since the cursor, and a client that falls behind by more than the
+		// buffer loses the oldest entries
+		var batch []logging.LogEntry
 		for {
+			prev := cursor
+			batch, cursor = buffer.ReadSince(prev, batch[:0])
+			if missed := cursor - prev - uint64(len(batch)); resumed && missed > 0 {
+				metrics.AddSSEDroppedEvents("logs", missed)
+			}
+			if len(batch) > 0 {
+				for i := range batch {
+					if err := send(sse.Message{ID: int(batch[i].Seq), Data: logEntryEvent(&batch[i])}); err != nil {
+						return
+					}
+				}
+				clear(batch)
+			}
+			resumed = true
+
 			select {
 			case <-ctx.Done():
 				return
-			case event := <-eventCh:
-				if err := send.Data(event); err != nil {
-					return
-				}
+			case <-wake:
 			}
 		}
 	})
 }
+
+// logEntryEvent converts a buffered log entry to its SSE representation.
+func logEntryEvent(entry *logging.LogEntry) events.LogEntryEvent {
+	return events.LogEntryEvent{
+		Seq:        entry.Seq,
+		Timestamp:  entry.Timestamp.Format(time.RFC3339Nano),
+		Level:      entry.Level,
+		Module:     entry.Module,
+		Message:    entry.Message,
+		Attributes: entry.AttributeMap(),
+	}
+}
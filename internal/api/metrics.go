@@ -0,0 +1,69 @@
+package api
+
+import (
+	"context"
+	"net/http"
+	"time"
+
+	"github.com/danielgtaylor/huma/v2"
+	"github.com/smazurov/videonode/internal/metrics/history"
+)
+
+// MetricsHistoryInput is the request for a stream's metrics history.
+type MetricsHistoryInput struct {
+	StreamID  string `path:"stream_id" example:"stream-001" doc:"Stream identifier"`
+	Seconds   int    `query:"seconds" minimum:"1" maximum:"86400" default:"300" doc:"How far back to return, in seconds"`
+	MaxPoints int    `query:"max_points" minimum:"0" maximum:"2000" default:"300" doc:"Most points to return per series (0 for no limit); coarser points are returned past it"`
+}
+
+// MetricsHistoryData is a stream's metrics history, one value per series for
+// every timestamp.
+type MetricsHistoryData struct {
+	StreamID          string               `json:"stream_id" example:"stream-001" doc:"Stream identifier"`
+	ResolutionSeconds float64              `json:"resolution_seconds" example:"1" doc:"Seconds covered by each point, values are averaged over it"`
+	Timestamps        []int64              `json:"timestamps" doc:"Start of each point, in Unix milliseconds. The last point may still be filling"`
+	Series            map[string][]float64 `json:"series" doc:"Values per series: fps, dropped_frames (per second), speed, egress_bitrate (bits per second), peers, nack_rate and pli_rate (per second)"`
+}
+
+// MetricsHistoryResponse wraps MetricsHistoryData for API responses.
+type MetricsHistoryResponse struct {
+	Body MetricsHistoryData
+}
+
+// registerMetricsRoutes registers the metrics history endpoint.
+func (s *Server) registerMetricsRoutes() {
+	if s.options.MetricsHistory == nil {
+		return
+	}
+
+	huma.Register(s.api, huma.Operation{
+		OperationID: "get-stream-metrics-history",
+		Method:      http.MethodGet,
+		Path:        "/api/streams/{stream_id}/metrics/history",
+		Summary:     "Get Stream Metrics History",
+		Description: "Get recent stream metrics from the in-memory history: 5 minutes at 1s, an hour at 10s and a day at 1 minute resolution",
+		Tags:        []string{"streams"},
+		Errors:      []int{401},
+		Security:    withAuth(),
+	}, func(_ context.Context, input *MetricsHistoryInput) (*MetricsHistoryResponse, error) {
+		since := time.Now().Add(-time.Duration(input.Seconds) * time.Second)
+		rng := s.options.MetricsHistory.Query(input.StreamID, since, input.MaxPoints)
+
+		data := MetricsHistoryData{
+			StreamID:          input.StreamID,
+			ResolutionSeconds: rng.Resolution.Seconds(),
+			Timestamps:        make([]int64, len(rng.Times)),
+			Series:            make(map[string][]float64, len(rng.Values)),
+		}
+		for i, t := range rng.Times {
+			data.Timestamps[i] = t.UnixMilli()
+		}
+		for i, values := range rng.Values {
+			if values == nil {
+				values = []float64{}
+			}
+			data.Series[history.Series(i).String()] = values
+		}
+		return &MetricsHistoryResponse{Body: data}, nil
+	})
+}
@@ -134,6 +134,7 @@ type StreamUpdateRequestData struct {
 	Codec               *string  `json:"codec,omitempty" enum:"h264,h265" example:"h264" doc:"Video codec standard"`
 	InputFormat         *string  `json:"input_format,omitempty" example:"yuyv422" doc:"V4L2 input format"`
 	Bitrate             *float64 `json:"bitrate,omitempty" example:"2.0" doc:"Bitrate in Mbps"`
+	KeyframeInterval    *int     `json:"keyframe_interval,omitempty" minimum:"1" example:"60" doc:"Keyframe interval (GOP size) in frames"`
 	Width               *int     `json:"width,omitempty" example:"1920" doc:"Video width"`
 	Height              *int     `json:"height,omitempty" example:"1080" doc:"Video height"`
 	Framerate           *int     `json:"framerate,omitempty" example:"30" doc:"Video framerate"`
@@ -149,6 +150,24 @@ type StreamUpdateRequest struct {
 	Body StreamUpdateRequestData
 }
 
+// StreamBatchUpdateData is an update of one stream in a batch.
+type StreamBatchUpdateData struct {
+	StreamID string `json:"stream_id" pattern:"^[a-zA-Z0-9_-]+$" minLength:"1" maxLength:"50" example:"stream-001" doc:"Stream identifier"`
+	StreamUpdateRequestData
+}
+
+// StreamBatchRequestData contains streams to create and update with a single
+// write to the streams configuration.
+type StreamBatchRequestData struct {
+	Create []StreamRequestData     `json:"create,omitempty" doc:"Streams to create"`
+	Update []StreamBatchUpdateData `json:"update,omitempty" doc:"Streams to update"`
+}
+
+// StreamBatchRequest wraps StreamBatchRequestData for API requests.
+type StreamBatchRequest struct {
+	Body StreamBatchRequestData
+}
+
 // StreamResponse wraps StreamData for API responses.
 type StreamResponse struct {
 	Body StreamData
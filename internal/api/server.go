@@ -12,6 +12,8 @@ import (
 	"github.com/smazurov/videonode/internal/devices"
 	"github.com/smazurov/videonode/internal/events"
 	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/metrics/exporters"
+	"github.com/smazurov/videonode/internal/metrics/history"
 	"github.com/smazurov/videonode/internal/streaming"
 	"github.com/smazurov/videonode/internal/streams"
 	"github.com/smazurov/videonode/internal/updater"
@@ -27,6 +29,7 @@ type Server struct {
 	options        *Options
 	deviceDetector devices.DeviceDetector
 	eventBus       *events.Bus
+	snapshots      *snapshotCache
 	logger         logging.Logger
 }
 
@@ -118,7 +121,10 @@ type Options struct {
 		Available() []string
 		Patterns() []string
 	}
-	WebRTCManager *streaming.WebRTCManager // WebRTC signaling manager
+	WebRTCManager  *streaming.WebRTCManager // WebRTC signaling manager
+	StreamingHub   *streaming.Hub           // Optional, serves snapshots from live streams
+	SSEExporter    *exporters.SSEExporter   // Optional, baseline for stream metrics deltas
+	MetricsHistory *history.Store           // Optional, serves stream metrics history
 }
 
 // NewServer creates a new API server with Huma v2 using Go 1.22+ native routing.
@@ -148,12 +154,14 @@ func NewServer(opts *Options) *Server {
 	api := humago.New(mux, config)
 
 	server := &Server{
-		api:           api,
-		mux:           mux,
-		streamService: opts.StreamService,
-		options:       opts,
-		eventBus:      opts.EventBus,
-		logger:        logging.GetLogger("api"),
+		api:            api,
+		mux:            mux,
+		streamService:  opts.StreamService,
+		options:        opts,
+		eventBus:       opts.EventBus,
+		snapshots:      newSnapshotCache(snapshotCacheTTL),
+		deviceDetector: devices.NewDetector(),
+		logger:         logging.GetLogger("api"),
 	}
 
 	// Apply CORS middleware first (before auth)
@@ -245,7 +253,6 @@ func (s *Server) Start(addr string) error {
 
 	// Start device monitoring with composite broadcaster
 	// This broadcasts device events to both SSE clients (via Server) and stream management (via StreamService)
-	s.deviceDetector = devices.NewDetector()
 	s.deviceDetector.SetEventBus(s.eventBus)
 	compositeBroadcaster := &CompositeBroadcaster{
 		broadcasters: []devices.EventBroadcaster{s, s.streamService},
@@ -312,6 +319,12 @@ func (s *Server) registerRoutes() {
 	// Stream endpoints
 	s.registerStreamRoutes()
 
+	// Snapshot endpoints (if the streaming hub is available)
+	s.registerSnapshotRoutes()
+
+	// Metrics history endpoint (if the history store is available)
+	s.registerMetricsRoutes()
+
 	// Options endpoints
 	s.registerOptionsRoutes()
 
@@ -0,0 +1,28 @@
+package api
+
+import (
+	"testing"
+
+	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/streaming"
+	"github.com/smazurov/videonode/internal/streams"
+)
+
+// TestNewServerRegistersAllRoutes builds a server with every optional
+// service, so routes registered twice panic here instead of at startup.
+func TestNewServerRegistersAllRoutes(t *testing.T) {
+	logger := logging.GetLogger("streaming")
+	hub := streaming.NewHub(logger)
+	server := NewServer(&Options{
+		StreamService: &mockStreamService{
+			streams:     map[string]*streams.Stream{},
+			streamSpecs: map[string]*streams.StreamSpec{},
+		},
+		StreamingHub:  hub,
+		WebRTCManager: streaming.NewWebRTCManager(hub, streaming.WebRTCConfig{}, logger),
+	})
+
+	if server.api.OpenAPI().Paths["/api/streams/live"] == nil {
+		t.Error("live streams route not registered")
+	}
+}
@@ -0,0 +1,186 @@
+package api
+
+import (
+	"context"
+	"errors"
+	"net/http"
+	"strconv"
+	"sync"
+	"time"
+
+	"github.com/danielgtaylor/huma/v2"
+	"github.com/smazurov/videonode/internal/capture"
+	"github.com/smazurov/videonode/internal/streaming"
+)
+
+// Snapshot settings. Thumbnails are small and served from cache for a few
+// seconds, so a grid of previews polling them costs one decode per stream
+// per TTL rather than one per viewer.
+const (
+	snapshotCacheTTL  = 5 * time.Second
+	snapshotTimeout   = 5 * time.Second
+	thumbnailMaxWidth = 1920
+)
+
+// StreamThumbnailInput is the request for a stream thumbnail.
+type StreamThumbnailInput struct {
+	StreamID string `path:"stream_id" example:"stream-001" doc:"Stream identifier"`
+	Width    int    `query:"width" minimum:"0" maximum:"1920" doc:"Image width in pixels (default 320, 0 for full size)" default:"320"`
+}
+
+// ImageOutput is a raw image response.
+type ImageOutput struct {
+	ContentType  string `header:"Content-Type"`
+	CacheControl string `header:"Cache-Control"`
+	Body         []byte
+}
+
+// registerSnapshotRoutes registers snapshot endpoints served from the
+// streaming hub.
+func (s *Server) registerSnapshotRoutes() {
+	if s.options.StreamingHub == nil {
+		return
+	}
+
+	huma.Register(s.api, huma.Operation{
+		OperationID: "get-stream-thumbnail",
+		Method:      http.MethodGet,
+		Path:        "/api/streams/{stream_id}/thumbnail",
+		Summary:     "Get Stream Thumbnail",
+		Description: "Get a JPEG of the stream's latest keyframe. Images are cached for a few seconds and never touch the capture device",
+		Tags:        []string{"streams"},
+		Errors:      []int{401, 404, 500},
+		Security:    withAuth(),
+	}, func(ctx context.Context, input *StreamThumbnailInput) (*ImageOutput, error) {
+		width := min(input.Width, thumbnailMaxWidth)
+		image, err := s.streamSnapshot(ctx, input.StreamID, width)
+		if errors.Is(err, streaming.ErrStreamNotFound) || errors.Is(err, streaming.ErrTrackNotFound) {
+			return nil, huma.Error404NotFound("stream not running", err)
+		}
+		if err != nil {
+			return nil, huma.Error500InternalServerError("failed to create thumbnail", err)
+		}
+		return &ImageOutput{
+			ContentType:  "image/jpeg",
+			CacheControl: "private, max-age=" + strconv.Itoa(int(snapshotCacheTTL/time.Second)),
+			Body:         image,
+		}, nil
+	})
+}
+
+// streamSnapshot returns a JPEG of a stream's latest keyframe, scaled to
+// width (0 keeps the stream's size).
+func (s *Server) streamSnapshot(ctx context.Context, streamID string, width int) ([]byte, error) {
+	key := streamID + "@" + strconv.Itoa(width)
+	return s.snapshots.get(ctx, key, func() ([]byte, error) {
+		// Not tied to the request: other callers may be waiting on this load
+		loadCtx, cancel := context.WithTimeout(context.Background(), snapshotTimeout)
+		defer cancel()
+
+		keyframe, err := s.options.StreamingHub.Keyframe(loadCtx, streamID)
+		if err != nil {
+			return nil, err
+		}
+		return capture.DecodeKeyframe(loadCtx, keyframe.Codec, keyframe.Data, width)
+	})
+}
+
+// deviceStream returns the ID of the running stream that captures from a
+// device, or "" if there is none.
+func (s *Server) deviceStream(ctx context.Context, deviceID string) string {
+	streamList, err := s.streamService.ListStreams(ctx)
+	if err != nil {
+		return ""
+	}
+	for _, stream := range streamList {
+		if !stream.Enabled {
+			continue
+		}
+		spec, err := s.streamService.GetStreamSpec(ctx, stream.ID)
+		if err == nil && spec.Device == deviceID {
+			return stream.ID
+		}
+	}
+	return ""
+}
+
+// snapshotCache keeps recently generated images for a short TTL. Concurrent
+// requests for the same key share one load. Failed loads are not cached.
+type snapshotCache struct {
+	ttl     time.Duration
+	now     func() time.Time
+	mu      sync.Mutex
+	entries map[string]*snapshotEntry
+}
+
+type snapshotEntry struct {
+	ready   chan struct{} // closed once image/err are set
+	image   []byte
+	err     error
+	expires time.Time
+}
+
+func newSnapshotCache(ttl time.Duration) *snapshotCache {
+	return &snapshotCache{
+		ttl:     ttl,
+		now:     time.Now,
+		entries: make(map[string]*snapshotEntry),
+	}
+}
+
+// get returns the cached image for key, loading it if missing or expired.
+func (c *snapshotCache) get(ctx context.Context, key string, load func() ([]byte, error)) ([]byte, error) {
+	c.mu.Lock()
+	now := c.now()
+	entry, ok := c.entries[key]
+	if !ok || isExpired(entry, now) {
+		c.pruneLocked(now)
+		entry = &snapshotEntry{ready: make(chan struct{})}
+		c.entries[key] = entry
+		c.mu.Unlock()
+
+		go c.fill(key, entry, load)
+	} else {
+		c.mu.Unlock()
+	}
+
+	select {
+	case <-entry.ready:
+		return entry.image, entry.err
+	case <-ctx.Done():
+		return nil, ctx.Err()
+	}
+}
+
+func (c *snapshotCache) fill(key string, entry *snapshotEntry, load func() ([]byte, error)) {
+	image, err := load()
+
+	c.mu.Lock()
+	entry.image, entry.err = image, err
+	entry.expires = c.now().Add(c.ttl)
+	if err != nil && c.entries[key] == entry {
+		delete(c.entries, key)
+	}
+	c.mu.Unlock()
+	close(entry.ready)
+}
+
+// pruneLocked drops expired entries. Caller must hold c.mu.
+func (c *snapshotCache) pruneLocked(now time.Time) {
+	for key, entry := range c.entries {
+		if isExpired(entry, now) {
+			delete(c.entries, key)
+		}
+	}
+}
+
+// isExpired reports whether a loaded entry is past its TTL. Entries still
+// loading never expire.
+func isExpired(entry *snapshotEntry, now time.Time) bool {
+	select {
+	case <-entry.ready:
+		return !now.Before(entry.expires)
+	default:
+		return false
+	}
+}
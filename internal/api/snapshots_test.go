@@ -0,0 +1,132 @@
+package api
+
+import (
+	"context"
+	"errors"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/smazurov/videonode/internal/streams"
+)
+
+func TestSnapshotCache_TTL(t *testing.T) {
+	now := time.Unix(1000, 0)
+	cache := newSnapshotCache(5 * time.Second)
+	cache.now = func() time.Time { return now }
+
+	var loads int
+	load := func() ([]byte, error) {
+		loads++
+		return []byte{byte(loads)}, nil
+	}
+
+	image, _ := cache.get(context.Background(), "a@320", load)
+	if image[0] != 1 {
+		t.Fatalf("first get = %v, want load 1", image)
+	}
+
+	now = now.Add(4 * time.Second)
+	image, _ = cache.get(context.Background(), "a@320", load)
+	if image[0] != 1 || loads != 1 {
+		t.Errorf("get within TTL reloaded: image %v, %d loads", image, loads)
+	}
+
+	now = now.Add(2 * time.Second)
+	image, _ = cache.get(context.Background(), "a@320", load)
+	if image[0] != 2 {
+		t.Errorf("get after TTL = %v, want load 2", image)
+	}
+}
+
+func TestSnapshotCache_FailuresNotCached(t *testing.T) {
+	cache := newSnapshotCache(time.Minute)
+	errDecode := errors.New("decode failed")
+
+	_, err := cache.get(context.Background(), "a@0", func() ([]byte, error) { return nil, errDecode })
+	if !errors.Is(err, errDecode) {
+		t.Fatalf("err = %v, want %v", err, errDecode)
+	}
+
+	image, err := cache.get(context.Background(), "a@0", func() ([]byte, error) { return []byte("jpeg"), nil })
+	if err != nil || string(image) != "jpeg" {
+		t.Errorf("get after failure = %q, %v; want a fresh load", image, err)
+	}
+}
+
+func TestSnapshotCache_SharesInflightLoad(t *testing.T) {
+	cache := newSnapshotCache(time.Minute)
+	release := make(chan struct{})
+	var loads atomic.Int32
+	load := func() ([]byte, error) {
+		loads.Add(1)
+		<-release
+		return []byte("jpeg"), nil
+	}
+
+	var wg sync.WaitGroup
+	for range 4 {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			if image, err := cache.get(context.Background(), "a@320", load); err != nil || string(image) != "jpeg" {
+				t.Errorf("get = %q, %v", image, err)
+			}
+		}()
+	}
+
+	// Let all callers find the pending entry before the load finishes
+	time.Sleep(20 * time.Millisecond)
+	close(release)
+	wg.Wait()
+
+	if n := loads.Load(); n != 1 {
+		t.Errorf("loads = %d, want 1", n)
+	}
+}
+
+func TestSnapshotCache_CallerTimeout(t *testing.T) {
+	cache := newSnapshotCache(time.Minute)
+	release := make(chan struct{})
+	defer close(release)
+
+	ctx, cancel := context.WithTimeout(context.Background(), 10*time.Millisecond)
+	defer cancel()
+
+	_, err := cache.get(ctx, "a@320", func() ([]byte, error) {
+		<-release
+		return nil, nil
+	})
+	if !errors.Is(err, context.DeadlineExceeded) {
+		t.Errorf("err = %v, want deadline exceeded", err)
+	}
+}
+
+func TestDeviceStream(t *testing.T) {
+	mockSvc := &mockStreamService{
+		streams: map[string]*streams.Stream{
+			"live":    {ID: "live", Enabled: true},
+			"offline": {ID: "offline", Enabled: false},
+		},
+		streamSpecs: map[string]*streams.StreamSpec{
+			"live":    {ID: "live", Device: "usb-live"},
+			"offline": {ID: "offline", Device: "usb-offline"},
+		},
+	}
+	server := &Server{streamService: mockSvc}
+
+	tests := []struct {
+		deviceID string
+		want     string
+	}{
+		{"usb-live", "live"},
+		{"usb-offline", ""},
+		{"usb-unknown", ""},
+	}
+	for _, tt := range tests {
+		if got := server.deviceStream(context.Background(), tt.deviceID); got != tt.want {
+			t.Errorf("deviceStream(%q) = %q, want %q", tt.deviceID, got, tt.want)
+		}
+	}
+}
@@ -96,19 +96,7 @@ func (s *Server) registerStreamRoutes() {
 	},
 	) (*models.StreamResponse, error) {
 		// Convert API request to domain parameters
-		params := streams.StreamUpdateParams{
-			Codec:               input.Body.Codec,
-			InputFormat:         input.Body.InputFormat,
-			Bitrate:             input.Body.Bitrate,
-			Width:               input.Body.Width,
-			Height:              input.Body.Height,
-			Framerate:           input.Body.Framerate,
-			AudioDevice:         input.Body.AudioDevice,
-			Options:             input.Body.Options,
-			CustomFFmpegCommand: input.Body.CustomFFmpegCommand,
-			TestMode:            input.Body.TestMode,
-			Enabled:             input.Body.Enabled,
-		}
+		params := convertUpdateRequest(input.Body)
 
 		stream, err := s.streamService.UpdateStream(ctx, input.StreamID, params)
 		if err != nil {
@@ -130,6 +118,67 @@ func (s *Server) registerStreamRoutes() {
 		}, nil
 	})
 
+	// Create and update streams in one batch
+	huma.Register(s.api, huma.Operation{
+		OperationID: "batch-streams",
+		Method:      http.MethodPost,
+		Path:        "/api/streams/batch",
+		Summary:     "Batch Create and Update Streams",
+		Description: "Create and update several streams with a single atomic write to the streams configuration. " +
+			"If any stream is rejected, none are changed.",
+		Tags:     []string{"streams"},
+		Errors:   []int{400, 401, 404, 409, 500},
+		Security: withAuth(),
+	}, func(ctx context.Context, input *models.StreamBatchRequest) (*models.StreamListResponse, error) {
+		params := streams.StreamBatchParams{
+			Create: make([]streams.StreamCreateParams, len(input.Body.Create)),
+			Update: make([]streams.StreamBatchUpdate, len(input.Body.Update)),
+		}
+		for i, create := range input.Body.Create {
+			params.Create[i] = s.convertCreateRequest(create)
+		}
+		for i, update := range input.Body.Update {
+			params.Update[i] = streams.StreamBatchUpdate{
+				StreamID: update.StreamID,
+				Params:   convertUpdateRequest(update.StreamUpdateRequestData),
+			}
+		}
+
+		results, err := s.streamService.ApplyBatch(ctx, params)
+		if err != nil {
+			return nil, s.mapStreamError(err)
+		}
+
+		// Broadcast an event per stream, as the single-stream endpoints do
+		apiStreams := make([]models.StreamData, len(results))
+		for i, stream := range results {
+			apiStreams[i] = s.domainToAPIStream(stream)
+			if s.eventBus == nil {
+				continue
+			}
+			if i < len(params.Create) {
+				s.eventBus.Publish(events.StreamCreatedEvent{
+					Stream:    apiStreams[i],
+					Action:    "created",
+					Timestamp: time.Now().Format(time.RFC3339),
+				})
+			} else {
+				s.eventBus.Publish(events.StreamUpdatedEvent{
+					Stream:    apiStreams[i],
+					Action:    "updated",
+					Timestamp: time.Now().Format(time.RFC3339),
+				})
+			}
+		}
+
+		return &models.StreamListResponse{
+			Body: models.StreamListData{
+				Streams: apiStreams,
+				Count:   len(apiStreams),
+			},
+		}, nil
+	})
+
 	// Delete stream
 	huma.Register(s.api, huma.Operation{
 		OperationID: "delete-stream",
@@ -275,6 +324,24 @@ func (s *Server) convertCreateRequest(body models.StreamRequestData) streams.Str
 	return params
 }
 
+// convertUpdateRequest converts API update request to domain params.
+func convertUpdateRequest(body models.StreamUpdateRequestData) streams.StreamUpdateParams {
+	return streams.StreamUpdateParams{
+		Codec:               body.Codec,
+		InputFormat:         body.InputFormat,
+		Bitrate:             body.Bitrate,
+		KeyframeInterval:    body.KeyframeInterval,
+		Width:               body.Width,
+		Height:              body.Height,
+		Framerate:           body.Framerate,
+		AudioDevice:         body.AudioDevice,
+		Options:             body.Options,
+		CustomFFmpegCommand: body.CustomFFmpegCommand,
+		TestMode:            body.TestMode,
+		Enabled:             body.Enabled,
+	}
+}
+
 // domainToAPIStream converts a domain stream to API stream data with configuration.
 func (s *Server) domainToAPIStream(stream streams.Stream) models.StreamData {
 	// Get stream specification for configuration details
@@ -63,10 +63,18 @@ func (m *mockStreamService) GetFFmpegCommand(_ context.Context, _ string, _ stri
 func (m *mockStreamService) BroadcastDeviceDiscovery(_ string, _ devices.DeviceInfo, _ string) {
 }
 
+func (m *mockStreamService) ApplyBatch(_ context.Context, _ streams.StreamBatchParams) ([]streams.Stream, error) {
+	return nil, nil
+}
+
 func (m *mockStreamService) LoadStreamsFromConfig() error {
 	return nil
 }
 
+func (m *mockStreamService) ReloadStreams() (streams.SpecDiff, error) {
+	return streams.SpecDiff{}, nil
+}
+
 func (m *mockStreamService) GetProcessManager() streams.StreamProcessManager {
 	return nil
 }
@@ -45,7 +45,8 @@ func getOptimalEncoder() (string, *validation.EncoderSettings, error) {
 }
 
 // ToBytes captures a screenshot from the specified video device
-// and returns the image data as bytes.
+// and returns the image data as bytes. Devices that capture MJPEG are read
+// in-process; others are captured with FFmpeg.
 //
 // If delaySeconds > 0, it will record video for that duration and extract
 // the last frame, which allows devices like Elgato to naturally show
@@ -56,6 +57,14 @@ func ToBytes(devicePath string, delaySeconds float64) ([]byte, error) {
 		return nil, fmt.Errorf("device %s does not exist", devicePath)
 	}
 
+	// MJPEG devices hand out JPEG frames directly, without an FFmpeg process
+	data, err := captureNativeJPEG(devicePath, delaySeconds)
+	if err == nil {
+		fmt.Printf("Screenshot captured from %s (%d bytes)\n", devicePath, len(data))
+		return data, nil
+	}
+	slog.With("component", "capture").Debug("Native capture unavailable, using FFmpeg", "device", devicePath, "error", err)
+
 	// If no delay specified or too small, just capture a single frame
 	if delaySeconds <= 0.1 {
 		return captureDirectFrameToBytes(devicePath)
@@ -0,0 +1,10 @@
+//go:build darwin
+
+package capture
+
+import "errors"
+
+// captureNativeJPEG is only available on Linux; captures go through FFmpeg.
+func captureNativeJPEG(_ string, _ float64) ([]byte, error) {
+	return nil, errors.New("native capture requires Linux")
+}
@@ -0,0 +1,60 @@
+//go:build linux
+
+package capture
+
+import (
+	"errors"
+	"fmt"
+	"time"
+
+	"github.com/smazurov/videonode/pkg/linuxav/v4l2"
+)
+
+// nativeFrameTimeout bounds the wait for each frame of a native capture.
+const nativeFrameTimeout = 2 * time.Second
+
+// nativeWarmupFrames are skipped before a direct capture: webcams often
+// deliver dark or partial frames while auto exposure settles.
+const nativeWarmupFrames = 2
+
+// errNoNativeMJPEG is returned when the device can't deliver MJPEG itself.
+var errNoNativeMJPEG = errors.New("device does not capture MJPEG")
+
+// captureNativeJPEG grabs a JPEG frame straight from a device that captures
+// MJPEG, in-process and without encoding. With a delay, frames are read for
+// that long and the last one is returned, like the FFmpeg path does.
+func captureNativeJPEG(devicePath string, delaySeconds float64) ([]byte, error) {
+	stream, err := v4l2.OpenStream(devicePath, v4l2.StreamConfig{
+		PixelFormat: v4l2.PixelFormatMJPEG,
+		Width:       1280,
+		Height:      720,
+	})
+	if err != nil {
+		return nil, err
+	}
+	defer stream.Close()
+
+	if stream.Format().PixelFormat != v4l2.PixelFormatMJPEG {
+		return nil, errNoNativeMJPEG
+	}
+	if err := stream.Start(); err != nil {
+		return nil, err
+	}
+
+	deadline := time.Now().Add(time.Duration(delaySeconds * float64(time.Second)))
+	for i := 0; ; i++ {
+		frame, err := stream.Next(nativeFrameTimeout)
+		if err != nil {
+			return nil, fmt.Errorf("failed to capture frame: %w", err)
+		}
+
+		if i >= nativeWarmupFrames && !time.Now().Before(deadline) {
+			data := append([]byte(nil), frame.Data...)
+			_ = frame.Release()
+			return data, nil
+		}
+		if err := frame.Release(); err != nil {
+			return nil, err
+		}
+	}
+}
@@ -0,0 +1,51 @@
+package capture
+
+import (
+	"bytes"
+	"context"
+	"fmt"
+	"os/exec"
+	"strconv"
+	"strings"
+)
+
+// DecodeKeyframe converts an H264 or H265 keyframe (Annex B) to a JPEG
+// image. FFmpeg decodes it with a hardware decoder when one is available
+// and falls back to software otherwise. A width > 0 scales the image to that
+// width, keeping the aspect ratio.
+func DecodeKeyframe(ctx context.Context, codec string, data []byte, width int) ([]byte, error) {
+	var demuxer string
+	switch strings.ToLower(codec) {
+	case "h264":
+		demuxer = "h264"
+	case "h265", "hevc":
+		demuxer = "hevc"
+	default:
+		return nil, fmt.Errorf("unsupported codec %q", codec)
+	}
+
+	args := []string{
+		"-hide_banner", "-nostats", "-loglevel", "error",
+		"-hwaccel", "auto",
+		"-f", demuxer, "-i", "pipe:0",
+		"-frames:v", "1",
+	}
+	if width > 0 {
+		args = append(args, "-vf", "scale="+strconv.Itoa(width)+":-2")
+	}
+	args = append(args, "-q:v", "3", "-f", "image2", "-c:v", "mjpeg", "pipe:1")
+
+	var stdout, stderr bytes.Buffer
+	cmd := exec.CommandContext(ctx, "ffmpeg", args...)
+	cmd.Stdin = bytes.NewReader(data)
+	cmd.Stdout = &stdout
+	cmd.Stderr = &stderr
+
+	if err := cmd.Run(); err != nil {
+		return nil, fmt.Errorf("failed to decode keyframe: %w: %s", err, strings.TrimSpace(stderr.String()))
+	}
+	if stdout.Len() == 0 {
+		return nil, fmt.Errorf("failed to decode keyframe: no image produced")
+	}
+	return stdout.Bytes(), nil
+}
@@ -1,2 +1,3 @@
-// Package capture handles screenshot capture from V4L2 devices using FFmpeg.
+// Package capture handles screenshot capture from V4L2 devices, natively for
+// MJPEG devices and using FFmpeg otherwise.
 package capture
@@ -2,6 +2,7 @@ package config
 
 import (
 	"context"
+	"path/filepath"
 	"sync"
 	"time"
 
@@ -94,7 +95,9 @@ func (w *Watcher[T]) Start() error {
 	}
 	w.watcher = watcher
 
-	if err := watcher.Add(w.path); err != nil {
+	// Watch the directory rather than the file: a file replaced by rename
+	// (atomic saves, most editors) would otherwise drop the watch
+	if err := watcher.Add(filepath.Dir(w.path)); err != nil {
 		watcher.Close()
 		return err
 	}
@@ -133,8 +136,8 @@ func (w *Watcher[T]) watch() {
 			}
 
 			// Handle write events (most common for config changes)
-			// Also handle create events (some editors replace the file)
-			if event.Op&(fsnotify.Write|fsnotify.Create) != 0 {
+			// Also handle create events (files replaced by rename)
+			if filepath.Clean(event.Name) == filepath.Clean(w.path) && event.Op&(fsnotify.Write|fsnotify.Create) != 0 {
 				w.logger.Debug("Config file change detected", "op", event.Op.String())
 
 				// Reset debounce timer
@@ -4,6 +4,7 @@ import (
 	"fmt"
 	"log/slog"
 	"os"
+	"path/filepath"
 	"sync"
 	"sync/atomic"
 	"testing"
@@ -377,6 +378,55 @@ func TestConfigWatcher_Debounce(t *testing.T) {
 	}
 }
 
+func TestConfigWatcher_ReplacedByRename(t *testing.T) {
+	dir := t.TempDir()
+	path := filepath.Join(dir, "config.toml")
+	if err := os.WriteFile(path, []byte("value = 0\n"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+
+	received := make(chan testConfig, 4)
+	watcher := NewConfigWatcher(
+		path,
+		loadTestConfig,
+		newTestLogger(),
+		WithDebounce[testConfig](50*time.Millisecond),
+	)
+	watcher.OnReload(func(cfg testConfig) {
+		received <- cfg
+	})
+
+	if err := watcher.Start(); err != nil {
+		t.Fatal(err)
+	}
+	defer func() {
+		if err := watcher.Stop(); err != nil {
+			t.Errorf("watcher.Stop failed: %v", err)
+		}
+	}()
+	time.Sleep(100 * time.Millisecond)
+
+	// Each replace must be seen, the watch survives the first one
+	for i := 1; i <= 2; i++ {
+		tmp := filepath.Join(dir, ".config.toml.tmp")
+		if err := os.WriteFile(tmp, fmt.Appendf(nil, "value = %d\n", i), 0o644); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.Rename(tmp, path); err != nil {
+			t.Fatal(err)
+		}
+
+		select {
+		case cfg := <-received:
+			if cfg.Value != i {
+				t.Errorf("replace %d: got value %d", i, cfg.Value)
+			}
+		case <-time.After(2 * time.Second):
+			t.Fatalf("replace %d: timeout waiting for config reload", i)
+		}
+	}
+}
+
 func TestConfigWatcher_ThreadSafety(t *testing.T) {
 	tmpFile, err := os.CreateTemp("", "config_*.toml")
 	if err != nil {
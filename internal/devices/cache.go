@@ -0,0 +1,131 @@
+//go:build linux
+
+package devices
+
+import (
+	"sync"
+)
+
+// capabilityCache memoizes format, resolution and framerate enumeration per
+// device path, so UI requests don't re-enumerate the hardware. Entries live
+// until the device is invalidated by a hotplug change. Failed lookups are
+// not cached. Returned slices are shared and must not be modified.
+type capabilityCache struct {
+	mu      sync.Mutex
+	devices map[string]*deviceCapabilities
+	gen     uint64 // bumped on invalidate, so a load racing it isn't stored
+}
+
+// deviceCapabilities holds what has been enumerated so far for one device.
+type deviceCapabilities struct {
+	formats     []FormatInfo
+	hasFormats  bool
+	resolutions map[uint32][]Resolution
+	framerates  map[framerateKey][]Framerate
+}
+
+// framerateKey identifies a framerate enumeration.
+type framerateKey struct {
+	pixelFormat   uint32
+	width, height uint32
+}
+
+func newCapabilityCache() *capabilityCache {
+	return &capabilityCache{devices: make(map[string]*deviceCapabilities)}
+}
+
+// device returns the entry for devicePath, creating it. Caller holds mu.
+func (c *capabilityCache) device(devicePath string) *deviceCapabilities {
+	dc, ok := c.devices[devicePath]
+	if !ok {
+		dc = &deviceCapabilities{
+			resolutions: make(map[uint32][]Resolution),
+			framerates:  make(map[framerateKey][]Framerate),
+		}
+		c.devices[devicePath] = dc
+	}
+	return dc
+}
+
+// formats returns the cached formats of devicePath, calling load on a miss.
+func (c *capabilityCache) formats(devicePath string, load func() ([]FormatInfo, error)) ([]FormatInfo, error) {
+	c.mu.Lock()
+	if dc, ok := c.devices[devicePath]; ok && dc.hasFormats {
+		c.mu.Unlock()
+		return dc.formats, nil
+	}
+	gen := c.gen
+	c.mu.Unlock()
+
+	formats, err := load()
+	if err != nil {
+		return nil, err
+	}
+
+	c.mu.Lock()
+	if c.gen == gen {
+		dc := c.device(devicePath)
+		dc.formats, dc.hasFormats = formats, true
+	}
+	c.mu.Unlock()
+	return formats, nil
+}
+
+// resolutions returns the cached resolutions of a format, calling load on a miss.
+func (c *capabilityCache) resolutions(devicePath string, pixelFormat uint32, load func() ([]Resolution, error)) ([]Resolution, error) {
+	c.mu.Lock()
+	if dc, ok := c.devices[devicePath]; ok {
+		if res, ok := dc.resolutions[pixelFormat]; ok {
+			c.mu.Unlock()
+			return res, nil
+		}
+	}
+	gen := c.gen
+	c.mu.Unlock()
+
+	res, err := load()
+	if err != nil {
+		return nil, err
+	}
+
+	c.mu.Lock()
+	if c.gen == gen {
+		c.device(devicePath).resolutions[pixelFormat] = res
+	}
+	c.mu.Unlock()
+	return res, nil
+}
+
+// framerates returns the cached framerates of a format and resolution,
+// calling load on a miss.
+func (c *capabilityCache) framerates(devicePath string, key framerateKey, load func() ([]Framerate, error)) ([]Framerate, error) {
+	c.mu.Lock()
+	if dc, ok := c.devices[devicePath]; ok {
+		if rates, ok := dc.framerates[key]; ok {
+			c.mu.Unlock()
+			return rates, nil
+		}
+	}
+	gen := c.gen
+	c.mu.Unlock()
+
+	rates, err := load()
+	if err != nil {
+		return nil, err
+	}
+
+	c.mu.Lock()
+	if c.gen == gen {
+		c.device(devicePath).framerates[key] = rates
+	}
+	c.mu.Unlock()
+	return rates, nil
+}
+
+// invalidate drops everything cached for devicePath.
+func (c *capabilityCache) invalidate(devicePath string) {
+	c.mu.Lock()
+	delete(c.devices, devicePath)
+	c.gen++
+	c.mu.Unlock()
+}
@@ -0,0 +1,99 @@
+//go:build linux
+
+package devices
+
+import (
+	"errors"
+	"testing"
+)
+
+func TestCapabilityCache_Formats(t *testing.T) {
+	c := newCapabilityCache()
+	calls := 0
+	load := func() ([]FormatInfo, error) {
+		calls++
+		return []FormatInfo{{FormatName: "MJPEG"}}, nil
+	}
+
+	for range 3 {
+		formats, err := c.formats("/dev/video0", load)
+		if err != nil || len(formats) != 1 {
+			t.Fatalf("formats() = %v, %v", formats, err)
+		}
+	}
+	if calls != 1 {
+		t.Errorf("load called %d times, want 1", calls)
+	}
+
+	c.invalidate("/dev/video0")
+	if _, err := c.formats("/dev/video0", load); err != nil {
+		t.Fatal(err)
+	}
+	if calls != 2 {
+		t.Errorf("load called %d times after invalidate, want 2", calls)
+	}
+}
+
+func TestCapabilityCache_ErrorsNotCached(t *testing.T) {
+	c := newCapabilityCache()
+	calls := 0
+	load := func() ([]Resolution, error) {
+		calls++
+		return nil, errors.New("device busy")
+	}
+
+	for range 2 {
+		if _, err := c.resolutions("/dev/video0", 1, load); err == nil {
+			t.Fatal("resolutions() error = nil, want error")
+		}
+	}
+	if calls != 2 {
+		t.Errorf("load called %d times, want 2", calls)
+	}
+}
+
+func TestCapabilityCache_FrameratesKeyed(t *testing.T) {
+	c := newCapabilityCache()
+	calls := 0
+	load := func() ([]Framerate, error) {
+		calls++
+		return []Framerate{{Numerator: 1, Denominator: 30}}, nil
+	}
+
+	keys := []framerateKey{
+		{pixelFormat: 1, width: 1920, height: 1080},
+		{pixelFormat: 1, width: 1280, height: 720},
+		{pixelFormat: 1, width: 1920, height: 1080},
+	}
+	for _, k := range keys {
+		if _, err := c.framerates("/dev/video0", k, load); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if calls != 2 {
+		t.Errorf("load called %d times, want 2 (one per distinct key)", calls)
+	}
+}
+
+func TestCapabilityCache_InvalidateDuringLoad(t *testing.T) {
+	c := newCapabilityCache()
+	load := func() ([]FormatInfo, error) {
+		// Device is unplugged while enumeration is in flight
+		c.invalidate("/dev/video0")
+		return []FormatInfo{{FormatName: "stale"}}, nil
+	}
+	if _, err := c.formats("/dev/video0", load); err != nil {
+		t.Fatal(err)
+	}
+
+	calls := 0
+	if _, err := c.formats("/dev/video0", func() ([]FormatInfo, error) {
+		calls++
+		return nil, nil
+	}); err != nil {
+		t.Fatal(err)
+	}
+	if calls != 1 {
+		t.Error("result of a load raced by invalidate was cached")
+	}
+}
@@ -6,6 +6,7 @@ import (
 	"context"
 	"errors"
 	"fmt"
+	"sort"
 	"sync"
 	"time"
 
@@ -15,12 +16,41 @@ import (
 	"github.com/smazurov/videonode/pkg/linuxav/v4l2"
 )
 
+const (
+	// hotplugSettleDelay is how long a burst of hotplug events must be quiet
+	// before the devices are rescanned. A capture card creates several video
+	// nodes, and udev needs a moment to create the by-id symlinks.
+	hotplugSettleDelay = 1 * time.Second
+
+	// safetyPollInterval is how often devices are rescanned while hotplug
+	// monitoring works, in case an event was missed.
+	safetyPollInterval = 60 * time.Second
+
+	// fallbackPollInterval is how often devices are rescanned when hotplug
+	// monitoring isn't available.
+	fallbackPollInterval = 2 * time.Second
+)
+
+// signalRecheckDelays are the rechecks after a signal event that didn't
+// lock yet, for receivers that report a change before they settle.
+var signalRecheckDelays = []time.Duration{
+	50 * time.Millisecond,
+	150 * time.Millisecond,
+	400 * time.Millisecond,
+	1 * time.Second,
+	2 * time.Second,
+}
+
 type linuxDetector struct {
 	ctx         context.Context
 	cancel      context.CancelFunc
 	broadcaster EventBroadcaster
-	lastDevices map[string]DeviceInfo // key is DeviceID
+	lastDevices map[string]DeviceInfo  // key is DeviceID
+	monitoring  bool                   // lastDevices is kept current, serve lookups from it
+	signals     *v4l2.EventMux         // source change events of HDMI devices, nil if unavailable
+	rechecks    map[string]*time.Timer // pending signal rechecks, key is DeviceID
 	mu          sync.Mutex
+	caps        *capabilityCache
 	logger      logging.Logger
 	eventBus    *events.Bus
 }
@@ -28,12 +58,32 @@ type linuxDetector struct {
 func newDetector() DeviceDetector {
 	return &linuxDetector{
 		lastDevices: make(map[string]DeviceInfo),
+		rechecks:    make(map[string]*time.Timer),
+		caps:        newCapabilityCache(),
 		logger:      logging.GetLogger("devices"),
 	}
 }
 
 // FindDevices returns all currently available V4L2 devices.
+// While monitoring, this is the in-memory inventory, sorted by device path.
 func (d *linuxDetector) FindDevices() ([]DeviceInfo, error) {
+	d.mu.Lock()
+	if d.monitoring {
+		devices := make([]DeviceInfo, 0, len(d.lastDevices))
+		for _, device := range d.lastDevices {
+			devices = append(devices, device)
+		}
+		d.mu.Unlock()
+		sort.Slice(devices, func(i, j int) bool { return devices[i].DevicePath < devices[j].DevicePath })
+		return devices, nil
+	}
+	d.mu.Unlock()
+
+	return d.scanDevices()
+}
+
+// scanDevices enumerates the V4L2 devices from the hardware.
+func (d *linuxDetector) scanDevices() ([]DeviceInfo, error) {
 	v4l2Devices, err := v4l2.FindDevices()
 	if err != nil {
 		return nil, err
@@ -59,6 +109,13 @@ func (d *linuxDetector) FindDevices() ([]DeviceInfo, error) {
 
 // GetDeviceFormats returns supported formats for a device.
 func (d *linuxDetector) GetDeviceFormats(devicePath string) ([]FormatInfo, error) {
+	return d.caps.formats(devicePath, func() ([]FormatInfo, error) {
+		return queryFormats(devicePath)
+	})
+}
+
+// queryFormats enumerates the formats of a device from the hardware.
+func queryFormats(devicePath string) ([]FormatInfo, error) {
 	v4l2Formats, err := v4l2.GetFormats(devicePath)
 	if err != nil {
 		return nil, err
@@ -78,11 +135,29 @@ func (d *linuxDetector) GetDeviceFormats(devicePath string) ([]FormatInfo, error
 
 // GetDevicePathByID returns the device path for a given device ID.
 func (d *linuxDetector) GetDevicePathByID(deviceID string) (string, error) {
+	d.mu.Lock()
+	if d.monitoring {
+		device, exists := d.lastDevices[deviceID]
+		d.mu.Unlock()
+		if !exists {
+			return "", fmt.Errorf("device with ID %s not found", deviceID)
+		}
+		return device.DevicePath, nil
+	}
+	d.mu.Unlock()
+
 	return v4l2.GetDevicePathByID(deviceID)
 }
 
 // GetDeviceResolutions returns supported resolutions for a format.
 func (d *linuxDetector) GetDeviceResolutions(devicePath string, pixelFormat uint32) ([]Resolution, error) {
+	return d.caps.resolutions(devicePath, pixelFormat, func() ([]Resolution, error) {
+		return queryResolutions(devicePath, pixelFormat)
+	})
+}
+
+// queryResolutions enumerates the resolutions of a format from the hardware.
+func queryResolutions(devicePath string, pixelFormat uint32) ([]Resolution, error) {
 	v4l2Resolutions, err := v4l2.GetResolutions(devicePath, pixelFormat)
 	if err != nil {
 		return nil, err
@@ -101,6 +176,14 @@ func (d *linuxDetector) GetDeviceResolutions(devicePath string, pixelFormat uint
 
 // GetDeviceFramerates returns supported framerates for a resolution.
 func (d *linuxDetector) GetDeviceFramerates(devicePath string, pixelFormat uint32, width, height uint32) ([]Framerate, error) {
+	key := framerateKey{pixelFormat: pixelFormat, width: width, height: height}
+	return d.caps.framerates(devicePath, key, func() ([]Framerate, error) {
+		return queryFramerates(devicePath, pixelFormat, width, height)
+	})
+}
+
+// queryFramerates enumerates the framerates of a resolution from the hardware.
+func queryFramerates(devicePath string, pixelFormat uint32, width, height uint32) ([]Framerate, error) {
 	v4l2Framerates, err := v4l2.GetFramerates(devicePath, pixelFormat, width, height)
 	if err != nil {
 		return nil, err
@@ -127,7 +210,7 @@ func (d *linuxDetector) StartMonitoring(ctx context.Context, broadcaster EventBr
 	d.broadcaster = broadcaster
 
 	// Initialize with current devices
-	devices, err := d.FindDevices()
+	devices, err := d.scanDevices()
 	if err != nil {
 		d.logger.Warn("Failed to get initial device list", "error", err)
 	} else {
@@ -161,17 +244,33 @@ func (d *linuxDetector) StartMonitoring(ctx context.Context, broadcaster EventBr
 		}
 		d.logger.Info("Initialized with V4L2 devices", "count", len(devices))
 	}
+	d.monitoring = true
+
+	// One epoll loop watches source change events of all HDMI devices
+	signals, err := v4l2.NewEventMux(d.handleSignalEvent)
+	if err != nil {
+		d.logger.Warn("Failed to create signal event monitor, signal loss detected via stream crashes only", "error", err)
+	} else {
+		d.signals = signals
+		go func() {
+			if err := signals.Run(d.ctx); err != nil && !errors.Is(err, context.Canceled) {
+				d.logger.Error("Signal event monitor error", "error", err)
+			}
+		}()
+		for _, device := range d.lastDevices {
+			d.watchSignal(device)
+		}
+		d.logger.Info("Signal monitoring started for HDMI devices")
+	}
 
 	// Start hotplug monitoring via netlink
 	go d.monitorHotplug()
 
-	// Start signal monitoring for HDMI devices
-	go d.monitorDeviceSignals()
-
 	return nil
 }
 
-// monitorHotplug monitors for device additions/removals via netlink.
+// monitorHotplug keeps the device inventory current from netlink hotplug
+// events, with a slow periodic rescan as a safety net.
 func (d *linuxDetector) monitorHotplug() {
 	monitor, err := hotplug.NewMonitor()
 	if err != nil {
@@ -181,8 +280,8 @@ func (d *linuxDetector) monitorHotplug() {
 	}
 	defer func() { _ = monitor.Close() }()
 
-	// Filter for USB devices (which includes USB webcams and capture cards)
-	monitor.AddSubsystemFilter(hotplug.SubsystemUSB)
+	// video4linux events cover every video node, USB or platform
+	monitor.AddSubsystemFilter(hotplug.SubsystemVideo4Linux)
 
 	events := make(chan hotplug.Event, 32)
 	go func() {
@@ -193,6 +292,14 @@ func (d *linuxDetector) monitorHotplug() {
 
 	d.logger.Info("Hotplug monitoring started via netlink")
 
+	safetyPoll := time.NewTicker(safetyPollInterval)
+	defer safetyPoll.Stop()
+
+	// settle fires once a burst of events has been quiet for hotplugSettleDelay
+	settle := time.NewTimer(hotplugSettleDelay)
+	settle.Stop()
+	defer settle.Stop()
+
 	for {
 		select {
 		case <-d.ctx.Done():
@@ -204,34 +311,35 @@ func (d *linuxDetector) monitorHotplug() {
 				return
 			}
 
-			// Only process USB device add/remove events
-			if event.DevType != "usb_device" {
+			if event.Action != hotplug.ActionAdd && event.Action != hotplug.ActionRemove {
 				continue
 			}
 
-			if event.Action == hotplug.ActionAdd || event.Action == hotplug.ActionRemove {
-				d.logger.Debug("USB hotplug event",
-					"action", event.Action,
-					"devpath", event.DevPath,
-					"devtype", event.DevType)
+			d.logger.Debug("V4L2 hotplug event",
+				"action", event.Action,
+				"devname", event.DevName,
+				"devpath", event.DevPath)
 
-				// Give kernel time to enumerate V4L2 devices for add events
-				if event.Action == hotplug.ActionAdd {
-					time.Sleep(1 * time.Second)
-				}
-
-				d.checkAndBroadcastDeviceChanges()
+			// The node is gone or about to be reused, don't serve its old capabilities
+			if event.DevName != "" {
+				d.caps.invalidate("/dev/" + event.DevName)
 			}
+
+			settle.Reset(hotplugSettleDelay)
+		case <-settle.C:
+			d.checkAndBroadcastDeviceChanges()
+		case <-safetyPoll.C:
+			d.checkAndBroadcastDeviceChanges()
 		}
 	}
 }
 
 // pollDeviceChanges is a fallback that periodically checks for device additions/removals.
 func (d *linuxDetector) pollDeviceChanges() {
-	ticker := time.NewTicker(2 * time.Second)
+	ticker := time.NewTicker(fallbackPollInterval)
 	defer ticker.Stop()
 
-	d.logger.Info("Device polling started (fallback mode, checking every 2 seconds)")
+	d.logger.Info("Device polling started (fallback mode)", "interval", fallbackPollInterval)
 
 	for {
 		select {
@@ -253,6 +361,15 @@ func (d *linuxDetector) StopMonitoring() {
 		d.cancel()
 		d.cancel = nil
 	}
+	if d.signals != nil {
+		_ = d.signals.Close()
+		d.signals = nil
+	}
+	for id, t := range d.rechecks {
+		t.Stop()
+		delete(d.rechecks, id)
+	}
+	d.monitoring = false
 }
 
 // SetEventBus sets the event bus for stream crash notifications.
@@ -274,162 +391,111 @@ func (d *linuxDetector) handleStreamCrashed(e events.StreamCrashedEvent) {
 	}
 
 	d.logger.Debug("Stream crash, checking HDMI signal", "device_id", e.DeviceID)
+	d.checkSignal(e.DeviceID, 0)
+}
 
-	status := v4l2.GetDVTimings(device.DevicePath)
-	newReady := (status.State == v4l2.SignalStateLocked)
+// watchSignal registers an HDMI device with the signal event mux.
+// Caller may hold d.mu.
+func (d *linuxDetector) watchSignal(device DeviceInfo) {
+	if d.signals == nil || device.Type != DeviceTypeHDMI {
+		return
+	}
+	if err := d.signals.Add(device.DevicePath); err != nil {
+		d.logger.Debug("Source change events not available, signal loss detected via stream crashes only",
+			"device_id", device.DeviceID,
+			"path", device.DevicePath,
+			"error", err)
+	}
+}
 
-	d.mu.Lock()
-	device, exists = d.lastDevices[e.DeviceID]
-	if !exists {
-		d.mu.Unlock()
+// handleSignalEvent handles a V4L2 event from the signal mux. It runs on the
+// mux goroutine, so it only does quick non-blocking ioctls.
+func (d *linuxDetector) handleSignalEvent(e v4l2.DeviceEvent) {
+	if e.Kind == v4l2.EventDeviceGone {
+		// The hotplug rescan takes care of the inventory
+		d.logger.Debug("Device gone from signal monitor", "path", e.DevicePath)
 		return
 	}
 
-	if device.Ready && !newReady {
-		reason := signalStateString(status.State)
-		d.logger.Warn("HDMI signal lost (detected via crash)",
-			"device_id", e.DeviceID,
-			"device_name", device.DeviceName,
-			"reason", reason)
-		device.Ready = false
-		d.lastDevices[e.DeviceID] = device
-		d.broadcaster.BroadcastDeviceDiscovery("status_changed", device, time.Now().Format(time.RFC3339))
-		d.mu.Unlock()
-		go d.monitorDeviceEvents(e.DeviceID, device.DevicePath)
-	} else {
-		d.mu.Unlock()
+	d.mu.Lock()
+	var deviceID string
+	for id, device := range d.lastDevices {
+		if device.DevicePath == e.DevicePath {
+			deviceID = id
+			break
+		}
+	}
+	d.mu.Unlock()
+
+	if deviceID == "" {
+		return
 	}
-}
 
-// monitorDeviceSignals monitors HDMI devices using event-based monitoring.
-func (d *linuxDetector) monitorDeviceSignals() {
-	d.logger.Info("Signal monitoring started for HDMI devices")
+	d.logger.Debug("Signal event received",
+		"device_id", deviceID,
+		"kind", e.Kind,
+		"changes", e.Changes,
+		"value", e.Value)
 
-	// Start event-based monitoring for HDMI devices without signal
-	d.startEventMonitors()
+	d.checkSignal(deviceID, 0)
 }
 
-// startEventMonitors starts event monitoring for HDMI devices without signal.
-func (d *linuxDetector) startEventMonitors() {
+// checkSignal queries an HDMI device's signal and updates its ready state.
+// If the signal isn't locked yet it schedules a recheck, attempt counts
+// them. A new event or crash check supersedes any pending recheck.
+func (d *linuxDetector) checkSignal(deviceID string, attempt int) {
 	d.mu.Lock()
-	defer d.mu.Unlock()
+	if t, pending := d.rechecks[deviceID]; pending {
+		t.Stop()
+		delete(d.rechecks, deviceID)
+	}
+	device, exists := d.lastDevices[deviceID]
+	d.mu.Unlock()
 
-	for deviceID, device := range d.lastDevices {
-		// Only monitor HDMI devices (use cached type)
-		if device.Type != DeviceTypeHDMI {
-			continue
-		}
+	if !exists {
+		return
+	}
 
-		// If device doesn't have signal, start event monitor
-		if !device.Ready {
-			go d.monitorDeviceEvents(deviceID, device.DevicePath)
-		}
+	// Query detected timings from hardware, then verify signal lock.
+	// Rockchip driver auto-configures timings, so we just need to verify lock
+	status := v4l2.SignalStatus{State: v4l2.SignalStateNoSignal}
+	if _, err := v4l2.QueryDVTimings(device.DevicePath); err == nil {
+		status = v4l2.GetDVTimings(device.DevicePath)
 	}
-}
+	ready := status.State == v4l2.SignalStateLocked
 
-// monitorDeviceEvents waits for source change events on a specific device.
-func (d *linuxDetector) monitorDeviceEvents(deviceID, devicePath string) {
-	d.logger.Debug("Starting event monitor for HDMI device", "device_id", deviceID)
+	d.mu.Lock()
+	defer d.mu.Unlock()
 
-	for {
-		select {
-		case <-d.ctx.Done():
-			d.logger.Debug("Event monitor stopped", "device_id", deviceID)
-			return
-		default:
-			// Wait for source change event (blocking with 60 second timeout)
-			result, err := v4l2.WaitForSourceChange(devicePath, 60000)
-			if err != nil {
-				d.logger.Debug("Event monitoring not supported, falling back to polling only",
-					"device_id", deviceID,
-					"error", err)
-				return
-			}
+	device, exists = d.lastDevices[deviceID]
+	if !exists {
+		return
+	}
 
-			if result > 0 {
-				d.logger.Debug("Source change event received", "device_id", deviceID, "changes", result)
-
-				// Query detected timings and verify signal lock
-				// Rockchip driver auto-configures timings, so we just need to verify lock
-				const maxRetries = 5
-				const retryDelay = 1 * time.Second
-				var status v4l2.SignalStatus
-				var ready bool
-				var attempt int
-
-				for attempt = 0; attempt < maxRetries; attempt++ {
-					d.logger.Debug("Attempting signal detection",
-						"device_id", deviceID,
-						"attempt", attempt+1,
-						"device_path", devicePath)
-
-					// Query detected timings from hardware
-					_, err := v4l2.QueryDVTimings(devicePath)
-					if err != nil {
-						d.logger.Debug("QueryDVTimings failed",
-							"device_id", deviceID,
-							"attempt", attempt+1,
-							"error", err)
-						time.Sleep(retryDelay)
-						continue
-					}
-					d.logger.Debug("QueryDVTimings succeeded",
-						"device_id", deviceID,
-						"attempt", attempt+1)
-
-					// Verify signal is locked
-					status = v4l2.GetDVTimings(devicePath)
-					d.logger.Debug("GetDVTimings result",
-						"device_id", deviceID,
-						"state", signalStateString(status.State),
-						"width", status.Width,
-						"height", status.Height,
-						"fps", fmt.Sprintf("%.2f", status.FPS))
+	if ready != device.Ready {
+		if ready {
+			d.logger.Info("HDMI device signal acquired",
+				"device_id", deviceID,
+				"device_name", device.DeviceName,
+				"resolution", fmt.Sprintf("%dx%d", status.Width, status.Height),
+				"fps", fmt.Sprintf("%.2f", status.FPS))
+		} else {
+			d.logger.Warn("HDMI signal lost",
+				"device_id", deviceID,
+				"device_name", device.DeviceName,
+				"reason", signalStateString(status.State))
+		}
 
-					if status.State == v4l2.SignalStateLocked {
-						ready = true
-						d.logger.Info("Signal locked successfully",
-							"device_id", deviceID,
-							"resolution", fmt.Sprintf("%dx%d", status.Width, status.Height),
-							"fps", fmt.Sprintf("%.2f", status.FPS),
-							"attempts", attempt+1)
-						break
-					}
-
-					d.logger.Debug("Signal not locked yet, retrying",
-						"device_id", deviceID,
-						"attempt", attempt+1,
-						"state", signalStateString(status.State))
-					time.Sleep(retryDelay)
-				}
+		device.Ready = ready
+		d.lastDevices[deviceID] = device
+		d.caps.invalidate(device.DevicePath)
+		d.broadcaster.BroadcastDeviceDiscovery("status_changed", device, time.Now().Format(time.RFC3339))
+	}
 
-				d.mu.Lock()
-				if device, exists := d.lastDevices[deviceID]; exists {
-					if ready && !device.Ready {
-						d.logger.Info("HDMI device signal acquired (via event)",
-							"device_id", deviceID,
-							"device_name", device.DeviceName,
-							"resolution", fmt.Sprintf("%dx%d", status.Width, status.Height),
-							"fps", fmt.Sprintf("%.2f", status.FPS))
-
-						device.Ready = ready
-						d.lastDevices[deviceID] = device
-						d.broadcaster.BroadcastDeviceDiscovery("status_changed", device, time.Now().Format(time.RFC3339))
-						d.mu.Unlock()
-
-						// Signal is now present, stop event monitoring
-						d.logger.Debug("Stopping event monitor, signal present", "device_id", deviceID)
-						return
-					} else if !ready {
-						d.logger.Error("Signal not locked after retries",
-							"device_id", deviceID,
-							"retries", attempt+1,
-							"state", signalStateString(status.State))
-					}
-				}
-				d.mu.Unlock()
-			}
-		}
+	if !ready && attempt < len(signalRecheckDelays) && d.ctx.Err() == nil {
+		d.rechecks[deviceID] = time.AfterFunc(signalRecheckDelays[attempt], func() {
+			d.checkSignal(deviceID, attempt+1)
+		})
 	}
 }
 
@@ -455,7 +521,7 @@ func signalStateString(state v4l2.SignalState) string {
 
 // checkAndBroadcastDeviceChanges checks for V4L2 device changes and broadcasts if needed.
 func (d *linuxDetector) checkAndBroadcastDeviceChanges() {
-	devices, err := d.FindDevices()
+	devices, err := d.scanDevices()
 	if err != nil {
 		d.logger.Error("Error getting device data", "error", err)
 		return
@@ -476,6 +542,10 @@ func (d *linuxDetector) checkAndBroadcastDeviceChanges() {
 			d.broadcaster.BroadcastDeviceDiscovery("removed", oldDevice, time.Now().Format(time.RFC3339))
 			d.logger.Info("Device removed", "device", oldDevice.DevicePath, "name", oldDevice.DeviceName, "id", deviceID)
 			delete(d.lastDevices, deviceID)
+			d.caps.invalidate(oldDevice.DevicePath)
+			if d.signals != nil {
+				d.signals.Remove(oldDevice.DevicePath)
+			}
 		}
 	}
 
@@ -488,16 +558,19 @@ func (d *linuxDetector) checkAndBroadcastDeviceChanges() {
 			d.broadcaster.BroadcastDeviceDiscovery("added", newDevice, time.Now().Format(time.RFC3339))
 			d.logger.Info("Device added", "device", newDevice.DevicePath, "name", newDevice.DeviceName, "id", deviceID)
 			d.lastDevices[deviceID] = newDevice
-
-			// If it's an HDMI device without signal, start event monitoring (use cached type)
-			if newDevice.Type == DeviceTypeHDMI && !newDevice.Ready {
-				go d.monitorDeviceEvents(deviceID, newDevice.DevicePath)
-			}
+			d.caps.invalidate(newDevice.DevicePath)
+			d.watchSignal(newDevice)
 		} else if oldDevice != newDevice {
 			// Device changed (shouldn't happen often)
 			d.broadcaster.BroadcastDeviceDiscovery("changed", newDevice, time.Now().Format(time.RFC3339))
 			d.logger.Info("Device changed", "device", newDevice.DevicePath, "name", newDevice.DeviceName, "id", deviceID)
+			d.caps.invalidate(oldDevice.DevicePath)
+			d.caps.invalidate(newDevice.DevicePath)
+			if d.signals != nil && oldDevice.DevicePath != newDevice.DevicePath {
+				d.signals.Remove(oldDevice.DevicePath)
+			}
 			d.lastDevices[deviceID] = newDevice
+			d.watchSignal(newDevice)
 		}
 	}
 }
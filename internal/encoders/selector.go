@@ -170,6 +170,14 @@ func (s *DefaultSelector) getEncoderSettingsFromValidator(validator validation.E
 		return nil
 	}
 
+	// Prefer the zero-copy path when validate-encoders proved it works on this machine
+	if zeroCopy, ok := validator.(validation.ZeroCopyValidator); ok && s.validationManager.IsZeroCopyWorking(encoderName, inputFormat) {
+		if zeroCopySettings, zeroCopyErr := zeroCopy.GetZeroCopySettings(encoderName, inputFormat); zeroCopyErr == nil {
+			s.logger.Info("Using zero-copy input path", "encoder", encoderName, "input_format", inputFormat)
+			settings = zeroCopySettings
+		}
+	}
+
 	// If quality params are provided, get quality-specific encoder params and merge
 	if qualityParams != nil {
 		qualityEncoderParams, qualityErr := validator.GetQualityParams(encoderName, qualityParams)
@@ -3,10 +3,14 @@ package encoders
 import (
 	"fmt"
 	"log/slog"
+	"os"
 	"os/exec"
+	"slices"
 	"strings"
+	"sync"
 	"time"
 
+	"github.com/smazurov/videonode/internal/encoders/validation"
 	"github.com/smazurov/videonode/internal/types"
 )
 
@@ -14,6 +18,7 @@ import (
 type Validator struct {
 	provider types.ValidationProvider
 	logger   ValidationLogger
+	force    bool // Re-test encoders with cached results
 }
 
 // NewValidator creates a new Validator with the given ValidationProvider.
@@ -29,6 +34,12 @@ func (v *Validator) SetLogger(logger ValidationLogger) {
 	v.logger = logger
 }
 
+// SetForce makes ValidateEncoders re-test every encoder instead of reusing
+// results from an unchanged environment.
+func (v *Validator) SetForce(force bool) {
+	v.force = force
+}
+
 // ValidateEncoder tests a single encoder using the appropriate validator.
 func ValidateEncoder(encoderName string) (bool, error) {
 	registry := CreateValidatorRegistry()
@@ -69,11 +80,36 @@ func (l *VerboseLogger) Printf(format string, v ...any) {
 	l.logger.Info(fmt.Sprintf(format, v...))
 }
 
+// softwareValidationConcurrency limits concurrent validations of encoders
+// that don't run on a hardware device. Each already uses several CPU threads.
+const softwareValidationConcurrency = 2
+
+// validationJob is one encoder to validate.
+type validationJob struct {
+	validator   validation.EncoderValidator
+	encoderName string
+	fingerprint string // Environment the result depends on, "" if unknown
+}
+
+// validationOutcome is the result of a validation job.
+type validationOutcome struct {
+	valid    bool
+	err      error
+	zeroCopy []string // Working zero-copy paths of a valid encoder
+	cached   bool     // Reused from previous results
+}
+
 // ValidateEncoders validates all encoders and returns results.
+//
+// Encoders are validated concurrently, limited per hardware family so a
+// device isn't overloaded. Results of the previous run are reused for
+// encoders whose environment fingerprint hasn't changed, unless the validator
+// is forced to re-test everything (see SetForce).
 func (v *Validator) ValidateEncoders() (*types.ValidationResults, error) {
+	ffmpegVersion := getFFmpegVersion()
 	results := &types.ValidationResults{
 		Timestamp:      time.Now().Format(time.RFC3339),
-		FFmpegVersion:  getFFmpegVersion(),
+		FFmpegVersion:  ffmpegVersion,
 		TestDuration:   2,
 		TestResolution: "640x480",
 		H264: types.CodecValidation{
@@ -84,6 +120,8 @@ func (v *Validator) ValidateEncoders() (*types.ValidationResults, error) {
 			Working: []string{},
 			Failed:  []string{},
 		},
+		ZeroCopy:     []string{},
+		Fingerprints: make(map[string]string),
 	}
 
 	registry := CreateValidatorRegistry()
@@ -93,40 +131,200 @@ func (v *Validator) ValidateEncoders() (*types.ValidationResults, error) {
 
 	v.logger.Printf("Found %d validator(s) with compiled encoders", len(availableValidators))
 
+	var jobs []validationJob
+	kernel := kernelRelease()
 	for _, validator := range availableValidators {
-		v.logger.Printf("=== %s ===", validator.GetDescription())
+		fingerprint := environmentFingerprint(validator, ffmpegVersion, kernel)
 
 		// Get only the compiled encoders for this validator
-		compiledEncoders := registry.GetCompiledEncoders(validator)
-
-		for _, encoderName := range compiledEncoders {
-			v.logger.Printf("Testing %s...", encoderName)
-
-			if valid, err := validator.Validate(encoderName); valid {
-				v.logger.Printf("%s: ✓ WORKING", encoderName)
-
-				// Categorize by codec type (including software encoders)
-				if strings.Contains(encoderName, "h264") || strings.Contains(encoderName, "x264") {
-					results.H264.Working = append(results.H264.Working, encoderName)
-				} else if strings.Contains(encoderName, "hevc") || strings.Contains(encoderName, "h265") || strings.Contains(encoderName, "x265") {
-					results.H265.Working = append(results.H265.Working, encoderName)
-				}
-			} else {
-				v.logger.Printf("%s: ✗ FAILED (%v)", encoderName, err)
-
-				// Categorize by codec type (including software encoders)
-				if strings.Contains(encoderName, "h264") || strings.Contains(encoderName, "x264") {
-					results.H264.Failed = append(results.H264.Failed, encoderName)
-				} else if strings.Contains(encoderName, "hevc") || strings.Contains(encoderName, "h265") || strings.Contains(encoderName, "x265") {
-					results.H265.Failed = append(results.H265.Failed, encoderName)
-				}
-			}
+		for _, encoderName := range registry.GetCompiledEncoders(validator) {
+			jobs = append(jobs, validationJob{validator: validator, encoderName: encoderName, fingerprint: fingerprint})
+		}
+	}
+
+	var previous *types.ValidationResults
+	if !v.force {
+		previous = v.provider.GetValidation()
+	}
+	outcomes := v.runValidations(jobs, previous)
+
+	var cached int
+	for i, job := range jobs {
+		outcome := outcomes[i]
+		if outcome.cached {
+			cached++
+		}
+
+		// Categorize by codec type (including software encoders)
+		var codec *types.CodecValidation
+		if strings.Contains(job.encoderName, "h264") || strings.Contains(job.encoderName, "x264") {
+			codec = &results.H264
+		} else if strings.Contains(job.encoderName, "hevc") || strings.Contains(job.encoderName, "h265") || strings.Contains(job.encoderName, "x265") {
+			codec = &results.H265
+		} else {
+			continue
 		}
+
+		if outcome.valid {
+			codec.Working = append(codec.Working, job.encoderName)
+			results.ZeroCopy = append(results.ZeroCopy, outcome.zeroCopy...)
+		} else {
+			codec.Failed = append(codec.Failed, job.encoderName)
+		}
+		if job.fingerprint != "" {
+			results.Fingerprints[job.encoderName] = job.fingerprint
+		}
+	}
+
+	if cached > 0 {
+		v.logger.Printf("Reused %d cached result(s) from an unchanged environment", cached)
 	}
 
 	return results, nil
 }
 
+// runValidations validates jobs concurrently and returns their outcomes in
+// job order. Jobs with a matching result in previous aren't run.
+func (v *Validator) runValidations(jobs []validationJob, previous *types.ValidationResults) []validationOutcome {
+	outcomes := make([]validationOutcome, len(jobs))
+	limits := make(map[string]chan struct{}) // hardware family -> semaphore
+
+	var wg sync.WaitGroup
+	for i, job := range jobs {
+		if outcome, ok := cachedOutcome(previous, job); ok {
+			v.logOutcome(job.encoderName, outcome)
+			outcomes[i] = outcome
+			continue
+		}
+
+		family, concurrency := validatorFamily(job.validator)
+		limit, ok := limits[family]
+		if !ok {
+			limit = make(chan struct{}, concurrency)
+			limits[family] = limit
+		}
+
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			limit <- struct{}{}
+			defer func() { <-limit }()
+
+			v.logger.Printf("Testing %s...", job.encoderName)
+			valid, err := job.validator.Validate(job.encoderName)
+			outcome := validationOutcome{valid: valid, err: err}
+			v.logOutcome(job.encoderName, outcome)
+
+			// Zero-copy paths use the same device, so they run in the encoder's slot
+			if valid {
+				outcome.zeroCopy = v.validateZeroCopy(job.validator, job.encoderName)
+			}
+			outcomes[i] = outcome
+		}()
+	}
+	wg.Wait()
+
+	return outcomes
+}
+
+// logOutcome logs the result of validating an encoder.
+func (v *Validator) logOutcome(encoderName string, outcome validationOutcome) {
+	switch {
+	case outcome.cached && outcome.valid:
+		v.logger.Printf("%s: ✓ WORKING (cached)", encoderName)
+	case outcome.cached:
+		v.logger.Printf("%s: ✗ FAILED (cached)", encoderName)
+	case outcome.valid:
+		v.logger.Printf("%s: ✓ WORKING", encoderName)
+	default:
+		v.logger.Printf("%s: ✗ FAILED (%v)", encoderName, outcome.err)
+	}
+}
+
+// cachedOutcome returns the previous result of a job if it was validated in
+// the same environment.
+func cachedOutcome(previous *types.ValidationResults, job validationJob) (validationOutcome, bool) {
+	if previous == nil || job.fingerprint == "" || previous.Fingerprints[job.encoderName] != job.fingerprint {
+		return validationOutcome{}, false
+	}
+
+	name := job.encoderName
+	switch {
+	case slices.Contains(previous.H264.Working, name) || slices.Contains(previous.H265.Working, name):
+		outcome := validationOutcome{valid: true, cached: true}
+		prefix := types.ZeroCopyPath(name, "")
+		for _, path := range previous.ZeroCopy {
+			if strings.HasPrefix(path, prefix) {
+				outcome.zeroCopy = append(outcome.zeroCopy, path)
+			}
+		}
+		return outcome, true
+	case slices.Contains(previous.H264.Failed, name) || slices.Contains(previous.H265.Failed, name):
+		return validationOutcome{cached: true}, true
+	default:
+		return validationOutcome{}, false
+	}
+}
+
+// validatorFamily returns the hardware family of a validator's encoders and
+// how many of them may be validated at once.
+func validatorFamily(validator validation.EncoderValidator) (string, int) {
+	hardware, ok := validator.(validation.HardwareValidator)
+	if !ok {
+		return "software", softwareValidationConcurrency
+	}
+
+	info := hardware.GetHardwareInfo()
+	return info.Family, max(info.Concurrency, 1)
+}
+
+// environmentFingerprint describes the environment a validator's results
+// depend on: the FFmpeg version and, for hardware encoders, the kernel, device
+// node and the driver bound to it. Returns "" if the FFmpeg version is
+// unknown, so results are never reused.
+func environmentFingerprint(validator validation.EncoderValidator, ffmpegVersion string, kernel string) string {
+	if ffmpegVersion == "" || ffmpegVersion == "unknown" {
+		return ""
+	}
+
+	fingerprint := "ffmpeg=" + ffmpegVersion
+	if hardware, ok := validator.(validation.HardwareValidator); ok {
+		device := hardware.GetHardwareInfo().Device
+		fingerprint += ";kernel=" + kernel + ";device=" + device + ";driver=" + validation.DeviceDriver(device)
+	}
+	return fingerprint
+}
+
+// kernelRelease returns the running kernel's release, e.g. "6.1.0-rockchip".
+func kernelRelease() string {
+	release, err := os.ReadFile("/proc/sys/kernel/osrelease")
+	if err != nil {
+		return "unknown"
+	}
+	return strings.TrimSpace(string(release))
+}
+
+// validateZeroCopy tests every zero-copy input path of a working encoder and
+// returns the ones that work. Paths that fail are left to the CPU conversion
+// in the encoder's production settings.
+func (v *Validator) validateZeroCopy(validator validation.EncoderValidator, encoderName string) []string {
+	zeroCopy, ok := validator.(validation.ZeroCopyValidator)
+	if !ok {
+		return nil
+	}
+
+	var working []string
+	for _, inputFormat := range zeroCopy.GetZeroCopyFormats(encoderName) {
+		if valid, err := validation.ValidateZeroCopy(zeroCopy, encoderName, inputFormat); valid {
+			v.logger.Printf("%s from %s: ✓ ZERO-COPY", encoderName, inputFormat)
+			working = append(working, types.ZeroCopyPath(encoderName, inputFormat))
+		} else {
+			v.logger.Printf("%s from %s: ✗ zero-copy unavailable, using CPU conversion (%v)", encoderName, inputFormat, err)
+		}
+	}
+	return working
+}
+
 // SaveValidationResults saves validation results using ValidationProvider.
 func (v *Validator) SaveValidationResults(results *types.ValidationResults) error {
 	// Update validation data directly through provider
@@ -166,6 +364,10 @@ func PrintValidationSummary(results *types.ValidationResults) {
 		fmt.Printf("  Working: %s\n", strings.Join(results.H265.Working, ", "))
 	}
 
+	if len(results.ZeroCopy) > 0 {
+		fmt.Printf("Zero-copy input paths: %s\n", strings.Join(results.ZeroCopy, ", "))
+	}
+
 	if len(results.H264.Failed) > 0 || len(results.H265.Failed) > 0 {
 		fmt.Println("\nFailed encoders:")
 		if len(results.H264.Failed) > 0 {
@@ -205,8 +407,10 @@ func (v *Validator) RunValidateCommand(quiet bool) error {
 }
 
 // RunValidateCommandWithOptions runs validation with ValidationProvider - for backward compatibility.
-func RunValidateCommandWithOptions(provider types.ValidationProvider, quiet bool) {
+// With force, encoders are re-tested even if their environment is unchanged.
+func RunValidateCommandWithOptions(provider types.ValidationProvider, quiet bool, force bool) {
 	v := NewValidator(provider)
+	v.SetForce(force)
 	if err := v.RunValidateCommand(quiet); err != nil {
 		logger := slog.With("component", "encoder_validation")
 		logger.Error("Validation command failed", "error", err)
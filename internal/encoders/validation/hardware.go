@@ -0,0 +1,41 @@
+package validation
+
+import "path/filepath"
+
+// sysClassDir is where device classes are listed in sysfs.
+var sysClassDir = "/sys/class"
+
+// HardwareInfo describes the device a validator's encoders run on.
+type HardwareInfo struct {
+	Family      string // Hardware family, e.g. "vaapi"
+	Device      string // Device node the encoders open, e.g. /dev/dri/renderD128
+	Concurrency int    // Encoders of the family that may be validated at once
+}
+
+// HardwareValidator is implemented by validators whose encoders share a
+// hardware device. Validations are limited to the family's concurrency so one
+// device isn't overloaded, and cached results are invalidated when the
+// device's kernel driver changes. Validators without it are treated as
+// software encoders.
+type HardwareValidator interface {
+	EncoderValidator
+
+	// GetHardwareInfo returns the device the encoders run on
+	GetHardwareInfo() HardwareInfo
+}
+
+// DeviceDriver returns the name of the kernel driver bound to a device node,
+// e.g. "i915" for /dev/dri/renderD128, or "" if the device doesn't exist.
+func DeviceDriver(device string) string {
+	matches, err := filepath.Glob(filepath.Join(sysClassDir, "*", filepath.Base(device), "device", "driver"))
+	if err != nil {
+		return ""
+	}
+
+	for _, match := range matches {
+		if target, linkErr := filepath.EvalSymlinks(match); linkErr == nil {
+			return filepath.Base(target)
+		}
+	}
+	return ""
+}
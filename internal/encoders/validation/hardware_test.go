@@ -0,0 +1,32 @@
+package validation
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestDeviceDriver(t *testing.T) {
+	root := t.TempDir()
+	driverDir := filepath.Join(root, "bus", "pci", "drivers", "i915")
+	deviceDir := filepath.Join(root, "class", "drm", "renderD128", "device")
+	for _, dir := range []string{driverDir, deviceDir} {
+		if err := os.MkdirAll(dir, 0o755); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := os.Symlink(driverDir, filepath.Join(deviceDir, "driver")); err != nil {
+		t.Fatal(err)
+	}
+
+	original := sysClassDir
+	sysClassDir = filepath.Join(root, "class")
+	defer func() { sysClassDir = original }()
+
+	if got := DeviceDriver("/dev/dri/renderD128"); got != "i915" {
+		t.Errorf("DeviceDriver(renderD128) = %q, want i915", got)
+	}
+	if got := DeviceDriver("/dev/dri/renderD129"); got != "" {
+		t.Errorf("DeviceDriver(renderD129) = %q, want empty", got)
+	}
+}
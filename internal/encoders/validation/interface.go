@@ -178,6 +178,12 @@ func ValidateEncoderWithSettings(validator EncoderValidator, encoderName string)
 	// Add output file and overwrite flag
 	cmdParts = append(cmdParts, "-y", testFile)
 
+	return runValidationCommand(cmdParts, testFile)
+}
+
+// runValidationCommand runs an FFmpeg validation command with a timeout and
+// checks that it produced a non-trivial output file.
+func runValidationCommand(cmdParts []string, outputFile string) (bool, error) {
 	// Log the command for debugging
 	fmt.Printf("Executing FFmpeg command: %s\n", strings.Join(cmdParts, " "))
 
@@ -208,7 +214,7 @@ func ValidateEncoderWithSettings(validator EncoderValidator, encoderName string)
 		return false, fmt.Errorf("validation command timed out")
 	}
 
-	if fileInfo, statErr := os.Stat(testFile); statErr == nil && fileInfo.Size() > 1000 {
+	if fileInfo, statErr := os.Stat(outputFile); statErr == nil && fileInfo.Size() > 1000 {
 		return true, nil
 	}
 	return false, fmt.Errorf("output file missing or too small")
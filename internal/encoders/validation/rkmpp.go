@@ -40,6 +40,12 @@ func (v *RkmppValidator) GetDescription() string {
 	return "RKMPP (Rockchip Media Process Platform) - Hardware acceleration for Rockchip SoCs"
 }
 
+// GetHardwareInfo returns the MPP service RKMPP encoders share. It runs one
+// encode job at a time, so validations are not run in parallel.
+func (v *RkmppValidator) GetHardwareInfo() HardwareInfo {
+	return HardwareInfo{Family: "rkmpp", Device: "/dev/mpp_service", Concurrency: 1}
+}
+
 // GetProductionSettings returns production settings for RKMPP encoders.
 func (v *RkmppValidator) GetProductionSettings(encoderName string, inputFormat string) (*EncoderSettings, error) {
 	if !v.CanValidate(encoderName) {
@@ -72,16 +78,10 @@ func (v *RkmppValidator) GetProductionSettings(encoderName string, inputFormat s
 		// Test sources work better without RGA hardware filters on Rockchip
 		// RKMPP can handle yuv420p directly from test sources
 		settings.VideoFilters = ""
-	case "mjpeg":
-		// Use hardware MJPEG decode for best performance
-		// This keeps everything in hardware
-		settings.GlobalArgs = append(settings.GlobalArgs, "-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime")
-		settings.VideoFilters = "" // No filter needed with HW decode
-	case "h264":
-		// For H264 input, use hardware decode for best performance
-		// This keeps everything in hardware
-		settings.GlobalArgs = append(settings.GlobalArgs, "-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime")
-		settings.VideoFilters = "" // No filter needed with HW decode
+	case "mjpeg", "h264":
+		// Software decode; the hardware decode path is in GetZeroCopySettings
+		// and only used once validated
+		settings.VideoFilters = "format=nv12"
 	case "yuyv422", "yuvj422":
 		// Use RGA hardware scaler for format conversion (much faster than CPU)
 		// Need to initialize hardware device and upload frames to hardware memory
@@ -105,6 +105,37 @@ func (v *RkmppValidator) GetProductionSettings(encoderName string, inputFormat s
 	return settings, nil
 }
 
+// GetZeroCopyFormats returns the input formats with a zero-copy path into RKMPP encoders.
+func (v *RkmppValidator) GetZeroCopyFormats(encoderName string) []string {
+	if !strings.HasPrefix(encoderName, "h264_") && !strings.HasPrefix(encoderName, "hevc_") {
+		return nil
+	}
+	return []string{"mjpeg", "h264"}
+}
+
+// GetZeroCopySettings returns settings that decode compressed input with
+// MPP into DRM PRIME buffers the encoder imports directly.
+func (v *RkmppValidator) GetZeroCopySettings(encoderName string, inputFormat string) (*EncoderSettings, error) {
+	if strings.Contains(encoderName, "mjpeg") {
+		return nil, fmt.Errorf("%w: %s", ErrNoZeroCopyPath, inputFormat)
+	}
+
+	settings, err := v.GetProductionSettings(encoderName, inputFormat)
+	if err != nil {
+		return nil, err
+	}
+
+	switch inputFormat {
+	case "mjpeg", "h264":
+		settings.GlobalArgs = []string{"-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime"}
+		settings.VideoFilters = "" // No filter needed with HW decode
+	default:
+		return nil, fmt.Errorf("%w: %s", ErrNoZeroCopyPath, inputFormat)
+	}
+
+	return settings, nil
+}
+
 // GetQualityParams translates quality settings to RKMPP encoder parameters.
 func (v *RkmppValidator) GetQualityParams(encoderName string, params *types.QualityParams) (EncoderParams, error) {
 	if !v.CanValidate(encoderName) {
@@ -1,6 +1,8 @@
 package validation
 
 import (
+	"errors"
+	"slices"
 	"testing"
 
 	"github.com/smazurov/videonode/internal/types"
@@ -150,20 +152,20 @@ func TestRkmppValidator_GetProductionSettings(t *testing.T) {
 		wantErr        bool
 	}{
 		{
-			name:           "MJPEG input with hardware decode",
+			name:           "MJPEG input with software decode",
 			encoderName:    "h264_rkmpp",
 			inputFormat:    "mjpeg",
-			wantFilters:    "",
-			wantGlobalArgs: []string{"-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime"},
+			wantFilters:    "format=nv12",
+			wantGlobalArgs: []string{},
 			wantRcMode:     "VBR",
 			wantErr:        false,
 		},
 		{
-			name:           "H264 input with hardware decode",
+			name:           "H264 input with software decode",
 			encoderName:    "hevc_rkmpp",
 			inputFormat:    "h264",
-			wantFilters:    "",
-			wantGlobalArgs: []string{"-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime"},
+			wantFilters:    "format=nv12",
+			wantGlobalArgs: []string{},
 			wantRcMode:     "VBR",
 			wantErr:        false,
 		},
@@ -256,3 +258,62 @@ func TestRkmppValidator_GetProductionSettings(t *testing.T) {
 		})
 	}
 }
+
+func TestRkmppValidator_GetZeroCopySettings(t *testing.T) {
+	v := NewRkmppValidator()
+
+	tests := []struct {
+		name           string
+		encoderName    string
+		inputFormat    string
+		wantGlobalArgs []string
+		wantErr        error
+	}{
+		{
+			name:           "MJPEG decoded into DRM PRIME buffers",
+			encoderName:    "h264_rkmpp",
+			inputFormat:    "mjpeg",
+			wantGlobalArgs: []string{"-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime"},
+		},
+		{
+			name:           "H264 decoded into DRM PRIME buffers",
+			encoderName:    "hevc_rkmpp",
+			inputFormat:    "h264",
+			wantGlobalArgs: []string{"-hwaccel", "rkmpp", "-hwaccel_output_format", "drm_prime"},
+		},
+		{
+			name:        "YUYV422 keeps the RGA production path",
+			encoderName: "h264_rkmpp",
+			inputFormat: "yuyv422",
+			wantErr:     ErrNoZeroCopyPath,
+		},
+		{
+			name:        "MJPEG encoder",
+			encoderName: "mjpeg_rkmpp",
+			inputFormat: "mjpeg",
+			wantErr:     ErrNoZeroCopyPath,
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			settings, err := v.GetZeroCopySettings(tt.encoderName, tt.inputFormat)
+			if !errors.Is(err, tt.wantErr) {
+				t.Fatalf("GetZeroCopySettings() error = %v, want %v", err, tt.wantErr)
+			}
+			if tt.wantErr != nil {
+				return
+			}
+
+			if settings.VideoFilters != "" {
+				t.Errorf("GetZeroCopySettings() VideoFilters = %v, want none", settings.VideoFilters)
+			}
+			if !slices.Equal(settings.GlobalArgs, tt.wantGlobalArgs) {
+				t.Errorf("GetZeroCopySettings() GlobalArgs = %v, want %v", settings.GlobalArgs, tt.wantGlobalArgs)
+			}
+			if settings.OutputParams["rc_mode"] != "VBR" {
+				t.Errorf("GetZeroCopySettings() rc_mode = %v, want production output params", settings.OutputParams["rc_mode"])
+			}
+		})
+	}
+}
@@ -7,6 +7,9 @@ import (
 	"github.com/smazurov/videonode/internal/types"
 )
 
+// vaapiRenderNode is the DRM render node VAAPI encoders run on.
+const vaapiRenderNode = "/dev/dri/renderD128"
+
 // VaapiValidator validates VAAPI encoders.
 type VaapiValidator struct{}
 
@@ -42,6 +45,11 @@ func (v *VaapiValidator) GetDescription() string {
 	return "VAAPI (Video Acceleration API) - Intel/AMD hardware acceleration on Linux"
 }
 
+// GetHardwareInfo returns the render node VAAPI encoders share.
+func (v *VaapiValidator) GetHardwareInfo() HardwareInfo {
+	return HardwareInfo{Family: "vaapi", Device: vaapiRenderNode, Concurrency: 2}
+}
+
 // GetProductionSettings returns production settings for VAAPI encoders.
 func (v *VaapiValidator) GetProductionSettings(encoderName string, inputFormat string) (*EncoderSettings, error) {
 	if !v.CanValidate(encoderName) {
@@ -49,7 +57,7 @@ func (v *VaapiValidator) GetProductionSettings(encoderName string, inputFormat s
 	}
 
 	settings := &EncoderSettings{
-		GlobalArgs: []string{"-vaapi_device", "/dev/dri/renderD128"},
+		GlobalArgs: []string{"-vaapi_device", vaapiRenderNode},
 		OutputParams: map[string]string{
 			"qp": "20",
 			"bf": "0", // Disable B-frames for WebRTC compatibility
@@ -99,6 +107,43 @@ func (v *VaapiValidator) GetProductionSettings(encoderName string, inputFormat s
 	return settings, nil
 }
 
+// GetZeroCopyFormats returns the input formats with a zero-copy path into VAAPI encoders.
+func (v *VaapiValidator) GetZeroCopyFormats(encoderName string) []string {
+	if !strings.HasPrefix(encoderName, "h264_") && !strings.HasPrefix(encoderName, "hevc_") {
+		return nil
+	}
+	return []string{"mjpeg", "h264", "yuyv422"}
+}
+
+// GetZeroCopySettings returns settings that keep frames in VAAPI surfaces.
+// Compressed input is decoded on the GPU straight into surfaces, and raw
+// input is uploaded once and converted on the GPU, instead of the CPU
+// format conversion chains in GetProductionSettings.
+func (v *VaapiValidator) GetZeroCopySettings(encoderName string, inputFormat string) (*EncoderSettings, error) {
+	settings, err := v.GetProductionSettings(encoderName, inputFormat)
+	if err != nil {
+		return nil, err
+	}
+
+	switch inputFormat {
+	case "mjpeg", "h264":
+		// Decoded frames stay on the GPU; scale_vaapi converts 4:2:2 MJPEG to nv12
+		settings.GlobalArgs = []string{
+			"-hwaccel", "vaapi",
+			"-hwaccel_device", vaapiRenderNode,
+			"-hwaccel_output_format", "vaapi",
+		}
+		settings.VideoFilters = "scale_vaapi=format=nv12"
+	case "yuyv422":
+		// Upload the packed 4:2:2 frame as-is and convert on the GPU
+		settings.VideoFilters = "hwupload,scale_vaapi=format=nv12"
+	default:
+		return nil, fmt.Errorf("%w: %s", ErrNoZeroCopyPath, inputFormat)
+	}
+
+	return settings, nil
+}
+
 // GetQualityParams translates quality settings to VAAPI-specific encoder parameters.
 func (v *VaapiValidator) GetQualityParams(encoderName string, params *types.QualityParams) (EncoderParams, error) {
 	if !v.CanValidate(encoderName) {
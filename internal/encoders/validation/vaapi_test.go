@@ -1,6 +1,8 @@
 package validation
 
 import (
+	"errors"
+	"slices"
 	"testing"
 
 	"github.com/smazurov/videonode/internal/types"
@@ -202,6 +204,80 @@ func TestVaapiValidator_GetProductionSettings(t *testing.T) {
 	}
 }
 
+func TestVaapiValidator_GetZeroCopySettings(t *testing.T) {
+	v := NewVaapiValidator()
+
+	tests := []struct {
+		name           string
+		encoderName    string
+		inputFormat    string
+		wantFilters    string
+		wantGlobalArgs []string
+		wantErr        error
+	}{
+		{
+			name:           "MJPEG decoded into VAAPI surfaces",
+			encoderName:    "h264_vaapi",
+			inputFormat:    "mjpeg",
+			wantFilters:    "scale_vaapi=format=nv12",
+			wantGlobalArgs: []string{"-hwaccel", "vaapi", "-hwaccel_device", "/dev/dri/renderD128", "-hwaccel_output_format", "vaapi"},
+		},
+		{
+			name:           "H264 decoded into VAAPI surfaces",
+			encoderName:    "hevc_vaapi",
+			inputFormat:    "h264",
+			wantFilters:    "scale_vaapi=format=nv12",
+			wantGlobalArgs: []string{"-hwaccel", "vaapi", "-hwaccel_device", "/dev/dri/renderD128", "-hwaccel_output_format", "vaapi"},
+		},
+		{
+			name:           "YUYV422 uploaded and converted on the GPU",
+			encoderName:    "h264_vaapi",
+			inputFormat:    "yuyv422",
+			wantFilters:    "hwupload,scale_vaapi=format=nv12",
+			wantGlobalArgs: []string{"-vaapi_device", "/dev/dri/renderD128"},
+		},
+		{
+			name:        "No zero-copy path for RGB",
+			encoderName: "h264_vaapi",
+			inputFormat: "rgb24",
+			wantErr:     ErrNoZeroCopyPath,
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			settings, err := v.GetZeroCopySettings(tt.encoderName, tt.inputFormat)
+			if !errors.Is(err, tt.wantErr) {
+				t.Fatalf("GetZeroCopySettings() error = %v, want %v", err, tt.wantErr)
+			}
+			if tt.wantErr != nil {
+				return
+			}
+
+			if settings.VideoFilters != tt.wantFilters {
+				t.Errorf("GetZeroCopySettings() VideoFilters = %v, want %v", settings.VideoFilters, tt.wantFilters)
+			}
+			if !slices.Equal(settings.GlobalArgs, tt.wantGlobalArgs) {
+				t.Errorf("GetZeroCopySettings() GlobalArgs = %v, want %v", settings.GlobalArgs, tt.wantGlobalArgs)
+			}
+			if settings.OutputParams["bf"] != "0" {
+				t.Errorf("GetZeroCopySettings() bf = %v, want production output params", settings.OutputParams["bf"])
+			}
+		})
+	}
+}
+
+func TestVaapiValidator_GetZeroCopyFormats(t *testing.T) {
+	v := NewVaapiValidator()
+
+	if got := v.GetZeroCopyFormats("h264_vaapi"); !slices.Equal(got, []string{"mjpeg", "h264", "yuyv422"}) {
+		t.Errorf("GetZeroCopyFormats(h264_vaapi) = %v", got)
+	}
+	if got := v.GetZeroCopyFormats("vp9_vaapi"); got != nil {
+		t.Errorf("GetZeroCopyFormats(vp9_vaapi) = %v, want none", got)
+	}
+}
+
 func floatPtr(f float64) *float64 {
 	return &f
 }
@@ -0,0 +1,101 @@
+package validation
+
+import (
+	"errors"
+	"fmt"
+	"path/filepath"
+)
+
+// ErrNoZeroCopyPath is returned when an encoder has no zero-copy path for an input format.
+var ErrNoZeroCopyPath = errors.New("no zero-copy path for input format")
+
+// ZeroCopyValidator is implemented by validators whose encoders can take
+// frames that stay in device memory (VAAPI surfaces, DRM PRIME buffers) from
+// decode or upload through to the encoder, skipping CPU format conversion.
+//
+// Zero-copy settings depend on driver support that varies between devices,
+// so they are only used for encoder/input format pairs that passed
+// ValidateZeroCopy. Everything else uses GetProductionSettings.
+type ZeroCopyValidator interface {
+	EncoderValidator
+
+	// GetZeroCopyFormats returns the input formats the encoder has a zero-copy path for
+	GetZeroCopyFormats(encoderName string) []string
+
+	// GetZeroCopySettings returns the zero-copy FFmpeg settings for the encoder and input format
+	// Returns ErrNoZeroCopyPath if the format has none
+	GetZeroCopySettings(encoderName string, inputFormat string) (*EncoderSettings, error)
+}
+
+// zeroCopySample describes a short software-encoded clip in a capture format,
+// standing in for a V4L2 device during validation.
+type zeroCopySample struct {
+	file   string   // Sample file name
+	encode []string // Output arguments that write the sample
+	input  []string // Input arguments that read it back
+}
+
+// zeroCopySamples holds the samples for every capture format with a zero-copy path.
+var zeroCopySamples = map[string]zeroCopySample{
+	"mjpeg": {
+		file:   "sample.mjpeg",
+		encode: []string{"-c:v", "mjpeg", "-pix_fmt", "yuvj422p", "-f", "mjpeg"},
+		input:  []string{"-f", "mjpeg"},
+	},
+	"h264": {
+		file:   "sample.h264",
+		encode: []string{"-c:v", "libx264", "-pix_fmt", "yuv420p", "-f", "h264"},
+		input:  []string{"-f", "h264"},
+	},
+	"yuyv422": {
+		file:   "sample.yuv",
+		encode: []string{"-pix_fmt", "yuyv422", "-f", "rawvideo"},
+		input:  []string{"-f", "rawvideo", "-pix_fmt", "yuyv422", "-video_size", "640x480", "-framerate", "30"},
+	},
+}
+
+// ValidateZeroCopy tests an encoder's zero-copy path for an input format.
+// A sample clip in that format is generated in software, then encoded with
+// the zero-copy settings the same way a V4L2 capture would be.
+func ValidateZeroCopy(validator ZeroCopyValidator, encoderName string, inputFormat string) (bool, error) {
+	sample, ok := zeroCopySamples[inputFormat]
+	if !ok {
+		return false, fmt.Errorf("%w: %s", ErrNoZeroCopyPath, inputFormat)
+	}
+
+	settings, err := validator.GetZeroCopySettings(encoderName, inputFormat)
+	if err != nil {
+		return false, err
+	}
+
+	tempDir, cleanup, err := createTempDir()
+	if err != nil {
+		return false, fmt.Errorf("failed to create temp directory: %w", err)
+	}
+	defer cleanup()
+
+	// Generate the sample in software
+	sampleFile := filepath.Join(tempDir, sample.file)
+	cmdParts := []string{"ffmpeg", "-f", "lavfi", "-i", "testsrc2=duration=2:size=640x480:rate=30"}
+	cmdParts = append(cmdParts, sample.encode...)
+	cmdParts = append(cmdParts, "-y", sampleFile)
+	if generated, genErr := runValidationCommand(cmdParts, sampleFile); !generated {
+		return false, fmt.Errorf("failed to generate %s sample: %w", inputFormat, genErr)
+	}
+
+	// Encode it through the zero-copy path
+	testFile := filepath.Join(tempDir, fmt.Sprintf("test_%s_%s.mp4", encoderName, inputFormat))
+	cmdParts = []string{"ffmpeg"}
+	cmdParts = append(cmdParts, settings.GlobalArgs...)
+	cmdParts = append(cmdParts, sample.input...)
+	cmdParts = append(cmdParts, "-i", sampleFile, "-c:v", encoderName)
+	if settings.VideoFilters != "" {
+		cmdParts = append(cmdParts, "-vf", settings.VideoFilters)
+	}
+	for key, value := range settings.OutputParams {
+		cmdParts = append(cmdParts, fmt.Sprintf("-%s", key), value)
+	}
+	cmdParts = append(cmdParts, "-y", testFile)
+
+	return runValidationCommand(cmdParts, testFile)
+}
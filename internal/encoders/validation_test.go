@@ -0,0 +1,150 @@
+package encoders
+
+import (
+	"errors"
+	"slices"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/smazurov/videonode/internal/encoders/validation"
+	"github.com/smazurov/videonode/internal/types"
+)
+
+// fakeHardwareValidator validates encoders without running FFmpeg and
+// records how many validations ran at once.
+type fakeHardwareValidator struct {
+	*validation.GenericValidator
+	info    validation.HardwareInfo
+	failing []string
+
+	mu        sync.Mutex
+	tested    []string
+	running   atomic.Int32
+	maxActive atomic.Int32
+}
+
+func (f *fakeHardwareValidator) GetHardwareInfo() validation.HardwareInfo { return f.info }
+
+func (f *fakeHardwareValidator) Validate(encoderName string) (bool, error) {
+	active := f.running.Add(1)
+	defer f.running.Add(-1)
+	for {
+		peak := f.maxActive.Load()
+		if active <= peak || f.maxActive.CompareAndSwap(peak, active) {
+			break
+		}
+	}
+	time.Sleep(10 * time.Millisecond)
+
+	f.mu.Lock()
+	f.tested = append(f.tested, encoderName)
+	f.mu.Unlock()
+
+	if slices.Contains(f.failing, encoderName) {
+		return false, errors.New("encode failed")
+	}
+	return true, nil
+}
+
+// fakeProvider is an in-memory ValidationProvider.
+type fakeProvider struct {
+	results *types.ValidationResults
+}
+
+func (p *fakeProvider) GetValidation() *types.ValidationResults { return p.results }
+func (p *fakeProvider) UpdateValidation(results *types.ValidationResults) error {
+	p.results = results
+	return nil
+}
+
+func TestRunValidations_LimitsConcurrencyPerFamily(t *testing.T) {
+	fake := &fakeHardwareValidator{
+		GenericValidator: validation.NewGenericValidator(),
+		info:             validation.HardwareInfo{Family: "vaapi", Concurrency: 2},
+		failing:          []string{"hevc_vaapi"},
+	}
+	var jobs []validationJob
+	for _, name := range []string{"h264_vaapi", "hevc_vaapi", "vp8_vaapi", "vp9_vaapi", "av1_vaapi"} {
+		jobs = append(jobs, validationJob{validator: fake, encoderName: name, fingerprint: "fp"})
+	}
+
+	v := NewValidator(&fakeProvider{})
+	outcomes := v.runValidations(jobs, nil)
+
+	if peak := fake.maxActive.Load(); peak != 2 {
+		t.Errorf("peak concurrent validations = %d, want 2", peak)
+	}
+	if len(fake.tested) != len(jobs) {
+		t.Errorf("tested %d encoders, want %d", len(fake.tested), len(jobs))
+	}
+	for i, job := range jobs {
+		wantValid := job.encoderName != "hevc_vaapi"
+		if outcomes[i].valid != wantValid || outcomes[i].cached {
+			t.Errorf("%s: valid = %v cached = %v, want valid = %v cached = false",
+				job.encoderName, outcomes[i].valid, outcomes[i].cached, wantValid)
+		}
+	}
+}
+
+func TestRunValidations_ReusesResultsWithSameFingerprint(t *testing.T) {
+	fake := &fakeHardwareValidator{
+		GenericValidator: validation.NewGenericValidator(),
+		info:             validation.HardwareInfo{Family: "vaapi", Concurrency: 1},
+	}
+	previous := &types.ValidationResults{
+		H264:     types.CodecValidation{Working: []string{"h264_vaapi"}},
+		H265:     types.CodecValidation{Failed: []string{"hevc_vaapi"}},
+		ZeroCopy: []string{"h264_vaapi:mjpeg", "h264_vaapi:h264", "hevc_vaapi:mjpeg"},
+		Fingerprints: map[string]string{
+			"h264_vaapi": "fp-new",
+			"hevc_vaapi": "fp-new",
+			"libx264":    "fp-old",
+		},
+	}
+	jobs := []validationJob{
+		{validator: fake, encoderName: "h264_vaapi", fingerprint: "fp-new"},
+		{validator: fake, encoderName: "hevc_vaapi", fingerprint: "fp-new"},
+		{validator: fake, encoderName: "libx264", fingerprint: "fp-new"}, // environment changed
+		{validator: fake, encoderName: "libx265", fingerprint: ""},       // unknown environment
+	}
+
+	v := NewValidator(&fakeProvider{})
+	outcomes := v.runValidations(jobs, previous)
+
+	if !outcomes[0].valid || !outcomes[0].cached || !slices.Equal(outcomes[0].zeroCopy, []string{"h264_vaapi:mjpeg", "h264_vaapi:h264"}) {
+		t.Errorf("h264_vaapi outcome = %+v, want cached working with its zero-copy paths", outcomes[0])
+	}
+	if outcomes[1].valid || !outcomes[1].cached {
+		t.Errorf("hevc_vaapi outcome = %+v, want cached failure", outcomes[1])
+	}
+	slices.Sort(fake.tested)
+	if want := []string{"libx264", "libx265"}; !slices.Equal(fake.tested, want) {
+		t.Errorf("tested %v, want %v", fake.tested, want)
+	}
+}
+
+func TestEnvironmentFingerprint(t *testing.T) {
+	hardware := &fakeHardwareValidator{info: validation.HardwareInfo{Device: "/dev/nonexistent0"}}
+	software := validation.NewGenericValidator()
+
+	tests := []struct {
+		name          string
+		validator     validation.EncoderValidator
+		ffmpegVersion string
+		want          string
+	}{
+		{"software", software, "7.1.1", "ffmpeg=7.1.1"},
+		{"hardware", hardware, "7.1.1", "ffmpeg=7.1.1;kernel=6.1.0;device=/dev/nonexistent0;driver="},
+		{"unknown ffmpeg", software, "unknown", ""},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := environmentFingerprint(tt.validator, tt.ffmpegVersion, "6.1.0"); got != tt.want {
+				t.Errorf("environmentFingerprint() = %q, want %q", got, tt.want)
+			}
+		})
+	}
+}
@@ -37,8 +37,6 @@ func (b *Bus) Publish(ev Event) {
 		event.Publish(b.dispatcher, e)
 	case StreamMetricsEvent:
 		event.Publish(b.dispatcher, e)
-	case LogEntryEvent:
-		event.Publish(b.dispatcher, e)
 	case StreamCrashedEvent:
 		event.Publish(b.dispatcher, e)
 	}
@@ -71,8 +69,6 @@ func (b *Bus) Subscribe(handler any) func() {
 		return event.Subscribe(b.dispatcher, h)
 	case func(StreamMetricsEvent):
 		return event.Subscribe(b.dispatcher, h)
-	case func(LogEntryEvent):
-		return event.Subscribe(b.dispatcher, h)
 	case func(StreamCrashedEvent):
 		return event.Subscribe(b.dispatcher, h)
 	default:
@@ -268,11 +268,11 @@ func TestStreamStateChangedEvent_Interface(t *testing.T) {
 	}
 }
 
-func TestSubscribeToChannel(t *testing.T) {
+func TestSubscribeToQueue(t *testing.T) {
 	bus := New()
-	ch := make(chan any, 10)
+	queue := NewQueue(10, nil)
 
-	unsub := SubscribeToChannel[CaptureSuccessEvent](bus, ch)
+	unsub := SubscribeToQueue[CaptureSuccessEvent](bus, queue)
 	defer unsub()
 
 	event := CaptureSuccessEvent{
@@ -281,28 +281,72 @@ func TestSubscribeToChannel(t *testing.T) {
 	}
 	bus.Publish(event)
 
-	received := <-ch
-	captureEvent, ok := received.(CaptureSuccessEvent)
+	select {
+	case <-queue.Ready():
+	case <-time.After(time.Second):
+		t.Fatal("Timeout waiting for event")
+	}
+	received := queue.Drain(nil)
+	if len(received) != 1 {
+		t.Fatalf("Expected 1 event, got %d", len(received))
+	}
+	captureEvent, ok := received[0].(CaptureSuccessEvent)
 	if !ok {
-		t.Fatalf("Expected CaptureSuccessEvent, got %T", received)
+		t.Fatalf("Expected CaptureSuccessEvent, got %T", received[0])
 	}
 	if captureEvent.DevicePath != event.DevicePath {
 		t.Errorf("Expected device_path %s, got %s", event.DevicePath, captureEvent.DevicePath)
 	}
 }
 
-func TestSubscribeToChannel_NonBlocking(_ *testing.T) {
-	bus := New()
-	ch := make(chan any) // No buffer
+func TestQueue_DropsOldest(t *testing.T) {
+	dropped := 0
+	queue := NewQueue(2, func() { dropped++ })
 
-	unsub := SubscribeToChannel[StreamCreatedEvent](bus, ch)
-	defer unsub()
+	for _, action := range []string{"a", "b", "c"} {
+		queue.Push(StreamCreatedEvent{Action: action}) // never blocks
+	}
+
+	received := queue.Drain(nil)
+	if len(received) != 2 || received[0].(StreamCreatedEvent).Action != "b" || received[1].(StreamCreatedEvent).Action != "c" {
+		t.Errorf("Expected [b c], got %v", received)
+	}
+	if dropped != 1 {
+		t.Errorf("Expected 1 dropped event, got %d", dropped)
+	}
+	if rest := queue.Drain(nil); len(rest) != 0 {
+		t.Errorf("Expected empty queue after drain, got %v", rest)
+	}
+}
 
-	done := make(chan bool, 1)
-	go func() {
-		bus.Publish(StreamCreatedEvent{Action: "created"})
-		done <- true
-	}()
+func TestQueue_CoalescesMetrics(t *testing.T) {
+	value := func(v float64) *float64 { return &v }
+	queue := NewQueue(1, func() { t.Error("metrics batch dropped an event") })
+
+	first := StreamMetricsEvent{Streams: map[string]StreamMetricsDelta{
+		"cam1": {FPS: value(30), DroppedFrames: value(0)},
+		"cam2": {FPS: value(25)},
+	}}
+	queue.Push(first)
+	queue.Push(StreamCreatedEvent{Action: "created"})
+	queue.Push(StreamMetricsEvent{
+		Streams: map[string]StreamMetricsDelta{"cam1": {DroppedFrames: value(3)}},
+		Removed: []string{"cam2"},
+	})
 
-	<-done // Should complete without blocking
+	received := queue.Drain(nil)
+	if len(received) != 2 {
+		t.Fatalf("Expected the queued event and one batch, got %v", received)
+	}
+	batch := received[1].(StreamMetricsEvent)
+	cam1 := batch.Streams["cam1"]
+	if *cam1.FPS != 30 || *cam1.DroppedFrames != 3 {
+		t.Errorf("Expected cam1 fps 30 and 3 dropped frames, got %v and %v", *cam1.FPS, *cam1.DroppedFrames)
+	}
+	if _, ok := batch.Streams["cam2"]; ok || len(batch.Removed) != 1 || batch.Removed[0] != "cam2" {
+		t.Errorf("Expected cam2 removed, got %+v", batch)
+	}
+	if *first.Streams["cam1"].DroppedFrames != 0 {
+		t.Error("Coalescing modified the published batch")
+	}
 }
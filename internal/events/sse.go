@@ -1,15 +1,90 @@
 package events
 
-import "github.com/kelindar/event"
+import (
+	"sync"
 
-// SubscribeToChannel bridges kelindar/event callback-based subscriptions to channels
-// This is needed for SSE integration where Huma expects a channel-based select loop.
-func SubscribeToChannel[T Event](bus *Bus, ch chan<- any) func() {
-	return event.Subscribe(bus.dispatcher, func(e T) {
-		select {
-		case ch <- e:
-		default:
-			// Drop event if channel is full (non-blocking)
+	"github.com/kelindar/event"
+)
+
+// Queue buffers the events of one SSE client. Pushing never blocks, so a
+// stalled browser tab can't hold up the bus: when the queue is full the
+// oldest pending event is dropped. Stream metrics batches don't take queue
+// slots; pending ones are coalesced into a single batch, delivered after the
+// queued events.
+type Queue struct {
+	mu      sync.Mutex
+	size    int
+	pending []any
+	metrics *StreamMetricsEvent // Coalesced metrics batch, nil if none pending
+	ready   chan struct{}
+	onDrop  func()
+}
+
+// NewQueue creates a queue holding up to size events. onDrop, if set, is
+// called for every event dropped because the client fell behind.
+func NewQueue(size int, onDrop func()) *Queue {
+	return &Queue{
+		size:    max(size, 1),
+		pending: make([]any, 0, max(size, 1)),
+		ready:   make(chan struct{}, 1),
+		onDrop:  onDrop,
+	}
+}
+
+// Push adds an event, dropping the oldest pending one if the queue is full.
+func (q *Queue) Push(e any) {
+	q.mu.Lock()
+	if batch, ok := e.(StreamMetricsEvent); ok {
+		if q.metrics == nil {
+			batch = batch.clone()
+			q.metrics = &batch
+		} else {
+			q.metrics.coalesce(batch)
 		}
+	} else {
+		if len(q.pending) == q.size {
+			copy(q.pending, q.pending[1:])
+			q.pending = q.pending[:len(q.pending)-1]
+			if q.onDrop != nil {
+				q.onDrop()
+			}
+		}
+		q.pending = append(q.pending, e)
+	}
+	q.mu.Unlock()
+
+	select {
+	case q.ready <- struct{}{}:
+	default:
+	}
+}
+
+// Ready returns a channel that receives when events are pending.
+func (q *Queue) Ready() <-chan struct{} {
+	return q.ready
+}
+
+// Drain appends all pending events to dst in delivery order and empties the
+// queue.
+func (q *Queue) Drain(dst []any) []any {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+
+	dst = append(dst, q.pending...)
+	clear(q.pending)
+	q.pending = q.pending[:0]
+	if q.metrics != nil {
+		dst = append(dst, *q.metrics)
+		q.metrics = nil
+	}
+	return dst
+}
+
+// SubscribeToQueue bridges kelindar/event callback-based subscriptions to a
+// client queue. This is needed for SSE integration where Huma expects a
+// select loop.
+func SubscribeToQueue[T Event](bus *Bus, q *Queue) func() {
+	return event.Subscribe(bus.dispatcher, func(e T) {
+		q.Push(e)
 	})
 }
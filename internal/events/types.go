@@ -1,6 +1,11 @@
 package events
 
-import "github.com/smazurov/videonode/internal/api/models"
+import (
+	"maps"
+	"slices"
+
+	"github.com/smazurov/videonode/internal/api/models"
+)
 
 // Event type constants for kelindar/event.
 const (
@@ -104,13 +109,74 @@ func (e StreamStateChangedEvent) IsEnabled() bool {
 	return e.Enabled
 }
 
-// StreamMetricsEvent represents FFmpeg stream metrics.
+// StreamMetricsEvent is one batch of FFmpeg stream metrics for all streams.
+// A delta batch carries only the streams and fields that changed since the
+// previous batch; a full batch (sent when a client connects) carries all of
+// them. Streams whose metrics went away are listed in Removed.
 type StreamMetricsEvent struct {
-	EventType       string `json:"type"`
-	StreamID        string `json:"stream_id"`
-	FPS             string `json:"fps"`
-	DroppedFrames   string `json:"dropped_frames"`
-	DuplicateFrames string `json:"duplicate_frames"`
+	EventType string                        `json:"type"`
+	Full      bool                          `json:"full,omitempty" doc:"Snapshot of all streams rather than changes"`
+	Streams   map[string]StreamMetricsDelta `json:"streams" doc:"Changed metrics by stream ID"`
+	Removed   []string                      `json:"removed,omitempty" doc:"Streams without metrics anymore"`
+}
+
+// StreamMetricsDelta holds the metrics of one stream in a batch. Unset
+// fields didn't change.
+type StreamMetricsDelta struct {
+	FPS             *float64 `json:"fps,omitempty"`
+	DroppedFrames   *float64 `json:"dropped_frames,omitempty"`
+	DuplicateFrames *float64 `json:"duplicate_frames,omitempty"`
+	Speed           *float64 `json:"speed,omitempty"`
+	OutputBitrate   *float64 `json:"output_bitrate,omitempty" doc:"Output bitrate in bits/s"`
+	EncodeLag       *float64 `json:"encode_lag,omitempty" doc:"Encode lag in seconds"`
+}
+
+// merge overlays the set fields of newer.
+func (d *StreamMetricsDelta) merge(newer StreamMetricsDelta) {
+	for _, f := range []struct{ dst, src **float64 }{
+		{&d.FPS, &newer.FPS},
+		{&d.DroppedFrames, &newer.DroppedFrames},
+		{&d.DuplicateFrames, &newer.DuplicateFrames},
+		{&d.Speed, &newer.Speed},
+		{&d.OutputBitrate, &newer.OutputBitrate},
+		{&d.EncodeLag, &newer.EncodeLag},
+	} {
+		if *f.src != nil {
+			*f.dst = *f.src
+		}
+	}
+}
+
+// clone returns a copy of the batch that can be merged into without touching
+// the original, which other subscribers share.
+func (e StreamMetricsEvent) clone() StreamMetricsEvent {
+	e.Streams = maps.Clone(e.Streams)
+	if e.Streams == nil {
+		e.Streams = make(map[string]StreamMetricsDelta)
+	}
+	e.Removed = slices.Clone(e.Removed)
+	return e
+}
+
+// coalesce folds a newer batch into e, which must be a clone. The result
+// brings a client that missed newer to the same state as one that got both.
+func (e *StreamMetricsEvent) coalesce(newer StreamMetricsEvent) {
+	if newer.Full {
+		*e = newer.clone()
+		return
+	}
+	for streamID, delta := range newer.Streams {
+		merged := e.Streams[streamID]
+		merged.merge(delta)
+		e.Streams[streamID] = merged
+		e.Removed = slices.DeleteFunc(e.Removed, func(id string) bool { return id == streamID })
+	}
+	for _, streamID := range newer.Removed {
+		delete(e.Streams, streamID)
+		if !slices.Contains(e.Removed, streamID) {
+			e.Removed = append(e.Removed, streamID)
+		}
+	}
 }
 
 // Type returns the event type identifier for StreamMetricsEvent.
@@ -118,6 +184,7 @@ func (e StreamMetricsEvent) Type() uint32 { return TypeStreamMetrics }
 
 // LogEntryEvent represents a log entry for SSE streaming.
 type LogEntryEvent struct {
+	Seq        uint64         `json:"seq" example:"42" doc:"Log sequence number, also sent as the SSE message ID"`
 	Timestamp  string         `json:"timestamp" example:"2025-01-09T10:30:00.123Z" doc:"Log timestamp"`
 	Level      string         `json:"level" example:"info" doc:"Log level"`
 	Module     string         `json:"module" example:"api" doc:"Source module"`
@@ -7,16 +7,92 @@ import (
 )
 
 // BuildCommand builds an FFmpeg command from structured parameters.
+// With Outputs set, one command captures once and encodes every output.
 func BuildCommand(p *Params) string {
 	var cmd strings.Builder
 
 	cmd.WriteString(Base())
 
 	// Global args (hardware devices, etc.)
-	for _, arg := range p.GlobalArgs {
-		cmd.WriteString(" " + arg)
+	for _, args := range globalArgs(p) {
+		for _, arg := range args {
+			cmd.WriteString(" " + arg)
+		}
+	}
+
+	writeInputs(&cmd, p)
+
+	if len(p.Outputs) > 0 {
+		writeSplitOutputs(&cmd, p)
+		return cmd.String()
+	}
+
+	// Map video and audio when a second input is present
+	if p.AudioDevice != "" {
+		cmd.WriteString(" -map 0:v -map 1:a")
+	}
+
+	writeFPSMode(&cmd, p)
+
+	// Audio filters
+	if p.AudioFilters != "" {
+		cmd.WriteString(" -af " + p.AudioFilters)
+	}
+
+	// Video filters
+	var videoFilterChain []string
+
+	// Add text overlay for test sources
+	if p.OverlayText != "" {
+		videoFilterChain = append(videoFilterChain, overlayFilter(p.OverlayText))
 	}
 
+	// Add existing video filters
+	if p.VideoFilters != "" {
+		videoFilterChain = append(videoFilterChain, p.VideoFilters)
+	}
+
+	// Apply video filter chain
+	if len(videoFilterChain) > 0 {
+		cmd.WriteString(" -vf " + strings.Join(videoFilterChain, ","))
+	}
+
+	writeVideoEncoder(&cmd, p)
+
+	// Audio codec
+	if p.AudioDevice != "" {
+		cmd.WriteString(" -c:a libopus -b:a 128k -ar 48000")
+	}
+
+	writeProgress(&cmd, p)
+	writeOutput(&cmd, p.OutputURL, captureTimestamps(p))
+
+	return cmd.String()
+}
+
+// globalArgs returns the global argument groups of a command and its
+// outputs. Outputs using the same hardware as the main encoder share its
+// arguments.
+func globalArgs(p *Params) [][]string {
+	var groups [][]string
+	if len(p.GlobalArgs) > 0 {
+		groups = append(groups, p.GlobalArgs)
+	}
+	for _, output := range p.Outputs {
+		args := output.Params.GlobalArgs
+		if len(args) == 0 {
+			continue
+		}
+		if !slices.ContainsFunc(groups, func(group []string) bool { return slices.Equal(group, args) }) {
+			groups = append(groups, args)
+		}
+	}
+	return groups
+}
+
+// writeInputs writes the video input (device or test source) and the
+// optional audio input.
+func writeInputs(cmd *strings.Builder, p *Params) {
 	// Input configuration
 	if p.OverlayText != "" {
 		// Generate test pattern input
@@ -42,7 +118,7 @@ func BuildCommand(p *Params) string {
 		cmd.WriteString(" -f v4l2")
 
 		// Apply FFmpeg options (before input)
-		ApplyOptionsToCommand(p.Options, &cmd)
+		ApplyOptionsToCommand(p.Options, cmd)
 
 		if p.InputFormat != "" {
 			cmd.WriteString(" -input_format " + p.InputFormat)
@@ -53,7 +129,14 @@ func BuildCommand(p *Params) string {
 		if p.FPS != "" {
 			cmd.WriteString(" -framerate " + p.FPS)
 		}
+		if p.CaptureTimestamps {
+			// Wallclock capture times, kept through encoding
+			cmd.WriteString(" -ts mono2abs")
+		}
 		cmd.WriteString(" -i " + p.DevicePath)
+		if p.CaptureTimestamps {
+			cmd.WriteString(" -copyts")
+		}
 	}
 
 	// Audio input if specified
@@ -61,7 +144,6 @@ func BuildCommand(p *Params) string {
 		if p.OverlayText != "" {
 			// Generate test audio tone for test mode
 			cmd.WriteString(" -f lavfi -i \"sine=frequency=1000:sample_rate=48000\"")
-			cmd.WriteString(" -map 0:v -map 1:a")
 		} else {
 			// Normal ALSA audio input
 			cmd.WriteString(" -thread_queue_size 1024")
@@ -75,39 +157,89 @@ func BuildCommand(p *Params) string {
 
 			cmd.WriteString(" -f alsa -sample_fmt s16 -ar 48000 -ac 2")
 			cmd.WriteString(" -i " + p.AudioDevice)
-			cmd.WriteString(" -map 0:v -map 1:a")
 		}
 	}
+}
 
-	// Apply fps_mode passthrough if enabled (passes frames as-is without dropping/duplicating)
-	if slices.Contains(p.Options, OptionVsyncPassthrough) {
-		cmd.WriteString(" -fps_mode passthrough")
+// writeSplitOutputs decodes the video once, splits it to the main output and
+// every extra output, and writes one encoder and output per branch. Audio is
+// encoded once, for the main output only.
+func writeSplitOutputs(cmd *strings.Builder, p *Params) {
+	branches := len(p.Outputs) + 1
+
+	var graph strings.Builder
+	graph.WriteString("[0:v]")
+	if p.OverlayText != "" {
+		graph.WriteString(overlayFilter(p.OverlayText) + ",")
 	}
+	fmt.Fprintf(&graph, "split=%d", branches)
+	for i := range branches {
+		fmt.Fprintf(&graph, "[s%d]", i)
+	}
+	fmt.Fprintf(&graph, ";[s0]%s[v0]", filterChain(p.VideoFilters))
+	for i, output := range p.Outputs {
+		chain := output.Params.VideoFilters
+		if output.Resolution != "" {
+			scale := "scale=" + strings.Replace(output.Resolution, "x", ":", 1)
+			if chain == "" {
+				chain = scale
+			} else {
+				chain = scale + "," + chain
+			}
+		}
+		fmt.Fprintf(&graph, ";[s%d]%s[v%d]", i+1, filterChain(chain), i+1)
+	}
+	cmd.WriteString(" -filter_complex \"" + graph.String() + "\"")
 
-	// Audio filters
+	writeProgress(cmd, p)
+
+	// Main output
+	cmd.WriteString(" -map \"[v0]\"")
+	if p.AudioDevice != "" {
+		cmd.WriteString(" -map 1:a")
+	}
+	writeFPSMode(cmd, p)
 	if p.AudioFilters != "" {
 		cmd.WriteString(" -af " + p.AudioFilters)
 	}
+	writeVideoEncoder(cmd, p)
+	if p.AudioDevice != "" {
+		cmd.WriteString(" -c:a libopus -b:a 128k -ar 48000")
+	}
+	writeOutput(cmd, p.OutputURL, captureTimestamps(p))
 
-	// Video filters
-	var videoFilterChain []string
-
-	// Add text overlay for test sources
-	if p.OverlayText != "" {
-		drawtext := fmt.Sprintf("drawtext=text='%s':x=(w-text_w)/2:y=(h-text_h)/2:fontsize=120:fontcolor=white:box=1:boxcolor=black@0.5:boxborderw=5", p.OverlayText)
-		videoFilterChain = append(videoFilterChain, drawtext)
+	// Extra outputs
+	for i, output := range p.Outputs {
+		fmt.Fprintf(cmd, " -map \"[v%d]\"", i+1)
+		writeFPSMode(cmd, p)
+		writeVideoEncoder(cmd, output.Params)
+		writeOutput(cmd, output.Params.OutputURL, captureTimestamps(p))
 	}
+}
 
-	// Add existing video filters
-	if p.VideoFilters != "" {
-		videoFilterChain = append(videoFilterChain, p.VideoFilters)
+// filterChain returns a filtergraph branch, "null" when it has no filters.
+func filterChain(filters string) string {
+	if filters == "" {
+		return "null"
 	}
+	return filters
+}
 
-	// Apply video filter chain
-	if len(videoFilterChain) > 0 {
-		cmd.WriteString(" -vf " + strings.Join(videoFilterChain, ","))
+// overlayFilter returns the drawtext filter for test source overlays.
+func overlayFilter(text string) string {
+	return fmt.Sprintf("drawtext=text='%s':x=(w-text_w)/2:y=(h-text_h)/2:fontsize=120:fontcolor=white:box=1:boxcolor=black@0.5:boxborderw=5", text)
+}
+
+// writeFPSMode applies fps_mode passthrough if enabled (passes frames as-is
+// without dropping/duplicating).
+func writeFPSMode(cmd *strings.Builder, p *Params) {
+	if slices.Contains(p.Options, OptionVsyncPassthrough) {
+		cmd.WriteString(" -fps_mode passthrough")
 	}
+}
 
+// writeVideoEncoder writes the video encoder, rate control and GOP settings.
+func writeVideoEncoder(cmd *strings.Builder, p *Params) {
 	// Encoder
 	cmd.WriteString(" -c:v " + p.Encoder)
 
@@ -162,25 +294,33 @@ func BuildCommand(p *Params) string {
 		cmd.WriteString(" -keyint_min 15")
 		cmd.WriteString(" -sc_threshold 0")
 	}
+}
 
-	// Audio codec
-	if p.AudioDevice != "" {
-		cmd.WriteString(" -c:a libopus -b:a 128k -ar 48000")
-	}
-
-	// Progress monitoring
+// writeProgress enables progress monitoring over a unix socket.
+func writeProgress(cmd *strings.Builder, p *Params) {
 	if p.ProgressSocket != "" {
 		cmd.WriteString(" -progress unix://" + p.ProgressSocket)
 	}
+}
 
-	// Output configuration - detect format from URL
-	if strings.HasPrefix(p.OutputURL, "rtsp://") {
+// captureTimestamps reports whether a command carries capture times (see
+// Params.CaptureTimestamps).
+func captureTimestamps(p *Params) bool {
+	return p.CaptureTimestamps && p.OverlayText == ""
+}
+
+// writeOutput writes the output format and URL, detected from the URL.
+// With realtimeEpoch, RTSP sender reports count RTP time from the Unix epoch,
+// matching the wallclock timestamps of the frames.
+func writeOutput(cmd *strings.Builder, outputURL string, realtimeEpoch bool) {
+	if strings.HasPrefix(outputURL, "rtsp://") {
 		// RTSP output for streaming server
-		cmd.WriteString(" -rtsp_transport tcp -f rtsp " + p.OutputURL)
+		if realtimeEpoch {
+			cmd.WriteString(" -start_time_realtime 1")
+		}
+		cmd.WriteString(" -rtsp_transport tcp -f rtsp " + outputURL)
 	} else {
 		// Default: mpegts with low-latency options (for SRT, etc.)
-		cmd.WriteString(" -muxdelay 0 -muxpreload 0 -flush_packets 1 -f mpegts " + p.OutputURL)
+		cmd.WriteString(" -muxdelay 0 -muxpreload 0 -flush_packets 1 -f mpegts " + outputURL)
 	}
-
-	return cmd.String()
 }
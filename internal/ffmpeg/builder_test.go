@@ -0,0 +1,182 @@
+package ffmpeg
+
+import (
+	"strings"
+	"testing"
+)
+
+func TestBuildCommandSingleOutput(t *testing.T) {
+	cmd := BuildCommand(&Params{
+		DevicePath:   "/dev/video0",
+		InputFormat:  "yuyv422",
+		Encoder:      "h264_vaapi",
+		GlobalArgs:   []string{"-vaapi_device", "/dev/dri/renderD128"},
+		VideoFilters: "format=nv12,hwupload",
+		BFrames:      -1,
+		OutputURL:    "rtsp://127.0.0.1:8554/cam",
+	})
+
+	for _, want := range []string{
+		" -vaapi_device /dev/dri/renderD128 -f v4l2 -input_format yuyv422 -i /dev/video0",
+		" -vf format=nv12,hwupload -c:v h264_vaapi",
+		" -rtsp_transport tcp -f rtsp rtsp://127.0.0.1:8554/cam",
+	} {
+		if !strings.Contains(cmd, want) {
+			t.Errorf("command missing %q: %s", want, cmd)
+		}
+	}
+	if strings.Contains(cmd, "-filter_complex") {
+		t.Errorf("single output should not use a filtergraph: %s", cmd)
+	}
+}
+
+func TestBuildCommandMultipleOutputs(t *testing.T) {
+	vaapi := []string{"-vaapi_device", "/dev/dri/renderD128"}
+	cmd := BuildCommand(&Params{
+		DevicePath:     "/dev/video0",
+		Encoder:        "h264_vaapi",
+		Bitrate:        "8M",
+		GlobalArgs:     vaapi,
+		VideoFilters:   "format=nv12,hwupload",
+		BFrames:        -1,
+		AudioDevice:    "hw:1,0",
+		ProgressSocket: "/tmp/progress.sock",
+		OutputURL:      "rtsp://127.0.0.1:8554/cam",
+		Outputs: []Output{
+			{
+				Resolution: "640x360",
+				Params: &Params{
+					Encoder:      "h264_vaapi",
+					Bitrate:      "800k",
+					GlobalArgs:   vaapi,
+					VideoFilters: "format=nv12,hwupload",
+					BFrames:      -1,
+					OutputURL:    "rtsp://127.0.0.1:8554/cam-sub",
+				},
+			},
+			{
+				Params: &Params{
+					Encoder:   "libx264",
+					BFrames:   -1,
+					OutputURL: "rtsp://127.0.0.1:8554/cam-sw",
+				},
+			},
+		},
+	})
+
+	if n := strings.Count(cmd, "-vaapi_device"); n != 1 {
+		t.Errorf("shared hardware args should appear once, got %d: %s", n, cmd)
+	}
+	if n := strings.Count(cmd, " -i "); n != 2 {
+		t.Errorf("expected one video and one audio input, got %d: %s", n, cmd)
+	}
+
+	graph := `-filter_complex "[0:v]split=3[s0][s1][s2];[s0]format=nv12,hwupload[v0];[s1]scale=640:360,format=nv12,hwupload[v1];[s2]null[v2]"`
+	if !strings.Contains(cmd, graph) {
+		t.Errorf("command missing filtergraph %s: %s", graph, cmd)
+	}
+
+	// Outputs in order, audio only on the main output
+	main := strings.Index(cmd, `-map "[v0]" -map 1:a`)
+	sub := strings.Index(cmd, `-map "[v1]" -c:v h264_vaapi -profile:v high -level:v 5.2 -b:v 800k`)
+	sw := strings.Index(cmd, `-map "[v2]" -c:v libx264`)
+	if main < 0 || sub < main || sw < sub {
+		t.Errorf("outputs missing or out of order (main %d, sub %d, sw %d): %s", main, sub, sw, cmd)
+	}
+	if n := strings.Count(cmd, "-c:a libopus"); n != 1 {
+		t.Errorf("audio should be encoded once, got %d: %s", n, cmd)
+	}
+	if !strings.HasSuffix(cmd, "-f rtsp rtsp://127.0.0.1:8554/cam-sw") {
+		t.Errorf("command should end with the last output: %s", cmd)
+	}
+}
+
+func TestBuildCommandCaptureTimestamps(t *testing.T) {
+	params := &Params{
+		DevicePath:        "/dev/video0",
+		Encoder:           "libx264",
+		BFrames:           -1,
+		CaptureTimestamps: true,
+		OutputURL:         "rtsp://127.0.0.1:8554/cam",
+		Outputs: []Output{
+			{Resolution: "640x360", Params: &Params{Encoder: "libx264", BFrames: -1, OutputURL: "rtsp://127.0.0.1:8554/cam-sub"}},
+		},
+	}
+	cmd := BuildCommand(params)
+	if !strings.Contains(cmd, " -f v4l2 -ts mono2abs -i /dev/video0 -copyts") {
+		t.Errorf("device input should keep wallclock capture times: %s", cmd)
+	}
+	if n := strings.Count(cmd, " -start_time_realtime 1 -rtsp_transport tcp -f rtsp "); n != 2 {
+		t.Errorf("every RTSP output should report from the Unix epoch, got %d: %s", n, cmd)
+	}
+
+	// Test sources have no capture times
+	params.OverlayText = "TEST MODE"
+	cmd = BuildCommand(params)
+	if strings.Contains(cmd, "-copyts") || strings.Contains(cmd, "-start_time_realtime") {
+		t.Errorf("test source should not carry capture times: %s", cmd)
+	}
+}
+
+func TestBuildCommandMultipleOutputsTestSource(t *testing.T) {
+	cmd := BuildCommand(&Params{
+		OverlayText: "NO SIGNAL",
+		Encoder:     "libx264",
+		BFrames:     -1,
+		OutputURL:   "rtsp://127.0.0.1:8554/cam",
+		Outputs: []Output{
+			{Resolution: "640x360", Params: &Params{Encoder: "libx264", BFrames: -1, OutputURL: "rtsp://127.0.0.1:8554/cam-sub"}},
+		},
+	})
+
+	// The overlay is drawn once, before the split
+	if !strings.Contains(cmd, `"[0:v]drawtext=text='NO SIGNAL'`) || !strings.Contains(cmd, ",split=2[s0][s1]") {
+		t.Errorf("overlay should precede the split: %s", cmd)
+	}
+	if strings.Contains(cmd, " -vf ") {
+		t.Errorf("split outputs should not use -vf: %s", cmd)
+	}
+}
+
+func TestBuildSlateCommand(t *testing.T) {
+	cmd := BuildSlateCommand(&Params{
+		Resolution:   "1280x720",
+		FPS:          "25",
+		OverlayText:  "NO SIGNAL",
+		Encoder:      "hevc_vaapi",
+		GlobalArgs:   []string{"-vaapi_device", "/dev/dri/renderD128"},
+		VideoFilters: "format=nv12,hwupload",
+		GOP:          50,
+		BFrames:      0,
+		OutputURL:    "rtsp://127.0.0.1:8554/cam",
+	})
+
+	for _, want := range []string{
+		" -vaapi_device /dev/dri/renderD128 -f lavfi -i \"color=c=0x202020:size=1280x720:rate=25\"",
+		" -frames:v 50 -vf \"drawtext=text='NO SIGNAL':",
+		",format=nv12,hwupload\" -c:v hevc_vaapi",
+		" -g 50 -bf 0 -an -f hevc pipe:1",
+	} {
+		if !strings.Contains(cmd, want) {
+			t.Errorf("command missing %q: %s", want, cmd)
+		}
+	}
+	if strings.Contains(cmd, "-re") || strings.Contains(cmd, "rtsp") {
+		t.Errorf("slate should be encoded once, not streamed: %s", cmd)
+	}
+}
+
+func TestSlateCodec(t *testing.T) {
+	tests := map[string]string{
+		"libx264":    "h264",
+		"h264_rkmpp": "h264",
+		"hevc_vaapi": "h265",
+		"libx265":    "h265",
+		"mpeg4":      "",
+	}
+	for encoder, want := range tests {
+		if got := SlateCodec(encoder); got != want {
+			t.Errorf("SlateCodec(%q) = %q, want %q", encoder, got, want)
+		}
+	}
+}
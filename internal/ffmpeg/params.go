@@ -10,6 +10,11 @@ type Params struct {
 	FPS         string // 30, 60, etc.
 	OverlayText string // If set, use test source with this overlay (e.g. "TEST MODE", "NO SIGNAL", "CRASH")
 
+	// CaptureTimestamps carries the V4L2 capture time of each frame as its
+	// RTP timestamp, with RTCP sender reports mapping RTP timestamps to
+	// wallclock, for latency tracing. Device inputs with RTSP outputs only
+	CaptureTimestamps bool
+
 	// Encoder Configuration
 	Encoder string // h264_vaapi, libx264, etc.
 
@@ -41,4 +46,17 @@ type Params struct {
 
 	// Behavior Options
 	Options []OptionType // FFmpeg behavior flags
+
+	// Extra encoded outputs (rungs) of the same capture
+	Outputs []Output
+}
+
+// Output is an extra encoded output of a command's capture, such as a
+// low-bitrate sub-stream. The device is captured and decoded once and split
+// to every output. Only the encoder, rate control, hardware, filter and
+// output fields of Params are used; input, audio and options come from the
+// main command.
+type Output struct {
+	Resolution string // Scale to WIDTHxHEIGHT before encoding (empty = capture size)
+	Params     *Params
 }
@@ -0,0 +1,68 @@
+package ffmpeg
+
+import (
+	"fmt"
+	"strings"
+)
+
+// slateBackground is the solid color slates are drawn on.
+const slateBackground = "0x202020"
+
+// SlateCodec returns the codec ("h264" or "h265") of the raw bitstream an
+// encoder produces, or "" if slates can't be pre-encoded with it.
+func SlateCodec(encoder string) string {
+	switch {
+	case strings.Contains(encoder, "h264") || strings.Contains(encoder, "x264"):
+		return "h264"
+	case strings.Contains(encoder, "hevc") || strings.Contains(encoder, "h265") || strings.Contains(encoder, "x265"):
+		return "h265"
+	default:
+		return ""
+	}
+}
+
+// BuildSlateCommand builds an FFmpeg command that encodes one GOP of a static
+// slate, p.OverlayText on a solid background, with the encoder settings of
+// p, and writes it to stdout as an Annex B byte stream. The clip starts with
+// a keyframe and ends before the next one, so it can be looped seamlessly.
+// Input, audio, progress and output fields of p are ignored.
+func BuildSlateCommand(p *Params) string {
+	var cmd strings.Builder
+
+	cmd.WriteString(Base())
+	for _, arg := range p.GlobalArgs {
+		cmd.WriteString(" " + arg)
+	}
+
+	size := p.Resolution
+	if size == "" {
+		size = "1920x1080"
+	}
+	rate := p.FPS
+	if rate == "" {
+		rate = "30"
+	}
+	fmt.Fprintf(&cmd, " -f lavfi -i \"color=c=%s:size=%s:rate=%s\"", slateBackground, size, rate)
+
+	frames := p.GOP
+	if frames <= 0 {
+		frames = 60 // writeVideoEncoder's default GOP
+	}
+	fmt.Fprintf(&cmd, " -frames:v %d", frames)
+
+	videoFilterChain := []string{overlayFilter(p.OverlayText)}
+	if p.VideoFilters != "" {
+		videoFilterChain = append(videoFilterChain, p.VideoFilters)
+	}
+	cmd.WriteString(" -vf \"" + strings.Join(videoFilterChain, ",") + "\"")
+
+	writeVideoEncoder(&cmd, p)
+
+	muxer := "h264"
+	if SlateCodec(p.Encoder) == "h265" {
+		muxer = "hevc"
+	}
+	cmd.WriteString(" -an -f " + muxer + " pipe:1")
+
+	return cmd.String()
+}
@@ -2,76 +2,177 @@ package logging
 
 import (
 	"sync"
+	"sync/atomic"
 	"time"
 )
 
+// Attr is a flattened log attribute. Attributes inside groups are keyed with
+// dot notation (e.g. "request.id").
+type Attr struct {
+	Key   string
+	Value any
+}
+
 // LogEntry represents a single log line stored in the ring buffer.
 type LogEntry struct {
-	Timestamp  time.Time      `json:"timestamp"`
-	Level      string         `json:"level"`
-	Module     string         `json:"module"`
-	Message    string         `json:"message"`
-	Attributes map[string]any `json:"attributes,omitempty"`
+	Seq       uint64    `json:"seq"`
+	Timestamp time.Time `json:"timestamp"`
+	Level     string    `json:"level"`
+	Module    string    `json:"module"`
+	Message   string    `json:"message"`
+	Attrs     []Attr    `json:"-"`
+}
+
+// AttributeMap returns the entry's attributes as a map, or nil if it has none.
+func (e *LogEntry) AttributeMap() map[string]any {
+	if len(e.Attrs) == 0 {
+		return nil
+	}
+	m := make(map[string]any, len(e.Attrs))
+	for _, a := range e.Attrs {
+		m[a.Key] = a.Value
+	}
+	return m
 }
 
-// RingBuffer is a thread-safe circular buffer for log entries.
+// RingBuffer is a lock-free circular buffer for log entries.
+//
+// Every entry gets a sequence number, starting at 1. Readers keep the last
+// sequence number they saw as a cursor and fetch only newer entries with
+// ReadSince. Writers never block on readers or on each other.
 type RingBuffer struct {
-	entries []LogEntry
-	size    int
-	head    int
-	count   int
-	mu      sync.RWMutex
+	slots []atomic.Pointer[LogEntry]
+	mask  uint64
+	next  atomic.Uint64 // sequence number of the last reserved entry
+
+	waiters   atomic.Pointer[[]chan struct{}]
+	waitersMu sync.Mutex // serializes Subscribe and unsubscribe, never taken by Write
 }
 
-// NewRingBuffer creates a new ring buffer with the specified capacity.
+// NewRingBuffer creates a new ring buffer holding at least size entries.
+// The capacity is rounded up to a power of two.
 func NewRingBuffer(size int) *RingBuffer {
+	capacity := 1
+	for capacity < size {
+		capacity <<= 1
+	}
 	return &RingBuffer{
-		entries: make([]LogEntry, size),
-		size:    size,
+		slots: make([]atomic.Pointer[LogEntry], capacity),
+		mask:  uint64(capacity - 1),
 	}
 }
 
 // Write adds a log entry to the buffer, overwriting the oldest entry if full.
-func (rb *RingBuffer) Write(entry LogEntry) {
-	rb.mu.Lock()
-	defer rb.mu.Unlock()
+// It returns the sequence number assigned to the entry.
+func (rb *RingBuffer) Write(entry LogEntry) uint64 {
+	seq := rb.next.Add(1)
+	entry.Seq = seq
+	slot := &rb.slots[seq&rb.mask]
 
-	rb.entries[rb.head] = entry
-	rb.head = (rb.head + 1) % rb.size
+	// A writer a full lap ahead may already own this slot; keep the newer entry
+	for {
+		old := slot.Load()
+		if old != nil && old.Seq > seq {
+			break
+		}
+		if slot.CompareAndSwap(old, &entry) {
+			break
+		}
+	}
 
-	if rb.count < rb.size {
-		rb.count++
+	if waiters := rb.waiters.Load(); waiters != nil {
+		for _, ch := range *waiters {
+			select {
+			case ch <- struct{}{}:
+			default:
+			}
+		}
 	}
+
+	return seq
+}
+
+// ReadSince appends the entries with a sequence number greater than cursor
+// to dst, in order, and returns the new cursor. Entries that were already
+// overwritten are skipped, so a gap between cursor and the first returned
+// Seq is the number of entries the reader missed.
+func (rb *RingBuffer) ReadSince(cursor uint64, dst []LogEntry) ([]LogEntry, uint64) {
+	last := rb.next.Load()
+	first := cursor + 1
+	if size := uint64(len(rb.slots)); last >= size && first <= last-size {
+		first = last - size + 1
+	}
+
+	for seq := first; seq <= last; seq++ {
+		e := rb.slots[seq&rb.mask].Load()
+		switch {
+		case e != nil && e.Seq == seq:
+			dst = append(dst, *e)
+		case e != nil && e.Seq > seq:
+			// Overwritten while we were reading
+		default:
+			// Reserved but not stored yet, pick it up on the next read
+			return dst, seq - 1
+		}
+	}
+
+	return dst, last
 }
 
 // ReadAll returns all entries in chronological order.
 func (rb *RingBuffer) ReadAll() []LogEntry {
-	rb.mu.RLock()
-	defer rb.mu.RUnlock()
+	entries, _ := rb.ReadSince(0, nil)
+	return entries
+}
 
-	if rb.count == 0 {
-		return nil
+// Last returns the sequence number of the newest entry, 0 if none.
+func (rb *RingBuffer) Last() uint64 {
+	return rb.next.Load()
+}
+
+// Count returns the number of entries in the buffer.
+func (rb *RingBuffer) Count() int {
+	n := rb.next.Load()
+	if size := uint64(len(rb.slots)); n > size {
+		return len(rb.slots)
 	}
+	return int(n)
+}
 
-	result := make([]LogEntry, rb.count)
-
-	if rb.count < rb.size {
-		// Buffer not full yet, entries start at 0
-		copy(result, rb.entries[:rb.count])
-	} else {
-		// Buffer is full, oldest entry is at head
-		firstPart := rb.entries[rb.head:]
-		secondPart := rb.entries[:rb.head]
-		copy(result, firstPart)
-		copy(result[len(firstPart):], secondPart)
+// Subscribe returns a channel that receives a signal after entries are
+// written, and a function to stop the subscription. Signals are coalesced:
+// one signal may stand for many entries, read them with ReadSince.
+func (rb *RingBuffer) Subscribe() (<-chan struct{}, func()) {
+	ch := make(chan struct{}, 1)
+
+	rb.waitersMu.Lock()
+	rb.storeWaiters(append(rb.loadWaiters(), ch))
+	rb.waitersMu.Unlock()
+
+	return ch, func() {
+		rb.waitersMu.Lock()
+		defer rb.waitersMu.Unlock()
+
+		current := rb.loadWaiters()
+		updated := make([]chan struct{}, 0, len(current))
+		for _, c := range current {
+			if c != ch {
+				updated = append(updated, c)
+			}
+		}
+		rb.storeWaiters(updated)
 	}
+}
 
-	return result
+// loadWaiters returns a copy of the subscriber list. Caller holds waitersMu.
+func (rb *RingBuffer) loadWaiters() []chan struct{} {
+	if w := rb.waiters.Load(); w != nil {
+		return append([]chan struct{}(nil), (*w)...)
+	}
+	return nil
 }
 
-// Count returns the number of entries in the buffer.
-func (rb *RingBuffer) Count() int {
-	rb.mu.RLock()
-	defer rb.mu.RUnlock()
-	return rb.count
+// storeWaiters publishes a new subscriber list. Caller holds waitersMu.
+func (rb *RingBuffer) storeWaiters(w []chan struct{}) {
+	rb.waiters.Store(&w)
 }
@@ -4,17 +4,12 @@ import (
 	"context"
 	"fmt"
 	"log/slog"
-	"sort"
+	"slices"
 	"strings"
 	"time"
 )
 
-// LogCallback is called when a new log entry is written.
-// Used to publish log events without creating import cycles.
-type LogCallback func(entry LogEntry)
-
-// BufferHandler is a slog.Handler that writes to a ring buffer
-// and optionally calls a callback for each log entry.
+// BufferHandler is a slog.Handler that writes to a ring buffer.
 // It dynamically accesses the global buffer so loggers created before
 // Initialize() still write to the buffer once it's available.
 type BufferHandler struct {
@@ -39,10 +34,9 @@ func (h *BufferHandler) Enabled(_ context.Context, level slog.Level) bool {
 
 // Handle implements slog.Handler.
 func (h *BufferHandler) Handle(_ context.Context, r slog.Record) error {
-	// Dynamically access global buffer and callback
+	// Dynamically access global buffer
 	mutex.RLock()
 	buf := logBuffer
-	cb := logCallback
 	mutex.RUnlock()
 
 	// Skip if buffer not yet initialized
@@ -50,7 +44,10 @@ func (h *BufferHandler) Handle(_ context.Context, r slog.Record) error {
 		return nil
 	}
 
-	attrs := make(map[string]any)
+	var attrs []Attr
+	if n := len(h.attrs) + r.NumAttrs(); n > 0 {
+		attrs = make([]Attr, 0, n)
+	}
 	module := "app"
 
 	// Process handler-level attrs (from WithAttrs)
@@ -58,7 +55,7 @@ func (h *BufferHandler) Handle(_ context.Context, r slog.Record) error {
 		if a.Key == "module" {
 			module = a.Value.String()
 		} else {
-			flattenAttr(attrs, h.groups, a)
+			attrs = flattenAttr(attrs, h.groups, a)
 		}
 	}
 
@@ -67,30 +64,24 @@ func (h *BufferHandler) Handle(_ context.Context, r slog.Record) error {
 		if a.Key == "module" {
 			module = a.Value.String()
 		} else {
-			flattenAttr(attrs, h.groups, a)
+			attrs = flattenAttr(attrs, h.groups, a)
 		}
 		return true
 	})
 
-	entry := LogEntry{
-		Timestamp:  r.Time,
-		Level:      levelToString(r.Level),
-		Module:     module,
-		Message:    r.Message,
-		Attributes: attrs,
-	}
-
-	buf.Write(entry)
-
-	if cb != nil {
-		cb(entry)
-	}
+	buf.Write(LogEntry{
+		Timestamp: r.Time,
+		Level:     levelToString(r.Level),
+		Module:    module,
+		Message:   r.Message,
+		Attrs:     attrs,
+	})
 
 	return nil
 }
 
-// flattenAttr extracts a slog.Attr into a flat map with dot-notation keys for groups.
-func flattenAttr(attrs map[string]any, groups []string, a slog.Attr) {
+// flattenAttr appends a slog.Attr to attrs with dot-notation keys for groups.
+func flattenAttr(attrs []Attr, groups []string, a slog.Attr) []Attr {
 	key := a.Key
 	if len(groups) > 0 {
 		key = strings.Join(groups, ".") + "." + key
@@ -100,21 +91,21 @@ func flattenAttr(attrs map[string]any, groups []string, a slog.Attr) {
 	case slog.KindGroup:
 		// Recursively flatten group attributes
 		for _, ga := range a.Value.Group() {
-			flattenAttr(attrs, append(groups, a.Key), ga)
+			attrs = flattenAttr(attrs, append(groups, a.Key), ga)
 		}
+		return attrs
 	case slog.KindTime:
-		attrs[key] = a.Value.Time().Format(time.RFC3339Nano)
+		return append(attrs, Attr{key, a.Value.Time().Format(time.RFC3339Nano)})
 	case slog.KindDuration:
-		attrs[key] = a.Value.Duration().String()
+		return append(attrs, Attr{key, a.Value.Duration().String()})
 	case slog.KindAny:
 		// Handle error type specially
 		if err, ok := a.Value.Any().(error); ok {
-			attrs[key] = err.Error()
-		} else {
-			attrs[key] = a.Value.Any()
+			return append(attrs, Attr{key, err.Error()})
 		}
+		return append(attrs, Attr{key, a.Value.Any()})
 	default:
-		attrs[key] = a.Value.Any()
+		return append(attrs, Attr{key, a.Value.Any()})
 	}
 }
 
@@ -169,18 +160,15 @@ func FormatLogLine(entry LogEntry) string {
 	sb.WriteString("] ")
 	sb.WriteString(entry.Message)
 
-	// Append attributes in key=value format
-	if len(entry.Attributes) > 0 {
-		keys := make([]string, 0, len(entry.Attributes))
-		for k := range entry.Attributes {
-			keys = append(keys, k)
-		}
-		sort.Strings(keys)
-		for _, k := range keys {
+	// Append attributes in key=value format, sorted by key
+	if len(entry.Attrs) > 0 {
+		attrs := slices.Clone(entry.Attrs)
+		slices.SortStableFunc(attrs, func(a, b Attr) int { return strings.Compare(a.Key, b.Key) })
+		for _, a := range attrs {
 			sb.WriteString(" ")
-			sb.WriteString(k)
+			sb.WriteString(a.Key)
 			sb.WriteString("=")
-			sb.WriteString(fmt.Sprint(entry.Attributes[k]))
+			sb.WriteString(fmt.Sprint(a.Value))
 		}
 	}
 
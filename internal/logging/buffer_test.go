@@ -0,0 +1,97 @@
+package logging
+
+import (
+	"fmt"
+	"sync"
+	"testing"
+)
+
+func TestRingBuffer_ReadSince(t *testing.T) {
+	rb := NewRingBuffer(4)
+	for i := range 3 {
+		rb.Write(LogEntry{Message: fmt.Sprint(i)})
+	}
+
+	entries, cursor := rb.ReadSince(0, nil)
+	if len(entries) != 3 || cursor != 3 {
+		t.Fatalf("ReadSince(0) = %d entries, cursor %d; want 3, 3", len(entries), cursor)
+	}
+
+	rb.Write(LogEntry{Message: "3"})
+	entries, cursor = rb.ReadSince(cursor, nil)
+	if len(entries) != 1 || entries[0].Message != "3" || entries[0].Seq != 4 || cursor != 4 {
+		t.Errorf("incremental read = %+v, cursor %d; want only seq 4", entries, cursor)
+	}
+
+	entries, _ = rb.ReadSince(cursor, nil)
+	if len(entries) != 0 {
+		t.Errorf("read with current cursor returned %d entries, want 0", len(entries))
+	}
+}
+
+func TestRingBuffer_Overwrite(t *testing.T) {
+	rb := NewRingBuffer(4)
+	for i := range 10 {
+		rb.Write(LogEntry{Message: fmt.Sprint(i)})
+	}
+
+	if got := rb.Count(); got != 4 {
+		t.Errorf("Count() = %d, want 4", got)
+	}
+
+	// A cursor that fell behind gets the newest entries, the gap shows the loss
+	entries, cursor := rb.ReadSince(2, nil)
+	if len(entries) != 4 || entries[0].Seq != 7 || cursor != 10 {
+		t.Errorf("ReadSince(2) = %d entries from seq %d, cursor %d; want 4 from 7, cursor 10", len(entries), entries[0].Seq, cursor)
+	}
+	for i, e := range entries {
+		if want := fmt.Sprint(6 + i); e.Message != want {
+			t.Errorf("entry %d = %q, want %q", i, e.Message, want)
+		}
+	}
+}
+
+func TestRingBuffer_ConcurrentWrites(t *testing.T) {
+	rb := NewRingBuffer(1024)
+	wake, stop := rb.Subscribe()
+	defer stop()
+
+	var wg sync.WaitGroup
+	for range 8 {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for range 100 {
+				rb.Write(LogEntry{Message: "x"})
+			}
+		}()
+	}
+	wg.Wait()
+
+	select {
+	case <-wake:
+	default:
+		t.Error("subscriber was not signaled")
+	}
+
+	entries, cursor := rb.ReadSince(0, nil)
+	if len(entries) != 800 || cursor != 800 {
+		t.Fatalf("read %d entries, cursor %d; want 800, 800", len(entries), cursor)
+	}
+	for i, e := range entries {
+		if e.Seq != uint64(i+1) {
+			t.Fatalf("entry %d has seq %d, want %d", i, e.Seq, i+1)
+		}
+	}
+}
+
+func TestLogEntry_AttributeMap(t *testing.T) {
+	e := LogEntry{Attrs: []Attr{{Key: "stream_id", Value: "cam1"}, {Key: "repeated", Value: 3}}}
+	m := e.AttributeMap()
+	if m["stream_id"] != "cam1" || m["repeated"] != 3 {
+		t.Errorf("AttributeMap() = %v", m)
+	}
+	if (&LogEntry{}).AttributeMap() != nil {
+		t.Error("AttributeMap() of entry without attributes should be nil")
+	}
+}
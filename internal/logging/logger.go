@@ -26,7 +26,6 @@ var (
 	isInitialized   bool
 	mutex           sync.RWMutex
 	logBuffer       *RingBuffer
-	logCallback     LogCallback
 )
 
 // Config represents logging configuration.
@@ -85,14 +84,6 @@ func GetBuffer() *RingBuffer {
 	return logBuffer
 }
 
-// SetLogCallback sets a callback to be called for each new log entry.
-// Used for publishing log events to SSE clients.
-func SetLogCallback(callback LogCallback) {
-	mutex.Lock()
-	defer mutex.Unlock()
-	logCallback = callback
-}
-
 // GetLogger returns a logger for the specified module, creating it if needed.
 func GetLogger(module string) *slog.Logger {
 	mutex.RLock()
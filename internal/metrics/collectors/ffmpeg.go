@@ -8,8 +8,6 @@ import (
 	"log/slog"
 	"net"
 	"os"
-	"strconv"
-	"strings"
 	"sync"
 	"time"
 
@@ -17,15 +15,20 @@ import (
 	"github.com/smazurov/videonode/internal/metrics"
 )
 
+// progressReadBufferSize bounds a progress line. FFmpeg's lines are short;
+// longer ones are skipped.
+const progressReadBufferSize = 4096
+
 // FFmpegCollector collects FFmpeg progress data via Unix socket.
 type FFmpegCollector struct {
 	logger     *slog.Logger
 	socketPath string
 	streamID   string
 	listener   net.Listener
-	ctx        context.Context
-	cancel     context.CancelFunc
+	conns      map[net.Conn]struct{} // Open progress connections, closed on Stop
+	mu         sync.Mutex
 	stopOnce   sync.Once
+	stopCtx    func() bool // Unregisters the context's stop hook
 }
 
 // NewFFmpegCollector creates a new FFmpeg collector.
@@ -34,131 +37,124 @@ func NewFFmpegCollector(socketPath, streamID string) *FFmpegCollector {
 		logger:     logging.GetLogger("streams").With("stream_id", streamID),
 		socketPath: socketPath,
 		streamID:   streamID,
+		conns:      make(map[net.Conn]struct{}),
 	}
 }
 
-// Start begins collecting FFmpeg data.
+// Start begins collecting FFmpeg data. The collector stops when ctx is done
+// or Stop is called. Both close the listener and open connections, which
+// ends their goroutines; nothing polls for shutdown.
 func (f *FFmpegCollector) Start(ctx context.Context) error {
-	f.ctx, f.cancel = context.WithCancel(ctx)
-	go f.startSocketListener()
+	f.logger.Info("Starting socket listener", "socket", f.socketPath)
+
+	if err := os.Remove(f.socketPath); err != nil && !os.IsNotExist(err) {
+		f.logger.Warn("Failed to clean up old socket file", "error", err)
+	}
+
+	listener, err := net.Listen("unix", f.socketPath)
+	if err != nil {
+		f.logger.Error("Failed to create Unix socket listener", "error", err)
+		return nil // the stream runs without progress metrics
+	}
+
+	f.mu.Lock()
+	f.listener = listener
+	f.stopCtx = context.AfterFunc(ctx, func() { _ = f.Stop() })
+	f.mu.Unlock()
+
+	go f.acceptConnections(listener)
 	return nil
 }
 
 // Stop stops the FFmpeg collector.
 func (f *FFmpegCollector) Stop() error {
-	var stopErr error
 	f.stopOnce.Do(func() {
-		if f.cancel != nil {
-			f.cancel()
+		f.mu.Lock()
+		if f.stopCtx != nil {
+			f.stopCtx()
 		}
 		if f.listener != nil {
 			f.listener.Close()
 			f.listener = nil
 		}
+		for conn := range f.conns {
+			conn.Close()
+		}
+		clear(f.conns)
+		f.mu.Unlock()
+
 		if f.socketPath != "" {
 			os.Remove(f.socketPath)
 		}
 		metrics.DeleteFFmpegMetrics(f.streamID)
 	})
-	return stopErr
+	return nil
 }
 
-func (f *FFmpegCollector) startSocketListener() {
-	f.logger.Info("Starting socket listener", "socket", f.socketPath)
-
-	if err := os.Remove(f.socketPath); err != nil && !os.IsNotExist(err) {
-		f.logger.Warn("Failed to clean up old socket file", "error", err)
-	}
-
-	listener, err := net.Listen("unix", f.socketPath)
-	if err != nil {
-		f.logger.Error("Failed to create Unix socket listener", "error", err)
-		return
-	}
-
-	f.listener = listener
-	defer func() {
-		listener.Close()
-		os.Remove(f.socketPath)
-	}()
-
+// acceptConnections serves progress connections until the listener closes.
+func (f *FFmpegCollector) acceptConnections(listener net.Listener) {
 	for {
-		select {
-		case <-f.ctx.Done():
+		conn, err := listener.Accept()
+		if err != nil {
+			if !errors.Is(err, net.ErrClosed) {
+				f.logger.Warn("Error accepting connection, stopping listener", "error", err)
+			}
 			return
-		default:
-		}
-
-		if ul, ok := listener.(*net.UnixListener); ok {
-			ul.SetDeadline(time.Now().Add(1 * time.Second))
 		}
 
-		conn, acceptErr := listener.Accept()
-		if acceptErr != nil {
-			var netErr net.Error
-			if errors.As(acceptErr, &netErr) {
-				continue
-			}
-			select {
-			case <-f.ctx.Done():
-				return
-			default:
-				if strings.Contains(acceptErr.Error(), "use of closed network connection") {
-					return
-				}
-				f.logger.Warn("Error accepting connection", "error", acceptErr)
-				continue
-			}
+		if !f.track(conn) {
+			conn.Close() // stopped meanwhile
+			return
 		}
-
 		go f.handleConnection(conn)
 	}
 }
 
-func (f *FFmpegCollector) handleConnection(conn net.Conn) {
-	defer conn.Close()
+// track registers an open connection. Returns false once stopped.
+func (f *FFmpegCollector) track(conn net.Conn) bool {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	if f.listener == nil {
+		return false
+	}
+	f.conns[conn] = struct{}{}
+	return true
+}
 
-	scanner := bufio.NewScanner(conn)
-	progressData := make(map[string]string)
+func (f *FFmpegCollector) untrack(conn net.Conn) {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	delete(f.conns, conn)
+}
 
-	for scanner.Scan() {
-		select {
-		case <-f.ctx.Done():
-			return
-		default:
-		}
+// handleConnection reads the progress blocks of one FFmpeg process. Lines are
+// read in place from a fixed buffer and parsed without allocating.
+func (f *FFmpegCollector) handleConnection(conn net.Conn) {
+	defer func() {
+		f.untrack(conn)
+		conn.Close()
+	}()
 
-		line := strings.TrimSpace(scanner.Text())
-		if line == "" {
-			continue
-		}
+	reader := bufio.NewReaderSize(conn, progressReadBufferSize)
+	recorder := metrics.NewFFmpegProgressRecorder(f.streamID)
+	var tracker progressTracker
+	var block ffmpegProgress
+	skipping := false
 
-		if strings.Contains(line, "=") {
-			parts := strings.SplitN(line, "=", 2)
-			if len(parts) == 2 {
-				progressData[strings.TrimSpace(parts[0])] = strings.TrimSpace(parts[1])
-			}
+	for {
+		line, err := reader.ReadSlice('\n')
+		switch {
+		case errors.Is(err, bufio.ErrBufferFull):
+			skipping = true // rest of an overlong line follows
+			continue
+		case skipping:
+			skipping = false
+		case len(line) > 0 && block.parseLine(line):
+			recorder.Record(tracker.update(&block, time.Now()))
+			block = ffmpegProgress{}
 		}
-
-		if strings.Contains(line, "progress=") {
-			f.sendProgressMetrics(progressData)
-			progressData = make(map[string]string)
+		if err != nil {
+			return
 		}
 	}
 }
-
-func (f *FFmpegCollector) sendProgressMetrics(data map[string]string) {
-	if fps, err := strconv.ParseFloat(data["fps"], 64); err == nil {
-		metrics.SetFFmpegFPS(f.streamID, fps)
-	}
-	if dropped, err := strconv.ParseFloat(data["drop_frames"], 64); err == nil {
-		metrics.SetFFmpegDroppedFrames(f.streamID, dropped)
-	}
-	if dup, err := strconv.ParseFloat(data["dup_frames"], 64); err == nil {
-		metrics.SetFFmpegDuplicateFrames(f.streamID, dup)
-	}
-	speedStr := strings.TrimSuffix(data["speed"], "x")
-	if speed, err := strconv.ParseFloat(strings.TrimSpace(speedStr), 64); err == nil {
-		metrics.SetFFmpegSpeed(f.streamID, speed)
-	}
-}
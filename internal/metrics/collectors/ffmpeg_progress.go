@@ -0,0 +1,170 @@
+package collectors
+
+import (
+	"bytes"
+	"strconv"
+	"time"
+
+	"github.com/smazurov/videonode/internal/metrics"
+)
+
+// progressField flags the fields set in a progress block.
+type progressField uint16
+
+const (
+	fieldFrame progressField = 1 << iota
+	fieldFPS
+	fieldBitrate
+	fieldTotalSize
+	fieldOutTime
+	fieldDropFrames
+	fieldDupFrames
+	fieldSpeed
+)
+
+// ffmpegProgress is one block of FFmpeg -progress output, the key=value
+// lines up to and including "progress=continue" (or "end"). Values FFmpeg
+// reports as N/A leave their field unset.
+type ffmpegProgress struct {
+	set        progressField
+	frame      int64
+	fps        float64
+	bitrate    float64 // kbit/s, FFmpeg's average since start
+	totalSize  int64   // bytes
+	outTimeUs  int64
+	dropFrames int64
+	dupFrames  int64
+	speed      float64
+}
+
+// parseLine parses one progress line into the block. It reports whether the
+// line ends the block. Unknown keys and unparsable values are ignored.
+// Parsing doesn't allocate.
+func (p *ffmpegProgress) parseLine(line []byte) bool {
+	key, value, ok := bytes.Cut(line, []byte{'='})
+	if !ok {
+		return false
+	}
+	key = bytes.TrimSpace(key)
+	value = bytes.TrimSpace(value)
+
+	// switch on string(key) compares without converting
+	switch string(key) {
+	case "frame":
+		p.setInt(fieldFrame, &p.frame, value)
+	case "fps":
+		p.setFloat(fieldFPS, &p.fps, value)
+	case "bitrate":
+		p.setFloat(fieldBitrate, &p.bitrate, bytes.TrimSuffix(value, []byte("kbits/s")))
+	case "total_size":
+		p.setInt(fieldTotalSize, &p.totalSize, value)
+	case "out_time_us":
+		p.setInt(fieldOutTime, &p.outTimeUs, value)
+	case "drop_frames":
+		p.setInt(fieldDropFrames, &p.dropFrames, value)
+	case "dup_frames":
+		p.setInt(fieldDupFrames, &p.dupFrames, value)
+	case "speed":
+		p.setFloat(fieldSpeed, &p.speed, bytes.TrimSpace(bytes.TrimSuffix(value, []byte{'x'})))
+	case "progress":
+		return true
+	}
+	return false
+}
+
+func (p *ffmpegProgress) setInt(field progressField, dst *int64, value []byte) {
+	if n, ok := parseDecimal(value); ok {
+		*dst = n
+		p.set |= field
+	}
+}
+
+func (p *ffmpegProgress) setFloat(field progressField, dst *float64, value []byte) {
+	// The string conversion doesn't escape ParseFloat, so it stays on the stack
+	if f, err := strconv.ParseFloat(string(value), 64); err == nil {
+		*dst = f
+		p.set |= field
+	}
+}
+
+// parseDecimal parses an optionally negative decimal integer.
+func parseDecimal(b []byte) (int64, bool) {
+	negative := len(b) > 0 && b[0] == '-'
+	if negative {
+		b = b[1:]
+	}
+	if len(b) == 0 || len(b) > 18 {
+		return 0, false
+	}
+
+	var n int64
+	for _, c := range b {
+		if c < '0' || c > '9' {
+			return 0, false
+		}
+		n = n*10 + int64(c-'0')
+	}
+	if negative {
+		n = -n
+	}
+	return n, true
+}
+
+// progressTracker turns the progress blocks of one FFmpeg process into stream
+// metrics, deriving the output bitrate and encode lag.
+type progressTracker struct {
+	current metrics.FFmpegStreamMetrics
+
+	lastBytes int64
+	lastAt    time.Time
+
+	// lagBase is the smallest wall clock minus output time seen, the offset
+	// of the process's best point. Lag is measured against it, so startup
+	// time before the first frame isn't counted as lag.
+	lagBase time.Duration
+	hasBase bool
+}
+
+// update folds a block received at now into the current metrics.
+func (t *progressTracker) update(p *ffmpegProgress, now time.Time) *metrics.FFmpegStreamMetrics {
+	m := &t.current
+	if p.set&fieldFrame != 0 {
+		m.Frames = float64(p.frame)
+	}
+	if p.set&fieldFPS != 0 {
+		m.FPS = p.fps
+	}
+	if p.set&fieldDropFrames != 0 {
+		m.DroppedFrames = float64(p.dropFrames)
+	}
+	if p.set&fieldDupFrames != 0 {
+		m.DuplicateFrames = float64(p.dupFrames)
+	}
+	if p.set&fieldSpeed != 0 {
+		m.Speed = p.speed
+	}
+
+	// Output bitrate over the last interval from total_size. Outputs that
+	// don't report a size (RTSP) fall back to FFmpeg's average bitrate.
+	switch {
+	case p.set&fieldTotalSize != 0:
+		if !t.lastAt.IsZero() && p.totalSize >= t.lastBytes {
+			if elapsed := now.Sub(t.lastAt).Seconds(); elapsed > 0 {
+				m.OutputBitrate = float64(p.totalSize-t.lastBytes) * 8 / elapsed
+			}
+		}
+		m.OutputBytes = float64(p.totalSize)
+		t.lastBytes, t.lastAt = p.totalSize, now
+	case p.set&fieldBitrate != 0:
+		m.OutputBitrate = p.bitrate * 1000
+	}
+
+	if p.set&fieldOutTime != 0 {
+		offset := time.Duration(now.UnixNano()) - time.Duration(p.outTimeUs)*time.Microsecond
+		if !t.hasBase || offset < t.lagBase {
+			t.lagBase, t.hasBase = offset, true
+		}
+		m.EncodeLag = (offset - t.lagBase).Seconds()
+	}
+	return m
+}
@@ -0,0 +1,148 @@
+package collectors
+
+import (
+	"strings"
+	"testing"
+	"time"
+)
+
+const testProgressBlock = `frame=1234
+fps=29.97
+stream_0_0_q=23.0
+bitrate=1843.2kbits/s
+total_size=9437184
+out_time_us=41133333
+out_time_ms=41133333
+out_time=00:00:41.133333
+dup_frames=1
+drop_frames=3
+speed=1.01x
+progress=continue
+`
+
+func parseBlock(t *testing.T, block string) ffmpegProgress {
+	t.Helper()
+	var p ffmpegProgress
+	lines := strings.SplitAfter(block, "\n")
+	for i, line := range lines {
+		if p.parseLine([]byte(line)) != (i == len(lines)-2) {
+			t.Fatalf("line %q ended the block: %v", line, i != len(lines)-2)
+		}
+	}
+	return p
+}
+
+func TestFFmpegProgressParseLine(t *testing.T) {
+	p := parseBlock(t, testProgressBlock)
+
+	if p.frame != 1234 || p.fps != 29.97 || p.bitrate != 1843.2 || p.totalSize != 9437184 ||
+		p.outTimeUs != 41133333 || p.dupFrames != 1 || p.dropFrames != 3 || p.speed != 1.01 {
+		t.Errorf("parsed block = %+v", p)
+	}
+	all := fieldFrame | fieldFPS | fieldBitrate | fieldTotalSize | fieldOutTime | fieldDropFrames | fieldDupFrames | fieldSpeed
+	if p.set != all {
+		t.Errorf("set fields = %b, want %b", p.set, all)
+	}
+}
+
+func TestFFmpegProgressParseLineUnavailable(t *testing.T) {
+	p := parseBlock(t, "frame=0\nbitrate=N/A\ntotal_size=N/A\nout_time_us=N/A\nspeed=N/A\nfps=bogus\nprogress=continue\n")
+
+	if p.set != fieldFrame {
+		t.Errorf("set fields = %b, want only frame", p.set)
+	}
+}
+
+func TestParseDecimal(t *testing.T) {
+	tests := []struct {
+		in   string
+		want int64
+		ok   bool
+	}{
+		{"0", 0, true},
+		{"9437184", 9437184, true},
+		{"-42", -42, true},
+		{"", 0, false},
+		{"-", 0, false},
+		{"N/A", 0, false},
+		{"12a", 0, false},
+		{"1234567890123456789", 0, false},
+	}
+	for _, tt := range tests {
+		got, ok := parseDecimal([]byte(tt.in))
+		if got != tt.want || ok != tt.ok {
+			t.Errorf("parseDecimal(%q) = %d, %v, want %d, %v", tt.in, got, ok, tt.want, tt.ok)
+		}
+	}
+}
+
+func TestProgressTrackerDerivesBitrateAndLag(t *testing.T) {
+	var tracker progressTracker
+	start := time.Unix(1000, 0)
+
+	// Startup before the first frame isn't lag
+	m := tracker.update(&ffmpegProgress{set: fieldTotalSize | fieldOutTime, totalSize: 0, outTimeUs: 0}, start.Add(2*time.Second))
+	if m.EncodeLag != 0 || m.OutputBitrate != 0 {
+		t.Errorf("first block lag = %v, bitrate = %v, want 0", m.EncodeLag, m.OutputBitrate)
+	}
+
+	// 250 KB in one second with output keeping up
+	m = tracker.update(&ffmpegProgress{set: fieldTotalSize | fieldOutTime, totalSize: 250000, outTimeUs: 1000000}, start.Add(3*time.Second))
+	if m.OutputBitrate != 2000000 || m.EncodeLag != 0 {
+		t.Errorf("bitrate = %v, lag = %v, want 2000000, 0", m.OutputBitrate, m.EncodeLag)
+	}
+
+	// Output advances half a second in one second of wall clock
+	m = tracker.update(&ffmpegProgress{set: fieldOutTime, outTimeUs: 1500000}, start.Add(4*time.Second))
+	if m.EncodeLag != 0.5 {
+		t.Errorf("lag = %v, want 0.5", m.EncodeLag)
+	}
+	if m.OutputBitrate != 2000000 || m.OutputBytes != 250000 {
+		t.Error("fields missing from a block lost their previous values")
+	}
+
+	// Outputs without a size report FFmpeg's average bitrate
+	var rtsp progressTracker
+	m = rtsp.update(&ffmpegProgress{set: fieldBitrate, bitrate: 1843.2}, start)
+	if m.OutputBitrate != 1843200 {
+		t.Errorf("bitrate = %v, want 1843200", m.OutputBitrate)
+	}
+}
+
+func TestFFmpegProgressParseDoesNotAllocate(t *testing.T) {
+	lines := strings.SplitAfter(testProgressBlock, "\n")
+	raw := make([][]byte, len(lines))
+	for i, line := range lines {
+		raw[i] = []byte(line)
+	}
+
+	var tracker progressTracker
+	now := time.Now()
+	allocs := testing.AllocsPerRun(100, func() {
+		var p ffmpegProgress
+		for _, line := range raw {
+			if p.parseLine(line) {
+				tracker.update(&p, now)
+			}
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("parsing a progress block allocated %v times, want 0", allocs)
+	}
+}
+
+func BenchmarkFFmpegProgressParse(b *testing.B) {
+	lines := strings.SplitAfter(testProgressBlock, "\n")
+	raw := make([][]byte, len(lines))
+	for i, line := range lines {
+		raw[i] = []byte(line)
+	}
+
+	b.ReportAllocs()
+	for b.Loop() {
+		var p ffmpegProgress
+		for _, line := range raw {
+			p.parseLine(line)
+		}
+	}
+}
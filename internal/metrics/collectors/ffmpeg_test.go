@@ -1,6 +1,8 @@
 package collectors
 
 import (
+	"context"
+	"errors"
 	"fmt"
 	"net"
 	"os"
@@ -271,3 +273,32 @@ func TestFFmpegCollectorHandleConnection(t *testing.T) {
 	conn.Close()
 	time.Sleep(30 * time.Millisecond)
 }
+
+func TestFFmpegCollectorContextCancelClosesConnections(t *testing.T) {
+	skipOnMacOS(t)
+	socketPath := filepath.Join(t.TempDir(), "ffmpeg6.sock")
+
+	collector := NewFFmpegCollector(socketPath, "test-stream-ffmpeg-cancel")
+	ctx, cancel := context.WithCancel(t.Context())
+	if err := collector.Start(ctx); err != nil {
+		t.Fatalf("failed to start collector: %v", err)
+	}
+
+	conn, err := net.Dial("unix", socketPath)
+	if err != nil {
+		t.Fatalf("failed to connect: %v", err)
+	}
+	defer conn.Close()
+	time.Sleep(20 * time.Millisecond) // let the collector accept
+
+	cancel()
+
+	// The collector closes its end, so a read returns instead of blocking
+	_ = conn.SetReadDeadline(time.Now().Add(time.Second))
+	if _, err := conn.Read(make([]byte, 1)); err == nil || errors.Is(err, os.ErrDeadlineExceeded) {
+		t.Errorf("read after cancel = %v, want the connection closed", err)
+	}
+	if _, err := os.Stat(socketPath); !os.IsNotExist(err) {
+		t.Error("expected socket file to be removed")
+	}
+}
@@ -2,7 +2,7 @@ package exporters
 
 import (
 	"context"
-	"strconv"
+	"math"
 	"sync"
 	"time"
 
@@ -15,13 +15,23 @@ type EventPublisher interface {
 	Publish(ev events.Event)
 }
 
-// SSEExporter exports FFmpeg stream metrics via Server-Sent Events.
+// SSEExporter exports FFmpeg stream metrics via Server-Sent Events. Each tick
+// publishes one batch with only the metrics that changed since the last one,
+// and nothing when none did.
 type SSEExporter struct {
 	eventBus EventPublisher
 	interval time.Duration
 	ctx      context.Context
 	cancel   context.CancelFunc
 	wg       sync.WaitGroup
+
+	mu   sync.Mutex
+	last map[string]streamValues // As last published
+}
+
+// streamValues are the metrics of a stream at the precision clients see.
+type streamValues struct {
+	fps, dropped, duplicate, speed, bitrate, lag float64
 }
 
 // NewSSEExporter creates a new SSE exporter.
@@ -29,6 +39,7 @@ func NewSSEExporter(eventBus EventPublisher) *SSEExporter {
 	return &SSEExporter{
 		eventBus: eventBus,
 		interval: 1 * time.Second,
+		last:     make(map[string]streamValues),
 	}
 }
 
@@ -64,17 +75,92 @@ func (s *SSEExporter) run() {
 
 func (s *SSEExporter) publishMetrics() {
 	allMetrics := metrics.GetAllFFmpegMetrics()
+
+	s.mu.Lock()
+	batch := events.StreamMetricsEvent{
+		EventType: "stream_metrics",
+		Streams:   make(map[string]events.StreamMetricsDelta),
+	}
 	for streamID, m := range allMetrics {
-		s.eventBus.Publish(events.StreamMetricsEvent{
-			EventType:       "stream_metrics",
-			StreamID:        streamID,
-			FPS:             strconv.FormatFloat(m.FPS, 'f', 2, 64),
-			DroppedFrames:   strconv.FormatFloat(m.DroppedFrames, 'f', 0, 64),
-			DuplicateFrames: strconv.FormatFloat(m.DuplicateFrames, 'f', 0, 64),
-		})
+		current := valuesOf(m)
+		previous, known := s.last[streamID]
+		if delta, changed := diffValues(previous, current, known); changed {
+			batch.Streams[streamID] = delta
+		}
+		s.last[streamID] = current
+	}
+	for streamID := range s.last {
+		if _, ok := allMetrics[streamID]; !ok {
+			delete(s.last, streamID)
+			batch.Removed = append(batch.Removed, streamID)
+		}
+	}
+	s.mu.Unlock()
+
+	// Published after unlocking, in tick order since only run() publishes
+	if len(batch.Streams) > 0 || len(batch.Removed) > 0 {
+		s.eventBus.Publish(batch)
+	}
+}
+
+// Snapshot returns a full batch of the metrics as last published, the
+// baseline for the deltas that follow.
+func (s *SSEExporter) Snapshot() events.StreamMetricsEvent {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	batch := events.StreamMetricsEvent{
+		EventType: "stream_metrics",
+		Full:      true,
+		Streams:   make(map[string]events.StreamMetricsDelta, len(s.last)),
+	}
+	for streamID, values := range s.last {
+		batch.Streams[streamID], _ = diffValues(streamValues{}, values, false)
+	}
+	return batch
+}
+
+func valuesOf(m *metrics.FFmpegStreamMetrics) streamValues {
+	return streamValues{
+		fps:       roundTo(m.FPS, 100),
+		dropped:   m.DroppedFrames,
+		duplicate: m.DuplicateFrames,
+		speed:     roundTo(m.Speed, 100),
+		bitrate:   roundTo(m.OutputBitrate, 1e-3), // kbit/s
+		lag:       roundTo(m.EncodeLag, 1000),     // ms
 	}
 }
 
+// diffValues returns the fields of current that differ from previous, or all
+// of them if previous isn't known.
+func diffValues(previous, current streamValues, known bool) (events.StreamMetricsDelta, bool) {
+	var delta events.StreamMetricsDelta
+	changed := false
+	for _, f := range []struct {
+		dst      **float64
+		from, to float64
+	}{
+		{&delta.FPS, previous.fps, current.fps},
+		{&delta.DroppedFrames, previous.dropped, current.dropped},
+		{&delta.DuplicateFrames, previous.duplicate, current.duplicate},
+		{&delta.Speed, previous.speed, current.speed},
+		{&delta.OutputBitrate, previous.bitrate, current.bitrate},
+		{&delta.EncodeLag, previous.lag, current.lag},
+	} {
+		if !known || f.from != f.to {
+			value := f.to
+			*f.dst = &value
+			changed = true
+		}
+	}
+	return delta, changed
+}
+
+// roundTo rounds v to a multiple of 1/scale.
+func roundTo(v, scale float64) float64 {
+	return math.Round(v*scale) / scale
+}
+
 // GetEventTypes returns event types for SSE endpoint registration.
 func GetEventTypes() map[string]any {
 	return map[string]any{
@@ -2,6 +2,7 @@ package exporters
 
 import (
 	"context"
+	"slices"
 	"sync"
 	"testing"
 	"time"
@@ -75,16 +76,16 @@ func TestSSEExporterPublishesMetrics(t *testing.T) {
 	var found bool
 	for _, ev := range evts {
 		if sme, ok := ev.(events.StreamMetricsEvent); ok {
-			if sme.StreamID == streamID {
+			if delta, ok := sme.Streams[streamID]; ok {
 				found = true
-				if sme.FPS != "30.00" {
-					t.Errorf("FPS = %q, want \"30.00\"", sme.FPS)
+				if delta.FPS == nil || *delta.FPS != 30 {
+					t.Errorf("FPS = %v, want 30", delta.FPS)
 				}
-				if sme.DroppedFrames != "5" {
-					t.Errorf("DroppedFrames = %q, want \"5\"", sme.DroppedFrames)
+				if delta.DroppedFrames == nil || *delta.DroppedFrames != 5 {
+					t.Errorf("DroppedFrames = %v, want 5", delta.DroppedFrames)
 				}
-				if sme.DuplicateFrames != "2" {
-					t.Errorf("DuplicateFrames = %q, want \"2\"", sme.DuplicateFrames)
+				if delta.DuplicateFrames == nil || *delta.DuplicateFrames != 2 {
+					t.Errorf("DuplicateFrames = %v, want 2", delta.DuplicateFrames)
 				}
 				break
 			}
@@ -119,7 +120,7 @@ func TestSSEExporterNoMetrics(t *testing.T) {
 	// Verify no events were published for our test stream
 	for _, ev := range mock.getEvents() {
 		if sme, ok := ev.(events.StreamMetricsEvent); ok {
-			if sme.StreamID == testStreamID {
+			if _, ok := sme.Streams[testStreamID]; ok {
 				t.Error("expected no events for deleted stream")
 			}
 		}
@@ -184,6 +185,59 @@ func TestSSEExporterStopBeforeStart(t *testing.T) {
 	}
 }
 
+func TestSSEExporterPublishesChangesOnly(t *testing.T) {
+	streamID := "sse-delta-test"
+	metrics.SetFFmpegFPS(streamID, 30.0)
+	metrics.SetFFmpegDroppedFrames(streamID, 1)
+	defer metrics.DeleteFFmpegMetrics(streamID)
+
+	mock := newMockEventBus()
+	exporter := NewSSEExporter(mock)
+
+	deltaOf := func() (events.StreamMetricsDelta, bool) {
+		evts := mock.getEvents()
+		if len(evts) == 0 {
+			return events.StreamMetricsDelta{}, false
+		}
+		delta, ok := evts[len(evts)-1].(events.StreamMetricsEvent).Streams[streamID]
+		return delta, ok
+	}
+
+	exporter.publishMetrics()
+	if delta, ok := deltaOf(); !ok || delta.FPS == nil || delta.DroppedFrames == nil || delta.EncodeLag == nil {
+		t.Fatalf("first batch = %+v, want all fields", delta)
+	}
+
+	// Unchanged metrics aren't sent again
+	published := len(mock.getEvents())
+	exporter.publishMetrics()
+	for _, ev := range mock.getEvents()[published:] {
+		if _, ok := ev.(events.StreamMetricsEvent).Streams[streamID]; ok {
+			t.Error("unchanged stream sent again")
+		}
+	}
+
+	metrics.SetFFmpegDroppedFrames(streamID, 4)
+	exporter.publishMetrics()
+	delta, ok := deltaOf()
+	if !ok || delta.DroppedFrames == nil || *delta.DroppedFrames != 4 || delta.FPS != nil {
+		t.Errorf("delta = %+v, want only dropped frames", delta)
+	}
+
+	// The snapshot has every field of every stream
+	snapshot := exporter.Snapshot()
+	if full := snapshot.Streams[streamID]; !snapshot.Full || full.FPS == nil || *full.DroppedFrames != 4 {
+		t.Errorf("snapshot = %+v, want full metrics", snapshot)
+	}
+
+	metrics.DeleteFFmpegMetrics(streamID)
+	exporter.publishMetrics()
+	last := mock.getEvents()[len(mock.getEvents())-1].(events.StreamMetricsEvent)
+	if !slices.Contains(last.Removed, streamID) {
+		t.Errorf("removed = %v, want %s", last.Removed, streamID)
+	}
+}
+
 func TestGetEventTypes(t *testing.T) {
 	types := GetEventTypes()
 	if _, ok := types["stream-metrics"]; !ok {
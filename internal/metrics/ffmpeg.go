@@ -37,6 +37,34 @@ var (
 		Help:      "FFmpeg processing speed multiplier",
 	}, []string{"stream_id"})
 
+	ffmpegFrames = promauto.NewGaugeVec(prometheus.GaugeOpts{
+		Namespace: "videonode",
+		Subsystem: "ffmpeg",
+		Name:      "frames_total",
+		Help:      "Total frames encoded by the current FFmpeg process",
+	}, []string{"stream_id"})
+
+	ffmpegOutputBytes = promauto.NewGaugeVec(prometheus.GaugeOpts{
+		Namespace: "videonode",
+		Subsystem: "ffmpeg",
+		Name:      "output_bytes_total",
+		Help:      "Total bytes written by the current FFmpeg process",
+	}, []string{"stream_id"})
+
+	ffmpegOutputBitrate = promauto.NewGaugeVec(prometheus.GaugeOpts{
+		Namespace: "videonode",
+		Subsystem: "ffmpeg",
+		Name:      "output_bitrate_bits_per_second",
+		Help:      "FFmpeg output bitrate over the last progress interval",
+	}, []string{"stream_id"})
+
+	ffmpegEncodeLag = promauto.NewGaugeVec(prometheus.GaugeOpts{
+		Namespace: "videonode",
+		Subsystem: "ffmpeg",
+		Name:      "encode_lag_seconds",
+		Help:      "How far FFmpeg output has fallen behind real time since its best point",
+	}, []string{"stream_id"})
+
 	// Local cache for SSE exporter access.
 	ffmpegCache   = make(map[string]*FFmpegStreamMetrics)
 	ffmpegCacheMu sync.RWMutex
@@ -48,6 +76,53 @@ type FFmpegStreamMetrics struct {
 	DroppedFrames   float64
 	DuplicateFrames float64
 	Speed           float64
+	Frames          float64
+	OutputBytes     float64
+	OutputBitrate   float64 // bits/s
+	EncodeLag       float64 // seconds
+}
+
+// FFmpegProgressRecorder sets the progress metrics of one stream. Its gauges
+// are resolved once, so a progress update skips the label lookups and takes
+// the cache lock once instead of per metric.
+type FFmpegProgressRecorder struct {
+	streamID      string
+	fps           prometheus.Gauge
+	dropped       prometheus.Gauge
+	duplicate     prometheus.Gauge
+	speed         prometheus.Gauge
+	frames        prometheus.Gauge
+	outputBytes   prometheus.Gauge
+	outputBitrate prometheus.Gauge
+	encodeLag     prometheus.Gauge
+}
+
+// NewFFmpegProgressRecorder resolves the progress metrics of a stream.
+func NewFFmpegProgressRecorder(streamID string) *FFmpegProgressRecorder {
+	return &FFmpegProgressRecorder{
+		streamID:      streamID,
+		fps:           ffmpegFPS.WithLabelValues(streamID),
+		dropped:       ffmpegDroppedFrames.WithLabelValues(streamID),
+		duplicate:     ffmpegDuplicateFrames.WithLabelValues(streamID),
+		speed:         ffmpegSpeed.WithLabelValues(streamID),
+		frames:        ffmpegFrames.WithLabelValues(streamID),
+		outputBytes:   ffmpegOutputBytes.WithLabelValues(streamID),
+		outputBitrate: ffmpegOutputBitrate.WithLabelValues(streamID),
+		encodeLag:     ffmpegEncodeLag.WithLabelValues(streamID),
+	}
+}
+
+// Record sets all progress metrics of the stream.
+func (r *FFmpegProgressRecorder) Record(m *FFmpegStreamMetrics) {
+	r.fps.Set(m.FPS)
+	r.dropped.Set(m.DroppedFrames)
+	r.duplicate.Set(m.DuplicateFrames)
+	r.speed.Set(m.Speed)
+	r.frames.Set(m.Frames)
+	r.outputBytes.Set(m.OutputBytes)
+	r.outputBitrate.Set(m.OutputBitrate)
+	r.encodeLag.Set(m.EncodeLag)
+	updateCache(r.streamID, func(cached *FFmpegStreamMetrics) { *cached = *m })
 }
 
 // SetFFmpegFPS sets the current FPS for a stream.
@@ -80,6 +155,10 @@ func DeleteFFmpegMetrics(streamID string) {
 	ffmpegDroppedFrames.DeleteLabelValues(streamID)
 	ffmpegDuplicateFrames.DeleteLabelValues(streamID)
 	ffmpegSpeed.DeleteLabelValues(streamID)
+	ffmpegFrames.DeleteLabelValues(streamID)
+	ffmpegOutputBytes.DeleteLabelValues(streamID)
+	ffmpegOutputBitrate.DeleteLabelValues(streamID)
+	ffmpegEncodeLag.DeleteLabelValues(streamID)
 
 	ffmpegCacheMu.Lock()
 	delete(ffmpegCache, streamID)
@@ -110,3 +110,20 @@ func TestFFmpegMetricsConcurrency(t *testing.T) {
 
 	DeleteFFmpegMetrics(streamID)
 }
+
+func TestFFmpegProgressRecorder(t *testing.T) {
+	streamID := "test-stream-recorder"
+	DeleteFFmpegMetrics(streamID)
+	defer DeleteFFmpegMetrics(streamID)
+
+	recorder := NewFFmpegProgressRecorder(streamID)
+	recorder.Record(&FFmpegStreamMetrics{FPS: 30, Frames: 900, OutputBitrate: 4e6, EncodeLag: 0.25})
+
+	m := GetFFmpegMetrics(streamID)
+	if m == nil {
+		t.Fatal("expected metrics to be cached")
+	}
+	if m.FPS != 30 || m.Frames != 900 || m.OutputBitrate != 4e6 || m.EncodeLag != 0.25 {
+		t.Errorf("cached metrics = %+v", m)
+	}
+}
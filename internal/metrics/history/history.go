@@ -0,0 +1,265 @@
+// Package history keeps a short window of per-stream metrics in memory, so
+// the UI can draw charts without an external time-series database.
+//
+// Each stream has one fixed-size ring per downsampling tier. Rings are
+// columnar: one float32 column per series plus a column of bucket numbers,
+// so memory is allocated once per stream and recording never allocates.
+package history
+
+import (
+	"sync"
+	"time"
+)
+
+// Series identifies a metric kept in the history.
+type Series int
+
+// Series kept per stream.
+const (
+	FPS           Series = iota // encoder frames per second
+	DroppedFrames               // frames dropped per second
+	Speed                       // encoder speed, 1 is real time
+	EgressBitrate               // bits per second sent to all consumers
+	Peers                       // connected WebRTC peers
+	NACKRate                    // packets per second peers requested again
+	PLIRate                     // picture loss indications per second
+	numSeries
+)
+
+var seriesNames = [numSeries]string{
+	FPS:           "fps",
+	DroppedFrames: "dropped_frames",
+	Speed:         "speed",
+	EgressBitrate: "egress_bitrate",
+	Peers:         "peers",
+	NACKRate:      "nack_rate",
+	PLIRate:       "pli_rate",
+}
+
+// String returns the series name used in API responses.
+func (s Series) String() string {
+	if s < 0 || s >= numSeries {
+		return "unknown"
+	}
+	return seriesNames[s]
+}
+
+// Sample holds the value of every series of a stream at one point in time.
+type Sample [numSeries]float64
+
+// Tier is one downsampling level: points of Resolution each, Points of them.
+type Tier struct {
+	Resolution time.Duration
+	Points     int
+}
+
+// span returns how far back the tier reaches.
+func (t Tier) span() time.Duration {
+	return t.Resolution * time.Duration(t.Points)
+}
+
+// DefaultTiers keep 5 minutes at 1s, an hour at 10s and a day at 1 minute,
+// about 75 KB per stream.
+var DefaultTiers = []Tier{
+	{Resolution: time.Second, Points: 300},
+	{Resolution: 10 * time.Second, Points: 360},
+	{Resolution: time.Minute, Points: 1440},
+}
+
+// Range is the result of a query, with one value per series for every
+// point in Times. Buckets without samples are left out.
+type Range struct {
+	Resolution time.Duration
+	Times      []time.Time // start of each bucket
+	Values     [numSeries][]float64
+}
+
+// ring is the history of one stream at one tier. The bucket being filled is
+// averaged in sum and n, and written to its slot once the next bucket starts.
+type ring struct {
+	resolution int64   // nanoseconds per bucket
+	buckets    []int64 // bucket number held by each slot, 0 if empty
+	columns    [numSeries][]float32
+
+	current int64 // bucket being accumulated
+	sum     [numSeries]float64
+	n       int
+}
+
+func newRing(tier Tier) *ring {
+	r := &ring{
+		resolution: int64(tier.Resolution),
+		buckets:    make([]int64, tier.Points),
+	}
+	for i := range r.columns {
+		r.columns[i] = make([]float32, tier.Points)
+	}
+	return r
+}
+
+// add accumulates a sample taken at unixNano. Samples older than the bucket
+// being filled are dropped.
+func (r *ring) add(unixNano int64, sample *Sample) {
+	bucket := unixNano / r.resolution
+	if r.n > 0 {
+		if bucket < r.current {
+			return
+		}
+		if bucket != r.current {
+			r.flush()
+		}
+	}
+	r.current = bucket
+	for i, v := range sample {
+		r.sum[i] += v
+	}
+	r.n++
+}
+
+// flush stores the average of the accumulated bucket in its slot.
+func (r *ring) flush() {
+	slot := r.current % int64(len(r.buckets))
+	r.buckets[slot] = r.current
+	for i := range r.columns {
+		r.columns[i][slot] = float32(r.sum[i] / float64(r.n))
+	}
+	r.sum = [numSeries]float64{}
+	r.n = 0
+}
+
+// query appends the points from bucket from on to out, the bucket being
+// filled last.
+func (r *ring) query(from int64, out *Range) {
+	if r.n == 0 {
+		return
+	}
+
+	// Slots hold the buckets before the current one, as far back as its
+	// own slot, which is overwritten only when it is flushed
+	size := int64(len(r.buckets))
+	for bucket := max(from, r.current-size); bucket < r.current; bucket++ {
+		slot := bucket % size
+		if r.buckets[slot] != bucket || bucket == 0 {
+			continue
+		}
+		out.Times = append(out.Times, time.Unix(0, bucket*r.resolution))
+		for i := range out.Values {
+			out.Values[i] = append(out.Values[i], float64(r.columns[i][slot]))
+		}
+	}
+
+	if r.current >= from {
+		out.Times = append(out.Times, time.Unix(0, r.current*r.resolution))
+		for i := range out.Values {
+			out.Values[i] = append(out.Values[i], r.sum[i]/float64(r.n))
+		}
+	}
+}
+
+// streamHistory is the history of one stream across all tiers.
+type streamHistory struct {
+	rings []*ring
+	last  time.Time // time of the latest sample
+}
+
+// Store holds the metrics history of all streams. It is safe for concurrent
+// use.
+type Store struct {
+	tiers []Tier
+
+	mu      sync.Mutex
+	streams map[string]*streamHistory
+}
+
+// NewStore creates a store with the given tiers, finest first, or
+// DefaultTiers if none are given.
+func NewStore(tiers ...Tier) *Store {
+	if len(tiers) == 0 {
+		tiers = DefaultTiers
+	}
+	return &Store{
+		tiers:   tiers,
+		streams: make(map[string]*streamHistory),
+	}
+}
+
+// Record adds a sample of a stream taken at the given time.
+func (s *Store) Record(streamID string, at time.Time, sample Sample) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	h, ok := s.streams[streamID]
+	if !ok {
+		h = &streamHistory{rings: make([]*ring, len(s.tiers))}
+		for i, tier := range s.tiers {
+			h.rings[i] = newRing(tier)
+		}
+		s.streams[streamID] = h
+	}
+
+	unixNano := at.UnixNano()
+	for _, r := range h.rings {
+		r.add(unixNano, &sample)
+	}
+	if at.After(h.last) {
+		h.last = at
+	}
+}
+
+// Query returns the history of a stream since the given time, from the
+// finest tier that reaches back that far from the stream's latest sample in
+// at most maxPoints points (0 for no limit). The coarsest tier is used if
+// none does. An unknown stream yields an empty range.
+func (s *Store) Query(streamID string, since time.Time, maxPoints int) Range {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	h, ok := s.streams[streamID]
+	if !ok {
+		return Range{Resolution: s.tiers[0].Resolution}
+	}
+
+	tier := s.pickTier(h.last.Sub(since), maxPoints)
+	out := Range{Resolution: s.tiers[tier].Resolution}
+	r := h.rings[tier]
+	r.query(since.UnixNano()/r.resolution, &out)
+	return out
+}
+
+// pickTier returns the index of the tier to answer a query over window from.
+func (s *Store) pickTier(window time.Duration, maxPoints int) int {
+	for i, tier := range s.tiers {
+		if window > tier.span() {
+			continue
+		}
+		if maxPoints > 0 && int(window/tier.Resolution) > maxPoints {
+			continue
+		}
+		return i
+	}
+	return len(s.tiers) - 1
+}
+
+// Prune drops the streams without samples in the longest tier's window,
+// whose history has aged out entirely.
+func (s *Store) Prune(now time.Time) {
+	var longest time.Duration
+	for _, tier := range s.tiers {
+		longest = max(longest, tier.span())
+	}
+
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	for streamID, h := range s.streams {
+		if now.Sub(h.last) > longest {
+			delete(s.streams, streamID)
+		}
+	}
+}
+
+// Remove drops the history of a stream.
+func (s *Store) Remove(streamID string) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	delete(s.streams, streamID)
+}
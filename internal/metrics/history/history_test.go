@@ -0,0 +1,162 @@
+package history
+
+import (
+	"testing"
+	"time"
+)
+
+var epoch = time.Unix(1_700_000_000, 0)
+
+func sampleWith(fps float64) Sample {
+	var s Sample
+	s[FPS] = fps
+	return s
+}
+
+func TestStoreQueryPicksTier(t *testing.T) {
+	store := NewStore(
+		Tier{Resolution: time.Second, Points: 10},
+		Tier{Resolution: 5 * time.Second, Points: 10},
+	)
+	for i := range 40 {
+		store.Record("cam", epoch.Add(time.Duration(i)*time.Second), sampleWith(float64(i)))
+	}
+	last := epoch.Add(39 * time.Second)
+
+	tests := []struct {
+		name           string
+		since          time.Time
+		maxPoints      int
+		wantResolution time.Duration
+		wantPoints     int
+	}{
+		{"fine window", last.Add(-5 * time.Second), 0, time.Second, 6},
+		{"beyond fine span", last.Add(-20 * time.Second), 0, 5 * time.Second, 5},
+		{"too many fine points", last.Add(-8 * time.Second), 4, 5 * time.Second, 2},
+		{"beyond all spans", epoch.Add(-time.Hour), 0, 5 * time.Second, 8},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			got := store.Query("cam", tt.since, tt.maxPoints)
+			if got.Resolution != tt.wantResolution {
+				t.Errorf("Resolution = %v, want %v", got.Resolution, tt.wantResolution)
+			}
+			if len(got.Times) != tt.wantPoints {
+				t.Errorf("points = %d, want %d", len(got.Times), tt.wantPoints)
+			}
+			for i := range got.Values {
+				if len(got.Values[i]) != len(got.Times) {
+					t.Errorf("series %v has %d values for %d times", Series(i), len(got.Values[i]), len(got.Times))
+				}
+			}
+		})
+	}
+}
+
+func TestStoreDownsamplesByAverage(t *testing.T) {
+	store := NewStore(Tier{Resolution: 10 * time.Second, Points: 6})
+	for i := range 25 {
+		store.Record("cam", epoch.Add(time.Duration(i)*time.Second), sampleWith(float64(i)))
+	}
+
+	got := store.Query("cam", epoch, 0)
+	want := []float64{4.5, 14.5, 22} // the last bucket is still filling
+	if len(got.Values[FPS]) != len(want) {
+		t.Fatalf("points = %v, want %v", got.Values[FPS], want)
+	}
+	for i, w := range want {
+		if got.Values[FPS][i] != w {
+			t.Errorf("point %d = %v, want %v", i, got.Values[FPS][i], w)
+		}
+		if wantTime := epoch.Add(time.Duration(i) * 10 * time.Second); !got.Times[i].Equal(wantTime) {
+			t.Errorf("time %d = %v, want %v", i, got.Times[i], wantTime)
+		}
+	}
+}
+
+func TestStoreRingWrapsAndSkipsGaps(t *testing.T) {
+	store := NewStore(Tier{Resolution: time.Second, Points: 4})
+	for _, sec := range []int{0, 1, 2, 3, 4, 5, 7} {
+		store.Record("cam", epoch.Add(time.Duration(sec)*time.Second), sampleWith(float64(sec)))
+	}
+
+	got := store.Query("cam", epoch, 0)
+	want := []float64{3, 4, 5, 7} // 0 to 2 were overwritten, 6 never came
+	if len(got.Values[FPS]) != len(want) {
+		t.Fatalf("values = %v, want %v", got.Values[FPS], want)
+	}
+	for i, w := range want {
+		if got.Values[FPS][i] != w {
+			t.Errorf("value %d = %v, want %v", i, got.Values[FPS][i], w)
+		}
+	}
+}
+
+func TestStoreUnknownAndPruned(t *testing.T) {
+	store := NewStore(Tier{Resolution: time.Second, Points: 5})
+	store.Record("cam", epoch, sampleWith(30))
+
+	if got := store.Query("other", epoch, 0); len(got.Times) != 0 {
+		t.Errorf("unknown stream has %d points", len(got.Times))
+	}
+
+	store.Prune(epoch.Add(5 * time.Second))
+	if got := store.Query("cam", epoch, 0); len(got.Times) != 1 {
+		t.Errorf("points after prune within span = %d, want 1", len(got.Times))
+	}
+	store.Prune(epoch.Add(6 * time.Second))
+	if got := store.Query("cam", epoch, 0); len(got.Times) != 0 {
+		t.Errorf("points after history aged out = %d, want 0", len(got.Times))
+	}
+}
+
+func TestSamplerRates(t *testing.T) {
+	readings := map[string]Reading{}
+	store := NewStore(Tier{Resolution: time.Second, Points: 10})
+	sampler := NewSampler(store, func() map[string]Reading { return readings })
+
+	steps := []struct {
+		reading Reading
+		want    Sample
+	}{
+		{
+			reading: Reading{FPS: 30, DroppedFrames: 10, BytesSent: 1000, Peers: 2},
+			want:    Sample{FPS: 30, Peers: 2}, // no rates without a previous reading
+		},
+		{
+			reading: Reading{FPS: 29, DroppedFrames: 12, BytesSent: 126000, NACKs: 3, PLIs: 1, Peers: 2},
+			want:    Sample{FPS: 29, DroppedFrames: 2, EgressBitrate: 1_000_000, Peers: 2, NACKRate: 3, PLIRate: 1},
+		},
+		{
+			reading: Reading{FPS: 30, DroppedFrames: 1, BytesSent: 126000, NACKs: 3, PLIs: 1, Peers: 1},
+			want:    Sample{FPS: 30, DroppedFrames: 1, Peers: 1}, // encoder restarted
+		},
+	}
+	for i, step := range steps {
+		now := epoch.Add(time.Duration(i) * time.Second)
+		readings["cam"] = step.reading
+		sampler.sample(now)
+
+		got := store.Query("cam", now, 0)
+		if len(got.Times) != 1 {
+			t.Fatalf("step %d: points = %d, want 1", i, len(got.Times))
+		}
+		for s := range numSeries {
+			if got.Values[s][0] != step.want[s] {
+				t.Errorf("step %d: %v = %v, want %v", i, s, got.Values[s][0], step.want[s])
+			}
+		}
+	}
+}
+
+func BenchmarkStoreRecord(b *testing.B) {
+	store := NewStore()
+	sample := sampleWith(30)
+	at := epoch
+
+	b.ReportAllocs()
+	for b.Loop() {
+		at = at.Add(time.Second)
+		store.Record("cam", at, sample)
+	}
+}
@@ -0,0 +1,120 @@
+package history
+
+import (
+	"context"
+	"sync"
+	"time"
+)
+
+// Reading is what a Source reports for one stream. Counters are cumulative,
+// the sampler turns them into per-second rates.
+type Reading struct {
+	FPS           float64
+	Speed         float64
+	DroppedFrames float64 // total since the encoder started
+	BytesSent     uint64  // total sent to all consumers
+	NACKs         uint64  // total packets peers requested again
+	PLIs          uint64  // total picture loss indications
+	Peers         int
+}
+
+// Source returns the current readings of all streams.
+type Source func() map[string]Reading
+
+// Sampler records the readings of a Source into a Store once per interval.
+type Sampler struct {
+	store    *Store
+	source   Source
+	interval time.Duration
+	ctx      context.Context
+	cancel   context.CancelFunc
+	wg       sync.WaitGroup
+
+	previous map[string]timedReading // Only touched by run()
+}
+
+// timedReading is the last reading of a stream, the base for its rates.
+type timedReading struct {
+	Reading
+	at time.Time
+}
+
+// NewSampler creates a sampler that reads source every second.
+func NewSampler(store *Store, source Source) *Sampler {
+	return &Sampler{
+		store:    store,
+		source:   source,
+		interval: 1 * time.Second,
+		previous: make(map[string]timedReading),
+	}
+}
+
+// Start begins sampling.
+func (s *Sampler) Start(ctx context.Context) {
+	s.ctx, s.cancel = context.WithCancel(ctx)
+	s.wg.Add(1)
+	go s.run()
+}
+
+// Stop stops sampling and waits for the goroutine to finish.
+func (s *Sampler) Stop() {
+	if s.cancel != nil {
+		s.cancel()
+	}
+	s.wg.Wait()
+}
+
+func (s *Sampler) run() {
+	defer s.wg.Done()
+	ticker := time.NewTicker(s.interval)
+	defer ticker.Stop()
+
+	for {
+		select {
+		case <-s.ctx.Done():
+			return
+		case now := <-ticker.C:
+			s.sample(now)
+		}
+	}
+}
+
+// sample records one reading of every stream taken at now.
+func (s *Sampler) sample(now time.Time) {
+	readings := s.source()
+	for streamID, current := range readings {
+		sample := Sample{
+			FPS:   current.FPS,
+			Speed: current.Speed,
+			Peers: float64(current.Peers),
+		}
+		if previous, ok := s.previous[streamID]; ok {
+			if elapsed := now.Sub(previous.at).Seconds(); elapsed > 0 {
+				sample[DroppedFrames] = rate(current.DroppedFrames, previous.DroppedFrames, elapsed)
+				sample[EgressBitrate] = 8 * rate(float64(current.BytesSent), float64(previous.BytesSent), elapsed)
+				sample[NACKRate] = rate(float64(current.NACKs), float64(previous.NACKs), elapsed)
+				sample[PLIRate] = rate(float64(current.PLIs), float64(previous.PLIs), elapsed)
+			}
+		}
+		s.previous[streamID] = timedReading{Reading: current, at: now}
+		s.store.Record(streamID, now, sample)
+	}
+
+	for streamID := range s.previous {
+		if _, ok := readings[streamID]; !ok {
+			delete(s.previous, streamID)
+		}
+	}
+	s.store.Prune(now)
+}
+
+// rate returns the per-second rate of a counter over elapsed seconds. A
+// counter that went down was reset, by an encoder restart, and counted up
+// from zero since.
+func rate(current, previous, elapsed float64) float64 {
+	delta := current - previous
+	if delta < 0 {
+		delta = current
+	}
+	return delta / elapsed
+}
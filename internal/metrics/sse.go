@@ -0,0 +1,23 @@
+package metrics
+
+import (
+	"github.com/prometheus/client_golang/prometheus"
+	"github.com/prometheus/client_golang/prometheus/promauto"
+)
+
+var sseDroppedEvents = promauto.NewCounterVec(prometheus.CounterOpts{
+	Namespace: "videonode",
+	Subsystem: "sse",
+	Name:      "dropped_events_total",
+	Help:      "Events dropped for SSE clients that fell behind",
+}, []string{"endpoint"})
+
+// IncrementSSEDroppedEvents counts an event dropped for a slow SSE client.
+func IncrementSSEDroppedEvents(endpoint string) {
+	sseDroppedEvents.WithLabelValues(endpoint).Inc()
+}
+
+// AddSSEDroppedEvents counts n events dropped for a slow SSE client.
+func AddSSEDroppedEvents(endpoint string, n uint64) {
+	sseDroppedEvents.WithLabelValues(endpoint).Add(float64(n))
+}
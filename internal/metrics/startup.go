@@ -0,0 +1,35 @@
+package metrics
+
+import (
+	"github.com/prometheus/client_golang/prometheus"
+	"github.com/prometheus/client_golang/prometheus/promauto"
+)
+
+var (
+	streamTimeToFirstPacket = promauto.NewGaugeVec(prometheus.GaugeOpts{
+		Namespace: "videonode",
+		Subsystem: "stream",
+		Name:      "time_to_first_packet_seconds",
+		Help:      "Time from the latest FFmpeg launch of a stream to its first producer packet",
+	}, []string{"stream_id"})
+
+	streamStartupDuration = promauto.NewHistogram(prometheus.HistogramOpts{
+		Namespace: "videonode",
+		Subsystem: "stream",
+		Name:      "startup_duration_seconds",
+		Help:      "Distribution of stream time to first producer packet",
+		Buckets:   []float64{0.25, 0.5, 1, 2, 3, 5, 8, 13, 20, 30},
+	})
+)
+
+// ObserveStreamStartup records how long a stream took from FFmpeg launch to
+// its first producer packet.
+func ObserveStreamStartup(streamID string, seconds float64) {
+	streamTimeToFirstPacket.WithLabelValues(streamID).Set(seconds)
+	streamStartupDuration.Observe(seconds)
+}
+
+// DeleteStreamStartup removes the startup metrics of a stream.
+func DeleteStreamStartup(streamID string) {
+	streamTimeToFirstPacket.DeleteLabelValues(streamID)
+}
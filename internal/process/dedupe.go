@@ -0,0 +1,188 @@
+package process
+
+import (
+	"time"
+)
+
+const (
+	// dedupeWindow is how long repeats of a logged output line are folded
+	// into a count instead of being logged again.
+	dedupeWindow = 5 * time.Second
+
+	// dedupeSlots is how many distinct recent lines are tracked, enough for
+	// FFmpeg alternating between a handful of warnings.
+	dedupeSlots = 8
+
+	// maxLinesPerSecond caps how many output lines of one process reach the
+	// logger per second. The rest are counted and reported once.
+	maxLinesPerSecond = 50
+)
+
+// outputLine is a line of process output ready to be logged. When count is
+// set, countKey names what it counts ("repeated" or "dropped").
+type outputLine struct {
+	level    string
+	msg      string
+	countKey string
+	count    int
+}
+
+// dedupeSlot tracks one recently logged line.
+type dedupeSlot struct {
+	key       string
+	level     string
+	msg       string
+	windowEnd time.Time
+	repeated  int
+}
+
+// lineDeduper folds repeated process output lines into "repeated N" counts
+// and rate-limits the rest.
+//
+// Lines are compared with digits and hex numbers masked, so FFmpeg warnings
+// that differ only in timestamps or addresses ("Past duration 0.999 too large",
+// "non-monotonic DTS ... 1234 >= 1200") count as repeats. A suppressed line
+// costs a key build and a scan of a few slots, it is never parsed or logged.
+// Not safe for concurrent use, each output stream gets its own.
+type lineDeduper struct {
+	parser LogParser
+	slots  []dedupeSlot
+	key    []byte
+
+	second  time.Time
+	logged  int
+	dropped int
+}
+
+// newLineDeduper creates a deduper that parses lines with parser (nil logs
+// everything at info level).
+func newLineDeduper(parser LogParser) *lineDeduper {
+	return &lineDeduper{
+		parser: parser,
+		slots:  make([]dedupeSlot, 0, dedupeSlots),
+	}
+}
+
+// add processes one output line seen at now and appends the lines to log to
+// out. raw is only read during the call.
+func (d *lineDeduper) add(raw []byte, now time.Time, out []outputLine) []outputLine {
+	d.key = appendDedupeKey(d.key[:0], raw)
+	out = d.expire(now, out)
+
+	for i := range d.slots {
+		if d.slots[i].key == string(d.key) {
+			d.slots[i].repeated++
+			return out
+		}
+	}
+
+	level, msg := "info", string(raw)
+	if d.parser != nil {
+		level, msg = d.parser(msg)
+	}
+
+	out = d.rollSecond(now, out)
+	if d.logged >= maxLinesPerSecond {
+		d.dropped++
+		return out
+	}
+	d.logged++
+	out = append(out, outputLine{level: level, msg: msg})
+
+	if len(d.slots) == dedupeSlots {
+		// Evict the slot closest to expiring
+		oldest := 0
+		for i := range d.slots {
+			if d.slots[i].windowEnd.Before(d.slots[oldest].windowEnd) {
+				oldest = i
+			}
+		}
+		out = d.slots[oldest].summary(out)
+		d.slots = append(d.slots[:oldest], d.slots[oldest+1:]...)
+	}
+	d.slots = append(d.slots, dedupeSlot{
+		key:       string(d.key),
+		level:     level,
+		msg:       msg,
+		windowEnd: now.Add(dedupeWindow),
+	})
+
+	return out
+}
+
+// flush appends summaries for everything still pending, used when the output
+// stream ends.
+func (d *lineDeduper) flush(out []outputLine) []outputLine {
+	for i := range d.slots {
+		out = d.slots[i].summary(out)
+	}
+	d.slots = d.slots[:0]
+	if d.dropped > 0 {
+		out = append(out, d.droppedLine())
+		d.dropped = 0
+	}
+	return out
+}
+
+// expire closes the windows that ended by now, appending their summaries.
+func (d *lineDeduper) expire(now time.Time, out []outputLine) []outputLine {
+	kept := d.slots[:0]
+	for _, s := range d.slots {
+		if now.Before(s.windowEnd) {
+			kept = append(kept, s)
+			continue
+		}
+		out = s.summary(out)
+	}
+	clear(d.slots[len(kept):])
+	d.slots = kept
+	return out
+}
+
+// rollSecond starts a new rate-limit second if the current one is over,
+// reporting the lines dropped in it.
+func (d *lineDeduper) rollSecond(now time.Time, out []outputLine) []outputLine {
+	if now.Sub(d.second) < time.Second {
+		return out
+	}
+	if d.dropped > 0 {
+		out = append(out, d.droppedLine())
+	}
+	d.second = now
+	d.logged = 0
+	d.dropped = 0
+	return out
+}
+
+func (d *lineDeduper) droppedLine() outputLine {
+	return outputLine{level: "warning", msg: "Output rate limited", countKey: "dropped", count: d.dropped}
+}
+
+// summary appends the slot's repeat count, if any, to out.
+func (s *dedupeSlot) summary(out []outputLine) []outputLine {
+	if s.repeated == 0 {
+		return out
+	}
+	return append(out, outputLine{level: s.level, msg: s.msg, countKey: "repeated", count: s.repeated})
+}
+
+// appendDedupeKey appends line to dst with every run of digits, together with
+// any hex digits and "x" directly following it, replaced by '#'.
+func appendDedupeKey(dst, line []byte) []byte {
+	for i := 0; i < len(line); i++ {
+		c := line[i]
+		if c < '0' || c > '9' {
+			dst = append(dst, c)
+			continue
+		}
+		for i+1 < len(line) && isNumberByte(line[i+1]) {
+			i++
+		}
+		dst = append(dst, '#')
+	}
+	return dst
+}
+
+func isNumberByte(c byte) bool {
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F') || c == 'x'
+}
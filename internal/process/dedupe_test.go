@@ -0,0 +1,103 @@
+package process
+
+import (
+	"testing"
+	"time"
+)
+
+func TestAppendDedupeKey(t *testing.T) {
+	tests := []struct {
+		name string
+		a, b string
+		same bool
+	}{
+		{"past duration", "Past duration 0.999992 too large", "Past duration 0.611000 too large", true},
+		{"address", "[h264 @ 0x5581c0a3b2c0] non-monotonic DTS", "[h264 @ 0x7f00aa001200] non-monotonic DTS", true},
+		{"different text", "Past duration 0.9 too large", "Past duration 0.9 too small", false},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			a := string(appendDedupeKey(nil, []byte(tt.a)))
+			b := string(appendDedupeKey(nil, []byte(tt.b)))
+			if (a == b) != tt.same {
+				t.Errorf("keys %q and %q: same = %v, want %v", a, b, a == b, tt.same)
+			}
+		})
+	}
+}
+
+func TestLineDeduper_FoldsRepeats(t *testing.T) {
+	d := newLineDeduper(nil)
+	now := time.Unix(1000, 0)
+
+	var logged []outputLine
+	for i := range 500 {
+		logged = d.add([]byte("Past duration 0.99"+string(rune('0'+i%10))+" too large"), now, logged)
+	}
+	if len(logged) != 1 {
+		t.Fatalf("logged %d lines within the window, want 1", len(logged))
+	}
+
+	// The next line after the window reports the repeats
+	logged = d.add([]byte("other"), now.Add(dedupeWindow), logged[:0])
+	if len(logged) != 2 {
+		t.Fatalf("logged %d lines after the window, want summary and new line", len(logged))
+	}
+	if got := logged[0]; got.countKey != "repeated" || got.count != 499 {
+		t.Errorf("summary = %+v, want repeated=499", got)
+	}
+	if logged[1].msg != "other" {
+		t.Errorf("second line = %q, want %q", logged[1].msg, "other")
+	}
+}
+
+func TestLineDeduper_FlushReportsPending(t *testing.T) {
+	d := newLineDeduper(nil)
+	now := time.Unix(1000, 0)
+
+	d.add([]byte("spam 1"), now, nil)
+	d.add([]byte("spam 2"), now, nil)
+	d.add([]byte("spam 3"), now, nil)
+
+	out := d.flush(nil)
+	if len(out) != 1 || out[0].count != 2 {
+		t.Errorf("flush = %+v, want one line with repeated=2", out)
+	}
+}
+
+func TestLineDeduper_RateLimit(t *testing.T) {
+	d := newLineDeduper(nil)
+	now := time.Unix(1000, 0)
+
+	var logged int
+	for i := range maxLinesPerSecond + 20 {
+		// Distinct text so nothing dedupes
+		line := []byte("line " + string(rune('a'+i%26)) + string(rune('a'+i/26)))
+		logged += len(d.add(line, now, nil))
+	}
+	if logged != maxLinesPerSecond {
+		t.Errorf("logged %d lines in one second, want %d", logged, maxLinesPerSecond)
+	}
+
+	out := d.add([]byte("later"), now.Add(time.Second), nil)
+	var dropped int
+	for _, l := range out {
+		if l.countKey == "dropped" {
+			dropped = l.count
+		}
+	}
+	if dropped != 20 {
+		t.Errorf("dropped = %d, want 20", dropped)
+	}
+}
+
+func TestLineDeduper_UsesParser(t *testing.T) {
+	d := newLineDeduper(func(line string) (string, string) {
+		return "warning", "parsed: " + line
+	})
+
+	out := d.add([]byte("x"), time.Unix(1000, 0), nil)
+	if len(out) != 1 || out[0].level != "warning" || out[0].msg != "parsed: x" {
+		t.Errorf("add = %+v, want parsed warning", out)
+	}
+}
@@ -328,6 +328,8 @@ func (p *Process) waitForExit(processDone <-chan error, timeout time.Duration) i
 // streamOutput streams output from the subprocess.
 // Uses the configured processLogger (or falls back to default logger).
 // Uses the configured LogParser to extract log levels from process output.
+// Repeated lines are folded into a "repeated" count and the rate of logged
+// lines is capped, so a process flooding its output can't flood the logs.
 func (p *Process) streamOutput(reader io.Reader, source string) {
 	scanner := bufio.NewScanner(reader)
 
@@ -337,29 +339,24 @@ func (p *Process) streamOutput(reader io.Reader, source string) {
 		logger = p.logger
 	}
 
+	dedupe := newLineDeduper(p.logParser)
+	var lines []outputLine
+
 	for scanner.Scan() {
-		line := scanner.Text()
+		raw := scanner.Bytes()
 
 		if p.outputHandler != nil {
-			p.outputHandler.HandleLine(source, line)
+			p.outputHandler.HandleLine(source, string(raw))
 		}
 
-		// Use configured parser or default to info level
-		level, msg := "info", line
-		if p.logParser != nil {
-			level, msg = p.logParser(line)
+		lines = dedupe.add(raw, time.Now(), lines[:0])
+		for _, line := range lines {
+			logOutputLine(logger, line)
 		}
+	}
 
-		switch level {
-		case "fatal", "error":
-			logger.Error(msg)
-		case "warning":
-			logger.Warn(msg)
-		case "debug", "trace":
-			logger.Debug(msg)
-		default:
-			logger.Info(msg)
-		}
+	for _, line := range dedupe.flush(lines[:0]) {
+		logOutputLine(logger, line)
 	}
 
 	if err := scanner.Err(); err != nil {
@@ -367,6 +364,25 @@ func (p *Process) streamOutput(reader io.Reader, source string) {
 	}
 }
 
+// logOutputLine logs a line of process output at its parsed level.
+func logOutputLine(logger logging.Logger, line outputLine) {
+	var args []any
+	if line.count > 0 {
+		args = []any{line.countKey, line.count}
+	}
+
+	switch line.level {
+	case "fatal", "error":
+		logger.Error(line.msg, args...)
+	case "warning":
+		logger.Warn(line.msg, args...)
+	case "debug", "trace":
+		logger.Debug(line.msg, args...)
+	default:
+		logger.Info(line.msg, args...)
+	}
+}
+
 // parseCommand parses a command string into arguments
 // Handles quoted strings and basic escaping.
 func parseCommand(command string) ([]string, error) {
@@ -3,7 +3,9 @@ package streaming
 
 import (
 	"context"
+	"errors"
 	"net/http"
+	"time"
 
 	"github.com/danielgtaylor/huma/v2"
 )
@@ -20,10 +22,101 @@ type WebRTCAnswerOutput struct {
 	Body        []byte
 }
 
+// WHEPOfferInput is the request body for creating a WHEP session.
+type WHEPOfferInput struct {
+	StreamID string `path:"stream" doc:"Stream ID to play"`
+	RawBody  []byte `contentType:"application/sdp" doc:"SDP offer"`
+}
+
+// WHEPAnswerOutput is the response for a created WHEP session.
+type WHEPAnswerOutput struct {
+	ContentType string `header:"Content-Type"`
+	Location    string `header:"Location" doc:"WHEP session URL"`
+	AcceptPatch string `header:"Accept-Patch"`
+	Body        []byte
+}
+
+// WHEPCandidateInput is the request body for trickling ICE candidates.
+type WHEPCandidateInput struct {
+	StreamID  string `path:"stream" doc:"Stream ID"`
+	SessionID string `path:"session" doc:"WHEP session ID"`
+	RawBody   []byte `contentType:"application/trickle-ice-sdpfrag" doc:"ICE candidates (RFC 8840)"`
+}
+
+// WHEPSessionInput identifies a WHEP session.
+type WHEPSessionInput struct {
+	StreamID  string `path:"stream" doc:"Stream ID"`
+	SessionID string `path:"session" doc:"WHEP session ID"`
+}
+
+// BundleOfferInput is the request body for creating a bundled session.
+type BundleOfferInput struct {
+	Streams string `query:"streams" required:"true" doc:"Comma-separated stream IDs, one per m-line of each kind; empty entries leave a slot unused"`
+	RawBody []byte `contentType:"application/sdp" doc:"SDP offer from browser"`
+}
+
+// BundleAnswerOutput is the response for a created bundled session.
+type BundleAnswerOutput struct {
+	ContentType string `header:"Content-Type"`
+	Location    string `header:"Location" doc:"Bundle session URL"`
+	Body        []byte
+}
+
+// BundleRenegotiateInput is the request body for renegotiating a bundle.
+type BundleRenegotiateInput struct {
+	SessionID string `path:"session" doc:"Bundle session ID"`
+	Streams   string `query:"streams" required:"true" doc:"Comma-separated stream IDs, one per m-line of each kind; empty entries leave a slot unused"`
+	RawBody   []byte `contentType:"application/sdp" doc:"SDP offer from browser"`
+}
+
+// BundleSessionInput identifies a bundled session.
+type BundleSessionInput struct {
+	SessionID string `path:"session" doc:"Bundle session ID"`
+}
+
+// LatencyReportInput is a batch of frame timings reported by a browser.
+type LatencyReportInput struct {
+	Body struct {
+		SessionID string                `json:"session_id" doc:"WebRTC session ID (the ice-ufrag of the answer)"`
+		StreamID  string                `json:"stream_id,omitempty" doc:"Stream of a bundle session; ignored for single-stream sessions"`
+		Samples   []LatencySampleReport `json:"samples" doc:"Displayed frames since the previous report"`
+	}
+}
+
+// LatencySampleReport is a displayed frame, with times in Unix milliseconds
+// on the server's clock.
+type LatencySampleReport struct {
+	RTPTimestamp uint32  `json:"rtp_timestamp" doc:"RTP timestamp of the frame"`
+	ReceivedAt   float64 `json:"received_at" doc:"When the last packet of the frame was received"`
+	DisplayedAt  float64 `json:"displayed_at" doc:"When the frame was presented"`
+	DecodeMs     float64 `json:"decode_ms,omitempty" doc:"Time spent decoding the frame"`
+}
+
+// LatencyReportOutput is the response to a latency report.
+type LatencyReportOutput struct {
+	Body struct {
+		ServerTime float64 `json:"server_time" doc:"Server wallclock in Unix milliseconds, for estimating the browser's clock offset"`
+	}
+}
+
+// unixMillisTime converts Unix milliseconds to time.
+func unixMillisTime(ms float64) time.Time {
+	return time.UnixMicro(int64(ms * 1000))
+}
+
+// LiveStreamOrigin is where a live stream originates.
+type LiveStreamOrigin struct {
+	StreamID string   `json:"stream_id" example:"stream-001" doc:"Stream identifier"`
+	Origin   string   `json:"origin" enum:"local,relay,slate" example:"local" doc:"Where the stream originates: local FFmpeg, relayed from an upstream node, or a no-signal slate"`
+	Upstream string   `json:"upstream,omitempty" example:"rtsp://capture:8554/stream-001" doc:"Upstream URL of relayed streams"`
+	Codecs   []string `json:"codecs" example:"H264,OPUS" doc:"Codecs of the producer's tracks"`
+}
+
 // StreamListOutput is the response for listing active streams.
 type StreamListOutput struct {
 	Body struct {
-		Streams []string `json:"streams" doc:"List of active stream IDs"`
+		Streams []string           `json:"streams" doc:"List of active stream IDs"`
+		Origins []LiveStreamOrigin `json:"origins" doc:"Where each active stream originates, in the order of streams"`
 	}
 }
 
@@ -48,22 +141,184 @@ func RegisterWebRTCAPI(api huma.API, webrtcManager *WebRTCManager) {
 		}, nil
 	})
 
+	// POST /api/whep/<stream> - WHEP playback (RFC 9725 style)
+	huma.Register(api, huma.Operation{
+		OperationID:   "whep-offer",
+		Method:        http.MethodPost,
+		Path:          "/api/whep/{stream}",
+		Summary:       "WHEP playback",
+		Description:   "Create a WHEP session. The answer returns without waiting for full ICE gathering; trickle candidates with PATCH",
+		Tags:          []string{"streaming"},
+		DefaultStatus: http.StatusCreated,
+	}, func(_ context.Context, input *WHEPOfferInput) (*WHEPAnswerOutput, error) {
+		sessionID, answer, err := webrtcManager.CreateSession(input.StreamID, string(input.RawBody))
+		if errors.Is(err, ErrStreamNotFound) {
+			return nil, huma.Error404NotFound("stream not found", err)
+		}
+		if err != nil {
+			return nil, huma.Error400BadRequest("invalid offer", err)
+		}
+		return &WHEPAnswerOutput{
+			ContentType: "application/sdp",
+			Location:    "/api/whep/" + input.StreamID + "/" + sessionID,
+			AcceptPatch: "application/trickle-ice-sdpfrag",
+			Body:        []byte(answer),
+		}, nil
+	})
+
+	// PATCH /api/whep/<stream>/<session> - Trickle ICE candidates
+	huma.Register(api, huma.Operation{
+		OperationID:   "whep-candidates",
+		Method:        http.MethodPatch,
+		Path:          "/api/whep/{stream}/{session}",
+		Summary:       "WHEP trickle ICE",
+		Description:   "Add client ICE candidates to a WHEP session",
+		Tags:          []string{"streaming"},
+		DefaultStatus: http.StatusNoContent,
+	}, func(_ context.Context, input *WHEPCandidateInput) (*struct{}, error) {
+		err := webrtcManager.AddRemoteCandidates(input.StreamID, input.SessionID, string(input.RawBody))
+		if errors.Is(err, ErrSessionNotFound) {
+			return nil, huma.Error404NotFound("session not found", err)
+		}
+		if err != nil {
+			return nil, huma.Error400BadRequest("invalid candidate", err)
+		}
+		return &struct{}{}, nil
+	})
+
+	// DELETE /api/whep/<stream>/<session> - End WHEP session
+	huma.Register(api, huma.Operation{
+		OperationID:   "whep-delete",
+		Method:        http.MethodDelete,
+		Path:          "/api/whep/{stream}/{session}",
+		Summary:       "End WHEP session",
+		Description:   "Close a WHEP session",
+		Tags:          []string{"streaming"},
+		DefaultStatus: http.StatusOK,
+	}, func(_ context.Context, input *WHEPSessionInput) (*struct{}, error) {
+		if err := webrtcManager.CloseSession(input.StreamID, input.SessionID); err != nil {
+			return nil, huma.Error404NotFound("session not found", err)
+		}
+		return &struct{}{}, nil
+	})
+
+	// POST /api/webrtc/bundle?streams=<a,b,c> - Several streams on one connection
+	huma.Register(api, huma.Operation{
+		OperationID:   "webrtc-bundle-offer",
+		Method:        http.MethodPost,
+		Path:          "/api/webrtc/bundle",
+		Summary:       "WebRTC bundle",
+		Description:   "Play several streams over one PeerConnection. The k-th video (and audio) m-line of the offer plays the k-th listed stream",
+		Tags:          []string{"streaming"},
+		DefaultStatus: http.StatusCreated,
+	}, func(_ context.Context, input *BundleOfferInput) (*BundleAnswerOutput, error) {
+		sessionID, answer, err := webrtcManager.CreateBundle(ParseBundleStreams(input.Streams), string(input.RawBody))
+		if errors.Is(err, ErrStreamNotFound) {
+			return nil, huma.Error404NotFound("no stream found", err)
+		}
+		if err != nil {
+			return nil, huma.Error400BadRequest("invalid offer", err)
+		}
+		return &BundleAnswerOutput{
+			ContentType: "application/sdp",
+			Location:    "/api/webrtc/bundle/" + sessionID,
+			Body:        []byte(answer),
+		}, nil
+	})
+
+	// PUT /api/webrtc/bundle/<session>?streams=<a,b,c> - Renegotiate a bundle
+	huma.Register(api, huma.Operation{
+		OperationID: "webrtc-bundle-renegotiate",
+		Method:      http.MethodPut,
+		Path:        "/api/webrtc/bundle/{session}",
+		Summary:     "Renegotiate WebRTC bundle",
+		Description: "Apply a new offer to a bundle, adding, removing or replacing its streams",
+		Tags:        []string{"streaming"},
+	}, func(_ context.Context, input *BundleRenegotiateInput) (*WebRTCAnswerOutput, error) {
+		answer, err := webrtcManager.RenegotiateBundle(input.SessionID, ParseBundleStreams(input.Streams), string(input.RawBody))
+		if errors.Is(err, ErrSessionNotFound) {
+			return nil, huma.Error404NotFound("session not found", err)
+		}
+		if err != nil {
+			return nil, huma.Error400BadRequest("invalid offer", err)
+		}
+		return &WebRTCAnswerOutput{
+			ContentType: "application/sdp",
+			Body:        []byte(answer),
+		}, nil
+	})
+
+	// DELETE /api/webrtc/bundle/<session> - End a bundle
+	huma.Register(api, huma.Operation{
+		OperationID:   "webrtc-bundle-delete",
+		Method:        http.MethodDelete,
+		Path:          "/api/webrtc/bundle/{session}",
+		Summary:       "End WebRTC bundle",
+		Description:   "Close a bundled session",
+		Tags:          []string{"streaming"},
+		DefaultStatus: http.StatusOK,
+	}, func(_ context.Context, input *BundleSessionInput) (*struct{}, error) {
+		if err := webrtcManager.CloseBundle(input.SessionID); err != nil {
+			return nil, huma.Error404NotFound("session not found", err)
+		}
+		return &struct{}{}, nil
+	})
+
+	// POST /api/webrtc/latency - Browser frame timings for latency tracing
+	huma.Register(api, huma.Operation{
+		OperationID: "webrtc-latency-report",
+		Method:      http.MethodPost,
+		Path:        "/api/webrtc/latency",
+		Summary:     "Report frame latency",
+		Description: "Record when a WebRTC session's browser received, decoded and displayed frames, completing the glass-to-glass latency metrics. An empty report only returns the server time",
+		Tags:        []string{"streaming"},
+	}, func(_ context.Context, input *LatencyReportInput) (*LatencyReportOutput, error) {
+		samples := make([]LatencySample, 0, len(input.Body.Samples))
+		for _, sample := range input.Body.Samples {
+			samples = append(samples, LatencySample{
+				RTPTimestamp: sample.RTPTimestamp,
+				Received:     unixMillisTime(sample.ReceivedAt),
+				Decode:       time.Duration(sample.DecodeMs * float64(time.Millisecond)),
+				Displayed:    unixMillisTime(sample.DisplayedAt),
+			})
+		}
+		err := webrtcManager.ReportLatency(input.Body.SessionID, input.Body.StreamID, samples)
+		if errors.Is(err, ErrSessionNotFound) {
+			return nil, huma.Error404NotFound("session not found", err)
+		}
+		if err != nil {
+			return nil, huma.Error409Conflict("latency tracing is disabled", err)
+		}
+		output := &LatencyReportOutput{}
+		output.Body.ServerTime = float64(time.Now().UnixMicro()) / 1000
+		return output, nil
+	})
+
 	// GET /api/streams/live - List active streams
 	huma.Register(api, huma.Operation{
 		OperationID: "list-live-streams",
 		Method:      http.MethodGet,
 		Path:        "/api/streams/live",
 		Summary:     "List live streams",
-		Description: "Returns a list of stream IDs that currently have active producers",
+		Description: "Returns the stream IDs that currently have active producers and where each originates, including streams relayed from upstream nodes",
 		Tags:        []string{"streaming"},
 	}, func(_ context.Context, _ *struct{}) (*StreamListOutput, error) {
-		streams := webrtcManager.hub.ListStreams()
-		return &StreamListOutput{
-			Body: struct {
-				Streams []string `json:"streams" doc:"List of active stream IDs"`
-			}{
-				Streams: streams,
-			},
-		}, nil
+		live := webrtcManager.hub.LiveStreams()
+		output := &StreamListOutput{}
+		output.Body.Streams = make([]string, len(live))
+		output.Body.Origins = make([]LiveStreamOrigin, len(live))
+		for i, stream := range live {
+			output.Body.Streams[i] = stream.StreamID
+			output.Body.Origins[i] = LiveStreamOrigin{
+				StreamID: stream.StreamID,
+				Origin:   stream.Origin,
+				Upstream: stream.Upstream,
+				Codecs:   stream.Codecs,
+			}
+			if output.Body.Origins[i].Codecs == nil {
+				output.Body.Origins[i].Codecs = []string{}
+			}
+		}
+		return output, nil
 	})
 }
@@ -0,0 +1,393 @@
+package streaming
+
+import (
+	"bytes"
+	"context"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"net"
+	"os/exec"
+	"strconv"
+	"sync"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+	"github.com/prometheus/client_golang/prometheus"
+	"github.com/prometheus/client_golang/prometheus/promauto"
+	"github.com/smazurov/videonode/internal/logging"
+)
+
+// Native audio capture format and defaults.
+const (
+	audioSampleRate = 48000
+	audioChannels   = 2
+
+	// DefaultAudioBitrate is the Opus bitrate of streams that don't set one,
+	// the same FFmpeg encodes stream audio at.
+	DefaultAudioBitrate = 128000
+
+	// audioFrameDuration is the Opus packet duration in milliseconds
+	audioFrameDuration = 10
+	// audioPayloadType is the dynamic payload type FFmpeg's RTP muxer gives
+	// audio
+	audioPayloadType = 97
+	// audioReadTimeout ends a capture whose device stopped delivering
+	audioReadTimeout = 500 * time.Millisecond
+)
+
+// Audio capture restart backoff. A capture that ran for audioStableAfter
+// starts over at the minimum delay.
+const (
+	audioMinBackoff  = time.Second
+	audioMaxBackoff  = 30 * time.Second
+	audioStableAfter = time.Minute
+)
+
+var (
+	audioCaptureOverruns = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "audio",
+		Name:      "capture_overruns_total",
+		Help:      "ALSA capture buffer overruns per stream, each losing some audio",
+	}, []string{"stream_id"})
+
+	audioCapturePackets = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "audio",
+		Name:      "packets_total",
+		Help:      "Opus packets published to the hub per stream",
+	}, []string{"stream_id"})
+)
+
+// errPCMTimeout is returned by pcmSource.Read when no frames arrive in time.
+var errPCMTimeout = errors.New("no audio frames")
+
+// errPCMOverrun is returned by pcmSource.Read after frames were lost.
+var errPCMOverrun = errors.New("capture overrun")
+
+// pcmSource is a running capture of interleaved S16_LE PCM at
+// audioSampleRate and audioChannels.
+type pcmSource interface {
+	// Read copies captured frames into p, waiting up to timeout. It returns
+	// errPCMTimeout or errPCMOverrun for those conditions.
+	Read(p []byte, timeout time.Duration) (int, error)
+	Close() error
+}
+
+// AudioCaptureConfig configures the native audio capture of a stream.
+type AudioCaptureConfig struct {
+	// Device is the ALSA device ("hw:X,Y")
+	Device string
+	// Bitrate is the Opus bitrate in bits per second (0 = DefaultAudioBitrate)
+	Bitrate int
+}
+
+// AudioCaptures captures stream audio from ALSA in process, in place of
+// FFmpeg, and publishes it to the hub as each stream's separate audio source
+// (see Hub.SetAudioSource). Capture reads the device's ring buffer in 5 ms
+// periods without resampling, so audio timestamps follow the device's sample
+// clock, and keeps running across FFmpeg restarts.
+//
+// Opus is encoded by a dedicated FFmpeg libopus process fed the PCM over a
+// pipe in small chunks, in low-delay mode with 10 ms packets. It sends RTP
+// back over loopback; the packets are handed to the hub as they arrive.
+type AudioCaptures struct {
+	hub      *Hub
+	logger   logging.Logger
+	mu       sync.Mutex
+	resolver func(streamID string) (AudioCaptureConfig, bool)
+	onReady  func(streamID string)
+	captures map[string]*audioCapture
+}
+
+// NewAudioCaptures creates an audio capture manager for the hub's streams.
+func NewAudioCaptures(hub *Hub, logger logging.Logger) *AudioCaptures {
+	return &AudioCaptures{
+		hub:      hub,
+		logger:   logger,
+		captures: make(map[string]*audioCapture),
+	}
+}
+
+// SetResolver sets the lookup for per-stream audio capture settings.
+// Returning false leaves the stream's audio to FFmpeg, if it has any.
+func (a *AudioCaptures) SetResolver(resolver func(streamID string) (AudioCaptureConfig, bool)) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+	a.resolver = resolver
+}
+
+// SetOnSourceReady sets the callback invoked each time a stream's capture
+// starts publishing audio to the hub, for consumers that pick their tracks
+// once (recordings).
+func (a *AudioCaptures) SetOnSourceReady(callback func(streamID string)) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+	a.onReady = callback
+}
+
+// Start begins capturing a stream's audio if its settings ask for it. A
+// capture with unchanged settings is left running; one whose settings
+// changed or went away is restarted or stopped.
+func (a *AudioCaptures) Start(streamID string) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	if a.resolver == nil {
+		return
+	}
+	config, enabled := a.resolver(streamID)
+	if config.Bitrate <= 0 {
+		config.Bitrate = DefaultAudioBitrate
+	}
+
+	existing, running := a.captures[streamID]
+	if running && enabled && existing.config == config {
+		return
+	}
+	if running {
+		delete(a.captures, streamID)
+		existing.stop()
+		a.logger.Info("Audio capture stopped", "stream_id", streamID)
+	}
+	if !enabled {
+		return
+	}
+
+	capture := newAudioCapture(a.hub, streamID, config, a.logger)
+	capture.onReady = a.onReady
+	a.captures[streamID] = capture
+	go capture.run()
+	a.logger.Info("Audio capture started", "stream_id", streamID, "device", config.Device)
+}
+
+// Stop ends a stream's audio capture.
+func (a *AudioCaptures) Stop(streamID string) {
+	a.mu.Lock()
+	capture, ok := a.captures[streamID]
+	delete(a.captures, streamID)
+	a.mu.Unlock()
+
+	if ok {
+		capture.stop()
+		a.logger.Info("Audio capture stopped", "stream_id", streamID)
+	}
+}
+
+// StopAll ends all audio captures.
+func (a *AudioCaptures) StopAll() {
+	a.mu.Lock()
+	captures := a.captures
+	a.captures = make(map[string]*audioCapture)
+	a.mu.Unlock()
+
+	for _, capture := range captures {
+		capture.stop()
+	}
+}
+
+// audioCapture captures one stream's audio, reopening the device and
+// encoder with backoff until stopped.
+type audioCapture struct {
+	hub      *Hub
+	streamID string
+	config   AudioCaptureConfig
+	logger   logging.Logger
+	onReady  func(streamID string)
+	ctx      context.Context
+	cancel   context.CancelFunc
+	done     chan struct{}
+}
+
+func newAudioCapture(hub *Hub, streamID string, config AudioCaptureConfig, logger logging.Logger) *audioCapture {
+	ctx, cancel := context.WithCancel(context.Background())
+	return &audioCapture{
+		hub:      hub,
+		streamID: streamID,
+		config:   config,
+		logger:   logger,
+		ctx:      ctx,
+		cancel:   cancel,
+		done:     make(chan struct{}),
+	}
+}
+
+func (c *audioCapture) stop() {
+	c.cancel()
+	<-c.done
+}
+
+func (c *audioCapture) run() {
+	defer close(c.done)
+
+	backoff := audioMinBackoff
+	for {
+		started := time.Now()
+		err := c.capture()
+		if c.ctx.Err() != nil {
+			return
+		}
+
+		if time.Since(started) >= audioStableAfter {
+			backoff = audioMinBackoff
+		}
+		c.logger.Warn("Audio capture failed", "stream_id", c.streamID, "device", c.config.Device, "error", err, "retry_in", backoff)
+
+		select {
+		case <-c.ctx.Done():
+			return
+		case <-time.After(backoff):
+		}
+		backoff = min(backoff*2, audioMaxBackoff)
+	}
+}
+
+// capture runs the device and the encoder until either fails or the capture
+// is stopped.
+func (c *audioCapture) capture() error {
+	pcm, err := openPCM(c.config.Device)
+	if err != nil {
+		return err
+	}
+	defer pcm.Close()
+
+	conn, err := net.ListenUDP("udp", &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1)})
+	if err != nil {
+		return fmt.Errorf("listen for encoder: %w", err)
+	}
+	defer conn.Close()
+
+	ctx, cancel := context.WithCancel(c.ctx)
+	defer cancel()
+	cmd := exec.CommandContext(ctx, "ffmpeg", opusEncoderArgs(c.config.Bitrate, conn.LocalAddr().(*net.UDPAddr).Port)...)
+	var stderr bytes.Buffer
+	cmd.Stderr = &stderr
+	stdin, err := cmd.StdinPipe()
+	if err != nil {
+		return fmt.Errorf("encoder stdin: %w", err)
+	}
+	if err := cmd.Start(); err != nil {
+		return fmt.Errorf("start encoder: %w", err)
+	}
+
+	receiver := core.NewReceiver(&core.Media{
+		Kind:      core.KindAudio,
+		Direction: core.DirectionRecvonly,
+		Codecs:    []*core.Codec{opusCodec()},
+	}, opusCodec())
+	c.hub.SetAudioSource(c.streamID, receiver)
+	defer c.hub.RemoveAudioSource(c.streamID, receiver)
+	go c.publish(conn, receiver)
+	if c.onReady != nil {
+		go c.onReady(c.streamID)
+	}
+
+	err = c.feed(pcm, stdin)
+	_ = stdin.Close()
+	cancel()
+	_ = cmd.Wait() // stderr is complete once FFmpeg is reaped
+	if errors.Is(err, errEncoderWrite) {
+		if line := lastLine(stderr.String()); line != "" {
+			return fmt.Errorf("%w: %s", err, line)
+		}
+	}
+	return err
+}
+
+// errEncoderWrite is returned by feed when the encoder stopped reading.
+var errEncoderWrite = errors.New("encoder exited")
+
+// feed copies captured PCM to the encoder as it arrives, until the capture
+// is stopped or either side fails.
+func (c *audioCapture) feed(pcm pcmSource, encoder io.Writer) error {
+	if _, err := encoder.Write(wavStreamHeader(audioSampleRate, audioChannels)); err != nil {
+		return fmt.Errorf("%w: %w", errEncoderWrite, err)
+	}
+
+	buf := make([]byte, 4096)
+	for c.ctx.Err() == nil {
+		n, err := pcm.Read(buf, audioReadTimeout)
+		if errors.Is(err, errPCMOverrun) {
+			audioCaptureOverruns.WithLabelValues(c.streamID).Inc()
+			c.logger.Debug("Audio capture overrun", "stream_id", c.streamID)
+			continue
+		}
+		if err != nil {
+			if c.ctx.Err() != nil {
+				return nil
+			}
+			return err
+		}
+		if _, err := encoder.Write(buf[:n]); err != nil {
+			return fmt.Errorf("%w: %w", errEncoderWrite, err)
+		}
+	}
+	return nil
+}
+
+// publish hands the encoder's RTP packets to the hub until conn is closed.
+// Packets are shared with every consumer, so each gets its own buffer.
+func (c *audioCapture) publish(conn *net.UDPConn, receiver *core.Receiver) {
+	packets := audioCapturePackets.WithLabelValues(c.streamID)
+	for {
+		buf := make([]byte, 1500)
+		n, err := conn.Read(buf)
+		if err != nil {
+			return
+		}
+		packet := &rtp.Packet{}
+		if err := packet.Unmarshal(buf[:n]); err != nil {
+			continue
+		}
+		packet.PayloadType = audioPayloadType
+		receiver.Input(packet)
+		packets.Inc()
+	}
+}
+
+func opusCodec() *core.Codec {
+	return &core.Codec{
+		Name:        core.CodecOpus,
+		ClockRate:   audioSampleRate,
+		Channels:    audioChannels,
+		PayloadType: audioPayloadType,
+	}
+}
+
+// opusEncoderArgs encodes a WAV stream on stdin to Opus RTP sent to port on
+// loopback. The WAV demuxer reads at most max_size bytes per packet (256
+// frames), so PCM isn't batched before encoding.
+func opusEncoderArgs(bitrate, port int) []string {
+	return []string{
+		"-hide_banner", "-loglevel", "error",
+		"-probesize", "32", "-analyzeduration", "0", "-fflags", "nobuffer",
+		"-f", "wav", "-ignore_length", "1", "-max_size", "1024",
+		"-i", "pipe:0",
+		"-c:a", "libopus", "-b:a", strconv.Itoa(bitrate),
+		"-application", "lowdelay", "-frame_duration", strconv.Itoa(audioFrameDuration),
+		"-flush_packets", "1",
+		"-f", "rtp", "rtp://127.0.0.1:" + strconv.Itoa(port) + "?pkt_size=1200",
+	}
+}
+
+// wavStreamHeader is the header of an S16_LE WAV stream of unknown length.
+func wavStreamHeader(rate, channels int) []byte {
+	const unknownSize = 0xFFFFFFFF
+	header := make([]byte, 0, 44)
+	header = append(header, "RIFF"...)
+	header = binary.LittleEndian.AppendUint32(header, unknownSize)
+	header = append(header, "WAVEfmt "...)
+	header = binary.LittleEndian.AppendUint32(header, 16)
+	header = binary.LittleEndian.AppendUint16(header, 1) // PCM
+	header = binary.LittleEndian.AppendUint16(header, uint16(channels))
+	header = binary.LittleEndian.AppendUint32(header, uint32(rate))
+	header = binary.LittleEndian.AppendUint32(header, uint32(rate*channels*2)) // byte rate
+	header = binary.LittleEndian.AppendUint16(header, uint16(channels*2))      // block align
+	header = binary.LittleEndian.AppendUint16(header, 16)                      // bits per sample
+	header = append(header, "data"...)
+	header = binary.LittleEndian.AppendUint32(header, unknownSize)
+	return header
+}
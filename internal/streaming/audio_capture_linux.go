@@ -0,0 +1,37 @@
+//go:build linux
+
+package streaming
+
+import (
+	"errors"
+	"time"
+
+	"github.com/smazurov/videonode/pkg/linuxav/alsa"
+)
+
+// alsaPCM adapts an ALSA mmap capture to pcmSource.
+type alsaPCM struct {
+	*alsa.Capture
+}
+
+func openPCM(device string) (pcmSource, error) {
+	capture, err := alsa.OpenCapture(device, alsa.CaptureConfig{
+		Rate:     audioSampleRate,
+		Channels: audioChannels,
+	})
+	if err != nil {
+		return nil, err
+	}
+	return alsaPCM{capture}, nil
+}
+
+func (p alsaPCM) Read(buf []byte, timeout time.Duration) (int, error) {
+	n, err := p.Capture.Read(buf, timeout)
+	switch {
+	case errors.Is(err, alsa.ErrOverrun):
+		return n, errPCMOverrun
+	case errors.Is(err, alsa.ErrReadTimeout):
+		return n, errPCMTimeout
+	}
+	return n, err
+}
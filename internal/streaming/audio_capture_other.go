@@ -0,0 +1,10 @@
+//go:build !linux
+
+package streaming
+
+import "errors"
+
+// Native audio capture is ALSA, which is Linux-only.
+func openPCM(_ string) (pcmSource, error) {
+	return nil, errors.New("native audio capture needs ALSA (Linux)")
+}
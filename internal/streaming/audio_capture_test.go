@@ -0,0 +1,185 @@
+package streaming
+
+import (
+	"bytes"
+	"encoding/binary"
+	"errors"
+	"io"
+	"log/slog"
+	"slices"
+	"testing"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/AlexxIT/go2rtc/pkg/rtsp"
+	"github.com/pion/rtp"
+)
+
+// fakePCM replays reads from a script, then reports a stalled device.
+type fakePCM struct {
+	reads [][]byte
+	errs  []error
+}
+
+func (p *fakePCM) Read(buf []byte, _ time.Duration) (int, error) {
+	if len(p.reads) == 0 {
+		return 0, errPCMTimeout
+	}
+	data, err := p.reads[0], p.errs[0]
+	p.reads, p.errs = p.reads[1:], p.errs[1:]
+	return copy(buf, data), err
+}
+
+func (p *fakePCM) Close() error { return nil }
+
+func TestWAVStreamHeader(t *testing.T) {
+	header := wavStreamHeader(48000, 2)
+	if len(header) != 44 {
+		t.Fatalf("header is %d bytes, want 44", len(header))
+	}
+	if string(header[0:4]) != "RIFF" || string(header[8:16]) != "WAVEfmt " || string(header[36:40]) != "data" {
+		t.Errorf("header chunks = %q", header)
+	}
+	if rate := binary.LittleEndian.Uint32(header[24:]); rate != 48000 {
+		t.Errorf("sample rate = %d, want 48000", rate)
+	}
+	if align := binary.LittleEndian.Uint16(header[32:]); align != 4 {
+		t.Errorf("block align = %d, want 4", align)
+	}
+	if size := binary.LittleEndian.Uint32(header[40:]); size != 0xFFFFFFFF {
+		t.Errorf("data size = %#x, want unknown", size)
+	}
+}
+
+func TestOpusEncoderArgs(t *testing.T) {
+	args := opusEncoderArgs(96000, 5004)
+	for _, want := range [][]string{
+		{"-max_size", "1024"},
+		{"-b:a", "96000"},
+		{"-application", "lowdelay"},
+		{"-c:a", "libopus"},
+	} {
+		i := slices.Index(args, want[0])
+		if i < 0 || i+1 >= len(args) || args[i+1] != want[1] {
+			t.Errorf("args %v lack %v", args, want)
+		}
+	}
+	if args[len(args)-1] != "rtp://127.0.0.1:5004?pkt_size=1200" {
+		t.Errorf("args %v don't send RTP to the capture", args)
+	}
+}
+
+func TestAudioCaptureFeed(t *testing.T) {
+	logger := slog.New(slog.NewTextHandler(io.Discard, nil))
+	capture := newAudioCapture(NewHub(logger), "cam", AudioCaptureConfig{Device: "hw:1,0"}, logger)
+	defer capture.cancel()
+
+	pcm := &fakePCM{
+		reads: [][]byte{{1, 2, 3, 4}, nil, {5, 6, 7, 8}},
+		errs:  []error{nil, errPCMOverrun, nil},
+	}
+	var encoder bytes.Buffer
+	err := capture.feed(pcm, &encoder)
+	if !errors.Is(err, errPCMTimeout) {
+		t.Errorf("feed = %v, want the stalled device's error", err)
+	}
+
+	written := encoder.Bytes()
+	if len(written) != 44+8 || !bytes.Equal(written[44:], []byte{1, 2, 3, 4, 5, 6, 7, 8}) {
+		t.Errorf("encoder got %v, want the WAV header and both reads", written)
+	}
+}
+
+func TestAudioCaptureFeedStopped(t *testing.T) {
+	logger := slog.New(slog.NewTextHandler(io.Discard, nil))
+	capture := newAudioCapture(NewHub(logger), "cam", AudioCaptureConfig{Device: "hw:1,0"}, logger)
+	capture.cancel()
+
+	var encoder bytes.Buffer
+	if err := capture.feed(&fakePCM{}, &encoder); err != nil {
+		t.Errorf("feed after stop = %v, want nil", err)
+	}
+}
+
+func TestHubAudioSource(t *testing.T) {
+	hub := NewHub(slog.New(slog.NewTextHandler(io.Discard, nil)))
+	h264 := &core.Codec{Name: core.CodecH264}
+	hub.producers["cam"] = newSlateProducer(&slateClip{codec: h264}, 30)
+
+	newAudio := func() *core.Receiver {
+		return core.NewReceiver(&core.Media{
+			Kind:      core.KindAudio,
+			Direction: core.DirectionRecvonly,
+			Codecs:    []*core.Codec{opusCodec()},
+		}, opusCodec())
+	}
+	audio := newAudio()
+	hub.SetAudioSource("cam", audio)
+	if got := hub.LiveStreams()[0].Codecs; !slices.Equal(got, []string{core.CodecH264, core.CodecOpus}) {
+		t.Errorf("codecs = %v, want video from the slate and the audio source", got)
+	}
+
+	received := make(chan *rtp.Packet, 4)
+	attachment, err := hub.AttachTrack("cam", core.KindAudio, func(packet *rtp.Packet) { received <- packet })
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer attachment.Close()
+
+	waitPacket := func(want byte) {
+		t.Helper()
+		select {
+		case packet := <-received:
+			if packet.Payload[0] != want {
+				t.Errorf("packet payload = %x, want %x", packet.Payload, want)
+			}
+		case <-time.After(2 * time.Second):
+			t.Fatal("timed out waiting for audio")
+		}
+	}
+	audio.Input(&rtp.Packet{Header: rtp.Header{SSRC: 1, Timestamp: 960}, Payload: []byte{1}})
+	waitPacket(1)
+
+	// Restarting the capture continues the same consumers
+	hub.RemoveAudioSource("cam", audio)
+	restarted := newAudio()
+	hub.SetAudioSource("cam", restarted)
+	restarted.Input(&rtp.Packet{Header: rtp.Header{SSRC: 2, Timestamp: 480}, Payload: []byte{2}})
+	waitPacket(2)
+
+	// Removing a replaced source leaves the current one alone
+	hub.RemoveAudioSource("cam", audio)
+	if got := len(hub.LiveStreams()[0].Codecs); got != 2 {
+		t.Errorf("codecs after removing a stale source = %d, want 2", got)
+	}
+
+	// A producer with audio of its own takes precedence
+	ffmpegAudio := newAudio()
+	conn := &rtsp.Conn{}
+	video := core.NewReceiver(&core.Media{Kind: core.KindVideo, Direction: core.DirectionRecvonly, Codecs: []*core.Codec{h264}}, h264)
+	conn.Receivers = []*core.Receiver{video, ffmpegAudio}
+	prod := rtspProducer{conn}
+	hub.producers["cam"] = prod
+	hub.mu.RLock()
+	tracks := hub.streamTracksLocked("cam", prod)
+	hub.mu.RUnlock()
+	if len(tracks) != 2 || tracks[1] != ffmpegAudio {
+		t.Errorf("tracks = %v, want the producer's own", tracks)
+	}
+}
+
+func TestAudioCapturesStartWithoutResolver(t *testing.T) {
+	logger := slog.New(slog.NewTextHandler(io.Discard, nil))
+	captures := NewAudioCaptures(NewHub(logger), logger)
+	captures.Start("cam")
+	if len(captures.captures) != 0 {
+		t.Error("capture started without settings")
+	}
+
+	captures.SetResolver(func(string) (AudioCaptureConfig, bool) { return AudioCaptureConfig{}, false })
+	captures.Start("cam")
+	if len(captures.captures) != 0 {
+		t.Error("capture started for a stream without native audio")
+	}
+	captures.StopAll()
+}
@@ -0,0 +1,160 @@
+package streaming
+
+import (
+	"sync"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// trackFanout relays a producer track to every consumer of that track, and
+// keeps doing so across producer restarts.
+//
+// The ingest sender is a single child of the producer receiver, so H264/H265
+// NAL inspection and parameter set injection run once per packet regardless
+// of peer count. The parsed packets are published on out, a receiver that
+// consumer senders attach to instead of the producer. Each consumer sender
+// owns a bounded queue drained by its own goroutine: a slow peer drops only
+// its own packets and never blocks the ingest goroutine or other peers.
+//
+// When the producer is replaced, the fan-out is detached from the old track
+// and attached to the new one. Consumers stay attached to out and see one
+// continuous RTP stream.
+//
+// The fan-out rewrites producer packets in place instead of copying them, so
+// it must be the only consumer of the producer track that reads them. Packets
+// published on out are shared by all peers and must be treated as read-only
+// by consumer handlers.
+type trackFanout struct {
+	media  *core.Media
+	source *core.Receiver // nil while detached
+	ingest *core.Sender
+	out    *core.Receiver
+	cache  *gopCache // nil when the stream has no GOP cache
+
+	// timeline traces frames for latency metrics, nil unless tracing video
+	timeline *streamTimeline
+
+	mu       sync.Mutex // guards rewriter and current against attach/detach
+	rewriter rtpRewriter
+	current  *core.Receiver // source as seen by publish
+}
+
+// newTrackFanout creates a fan-out stage for an RTP producer track.
+// The fan-out lives until its consumers can no longer be carried over to a
+// new producer. A non-nil cacheConfig enables the GOP cache for late-joining
+// consumers on H264/H265 tracks. A non-nil timeline traces the latency of the
+// track's frames.
+func newTrackFanout(source *core.Receiver, cacheConfig *GOPCacheConfig, timeline *streamTimeline) *trackFanout {
+	f := &trackFanout{
+		media: &core.Media{
+			Kind:      core.GetKind(source.Codec.Name),
+			Direction: core.DirectionRecvonly,
+			Codecs:    []*core.Codec{source.Codec},
+		},
+		rewriter: rtpRewriter{clockRate: source.Codec.ClockRate},
+		timeline: timeline,
+	}
+	f.out = core.NewReceiver(f.media, source.Codec)
+
+	if cacheConfig != nil && supportsPassthrough(source.Codec) {
+		f.cache = newGOPCache(*cacheConfig)
+	}
+
+	f.attach(source)
+	return f
+}
+
+// attach starts relaying a producer track. The track must be compatible with
+// the fan-out's codec (see codecsCompatible).
+func (f *trackFanout) attach(source *core.Receiver) {
+	if f.source == source {
+		return
+	}
+	if f.source != nil {
+		f.detach()
+	}
+	f.source = source
+	f.mu.Lock()
+	f.current = source
+	f.mu.Unlock()
+
+	var onKeyframe func()
+	if f.cache != nil {
+		onKeyframe = f.cache.reset
+	}
+
+	f.ingest = core.NewSender(f.media, source.Codec)
+	switch source.Codec.Name {
+	case core.CodecH265:
+		streamHandler := newH265StreamHandler(source.Codec, f.publish)
+		streamHandler.onKeyframe = onKeyframe
+		f.ingest.Handler = streamHandler.handlePacket
+	case core.CodecH264:
+		streamHandler := newH264StreamHandler(source.Codec, f.publish)
+		streamHandler.onKeyframe = onKeyframe
+		f.ingest.Handler = streamHandler.handlePacket
+	default:
+		f.ingest.Handler = f.publish
+	}
+	f.ingest.HandleRTP(source)
+}
+
+// detach stops relaying the current producer track. Consumers stay attached
+// to out; the next attached track continues their RTP stream.
+func (f *trackFanout) detach() {
+	if f.source == nil {
+		return
+	}
+	f.ingest.Close()
+	f.ingest = nil
+	f.source = nil
+
+	f.mu.Lock()
+	f.rewriter.rebase()
+	f.current = nil
+	f.mu.Unlock()
+
+	if f.cache != nil {
+		f.cache.invalidate() // the old GOP can't be decoded with the new stream
+	}
+}
+
+// publish hands a packet to every attached consumer sender.
+// The packet is cached first so a consumer's first live packet is always
+// found in the cache.
+func (f *trackFanout) publish(packet *rtp.Packet) {
+	f.mu.Lock()
+	sourceTS := packet.Timestamp
+	source := f.current
+	f.rewriter.rewrite(packet) // the fan-out is the producer track's only consumer
+	f.mu.Unlock()
+
+	if f.timeline != nil {
+		f.timeline.ingest(source, sourceTS, packet.Timestamp, time.Now())
+	}
+
+	if f.cache != nil {
+		f.cache.add(packet)
+	}
+	f.out.Input(packet)
+}
+
+// Close detaches the fan-out from the producer track.
+// Consumer senders stay attached to out until their connection closes.
+func (f *trackFanout) Close() {
+	f.detach()
+}
+
+// supportsFanout reports whether a producer track can be relayed through a
+// fan-out to WebRTC consumers.
+func supportsFanout(codec *core.Codec) bool {
+	return codec.IsRTP()
+}
+
+// supportsPassthrough reports whether a producer track can use the
+// parse-once passthrough path, writing packets straight to WebRTC tracks.
+func supportsPassthrough(codec *core.Codec) bool {
+	return codec.IsRTP() && (codec.Name == core.CodecH264 || codec.Name == core.CodecH265)
+}
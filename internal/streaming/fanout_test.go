@@ -0,0 +1,146 @@
+package streaming
+
+import (
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+func TestTrackFanout_SharedParse(t *testing.T) {
+	codec := &core.Codec{
+		Name:        core.CodecH264,
+		ClockRate:   90000,
+		PayloadType: 96,
+		FmtpLine:    "sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA==",
+	}
+	media := &core.Media{
+		Kind:      core.KindVideo,
+		Direction: core.DirectionRecvonly,
+		Codecs:    []*core.Codec{codec},
+	}
+
+	source := core.NewReceiver(media, codec)
+	fanout := newTrackFanout(source, nil, nil)
+	defer fanout.Close()
+
+	const peers = 2
+	var mu sync.Mutex
+	var wg sync.WaitGroup
+	received := make([][]*rtp.Packet, peers)
+	wg.Add(peers * 3)
+
+	for i := range peers {
+		sender := core.NewSender(media, codec)
+		sender.Handler = func(pkt *rtp.Packet) {
+			mu.Lock()
+			received[i] = append(received[i], pkt)
+			mu.Unlock()
+			wg.Done()
+		}
+		sender.HandleRTP(fanout.out)
+		defer sender.Close()
+	}
+
+	source.Input(&rtp.Packet{
+		Header:  rtp.Header{PayloadType: 96, SequenceNumber: 100, Timestamp: 1000, SSRC: 12345, Marker: true},
+		Payload: []byte{0x65, 0x00, 0x00, 0x00}, // NAL type 5 (IDR)
+	})
+
+	done := make(chan struct{})
+	go func() {
+		wg.Wait()
+		close(done)
+	}()
+	select {
+	case <-done:
+	case <-time.After(2 * time.Second):
+		t.Fatal("timed out waiting for fan-out packets")
+	}
+
+	mu.Lock()
+	defer mu.Unlock()
+
+	// Each peer should receive SPS + PPS + IDR
+	for i, pkts := range received {
+		if len(pkts) != 3 {
+			t.Fatalf("peer %d: expected 3 packets, got %d", i, len(pkts))
+		}
+	}
+
+	// Packets are parsed once and shared, so every peer sees the same instances
+	for j := range received[0] {
+		if received[0][j] != received[1][j] {
+			t.Errorf("packet %d: peers received different instances, expected shared packet", j)
+		}
+	}
+}
+
+func BenchmarkTrackFanout_Publish(b *testing.B) {
+	codec := &core.Codec{Name: core.CodecH264, ClockRate: 90000, PayloadType: 96}
+	media := &core.Media{Kind: core.KindVideo, Direction: core.DirectionRecvonly, Codecs: []*core.Codec{codec}}
+	fanout := newTrackFanout(core.NewReceiver(media, codec), &GOPCacheConfig{}, nil)
+	defer fanout.Close()
+
+	packet := &rtp.Packet{
+		Header:  rtp.Header{PayloadType: 96, Timestamp: 1000},
+		Payload: make([]byte, 1200),
+	}
+
+	b.ReportAllocs()
+	i := 0
+	for b.Loop() {
+		if i%1000 == 0 {
+			fanout.cache.reset()
+		}
+		fanout.publish(packet)
+		i++
+	}
+}
+
+func TestTrackFanout_Handover(t *testing.T) {
+	codec := &core.Codec{Name: core.CodecOpus, ClockRate: 48000, Channels: 2, PayloadType: 111}
+	media := &core.Media{Kind: core.KindAudio, Direction: core.DirectionRecvonly, Codecs: []*core.Codec{codec}}
+
+	first := core.NewReceiver(media, codec)
+	fanout := newTrackFanout(first, nil, nil)
+	defer fanout.Close()
+
+	received := make(chan *rtp.Packet, 4)
+	sender := core.NewSender(media, codec)
+	sender.Handler = func(pkt *rtp.Packet) { received <- pkt }
+	sender.HandleRTP(fanout.out)
+	defer sender.Close()
+
+	next := func() *rtp.Packet {
+		select {
+		case pkt := <-received:
+			return pkt
+		case <-time.After(2 * time.Second):
+			t.Fatal("timed out waiting for fan-out packet")
+			return nil
+		}
+	}
+
+	first.Input(&rtp.Packet{Header: rtp.Header{SSRC: 1, SequenceNumber: 10, Timestamp: 960}, Payload: []byte{1}})
+	before := next()
+
+	// Restarted producer: new receiver, new SSRC and random bases
+	fanout.detach()
+	second := core.NewReceiver(media, codec)
+	fanout.attach(second)
+	second.Input(&rtp.Packet{Header: rtp.Header{SSRC: 2, SequenceNumber: 40000, Timestamp: 7}, Payload: []byte{2}})
+	after := next()
+
+	if after.SSRC != before.SSRC {
+		t.Errorf("SSRC changed across handover: %d -> %d", before.SSRC, after.SSRC)
+	}
+	if after.SequenceNumber != before.SequenceNumber+1 {
+		t.Errorf("seq = %d, want %d", after.SequenceNumber, before.SequenceNumber+1)
+	}
+	if after.Timestamp <= before.Timestamp {
+		t.Errorf("timestamp went backwards: %d -> %d", before.Timestamp, after.Timestamp)
+	}
+}
@@ -0,0 +1,387 @@
+package streaming
+
+import (
+	"encoding/binary"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+)
+
+// Fragmented MP4 (ISO/IEC 14496-12) boxes written by the recorder. Only what
+// a fragmented file needs is written: an init segment (ftyp, moov) with empty
+// sample tables, then one moof+mdat pair per fragment.
+
+// fmp4Track describes a track of the init segment.
+type fmp4Track struct {
+	id        uint32
+	codec     string // core.CodecH264, core.CodecH265 or core.CodecOpus
+	timescale uint32
+	width     uint16
+	height    uint16
+	channels  uint16
+	config    []byte // avcC or hvcC record, unused for Opus
+}
+
+// fmp4Sample is a sample of a track fragment.
+type fmp4Sample struct {
+	duration uint32
+	size     uint32
+	sync     bool
+}
+
+// fmp4Fragment is a track's part of a fragment: its samples, with their
+// data stored back to back.
+type fmp4Fragment struct {
+	track      *fmp4Track
+	decodeTime uint64 // of the first sample, in the track's timescale
+	samples    []fmp4Sample
+	data       []byte
+}
+
+// Sample flags (ISO/IEC 14496-12 8.8.3.1).
+const (
+	fmp4SampleSync    = 0x02000000 // depends on no other sample
+	fmp4SampleNonSync = 0x01010000 // depends on others, not a sync sample
+)
+
+// movieTimescale is the timescale of the movie header. Fragmented files have
+// no movie duration, so any value works.
+const movieTimescale = 1000
+
+// unityMatrix is the identity transformation matrix of mvhd and tkhd.
+var unityMatrix = [9]uint32{0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000}
+
+// boxWriter appends ISO BMFF boxes to a buffer.
+type boxWriter struct {
+	buf []byte
+}
+
+// start opens a box and returns its offset, to be passed to end.
+func (w *boxWriter) start(typ string) int {
+	offset := len(w.buf)
+	w.buf = append(w.buf, 0, 0, 0, 0, typ[0], typ[1], typ[2], typ[3])
+	return offset
+}
+
+// startFull opens a full box with a version and flags.
+func (w *boxWriter) startFull(typ string, version byte, flags uint32) int {
+	offset := w.start(typ)
+	w.u32(uint32(version)<<24 | flags)
+	return offset
+}
+
+// end closes the box opened at offset by writing its size.
+func (w *boxWriter) end(offset int) {
+	binary.BigEndian.PutUint32(w.buf[offset:], uint32(len(w.buf)-offset))
+}
+
+func (w *boxWriter) u8(v uint8)   { w.buf = append(w.buf, v) }
+func (w *boxWriter) u16(v uint16) { w.buf = binary.BigEndian.AppendUint16(w.buf, v) }
+func (w *boxWriter) u32(v uint32) { w.buf = binary.BigEndian.AppendUint32(w.buf, v) }
+func (w *boxWriter) u64(v uint64) { w.buf = binary.BigEndian.AppendUint64(w.buf, v) }
+
+func (w *boxWriter) bytes(b []byte) { w.buf = append(w.buf, b...) }
+
+func (w *boxWriter) zeros(n int) {
+	for range n {
+		w.buf = append(w.buf, 0)
+	}
+}
+
+func (w *boxWriter) matrix() {
+	for _, v := range unityMatrix {
+		w.u32(v)
+	}
+}
+
+// appendFMP4Init appends an init segment (ftyp and moov) for tracks to dst.
+func appendFMP4Init(dst []byte, tracks []*fmp4Track) []byte {
+	w := boxWriter{buf: dst}
+
+	ftyp := w.start("ftyp")
+	w.bytes([]byte("iso5"))
+	w.u32(512)
+	w.bytes([]byte("iso5iso6mp41"))
+	w.end(ftyp)
+
+	moov := w.start("moov")
+
+	mvhd := w.startFull("mvhd", 0, 0)
+	w.u32(0) // creation time
+	w.u32(0) // modification time
+	w.u32(movieTimescale)
+	w.u32(0)          // duration, unknown
+	w.u32(0x00010000) // rate 1.0
+	w.u16(0x0100)     // volume 1.0
+	w.zeros(10)
+	w.matrix()
+	w.zeros(24)
+	w.u32(uint32(len(tracks) + 1)) // next track ID
+	w.end(mvhd)
+
+	for _, track := range tracks {
+		writeTrak(&w, track)
+	}
+
+	mvex := w.start("mvex")
+	for _, track := range tracks {
+		trex := w.startFull("trex", 0, 0)
+		w.u32(track.id)
+		w.u32(1) // sample description index
+		w.u32(0) // default duration
+		w.u32(0) // default size
+		w.u32(0) // default flags
+		w.end(trex)
+	}
+	w.end(mvex)
+
+	w.end(moov)
+	return w.buf
+}
+
+func writeTrak(w *boxWriter, track *fmp4Track) {
+	audio := track.codec == core.CodecOpus
+
+	trak := w.start("trak")
+
+	tkhd := w.startFull("tkhd", 0, 3) // enabled, in movie
+	w.u32(0)                          // creation time
+	w.u32(0)                          // modification time
+	w.u32(track.id)
+	w.u32(0) // reserved
+	w.u32(0) // duration
+	w.zeros(8)
+	w.u16(0) // layer
+	w.u16(0) // alternate group
+	if audio {
+		w.u16(0x0100)
+	} else {
+		w.u16(0)
+	}
+	w.u16(0)
+	w.matrix()
+	w.u32(uint32(track.width) << 16)
+	w.u32(uint32(track.height) << 16)
+	w.end(tkhd)
+
+	mdia := w.start("mdia")
+
+	mdhd := w.startFull("mdhd", 0, 0)
+	w.u32(0) // creation time
+	w.u32(0) // modification time
+	w.u32(track.timescale)
+	w.u32(0)      // duration
+	w.u16(0x55C4) // language "und"
+	w.u16(0)
+	w.end(mdhd)
+
+	hdlr := w.startFull("hdlr", 0, 0)
+	w.u32(0)
+	if audio {
+		w.bytes([]byte("soun"))
+	} else {
+		w.bytes([]byte("vide"))
+	}
+	w.zeros(12)
+	if audio {
+		w.bytes([]byte("SoundHandler\x00"))
+	} else {
+		w.bytes([]byte("VideoHandler\x00"))
+	}
+	w.end(hdlr)
+
+	minf := w.start("minf")
+	if audio {
+		smhd := w.startFull("smhd", 0, 0)
+		w.u16(0) // balance
+		w.u16(0)
+		w.end(smhd)
+	} else {
+		vmhd := w.startFull("vmhd", 0, 1)
+		w.zeros(8) // graphics mode, opcolor
+		w.end(vmhd)
+	}
+
+	dinf := w.start("dinf")
+	dref := w.startFull("dref", 0, 0)
+	w.u32(1)
+	url := w.startFull("url ", 0, 1) // media is in this file
+	w.end(url)
+	w.end(dref)
+	w.end(dinf)
+
+	stbl := w.start("stbl")
+	stsd := w.startFull("stsd", 0, 0)
+	w.u32(1)
+	if audio {
+		writeOpusSampleEntry(w, track)
+	} else {
+		writeVisualSampleEntry(w, track)
+	}
+	w.end(stsd)
+	for _, typ := range []string{"stts", "stsc", "stco"} {
+		box := w.startFull(typ, 0, 0)
+		w.u32(0) // no entries, samples are in fragments
+		w.end(box)
+	}
+	stsz := w.startFull("stsz", 0, 0)
+	w.u32(0) // sample size
+	w.u32(0) // sample count
+	w.end(stsz)
+	w.end(stbl)
+
+	w.end(minf)
+	w.end(mdia)
+	w.end(trak)
+}
+
+func writeVisualSampleEntry(w *boxWriter, track *fmp4Track) {
+	entryType, configType := "avc1", "avcC"
+	if track.codec == core.CodecH265 {
+		entryType, configType = "hvc1", "hvcC"
+	}
+
+	entry := w.start(entryType)
+	w.zeros(6)
+	w.u16(1) // data reference index
+	w.zeros(16)
+	w.u16(track.width)
+	w.u16(track.height)
+	w.u32(0x00480000) // 72 dpi
+	w.u32(0x00480000)
+	w.u32(0)
+	w.u16(1)    // frame count
+	w.zeros(32) // compressor name
+	w.u16(0x0018)
+	w.u16(0xFFFF)
+
+	config := w.start(configType)
+	w.bytes(track.config)
+	w.end(config)
+
+	w.end(entry)
+}
+
+// writeOpusSampleEntry writes an Opus sample entry with its dOps box
+// (Encapsulation of Opus in ISO BMFF, 4.3).
+func writeOpusSampleEntry(w *boxWriter, track *fmp4Track) {
+	entry := w.start("Opus")
+	w.zeros(6)
+	w.u16(1) // data reference index
+	w.zeros(8)
+	w.u16(track.channels)
+	w.u16(16) // sample size
+	w.u32(0)
+	w.u32(48000 << 16)
+
+	dops := w.start("dOps")
+	w.u8(0) // version
+	w.u8(uint8(track.channels))
+	w.u16(0) // pre-skip, unknown for a live stream
+	w.u32(48000)
+	w.u16(0) // output gain
+	w.u8(0)  // mapping family: mono or stereo
+	w.end(dops)
+
+	w.end(entry)
+}
+
+// appendFMP4Fragment appends a moof+mdat pair holding the samples of
+// fragments to dst. Fragments without samples are left out.
+func appendFMP4Fragment(dst []byte, sequence uint32, fragments []*fmp4Fragment) []byte {
+	w := boxWriter{buf: dst}
+
+	moof := w.start("moof")
+	mfhd := w.startFull("mfhd", 0, 0)
+	w.u32(sequence)
+	w.end(mfhd)
+
+	var dataOffsets []int // positions of the trun data offsets to fill in
+	for _, frag := range fragments {
+		if len(frag.samples) == 0 {
+			continue
+		}
+		traf := w.start("traf")
+
+		tfhd := w.startFull("tfhd", 0, 0x020000) // default base is moof
+		w.u32(frag.track.id)
+		w.end(tfhd)
+
+		tfdt := w.startFull("tfdt", 1, 0)
+		w.u64(frag.decodeTime)
+		w.end(tfdt)
+
+		// data offset, sample durations, sizes and flags present
+		trun := w.startFull("trun", 0, 0x000001|0x000100|0x000200|0x000400)
+		w.u32(uint32(len(frag.samples)))
+		dataOffsets = append(dataOffsets, len(w.buf))
+		w.u32(0)
+		for _, sample := range frag.samples {
+			w.u32(sample.duration)
+			w.u32(sample.size)
+			if sample.sync {
+				w.u32(fmp4SampleSync)
+			} else {
+				w.u32(fmp4SampleNonSync)
+			}
+		}
+		w.end(trun)
+
+		w.end(traf)
+	}
+	w.end(moof)
+
+	mdat := w.start("mdat")
+	i := 0
+	for _, frag := range fragments {
+		if len(frag.samples) == 0 {
+			continue
+		}
+		binary.BigEndian.PutUint32(w.buf[dataOffsets[i]:], uint32(len(w.buf)-moof))
+		w.bytes(frag.data)
+		i++
+	}
+	w.end(mdat)
+
+	return w.buf
+}
+
+// avcDecoderConfig builds an avcC record (ISO/IEC 14496-15 5.3.3) with
+// 4-byte NAL lengths.
+func avcDecoderConfig(sps, pps []byte) []byte {
+	if len(sps) < 4 {
+		return nil
+	}
+	config := []byte{1, sps[1], sps[2], sps[3], 0xFF, 0xE1}
+	config = binary.BigEndian.AppendUint16(config, uint16(len(sps)))
+	config = append(config, sps...)
+	config = append(config, 1)
+	config = binary.BigEndian.AppendUint16(config, uint16(len(pps)))
+	return append(config, pps...)
+}
+
+// hevcDecoderConfig builds an hvcC record (ISO/IEC 14496-15 8.3.3) with
+// 4-byte NAL lengths, taking the profile and format fields from the SPS.
+func hevcDecoderConfig(vps, sps, pps []byte, info *h265SPSInfo) []byte {
+	config := []byte{1}
+	config = append(config, info.profileTierLevel[:]...)
+	config = append(config,
+		0xF0, 0x00, // min spatial segmentation
+		0xFC,                     // parallelism type unknown
+		0xFC|info.chromaFormat&3, // chroma format
+		0xF8|info.bitDepthLuma&7,
+		0xF8|info.bitDepthChroma&7,
+		0, 0, // average frame rate unknown
+		info.maxSubLayers<<3|info.temporalIDNested<<2|3, // 4-byte NAL lengths
+		3, // arrays: VPS, SPS, PPS
+	)
+	for _, ps := range []struct {
+		nalType byte
+		nal     []byte
+	}{{h265NALVPS, vps}, {h265NALSPS, sps}, {h265NALPPS, pps}} {
+		config = append(config, 0x80|ps.nalType) // complete array
+		config = binary.BigEndian.AppendUint16(config, 1)
+		config = binary.BigEndian.AppendUint16(config, uint16(len(ps.nal)))
+		config = append(config, ps.nal...)
+	}
+	return config
+}
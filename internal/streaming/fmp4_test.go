@@ -0,0 +1,288 @@
+package streaming
+
+import (
+	"bytes"
+	"encoding/base64"
+	"encoding/binary"
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+)
+
+// testSPS and testPPS are an H264 baseline 640x480 stream's parameter sets.
+const (
+	testSPS = "Z0IAKeKQFAe2AtwEBAaQeJEV"
+	testPPS = "aM48gA=="
+)
+
+func decodeBase64(t *testing.T, s string) []byte {
+	t.Helper()
+	b, err := base64.StdEncoding.DecodeString(s)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return b
+}
+
+type box struct {
+	typ    string
+	offset int // of the box header in the parsed buffer
+	body   []byte
+}
+
+func readBoxes(t *testing.T, data []byte) []box {
+	t.Helper()
+	var boxes []box
+	for offset := 0; offset < len(data); {
+		if len(data)-offset < 8 {
+			t.Fatalf("truncated box header at %d", offset)
+		}
+		size := int(binary.BigEndian.Uint32(data[offset:]))
+		if size < 8 || offset+size > len(data) {
+			t.Fatalf("box at %d has size %d, %d bytes left", offset, size, len(data)-offset)
+		}
+		boxes = append(boxes, box{string(data[offset+4 : offset+8]), offset, data[offset+8 : offset+size]})
+		offset += size
+	}
+	return boxes
+}
+
+func findBox(t *testing.T, data []byte, path ...string) box {
+	t.Helper()
+	var found box
+	for i, typ := range path {
+		ok := false
+		for _, b := range readBoxes(t, data) {
+			if b.typ == typ {
+				found, ok = b, true
+				break
+			}
+		}
+		if !ok {
+			t.Fatalf("box %v not found", path[:i+1])
+		}
+		data = found.body
+	}
+	return found
+}
+
+// trafInfo is what a test reads back from a track fragment.
+type trafInfo struct {
+	trackID    uint32
+	decodeTime uint64
+	durations  []uint32
+	sizes      []uint32
+	sync       []bool
+}
+
+// parseFragment reads back a moof+mdat pair and checks that every trun
+// points at its samples inside mdat.
+func parseFragment(t *testing.T, data []byte) (sequence uint32, trafs []trafInfo) {
+	t.Helper()
+	boxes := readBoxes(t, data)
+	if len(boxes) != 2 || boxes[0].typ != "moof" || boxes[1].typ != "mdat" {
+		t.Fatalf("fragment boxes = %v, want moof and mdat", boxes)
+	}
+	moof, mdat := boxes[0], boxes[1]
+	sequence = binary.BigEndian.Uint32(findBox(t, moof.body, "mfhd").body[4:])
+
+	mdatStart := mdat.offset + 8
+	expectOffset := mdatStart
+	for _, traf := range readBoxes(t, moof.body) {
+		if traf.typ != "traf" {
+			continue
+		}
+		var info trafInfo
+		info.trackID = binary.BigEndian.Uint32(findBox(t, traf.body, "tfhd").body[4:])
+		info.decodeTime = binary.BigEndian.Uint64(findBox(t, traf.body, "tfdt").body[4:])
+
+		trun := findBox(t, traf.body, "trun").body
+		count := int(binary.BigEndian.Uint32(trun[4:]))
+		dataOffset := int(binary.BigEndian.Uint32(trun[8:]))
+		if got := moof.offset + dataOffset; got != expectOffset {
+			t.Errorf("track %d data at %d, want %d", info.trackID, got, expectOffset)
+		}
+		for i := range count {
+			entry := trun[12+12*i:]
+			info.durations = append(info.durations, binary.BigEndian.Uint32(entry))
+			info.sizes = append(info.sizes, binary.BigEndian.Uint32(entry[4:]))
+			info.sync = append(info.sync, binary.BigEndian.Uint32(entry[8:]) == fmp4SampleSync)
+			expectOffset += int(binary.BigEndian.Uint32(entry[4:]))
+		}
+		trafs = append(trafs, info)
+	}
+	if expectOffset != len(data) {
+		t.Errorf("samples end at %d, mdat at %d", expectOffset, len(data))
+	}
+	return sequence, trafs
+}
+
+func TestFMP4Init(t *testing.T) {
+	sps, pps := decodeBase64(t, testSPS), decodeBase64(t, testPPS)
+	tracks := []*fmp4Track{
+		{id: 1, codec: core.CodecH264, timescale: 90000, width: 640, height: 480, config: avcDecoderConfig(sps, pps)},
+		{id: 2, codec: core.CodecOpus, timescale: 48000, channels: 2},
+	}
+	init := appendFMP4Init(nil, tracks)
+
+	boxes := readBoxes(t, init)
+	if len(boxes) != 2 || boxes[0].typ != "ftyp" || boxes[1].typ != "moov" {
+		t.Fatalf("init boxes = %v, want ftyp and moov", boxes)
+	}
+
+	avcC := findBox(t, init, "moov", "trak", "mdia", "minf", "stbl", "stsd")
+	entry := readBoxes(t, avcC.body[8:])[0]
+	if entry.typ != "avc1" {
+		t.Fatalf("sample entry = %q, want avc1", entry.typ)
+	}
+	if w, h := binary.BigEndian.Uint16(entry.body[24:]), binary.BigEndian.Uint16(entry.body[26:]); w != 640 || h != 480 {
+		t.Errorf("sample entry size = %dx%d, want 640x480", w, h)
+	}
+	config := findBox(t, entry.body[78:], "avcC").body
+	if !bytes.Contains(config, sps) || !bytes.Contains(config, pps) {
+		t.Error("avcC lacks the parameter sets")
+	}
+
+	var trexIDs []uint32
+	for _, b := range readBoxes(t, findBox(t, init, "moov", "mvex").body) {
+		trexIDs = append(trexIDs, binary.BigEndian.Uint32(b.body[4:]))
+	}
+	if len(trexIDs) != 2 || trexIDs[0] != 1 || trexIDs[1] != 2 {
+		t.Errorf("trex track IDs = %v, want [1 2]", trexIDs)
+	}
+}
+
+func TestFMP4Fragment(t *testing.T) {
+	video := &fmp4Track{id: 1}
+	audio := &fmp4Track{id: 2}
+	fragments := []*fmp4Fragment{
+		{
+			track:      video,
+			decodeTime: 90000,
+			samples:    []fmp4Sample{{duration: 3000, size: 3, sync: true}, {duration: 3000, size: 2}},
+			data:       []byte{1, 2, 3, 4, 5},
+		},
+		{track: audio}, // no samples, left out
+		{
+			track:      audio,
+			decodeTime: 48000,
+			samples:    []fmp4Sample{{duration: 960, size: 4, sync: true}},
+			data:       []byte{6, 7, 8, 9},
+		},
+	}
+
+	data := appendFMP4Fragment([]byte("prefix"), 7, fragments)
+	if !bytes.HasPrefix(data, []byte("prefix")) {
+		t.Fatal("dst was not appended to")
+	}
+	sequence, trafs := parseFragment(t, data[len("prefix"):])
+	if sequence != 7 {
+		t.Errorf("sequence = %d, want 7", sequence)
+	}
+	if len(trafs) != 2 {
+		t.Fatalf("trafs = %d, want 2", len(trafs))
+	}
+	if trafs[0].trackID != 1 || trafs[0].decodeTime != 90000 || len(trafs[0].sizes) != 2 || !trafs[0].sync[0] || trafs[0].sync[1] {
+		t.Errorf("video traf = %+v", trafs[0])
+	}
+	if trafs[1].trackID != 2 || trafs[1].decodeTime != 48000 || trafs[1].durations[0] != 960 {
+		t.Errorf("audio traf = %+v", trafs[1])
+	}
+	if mdat := findBox(t, data[len("prefix"):], "mdat"); !bytes.Equal(mdat.body, []byte{1, 2, 3, 4, 5, 6, 7, 8, 9}) {
+		t.Errorf("mdat = %v", mdat.body)
+	}
+}
+
+func TestParseH264SPSSize(t *testing.T) {
+	width, height, err := parseH264SPSSize(decodeBase64(t, testSPS))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if width != 640 || height != 480 {
+		t.Errorf("size = %dx%d, want 640x480", width, height)
+	}
+
+	if _, _, err := parseH264SPSSize([]byte{0x67, 0x42, 0x00}); err == nil {
+		t.Error("truncated SPS parsed")
+	}
+}
+
+// bitWriter builds RBSPs for parser tests.
+type bitWriter struct {
+	buf  []byte
+	bits int
+}
+
+func (w *bitWriter) put(v uint32, n int) {
+	for i := n - 1; i >= 0; i-- {
+		if w.bits%8 == 0 {
+			w.buf = append(w.buf, 0)
+		}
+		w.buf[len(w.buf)-1] |= byte(v>>i&1) << (7 - w.bits%8)
+		w.bits++
+	}
+}
+
+func (w *bitWriter) ue(v uint32) {
+	n := 0
+	for (v+1)>>n > 1 {
+		n++
+	}
+	w.put(0, n)
+	w.put(v+1, n+1)
+}
+
+func TestParseH265SPS(t *testing.T) {
+	var w bitWriter
+	w.put(0x4201, 16) // NAL header: SPS
+	w.put(0, 4)       // sps_video_parameter_set_id
+	w.put(0, 3)       // sps_max_sub_layers_minus1
+	w.put(1, 1)       // sps_temporal_id_nesting_flag
+	w.put(0x01, 8)    // Main profile
+	w.put(0x60000000, 32)
+	w.put(0xB0, 8)
+	w.put(0, 32)
+	w.put(0, 8)
+	w.put(93, 8) // level 3.1
+	w.ue(0)      // sps_seq_parameter_set_id
+	w.ue(1)      // chroma_format_idc 4:2:0
+	w.ue(1920)
+	w.ue(1088)
+	w.put(1, 1) // conformance window
+	w.ue(0)
+	w.ue(0)
+	w.ue(0)
+	w.ue(4) // 8 rows cropped at the bottom
+	w.ue(2) // bit_depth_luma_minus8
+	w.ue(2) // bit_depth_chroma_minus8
+	w.put(1, 1)
+
+	info, err := parseH265SPS(w.buf)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if info.width != 1920 || info.height != 1080 {
+		t.Errorf("size = %dx%d, want 1920x1080", info.width, info.height)
+	}
+	if info.chromaFormat != 1 || info.bitDepthLuma != 2 || info.bitDepthChroma != 2 {
+		t.Errorf("format = %d, depths %d/%d, want 1, 2/2", info.chromaFormat, info.bitDepthLuma, info.bitDepthChroma)
+	}
+	if info.maxSubLayers != 1 || info.temporalIDNested != 1 {
+		t.Errorf("sub-layers = %d, nested %d, want 1, 1", info.maxSubLayers, info.temporalIDNested)
+	}
+	if !bytes.Equal(info.profileTierLevel[:], w.buf[3:15]) {
+		t.Errorf("profile tier level = %x, want %x", info.profileTierLevel, w.buf[3:15])
+	}
+
+	if _, err := parseH265SPS(w.buf[:16]); err == nil {
+		t.Error("truncated SPS parsed")
+	}
+}
+
+func TestUnescapeRBSP(t *testing.T) {
+	got := unescapeRBSP([]byte{0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x03, 0x00, 0x03})
+	want := []byte{0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03}
+	if !bytes.Equal(got, want) {
+		t.Errorf("unescapeRBSP = %x, want %x", got, want)
+	}
+}
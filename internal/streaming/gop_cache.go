@@ -0,0 +1,195 @@
+package streaming
+
+import (
+	"sync"
+	"sync/atomic"
+
+	"github.com/pion/rtp"
+)
+
+// Default GOP cache limits, used when a stream enables the cache without
+// setting explicit bounds. 16384 packets covers a 4s GOP at 50Mbit/s with
+// ~1400 byte packets; 24MiB covers the same GOP's payload.
+const (
+	DefaultGOPCacheMaxPackets = 16384
+	DefaultGOPCacheMaxBytes   = 24 << 20
+)
+
+// GOPCacheConfig configures the per-producer GOP cache used for instant
+// first frame on late-joining WebRTC consumers.
+type GOPCacheConfig struct {
+	// MaxPackets caps the number of RTP packets kept for one GOP (0 = default)
+	MaxPackets int
+	// MaxBytes caps the payload bytes kept for one GOP (0 = default)
+	MaxBytes int
+}
+
+// gopCache keeps the most recent keyframe and its follow-on packets.
+// It is written by a fan-out ingest goroutine and read by consumer writers.
+// Cached packets are shared with live consumers and must not be modified.
+//
+// If a GOP exceeds either limit, the cache is invalidated until the next
+// keyframe rather than serving a partial GOP with undecodable references.
+type gopCache struct {
+	mu         sync.Mutex
+	packets    []*rtp.Packet
+	bytes      int
+	maxPackets int
+	maxBytes   int
+	valid      bool // true once a keyframe has been seen and limits hold
+}
+
+func newGOPCache(config GOPCacheConfig) *gopCache {
+	if config.MaxPackets <= 0 {
+		config.MaxPackets = DefaultGOPCacheMaxPackets
+	}
+	if config.MaxBytes <= 0 {
+		config.MaxBytes = DefaultGOPCacheMaxBytes
+	}
+	return &gopCache{
+		maxPackets: config.MaxPackets,
+		maxBytes:   config.MaxBytes,
+	}
+}
+
+// reset discards the cached GOP and starts caching a new one.
+// Called at the start of every keyframe.
+func (c *gopCache) reset() {
+	c.mu.Lock()
+	c.clearLocked()
+	c.valid = true
+	c.mu.Unlock()
+}
+
+// invalidate discards the cached GOP and stops caching until the next
+// keyframe.
+func (c *gopCache) invalidate() {
+	c.mu.Lock()
+	c.clearLocked()
+	c.valid = false
+	c.mu.Unlock()
+}
+
+// add appends a packet to the current GOP.
+func (c *gopCache) add(packet *rtp.Packet) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	if !c.valid {
+		return
+	}
+	if len(c.packets) >= c.maxPackets || c.bytes+len(packet.Payload) > c.maxBytes {
+		c.clearLocked()
+		c.valid = false
+		return
+	}
+	c.packets = append(c.packets, packet)
+	c.bytes += len(packet.Payload)
+}
+
+// burst returns the cached packets that precede live, the next live packet
+// a consumer is about to receive. Returns nil if live is not part of the
+// cached GOP: the consumer then either starts on a keyframe or waits for one.
+func (c *gopCache) burst(live *rtp.Packet) []*rtp.Packet {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	if !c.valid {
+		return nil
+	}
+	for i, pkt := range c.packets {
+		if pkt == live {
+			if i == 0 {
+				return nil
+			}
+			return append([]*rtp.Packet(nil), c.packets[:i]...)
+		}
+	}
+	return nil
+}
+
+func (c *gopCache) clearLocked() {
+	clear(c.packets) // drop references so old GOPs can be collected
+	c.packets = c.packets[:0]
+	c.bytes = 0
+}
+
+// gopReplay prepends the cached GOP to a consumer's first live packet, and
+// replays it again on request to recover the consumer after packet loss.
+// It runs on the consumer's writer goroutine, so the burst never delays the
+// fan-out or other consumers.
+//
+// The join burst takes the sequence numbers right before the first live
+// packet. A recovery burst is inserted after packets the consumer already
+// received, so every later packet is shifted by seqOffset.
+type gopReplay struct {
+	cache     *gopCache
+	handler   func(*rtp.Packet)
+	joined    bool
+	pending   atomic.Bool // recovery requested
+	seqOffset uint16
+	scratch   rtp.Packet // reused for shifted live packets
+}
+
+func newGOPReplay(cache *gopCache, handler func(*rtp.Packet)) *gopReplay {
+	return &gopReplay{cache: cache, handler: handler}
+}
+
+// requestRecovery makes the next live packet be preceded by the cached GOP.
+// Safe to call from any goroutine.
+func (r *gopReplay) requestRecovery() {
+	r.pending.Store(true)
+}
+
+func (r *gopReplay) handlePacket(packet *rtp.Packet) {
+	switch {
+	case !r.joined:
+		r.joined = true
+		r.pending.Store(false)
+		burst := rewriteBurst(r.cache.burst(packet), packet)
+		for i := range burst {
+			r.handler(&burst[i])
+		}
+	case r.pending.Load() && r.pending.Swap(false):
+		burst := rewriteBurst(r.cache.burst(packet), packet)
+		for i := range burst {
+			burst[i].SequenceNumber = packet.SequenceNumber + r.seqOffset + uint16(i)
+			r.handler(&burst[i])
+		}
+		r.seqOffset += uint16(len(burst))
+	}
+
+	if r.seqOffset == 0 {
+		r.handler(packet)
+		return
+	}
+	r.scratch = *packet
+	r.scratch.SequenceNumber += r.seqOffset
+	r.handler(&r.scratch)
+}
+
+// rewriteBurst copies cached packets so they continue seamlessly into live.
+// Sequence numbers are made contiguous, ending right before live. Timestamps
+// are compressed to one tick per frame, ending at live's frame, so the
+// browser decodes the burst immediately instead of playing back a GOP of
+// stale frames. Payloads are shared with the cache.
+func rewriteBurst(burst []*rtp.Packet, live *rtp.Packet) []rtp.Packet {
+	if len(burst) == 0 {
+		return nil
+	}
+
+	out := make([]rtp.Packet, len(burst))
+	timestamp := live.Timestamp
+	prevOriginal := live.Timestamp
+	for i := len(burst) - 1; i >= 0; i-- {
+		pkt := burst[i]
+		if pkt.Timestamp != prevOriginal {
+			timestamp--
+			prevOriginal = pkt.Timestamp
+		}
+		out[i] = *pkt
+		out[i].Timestamp = timestamp
+		out[i].SequenceNumber = live.SequenceNumber - uint16(len(burst)-i)
+	}
+	return out
+}
@@ -0,0 +1,215 @@
+package streaming
+
+import (
+	"testing"
+
+	"github.com/pion/rtp"
+)
+
+func newTestPacket(seq uint16, ts uint32, size int) *rtp.Packet {
+	return &rtp.Packet{
+		Header:  rtp.Header{SequenceNumber: seq, Timestamp: ts, SSRC: 12345},
+		Payload: make([]byte, size),
+	}
+}
+
+func TestGOPCache_Burst(t *testing.T) {
+	cache := newGOPCache(GOPCacheConfig{})
+
+	// Packets before the first keyframe are not cached
+	cache.add(newTestPacket(1, 1000, 10))
+
+	cache.reset()
+	gop := []*rtp.Packet{
+		newTestPacket(10, 3000, 10), // keyframe
+		newTestPacket(11, 3000, 10),
+		newTestPacket(12, 6000, 10),
+		newTestPacket(13, 9000, 10),
+	}
+	for _, pkt := range gop {
+		cache.add(pkt)
+	}
+
+	tests := []struct {
+		name string
+		live *rtp.Packet
+		want int
+	}{
+		{"live is keyframe", gop[0], 0},
+		{"live mid-GOP", gop[2], 2},
+		{"live is last cached", gop[3], 3},
+		{"live not cached", newTestPacket(14, 12000, 10), 0},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := len(cache.burst(tt.live)); got != tt.want {
+				t.Errorf("burst length = %d, want %d", got, tt.want)
+			}
+		})
+	}
+}
+
+func TestGOPCache_Overflow(t *testing.T) {
+	cache := newGOPCache(GOPCacheConfig{MaxPackets: 2})
+
+	cache.reset()
+	first := newTestPacket(1, 1000, 10)
+	cache.add(first)
+	cache.add(newTestPacket(2, 2000, 10))
+	live := newTestPacket(3, 3000, 10)
+	cache.add(live) // exceeds MaxPackets, invalidates the GOP
+
+	if burst := cache.burst(live); burst != nil {
+		t.Errorf("expected no burst after overflow, got %d packets", len(burst))
+	}
+
+	// Next keyframe re-enables the cache
+	cache.reset()
+	keyframe := newTestPacket(4, 4000, 10)
+	next := newTestPacket(5, 5000, 10)
+	cache.add(keyframe)
+	cache.add(next)
+	if got := len(cache.burst(next)); got != 1 {
+		t.Errorf("expected 1 packet burst after reset, got %d", got)
+	}
+}
+
+func TestGOPCache_MaxBytes(t *testing.T) {
+	cache := newGOPCache(GOPCacheConfig{MaxBytes: 15})
+
+	cache.reset()
+	cache.add(newTestPacket(1, 1000, 10))
+	live := newTestPacket(2, 2000, 10)
+	cache.add(live) // exceeds MaxBytes
+
+	if burst := cache.burst(live); burst != nil {
+		t.Errorf("expected no burst after byte overflow, got %d packets", len(burst))
+	}
+}
+
+func TestRewriteBurst(t *testing.T) {
+	burst := []*rtp.Packet{
+		newTestPacket(10, 3000, 1),
+		newTestPacket(11, 3000, 1),
+		newTestPacket(12, 6000, 1),
+	}
+
+	t.Run("live starts new frame", func(t *testing.T) {
+		live := newTestPacket(500, 9000, 1)
+		out := rewriteBurst(burst, live)
+
+		wantSeq := []uint16{497, 498, 499}
+		wantTS := []uint32{8998, 8998, 8999}
+		for i := range out {
+			if out[i].SequenceNumber != wantSeq[i] {
+				t.Errorf("packet %d: seq = %d, want %d", i, out[i].SequenceNumber, wantSeq[i])
+			}
+			if out[i].Timestamp != wantTS[i] {
+				t.Errorf("packet %d: timestamp = %d, want %d", i, out[i].Timestamp, wantTS[i])
+			}
+		}
+	})
+
+	t.Run("live continues cached frame", func(t *testing.T) {
+		live := newTestPacket(13, 6000, 1)
+		out := rewriteBurst(burst, live)
+
+		wantTS := []uint32{5999, 5999, 6000}
+		for i := range out {
+			if out[i].Timestamp != wantTS[i] {
+				t.Errorf("packet %d: timestamp = %d, want %d", i, out[i].Timestamp, wantTS[i])
+			}
+		}
+	})
+
+	t.Run("cache is not modified", func(t *testing.T) {
+		_ = rewriteBurst(burst, newTestPacket(500, 9000, 1))
+		if burst[0].SequenceNumber != 10 || burst[0].Timestamp != 3000 {
+			t.Error("rewriteBurst must not modify cached packets")
+		}
+	})
+}
+
+func TestGOPReplay_FirstPacketOnly(t *testing.T) {
+	cache := newGOPCache(GOPCacheConfig{})
+	cache.reset()
+	keyframe := newTestPacket(10, 3000, 1)
+	live := newTestPacket(11, 6000, 1)
+	cache.add(keyframe)
+	cache.add(live)
+
+	var received []rtp.Packet
+	replay := newGOPReplay(cache, func(pkt *rtp.Packet) {
+		received = append(received, *pkt)
+	})
+
+	replay.handlePacket(live)
+	replay.handlePacket(newTestPacket(12, 9000, 1))
+
+	// Burst (keyframe) + live + next live
+	if len(received) != 3 {
+		t.Fatalf("expected 3 packets, got %d", len(received))
+	}
+	if received[0].SequenceNumber != 10 {
+		t.Errorf("burst seq = %d, want 10", received[0].SequenceNumber)
+	}
+	if received[1].SequenceNumber != 11 || received[2].SequenceNumber != 12 {
+		t.Error("live packets should pass through unchanged")
+	}
+}
+
+func TestGOPReplay_Recovery(t *testing.T) {
+	cache := newGOPCache(GOPCacheConfig{})
+	cache.reset()
+	gop := []*rtp.Packet{
+		newTestPacket(10, 3000, 1), // keyframe
+		newTestPacket(11, 6000, 1),
+		newTestPacket(12, 9000, 1),
+	}
+	for _, pkt := range gop {
+		cache.add(pkt)
+	}
+
+	var received []rtp.Packet
+	replay := newGOPReplay(cache, func(pkt *rtp.Packet) {
+		received = append(received, *pkt)
+	})
+
+	replay.handlePacket(gop[0])
+	replay.handlePacket(gop[1])
+	replay.requestRecovery()
+	replay.handlePacket(gop[2])
+	replay.handlePacket(newTestPacket(13, 12000, 1))
+
+	// keyframe, 11, recovery burst (10, 11), 12, 13
+	wantSeq := []uint16{10, 11, 12, 13, 14, 15}
+	if len(received) != len(wantSeq) {
+		t.Fatalf("expected %d packets, got %d", len(wantSeq), len(received))
+	}
+	for i, want := range wantSeq {
+		if received[i].SequenceNumber != want {
+			t.Errorf("packet %d: seq = %d, want %d", i, received[i].SequenceNumber, want)
+		}
+	}
+	if received[2].Timestamp != received[3].Timestamp-1 {
+		t.Errorf("recovery burst should be compressed before live frame, got ts %d and %d", received[2].Timestamp, received[3].Timestamp)
+	}
+	if gop[2].SequenceNumber != 12 {
+		t.Error("shifting live packets must not modify the shared packet")
+	}
+}
+
+func BenchmarkGOPCache_Add(b *testing.B) {
+	cache := newGOPCache(GOPCacheConfig{})
+	packet := newTestPacket(1, 1000, 1200)
+
+	b.ReportAllocs()
+	i := 0
+	for b.Loop() {
+		if i%1000 == 0 {
+			cache.reset()
+		}
+		cache.add(packet)
+		i++
+	}
+}
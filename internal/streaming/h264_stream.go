@@ -13,9 +13,13 @@ import (
 // it injects SPS/PPS from the codec's fmtp line before the first IDR frame.
 type h264StreamHandler struct {
 	handler     func(*rtp.Packet)
+	onKeyframe  func() // optional, called before the first packet of each keyframe
 	sps, pps    []byte
 	payloadType uint8
-	sentPS      bool // true once we've seen or injected SPS/PPS
+	sentPS      bool   // true once we've seen or injected SPS/PPS
+	sawIDR      bool   // true once an IDR picture was forwarded
+	idrTS       uint32 // RTP timestamp of the last IDR picture
+	injected    packetSlab
 }
 
 func newH264StreamHandler(codec *core.Codec, handler func(*rtp.Packet)) *h264StreamHandler {
@@ -39,26 +43,26 @@ func (h *h264StreamHandler) handlePacket(packet *rtp.Packet) {
 	// This helps Firefox/OpenH264 recover after packet loss.
 	switch nalType {
 	case 7, 8: // SPS or PPS in stream - pass through, skip injection for this IDR
+		if !h.sentPS {
+			h.keyframeStart()
+		}
 		h.sentPS = true
 	case 24: // STAP-A - if it contains SPS/PPS, skip injection for this IDR
 		if h.stapAContainsPS(packet.Payload) {
+			if !h.sentPS {
+				h.keyframeStart()
+			}
 			h.sentPS = true
 		}
 	case 5: // IDR frame - inject SPS/PPS before it (unless just received in-band)
-		if !h.sentPS {
-			h.injectParameterSets(packet)
-		}
-		h.sentPS = false // Reset so we inject again on next IDR
+		h.idrStart(packet)
 	case 28: // FU-A - check if start of IDR
 		if len(packet.Payload) >= 2 {
 			fuHeader := packet.Payload[1]
 			isStart := fuHeader&0x80 != 0
 			fragNalType := fuHeader & 0x1F
 			if isStart && fragNalType == 5 {
-				if !h.sentPS {
-					h.injectParameterSets(packet)
-				}
-				h.sentPS = false // Reset for next IDR
+				h.idrStart(packet)
 			}
 		}
 	}
@@ -66,6 +70,32 @@ func (h *h264StreamHandler) handlePacket(packet *rtp.Packet) {
 	h.handler(packet)
 }
 
+// idrStart injects SPS/PPS before an IDR picture if none were just received
+// in-band, then resets so the next IDR gets them again. An IDR picture may be
+// split into several slices sharing one RTP timestamp; only its first slice
+// starts the keyframe.
+func (h *h264StreamHandler) idrStart(packet *rtp.Packet) {
+	if h.sawIDR && packet.Timestamp == h.idrTS {
+		return // later slice of the same picture
+	}
+	h.sawIDR, h.idrTS = true, packet.Timestamp
+
+	if !h.sentPS {
+		h.keyframeStart()
+		h.injectParameterSets(packet)
+	}
+	h.sentPS = false // Reset so we inject again on next IDR
+}
+
+// keyframeStart notifies the keyframe hook, if any. A keyframe begins with
+// its parameter sets (in-band or injected), or with the IDR itself when
+// none are available.
+func (h *h264StreamHandler) keyframeStart() {
+	if h.onKeyframe != nil {
+		h.onKeyframe()
+	}
+}
+
 // stapAContainsPS checks if a STAP-A packet contains SPS or PPS.
 func (h *h264StreamHandler) stapAContainsPS(payload []byte) bool {
 	offset := 1
@@ -95,18 +125,39 @@ func (h *h264StreamHandler) injectParameterSets(template *rtp.Packet) {
 }
 
 func (h *h264StreamHandler) sendNAL(template *rtp.Packet, nal []byte) {
-	pkt := &rtp.Packet{
-		Header: rtp.Header{
-			Version:     2,
-			PayloadType: h.payloadType,
-			Timestamp:   template.Timestamp,
-			SSRC:        template.SSRC,
-		},
-		Payload: nal,
+	pkt := h.injected.next()
+	pkt.Header = rtp.Header{
+		Version:        2,
+		PayloadType:    h.payloadType,
+		SequenceNumber: template.SequenceNumber,
+		Timestamp:      template.Timestamp,
+		SSRC:           template.SSRC,
 	}
+	pkt.Payload = nal
 	h.handler(pkt)
 }
 
+// packetSlabSize is the number of injected packets allocated at once.
+const packetSlabSize = 64
+
+// packetSlab hands out packets for injected parameter sets from a
+// preallocated block, so keyframes don't allocate. Slots are never reused:
+// injected packets are shared with the GOP cache and per-peer send queues,
+// which may hold them for a while. A block is freed once all its packets are
+// released.
+type packetSlab struct {
+	free []rtp.Packet
+}
+
+func (s *packetSlab) next() *rtp.Packet {
+	if len(s.free) == 0 {
+		s.free = make([]rtp.Packet, packetSlabSize)
+	}
+	pkt := &s.free[0]
+	s.free = s.free[1:]
+	return pkt
+}
+
 // parseSpsPps extracts SPS and PPS from the codec's fmtp line.
 func parseSpsPps(fmtpLine string) (sps, pps []byte) {
 	const prefix = "sprop-parameter-sets="
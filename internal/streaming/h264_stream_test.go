@@ -1,6 +1,7 @@
 package streaming
 
 import (
+	"slices"
 	"testing"
 
 	"github.com/AlexxIT/go2rtc/pkg/core"
@@ -377,3 +378,110 @@ func TestH264StreamHandler_StapAContainsPS(t *testing.T) {
 		t.Error("stapAContainsPS should return false for STAP-A without SPS/PPS")
 	}
 }
+
+func TestH264StreamHandler_OnKeyframe(t *testing.T) {
+	codec := &core.Codec{
+		Name:        core.CodecH264,
+		PayloadType: 96,
+		FmtpLine:    "sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA==",
+	}
+
+	var events []string
+	handler := newH264StreamHandler(codec, func(_ *rtp.Packet) {
+		events = append(events, "packet")
+	})
+	handler.onKeyframe = func() {
+		events = append(events, "keyframe")
+	}
+
+	// In-band SPS + PPS + IDR: hook fires once, before the SPS
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{0x67, 0x42}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{0x68, 0xce}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{0x65, 0x00}})
+	// P-frame: no hook
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 2000}, Payload: []byte{0x01, 0x00}})
+	// IDR without in-band SPS/PPS: hook fires before injected parameter sets
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 3000}, Payload: []byte{0x65, 0x00}})
+
+	want := []string{
+		"keyframe", "packet", "packet", "packet",
+		"packet",
+		"keyframe", "packet", "packet", "packet",
+	}
+	if len(events) != len(want) {
+		t.Fatalf("events = %v, want %v", events, want)
+	}
+	for i := range want {
+		if events[i] != want[i] {
+			t.Fatalf("events = %v, want %v", events, want)
+		}
+	}
+}
+
+func TestH264StreamHandler_MultiSliceIDR(t *testing.T) {
+	codec := &core.Codec{
+		Name:        core.CodecH264,
+		PayloadType: 96,
+		FmtpLine:    "sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA==",
+	}
+
+	var events []string
+	handler := newH264StreamHandler(codec, func(pkt *rtp.Packet) {
+		events = append(events, map[byte]string{7: "sps", 8: "pps", 5: "idr", 28: "fu-a"}[pkt.Payload[0]&0x1F])
+	})
+	handler.onKeyframe = func() {
+		events = append(events, "keyframe")
+	}
+
+	// Two single-NAL IDR slices of one picture, then a second picture
+	// whose slices are FU-A fragmented
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{0x65, 0x88}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{0x65, 0x00}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 4000}, Payload: []byte{0x7C, 0x85, 0x88}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 4000}, Payload: []byte{0x7C, 0x45, 0x00}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 4000}, Payload: []byte{0x7C, 0x85, 0x00}})
+
+	want := []string{
+		"keyframe", "sps", "pps", "idr", "idr",
+		"keyframe", "sps", "pps", "fu-a", "fu-a", "fu-a",
+	}
+	if !slices.Equal(events, want) {
+		t.Errorf("events = %v, want %v", events, want)
+	}
+}
+
+func newBenchH264Handler() *h264StreamHandler {
+	codec := &core.Codec{
+		Name:        core.CodecH264,
+		PayloadType: 96,
+		FmtpLine:    "sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA==",
+	}
+	return newH264StreamHandler(codec, func(*rtp.Packet) {})
+}
+
+func BenchmarkH264StreamHandler_Passthrough(b *testing.B) {
+	handler := newBenchH264Handler()
+	packet := &rtp.Packet{
+		Header:  rtp.Header{Timestamp: 1000},
+		Payload: append([]byte{0x7C, 0x01}, make([]byte, 1200)...), // FU-A continuation of a P slice
+	}
+
+	b.ReportAllocs()
+	for b.Loop() {
+		handler.handlePacket(packet)
+	}
+}
+
+func BenchmarkH264StreamHandler_IDRInjection(b *testing.B) {
+	handler := newBenchH264Handler()
+	packet := &rtp.Packet{
+		Header:  rtp.Header{Timestamp: 1000},
+		Payload: append([]byte{0x7C, 0x85}, make([]byte, 1200)...), // FU-A start of an IDR
+	}
+
+	b.ReportAllocs()
+	for b.Loop() {
+		packet.Timestamp += 3000 // a new picture each time
+		handler.handlePacket(packet)
+	}
+}
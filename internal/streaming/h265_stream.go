@@ -0,0 +1,183 @@
+package streaming
+
+import (
+	"encoding/base64"
+	"strings"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// H265 NAL unit types (RFC 7798).
+const (
+	h265NALIRAPFirst = 16 // BLA_W_LP
+	h265NALIRAPLast  = 23 // RSV_IRAP_VCL23
+	h265NALVPS       = 32
+	h265NALSPS       = 33
+	h265NALPPS       = 34
+	h265NALAP        = 48 // Aggregation packet
+	h265NALFU        = 49 // Fragmentation unit
+)
+
+// h265StreamHandler provides RTP passthrough for H265 with VPS/SPS/PPS injection.
+// It forwards packets directly without reassembly. For late-joining clients,
+// it injects VPS/SPS/PPS from the codec's fmtp line before every IRAP picture.
+type h265StreamHandler struct {
+	handler       func(*rtp.Packet)
+	onKeyframe    func() // optional, called before the first packet of each keyframe
+	vps, sps, pps []byte
+	payloadType   uint8
+	sentPS        bool   // true once we've seen or injected parameter sets
+	sawIRAP       bool   // true once an IRAP picture was forwarded
+	irapTS        uint32 // RTP timestamp of the last IRAP picture
+	injected      packetSlab
+}
+
+func newH265StreamHandler(codec *core.Codec, handler func(*rtp.Packet)) *h265StreamHandler {
+	vps, sps, pps := parseVpsSpsPps(codec.FmtpLine)
+	return &h265StreamHandler{
+		handler:     handler,
+		vps:         vps,
+		sps:         sps,
+		pps:         pps,
+		payloadType: codec.PayloadType,
+	}
+}
+
+func (h *h265StreamHandler) handlePacket(packet *rtp.Packet) {
+	if len(packet.Payload) < 2 {
+		return
+	}
+
+	nalType := h265NALType(packet.Payload[0])
+
+	// Inject VPS/SPS/PPS before EVERY IRAP picture, mirroring the H264 handler.
+	switch {
+	case isH265ParameterSet(nalType): // Parameter set in stream - skip injection for this IRAP
+		if !h.sentPS {
+			h.keyframeStart()
+		}
+		h.sentPS = true
+	case nalType == h265NALAP: // AP - if it contains parameter sets, skip injection for this IRAP
+		if h.apContainsPS(packet.Payload) {
+			if !h.sentPS {
+				h.keyframeStart()
+			}
+			h.sentPS = true
+		}
+	case isH265IRAP(nalType): // IRAP picture - inject parameter sets (unless just received in-band)
+		h.irapStart(packet)
+	case nalType == h265NALFU: // FU - check if start of IRAP
+		if len(packet.Payload) >= 3 {
+			fuHeader := packet.Payload[2]
+			isStart := fuHeader&0x80 != 0
+			if isStart && isH265IRAP(fuHeader&0x3F) {
+				h.irapStart(packet)
+			}
+		}
+	}
+
+	h.handler(packet)
+}
+
+// irapStart injects parameter sets before an IRAP picture if none were just
+// received in-band, then resets so the next IRAP gets them again. Only the
+// first slice segment of a picture starts the keyframe; later ones share its
+// RTP timestamp.
+func (h *h265StreamHandler) irapStart(packet *rtp.Packet) {
+	if h.sawIRAP && packet.Timestamp == h.irapTS {
+		return // later slice segment of the same picture
+	}
+	h.sawIRAP, h.irapTS = true, packet.Timestamp
+
+	if !h.sentPS {
+		h.keyframeStart()
+		h.injectParameterSets(packet)
+	}
+	h.sentPS = false
+}
+
+// keyframeStart notifies the keyframe hook, if any.
+func (h *h265StreamHandler) keyframeStart() {
+	if h.onKeyframe != nil {
+		h.onKeyframe()
+	}
+}
+
+// apContainsPS checks if an aggregation packet contains VPS, SPS or PPS.
+// Assumes no DONL fields (sprop-max-don-diff is 0, as FFmpeg sends).
+func (h *h265StreamHandler) apContainsPS(payload []byte) bool {
+	offset := 2
+	for offset+2 <= len(payload) {
+		nalSize := int(payload[offset])<<8 | int(payload[offset+1])
+		offset += 2
+		if offset+nalSize > len(payload) || nalSize == 0 {
+			break
+		}
+		if isH265ParameterSet(h265NALType(payload[offset])) {
+			return true
+		}
+		offset += nalSize
+	}
+	return false
+}
+
+func (h *h265StreamHandler) injectParameterSets(template *rtp.Packet) {
+	for _, nal := range [][]byte{h.vps, h.sps, h.pps} {
+		if len(nal) > 0 {
+			h.sendNAL(template, nal)
+		}
+	}
+	h.sentPS = true
+}
+
+func (h *h265StreamHandler) sendNAL(template *rtp.Packet, nal []byte) {
+	pkt := h.injected.next()
+	pkt.Header = rtp.Header{
+		Version:        2,
+		PayloadType:    h.payloadType,
+		SequenceNumber: template.SequenceNumber,
+		Timestamp:      template.Timestamp,
+		SSRC:           template.SSRC,
+	}
+	pkt.Payload = nal
+	h.handler(pkt)
+}
+
+// h265NALType extracts the NAL unit type from the first NAL header byte.
+func h265NALType(b byte) byte {
+	return (b >> 1) & 0x3F
+}
+
+func isH265IRAP(nalType byte) bool {
+	return nalType >= h265NALIRAPFirst && nalType <= h265NALIRAPLast
+}
+
+func isH265ParameterSet(nalType byte) bool {
+	return nalType == h265NALVPS || nalType == h265NALSPS || nalType == h265NALPPS
+}
+
+// parseVpsSpsPps extracts VPS, SPS and PPS from the codec's fmtp line.
+func parseVpsSpsPps(fmtpLine string) (vps, sps, pps []byte) {
+	return parseSprop(fmtpLine, "sprop-vps="),
+		parseSprop(fmtpLine, "sprop-sps="),
+		parseSprop(fmtpLine, "sprop-pps=")
+}
+
+// parseSprop decodes a single base64 sprop parameter from an fmtp line.
+// Only the first parameter set is used when several are comma-separated.
+func parseSprop(fmtpLine, prefix string) []byte {
+	_, value, found := strings.Cut(fmtpLine, prefix)
+	if !found {
+		return nil
+	}
+	if semi := strings.Index(value, ";"); semi >= 0 {
+		value = value[:semi]
+	}
+	if comma := strings.Index(value, ","); comma >= 0 {
+		value = value[:comma]
+	}
+
+	nal, _ := base64.StdEncoding.DecodeString(value)
+	return nal
+}
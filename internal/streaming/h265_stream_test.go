@@ -0,0 +1,174 @@
+package streaming
+
+import (
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+const testH265Fmtp = "sprop-vps=QAEMAQ==;sprop-sps=QgEBAQ==;sprop-pps=RAHBcg=="
+
+func newTestH265Handler(received *[]*rtp.Packet) *h265StreamHandler {
+	codec := &core.Codec{
+		Name:        core.CodecH265,
+		PayloadType: 103,
+		FmtpLine:    testH265Fmtp,
+	}
+	return newH265StreamHandler(codec, func(pkt *rtp.Packet) {
+		clone := *pkt
+		clone.Payload = append([]byte{}, pkt.Payload...)
+		*received = append(*received, &clone)
+	})
+}
+
+func TestParseVpsSpsPps(t *testing.T) {
+	vps, sps, pps := parseVpsSpsPps(testH265Fmtp)
+
+	tests := []struct {
+		name string
+		nal  []byte
+		want byte
+	}{
+		{"VPS", vps, h265NALVPS},
+		{"SPS", sps, h265NALSPS},
+		{"PPS", pps, h265NALPPS},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if len(tt.nal) == 0 {
+				t.Fatalf("%s should not be empty", tt.name)
+			}
+			if got := h265NALType(tt.nal[0]); got != tt.want {
+				t.Errorf("%s NAL type = %d, want %d", tt.name, got, tt.want)
+			}
+		})
+	}
+
+	if vps, sps, pps := parseVpsSpsPps("profile-id=1"); vps != nil || sps != nil || pps != nil {
+		t.Error("expected nil parameter sets for fmtp without sprop")
+	}
+}
+
+func TestH265StreamHandler_Passthrough(t *testing.T) {
+	var received []*rtp.Packet
+	handler := newTestH265Handler(&received)
+
+	// TRAIL_R (type 1) - should pass through directly
+	handler.handlePacket(&rtp.Packet{
+		Header:  rtp.Header{Timestamp: 1000},
+		Payload: []byte{0x02, 0x01, 0x00},
+	})
+
+	if len(received) != 1 {
+		t.Fatalf("Expected 1 packet, got %d", len(received))
+	}
+}
+
+func TestH265StreamHandler_IRAPInjection(t *testing.T) {
+	var received []*rtp.Packet
+	handler := newTestH265Handler(&received)
+
+	// IDR_W_RADL (type 19) single NAL packet
+	handler.handlePacket(&rtp.Packet{
+		Header:  rtp.Header{Timestamp: 1000, Marker: true},
+		Payload: []byte{19 << 1, 0x01, 0x00},
+	})
+
+	// Should receive VPS + SPS + PPS + IDR = 4 packets
+	if len(received) != 4 {
+		t.Fatalf("Expected 4 packets (VPS, SPS, PPS, IDR), got %d", len(received))
+	}
+	want := []byte{h265NALVPS, h265NALSPS, h265NALPPS, 19}
+	for i, w := range want {
+		if got := h265NALType(received[i].Payload[0]); got != w {
+			t.Errorf("packet %d: NAL type = %d, want %d", i, got, w)
+		}
+		if received[i].Timestamp != 1000 {
+			t.Errorf("packet %d: timestamp = %d, want 1000", i, received[i].Timestamp)
+		}
+	}
+	if received[0].Marker || received[1].Marker || received[2].Marker {
+		t.Error("Parameter sets should not have marker bit")
+	}
+
+	// CRA (type 21) as the next IRAP should inject again
+	handler.handlePacket(&rtp.Packet{Payload: []byte{21 << 1, 0x01, 0x00}})
+	if len(received) != 8 {
+		t.Fatalf("Expected 8 packets (second IRAP should inject), got %d", len(received))
+	}
+}
+
+func TestH265StreamHandler_FUInjection(t *testing.T) {
+	var received []*rtp.Packet
+	handler := newTestH265Handler(&received)
+
+	// FU start fragment of IDR_N_LP (type 20)
+	handler.handlePacket(&rtp.Packet{Payload: []byte{h265NALFU << 1, 0x01, 0x80 | 20, 0x00}})
+	if len(received) != 4 {
+		t.Fatalf("Expected 4 packets (VPS, SPS, PPS, FU start), got %d", len(received))
+	}
+
+	// Continuation fragment should not inject
+	handler.handlePacket(&rtp.Packet{Payload: []byte{h265NALFU << 1, 0x01, 0x40 | 20, 0x00}})
+	if len(received) != 5 {
+		t.Fatalf("Expected 5 packets total, got %d", len(received))
+	}
+
+	// FU start of a non-IRAP picture should not inject
+	handler.handlePacket(&rtp.Packet{Payload: []byte{h265NALFU << 1, 0x01, 0x80 | 1, 0x00}})
+	if len(received) != 6 {
+		t.Fatalf("Expected 6 packets total, got %d", len(received))
+	}
+}
+
+func TestH265StreamHandler_APWithParameterSets(t *testing.T) {
+	var received []*rtp.Packet
+	handler := newTestH265Handler(&received)
+
+	vps := []byte{0x40, 0x01, 0x0c}
+	sps := []byte{0x42, 0x01, 0x01}
+	ap := []byte{h265NALAP << 1, 0x01}
+	ap = append(ap, byte(len(vps)>>8), byte(len(vps)))
+	ap = append(ap, vps...)
+	ap = append(ap, byte(len(sps)>>8), byte(len(sps)))
+	ap = append(ap, sps...)
+
+	if !handler.apContainsPS(ap) {
+		t.Fatal("apContainsPS should return true for AP with VPS/SPS")
+	}
+
+	handler.handlePacket(&rtp.Packet{Payload: ap})
+	handler.handlePacket(&rtp.Packet{Payload: []byte{19 << 1, 0x01, 0x00}})
+
+	// AP + IDR, no injection because AP carried parameter sets
+	if len(received) != 2 {
+		t.Fatalf("Expected 2 packets (AP + IDR, no injection), got %d", len(received))
+	}
+
+	// AP without parameter sets
+	slice := []byte{0x02, 0x01, 0x00}
+	apNoPS := []byte{h265NALAP << 1, 0x01, byte(len(slice) >> 8), byte(len(slice))}
+	apNoPS = append(apNoPS, slice...)
+	if handler.apContainsPS(apNoPS) {
+		t.Error("apContainsPS should return false for AP without parameter sets")
+	}
+}
+
+func TestH265StreamHandler_MultiSliceIRAP(t *testing.T) {
+	var received []*rtp.Packet
+	handler := newTestH265Handler(&received)
+
+	// Two slice segments of one IDR picture: parameter sets once
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{19 << 1, 0x01, 0x80}})
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 1000}, Payload: []byte{19 << 1, 0x01, 0x00}})
+	if len(received) != 5 {
+		t.Fatalf("Expected 5 packets (VPS, SPS, PPS, two slices), got %d", len(received))
+	}
+
+	// FU start of the next IRAP picture injects again
+	handler.handlePacket(&rtp.Packet{Header: rtp.Header{Timestamp: 4000}, Payload: []byte{h265NALFU << 1, 0x01, 0x80 | 21, 0x00}})
+	if len(received) != 9 {
+		t.Fatalf("Expected 9 packets (next IRAP should inject), got %d", len(received))
+	}
+}
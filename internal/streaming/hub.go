@@ -2,11 +2,15 @@ package streaming
 
 import (
 	"errors"
+	"slices"
+	"strings"
 	"sync"
+	"time"
 
 	"github.com/AlexxIT/go2rtc/pkg/core"
 	"github.com/AlexxIT/go2rtc/pkg/rtsp"
 	"github.com/AlexxIT/go2rtc/pkg/webrtc"
+	"github.com/pion/rtcp"
 	"github.com/pion/rtp"
 	"github.com/smazurov/videonode/internal/logging"
 )
@@ -14,25 +18,77 @@ import (
 // ErrStreamNotFound is returned when a requested stream doesn't exist.
 var ErrStreamNotFound = errors.New("stream not found")
 
+// ErrTrackNotFound is returned when a stream has no relayable track of the
+// requested media kind.
+var ErrTrackNotFound = errors.New("track not found")
+
+// DefaultProducerHandoverTimeout is how long WebRTC consumers of a stream are
+// kept after its producer disconnects, waiting for a replacement (FFmpeg
+// restart) to continue their stream.
+const DefaultProducerHandoverTimeout = 10 * time.Second
+
 // Hub manages stream producers and routes consumers to them.
-// Producers are RTSP connections from FFmpeg (ANNOUNCE).
+// Producers are RTSP connections from FFmpeg (ANNOUNCE), or slates the hub
+// plays itself while a stream has no live producer (see PlaySlate).
 // Consumers are RTSP clients (DESCRIBE) or WebRTC peers.
 type Hub struct {
-	producers          map[string]*rtsp.Conn
+	producers          map[string]producer
+	fanouts            map[string]map[string]*trackFanout // streamID -> media kind -> fan-out
+	handovers          map[string]*producerHandover       // streams waiting for a replacement producer
+	handoverTimeout    time.Duration
 	mu                 sync.RWMutex
 	logger             logging.Logger
 	onProducerReplaced func(streamID string)
+	gopCacheResolver   func(streamID string) (GOPCacheConfig, bool)
+	onFirstPacket      func(streamID string)
+	replays            map[core.Consumer][]*gopReplay // GOP replays per wired WebRTC consumer
+	upstreams          map[string]string              // relayed streams -> upstream URL
+	audioSources       map[string]*core.Receiver      // audio captured outside the producer (see SetAudioSource)
+	latencyTracing     bool                           // trace frame latency (see SetLatencyTracing)
+	timelines          map[string]*streamTimeline     // latency tracing per stream
 }
 
 // NewHub creates a new stream hub.
 func NewHub(logger logging.Logger) *Hub {
 	return &Hub{
-		producers: make(map[string]*rtsp.Conn),
-		logger:    logger,
+		producers:       make(map[string]producer),
+		fanouts:         make(map[string]map[string]*trackFanout),
+		handovers:       make(map[string]*producerHandover),
+		handoverTimeout: DefaultProducerHandoverTimeout,
+		replays:         make(map[core.Consumer][]*gopReplay),
+		upstreams:       make(map[string]string),
+		audioSources:    make(map[string]*core.Receiver),
+		timelines:       make(map[string]*streamTimeline),
+		logger:          logger,
 	}
 }
 
-// SetOnProducerReplaced sets the callback invoked when a producer is replaced or removed.
+// producer is a stream's media source.
+type producer interface {
+	// tracks returns the producer's media tracks.
+	tracks() []*core.Receiver
+	// stop disconnects the producer.
+	stop()
+}
+
+// rtspProducer is an FFmpeg RTSP connection publishing a stream.
+type rtspProducer struct {
+	conn *rtsp.Conn
+}
+
+func (p rtspProducer) tracks() []*core.Receiver { return p.conn.Receivers }
+
+func (p rtspProducer) stop() { _ = p.conn.Stop() }
+
+// producerHandover tracks a stream whose producer disconnected while WebRTC
+// consumers were attached.
+type producerHandover struct {
+	timer *time.Timer
+}
+
+// SetOnProducerReplaced sets the callback invoked when WebRTC consumers of a
+// stream can't be carried over to a new producer: the codec or profile
+// changed, or no producer returned within the handover timeout.
 // This allows notifying WebRTC consumers to reconnect.
 func (h *Hub) SetOnProducerReplaced(callback func(streamID string)) {
 	h.mu.Lock()
@@ -40,19 +96,60 @@ func (h *Hub) SetOnProducerReplaced(callback func(streamID string)) {
 	h.onProducerReplaced = callback
 }
 
+// SetGOPCacheResolver sets the lookup for per-stream GOP cache settings.
+// The resolver is consulted when a producer's first WebRTC consumer is wired;
+// returning false disables the cache for that stream.
+func (h *Hub) SetGOPCacheResolver(resolver func(streamID string) (GOPCacheConfig, bool)) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	h.gopCacheResolver = resolver
+}
+
+// SetLatencyTracing enables tracing the latency of video frames from capture
+// to the browser. Producers anchor capture times with RTCP sender reports
+// (see ProducerRTCP). Call before serving producers and consumers.
+func (h *Hub) SetLatencyTracing(enabled bool) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	h.latencyTracing = enabled
+}
+
+// SetOnFirstPacket sets the callback invoked when an RTSP producer delivers
+// its first packet after connecting, marking the stream live. Startup
+// latency is measured up to here.
+func (h *Hub) SetOnFirstPacket(callback func(streamID string)) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	h.onFirstPacket = callback
+}
+
 // AddProducer registers an RTSP producer (FFmpeg pushing via ANNOUNCE).
+// If the stream already has WebRTC consumers and the new producer announces
+// compatible codecs, the consumers are kept and continue on the new producer
+// once it is ready (see ProducerReady). Otherwise they are closed.
 func (h *Hub) AddProducer(streamID string, conn *rtsp.Conn) {
 	h.mu.Lock()
 
 	// Close existing producer if any
-	var callback func(streamID string)
 	if existing, ok := h.producers[streamID]; ok {
 		h.logger.Info("Replacing existing producer", "stream_id", streamID)
-		_ = existing.Stop()
-		callback = h.onProducerReplaced
+		existing.stop()
+		h.detachFanoutsLocked(streamID)
 	}
+	h.cancelHandoverLocked(streamID)
 
-	h.producers[streamID] = conn
+	var callback func(streamID string)
+	if len(h.fanouts[streamID]) > 0 {
+		if h.announcesCompatibleLocked(streamID, conn) {
+			h.logger.Info("Handing over consumers to new producer", "stream_id", streamID)
+		} else {
+			h.logger.Info("Producer codecs changed, closing consumers", "stream_id", streamID)
+			h.closeFanoutsLocked(streamID)
+			callback = h.onProducerReplaced
+		}
+	}
+
+	h.producers[streamID] = rtspProducer{conn}
 	h.logger.Debug("Producer added", "stream_id", streamID)
 	h.mu.Unlock()
 
@@ -62,16 +159,80 @@ func (h *Hub) AddProducer(streamID string, conn *rtsp.Conn) {
 	}
 }
 
-// RemoveProducer removes a producer from the hub.
-func (h *Hub) RemoveProducer(streamID string) {
+// ProducerReady attaches a stream's existing fan-outs to a producer's tracks.
+// Call once the producer has set up its tracks (RTSP RECORD accepted), before
+// it starts sending media.
+func (h *Hub) ProducerReady(streamID string, conn *rtsp.Conn) {
+	h.mu.Lock()
+
+	if h.producers[streamID] != producer(rtspProducer{conn}) {
+		h.mu.Unlock()
+		return
+	}
+	if h.onFirstPacket != nil {
+		watchFirstPacket(streamID, conn.Receivers, h.onFirstPacket)
+	}
+	if len(h.fanouts[streamID]) == 0 {
+		h.mu.Unlock()
+		return
+	}
+
+	callback := h.attachFanoutsLocked(streamID, h.streamTracksLocked(streamID, rtspProducer{conn}), false)
+	h.mu.Unlock()
+
+	if callback != nil {
+		go callback(streamID)
+	}
+}
+
+// watchFirstPacket invokes callback once, for the first packet on any of a
+// producer's tracks.
+func watchFirstPacket(streamID string, tracks []*core.Receiver, callback func(streamID string)) {
+	var once sync.Once
+	senders := make([]*core.Sender, 0, len(tracks))
+	for _, receiver := range tracks {
+		media := &core.Media{
+			Kind:      core.GetKind(receiver.Codec.Name),
+			Direction: core.DirectionSendonly,
+			Codecs:    []*core.Codec{receiver.Codec},
+		}
+		sender := core.NewSender(media, receiver.Codec)
+		sender.Handler = func(*rtp.Packet) {
+			once.Do(func() {
+				// Closing from the handler would wait on itself
+				go func() {
+					for _, s := range senders {
+						s.Close()
+					}
+					callback(streamID)
+				}()
+			})
+		}
+		senders = append(senders, sender)
+	}
+	for i, sender := range senders {
+		sender.HandleRTP(tracks[i])
+	}
+}
+
+// RemoveProducer removes a producer from the hub, unless it was already
+// replaced by a newer one. WebRTC consumers are kept for the handover
+// timeout, so a restarted producer can continue their stream.
+func (h *Hub) RemoveProducer(streamID string, conn *rtsp.Conn) {
 	h.mu.Lock()
 
 	var callback func(streamID string)
-	if conn, ok := h.producers[streamID]; ok {
+	if h.producers[streamID] == producer(rtspProducer{conn}) {
 		_ = conn.Stop()
 		delete(h.producers, streamID)
-		callback = h.onProducerReplaced
 		h.logger.Info("Producer removed", "stream_id", streamID)
+
+		if len(h.fanouts[streamID]) > 0 {
+			h.detachFanoutsLocked(streamID)
+			h.startHandoverLocked(streamID)
+		} else {
+			callback = h.onProducerReplaced
+		}
 	}
 	h.mu.Unlock()
 
@@ -81,13 +242,188 @@ func (h *Hub) RemoveProducer(streamID string) {
 	}
 }
 
-// GetProducer returns the producer for a stream ID.
+// attachFanoutsLocked continues a stream's fan-outs on a new producer's
+// tracks, or closes them and returns the replacement callback if the tracks
+// can't continue them. With optionalAudio, audio fan-outs without a matching
+// track stay detached (silent) instead. Caller must hold h.mu.
+func (h *Hub) attachFanoutsLocked(streamID string, tracks []*core.Receiver, optionalAudio bool) func(streamID string) {
+	receivers := make(map[string]*core.Receiver, len(h.fanouts[streamID]))
+	compatible := true
+	for kind, fanout := range h.fanouts[streamID] {
+		receiver := findReceiver(tracks, kind)
+		if receiver == nil && optionalAudio && kind == core.KindAudio {
+			continue
+		}
+		if receiver == nil || !codecsCompatible(fanout.out.Codec, receiver.Codec) {
+			compatible = false
+			break
+		}
+		receivers[kind] = receiver
+	}
+
+	if !compatible {
+		h.logger.Info("Producer tracks changed, closing consumers", "stream_id", streamID)
+		h.closeFanoutsLocked(streamID)
+		return h.onProducerReplaced
+	}
+
+	for kind, receiver := range receivers {
+		h.fanouts[streamID][kind].attach(receiver)
+	}
+	h.logger.Info("Producer handover complete", "stream_id", streamID, "tracks", len(receivers))
+	return nil
+}
+
+// startHandoverLocked arms the timer that closes a stream's consumers if no
+// producer returns in time. Caller must hold h.mu.
+func (h *Hub) startHandoverLocked(streamID string) {
+	h.cancelHandoverLocked(streamID)
+
+	handover := &producerHandover{}
+	handover.timer = time.AfterFunc(h.handoverTimeout, func() {
+		h.expireHandover(streamID, handover)
+	})
+	h.handovers[streamID] = handover
+	h.logger.Debug("Waiting for producer handover", "stream_id", streamID, "timeout", h.handoverTimeout)
+}
+
+// cancelHandoverLocked stops a pending handover timer. Caller must hold h.mu.
+func (h *Hub) cancelHandoverLocked(streamID string) {
+	if handover, ok := h.handovers[streamID]; ok {
+		handover.timer.Stop()
+		delete(h.handovers, streamID)
+	}
+}
+
+func (h *Hub) expireHandover(streamID string, handover *producerHandover) {
+	h.mu.Lock()
+	if h.handovers[streamID] != handover {
+		h.mu.Unlock()
+		return // cancelled or superseded
+	}
+	delete(h.handovers, streamID)
+	h.closeFanoutsLocked(streamID)
+	callback := h.onProducerReplaced
+	h.mu.Unlock()
+
+	h.logger.Info("No producer returned, closing consumers", "stream_id", streamID)
+	if callback != nil {
+		callback(streamID)
+	}
+}
+
+// announcesCompatibleLocked reports whether a new producer's announced media
+// can continue every fan-out of a stream. Audio is not required of streams
+// with a separate audio source. Caller must hold h.mu.
+func (h *Hub) announcesCompatibleLocked(streamID string, conn *rtsp.Conn) bool {
+	for kind, fanout := range h.fanouts[streamID] {
+		if kind == core.KindAudio && h.audioSources[streamID] != nil {
+			continue
+		}
+		found := false
+		for _, media := range conn.Medias {
+			if media.Kind == kind && len(media.Codecs) > 0 && codecsCompatible(fanout.out.Codec, media.Codecs[0]) {
+				found = true
+				break
+			}
+		}
+		if !found {
+			return false
+		}
+	}
+	return true
+}
+
+// findReceiver returns the first producer track of a media kind.
+func findReceiver(receivers []*core.Receiver, kind string) *core.Receiver {
+	for _, receiver := range receivers {
+		if core.GetKind(receiver.Codec.Name) == kind {
+			return receiver
+		}
+	}
+	return nil
+}
+
+// GetProducer returns the RTSP producer for a stream ID, or nil if the
+// stream has none (including while it plays a slate).
 func (h *Hub) GetProducer(streamID string) *rtsp.Conn {
+	h.mu.RLock()
+	defer h.mu.RUnlock()
+	if prod, ok := h.producers[streamID].(rtspProducer); ok {
+		return prod.conn
+	}
+	return nil
+}
+
+// getProducer returns the active producer of a stream, or nil.
+func (h *Hub) getProducer(streamID string) producer {
 	h.mu.RLock()
 	defer h.mu.RUnlock()
 	return h.producers[streamID]
 }
 
+// getProducerTracks returns the active producer of a stream and the
+// stream's tracks (see streamTracksLocked), or nil.
+func (h *Hub) getProducerTracks(streamID string) (producer, []*core.Receiver) {
+	h.mu.RLock()
+	defer h.mu.RUnlock()
+	prod := h.producers[streamID]
+	if prod == nil {
+		return nil, nil
+	}
+	return prod, h.streamTracksLocked(streamID, prod)
+}
+
+// streamTracksLocked returns a producer's tracks, plus the stream's separate
+// audio source when the producer has no audio of its own. Caller must hold
+// h.mu.
+func (h *Hub) streamTracksLocked(streamID string, prod producer) []*core.Receiver {
+	tracks := prod.tracks()
+	audio := h.audioSources[streamID]
+	if audio == nil || findReceiver(tracks, core.KindAudio) != nil {
+		return tracks
+	}
+	return append(slices.Clip(tracks), audio)
+}
+
+// SetAudioSource publishes receiver as a stream's audio track, for audio
+// captured separately from the stream's producer (native ALSA capture). It
+// is used while the producer has no audio track of its own, survives
+// producer restarts and slates, and continues the stream's existing audio
+// consumers.
+func (h *Hub) SetAudioSource(streamID string, receiver *core.Receiver) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+
+	h.audioSources[streamID] = receiver
+	fanout := h.fanouts[streamID][core.KindAudio]
+	if fanout == nil {
+		return
+	}
+	if prod := h.producers[streamID]; prod != nil && findReceiver(prod.tracks(), core.KindAudio) != nil {
+		return // the producer's own audio takes precedence
+	}
+	if codecsCompatible(fanout.out.Codec, receiver.Codec) {
+		fanout.attach(receiver)
+	}
+}
+
+// RemoveAudioSource removes a stream's separate audio source, unless it was
+// already replaced. Audio consumers stay attached and go silent until a
+// new source is set.
+func (h *Hub) RemoveAudioSource(streamID string, receiver *core.Receiver) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+
+	if h.audioSources[streamID] != receiver {
+		return
+	}
+	delete(h.audioSources, streamID)
+	if fanout := h.fanouts[streamID][core.KindAudio]; fanout != nil && fanout.source == receiver {
+		fanout.detach()
+	}
+}
+
 // HasProducer checks if a producer exists for the given stream ID.
 func (h *Hub) HasProducer(streamID string) bool {
 	h.mu.RLock()
@@ -99,10 +435,7 @@ func (h *Hub) HasProducer(streamID string) bool {
 // WireConsumer connects a consumer to a producer's tracks.
 // The consumer will receive all media tracks from the producer.
 func (h *Hub) WireConsumer(streamID string, cons core.Consumer) error {
-	h.mu.RLock()
-	prod := h.producers[streamID]
-	h.mu.RUnlock()
-
+	prod, tracks := h.getProducerTracks(streamID)
 	if prod == nil {
 		return ErrStreamNotFound
 	}
@@ -110,16 +443,26 @@ func (h *Hub) WireConsumer(streamID string, cons core.Consumer) error {
 	consumerMedias := cons.GetMedias()
 	h.logger.Debug("WireConsumer", "stream_id", streamID, "consumer_medias_count", len(consumerMedias))
 
-	// If consumer has no medias (RTSP playback), add all producer tracks directly
+	// If consumer has no medias (RTSP playback), add all producer tracks.
+	// RTP tracks go through the fan-out, which rewrites producer packets in
+	// place and so must be their only reader
 	if len(consumerMedias) == 0 {
-		for _, receiver := range prod.Receivers {
+		for _, receiver := range tracks {
+			source := receiver
+			if supportsFanout(receiver.Codec) {
+				fanout := h.getFanout(streamID, prod, receiver)
+				if fanout == nil {
+					return ErrStreamNotFound // producer replaced while wiring
+				}
+				source = fanout.out
+			}
 			// Construct media from codec (avoids deprecated receiver.Media)
 			media := &core.Media{
-				Kind:      core.GetKind(receiver.Codec.Name),
+				Kind:      core.GetKind(source.Codec.Name),
 				Direction: core.DirectionRecvonly,
-				Codecs:    []*core.Codec{receiver.Codec},
+				Codecs:    []*core.Codec{source.Codec},
 			}
-			if err := cons.AddTrack(media, receiver.Codec, receiver); err != nil {
+			if err := cons.AddTrack(media, source.Codec, source); err != nil {
 				h.logger.Warn("Failed to add track", "error", err)
 			}
 		}
@@ -130,7 +473,7 @@ func (h *Hub) WireConsumer(streamID string, cons core.Consumer) error {
 	webrtcConn, isWebRTC := cons.(*webrtc.Conn)
 
 	// Match producer tracks to consumer medias by kind (for WebRTC)
-	for _, receiver := range prod.Receivers {
+	for _, receiver := range tracks {
 		// Find matching consumer media by kind (video/audio)
 		receiverKind := core.GetKind(receiver.Codec.Name)
 		var matchedMedia *core.Media
@@ -159,34 +502,55 @@ func (h *Hub) WireConsumer(streamID string, cons core.Consumer) error {
 			continue
 		}
 
+		// Consumers attach to the shared fan-out instead of the producer track,
+		// so they survive producer restarts. For H264/H265 the fan-out also
+		// parses each packet once per stream for WebRTC RTP passthrough
+		source := receiver
+		var fanout *trackFanout
+		if supportsFanout(receiver.Codec) {
+			fanout = h.getFanout(streamID, prod, receiver)
+			if fanout == nil {
+				return ErrStreamNotFound // producer replaced while wiring
+			}
+			source = fanout.out
+		}
+		passthrough := isWebRTC && fanout != nil && supportsPassthrough(receiver.Codec)
+
 		// Track sender count for RTP passthrough optimization
 		var senderCountBefore int
 		if isWebRTC {
 			senderCountBefore = len(webrtcConn.Senders)
 		}
 
-		if err := cons.AddTrack(matchedMedia, consumerCodec, receiver); err != nil {
+		if err := cons.AddTrack(matchedMedia, consumerCodec, source); err != nil {
 			h.logger.Warn("Failed to add track", "stream_id", streamID, "error", err)
 			continue
 		}
 
-		// H264 RTP passthrough: skip depay/repay when source is already RTP
-		// Uses zero-copy forwarding with SPS/PPS injection
-		if isWebRTC && receiver.Codec.IsRTP() &&
-			receiver.Codec.Name == core.CodecH264 &&
-			len(webrtcConn.Senders) > senderCountBefore {
+		// Skip depay/repay when source is already RTP: the fan-out has already
+		// injected parameter sets, so the per-peer handler only writes the packet
+		if passthrough && len(webrtcConn.Senders) > senderCountBefore {
 			sender := webrtcConn.Senders[len(webrtcConn.Senders)-1]
 			localTrack := webrtcConn.GetSenderTrack(matchedMedia.ID)
 			payloadType := consumerCodec.PayloadType
+			counters := newStreamSendCounters(streamID)
 
 			if localTrack != nil {
-				streamHandler := newH264StreamHandler(receiver.Codec, func(packet *rtp.Packet) {
-					size := packet.MarshalSize()
+				write := func(packet *rtp.Packet) {
+					size := packet.MarshalSize() // computed from header fields, no marshalling
 					webrtcConn.Send += size
-					IncrementPacketsSent(streamID, size)
+					counters.add(size)
 					_ = localTrack.WriteRTP(payloadType, packet)
-				})
-				sender.Handler = streamHandler.handlePacket
+				}
+				if fanout.cache != nil {
+					replay := newGOPReplay(fanout.cache, write)
+					h.mu.Lock()
+					h.replays[cons] = append(h.replays[cons], replay)
+					h.mu.Unlock()
+					sender.Handler = replay.handlePacket
+				} else {
+					sender.Handler = write
+				}
 			}
 		}
 	}
@@ -194,6 +558,261 @@ func (h *Hub) WireConsumer(streamID string, cons core.Consumer) error {
 	return nil
 }
 
+// UnwireConsumer releases per-consumer state kept by WireConsumer.
+// Call when the consumer disconnects.
+func (h *Hub) UnwireConsumer(cons core.Consumer) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	delete(h.replays, cons)
+}
+
+// RecoverConsumer replays the cached GOP to a consumer before its next live
+// packet, so it can decode again after loss without waiting for the next
+// keyframe. Returns false if the consumer's stream has no GOP cache.
+func (h *Hub) RecoverConsumer(cons core.Consumer) bool {
+	h.mu.RLock()
+	replays := h.replays[cons]
+	h.mu.RUnlock()
+
+	for _, replay := range replays {
+		replay.requestRecovery()
+	}
+	return len(replays) > 0
+}
+
+// TrackAttachment is a consumer handler attached to a stream's fan-out with
+// AttachTrack.
+type TrackAttachment struct {
+	// Codec is the stream's codec for the track. It stays the same while the
+	// attachment lives; incompatible producers close the stream's consumers.
+	Codec *core.Codec
+
+	sender *core.Sender
+	replay *gopReplay // nil when the stream has no GOP cache
+}
+
+// AttachTrack feeds a stream's track of the given media kind to handler,
+// through the same fan-out WebRTC consumers use. Unlike WireConsumer it
+// doesn't need a core.Consumer: callers that manage their own RTP tracks
+// (bundled peers) write the packets themselves. Packets are shared with other
+// consumers and must be treated as read-only.
+func (h *Hub) AttachTrack(streamID, kind string, handler func(*rtp.Packet)) (*TrackAttachment, error) {
+	prod, tracks := h.getProducerTracks(streamID)
+	if prod == nil {
+		return nil, ErrStreamNotFound
+	}
+
+	receiver := findReceiver(tracks, kind)
+	if receiver == nil || !supportsFanout(receiver.Codec) {
+		return nil, ErrTrackNotFound
+	}
+
+	fanout := h.getFanout(streamID, prod, receiver)
+	if fanout == nil {
+		return nil, ErrStreamNotFound // producer replaced while attaching
+	}
+
+	attachment := &TrackAttachment{
+		Codec:  fanout.out.Codec,
+		sender: core.NewSender(fanout.media, fanout.out.Codec),
+	}
+	if fanout.cache != nil {
+		attachment.replay = newGOPReplay(fanout.cache, handler)
+		attachment.sender.Handler = attachment.replay.handlePacket
+	} else {
+		attachment.sender.Handler = handler
+	}
+	attachment.sender.HandleRTP(fanout.out)
+	return attachment, nil
+}
+
+// Recover replays the cached GOP before the next live packet, like
+// RecoverConsumer. Returns false if the stream has no GOP cache.
+func (a *TrackAttachment) Recover() bool {
+	if a.replay == nil {
+		return false
+	}
+	a.replay.requestRecovery()
+	return true
+}
+
+// Close stops feeding the handler.
+func (a *TrackAttachment) Close() {
+	a.sender.Close()
+}
+
+// getFanout returns the shared fan-out for a producer track's media kind,
+// creating it on first use. Returns nil if prod is no longer the stream's
+// active producer.
+func (h *Hub) getFanout(streamID string, prod producer, receiver *core.Receiver) *trackFanout {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+
+	if h.producers[streamID] != prod {
+		return nil
+	}
+
+	tracks := h.fanouts[streamID]
+	if tracks == nil {
+		tracks = make(map[string]*trackFanout)
+		h.fanouts[streamID] = tracks
+	}
+
+	kind := core.GetKind(receiver.Codec.Name)
+	fanout, ok := tracks[kind]
+	if ok {
+		if !codecsCompatible(fanout.out.Codec, receiver.Codec) {
+			return nil // ProducerReady closes the old consumers
+		}
+		fanout.attach(receiver) // no-op unless wired before ProducerReady
+	} else {
+		var cacheConfig *GOPCacheConfig
+		if h.gopCacheResolver != nil {
+			if config, enabled := h.gopCacheResolver(streamID); enabled {
+				cacheConfig = &config
+			}
+		}
+		var timeline *streamTimeline
+		if kind == core.KindVideo {
+			timeline = h.timelineLocked(streamID)
+		}
+		fanout = newTrackFanout(receiver, cacheConfig, timeline)
+		tracks[kind] = fanout
+		h.logger.Debug("Fan-out created", "stream_id", streamID, "codec", receiver.Codec.Name, "gop_cache", cacheConfig != nil)
+	}
+	return fanout
+}
+
+// latencyTracingEnabled reports whether SetLatencyTracing enabled tracing.
+func (h *Hub) latencyTracingEnabled() bool {
+	h.mu.RLock()
+	defer h.mu.RUnlock()
+	return h.latencyTracing
+}
+
+// latencyTimeline returns the latency timeline of a stream, nil unless
+// latency tracing is enabled.
+func (h *Hub) latencyTimeline(streamID string) *streamTimeline {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	return h.timelineLocked(streamID)
+}
+
+// timelineLocked returns the latency timeline of a stream, creating it.
+// Returns nil unless latency tracing is enabled. Caller must hold h.mu.
+func (h *Hub) timelineLocked(streamID string) *streamTimeline {
+	if !h.latencyTracing {
+		return nil
+	}
+	timeline, ok := h.timelines[streamID]
+	if !ok {
+		timeline = newStreamTimeline(streamID)
+		h.timelines[streamID] = timeline
+	}
+	return timeline
+}
+
+// ProducerRTCP handles RTCP an RTSP producer sent on an interleaved channel.
+// Sender reports for the video track anchor its capture clock for latency
+// tracing. Ignored unless latency tracing is enabled and conn is the stream's
+// producer.
+func (h *Hub) ProducerRTCP(streamID string, conn *rtsp.Conn, channel byte, packets []rtcp.Packet) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+
+	if h.producers[streamID] != producer(rtspProducer{conn}) {
+		return
+	}
+	timeline := h.timelineLocked(streamID)
+	if timeline == nil {
+		return
+	}
+	for _, receiver := range conn.Receivers {
+		// RTCP is interleaved on the channel after its track's RTP
+		if receiver.ID+1 != channel || core.GetKind(receiver.Codec.Name) != core.KindVideo {
+			continue
+		}
+		for _, packet := range packets {
+			if report, ok := packet.(*rtcp.SenderReport); ok {
+				timeline.senderReport(receiver, report)
+			}
+		}
+	}
+}
+
+// detachFanoutsLocked detaches a stream's fan-outs from its producer, keeping
+// their consumers. Audio from a separate audio source keeps playing. Caller
+// must hold h.mu.
+func (h *Hub) detachFanoutsLocked(streamID string) {
+	audio := h.audioSources[streamID]
+	for _, fanout := range h.fanouts[streamID] {
+		if audio != nil && fanout.source == audio {
+			continue
+		}
+		fanout.detach()
+	}
+}
+
+// closeFanoutsLocked detaches all fan-outs of a stream and forgets them.
+// Caller must hold h.mu.
+func (h *Hub) closeFanoutsLocked(streamID string) {
+	for _, fanout := range h.fanouts[streamID] {
+		fanout.Close()
+	}
+	delete(h.fanouts, streamID)
+}
+
+// Stream origins reported by LiveStreams.
+const (
+	OriginLocal = "local" // published by FFmpeg on this node
+	OriginRelay = "relay" // pulled from an upstream node
+	OriginSlate = "slate" // slate looped by the hub while the stream has no signal
+)
+
+// LiveStream is a stream with a producer in the hub.
+type LiveStream struct {
+	StreamID string
+	Origin   string   // OriginLocal, OriginRelay or OriginSlate
+	Upstream string   // source URL of relayed streams
+	Codecs   []string // of the producer's tracks
+}
+
+// LiveStreams returns the streams with a producer, sorted by ID, and where
+// each one originates.
+func (h *Hub) LiveStreams() []LiveStream {
+	h.mu.RLock()
+	defer h.mu.RUnlock()
+
+	live := make([]LiveStream, 0, len(h.producers))
+	for id, prod := range h.producers {
+		stream := LiveStream{StreamID: id, Origin: OriginLocal}
+		if _, ok := prod.(*slateProducer); ok {
+			stream.Origin = OriginSlate
+		} else if upstream, ok := h.upstreams[id]; ok {
+			stream.Origin = OriginRelay
+			stream.Upstream = upstream
+		}
+		for _, receiver := range h.streamTracksLocked(id, prod) {
+			stream.Codecs = append(stream.Codecs, receiver.Codec.Name)
+		}
+		live = append(live, stream)
+	}
+	slices.SortFunc(live, func(a, b LiveStream) int { return strings.Compare(a.StreamID, b.StreamID) })
+	return live
+}
+
+// setUpstream marks a stream as relayed from url, or as local with an empty
+// url.
+func (h *Hub) setUpstream(streamID, url string) {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	if url == "" {
+		delete(h.upstreams, streamID)
+	} else {
+		h.upstreams[streamID] = url
+	}
+}
+
 // ListStreams returns a list of all active stream IDs.
 func (h *Hub) ListStreams() []string {
 	h.mu.RLock()
@@ -211,9 +830,14 @@ func (h *Hub) Stop() {
 	h.mu.Lock()
 	defer h.mu.Unlock()
 
-	for id, conn := range h.producers {
-		_ = conn.Stop()
+	for id, prod := range h.producers {
+		prod.stop()
 		delete(h.producers, id)
+		h.closeFanoutsLocked(id)
+	}
+	for id := range h.handovers {
+		h.cancelHandoverLocked(id)
+		h.closeFanoutsLocked(id)
 	}
 	h.logger.Info("Hub stopped")
 }
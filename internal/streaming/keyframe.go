@@ -0,0 +1,88 @@
+package streaming
+
+import (
+	"sync"
+	"time"
+)
+
+// DefaultKeyframeRequestInterval is the minimum time between keyframe
+// recoveries for one stream. PLI/FIR arriving within the interval are
+// coalesced into the next recovery.
+const DefaultKeyframeRequestInterval = time.Second
+
+// keyframeRequests coalesces PLI/FIR from all peers of a stream and
+// rate-limits them. The first request after a quiet period fires at once; any
+// request during the cooldown is deferred to the end of it, so a request is
+// never lost and a loss burst across many peers costs one recovery.
+type keyframeRequests struct {
+	interval time.Duration
+	fire     func(streamID string, peerIDs []string)
+	mu       sync.Mutex
+	streams  map[string]*keyframeState
+}
+
+type keyframeState struct {
+	last  time.Time
+	peers map[string]struct{} // peers that requested since the last recovery
+	timer *time.Timer         // non-nil while a recovery is scheduled
+}
+
+func newKeyframeRequests(interval time.Duration, fire func(streamID string, peerIDs []string)) *keyframeRequests {
+	return &keyframeRequests{
+		interval: interval,
+		fire:     fire,
+		streams:  make(map[string]*keyframeState),
+	}
+}
+
+// request records a keyframe request from a peer.
+func (k *keyframeRequests) request(streamID, peerID string) {
+	k.mu.Lock()
+	defer k.mu.Unlock()
+
+	state, ok := k.streams[streamID]
+	if !ok {
+		state = &keyframeState{peers: make(map[string]struct{})}
+		k.streams[streamID] = state
+	}
+	state.peers[peerID] = struct{}{}
+
+	if state.timer != nil {
+		return // coalesced into the scheduled recovery
+	}
+
+	wait := max(k.interval-time.Since(state.last), 0)
+	state.timer = time.AfterFunc(wait, func() { k.flush(streamID, state) })
+}
+
+// flush fires a scheduled recovery with every peer that requested it.
+func (k *keyframeRequests) flush(streamID string, state *keyframeState) {
+	k.mu.Lock()
+	if k.streams[streamID] != state {
+		k.mu.Unlock()
+		return // stream removed while the timer was pending
+	}
+	peerIDs := make([]string, 0, len(state.peers))
+	for peerID := range state.peers {
+		peerIDs = append(peerIDs, peerID)
+	}
+	clear(state.peers)
+	state.timer = nil
+	state.last = time.Now()
+	k.mu.Unlock()
+
+	k.fire(streamID, peerIDs)
+}
+
+// remove drops state for a stream with no remaining peers.
+func (k *keyframeRequests) remove(streamID string) {
+	k.mu.Lock()
+	defer k.mu.Unlock()
+
+	if state, ok := k.streams[streamID]; ok {
+		if state.timer != nil {
+			state.timer.Stop()
+		}
+		delete(k.streams, streamID)
+	}
+}
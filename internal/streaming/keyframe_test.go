@@ -0,0 +1,66 @@
+package streaming
+
+import (
+	"sort"
+	"sync"
+	"testing"
+	"time"
+)
+
+func TestKeyframeRequests_CoalesceAndRateLimit(t *testing.T) {
+	var mu sync.Mutex
+	var fired [][]string
+	done := make(chan struct{}, 4)
+
+	requests := newKeyframeRequests(50*time.Millisecond, func(_ string, peerIDs []string) {
+		sort.Strings(peerIDs)
+		mu.Lock()
+		fired = append(fired, peerIDs)
+		mu.Unlock()
+		done <- struct{}{}
+	})
+
+	// First request after a quiet period fires immediately
+	requests.request("cam", "a")
+	<-done
+
+	// Requests during the cooldown collapse into a single deferred recovery
+	start := time.Now()
+	requests.request("cam", "b")
+	requests.request("cam", "c")
+	requests.request("cam", "b")
+	<-done
+	if elapsed := time.Since(start); elapsed < 30*time.Millisecond {
+		t.Errorf("deferred recovery fired after %v, expected to wait for the cooldown", elapsed)
+	}
+
+	mu.Lock()
+	defer mu.Unlock()
+	if len(fired) != 2 {
+		t.Fatalf("expected 2 recoveries, got %d", len(fired))
+	}
+	if len(fired[0]) != 1 || fired[0][0] != "a" {
+		t.Errorf("first recovery peers = %v, want [a]", fired[0])
+	}
+	if len(fired[1]) != 2 || fired[1][0] != "b" || fired[1][1] != "c" {
+		t.Errorf("second recovery peers = %v, want [b c]", fired[1])
+	}
+}
+
+func TestKeyframeRequests_Remove(t *testing.T) {
+	fired := make(chan struct{}, 2)
+	requests := newKeyframeRequests(50*time.Millisecond, func(string, []string) {
+		fired <- struct{}{}
+	})
+
+	requests.request("cam", "a")
+	<-fired
+	requests.request("cam", "b") // deferred
+	requests.remove("cam")
+
+	select {
+	case <-fired:
+		t.Error("removed stream should not fire a pending recovery")
+	case <-time.After(100 * time.Millisecond):
+	}
+}
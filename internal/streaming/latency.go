@@ -0,0 +1,395 @@
+package streaming
+
+import (
+	"errors"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/interceptor"
+	"github.com/pion/rtcp"
+	"github.com/pion/rtp"
+	"github.com/prometheus/client_golang/prometheus"
+	"github.com/prometheus/client_golang/prometheus/promauto"
+)
+
+// Glass-to-glass latency tracing follows each video frame from capture to the
+// browser's screen:
+//
+//   - FFmpeg stamps V4L2 capture times into RTP timestamps, and its RTCP
+//     sender reports map those timestamps to wallclock (see
+//     ffmpeg.Params.CaptureTimestamps).
+//   - The hub's fan-out records when each frame arrives (encode stage).
+//   - Each peer's latency interceptor records when the frame is sent (hub
+//     stage) and adds the abs-capture-time RTP header extension, so browsers
+//     can relate frames to their capture time.
+//   - The browser player reports when frames were received, decoded and
+//     displayed (network, decode and render stages), on the server's clock.
+
+// absCaptureTimeURI is the RTP header extension carrying a frame's capture
+// time (http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time).
+const absCaptureTimeURI = "http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time"
+
+// frameRingSize is how many recent frames a timeline remembers, about 8
+// seconds at 30 fps, enough for the browser's batched reports.
+const frameRingSize = 256
+
+// ntpEpochOffset is the number of seconds from the NTP epoch (1900) to the
+// Unix epoch.
+const ntpEpochOffset = 2208988800
+
+// ErrLatencyTracingDisabled is returned for latency reports of peers that
+// aren't traced.
+var ErrLatencyTracingDisabled = errors.New("latency tracing disabled")
+
+// Latency stages, in the order a frame passes them.
+const (
+	latencyStageEncode       = iota // capture to hub ingest: capture queue, encoder and RTSP push
+	latencyStageHub                 // hub ingest to WebRTC send
+	latencyStageNetwork             // WebRTC send to browser receive
+	latencyStageDecode              // browser decode
+	latencyStageRender              // decoded to displayed: jitter buffer and compositor
+	latencyStageGlassToGlass        // capture to displayed
+	latencyStageCount
+)
+
+var latencyStageNames = [latencyStageCount]string{"encode", "hub", "network", "decode", "render", "glass_to_glass"}
+
+// Per-stream latency distribution of each stage.
+var latencySeconds = promauto.NewHistogramVec(prometheus.HistogramOpts{
+	Namespace: "videonode",
+	Subsystem: "latency",
+	Name:      "stage_seconds",
+	Help:      "Video frame latency per stream and stage (encode, hub, network, decode, render, glass_to_glass)",
+	Buckets:   prometheus.ExponentialBuckets(0.001, 2, 12), // 1ms to 2s
+}, []string{"stream_id", "stage"})
+
+// LatencySample is when a browser received and displayed a frame, on the
+// server's clock.
+type LatencySample struct {
+	RTPTimestamp uint32        // RTP timestamp of the frame as sent to the browser
+	Received     time.Time     // Last packet of the frame received
+	Decode       time.Duration // Time spent decoding, 0 if not reported
+	Displayed    time.Time     // Frame presented
+}
+
+// frameTiming is when a video frame was captured and reached the hub and a
+// peer. Times are wallclock; zero if unknown.
+type frameTiming struct {
+	timestamp uint32 // RTP timestamp on the hub's output stream
+	capture   time.Time
+	ingest    time.Time
+	send      time.Time
+}
+
+// frameRing remembers the timings of the most recent frames.
+type frameRing struct {
+	frames [frameRingSize]frameTiming
+	next   int
+	count  int
+}
+
+func (r *frameRing) add(timing frameTiming) {
+	r.frames[r.next] = timing
+	r.next = (r.next + 1) % frameRingSize
+	r.count = min(r.count+1, frameRingSize)
+}
+
+// find returns the timing of the frame with an RTP timestamp, searching from
+// the newest.
+func (r *frameRing) find(timestamp uint32) (frameTiming, bool) {
+	for i := 1; i <= r.count; i++ {
+		timing := r.frames[(r.next-i+frameRingSize)%frameRingSize]
+		if timing.timestamp == timestamp {
+			return timing, true
+		}
+	}
+	return frameTiming{}, false
+}
+
+// captureClock maps RTP timestamps of a producer track to wallclock, from the
+// RTP and NTP timestamps of the track's latest RTCP sender report.
+type captureClock struct {
+	clockRate uint32
+	ntp       time.Time // zero until the first report
+	rtpTime   uint32
+}
+
+func (c *captureClock) senderReport(ntpTime uint64, rtpTime uint32) {
+	c.ntp = ntpToTime(ntpTime)
+	c.rtpTime = rtpTime
+}
+
+// captureTime returns the wallclock of an RTP timestamp. Timestamps within
+// 2^31 ticks of the report, before or after it, are mapped across
+// wraparound.
+func (c *captureClock) captureTime(timestamp uint32) (time.Time, bool) {
+	if c.ntp.IsZero() || c.clockRate == 0 {
+		return time.Time{}, false
+	}
+	ticks := int64(int32(timestamp - c.rtpTime))
+	return c.ntp.Add(time.Duration(ticks * int64(time.Second) / int64(c.clockRate))), true
+}
+
+// ntpToTime converts a 64-bit NTP timestamp to time.
+func ntpToTime(ntp uint64) time.Time {
+	seconds := int64(ntp>>32) - ntpEpochOffset
+	nanos := int64((ntp & 0xFFFFFFFF) * 1e9 >> 32)
+	return time.Unix(seconds, nanos)
+}
+
+// streamTimeline traces the video frames of a stream through the hub.
+// It outlives producers and fan-outs, so peers keep their timeline across
+// restarts.
+type streamTimeline struct {
+	stages [latencyStageCount]prometheus.Observer
+
+	mu           sync.Mutex
+	anchorSource *core.Receiver // track the capture clock belongs to
+	clock        captureClock
+	frames       frameRing
+	traced       bool
+	lastTS       uint32
+}
+
+func newStreamTimeline(streamID string) *streamTimeline {
+	t := &streamTimeline{}
+	for stage, name := range latencyStageNames {
+		t.stages[stage] = latencySeconds.WithLabelValues(streamID, name)
+	}
+	return t
+}
+
+// observe records a stage latency. Negative latencies, from clocks that
+// disagree, are dropped.
+func (t *streamTimeline) observe(stage int, latency time.Duration) {
+	if latency >= 0 {
+		t.stages[stage].Observe(latency.Seconds())
+	}
+}
+
+// senderReport anchors the capture clock of a producer track.
+func (t *streamTimeline) senderReport(source *core.Receiver, report *rtcp.SenderReport) {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	if t.anchorSource != source {
+		t.anchorSource = source
+		t.clock = captureClock{clockRate: source.Codec.ClockRate}
+	}
+	t.clock.senderReport(report.NTPTime, report.RTPTime)
+}
+
+// ingest records the arrival of a packet from a producer track, published
+// with outputTS. The first packet of each frame starts its timing.
+func (t *streamTimeline) ingest(source *core.Receiver, sourceTS, outputTS uint32, now time.Time) {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	if t.traced && outputTS == t.lastTS {
+		return
+	}
+	t.traced = true
+	t.lastTS = outputTS
+
+	timing := frameTiming{timestamp: outputTS, ingest: now}
+	if source != nil && source == t.anchorSource {
+		if capture, ok := t.clock.captureTime(sourceTS); ok {
+			timing.capture = capture
+			t.observe(latencyStageEncode, now.Sub(capture))
+		}
+	}
+	t.frames.add(timing)
+}
+
+// frame returns the timing of a frame by its output RTP timestamp.
+func (t *streamTimeline) frame(timestamp uint32) (frameTiming, bool) {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	return t.frames.find(timestamp)
+}
+
+// peerFrames are the frames of one stream sent to a peer.
+type peerFrames struct {
+	timeline *streamTimeline
+	frames   frameRing
+	sent     bool
+	lastTS   uint32
+}
+
+// peerLatency traces the video frames sent to a WebRTC peer, so the stages
+// the browser reports can be matched to them.
+type peerLatency struct {
+	streamID      string                                // stream of a single-stream peer
+	streamForSSRC func(ssrc uint32) string              // streams of a bundle's tracks
+	timeline      func(streamID string) *streamTimeline // nil if the stream isn't traced
+
+	mu      sync.Mutex
+	streams map[string]*peerFrames
+}
+
+func newPeerLatency(streamID string, streamForSSRC func(ssrc uint32) string, timeline func(streamID string) *streamTimeline) *peerLatency {
+	return &peerLatency{
+		streamID:      streamID,
+		streamForSSRC: streamForSSRC,
+		timeline:      timeline,
+		streams:       make(map[string]*peerFrames),
+	}
+}
+
+// streamLocked returns the sent frames of a stream, nil if it isn't traced.
+// Caller must hold p.mu.
+func (p *peerLatency) streamLocked(streamID string) *peerFrames {
+	if streamID == "" {
+		return nil
+	}
+	frames, ok := p.streams[streamID]
+	if !ok {
+		timeline := p.timeline(streamID)
+		if timeline == nil {
+			return nil
+		}
+		frames = &peerFrames{timeline: timeline}
+		p.streams[streamID] = frames
+	}
+	return frames
+}
+
+// sent records a video packet sent on the track with ssrc, and returns the
+// timing of its frame when it is the frame's first packet. Frames older than
+// the newest one sent, such as GOP replays for recovery, aren't recorded.
+func (p *peerLatency) sent(ssrc, timestamp uint32, now time.Time) (frameTiming, bool) {
+	streamID := p.streamID
+	if p.streamForSSRC != nil {
+		streamID = p.streamForSSRC(ssrc)
+	}
+
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	frames := p.streamLocked(streamID)
+	if frames == nil || (frames.sent && int32(timestamp-frames.lastTS) <= 0) {
+		return frameTiming{}, false
+	}
+	frames.sent = true
+	frames.lastTS = timestamp
+
+	timing, ok := frames.timeline.frame(timestamp)
+	if !ok {
+		return frameTiming{}, false
+	}
+	timing.send = now
+	frames.timeline.observe(latencyStageHub, now.Sub(timing.ingest))
+	frames.frames.add(timing)
+	return timing, true
+}
+
+// report records the stages of frames the browser displayed. Samples for
+// frames no longer remembered are skipped.
+func (p *peerLatency) report(streamID string, samples []LatencySample) {
+	if streamID == "" || p.streamForSSRC == nil {
+		streamID = p.streamID
+	}
+
+	p.mu.Lock()
+	defer p.mu.Unlock()
+	frames := p.streamLocked(streamID)
+	if frames == nil {
+		return
+	}
+	timeline := frames.timeline
+	for _, sample := range samples {
+		timing, ok := frames.frames.find(sample.RTPTimestamp)
+		if !ok {
+			continue
+		}
+		timeline.observe(latencyStageNetwork, sample.Received.Sub(timing.send))
+		if sample.Decode > 0 {
+			timeline.observe(latencyStageDecode, sample.Decode)
+		}
+		timeline.observe(latencyStageRender, sample.Displayed.Sub(sample.Received)-sample.Decode)
+		if !timing.capture.IsZero() {
+			timeline.observe(latencyStageGlassToGlass, sample.Displayed.Sub(timing.capture))
+		}
+	}
+}
+
+// ReportLatency records the latency samples a browser reported for a
+// session. streamID selects the stream of a bundle session and is ignored
+// for single-stream sessions.
+func (m *WebRTCManager) ReportLatency(sessionID, streamID string, samples []LatencySample) error {
+	m.mu.RLock()
+	peer, ok := m.peers[sessionID]
+	m.mu.RUnlock()
+	if !ok {
+		return ErrSessionNotFound
+	}
+	if peer.latency == nil {
+		return ErrLatencyTracingDisabled
+	}
+	peer.latency.report(streamID, samples)
+	return nil
+}
+
+// latencyInterceptorFactory creates the latency interceptor of a peer.
+type latencyInterceptorFactory struct {
+	peer *peerLatency
+}
+
+// NewInterceptor creates a new latency interceptor.
+func (f *latencyInterceptorFactory) NewInterceptor(_ string) (interceptor.Interceptor, error) {
+	return &latencyInterceptor{peer: f.peer}, nil
+}
+
+// latencyInterceptor records when video frames leave for the peer and tags
+// their first packet with the frame's capture time.
+type latencyInterceptor struct {
+	interceptor.NoOp
+	peer *peerLatency
+}
+
+// BindLocalStream wraps the RTP writer of a video track.
+func (l *latencyInterceptor) BindLocalStream(info *interceptor.StreamInfo, writer interceptor.RTPWriter) interceptor.RTPWriter {
+	if !strings.HasPrefix(strings.ToLower(info.MimeType), "video/") {
+		return writer
+	}
+	w := &latencyWriter{writer: writer, peer: l.peer, ssrc: info.SSRC}
+	for _, ext := range info.RTPHeaderExtensions {
+		if ext.URI == absCaptureTimeURI {
+			w.captureTimeID = uint8(ext.ID)
+		}
+	}
+	return w
+}
+
+type latencyWriter struct {
+	writer        interceptor.RTPWriter
+	peer          *peerLatency
+	ssrc          uint32
+	captureTimeID uint8 // abs-capture-time extension ID, 0 if not negotiated
+	started       bool
+	lastTS        uint32
+}
+
+func (w *latencyWriter) Write(header *rtp.Header, payload []byte, attributes interceptor.Attributes) (int, error) {
+	if w.started && header.Timestamp == w.lastTS {
+		return w.writer.Write(header, payload, attributes)
+	}
+	w.started = true
+	w.lastTS = header.Timestamp
+
+	timing, ok := w.peer.sent(w.ssrc, header.Timestamp, time.Now())
+	if !ok || w.captureTimeID == 0 || timing.capture.IsZero() {
+		return w.writer.Write(header, payload, attributes)
+	}
+	extension, err := rtp.NewAbsCaptureTimeExtension(timing.capture).Marshal()
+	if err != nil {
+		return w.writer.Write(header, payload, attributes)
+	}
+
+	// The header is shared with the stream's other peers
+	tagged := *header
+	tagged.Extensions = append([]rtp.Extension(nil), header.Extensions...)
+	if err := tagged.SetExtension(w.captureTimeID, extension); err != nil {
+		return w.writer.Write(header, payload, attributes)
+	}
+	return w.writer.Write(&tagged, payload, attributes)
+}
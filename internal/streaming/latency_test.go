@@ -0,0 +1,191 @@
+package streaming
+
+import (
+	"testing"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/interceptor"
+	"github.com/pion/rtcp"
+	"github.com/pion/rtp"
+)
+
+// timeToNTP converts time to a 64-bit NTP timestamp.
+func timeToNTP(t time.Time) uint64 {
+	seconds := uint64(t.Unix() + ntpEpochOffset)
+	fraction := uint64(t.Nanosecond()) << 32 / 1e9
+	return seconds<<32 | fraction
+}
+
+func TestNTPToTime(t *testing.T) {
+	ntp := uint64(ntpEpochOffset+10)<<32 | 1<<31
+	if got, want := ntpToTime(ntp), time.Unix(10, 5e8); !got.Equal(want) {
+		t.Errorf("ntpToTime() = %v, want %v", got, want)
+	}
+
+	now := time.Unix(1760000000, 123456000)
+	if got := ntpToTime(timeToNTP(now)); got.Sub(now).Abs() > time.Microsecond {
+		t.Errorf("round trip = %v, want %v", got, now)
+	}
+}
+
+func TestCaptureClock(t *testing.T) {
+	anchor := time.Unix(1760000000, 0)
+	tests := []struct {
+		name      string
+		rtpTime   uint32
+		timestamp uint32
+		want      time.Duration
+	}{
+		{"at report", 1000, 1000, 0},
+		{"after report", 1000, 91000, time.Second},
+		{"before report", 10000, 1000, -100 * time.Millisecond},
+		{"across wraparound", 0xFFFFFF00, 0x100, 512 * time.Second / 90000},
+		{"before wraparound", 0x100, 0xFFFFFF00, -512 * time.Second / 90000},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			clock := captureClock{clockRate: 90000}
+			if _, ok := clock.captureTime(tt.timestamp); ok {
+				t.Fatal("captureTime() succeeded before a sender report")
+			}
+			clock.senderReport(timeToNTP(anchor), tt.rtpTime)
+			got, ok := clock.captureTime(tt.timestamp)
+			if !ok || got.Sub(anchor).Round(time.Microsecond) != tt.want.Round(time.Microsecond) {
+				t.Errorf("captureTime() = %v, want %v after the report", got.Sub(anchor), tt.want)
+			}
+		})
+	}
+}
+
+func TestFrameRing(t *testing.T) {
+	var ring frameRing
+	for ts := range uint32(frameRingSize + 10) {
+		ring.add(frameTiming{timestamp: ts * 3000})
+	}
+	if _, ok := ring.find(5 * 3000); ok {
+		t.Error("found a frame that was overwritten")
+	}
+	if timing, ok := ring.find((frameRingSize + 9) * 3000); !ok || timing.timestamp != (frameRingSize+9)*3000 {
+		t.Error("newest frame not found")
+	}
+	if _, ok := ring.find(10 * 3000); !ok {
+		t.Error("oldest kept frame not found")
+	}
+}
+
+func newTimelineTrack() *core.Receiver {
+	codec := &core.Codec{Name: core.CodecH264, ClockRate: 90000}
+	media := &core.Media{Kind: core.KindVideo, Direction: core.DirectionRecvonly, Codecs: []*core.Codec{codec}}
+	return core.NewReceiver(media, codec)
+}
+
+func TestLatencyTracingFollowsFrames(t *testing.T) {
+	timeline := newStreamTimeline("latency-test")
+	source := newTimelineTrack()
+	capture := time.Unix(1760000000, 0)
+	timeline.senderReport(source, &rtcp.SenderReport{NTPTime: timeToNTP(capture), RTPTime: 9000})
+
+	// Frames from the anchored track, published on the output stream's
+	// timestamps. Later packets of a frame keep the first arrival
+	ingest := capture.Add(40 * time.Millisecond)
+	timeline.ingest(source, 9000, 500, ingest)
+	timeline.ingest(source, 9000, 500, ingest.Add(time.Millisecond))
+	timeline.ingest(source, 12000, 3500, ingest.Add(33*time.Millisecond))
+	timeline.ingest(newTimelineTrack(), 80, 6500, ingest.Add(66*time.Millisecond))
+
+	timing, ok := timeline.frame(500)
+	if !ok || !timing.capture.Equal(capture) || !timing.ingest.Equal(ingest) {
+		t.Fatalf("frame 500 = %+v, want captured at %v and ingested at %v", timing, capture, ingest)
+	}
+	if timing, _ := timeline.frame(6500); !timing.capture.IsZero() {
+		t.Errorf("frame of an unanchored track has capture time %v", timing.capture)
+	}
+
+	peer := newPeerLatency("cam", nil, func(string) *streamTimeline { return timeline })
+	send := ingest.Add(2 * time.Millisecond)
+	if timing, ok := peer.sent(1, 500, send); !ok || !timing.send.Equal(send) || !timing.capture.Equal(capture) {
+		t.Errorf("sent(500) = %+v, %v", timing, ok)
+	}
+	if _, ok := peer.sent(1, 3500, send.Add(33*time.Millisecond)); !ok {
+		t.Error("sent(3500) found no frame")
+	}
+	if _, ok := peer.sent(1, 500, send.Add(40*time.Millisecond)); ok {
+		t.Error("a replayed older frame was recorded")
+	}
+	if _, ok := peer.sent(1, 99999, send.Add(50*time.Millisecond)); ok {
+		t.Error("sent() found a frame the hub never saw")
+	}
+
+	// Reports match the peer's sent frames
+	peer.report("", []LatencySample{
+		{RTPTimestamp: 500, Received: send.Add(5 * time.Millisecond), Decode: 3 * time.Millisecond, Displayed: send.Add(30 * time.Millisecond)},
+		{RTPTimestamp: 424242, Received: send, Displayed: send},
+	})
+	if frames := peer.streams["cam"]; frames == nil || frames.frames.count != 2 {
+		t.Errorf("peer frames = %+v, want the two sent frames", frames)
+	}
+}
+
+// headerRecorder is an RTP writer that keeps the headers written to it.
+type headerRecorder struct {
+	headers []rtp.Header
+}
+
+func (r *headerRecorder) Write(header *rtp.Header, payload []byte, _ interceptor.Attributes) (int, error) {
+	r.headers = append(r.headers, *header)
+	return len(payload), nil
+}
+
+func TestLatencyWriterTagsFirstPacketOfFrame(t *testing.T) {
+	timeline := newStreamTimeline("latency-test")
+	source := newTimelineTrack()
+	capture := time.Unix(1760000000, 0)
+	timeline.senderReport(source, &rtcp.SenderReport{NTPTime: timeToNTP(capture), RTPTime: 0})
+	timeline.ingest(source, 0, 700, time.Now())
+
+	peer := newPeerLatency("cam", nil, func(string) *streamTimeline { return timeline })
+	factory := &latencyInterceptorFactory{peer: peer}
+	latency, err := factory.NewInterceptor("")
+	if err != nil {
+		t.Fatal(err)
+	}
+	recorder := &headerRecorder{}
+	writer := latency.BindLocalStream(&interceptor.StreamInfo{
+		SSRC:                1,
+		MimeType:            "video/H264",
+		RTPHeaderExtensions: []interceptor.RTPHeaderExtension{{URI: absCaptureTimeURI, ID: 3}},
+	}, recorder)
+
+	shared := &rtp.Header{Version: 2, SequenceNumber: 1, Timestamp: 700}
+	for range 2 {
+		if _, err := writer.Write(shared, []byte{1}, nil); err != nil {
+			t.Fatal(err)
+		}
+	}
+
+	if len(recorder.headers) != 2 {
+		t.Fatalf("wrote %d packets, want 2", len(recorder.headers))
+	}
+	payload := recorder.headers[0].GetExtension(3)
+	var extension rtp.AbsCaptureTimeExtension
+	if err := extension.Unmarshal(payload); err != nil {
+		t.Fatalf("first packet has no capture time: %v", err)
+	}
+	if got := extension.CaptureTime(); got.Sub(capture).Abs() > time.Microsecond {
+		t.Errorf("capture time = %v, want %v", got, capture)
+	}
+	if recorder.headers[1].GetExtension(3) != nil {
+		t.Error("later packet of the frame is tagged too")
+	}
+	if shared.Extension || len(shared.Extensions) != 0 {
+		t.Error("tagging modified the shared header")
+	}
+
+	// Audio tracks pass through
+	audio := latency.BindLocalStream(&interceptor.StreamInfo{MimeType: "audio/opus"}, recorder)
+	if audio != interceptor.RTPWriter(recorder) {
+		t.Error("audio writer was wrapped")
+	}
+}
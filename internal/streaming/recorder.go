@@ -0,0 +1,940 @@
+package streaming
+
+import (
+	"bytes"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+	"github.com/prometheus/client_golang/prometheus"
+	"github.com/prometheus/client_golang/prometheus/promauto"
+	"github.com/smazurov/videonode/internal/logging"
+)
+
+// Recording defaults.
+const (
+	// DefaultRecordingSegmentDuration is how much video a segment file holds
+	// when the stream doesn't configure it. Segments end on the first
+	// keyframe past it.
+	DefaultRecordingSegmentDuration = time.Minute
+
+	// recordingMaxFragment bounds the media buffered in memory before it is
+	// written as a fragment, for streams with long keyframe intervals.
+	recordingMaxFragment = 2 * time.Second
+
+	// recordingQueueSize is how many fragments a segment writer queues before
+	// new ones are dropped.
+	recordingQueueSize = 16
+
+	// Segment files are preallocated to the size of the previous segment,
+	// plus headroom, so writes don't extend the file block by block.
+	recordingFirstPrealloc = 32 << 20
+	recordingMaxPrealloc   = 1 << 30
+)
+
+// recordingTimeLayout names segment files by their start time, so names sort
+// in recording order.
+const recordingTimeLayout = "20060102T150405.000Z"
+
+var errNoParameterSets = errors.New("parameter sets not received yet")
+
+var (
+	recordingBytes = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "recording",
+		Name:      "bytes_total",
+		Help:      "Bytes written to recording segments per stream",
+	}, []string{"stream_id"})
+
+	recordingSegments = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "recording",
+		Name:      "segments_total",
+		Help:      "Recording segments completed per stream",
+	}, []string{"stream_id"})
+
+	recordingDroppedFragments = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "recording",
+		Name:      "dropped_fragments_total",
+		Help:      "Recording fragments dropped because the disk fell behind, per stream",
+	}, []string{"stream_id"})
+)
+
+// RecordingConfig configures the recording of a stream.
+type RecordingConfig struct {
+	// Dir is the recordings directory; segments go to Dir/<stream_id>/
+	Dir string
+	// SegmentDuration is the length of each segment file (0 = default)
+	SegmentDuration time.Duration
+	// MaxAge deletes segments older than this (0 = no age limit)
+	MaxAge time.Duration
+	// MaxBytes deletes the oldest segments while the stream's recordings
+	// exceed it (0 = no size limit)
+	MaxBytes int64
+}
+
+// Recordings records streams to disk. Recorders attach to the hub like
+// WebRTC consumers and remux the H264/H265 and Opus RTP they receive into
+// fragmented MP4 segments, without transcoding.
+type Recordings struct {
+	hub       *Hub
+	logger    logging.Logger
+	mu        sync.Mutex
+	resolver  func(streamID string) (RecordingConfig, bool)
+	recorders map[string]*Recorder
+}
+
+// NewRecordings creates a recording manager for the hub's streams.
+func NewRecordings(hub *Hub, logger logging.Logger) *Recordings {
+	return &Recordings{
+		hub:       hub,
+		logger:    logger,
+		recorders: make(map[string]*Recorder),
+	}
+}
+
+// SetResolver sets the lookup for per-stream recording settings. Returning
+// false leaves the stream unrecorded.
+func (r *Recordings) SetResolver(resolver func(streamID string) (RecordingConfig, bool)) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	r.resolver = resolver
+}
+
+// Start begins recording a stream if its settings ask for it. Call once the
+// stream's producer is live; a stream already being recorded is left alone.
+func (r *Recordings) Start(streamID string) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	if _, ok := r.recorders[streamID]; ok || r.resolver == nil {
+		return
+	}
+	config, enabled := r.resolver(streamID)
+	if !enabled {
+		return
+	}
+
+	recorder, err := startRecorder(r.hub, streamID, config, r.logger)
+	if err != nil {
+		r.logger.Warn("Failed to start recording", "stream_id", streamID, "error", err)
+		return
+	}
+	r.recorders[streamID] = recorder
+	r.logger.Info("Recording started", "stream_id", streamID, "dir", recorder.writer.dir)
+}
+
+// Restart ends a stream's current segment and starts recording it again,
+// for producers the hub couldn't carry its consumers over to (codec change).
+func (r *Recordings) Restart(streamID string) {
+	r.Stop(streamID)
+	r.Start(streamID)
+}
+
+// Stop ends a stream's recording, completing its current segment.
+func (r *Recordings) Stop(streamID string) {
+	r.mu.Lock()
+	recorder, ok := r.recorders[streamID]
+	delete(r.recorders, streamID)
+	r.mu.Unlock()
+
+	if ok {
+		recorder.stop()
+		r.logger.Info("Recording stopped", "stream_id", streamID)
+	}
+}
+
+// StopAll ends all recordings.
+func (r *Recordings) StopAll() {
+	r.mu.Lock()
+	recorders := r.recorders
+	r.recorders = make(map[string]*Recorder)
+	r.mu.Unlock()
+
+	for _, recorder := range recorders {
+		recorder.stop()
+	}
+}
+
+// Recorder records one stream. The video and audio attachments deliver
+// packets on their own sender goroutines; mu serializes them.
+type Recorder struct {
+	streamID string
+	logger   logging.Logger
+	writer   *segmentWriter
+	video    *TrackAttachment
+	audio    *TrackAttachment // nil for streams without Opus audio
+
+	mu        sync.Mutex
+	closed    bool
+	segmenter *segmenter
+	assembler *auAssembler
+	warned    bool // the stream can't be recorded yet, logged once
+}
+
+// startRecorder attaches a recorder to a stream's tracks.
+func startRecorder(hub *Hub, streamID string, config RecordingConfig, logger logging.Logger) (*Recorder, error) {
+	if config.SegmentDuration <= 0 {
+		config.SegmentDuration = DefaultRecordingSegmentDuration
+	}
+	r := &Recorder{
+		streamID: streamID,
+		logger:   logger,
+		writer:   newSegmentWriter(filepath.Join(config.Dir, streamID), streamID, config, logger),
+	}
+
+	// Packets wait until the segmenter is set up from the attached codecs
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	video, err := hub.AttachTrack(streamID, core.KindVideo, r.handleVideo)
+	if err != nil {
+		return nil, fmt.Errorf("attach video: %w", err)
+	}
+	if !supportsPassthrough(video.Codec) {
+		video.Close()
+		return nil, fmt.Errorf("%w: %s", ErrCodecNotSupported, video.Codec.Name)
+	}
+	r.video = video
+
+	var audioCodec *core.Codec
+	if audio, err := hub.AttachTrack(streamID, core.KindAudio, r.handleAudio); err == nil {
+		if audio.Codec.Name == core.CodecOpus {
+			r.audio = audio
+			audioCodec = audio.Codec
+		} else {
+			audio.Close()
+			logger.Info("Recording video only, audio codec can't be remuxed", "stream_id", streamID, "codec", audio.Codec.Name)
+		}
+	}
+
+	r.segmenter = newSegmenter(r.writer, video.Codec, audioCodec, config.SegmentDuration)
+	r.assembler = newAUAssembler(video.Codec.Name, r.segmenter.setParameterSet, r.segmenter.addVideo)
+	r.segmenter.loadParameterSets(video.Codec)
+
+	r.writer.start() // the first segment starts at the cached or next keyframe
+	return r, nil
+}
+
+func (r *Recorder) handleVideo(packet *rtp.Packet) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	if r.closed || r.segmenter == nil {
+		return
+	}
+	r.assembler.handlePacket(packet, time.Now())
+	if err := r.segmenter.err; err != nil && !r.warned {
+		r.warned = true
+		r.logger.Warn("Recording can't start yet", "stream_id", r.streamID, "error", err)
+	}
+}
+
+func (r *Recorder) handleAudio(packet *rtp.Packet) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	if r.closed || r.segmenter == nil {
+		return
+	}
+	r.segmenter.addAudio(packet.Timestamp, packet.Payload, time.Now())
+}
+
+// stop detaches the recorder and completes its segment.
+func (r *Recorder) stop() {
+	r.video.Close()
+	if r.audio != nil {
+		r.audio.Close()
+	}
+
+	r.mu.Lock()
+	r.closed = true
+	r.segmenter.close()
+	r.mu.Unlock()
+
+	r.writer.stop()
+}
+
+// segmentSink receives the segments a segmenter produces. Buffers are taken
+// from fragmentBuffers and handed over: the sink returns them to the pool.
+type segmentSink interface {
+	// openSegment starts a segment file beginning at start with its init
+	// segment.
+	openSegment(start time.Time, init *[]byte)
+	// writeFragment appends a moof+mdat pair to the open segment.
+	writeFragment(fragment *[]byte)
+	// closeSegment completes the open segment.
+	closeSegment()
+}
+
+// fragmentBuffers holds the buffers fragments are built in, reused once
+// their fragment is written.
+var fragmentBuffers = sync.Pool{New: func() any {
+	buf := make([]byte, 0, 256<<10)
+	return &buf
+}}
+
+// recTrack is a track's state in a segmenter. The last sample of a track
+// stays open until the next one arrives, since its duration is the
+// difference of their RTP timestamps.
+type recTrack struct {
+	fmp4Track
+	started      bool
+	open         bool   // the last sample of frag has no duration yet
+	lastTS       uint32 // RTP timestamp of the last sample
+	next         uint64 // decode time of the open sample, or the next one
+	base         uint64 // decode time at the start of the segment
+	lastDuration uint32 // used when the RTP timestamps give none
+	maxDelta     uint32 // larger timestamp jumps are gaps
+	frag         fmp4Fragment
+}
+
+func newRecTrack(id uint32, codec *core.Codec, defaultDuration uint32) *recTrack {
+	t := &recTrack{
+		fmp4Track: fmp4Track{
+			id:        id,
+			codec:     codec.Name,
+			timescale: codec.ClockRate,
+		},
+		lastDuration: defaultDuration,
+		maxDelta:     2 * codec.ClockRate,
+	}
+	t.frag.track = &t.fmp4Track
+	return t
+}
+
+// advance closes the open sample at RTP timestamp ts.
+func (t *recTrack) advance(ts uint32) {
+	if !t.open {
+		return
+	}
+	if delta := int32(ts - t.lastTS); delta > 0 && uint32(delta) <= t.maxDelta {
+		t.lastDuration = uint32(delta)
+	}
+	t.closeOpen()
+}
+
+// closeOpen gives the open sample the duration of the one before.
+func (t *recTrack) closeOpen() {
+	if !t.open {
+		return
+	}
+	t.frag.samples[len(t.frag.samples)-1].duration = t.lastDuration
+	t.next += uint64(t.lastDuration)
+	t.open = false
+}
+
+// add appends a sample at RTP timestamp ts, left open.
+func (t *recTrack) add(ts uint32, data []byte, sync bool) {
+	if len(t.frag.samples) == 0 {
+		t.frag.decodeTime = t.next - t.base
+	}
+	t.frag.samples = append(t.frag.samples, fmp4Sample{size: uint32(len(data)), sync: sync})
+	t.frag.data = append(t.frag.data, data...)
+	t.started = true
+	t.open = true
+	t.lastTS = ts
+}
+
+// segmenter cuts a stream's access units into fragmented MP4 segments.
+// Segments and fragments start on keyframes; video has no B-frames, so
+// decode and presentation times are equal. Each segment is a complete file
+// with its own init segment and a timeline starting at zero.
+type segmenter struct {
+	sink            segmentSink
+	segmentDuration time.Duration
+	video           *recTrack
+	audio           *recTrack // nil without audio
+
+	// parameter sets, by NAL type
+	vps, sps, pps []byte
+	paramsChanged bool
+
+	open       bool
+	openedAt   time.Time
+	sequence   uint32    // of the last fragment in the segment
+	fragmentAt time.Time // when the buffered fragment started
+	err        error     // why the last segment couldn't be opened
+	fragments  []*fmp4Fragment
+}
+
+func newSegmenter(sink segmentSink, video, audio *core.Codec, segmentDuration time.Duration) *segmenter {
+	s := &segmenter{
+		sink:            sink,
+		segmentDuration: segmentDuration,
+		video:           newRecTrack(1, video, video.ClockRate/30),
+	}
+	if audio != nil {
+		s.audio = newRecTrack(2, audio, audio.ClockRate/50) // 20 ms Opus frames
+		s.audio.channels = uint16(min(max(audio.Channels, 1), 2))
+	}
+	return s
+}
+
+// loadParameterSets takes the initial parameter sets from a codec's fmtp
+// line. In-band parameter sets replace them.
+func (s *segmenter) loadParameterSets(codec *core.Codec) {
+	if codec.Name == core.CodecH265 {
+		vps, sps, pps := parseVpsSpsPps(codec.FmtpLine)
+		s.setParameterSet(h265NALVPS, vps)
+		s.setParameterSet(h265NALSPS, sps)
+		s.setParameterSet(h265NALPPS, pps)
+		return
+	}
+	sps, pps := parseSpsPps(codec.FmtpLine)
+	s.setParameterSet(h264NALSPS, sps)
+	s.setParameterSet(h264NALPPS, pps)
+}
+
+// setParameterSet stores a VPS, SPS or PPS. A change while a segment is open
+// starts a new segment on the next keyframe, since the init segment holds
+// them.
+func (s *segmenter) setParameterSet(nalType byte, nal []byte) {
+	if len(nal) == 0 {
+		return
+	}
+	var slot *[]byte
+	switch {
+	case s.video.codec == core.CodecH265 && nalType == h265NALVPS:
+		slot = &s.vps
+	case s.video.codec == core.CodecH265 && nalType == h265NALSPS,
+		s.video.codec == core.CodecH264 && nalType == h264NALSPS:
+		slot = &s.sps
+	case s.video.codec == core.CodecH265 && nalType == h265NALPPS,
+		s.video.codec == core.CodecH264 && nalType == h264NALPPS:
+		slot = &s.pps
+	default:
+		return
+	}
+	if bytes.Equal(*slot, nal) {
+		return
+	}
+	*slot = bytes.Clone(nal)
+	if s.open {
+		s.paramsChanged = true
+	}
+}
+
+// addVideo adds a video access unit: AVCC NAL units without parameter sets.
+func (s *segmenter) addVideo(ts uint32, au []byte, sync bool, now time.Time) {
+	v := s.video
+	if !s.open {
+		if !sync {
+			return
+		}
+		if s.err = s.openSegment(now); s.err != nil {
+			return
+		}
+	}
+
+	v.advance(ts)
+	switch {
+	case sync && (s.paramsChanged || v.next-v.base >= s.segmentTicks()):
+		s.flush()
+		s.sink.closeSegment()
+		s.open = false
+		if s.err = s.openSegment(now); s.err != nil {
+			return
+		}
+	case sync || s.fragmentDue(now):
+		s.flush()
+	}
+
+	if s.fragmentAt.IsZero() {
+		s.fragmentAt = now
+	}
+	v.add(ts, au, sync)
+}
+
+// addAudio adds an Opus packet. Audio is dropped until video opens a
+// segment; it starts at its wall-clock offset into the segment.
+func (s *segmenter) addAudio(ts uint32, payload []byte, now time.Time) {
+	a := s.audio
+	if a == nil || !s.open || len(payload) == 0 {
+		return
+	}
+
+	if a.started {
+		a.advance(ts)
+	} else {
+		a.next = a.base + uint64(now.Sub(s.openedAt))*uint64(a.timescale)/uint64(time.Second)
+	}
+	if s.fragmentDue(now) {
+		s.flush()
+	}
+	if s.fragmentAt.IsZero() {
+		s.fragmentAt = now
+	}
+	a.add(ts, payload, true)
+}
+
+func (s *segmenter) segmentTicks() uint64 {
+	return uint64(s.segmentDuration) * uint64(s.video.timescale) / uint64(time.Second)
+}
+
+func (s *segmenter) fragmentDue(now time.Time) bool {
+	return !s.fragmentAt.IsZero() && now.Sub(s.fragmentAt) >= recordingMaxFragment
+}
+
+// openSegment starts a segment with an init segment for the current
+// parameter sets.
+func (s *segmenter) openSegment(now time.Time) error {
+	if err := s.configureVideo(); err != nil {
+		return err
+	}
+
+	tracks := []*fmp4Track{&s.video.fmp4Track}
+	if s.audio != nil {
+		tracks = append(tracks, &s.audio.fmp4Track)
+	}
+	buf := fragmentBuffers.Get().(*[]byte)
+	*buf = appendFMP4Init((*buf)[:0], tracks)
+	s.sink.openSegment(now, buf)
+
+	s.open = true
+	s.openedAt = now
+	s.sequence = 0
+	s.paramsChanged = false
+	for _, t := range s.tracks() {
+		if t.started {
+			t.base = t.next
+		}
+	}
+	return nil
+}
+
+// configureVideo sets the video track's size and decoder configuration from
+// the parameter sets.
+func (s *segmenter) configureVideo() error {
+	v := s.video
+	if v.codec == core.CodecH265 {
+		if s.vps == nil || s.sps == nil || s.pps == nil {
+			return errNoParameterSets
+		}
+		info, err := parseH265SPS(s.sps)
+		if err != nil {
+			return err
+		}
+		v.width, v.height = uint16(info.width), uint16(info.height)
+		v.config = hevcDecoderConfig(s.vps, s.sps, s.pps, info)
+		return nil
+	}
+
+	if s.sps == nil || s.pps == nil {
+		return errNoParameterSets
+	}
+	width, height, err := parseH264SPSSize(s.sps)
+	if err != nil {
+		return err
+	}
+	v.width, v.height = uint16(width), uint16(height)
+	v.config = avcDecoderConfig(s.sps, s.pps)
+	return nil
+}
+
+func (s *segmenter) tracks() []*recTrack {
+	if s.audio == nil {
+		return []*recTrack{s.video}
+	}
+	return []*recTrack{s.video, s.audio}
+}
+
+// flush writes the buffered samples as a fragment. Open samples are closed
+// with the duration of the one before.
+func (s *segmenter) flush() {
+	s.fragments = s.fragments[:0]
+	for _, t := range s.tracks() {
+		t.closeOpen()
+		if len(t.frag.samples) > 0 {
+			s.fragments = append(s.fragments, &t.frag)
+		}
+	}
+	s.fragmentAt = time.Time{}
+	if len(s.fragments) == 0 {
+		return
+	}
+
+	s.sequence++
+	buf := fragmentBuffers.Get().(*[]byte)
+	*buf = appendFMP4Fragment((*buf)[:0], s.sequence, s.fragments)
+	s.sink.writeFragment(buf)
+
+	for _, frag := range s.fragments {
+		frag.samples = frag.samples[:0]
+		frag.data = frag.data[:0]
+	}
+}
+
+// close writes what is buffered and completes the open segment.
+func (s *segmenter) close() {
+	if !s.open {
+		return
+	}
+	s.flush()
+	s.sink.closeSegment()
+	s.open = false
+}
+
+// auAssembler depacketizes H264 (RFC 6184) or H265 (RFC 7798) RTP into
+// access units of NAL units with 4-byte length prefixes, as MP4 samples
+// store them. Parameter sets are taken out and reported on their own.
+type auAssembler struct {
+	codec    string
+	onParams func(nalType byte, nal []byte)
+	onAU     func(ts uint32, au []byte, sync bool, now time.Time)
+
+	buf       []byte
+	timestamp uint32
+	pending   bool // buf holds NAL units of the access unit at timestamp
+	sync      bool
+	nalStart  int  // offset of the length prefix of the NAL unit being built
+	inFU      bool // a fragmented NAL unit is being reassembled
+}
+
+func newAUAssembler(codec string, onParams func(byte, []byte), onAU func(uint32, []byte, bool, time.Time)) *auAssembler {
+	return &auAssembler{codec: codec, onParams: onParams, onAU: onAU}
+}
+
+func (a *auAssembler) handlePacket(packet *rtp.Packet, now time.Time) {
+	if a.pending && packet.Timestamp != a.timestamp {
+		a.emit(now) // the access unit ended without a marker bit
+	}
+	a.timestamp = packet.Timestamp
+	a.pending = true
+
+	if a.codec == core.CodecH265 {
+		a.addH265(packet.Payload)
+	} else {
+		a.addH264(packet.Payload)
+	}
+
+	if packet.Marker {
+		a.emit(now)
+	}
+}
+
+func (a *auAssembler) addH264(payload []byte) {
+	if len(payload) == 0 {
+		return
+	}
+	switch payload[0] & 0x1F {
+	case h264NALSTAPA:
+		a.addAggregated(payload[1:])
+	case h264NALFUA:
+		if len(payload) < 2 {
+			return
+		}
+		a.addFragment(payload[1]&0x80 != 0, payload[1]&0x40 != 0, []byte{payload[0]&0xE0 | payload[1]&0x1F}, payload[2:])
+	default:
+		a.addNAL(payload)
+	}
+}
+
+func (a *auAssembler) addH265(payload []byte) {
+	if len(payload) < 3 {
+		return
+	}
+	switch h265NALType(payload[0]) {
+	case h265NALAP:
+		a.addAggregated(payload[2:])
+	case h265NALFU:
+		header := []byte{payload[0]&0x81 | (payload[2]&0x3F)<<1, payload[1]}
+		a.addFragment(payload[2]&0x80 != 0, payload[2]&0x40 != 0, header, payload[3:])
+	default:
+		a.addNAL(payload)
+	}
+}
+
+// addAggregated adds the NAL units of a STAP-A/AP payload, each prefixed
+// with its 16-bit size.
+func (a *auAssembler) addAggregated(payload []byte) {
+	for len(payload) >= 2 {
+		size := int(binary.BigEndian.Uint16(payload))
+		payload = payload[2:]
+		if size == 0 || size > len(payload) {
+			return
+		}
+		a.addNAL(payload[:size])
+		payload = payload[size:]
+	}
+}
+
+// addFragment adds a part of an FU-A/FU NAL unit. Parts after a lost start
+// are skipped.
+func (a *auAssembler) addFragment(start, end bool, header, data []byte) {
+	if start {
+		if a.inFU {
+			a.buf = a.buf[:a.nalStart] // the previous one never ended
+		}
+		a.beginNAL()
+		a.buf = append(a.buf, header...)
+		a.inFU = true
+	} else if !a.inFU {
+		return
+	}
+	a.buf = append(a.buf, data...)
+	if end {
+		a.inFU = false
+		a.endNAL()
+	}
+}
+
+func (a *auAssembler) addNAL(nal []byte) {
+	if a.inFU {
+		a.buf = a.buf[:a.nalStart]
+		a.inFU = false
+	}
+	a.beginNAL()
+	a.buf = append(a.buf, nal...)
+	a.endNAL()
+}
+
+func (a *auAssembler) beginNAL() {
+	a.nalStart = len(a.buf)
+	a.buf = append(a.buf, 0, 0, 0, 0)
+}
+
+// endNAL fills in the length of the NAL unit begun last, or takes it out if
+// it is a parameter set.
+func (a *auAssembler) endNAL() {
+	nal := a.buf[a.nalStart+4:]
+	if len(nal) == 0 {
+		a.buf = a.buf[:a.nalStart]
+		return
+	}
+
+	var nalType byte
+	var parameterSet, keyframe bool
+	if a.codec == core.CodecH265 {
+		nalType = h265NALType(nal[0])
+		parameterSet, keyframe = isH265ParameterSet(nalType), isH265IRAP(nalType)
+	} else {
+		nalType = nal[0] & 0x1F
+		parameterSet, keyframe = nalType == h264NALSPS || nalType == h264NALPPS, nalType == h264NALIDR
+	}
+
+	if parameterSet {
+		a.onParams(nalType, nal)
+		a.buf = a.buf[:a.nalStart]
+		return
+	}
+	a.sync = a.sync || keyframe
+	binary.BigEndian.PutUint32(a.buf[a.nalStart:], uint32(len(nal)))
+}
+
+// emit hands the access unit over, which must copy what it keeps.
+func (a *auAssembler) emit(now time.Time) {
+	if a.inFU {
+		a.buf = a.buf[:a.nalStart] // incomplete NAL unit
+		a.inFU = false
+	}
+	if len(a.buf) > 0 {
+		a.onAU(a.timestamp, a.buf, a.sync, now)
+	}
+	a.buf = a.buf[:0]
+	a.sync = false
+	a.pending = false
+}
+
+// segmentOp is a segment writer operation.
+type segmentOp struct {
+	kind  segmentOpKind
+	start time.Time
+	data  *[]byte
+}
+
+type segmentOpKind int
+
+const (
+	segmentOpen segmentOpKind = iota
+	segmentWrite
+	segmentClose
+)
+
+// segmentWriter writes a stream's segments on its own goroutine, so disk
+// latency never holds up the hub's sender goroutines. Each fragment is one
+// sequential write into a preallocated file. Fragments are dropped when the
+// disk falls behind by more than the queue; opening and closing segments
+// waits for it.
+type segmentWriter struct {
+	dir      string
+	streamID string
+	maxAge   time.Duration
+	maxBytes int64
+	logger   logging.Logger
+	ops      chan segmentOp
+	wg       sync.WaitGroup
+
+	// Only touched by run()
+	file     *os.File
+	written  int64
+	lastSize int64
+}
+
+func newSegmentWriter(dir, streamID string, config RecordingConfig, logger logging.Logger) *segmentWriter {
+	return &segmentWriter{
+		dir:      dir,
+		streamID: streamID,
+		maxAge:   config.MaxAge,
+		maxBytes: config.MaxBytes,
+		logger:   logger,
+		ops:      make(chan segmentOp, recordingQueueSize),
+	}
+}
+
+func (w *segmentWriter) start() {
+	w.wg.Add(1)
+	go w.run()
+}
+
+// stop waits for queued operations to finish.
+func (w *segmentWriter) stop() {
+	close(w.ops)
+	w.wg.Wait()
+}
+
+func (w *segmentWriter) openSegment(start time.Time, init *[]byte) {
+	w.ops <- segmentOp{kind: segmentOpen, start: start, data: init}
+}
+
+func (w *segmentWriter) writeFragment(fragment *[]byte) {
+	select {
+	case w.ops <- segmentOp{kind: segmentWrite, data: fragment}:
+	default:
+		fragmentBuffers.Put(fragment)
+		recordingDroppedFragments.WithLabelValues(w.streamID).Inc()
+		w.logger.Warn("Recording fell behind, fragment dropped", "stream_id", w.streamID)
+	}
+}
+
+func (w *segmentWriter) closeSegment() {
+	w.ops <- segmentOp{kind: segmentClose}
+}
+
+func (w *segmentWriter) run() {
+	defer w.wg.Done()
+	for op := range w.ops {
+		switch op.kind {
+		case segmentOpen:
+			w.open(op.start)
+			w.write(op.data)
+		case segmentWrite:
+			w.write(op.data)
+		case segmentClose:
+			w.close()
+		}
+	}
+	w.close()
+}
+
+func (w *segmentWriter) open(start time.Time) {
+	w.close()
+	if err := os.MkdirAll(w.dir, 0o755); err != nil {
+		w.logger.Error("Failed to create recording directory", "stream_id", w.streamID, "error", err)
+		return
+	}
+
+	name := filepath.Join(w.dir, start.UTC().Format(recordingTimeLayout)+".mp4")
+	file, err := os.Create(name)
+	if err != nil {
+		w.logger.Error("Failed to create recording segment", "stream_id", w.streamID, "error", err)
+		return
+	}
+
+	size := int64(recordingFirstPrealloc)
+	if w.lastSize > 0 {
+		size = min(w.lastSize+w.lastSize/4, recordingMaxPrealloc)
+	}
+	if err := preallocate(file, size); err != nil {
+		w.logger.Debug("Segment preallocation failed", "stream_id", w.streamID, "error", err)
+	}
+	w.file = file
+	w.written = 0
+}
+
+func (w *segmentWriter) write(data *[]byte) {
+	defer fragmentBuffers.Put(data)
+	if w.file == nil {
+		return
+	}
+	n, err := w.file.Write(*data)
+	w.written += int64(n)
+	recordingBytes.WithLabelValues(w.streamID).Add(float64(n))
+	if err != nil {
+		w.logger.Error("Failed to write recording segment, dropping the rest of it", "stream_id", w.streamID, "error", err)
+		w.close()
+	}
+}
+
+// close completes the open segment, giving back the preallocated space it
+// didn't use, and applies the retention limits.
+func (w *segmentWriter) close() {
+	if w.file == nil {
+		return
+	}
+	if err := w.file.Truncate(w.written); err != nil {
+		w.logger.Warn("Failed to trim recording segment", "stream_id", w.streamID, "error", err)
+	}
+	if err := w.file.Close(); err != nil {
+		w.logger.Warn("Failed to close recording segment", "stream_id", w.streamID, "error", err)
+	}
+	w.file = nil
+	w.lastSize = w.written
+	recordingSegments.WithLabelValues(w.streamID).Inc()
+
+	if err := applyRetention(w.dir, time.Now(), w.maxAge, w.maxBytes); err != nil {
+		w.logger.Warn("Failed to apply recording retention", "stream_id", w.streamID, "error", err)
+	}
+}
+
+// applyRetention deletes a stream's oldest segments in dir while they are
+// older than maxAge or add up to more than maxBytes. The newest segment is
+// always kept.
+func applyRetention(dir string, now time.Time, maxAge time.Duration, maxBytes int64) error {
+	if maxAge <= 0 && maxBytes <= 0 {
+		return nil
+	}
+	entries, err := os.ReadDir(dir) // sorted by name, so oldest first
+	if err != nil {
+		return fmt.Errorf("read recordings: %w", err)
+	}
+
+	type segment struct {
+		name    string
+		size    int64
+		modTime time.Time
+	}
+	var segments []segment
+	var total int64
+	for _, entry := range entries {
+		if !entry.Type().IsRegular() || !strings.HasSuffix(entry.Name(), ".mp4") {
+			continue
+		}
+		info, err := entry.Info()
+		if err != nil {
+			continue
+		}
+		segments = append(segments, segment{entry.Name(), info.Size(), info.ModTime()})
+		total += info.Size()
+	}
+
+	for _, seg := range segments[:max(len(segments)-1, 0)] {
+		expired := maxAge > 0 && now.Sub(seg.modTime) > maxAge
+		if !expired && (maxBytes <= 0 || total <= maxBytes) {
+			break
+		}
+		if err := os.Remove(filepath.Join(dir, seg.name)); err != nil {
+			return fmt.Errorf("remove segment: %w", err)
+		}
+		total -= seg.size
+	}
+	return nil
+}
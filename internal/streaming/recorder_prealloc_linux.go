@@ -0,0 +1,17 @@
+//go:build linux
+
+package streaming
+
+import (
+	"os"
+	"syscall"
+)
+
+// fallocKeepSize is FALLOC_FL_KEEP_SIZE (linux/falloc.h), missing from syscall.
+const fallocKeepSize = 0x01
+
+// preallocate reserves size bytes of disk for file without changing its
+// length, so appends fill allocated blocks instead of growing the file.
+func preallocate(file *os.File, size int64) error {
+	return syscall.Fallocate(int(file.Fd()), fallocKeepSize, 0, size)
+}
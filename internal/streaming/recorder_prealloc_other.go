@@ -0,0 +1,10 @@
+//go:build !linux
+
+package streaming
+
+import "os"
+
+// Preallocation is Linux-only; segments grow as they are written elsewhere.
+func preallocate(_ *os.File, _ int64) error {
+	return nil
+}
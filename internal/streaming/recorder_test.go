@@ -0,0 +1,345 @@
+package streaming
+
+import (
+	"bytes"
+	"io"
+	"log/slog"
+	"os"
+	"path/filepath"
+	"slices"
+	"testing"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// fakeSegment is a segment captured by fakeSink.
+type fakeSegment struct {
+	start     time.Time
+	init      []byte
+	fragments [][]byte
+	closed    bool
+}
+
+type fakeSink struct {
+	segments []*fakeSegment
+}
+
+func (s *fakeSink) openSegment(start time.Time, init *[]byte) {
+	s.segments = append(s.segments, &fakeSegment{start: start, init: bytes.Clone(*init)})
+	fragmentBuffers.Put(init)
+}
+
+func (s *fakeSink) writeFragment(fragment *[]byte) {
+	last := s.segments[len(s.segments)-1]
+	last.fragments = append(last.fragments, bytes.Clone(*fragment))
+	fragmentBuffers.Put(fragment)
+}
+
+func (s *fakeSink) closeSegment() {
+	s.segments[len(s.segments)-1].closed = true
+}
+
+func testH264Codec() *core.Codec {
+	return &core.Codec{
+		Name:      core.CodecH264,
+		ClockRate: 90000,
+		FmtpLine:  "packetization-mode=1;sprop-parameter-sets=" + testSPS + "," + testPPS,
+	}
+}
+
+var recordingEpoch = time.Unix(1_700_000_000, 0)
+
+// frameTime is when frame i of a 30 fps stream arrives.
+func frameTime(i int) time.Time {
+	return recordingEpoch.Add(time.Duration(i) * time.Second / 30)
+}
+
+func TestSegmenterSegmentsOnKeyframes(t *testing.T) {
+	sink := &fakeSink{}
+	s := newSegmenter(sink, testH264Codec(), nil, 2*time.Second)
+	s.loadParameterSets(testH264Codec())
+
+	// 30 fps, a keyframe every second starting at frame 5
+	for i := range 150 {
+		sync := i%30 == 5
+		s.addVideo(uint32(1000+3000*i), []byte{0, 0, 0, 1, 0x41}, sync, frameTime(i))
+	}
+	s.close()
+
+	if len(sink.segments) != 3 {
+		t.Fatalf("segments = %d, want 3", len(sink.segments))
+	}
+	wantFragments := []int{2, 2, 1}
+	for i, seg := range sink.segments {
+		if !seg.closed {
+			t.Errorf("segment %d not closed", i)
+		}
+		if want := frameTime(5 + 60*i); !seg.start.Equal(want) {
+			t.Errorf("segment %d starts at %v, want %v", i, seg.start, want)
+		}
+		if len(seg.fragments) != wantFragments[i] {
+			t.Fatalf("segment %d fragments = %d, want %d", i, len(seg.fragments), wantFragments[i])
+		}
+		for j, fragment := range seg.fragments {
+			sequence, trafs := parseFragment(t, fragment)
+			if sequence != uint32(j+1) {
+				t.Errorf("segment %d fragment %d sequence = %d", i, j, sequence)
+			}
+			if len(trafs) != 1 {
+				t.Fatalf("segment %d fragment %d trafs = %d, want 1", i, j, len(trafs))
+			}
+			video := trafs[0]
+			if want := uint64(j * 90000); video.decodeTime != want {
+				t.Errorf("segment %d fragment %d decode time = %d, want %d", i, j, video.decodeTime, want)
+			}
+			if !video.sync[0] || slices.Contains(video.sync[1:], true) {
+				t.Errorf("segment %d fragment %d doesn't start with its only keyframe: %v", i, j, video.sync)
+			}
+			for _, d := range video.durations {
+				if d != 3000 {
+					t.Errorf("segment %d fragment %d sample duration = %d, want 3000", i, j, d)
+					break
+				}
+			}
+		}
+	}
+}
+
+func TestSegmenterRotatesOnParameterSetChange(t *testing.T) {
+	sink := &fakeSink{}
+	s := newSegmenter(sink, testH264Codec(), nil, time.Hour)
+	s.loadParameterSets(testH264Codec())
+
+	s.addVideo(0, []byte{0x65}, true, frameTime(0))
+	s.addVideo(3000, []byte{0x41}, false, frameTime(1))
+	s.setParameterSet(h264NALSPS, decodeBase64(t, testSPS)) // unchanged
+	s.addVideo(6000, []byte{0x65}, true, frameTime(2))
+	s.setParameterSet(h264NALSPS, append(decodeBase64(t, testSPS), 0))
+	s.addVideo(9000, []byte{0x41}, false, frameTime(3))
+	s.addVideo(12000, []byte{0x65}, true, frameTime(4))
+
+	if len(sink.segments) != 2 {
+		t.Fatalf("segments = %d, want 2", len(sink.segments))
+	}
+	if !sink.segments[0].closed || sink.segments[1].closed {
+		t.Error("only the first segment should be closed")
+	}
+	if !bytes.Contains(sink.segments[1].init, append(decodeBase64(t, testSPS), 0)) {
+		t.Error("second init segment lacks the new SPS")
+	}
+}
+
+func TestSegmenterWaitsForParameterSets(t *testing.T) {
+	sink := &fakeSink{}
+	s := newSegmenter(sink, &core.Codec{Name: core.CodecH264, ClockRate: 90000}, nil, time.Minute)
+
+	s.addVideo(0, []byte{0x65}, true, frameTime(0))
+	if len(sink.segments) != 0 || s.err != errNoParameterSets {
+		t.Fatalf("segments = %d, err = %v, want none and errNoParameterSets", len(sink.segments), s.err)
+	}
+
+	s.loadParameterSets(testH264Codec())
+	s.addVideo(3000, []byte{0x65}, true, frameTime(1))
+	if len(sink.segments) != 1 || s.err != nil {
+		t.Errorf("segments = %d, err = %v, want 1 and none", len(sink.segments), s.err)
+	}
+}
+
+func TestSegmenterAudio(t *testing.T) {
+	sink := &fakeSink{}
+	opus := &core.Codec{Name: core.CodecOpus, ClockRate: 48000, Channels: 2}
+	s := newSegmenter(sink, testH264Codec(), opus, time.Minute)
+	s.loadParameterSets(testH264Codec())
+
+	audioTime := func(i int) time.Time { return recordingEpoch.Add(time.Duration(i) * 20 * time.Millisecond) }
+	s.addAudio(5000, []byte{1}, audioTime(0)) // before the first keyframe
+	s.addVideo(0, []byte{0x65}, true, frameTime(0))
+	for i := 1; i <= 10; i++ {
+		s.addAudio(uint32(5000+960*i), []byte{byte(i)}, audioTime(i))
+	}
+	s.addVideo(3000, []byte{0x41}, false, frameTime(1))
+	s.close()
+
+	if len(sink.segments) != 1 || len(sink.segments[0].fragments) != 1 {
+		t.Fatalf("segments = %d, want 1 with 1 fragment", len(sink.segments))
+	}
+	_, trafs := parseFragment(t, sink.segments[0].fragments[0])
+	if len(trafs) != 2 {
+		t.Fatalf("trafs = %d, want video and audio", len(trafs))
+	}
+	audio := trafs[1]
+	if audio.trackID != 2 || len(audio.sizes) != 10 {
+		t.Fatalf("audio track %d has %d samples, want track 2 with 10", audio.trackID, len(audio.sizes))
+	}
+	if audio.decodeTime != 960 { // 20 ms after the keyframe
+		t.Errorf("audio decode time = %d, want 960", audio.decodeTime)
+	}
+	for _, d := range audio.durations {
+		if d != 960 {
+			t.Errorf("audio sample duration = %d, want 960", d)
+			break
+		}
+	}
+	if opusEntry := findBox(t, sink.segments[0].init, "moov"); !bytes.Contains(opusEntry.body, []byte("dOps")) {
+		t.Error("init segment has no Opus track")
+	}
+}
+
+func TestAUAssembler(t *testing.T) {
+	type au struct {
+		ts   uint32
+		data []byte
+		sync bool
+	}
+	var aus []au
+	var params [][]byte
+	a := newAUAssembler(core.CodecH264,
+		func(_ byte, nal []byte) { params = append(params, bytes.Clone(nal)) },
+		func(ts uint32, data []byte, sync bool, _ time.Time) {
+			aus = append(aus, au{ts, bytes.Clone(data), sync})
+		},
+	)
+
+	packets := []*rtp.Packet{
+		rtpPacket(100, false, 0x41, 0xAA), // lost FU-A start below, so no marker
+		rtpPacket(200, false, 0x18, 0x00, 0x02, 0x67, 0x01, 0x00, 0x02, 0x68, 0x02),
+		rtpPacket(200, false, 0x7C, 0x85, 0x03), // FU-A start, IDR
+		rtpPacket(200, true, 0x7C, 0x45, 0x04),  // FU-A end
+		rtpPacket(300, false, 0x7C, 0x41, 0x05), // FU-A end without start
+		rtpPacket(300, true, 0x41, 0xBB),
+	}
+	for _, packet := range packets {
+		a.handlePacket(packet, recordingEpoch)
+	}
+
+	want := []au{
+		{100, []byte{0, 0, 0, 2, 0x41, 0xAA}, false},
+		{200, []byte{0, 0, 0, 3, 0x65, 0x03, 0x04}, true},
+		{300, []byte{0, 0, 0, 2, 0x41, 0xBB}, false},
+	}
+	if len(aus) != len(want) {
+		t.Fatalf("access units = %d, want %d", len(aus), len(want))
+	}
+	for i, w := range want {
+		if aus[i].ts != w.ts || !bytes.Equal(aus[i].data, w.data) || aus[i].sync != w.sync {
+			t.Errorf("access unit %d = %+v, want %+v", i, aus[i], w)
+		}
+	}
+	if len(params) != 2 || !bytes.Equal(params[0], []byte{0x67, 0x01}) || !bytes.Equal(params[1], []byte{0x68, 0x02}) {
+		t.Errorf("parameter sets = %x", params)
+	}
+}
+
+func TestApplyRetention(t *testing.T) {
+	now := recordingEpoch
+	segments := []struct {
+		name string
+		size int
+		age  time.Duration
+	}{
+		{"20231114T221000.000Z.mp4", 100, 50 * time.Minute},
+		{"20231114T222000.000Z.mp4", 100, 40 * time.Minute},
+		{"20231114T223000.000Z.mp4", 100, 30 * time.Minute},
+		{"20231114T224000.000Z.mp4", 100, 20 * time.Minute},
+	}
+
+	tests := []struct {
+		name     string
+		maxAge   time.Duration
+		maxBytes int64
+		want     []string
+	}{
+		{"no limits", 0, 0, []string{"20231114T221000.000Z.mp4", "20231114T222000.000Z.mp4", "20231114T223000.000Z.mp4", "20231114T224000.000Z.mp4"}},
+		{"by age", 35 * time.Minute, 0, []string{"20231114T223000.000Z.mp4", "20231114T224000.000Z.mp4"}},
+		{"by size", 0, 250, []string{"20231114T223000.000Z.mp4", "20231114T224000.000Z.mp4"}},
+		{"keeps the newest", time.Minute, 1, []string{"20231114T224000.000Z.mp4"}},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			dir := t.TempDir()
+			for _, seg := range segments {
+				path := filepath.Join(dir, seg.name)
+				if err := os.WriteFile(path, make([]byte, seg.size), 0o644); err != nil {
+					t.Fatal(err)
+				}
+				if err := os.Chtimes(path, now.Add(-seg.age), now.Add(-seg.age)); err != nil {
+					t.Fatal(err)
+				}
+			}
+			if err := os.WriteFile(filepath.Join(dir, "notes.txt"), make([]byte, 1000), 0o644); err != nil {
+				t.Fatal(err)
+			}
+
+			if err := applyRetention(dir, now, tt.maxAge, tt.maxBytes); err != nil {
+				t.Fatal(err)
+			}
+
+			entries, err := os.ReadDir(dir)
+			if err != nil {
+				t.Fatal(err)
+			}
+			var got []string
+			for _, entry := range entries {
+				if filepath.Ext(entry.Name()) == ".mp4" {
+					got = append(got, entry.Name())
+				}
+			}
+			if !slices.Equal(got, tt.want) {
+				t.Errorf("kept %v, want %v", got, tt.want)
+			}
+		})
+	}
+}
+
+func TestSegmentWriter(t *testing.T) {
+	dir := filepath.Join(t.TempDir(), "cam")
+	w := newSegmentWriter(dir, "cam", RecordingConfig{MaxBytes: 1}, slog.New(slog.NewTextHandler(io.Discard, nil)))
+	w.start()
+
+	buffer := func(data string) *[]byte {
+		buf := fragmentBuffers.Get().(*[]byte)
+		*buf = append((*buf)[:0], data...)
+		return buf
+	}
+	w.openSegment(recordingEpoch, buffer("init1"))
+	w.writeFragment(buffer("fragment"))
+	w.closeSegment()
+	w.openSegment(recordingEpoch.Add(time.Minute), buffer("init2"))
+	w.stop()
+
+	entries, err := os.ReadDir(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(entries) != 1 || entries[0].Name() != "20231114T221420.000Z.mp4" {
+		t.Fatalf("segments = %v, want only the newest", entries)
+	}
+	data, err := os.ReadFile(filepath.Join(dir, entries[0].Name()))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if string(data) != "init2" {
+		t.Errorf("segment = %q, want %q (trimmed to what was written)", data, "init2")
+	}
+}
+
+func BenchmarkSegmenter(b *testing.B) {
+	s := newSegmenter(discardSink{}, testH264Codec(), nil, time.Minute)
+	s.loadParameterSets(testH264Codec())
+	frame := make([]byte, 20_000)
+
+	b.ReportAllocs()
+	i := 0
+	for b.Loop() {
+		s.addVideo(uint32(3000*i), frame, i%30 == 0, frameTime(i))
+		i++
+	}
+}
+
+type discardSink struct{}
+
+func (discardSink) openSegment(_ time.Time, init *[]byte) { fragmentBuffers.Put(init) }
+func (discardSink) writeFragment(fragment *[]byte)        { fragmentBuffers.Put(fragment) }
+func (discardSink) closeSegment()                         {}
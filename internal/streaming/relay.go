@@ -0,0 +1,216 @@
+package streaming
+
+import (
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"net"
+	"net/url"
+	"os/exec"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/AlexxIT/go2rtc/pkg/rtsp"
+	"github.com/smazurov/videonode/internal/logging"
+)
+
+// Relay reconnect backoff. A relay that stayed connected for
+// relayStableAfter starts over at the minimum delay.
+const (
+	relayMinBackoff  = time.Second
+	relayMaxBackoff  = 30 * time.Second
+	relayStableAfter = time.Minute
+)
+
+// ErrInvalidRelay is returned for relay sources that can't be parsed.
+var ErrInvalidRelay = errors.New("invalid relay source")
+
+// RelaySource is a stream pulled from an upstream node and published in the
+// local hub under StreamID.
+type RelaySource struct {
+	StreamID string
+	// URL of the upstream stream: rtsp:// (the upstream node's RTSP server)
+	// is pulled natively; srt://, rtp:// and udp:// are remuxed by FFmpeg
+	// into the local RTSP server
+	URL string
+}
+
+// ParseRelaySource parses a relay source written as "stream_id=url".
+func ParseRelaySource(s string) (RelaySource, error) {
+	id, rawURL, found := strings.Cut(s, "=")
+	id, rawURL = strings.TrimSpace(id), strings.TrimSpace(rawURL)
+	if !found || id == "" || strings.Contains(id, "/") {
+		return RelaySource{}, fmt.Errorf("%w %q: want stream_id=url", ErrInvalidRelay, s)
+	}
+
+	u, err := url.Parse(rawURL)
+	if err != nil {
+		return RelaySource{}, fmt.Errorf("%w %q: %w", ErrInvalidRelay, s, err)
+	}
+	switch u.Scheme {
+	case "rtsp", "srt", "rtp", "udp":
+	default:
+		return RelaySource{}, fmt.Errorf("%w %q: unsupported scheme %q", ErrInvalidRelay, s, u.Scheme)
+	}
+	return RelaySource{StreamID: id, URL: rawURL}, nil
+}
+
+// Relays pulls streams from upstream nodes into the hub, so edge nodes can
+// serve viewers while the capture node's load stays that of one consumer per
+// edge. Each relay reconnects with backoff until stopped.
+type Relays struct {
+	hub      *Hub
+	rtspAddr string // the local RTSP server, for FFmpeg relays to publish to
+	logger   logging.Logger
+	ctx      context.Context
+	cancel   context.CancelFunc
+	wg       sync.WaitGroup
+}
+
+// NewRelays creates a relay manager publishing into hub. rtspAddr is the
+// listen address of the local RTSP server.
+func NewRelays(hub *Hub, rtspAddr string, logger logging.Logger) *Relays {
+	return &Relays{hub: hub, rtspAddr: rtspAddr, logger: logger}
+}
+
+// Start begins pulling sources.
+func (r *Relays) Start(ctx context.Context, sources []RelaySource) {
+	r.ctx, r.cancel = context.WithCancel(ctx)
+	for _, source := range sources {
+		r.hub.setUpstream(source.StreamID, source.URL)
+		r.wg.Add(1)
+		go r.run(source)
+	}
+}
+
+// Stop disconnects all relays and waits for them to finish.
+func (r *Relays) Stop() {
+	if r.cancel != nil {
+		r.cancel()
+	}
+	r.wg.Wait()
+}
+
+func (r *Relays) run(source RelaySource) {
+	defer r.wg.Done()
+	defer r.hub.setUpstream(source.StreamID, "")
+
+	backoff := relayMinBackoff
+	for {
+		r.logger.Info("Relay connecting", "stream_id", source.StreamID, "upstream", source.URL)
+		started := time.Now()
+
+		var err error
+		if strings.HasPrefix(source.URL, "rtsp://") {
+			err = r.pullRTSP(source)
+		} else {
+			err = r.pullFFmpeg(source)
+		}
+		if r.ctx.Err() != nil {
+			return
+		}
+
+		if time.Since(started) >= relayStableAfter {
+			backoff = relayMinBackoff
+		}
+		r.logger.Warn("Relay disconnected", "stream_id", source.StreamID, "error", err, "retry_in", backoff)
+
+		select {
+		case <-r.ctx.Done():
+			return
+		case <-time.After(backoff):
+		}
+		backoff = min(backoff*2, relayMaxBackoff)
+	}
+}
+
+// pullRTSP plays an upstream RTSP stream and publishes it as the stream's
+// producer, as if FFmpeg had announced it. Blocks until the connection ends.
+func (r *Relays) pullRTSP(source RelaySource) error {
+	conn := rtsp.NewClient(source.URL)
+	if err := conn.Dial(); err != nil {
+		return fmt.Errorf("dial: %w", err)
+	}
+	if err := conn.Describe(); err != nil {
+		_ = conn.Stop()
+		return fmt.Errorf("describe: %w", err)
+	}
+	for _, media := range conn.GetMedias() {
+		if media.Direction != core.DirectionRecvonly || len(media.Codecs) == 0 {
+			continue
+		}
+		if _, err := conn.GetTrack(media, media.Codecs[0]); err != nil {
+			_ = conn.Stop()
+			return fmt.Errorf("setup %s: %w", media.Kind, err)
+		}
+	}
+	if len(conn.Receivers) == 0 {
+		_ = conn.Stop()
+		return errors.New("upstream has no tracks")
+	}
+
+	r.hub.AddProducer(source.StreamID, conn)
+	r.hub.ProducerReady(source.StreamID, conn)
+	r.logger.Info("Relay connected", "stream_id", source.StreamID, "tracks", len(conn.Receivers))
+
+	stop := context.AfterFunc(r.ctx, func() { _ = conn.Stop() })
+	defer stop()
+
+	err := conn.Start() // PLAY, then reads until the connection closes
+	r.hub.RemoveProducer(source.StreamID, conn)
+	return err
+}
+
+// pullFFmpeg remuxes an SRT or RTP upstream with FFmpeg, without
+// transcoding, into the local RTSP server. Blocks until FFmpeg exits.
+func (r *Relays) pullFFmpeg(source RelaySource) error {
+	cmd := exec.CommandContext(r.ctx, "ffmpeg", relayFFmpegArgs(source, localRTSPURL(r.rtspAddr, source.StreamID))...)
+	var stderr bytes.Buffer
+	cmd.Stderr = &stderr
+
+	if err := cmd.Run(); err != nil {
+		if line := lastLine(stderr.String()); line != "" {
+			return fmt.Errorf("ffmpeg: %w: %s", err, line)
+		}
+		return fmt.Errorf("ffmpeg: %w", err)
+	}
+	return errors.New("ffmpeg exited")
+}
+
+// relayFFmpegArgs copies the first video and audio stream of the upstream
+// to the local RTSP server.
+func relayFFmpegArgs(source RelaySource, publishURL string) []string {
+	return []string{
+		"-hide_banner", "-loglevel", "error",
+		"-fflags", "nobuffer",
+		"-i", source.URL,
+		"-map", "0:v:0", "-map", "0:a:0?",
+		"-c", "copy",
+		"-f", "rtsp", "-rtsp_transport", "tcp",
+		publishURL,
+	}
+}
+
+// localRTSPURL is the URL a stream is published at on the RTSP server
+// listening on addr.
+func localRTSPURL(addr, streamID string) string {
+	host, port, err := net.SplitHostPort(addr)
+	if err != nil {
+		host, port = "", "8554"
+	}
+	if host == "" || host == "0.0.0.0" || host == "::" {
+		host = "127.0.0.1"
+	}
+	return "rtsp://" + net.JoinHostPort(host, port) + "/" + streamID
+}
+
+func lastLine(s string) string {
+	s = strings.TrimSpace(s)
+	if i := strings.LastIndexByte(s, '\n'); i >= 0 {
+		return s[i+1:]
+	}
+	return s
+}
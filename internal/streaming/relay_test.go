@@ -0,0 +1,104 @@
+package streaming
+
+import (
+	"errors"
+	"io"
+	"log/slog"
+	"slices"
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/AlexxIT/go2rtc/pkg/rtsp"
+)
+
+func TestParseRelaySource(t *testing.T) {
+	tests := []struct {
+		input   string
+		want    RelaySource
+		wantErr bool
+	}{
+		{"cam1=rtsp://capture:8554/cam1", RelaySource{"cam1", "rtsp://capture:8554/cam1"}, false},
+		{" cam1 = srt://capture:9000?mode=caller ", RelaySource{"cam1", "srt://capture:9000?mode=caller"}, false},
+		{"cam1=udp://0.0.0.0:5004", RelaySource{"cam1", "udp://0.0.0.0:5004"}, false},
+		{"rtsp://capture:8554/cam1", RelaySource{}, true},
+		{"=rtsp://capture:8554/cam1", RelaySource{}, true},
+		{"a/b=rtsp://capture:8554/cam1", RelaySource{}, true},
+		{"cam1=http://capture/cam1", RelaySource{}, true},
+	}
+	for _, tt := range tests {
+		t.Run(tt.input, func(t *testing.T) {
+			got, err := ParseRelaySource(tt.input)
+			if tt.wantErr {
+				if !errors.Is(err, ErrInvalidRelay) {
+					t.Errorf("err = %v, want ErrInvalidRelay", err)
+				}
+				return
+			}
+			if err != nil {
+				t.Fatal(err)
+			}
+			if got != tt.want {
+				t.Errorf("got %+v, want %+v", got, tt.want)
+			}
+		})
+	}
+}
+
+func TestLocalRTSPURL(t *testing.T) {
+	tests := []struct {
+		addr string
+		want string
+	}{
+		{":8554", "rtsp://127.0.0.1:8554/cam1"},
+		{"0.0.0.0:9554", "rtsp://127.0.0.1:9554/cam1"},
+		{"192.168.1.5:8554", "rtsp://192.168.1.5:8554/cam1"},
+		{"[::]:8554", "rtsp://127.0.0.1:8554/cam1"},
+		{"bad", "rtsp://127.0.0.1:8554/cam1"},
+	}
+	for _, tt := range tests {
+		if got := localRTSPURL(tt.addr, "cam1"); got != tt.want {
+			t.Errorf("localRTSPURL(%q) = %q, want %q", tt.addr, got, tt.want)
+		}
+	}
+}
+
+func TestRelayFFmpegArgsCopy(t *testing.T) {
+	args := relayFFmpegArgs(RelaySource{"cam1", "srt://capture:9000"}, "rtsp://127.0.0.1:8554/cam1")
+	if !slices.Contains(args, "copy") || slices.Contains(args, "-c:v") {
+		t.Errorf("args %v should copy without transcoding", args)
+	}
+	if args[len(args)-1] != "rtsp://127.0.0.1:8554/cam1" {
+		t.Errorf("args %v don't publish to the local RTSP server", args)
+	}
+}
+
+func TestHubLiveStreamsOrigin(t *testing.T) {
+	hub := NewHub(slog.New(slog.NewTextHandler(io.Discard, nil)))
+	h264 := &core.Codec{Name: core.CodecH264}
+	hub.producers["local"] = rtspProducer{&rtsp.Conn{}}
+	hub.producers["edge"] = rtspProducer{&rtsp.Conn{}}
+	hub.producers["idle"] = newSlateProducer(&slateClip{codec: h264}, 30)
+	hub.setUpstream("edge", "rtsp://capture:8554/cam1")
+	hub.setUpstream("gone", "rtsp://capture:8554/gone") // no producer yet
+
+	want := []LiveStream{
+		{StreamID: "edge", Origin: OriginRelay, Upstream: "rtsp://capture:8554/cam1"},
+		{StreamID: "idle", Origin: OriginSlate, Codecs: []string{core.CodecH264}},
+		{StreamID: "local", Origin: OriginLocal},
+	}
+	got := hub.LiveStreams()
+	if len(got) != len(want) {
+		t.Fatalf("live streams = %+v, want %+v", got, want)
+	}
+	for i := range want {
+		if got[i].StreamID != want[i].StreamID || got[i].Origin != want[i].Origin ||
+			got[i].Upstream != want[i].Upstream || !slices.Equal(got[i].Codecs, want[i].Codecs) {
+			t.Errorf("stream %d = %+v, want %+v", i, got[i], want[i])
+		}
+	}
+
+	hub.setUpstream("edge", "")
+	if got := hub.LiveStreams(); got[0].Origin != OriginLocal {
+		t.Errorf("origin after the relay stopped = %q, want %q", got[0].Origin, OriginLocal)
+	}
+}
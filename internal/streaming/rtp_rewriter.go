@@ -0,0 +1,111 @@
+package streaming
+
+import (
+	"encoding/hex"
+	"strings"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// rtpRewriter makes packets from successive producers look like one
+// continuous RTP stream: a fixed SSRC, contiguous sequence numbers and
+// monotonic timestamps. A restarted FFmpeg picks a new random SSRC, sequence
+// and timestamp base, which browsers would otherwise treat as a broken
+// stream.
+//
+// Injected parameter sets carry the sequence number of the packet they
+// precede. The rewriter gives each of them a slot of its own, so the output
+// has no duplicates while gaps from upstream loss are preserved.
+type rtpRewriter struct {
+	clockRate uint32
+
+	started    bool
+	pending    bool      // next packet starts a new source
+	detachedAt time.Time // when the previous source stopped
+	ssrc       uint32
+	seqOffset  uint16
+	tsOffset   uint32
+	lastInSeq  uint16
+	lastOutSeq uint16
+	lastOutTS  uint32
+}
+
+// rebase makes the next packet continue the stream from a new source.
+func (r *rtpRewriter) rebase() {
+	if r.started {
+		r.pending = true
+		r.detachedAt = time.Now()
+	}
+}
+
+// rewrite maps packet onto the output stream in place. The caller must own
+// the packet: it is rewritten before being handed to any other consumer.
+func (r *rtpRewriter) rewrite(packet *rtp.Packet) {
+	switch {
+	case !r.started:
+		r.started = true
+		r.ssrc = packet.SSRC
+	case r.pending:
+		r.pending = false
+		r.seqOffset = r.lastOutSeq + 1 - packet.SequenceNumber
+		r.tsOffset = r.lastOutTS + r.gapTicks() - packet.Timestamp
+	case packet.SequenceNumber == r.lastInSeq:
+		r.seqOffset++ // injected packet sharing its successor's sequence number
+	}
+	r.lastInSeq = packet.SequenceNumber
+
+	packet.SSRC = r.ssrc
+	packet.SequenceNumber += r.seqOffset
+	packet.Timestamp += r.tsOffset
+
+	r.lastOutSeq = packet.SequenceNumber
+	r.lastOutTS = packet.Timestamp
+}
+
+// gapTicks converts the time without a source into RTP clock ticks, so
+// playout resumes in real time after the gap.
+func (r *rtpRewriter) gapTicks() uint32 {
+	ticks := uint32(time.Since(r.detachedAt).Seconds() * float64(r.clockRate))
+	return max(ticks, 1)
+}
+
+// codecsCompatible reports whether consumers negotiated for codec a can keep
+// receiving codec b. Resolution and bitrate changes are fine, since the
+// decoder picks them up from in-band parameter sets. A different codec,
+// clock rate, channel count or H264/H265 profile requires renegotiation.
+func codecsCompatible(a, b *core.Codec) bool {
+	return a.Name == b.Name &&
+		a.ClockRate == b.ClockRate &&
+		a.Channels == b.Channels &&
+		codecProfile(a) == codecProfile(b)
+}
+
+// codecProfile returns the profile part of a codec's fmtp line, or "" for
+// codecs without one.
+func codecProfile(codec *core.Codec) string {
+	switch codec.Name {
+	case core.CodecH264:
+		// profile_idc and constraint flags, without the level
+		if id := fmtpValue(codec.FmtpLine, "profile-level-id="); len(id) >= 4 {
+			return strings.ToLower(id[:4])
+		}
+		if sps, _ := parseSpsPps(codec.FmtpLine); len(sps) >= 3 {
+			return hex.EncodeToString(sps[1:3])
+		}
+	case core.CodecH265:
+		return fmtpValue(codec.FmtpLine, "profile-id=")
+	}
+	return ""
+}
+
+// fmtpValue returns the value of a single fmtp parameter.
+func fmtpValue(fmtpLine, prefix string) string {
+	for param := range strings.SplitSeq(fmtpLine, ";") {
+		if value, found := strings.CutPrefix(strings.TrimSpace(param), prefix); found {
+			return value
+		}
+	}
+	return ""
+}
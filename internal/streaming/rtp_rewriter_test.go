@@ -0,0 +1,120 @@
+package streaming
+
+import (
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+func TestRTPRewriter_Handover(t *testing.T) {
+	r := rtpRewriter{clockRate: 90000}
+
+	var out []*rtp.Packet
+	send := func(ssrc uint32, seq uint16, ts uint32) {
+		packet := &rtp.Packet{Header: rtp.Header{SSRC: ssrc, SequenceNumber: seq, Timestamp: ts}}
+		r.rewrite(packet)
+		out = append(out, packet)
+	}
+
+	send(111, 100, 3000)
+	send(111, 101, 3000) // injected packet sharing the next packet's sequence number
+	send(111, 101, 3000)
+	send(111, 103, 6000) // upstream loss of 102
+
+	r.rebase()
+	send(222, 5000, 900000) // new producer with a new SSRC and bases
+	send(222, 5001, 903000)
+
+	wantSeq := []uint16{100, 101, 102, 104, 105, 106}
+	for i, pkt := range out {
+		if pkt.SSRC != 111 {
+			t.Errorf("packet %d: SSRC = %d, want 111", i, pkt.SSRC)
+		}
+		if pkt.SequenceNumber != wantSeq[i] {
+			t.Errorf("packet %d: seq = %d, want %d", i, pkt.SequenceNumber, wantSeq[i])
+		}
+	}
+
+	if out[4].Timestamp <= out[3].Timestamp {
+		t.Errorf("timestamp should advance across handover: %d after %d", out[4].Timestamp, out[3].Timestamp)
+	}
+	if out[5].Timestamp-out[4].Timestamp != 3000 {
+		t.Errorf("timestamp delta after handover = %d, want 3000", out[5].Timestamp-out[4].Timestamp)
+	}
+}
+
+func BenchmarkRTPRewriter_Rewrite(b *testing.B) {
+	r := rtpRewriter{clockRate: 90000}
+	packet := &rtp.Packet{
+		Header:  rtp.Header{SSRC: 1, Timestamp: 1000},
+		Payload: make([]byte, 1200),
+	}
+
+	b.ReportAllocs()
+	i := 0
+	for b.Loop() {
+		if i%1000 == 0 {
+			r.rebase() // a producer restart now and then
+		}
+		packet.SequenceNumber++
+		r.rewrite(packet)
+		i++
+	}
+}
+
+func TestCodecsCompatible(t *testing.T) {
+	h264 := func(fmtp string) *core.Codec {
+		return &core.Codec{Name: core.CodecH264, ClockRate: 90000, FmtpLine: fmtp}
+	}
+
+	tests := []struct {
+		name string
+		a, b *core.Codec
+		want bool
+	}{
+		{
+			"same profile, different level and parameter sets",
+			h264("packetization-mode=1;profile-level-id=42e01f;sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA=="),
+			h264("packetization-mode=1; profile-level-id=42E028"),
+			true,
+		},
+		{
+			"different H264 profile",
+			h264("profile-level-id=42e01f"),
+			h264("profile-level-id=64001f"),
+			false,
+		},
+		{
+			"profile from SPS",
+			h264("sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA=="),
+			h264("profile-level-id=420029"),
+			true,
+		},
+		{
+			"different codec",
+			h264("profile-level-id=42e01f"),
+			&core.Codec{Name: core.CodecH265, ClockRate: 90000},
+			false,
+		},
+		{
+			"different audio channels",
+			&core.Codec{Name: core.CodecOpus, ClockRate: 48000, Channels: 2},
+			&core.Codec{Name: core.CodecOpus, ClockRate: 48000, Channels: 1},
+			false,
+		},
+		{
+			"different H265 profile",
+			&core.Codec{Name: core.CodecH265, ClockRate: 90000, FmtpLine: "profile-id=1"},
+			&core.Codec{Name: core.CodecH265, ClockRate: 90000, FmtpLine: "profile-id=2"},
+			false,
+		},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := codecsCompatible(tt.a, tt.b); got != tt.want {
+				t.Errorf("codecsCompatible() = %v, want %v", got, tt.want)
+			}
+		})
+	}
+}
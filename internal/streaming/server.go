@@ -77,6 +77,14 @@ func (s *Server) handleConn(conn net.Conn) {
 
 	// Listen for RTSP method events
 	rtspConn.Listen(func(msg any) {
+		if report, ok := msg.(*rtsp.RTCP); ok {
+			// Sender reports anchor latency tracing
+			if streamID != "" {
+				s.hub.ProducerRTCP(streamID, rtspConn, report.Channel, report.Packets)
+			}
+			return
+		}
+
 		switch msg {
 		case rtsp.MethodAnnounce:
 			// FFmpeg pushing stream via ANNOUNCE
@@ -110,9 +118,17 @@ func (s *Server) handleConn(conn net.Conn) {
 		if !errors.Is(err, net.ErrClosed) {
 			s.logger.Debug("RTSP accept error", "error", err)
 		}
+		if streamID != "" {
+			s.hub.RemoveProducer(streamID, rtspConn)
+		}
 		return
 	}
 
+	// Producer tracks are set up: continue existing consumers on them
+	if streamID != "" {
+		s.hub.ProducerReady(streamID, rtspConn)
+	}
+
 	// Handle data transfer (blocks until connection closes)
 	if err := rtspConn.Handle(); err != nil {
 		if !errors.Is(err, net.ErrClosed) {
@@ -122,7 +138,7 @@ func (s *Server) handleConn(conn net.Conn) {
 
 	// Clean up producer on disconnect
 	if streamID != "" {
-		s.hub.RemoveProducer(streamID)
+		s.hub.RemoveProducer(streamID, rtspConn)
 		s.logger.Info("RTSP producer disconnected", "stream_id", streamID)
 	}
 }
@@ -149,6 +165,16 @@ func (s *Server) Stop() error {
 	return nil
 }
 
+// Addr returns the address the server is listening on, or nil before Start.
+func (s *Server) Addr() net.Addr {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.listener == nil {
+		return nil
+	}
+	return s.listener.Addr()
+}
+
 // Hub returns the server's stream hub.
 func (s *Server) Hub() *Hub {
 	return s.hub
@@ -0,0 +1,329 @@
+package streaming
+
+import (
+	"bytes"
+	"encoding/base64"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"math/rand/v2"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// slateMTU is the largest RTP payload of a slate packet, the same budget
+// FFmpeg's RTP muxer uses for WebRTC-friendly packets.
+const slateMTU = 1200
+
+// NAL unit types that need special handling when splitting a slate clip.
+const (
+	h264NALAUD = 9
+	h265NALAUD = 35
+	h265NALSEI = 40 // Suffix SEI, belongs to the preceding picture
+)
+
+// ErrInvalidSlate is returned when slate data can't be played.
+var ErrInvalidSlate = errors.New("invalid slate")
+
+// PlaySlate makes the hub itself the producer of a stream, looping a
+// pre-encoded clip until a live producer connects (see AddProducer) or
+// StopSlate is called. The clip is an Annex B byte stream (codec "h264" or
+// "h265") that starts with a keyframe, usually one GOP of a static no-signal
+// image, played at fps frames per second. Packets get continuous sequence
+// numbers and timestamps across loops.
+//
+// Existing WebRTC consumers continue on the slate when its codec is
+// compatible with theirs, like on a restarted producer. Their audio tracks
+// stay silent until a live producer returns, unless the stream has a
+// separate audio source (see SetAudioSource).
+func (h *Hub) PlaySlate(streamID, codec string, data []byte, fps int) error {
+	clip, err := newSlateClip(codec, data)
+	if err != nil {
+		return err
+	}
+	if fps <= 0 {
+		return fmt.Errorf("%w: fps %d", ErrInvalidSlate, fps)
+	}
+	slate := newSlateProducer(clip, fps)
+
+	h.mu.Lock()
+	if existing, ok := h.producers[streamID]; ok {
+		existing.stop()
+		h.detachFanoutsLocked(streamID)
+	}
+	h.cancelHandoverLocked(streamID)
+	h.producers[streamID] = slate
+
+	var callback func(streamID string)
+	if len(h.fanouts[streamID]) > 0 {
+		callback = h.attachFanoutsLocked(streamID, h.streamTracksLocked(streamID, slate), true)
+	}
+	h.mu.Unlock()
+
+	go slate.play()
+	h.logger.Info("Playing slate", "stream_id", streamID, "codec", clip.codec.Name, "frames", len(clip.frames))
+
+	if callback != nil {
+		go callback(streamID)
+	}
+	return nil
+}
+
+// StopSlate stops a stream's slate, if it is playing one. Like a
+// disconnected producer, its WebRTC consumers wait for the handover timeout
+// for a live producer to continue their stream.
+func (h *Hub) StopSlate(streamID string) {
+	h.mu.Lock()
+
+	var callback func(streamID string)
+	if slate, ok := h.producers[streamID].(*slateProducer); ok {
+		slate.stop()
+		delete(h.producers, streamID)
+		h.logger.Info("Slate stopped", "stream_id", streamID)
+
+		if len(h.fanouts[streamID]) > 0 {
+			h.detachFanoutsLocked(streamID)
+			h.startHandoverLocked(streamID)
+		} else {
+			callback = h.onProducerReplaced
+		}
+	}
+	h.mu.Unlock()
+
+	if callback != nil {
+		go callback(streamID)
+	}
+}
+
+// slateClip is a pre-encoded clip split into RTP payloads per frame.
+type slateClip struct {
+	codec  *core.Codec
+	frames [][][]byte // frame -> RTP payloads, in send order
+}
+
+// newSlateClip splits an Annex B byte stream into frames, packetizes them for
+// RTP (single NAL unit and FU packets) and derives the codec's fmtp line from
+// the in-band parameter sets.
+func newSlateClip(codec string, data []byte) (*slateClip, error) {
+	var isH265 bool
+	switch strings.ToLower(codec) {
+	case "h264":
+	case "h265", "hevc":
+		isH265 = true
+	default:
+		return nil, fmt.Errorf("%w: unsupported codec %q", ErrInvalidSlate, codec)
+	}
+
+	clip := &slateClip{}
+	var vps, sps, pps []byte
+	var frame [][]byte
+	var frameHasPicture bool
+	for _, nal := range splitAnnexB(data) {
+		var nalType byte
+		var isPicture, startsPicture bool
+		if isH265 {
+			if len(nal) < 3 {
+				continue
+			}
+			nalType = h265NALType(nal[0])
+			isPicture = nalType < h265NALVPS
+			startsPicture = isPicture && nal[2]&0x80 != 0 // first_slice_segment_in_pic_flag
+			switch nalType {
+			case h265NALAUD:
+				continue
+			case h265NALVPS:
+				vps = firstNAL(vps, nal)
+			case h265NALSPS:
+				sps = firstNAL(sps, nal)
+			case h265NALPPS:
+				pps = firstNAL(pps, nal)
+			}
+		} else {
+			if len(nal) < 2 {
+				continue
+			}
+			nalType = nal[0] & 0x1F
+			isPicture = nalType >= 1 && nalType <= h264NALIDR
+			startsPicture = isPicture && nal[1]&0x80 != 0 // first_mb_in_slice == 0
+			switch nalType {
+			case h264NALAUD:
+				continue
+			case h264NALSPS:
+				sps = firstNAL(sps, nal)
+			case h264NALPPS:
+				pps = firstNAL(pps, nal)
+			}
+		}
+
+		// A new frame starts with its first slice, or with the parameter
+		// sets and SEI that precede it
+		suffix := isH265 && nalType == h265NALSEI
+		if frameHasPicture && (startsPicture || !isPicture && !suffix) {
+			clip.frames = append(clip.frames, frame)
+			frame, frameHasPicture = nil, false
+		}
+		frame = append(frame, packetizeNAL(nal, isH265)...)
+		frameHasPicture = frameHasPicture || isPicture
+	}
+	if frameHasPicture {
+		clip.frames = append(clip.frames, frame)
+	}
+
+	if len(clip.frames) == 0 || sps == nil || pps == nil || isH265 && vps == nil {
+		return nil, fmt.Errorf("%w: no keyframe with parameter sets", ErrInvalidSlate)
+	}
+
+	b64 := base64.StdEncoding.EncodeToString
+	if isH265 {
+		clip.codec = &core.Codec{
+			Name:        core.CodecH265,
+			ClockRate:   90000,
+			PayloadType: 96,
+			FmtpLine:    "sprop-vps=" + b64(vps) + ";sprop-sps=" + b64(sps) + ";sprop-pps=" + b64(pps),
+		}
+	} else {
+		if len(sps) < 4 {
+			return nil, fmt.Errorf("%w: short SPS", ErrInvalidSlate)
+		}
+		clip.codec = &core.Codec{
+			Name:        core.CodecH264,
+			ClockRate:   90000,
+			PayloadType: 96,
+			FmtpLine: "packetization-mode=1;sprop-parameter-sets=" + b64(sps) + "," + b64(pps) +
+				";profile-level-id=" + strings.ToUpper(hex.EncodeToString(sps[1:4])),
+		}
+	}
+	return clip, nil
+}
+
+// firstNAL keeps the first parameter set of its type seen in a clip.
+func firstNAL(current, nal []byte) []byte {
+	if current != nil {
+		return current
+	}
+	return nal
+}
+
+// splitAnnexB returns the NAL units of an Annex B byte stream, without start
+// codes. The units share data's backing array.
+func splitAnnexB(data []byte) [][]byte {
+	var nals [][]byte
+	start := -1
+	for i := 0; i+2 < len(data); {
+		if data[i] != 0 || data[i+1] != 0 || data[i+2] != 1 {
+			i++
+			continue
+		}
+		if start >= 0 {
+			nals = append(nals, bytes.TrimRight(data[start:i], "\x00"))
+		}
+		i += 3
+		start = i
+	}
+	if start >= 0 && start < len(data) {
+		nals = append(nals, data[start:])
+	}
+	return nals
+}
+
+// packetizeNAL returns the RTP payloads of a NAL unit: the unit itself if it
+// fits, or fragmentation units (FU-A for H264, FU for H265) otherwise.
+func packetizeNAL(nal []byte, isH265 bool) [][]byte {
+	if len(nal) <= slateMTU {
+		return [][]byte{nal}
+	}
+
+	var header []byte // payload header and FU header, start bit set
+	var body []byte
+	if isH265 {
+		header = []byte{nal[0]&0x81 | h265NALFU<<1, nal[1], 0x80 | h265NALType(nal[0])}
+		body = nal[2:]
+	} else {
+		header = []byte{nal[0]&0xE0 | h264NALFUA, 0x80 | nal[0]&0x1F}
+		body = nal[1:]
+	}
+
+	fuHeader := len(header) - 1
+	chunk := slateMTU - len(header)
+	var payloads [][]byte
+	for len(body) > 0 {
+		n := min(chunk, len(body))
+		payload := make([]byte, 0, len(header)+n)
+		payload = append(payload, header...)
+		if n == len(body) {
+			payload[fuHeader] |= 0x40 // end bit
+		}
+		payloads = append(payloads, append(payload, body[:n]...))
+		body = body[n:]
+		header[fuHeader] &^= 0x80 // start bit only on the first fragment
+	}
+	return payloads
+}
+
+// slateProducer loops a slate clip in real time on a single video track.
+type slateProducer struct {
+	clip     *slateClip
+	fps      int
+	receiver *core.Receiver
+	done     chan struct{}
+	stopOnce sync.Once
+}
+
+func newSlateProducer(clip *slateClip, fps int) *slateProducer {
+	media := &core.Media{
+		Kind:      core.KindVideo,
+		Direction: core.DirectionRecvonly,
+		Codecs:    []*core.Codec{clip.codec},
+	}
+	return &slateProducer{
+		clip:     clip,
+		fps:      fps,
+		receiver: core.NewReceiver(media, clip.codec),
+		done:     make(chan struct{}),
+	}
+}
+
+func (s *slateProducer) tracks() []*core.Receiver { return []*core.Receiver{s.receiver} }
+
+func (s *slateProducer) stop() {
+	s.stopOnce.Do(func() { close(s.done) })
+}
+
+// play sends one frame per tick until stopped. Timestamps are derived from
+// the frame count, so they stay exact however the ticker drifts.
+func (s *slateProducer) play() {
+	ticker := time.NewTicker(time.Second / time.Duration(s.fps))
+	defer ticker.Stop()
+
+	ssrc := rand.Uint32()
+	seq := uint16(rand.Uint32())
+	ticksPerFrame := s.clip.codec.ClockRate / uint32(s.fps)
+
+	for n := uint32(0); ; n++ {
+		frame := s.clip.frames[int(n)%len(s.clip.frames)]
+		for i, payload := range frame {
+			s.receiver.Input(&rtp.Packet{
+				Header: rtp.Header{
+					Version:        2,
+					Marker:         i == len(frame)-1,
+					PayloadType:    s.clip.codec.PayloadType,
+					SequenceNumber: seq,
+					Timestamp:      n * ticksPerFrame,
+					SSRC:           ssrc,
+				},
+				Payload: payload,
+			})
+			seq++
+		}
+
+		select {
+		case <-ticker.C:
+		case <-s.done:
+			return
+		}
+	}
+}
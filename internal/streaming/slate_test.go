@@ -0,0 +1,136 @@
+package streaming
+
+import (
+	"bytes"
+	"errors"
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// annexB joins NAL units into an Annex B byte stream.
+func annexB(nals ...[]byte) []byte {
+	var data []byte
+	for _, nal := range nals {
+		data = append(data, annexBStartCode...)
+		data = append(data, nal...)
+	}
+	return data
+}
+
+// nalWithBody returns a NAL unit of header followed by size filler bytes.
+func nalWithBody(size int, header ...byte) []byte {
+	return append(header, bytes.Repeat([]byte{0xAB}, size)...)
+}
+
+func TestSplitAnnexB(t *testing.T) {
+	data := []byte{0, 0, 0, 1, 0x67, 0x01, 0, 0, 1, 0x68, 0x02, 0, 0, 0, 1, 0x65, 0x03}
+
+	nals := splitAnnexB(data)
+	want := [][]byte{{0x67, 0x01}, {0x68, 0x02}, {0x65, 0x03}}
+	if len(nals) != len(want) {
+		t.Fatalf("got %d NAL units, want %d", len(nals), len(want))
+	}
+	for i := range want {
+		if !bytes.Equal(nals[i], want[i]) {
+			t.Errorf("NAL %d = % x, want % x", i, nals[i], want[i])
+		}
+	}
+}
+
+func TestNewSlateClip(t *testing.T) {
+	h264SPS := []byte{0x67, 0x64, 0x00, 0x1F, 0xAC}
+	h264PPS := []byte{0x68, 0xEE, 0x3C, 0x80}
+	h264IDR := nalWithBody(2500, 0x65, 0x88)
+	h265VPS := []byte{0x40, 0x01, 0x0C}
+	h265SPS := []byte{0x42, 0x01, 0x01}
+	h265PPS := []byte{0x44, 0x01, 0xC1}
+	h265IDR := nalWithBody(2000, 0x26, 0x01, 0xAF) // IDR_W_RADL, first slice
+	h265SEI := []byte{0x50, 0x01, 0x05}            // suffix SEI
+
+	tests := []struct {
+		name         string
+		codec        string
+		data         []byte
+		wantCodec    string
+		wantFmtp     string
+		wantFrames   int
+		wantKeyframe []byte
+	}{
+		{
+			name:         "h264 keyframe fragmented with FU-A",
+			codec:        "h264",
+			data:         annexB([]byte{0x09, 0xF0}, h264SPS, h264PPS, h264IDR, []byte{0x09, 0xF0}, []byte{0x41, 0x9A, 0x01}),
+			wantCodec:    core.CodecH264,
+			wantFmtp:     "packetization-mode=1;sprop-parameter-sets=Z2QAH6w=,aO48gA==;profile-level-id=64001F",
+			wantFrames:   2,
+			wantKeyframe: annexB(h264SPS, h264PPS, h264IDR),
+		},
+		{
+			name:         "h265 keyframe with suffix SEI",
+			codec:        "hevc",
+			data:         annexB(h265VPS, h265SPS, h265PPS, h265IDR, h265SEI, []byte{0x02, 0x01, 0xD0}),
+			wantCodec:    core.CodecH265,
+			wantFmtp:     "sprop-vps=QAEM;sprop-sps=QgEB;sprop-pps=RAHB",
+			wantFrames:   2,
+			wantKeyframe: annexB(h265VPS, h265SPS, h265PPS, h265IDR, h265SEI),
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			clip, err := newSlateClip(tt.codec, tt.data)
+			if err != nil {
+				t.Fatalf("newSlateClip() error = %v", err)
+			}
+			if clip.codec.Name != tt.wantCodec || clip.codec.FmtpLine != tt.wantFmtp {
+				t.Errorf("codec = %s %q, want %s %q", clip.codec.Name, clip.codec.FmtpLine, tt.wantCodec, tt.wantFmtp)
+			}
+			if len(clip.frames) != tt.wantFrames {
+				t.Fatalf("got %d frames, want %d", len(clip.frames), tt.wantFrames)
+			}
+
+			// The first frame depacketizes back to the original keyframe
+			collector := newKeyframeCollector(tt.wantCodec)
+			for i, payload := range clip.frames[0] {
+				if len(payload) > slateMTU {
+					t.Errorf("payload %d is %d bytes, over the MTU", i, len(payload))
+				}
+				collector.handlePacket(&rtp.Packet{
+					Header:  rtp.Header{Timestamp: 0, Marker: i == len(clip.frames[0])-1},
+					Payload: payload,
+				})
+			}
+			select {
+			case got := <-collector.done:
+				if !bytes.Equal(got, tt.wantKeyframe) {
+					t.Errorf("keyframe = %d bytes, want %d bytes", len(got), len(tt.wantKeyframe))
+				}
+			default:
+				t.Fatal("keyframe not completed")
+			}
+		})
+	}
+}
+
+func TestNewSlateClip_Invalid(t *testing.T) {
+	tests := []struct {
+		name  string
+		codec string
+		data  []byte
+	}{
+		{"unsupported codec", "vp8", annexB([]byte{0x65, 0x88})},
+		{"no parameter sets", "h264", annexB([]byte{0x65, 0x88, 0x01})},
+		{"h265 without VPS", "h265", annexB([]byte{0x42, 0x01, 0x01}, []byte{0x44, 0x01, 0xC1}, []byte{0x26, 0x01, 0xAF})},
+		{"empty", "h264", nil},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if _, err := newSlateClip(tt.codec, tt.data); !errors.Is(err, ErrInvalidSlate) {
+				t.Errorf("newSlateClip() error = %v, want ErrInvalidSlate", err)
+			}
+		})
+	}
+}
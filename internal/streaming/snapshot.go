@@ -0,0 +1,203 @@
+package streaming
+
+import (
+	"context"
+	"encoding/binary"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+// H264 NAL unit types (RFC 6184).
+const (
+	h264NALIDR   = 5
+	h264NALSPS   = 7
+	h264NALPPS   = 8
+	h264NALSTAPA = 24
+	h264NALFUA   = 28
+)
+
+// annexBStartCode precedes every NAL unit of an Annex B byte stream.
+var annexBStartCode = []byte{0, 0, 0, 1}
+
+// Keyframe is a complete keyframe (IDR/IRAP access unit with its parameter
+// sets) taken from a stream, ready to be decoded on its own.
+type Keyframe struct {
+	Codec string // core.CodecH264 or core.CodecH265
+	Data  []byte // Annex B byte stream
+}
+
+// Keyframe returns the latest keyframe of a stream's video track. Streams
+// with a GOP cache answer immediately from the cached GOP; others wait for
+// the stream's next keyframe, up to a whole GOP, until ctx is done.
+func (h *Hub) Keyframe(ctx context.Context, streamID string) (*Keyframe, error) {
+	prod := h.getProducer(streamID)
+	if prod == nil {
+		return nil, ErrStreamNotFound
+	}
+	receiver := findReceiver(prod.tracks(), core.KindVideo)
+	if receiver == nil {
+		return nil, ErrTrackNotFound
+	}
+	if !supportsPassthrough(receiver.Codec) {
+		return nil, ErrCodecNotSupported
+	}
+
+	collector := newKeyframeCollector(receiver.Codec.Name)
+	attachment, err := h.AttachTrack(streamID, core.KindVideo, collector.handlePacket)
+	if err != nil {
+		return nil, err
+	}
+	defer attachment.Close()
+
+	select {
+	case data := <-collector.done:
+		return &Keyframe{Codec: attachment.Codec.Name, Data: data}, nil
+	case <-ctx.Done():
+		return nil, ctx.Err()
+	}
+}
+
+// keyframeCollector reassembles the first keyframe of an RTP stream into an
+// Annex B access unit. It skips packets until a keyframe starts (parameter
+// sets or the IDR/IRAP itself) and completes on the marker bit, or when a
+// packet of the next frame arrives. It runs on the attachment's sender
+// goroutine.
+type keyframeCollector struct {
+	codec     string
+	started   bool
+	finished  bool
+	timestamp uint32
+	buf       []byte
+	done      chan []byte
+}
+
+func newKeyframeCollector(codec string) *keyframeCollector {
+	return &keyframeCollector{codec: codec, done: make(chan []byte, 1)}
+}
+
+func (c *keyframeCollector) handlePacket(packet *rtp.Packet) {
+	if c.finished || len(packet.Payload) == 0 {
+		return
+	}
+
+	if !c.started {
+		if !c.startsKeyframe(packet.Payload) {
+			return
+		}
+		c.started = true
+		c.timestamp = packet.Timestamp
+	} else if packet.Timestamp != c.timestamp {
+		c.finish() // the access unit ended without a marker bit
+		return
+	}
+
+	if c.codec == core.CodecH265 {
+		c.appendH265(packet.Payload)
+	} else {
+		c.appendH264(packet.Payload)
+	}
+
+	if packet.Marker {
+		c.finish()
+	}
+}
+
+func (c *keyframeCollector) finish() {
+	c.finished = true
+	c.done <- c.buf
+}
+
+// startsKeyframe reports whether a payload is the first packet of a keyframe.
+func (c *keyframeCollector) startsKeyframe(payload []byte) bool {
+	if c.codec == core.CodecH265 {
+		if len(payload) < 3 {
+			return false
+		}
+		nalType := h265NALType(payload[0])
+		switch {
+		case nalType == h265NALAP:
+			return len(payload) >= 5 && isKeyframeStartH265(h265NALType(payload[4]))
+		case nalType == h265NALFU:
+			return payload[2]&0x80 != 0 && isH265IRAP(payload[2]&0x3F)
+		default:
+			return isKeyframeStartH265(nalType)
+		}
+	}
+
+	nalType := payload[0] & 0x1F
+	switch nalType {
+	case h264NALSTAPA:
+		return len(payload) >= 4 && isKeyframeStartH264(payload[3]&0x1F)
+	case h264NALFUA:
+		return len(payload) >= 2 && payload[1]&0x80 != 0 && payload[1]&0x1F == h264NALIDR
+	default:
+		return isKeyframeStartH264(nalType)
+	}
+}
+
+func isKeyframeStartH264(nalType byte) bool {
+	return nalType == h264NALSPS || nalType == h264NALPPS || nalType == h264NALIDR
+}
+
+func isKeyframeStartH265(nalType byte) bool {
+	return isH265ParameterSet(nalType) || isH265IRAP(nalType)
+}
+
+func (c *keyframeCollector) appendH264(payload []byte) {
+	switch payload[0] & 0x1F {
+	case h264NALSTAPA:
+		c.appendAggregated(payload[1:])
+	case h264NALFUA:
+		if len(payload) < 2 {
+			return
+		}
+		if payload[1]&0x80 != 0 {
+			c.buf = append(c.buf, annexBStartCode...)
+			c.buf = append(c.buf, payload[0]&0xE0|payload[1]&0x1F)
+		}
+		c.buf = append(c.buf, payload[2:]...)
+	default:
+		c.appendNAL(payload)
+	}
+}
+
+func (c *keyframeCollector) appendH265(payload []byte) {
+	if len(payload) < 2 {
+		return
+	}
+	switch h265NALType(payload[0]) {
+	case h265NALAP:
+		c.appendAggregated(payload[2:])
+	case h265NALFU:
+		if len(payload) < 3 {
+			return
+		}
+		if payload[2]&0x80 != 0 {
+			c.buf = append(c.buf, annexBStartCode...)
+			c.buf = append(c.buf, payload[0]&0x81|(payload[2]&0x3F)<<1, payload[1])
+		}
+		c.buf = append(c.buf, payload[3:]...)
+	default:
+		c.appendNAL(payload)
+	}
+}
+
+// appendAggregated appends the NAL units of a STAP-A/AP payload, each
+// prefixed with its 16-bit size.
+func (c *keyframeCollector) appendAggregated(payload []byte) {
+	for len(payload) >= 2 {
+		size := int(binary.BigEndian.Uint16(payload))
+		payload = payload[2:]
+		if size == 0 || size > len(payload) {
+			return
+		}
+		c.appendNAL(payload[:size])
+		payload = payload[size:]
+	}
+}
+
+func (c *keyframeCollector) appendNAL(nal []byte) {
+	c.buf = append(c.buf, annexBStartCode...)
+	c.buf = append(c.buf, nal...)
+}
@@ -0,0 +1,97 @@
+package streaming
+
+import (
+	"bytes"
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+)
+
+func rtpPacket(timestamp uint32, marker bool, payload ...byte) *rtp.Packet {
+	return &rtp.Packet{
+		Header:  rtp.Header{Timestamp: timestamp, Marker: marker},
+		Payload: payload,
+	}
+}
+
+func TestKeyframeCollector(t *testing.T) {
+	tests := []struct {
+		name    string
+		codec   string
+		packets []*rtp.Packet
+		want    []byte // nil: no keyframe completed
+	}{
+		{
+			name:  "h264 skips frames before the keyframe",
+			codec: core.CodecH264,
+			packets: []*rtp.Packet{
+				rtpPacket(100, true, 0x41, 0xAA), // P-frame
+				rtpPacket(200, false, 0x67, 0x01),
+				rtpPacket(200, false, 0x68, 0x02),
+				rtpPacket(200, true, 0x65, 0x03),
+			},
+			want: []byte{0, 0, 0, 1, 0x67, 0x01, 0, 0, 0, 1, 0x68, 0x02, 0, 0, 0, 1, 0x65, 0x03},
+		},
+		{
+			name:  "h264 STAP-A and FU-A",
+			codec: core.CodecH264,
+			packets: []*rtp.Packet{
+				rtpPacket(200, false, 0x18, 0x00, 0x02, 0x67, 0x01, 0x00, 0x02, 0x68, 0x02),
+				rtpPacket(200, false, 0x7C, 0x85, 0x03), // FU-A start, IDR
+				rtpPacket(200, true, 0x7C, 0x45, 0x04),  // FU-A end
+			},
+			want: []byte{0, 0, 0, 1, 0x67, 0x01, 0, 0, 0, 1, 0x68, 0x02, 0, 0, 0, 1, 0x65, 0x03, 0x04},
+		},
+		{
+			name:  "h264 ends on the next frame without marker",
+			codec: core.CodecH264,
+			packets: []*rtp.Packet{
+				rtpPacket(200, false, 0x65, 0x03),
+				rtpPacket(300, false, 0x41, 0xAA),
+			},
+			want: []byte{0, 0, 0, 1, 0x65, 0x03},
+		},
+		{
+			name:  "h264 incomplete keyframe",
+			codec: core.CodecH264,
+			packets: []*rtp.Packet{
+				rtpPacket(200, false, 0x7C, 0x85, 0x03),
+			},
+		},
+		{
+			name:  "h265 AP and FU",
+			codec: core.CodecH265,
+			packets: []*rtp.Packet{
+				rtpPacket(100, true, 0x02, 0x01, 0xAA),                          // TRAIL_R
+				rtpPacket(200, false, 0x60, 0x01, 0x00, 0x03, 0x40, 0x01, 0x0C), // AP with VPS
+				rtpPacket(200, false, 0x62, 0x01, 0x93, 0x05),                   // FU start, IDR_W_RADL (19)
+				rtpPacket(200, true, 0x62, 0x01, 0x53, 0x06),                    // FU end
+			},
+			want: []byte{0, 0, 0, 1, 0x40, 0x01, 0x0C, 0, 0, 0, 1, 0x26, 0x01, 0x05, 0x06},
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			collector := newKeyframeCollector(tt.codec)
+			for _, packet := range tt.packets {
+				collector.handlePacket(packet)
+			}
+
+			select {
+			case got := <-collector.done:
+				if tt.want == nil {
+					t.Fatalf("got keyframe % x, want none", got)
+				}
+				if !bytes.Equal(got, tt.want) {
+					t.Errorf("keyframe = % x, want % x", got, tt.want)
+				}
+			default:
+				if tt.want != nil {
+					t.Fatal("keyframe not completed")
+				}
+			}
+		})
+	}
+}
@@ -0,0 +1,257 @@
+package streaming
+
+import "errors"
+
+// errShortSPS is returned when an SPS ends before the fields the recorder
+// needs.
+var errShortSPS = errors.New("sps truncated")
+
+// bitReader reads the bits and Exp-Golomb codes of an RBSP.
+type bitReader struct {
+	data []byte
+	pos  int // in bits
+	err  error
+}
+
+func (r *bitReader) bit() uint32 {
+	if r.pos >= len(r.data)*8 {
+		r.err = errShortSPS
+		return 0
+	}
+	b := r.data[r.pos/8] >> (7 - r.pos%8) & 1
+	r.pos++
+	return uint32(b)
+}
+
+func (r *bitReader) bits(n int) uint32 {
+	var v uint32
+	for range n {
+		v = v<<1 | r.bit()
+	}
+	return v
+}
+
+func (r *bitReader) skip(n int) {
+	r.pos += n
+	if r.pos > len(r.data)*8 {
+		r.err = errShortSPS
+	}
+}
+
+// ue reads an unsigned Exp-Golomb code.
+func (r *bitReader) ue() uint32 {
+	zeros := 0
+	for r.bit() == 0 {
+		if r.err != nil || zeros == 31 {
+			r.err = errShortSPS
+			return 0
+		}
+		zeros++
+	}
+	return 1<<zeros - 1 + r.bits(zeros)
+}
+
+// se reads a signed Exp-Golomb code.
+func (r *bitReader) se() int32 {
+	v := r.ue()
+	if v&1 != 0 {
+		return int32(v/2 + 1)
+	}
+	return -int32(v / 2)
+}
+
+// unescapeRBSP removes the emulation prevention bytes (00 00 03) of a NAL
+// unit payload.
+func unescapeRBSP(nal []byte) []byte {
+	out := make([]byte, 0, len(nal))
+	zeros := 0
+	for _, b := range nal {
+		if zeros >= 2 && b == 3 {
+			zeros = 0
+			continue
+		}
+		out = append(out, b)
+		if b == 0 {
+			zeros++
+		} else {
+			zeros = 0
+		}
+	}
+	return out
+}
+
+// h264HighProfiles have chroma format and scaling list fields in their SPS.
+var h264HighProfiles = map[uint32]bool{100: true, 110: true, 122: true, 244: true, 44: true, 83: true, 86: true, 118: true, 128: true, 138: true, 139: true, 134: true, 135: true}
+
+// parseH264SPSSize returns the picture size coded in an H.264 SPS NAL unit
+// (ITU-T H.264 7.3.2.1.1).
+func parseH264SPSSize(sps []byte) (width, height int, err error) {
+	if len(sps) < 4 {
+		return 0, 0, errShortSPS
+	}
+	r := bitReader{data: unescapeRBSP(sps[1:])}
+	profile := r.bits(8)
+	r.skip(16) // constraint flags, level
+	r.ue()     // seq_parameter_set_id
+
+	chromaFormat := uint32(1)
+	separateColourPlane := false
+	if h264HighProfiles[profile] {
+		chromaFormat = r.ue()
+		if chromaFormat == 3 {
+			separateColourPlane = r.bit() == 1
+		}
+		r.ue()    // bit_depth_luma_minus8
+		r.ue()    // bit_depth_chroma_minus8
+		r.skip(1) // qpprime_y_zero_transform_bypass_flag
+		if r.bit() == 1 {
+			lists := 8
+			if chromaFormat == 3 {
+				lists = 12
+			}
+			for i := range lists {
+				if r.bit() == 1 {
+					size := 16
+					if i >= 6 {
+						size = 64
+					}
+					skipScalingList(&r, size)
+				}
+			}
+		}
+	}
+
+	r.ue() // log2_max_frame_num_minus4
+	switch r.ue() {
+	case 0:
+		r.ue() // log2_max_pic_order_cnt_lsb_minus4
+	case 1:
+		r.skip(1)
+		r.se()
+		r.se()
+		for range r.ue() {
+			r.se()
+		}
+	}
+	r.ue()    // max_num_ref_frames
+	r.skip(1) // gaps_in_frame_num_value_allowed_flag
+	widthMbs := r.ue() + 1
+	heightMapUnits := r.ue() + 1
+	frameMbsOnly := r.bit()
+	if frameMbsOnly == 0 {
+		r.skip(1) // mb_adaptive_frame_field_flag
+	}
+	r.skip(1) // direct_8x8_inference_flag
+
+	var cropLeft, cropRight, cropTop, cropBottom uint32
+	if r.bit() == 1 {
+		cropLeft, cropRight, cropTop, cropBottom = r.ue(), r.ue(), r.ue(), r.ue()
+	}
+	if r.err != nil {
+		return 0, 0, r.err
+	}
+
+	cropUnitX, cropUnitY := uint32(1), 2-frameMbsOnly
+	if chromaFormat != 0 && !separateColourPlane {
+		if chromaFormat == 1 || chromaFormat == 2 {
+			cropUnitX = 2
+		}
+		if chromaFormat == 1 {
+			cropUnitY *= 2
+		}
+	}
+	width = int(widthMbs*16 - cropUnitX*(cropLeft+cropRight))
+	height = int((2-frameMbsOnly)*heightMapUnits*16 - cropUnitY*(cropTop+cropBottom))
+	return width, height, nil
+}
+
+func skipScalingList(r *bitReader, size int) {
+	last, next := int32(8), int32(8)
+	for range size {
+		if next != 0 {
+			next = (last + r.se() + 256) % 256
+		}
+		if next != 0 {
+			last = next
+		}
+	}
+}
+
+// h265SPSInfo holds the H.265 SPS fields an hvcC record and the track
+// header need.
+type h265SPSInfo struct {
+	width, height    int
+	profileTierLevel [12]byte // general profile, compatibility, constraint and level fields
+	chromaFormat     byte
+	bitDepthLuma     byte // minus 8
+	bitDepthChroma   byte // minus 8
+	maxSubLayers     byte
+	temporalIDNested byte
+}
+
+// parseH265SPS parses an H.265 SPS NAL unit (ITU-T H.265 7.3.2.2) up to the
+// bit depths.
+func parseH265SPS(sps []byte) (*h265SPSInfo, error) {
+	if len(sps) < 15 {
+		return nil, errShortSPS
+	}
+	rbsp := unescapeRBSP(sps[2:])
+	if len(rbsp) < 13 {
+		return nil, errShortSPS
+	}
+	r := bitReader{data: rbsp}
+	info := &h265SPSInfo{}
+
+	r.skip(4) // sps_video_parameter_set_id
+	subLayersMinus1 := int(r.bits(3))
+	info.maxSubLayers = byte(subLayersMinus1 + 1)
+	info.temporalIDNested = byte(r.bit())
+	copy(info.profileTierLevel[:], rbsp[1:13])
+	r.skip(96) // general profile_tier_level
+
+	profilePresent := make([]bool, subLayersMinus1)
+	levelPresent := make([]bool, subLayersMinus1)
+	for i := range subLayersMinus1 {
+		profilePresent[i] = r.bit() == 1
+		levelPresent[i] = r.bit() == 1
+	}
+	if subLayersMinus1 > 0 {
+		r.skip(2 * (8 - subLayersMinus1))
+	}
+	for i := range subLayersMinus1 {
+		if profilePresent[i] {
+			r.skip(88)
+		}
+		if levelPresent[i] {
+			r.skip(8)
+		}
+	}
+
+	r.ue() // sps_seq_parameter_set_id
+	chromaFormat := r.ue()
+	if chromaFormat == 3 {
+		r.skip(1) // separate_colour_plane_flag
+	}
+	width, height := r.ue(), r.ue()
+	if r.bit() == 1 { // conformance_window_flag
+		subWidth, subHeight := uint32(1), uint32(1)
+		if chromaFormat == 1 || chromaFormat == 2 {
+			subWidth = 2
+		}
+		if chromaFormat == 1 {
+			subHeight = 2
+		}
+		left, right, top, bottom := r.ue(), r.ue(), r.ue(), r.ue()
+		width -= subWidth * (left + right)
+		height -= subHeight * (top + bottom)
+	}
+	info.bitDepthLuma = byte(r.ue())
+	info.bitDepthChroma = byte(r.ue())
+	if r.err != nil {
+		return nil, r.err
+	}
+
+	info.width, info.height = int(width), int(height)
+	info.chromaFormat = byte(chromaFormat)
+	return info, nil
+}
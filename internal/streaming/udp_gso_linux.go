@@ -0,0 +1,66 @@
+//go:build linux
+
+package streaming
+
+import (
+	"encoding/binary"
+	"errors"
+	"net"
+	"syscall"
+	"unsafe"
+)
+
+// UDP GSO limits. The kernel caps a GSO send at UDP_MAX_SEGMENTS segments
+// and one IP datagram's worth of payload.
+const (
+	gsoMaxSegments = 64
+	gsoMaxPayload  = 65000
+)
+
+// udpSegment is the UDP_SEGMENT socket option (linux/udp.h), missing from syscall.
+const udpSegment = 103
+
+// gsoSupported probes UDP_SEGMENT support (Linux 4.18+) on conn.
+func gsoSupported(conn *net.UDPConn) bool {
+	raw, err := conn.SyscallConn()
+	if err != nil {
+		return false
+	}
+
+	var optErr error
+	if err := raw.Control(func(fd uintptr) {
+		_, optErr = syscall.GetsockoptInt(int(fd), syscall.IPPROTO_UDP, udpSegment)
+	}); err != nil {
+		return false
+	}
+	return optErr == nil
+}
+
+// isGSOError reports whether a failed GSO send was rejected for its
+// segmentation: EIO when the device can't checksum segments, EINVAL when the
+// kernel refuses the UDP_SEGMENT control message.
+func isGSOError(err error) bool {
+	return errors.Is(err, syscall.EIO) || errors.Is(err, syscall.EINVAL)
+}
+
+// appendGSOControl appends a UDP_SEGMENT control message telling the kernel
+// to split the datagram into segments of segmentSize bytes.
+func appendGSOControl(oob []byte, segmentSize int) []byte {
+	start := len(oob)
+	space := syscall.CmsgSpace(2)
+	if cap(oob)-start < space {
+		grown := make([]byte, start, start+space)
+		copy(grown, oob)
+		oob = grown
+	}
+	oob = oob[:start+space]
+	clear(oob[start:])
+
+	hdr := (*syscall.Cmsghdr)(unsafe.Pointer(&oob[start]))
+	hdr.Level = syscall.IPPROTO_UDP
+	hdr.Type = udpSegment
+	hdr.SetLen(syscall.CmsgLen(2))
+	binary.NativeEndian.PutUint16(oob[start+syscall.CmsgLen(0):], uint16(segmentSize))
+
+	return oob
+}
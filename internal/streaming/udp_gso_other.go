@@ -0,0 +1,23 @@
+//go:build !linux
+
+package streaming
+
+import "net"
+
+// UDP GSO is Linux-only; batches are sent as individual datagrams elsewhere.
+const (
+	gsoMaxSegments = 1
+	gsoMaxPayload  = 0
+)
+
+func gsoSupported(_ *net.UDPConn) bool {
+	return false
+}
+
+func appendGSOControl(oob []byte, _ int) []byte {
+	return oob
+}
+
+func isGSOError(_ error) bool {
+	return false
+}
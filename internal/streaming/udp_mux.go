@@ -0,0 +1,280 @@
+package streaming
+
+import (
+	"errors"
+	"net"
+	"sync"
+
+	"github.com/pion/ice/v4"
+	pion "github.com/pion/webrtc/v4"
+	"github.com/smazurov/videonode/internal/logging"
+	"golang.org/x/net/ipv4"
+)
+
+// udpBatchSize is the maximum number of datagrams handed to one sendmmsg call.
+const udpBatchSize = 64
+
+// udpQueueSize bounds datagrams waiting for the batch writer. When full,
+// WriteTo blocks like a socket with a full send buffer.
+const udpQueueSize = 4096
+
+// udpMaxDatagram is the largest datagram copied into the send queue.
+// SRTP packets are well below typical Ethernet MTU.
+const udpMaxDatagram = 1500
+
+// UDPMux is a single UDP port shared by all WebRTC peers. ICE traffic is
+// demultiplexed by ufrag, so every PeerConnection sends and receives on the
+// same socket. Outgoing datagrams are batched with sendmmsg, and consecutive
+// equal-size datagrams to the same peer are coalesced with UDP GSO when the
+// kernel supports it.
+type UDPMux struct {
+	conn *batchConn
+	mux  ice.UDPMux
+}
+
+// ListenUDPMux opens the shared WebRTC UDP port on addr (e.g. ":8189").
+// Only IPv4 is supported, since batching relies on IPv4 message headers.
+func ListenUDPMux(addr string, logger logging.Logger) (*UDPMux, error) {
+	udpAddr, err := net.ResolveUDPAddr("udp4", addr)
+	if err != nil {
+		return nil, err
+	}
+	udpConn, err := net.ListenUDP("udp4", udpAddr)
+	if err != nil {
+		return nil, err
+	}
+
+	gso := gsoSupported(udpConn)
+	conn := newBatchConn(udpConn, gso)
+	logger.Info("WebRTC UDP mux listening", "addr", udpConn.LocalAddr(), "gso", gso)
+
+	return &UDPMux{
+		conn: conn,
+		mux:  pion.NewICEUDPMux(nil, conn),
+	}, nil
+}
+
+// LocalAddr returns the address of the shared UDP socket.
+func (m *UDPMux) LocalAddr() net.Addr {
+	return m.conn.LocalAddr()
+}
+
+// Close stops the mux and closes the shared socket.
+func (m *UDPMux) Close() error {
+	return m.mux.Close()
+}
+
+// batchConn wraps a UDP socket and turns individual WriteTo calls into
+// batched sendmmsg calls. The writer goroutine blocks for the first queued
+// datagram and then drains whatever else is already queued, so batching adds
+// no latency when idle and grows with load.
+type batchConn struct {
+	*net.UDPConn
+	pc    *ipv4.PacketConn
+	queue chan *datagram
+	pool  sync.Pool
+	gso   bool // UDP_SEGMENT available, cleared on first GSO send failure
+	done  chan struct{}
+	once  sync.Once
+}
+
+type datagram struct {
+	buf  []byte
+	addr *net.UDPAddr
+}
+
+func newBatchConn(conn *net.UDPConn, gso bool) *batchConn {
+	c := &batchConn{
+		UDPConn: conn,
+		pc:      ipv4.NewPacketConn(conn),
+		queue:   make(chan *datagram, udpQueueSize),
+		gso:     gso,
+		done:    make(chan struct{}),
+	}
+	c.pool.New = func() any {
+		return &datagram{buf: make([]byte, 0, udpMaxDatagram)}
+	}
+	go c.writeLoop()
+	return c
+}
+
+// WriteTo queues a datagram for the batch writer. The buffer is copied, so
+// callers may reuse it immediately. Oversized datagrams are sent directly.
+func (c *batchConn) WriteTo(b []byte, addr net.Addr) (int, error) {
+	udpAddr, ok := addr.(*net.UDPAddr)
+	if !ok || len(b) > udpMaxDatagram {
+		return c.UDPConn.WriteTo(b, addr)
+	}
+
+	d, _ := c.pool.Get().(*datagram)
+	d.buf = append(d.buf[:0], b...)
+	d.addr = udpAddr
+
+	select {
+	case c.queue <- d:
+		return len(b), nil
+	case <-c.done:
+		return 0, net.ErrClosed
+	}
+}
+
+// Close stops the writer and closes the socket.
+func (c *batchConn) Close() error {
+	c.once.Do(func() { close(c.done) })
+	return c.UDPConn.Close()
+}
+
+func (c *batchConn) writeLoop() {
+	pending := make([]*datagram, 0, udpBatchSize)
+	b := &batch{
+		msgs: make([]ipv4.Message, 0, udpBatchSize),
+		runs: make([]int, 0, udpBatchSize),
+	}
+
+	for {
+		select {
+		case d := <-c.queue:
+			pending = append(pending, d)
+		case <-c.done:
+			return
+		}
+
+	drain:
+		for len(pending) < udpBatchSize {
+			select {
+			case d := <-c.queue:
+				pending = append(pending, d)
+			default:
+				break drain
+			}
+		}
+
+		for sent := 0; sent < len(pending); {
+			c.buildMessages(b, pending[sent:])
+			n, err := c.send(b)
+			sent += n
+			if !errors.Is(err, errGSOUnsupported) {
+				break
+			}
+			// Some NICs reject GSO (no checksum offload): fall back
+			// permanently and resend what wasn't sent yet
+			c.gso = false
+		}
+
+		for i, d := range pending {
+			d.addr = nil
+			c.pool.Put(d)
+			pending[i] = nil
+		}
+		pending = pending[:0]
+	}
+}
+
+// errGSOUnsupported is returned by send when the kernel rejected a GSO
+// message.
+var errGSOUnsupported = errors.New("udp gso send rejected")
+
+// batch holds the reusable sendmmsg messages of the writer goroutine.
+type batch struct {
+	msgs  []ipv4.Message
+	runs  []int // datagrams carried by each message
+	slots []gsoSlot
+}
+
+// gsoSlot holds the reusable coalescing buffer and control header for one
+// GSO message within a batch.
+type gsoSlot struct {
+	buf []byte
+	oob []byte
+}
+
+// buildMessages converts queued datagrams into sendmmsg messages. With GSO,
+// runs of equal-size datagrams to the same address (the last may be shorter)
+// are coalesced into a single message with a UDP_SEGMENT control header.
+func (c *batchConn) buildMessages(b *batch, pending []*datagram) {
+	b.msgs, b.runs = b.msgs[:0], b.runs[:0]
+	used := 0
+
+	for i := 0; i < len(pending); {
+		d := pending[i]
+		run := 1
+		if c.gso {
+			total := len(d.buf)
+			for i+run < len(pending) && run < gsoMaxSegments {
+				next := pending[i+run]
+				if !next.addr.IP.Equal(d.addr.IP) || next.addr.Port != d.addr.Port ||
+					len(next.buf) > len(d.buf) || total+len(next.buf) > gsoMaxPayload {
+					break
+				}
+				total += len(next.buf)
+				run++
+				if len(next.buf) < len(d.buf) {
+					break // a shorter segment must be the last one
+				}
+			}
+		}
+		b.runs = append(b.runs, run)
+
+		if run == 1 {
+			b.msgs = append(b.msgs, ipv4.Message{Buffers: [][]byte{d.buf}, Addr: d.addr})
+			i++
+			continue
+		}
+
+		if used == len(b.slots) {
+			b.slots = append(b.slots, gsoSlot{buf: make([]byte, 0, gsoMaxPayload)})
+		}
+		slot := &b.slots[used]
+		used++
+
+		slot.buf = slot.buf[:0]
+		for _, seg := range pending[i : i+run] {
+			slot.buf = append(slot.buf, seg.buf...)
+		}
+		slot.oob = appendGSOControl(slot.oob[:0], len(d.buf))
+		b.msgs = append(b.msgs, ipv4.Message{
+			Buffers: [][]byte{slot.buf},
+			OOB:     slot.oob,
+			Addr:    d.addr,
+		})
+		i += run
+	}
+}
+
+// send writes all messages of a batch, looping because sendmmsg may send
+// fewer than requested, and returns the number of datagrams handled. A
+// message the kernel refuses (e.g. EHOSTUNREACH for a stale ICE candidate)
+// is dropped and the rest of the batch still goes out, since it carries other
+// peers' media; SRTP and RTCP recover the loss like any other. A rejected GSO
+// message stops the batch with errGSOUnsupported, leaving it and the rest
+// unsent.
+func (c *batchConn) send(b *batch) (int, error) {
+	msgs, runs := b.msgs, b.runs
+	handled := 0
+	for len(msgs) > 0 {
+		n, err := c.pc.WriteBatch(msgs, 0)
+		n = max(n, 0) // -1 from a failed sendmmsg
+		if n > 0 {
+			IncrementUDPBatches(n)
+		}
+		for _, run := range runs[:n] {
+			handled += run
+		}
+		msgs, runs = msgs[n:], runs[n:]
+		if err == nil {
+			continue
+		}
+
+		switch {
+		case errors.Is(err, net.ErrClosed):
+			return handled, err
+		case len(msgs) > 0 && len(msgs[0].OOB) > 0 && isGSOError(err):
+			return handled, errGSOUnsupported
+		case len(msgs) > 0:
+			IncrementUDPSendErrors()
+			handled += runs[0]
+			msgs, runs = msgs[1:], runs[1:]
+		}
+	}
+	return handled, nil
+}
@@ -0,0 +1,124 @@
+package streaming
+
+import (
+	"bytes"
+	"net"
+	"testing"
+	"time"
+)
+
+func TestBatchConn_DeliversAllDatagrams(t *testing.T) {
+	tests := []struct {
+		name string
+		gso  bool
+	}{
+		{"sendmmsg only", false},
+		{"with gso when supported", true},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			receiver, err := net.ListenUDP("udp4", &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1)})
+			if err != nil {
+				t.Fatalf("listen receiver: %v", err)
+			}
+			defer receiver.Close()
+
+			senderConn, err := net.ListenUDP("udp4", &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1)})
+			if err != nil {
+				t.Fatalf("listen sender: %v", err)
+			}
+			conn := newBatchConn(senderConn, tt.gso && gsoSupported(senderConn))
+			defer conn.Close()
+
+			// Equal-size datagrams followed by a shorter tail exercise GSO coalescing
+			var sent [][]byte
+			for i := range 20 {
+				size := 1200
+				if i == 19 {
+					size = 300
+				}
+				sent = append(sent, bytes.Repeat([]byte{byte(i)}, size))
+			}
+			for _, b := range sent {
+				if _, err := conn.WriteTo(b, receiver.LocalAddr()); err != nil {
+					t.Fatalf("WriteTo: %v", err)
+				}
+			}
+
+			buf := make([]byte, 2048)
+			for i, want := range sent {
+				_ = receiver.SetReadDeadline(time.Now().Add(2 * time.Second))
+				n, _, err := receiver.ReadFrom(buf)
+				if err != nil {
+					t.Fatalf("datagram %d: read: %v", i, err)
+				}
+				if !bytes.Equal(buf[:n], want) {
+					t.Fatalf("datagram %d: got %d bytes of %d, want %d bytes of %d", i, n, buf[0], len(want), want[0])
+				}
+			}
+		})
+	}
+}
+
+func TestBatchConn_WriteAfterClose(t *testing.T) {
+	udpConn, err := net.ListenUDP("udp4", &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1)})
+	if err != nil {
+		t.Fatalf("listen: %v", err)
+	}
+	conn := newBatchConn(udpConn, false)
+	_ = conn.Close()
+
+	// Fill the queue so WriteTo must observe the close rather than enqueue
+	addr := &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1), Port: 9}
+	var lastErr error
+	for range udpQueueSize + 1 {
+		if _, lastErr = conn.WriteTo([]byte{0}, addr); lastErr != nil {
+			break
+		}
+	}
+	if lastErr == nil {
+		t.Error("expected error writing to closed conn")
+	}
+}
+
+func TestBatchConn_SkipsFailedDatagram(t *testing.T) {
+	receiver, err := net.ListenUDP("udp4", &net.UDPAddr{IP: net.IPv4(127, 0, 0, 1)})
+	if err != nil {
+		t.Fatalf("listen receiver: %v", err)
+	}
+	defer receiver.Close()
+
+	senderConn, err := net.ListenUDP("udp4", &net.UDPAddr{})
+	if err != nil {
+		t.Fatalf("listen sender: %v", err)
+	}
+	conn := newBatchConn(senderConn, false)
+	defer conn.Close()
+
+	// Broadcast without SO_BROADCAST is refused, in the middle of a batch
+	// that must still reach the other peer
+	refused := &net.UDPAddr{IP: net.IPv4bcast, Port: 9}
+	pending := []*datagram{
+		{buf: []byte{1}, addr: receiver.LocalAddr().(*net.UDPAddr)},
+		{buf: []byte{2}, addr: refused},
+		{buf: []byte{3}, addr: receiver.LocalAddr().(*net.UDPAddr)},
+	}
+	b := &batch{}
+	conn.buildMessages(b, pending)
+	if n, err := conn.send(b); n != len(pending) || err != nil {
+		t.Fatalf("send() = %d, %v, want all %d datagrams handled", n, err, len(pending))
+	}
+
+	buf := make([]byte, 16)
+	for _, want := range []byte{1, 3} {
+		_ = receiver.SetReadDeadline(time.Now().Add(2 * time.Second))
+		n, _, err := receiver.ReadFrom(buf)
+		if err != nil {
+			t.Fatalf("datagram %d: read: %v", want, err)
+		}
+		if n != 1 || buf[0] != want {
+			t.Fatalf("got datagram %v, want %d", buf[:n], want)
+		}
+	}
+}
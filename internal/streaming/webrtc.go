@@ -1,7 +1,10 @@
 package streaming
 
 import (
+	"errors"
+	"strings"
 	"sync"
+	"time"
 
 	"github.com/AlexxIT/go2rtc/pkg/core"
 	"github.com/AlexxIT/go2rtc/pkg/webrtc"
@@ -14,27 +17,115 @@ import (
 type WebRTCConfig struct {
 	// ICEServers for STUN/TURN (empty for LAN-only)
 	ICEServers []pion.ICEServer
+
+	// UDPMux shares one UDP port across all peers (nil for per-peer ports)
+	UDPMux *UDPMux
+
+	// ICELite answers as an ICE-lite agent with host candidates only.
+	// Use when the server is directly reachable (LAN or public IP).
+	ICELite bool
 }
 
+// ErrSessionNotFound is returned when a WHEP session doesn't exist.
+var ErrSessionNotFound = errors.New("session not found")
+
+// WHEPGatherTimeout bounds how long a WHEP answer waits for local ICE
+// candidates. Host candidates are gathered within milliseconds; slower
+// server-reflexive candidates are left out and the client finds the server
+// through peer-reflexive candidates instead.
+const WHEPGatherTimeout = 100 * time.Millisecond
+
 // WebRTCManager manages WebRTC peer connections.
 type WebRTCManager struct {
 	hub         *Hub
 	config      WebRTCConfig
-	peers       map[string]*webrtc.Conn
+	keyframes   *keyframeRequests
+	engineOnce  sync.Once
+	engine      *webrtcEngine
+	engineErr   error
+	peers       map[string]*webrtcPeer
 	streamPeers map[string]map[string]bool // streamID -> set of peerIDs
+	uncached    map[string]bool            // streams logged as unable to serve a PLI
 	mu          sync.RWMutex
 	logger      logging.Logger
 }
 
+// webrtcPeer is one connected WebRTC consumer: a single-stream peer with a
+// go2rtc connection, or a bundle carrying several streams.
+type webrtcPeer struct {
+	streamID string // empty for bundles
+	conn     *webrtc.Conn
+	bundle   *webrtcBundle
+	pc       *pion.PeerConnection
+	latency  *peerLatency // nil unless latency tracing is enabled
+}
+
+// close closes the peer's connection. Cleanup runs from its state handler.
+func (p *webrtcPeer) close() error {
+	if p.conn != nil {
+		return p.conn.Stop()
+	}
+	return p.pc.Close()
+}
+
 // NewWebRTCManager creates a new WebRTC manager.
 func NewWebRTCManager(hub *Hub, config WebRTCConfig, logger logging.Logger) *WebRTCManager {
-	return &WebRTCManager{
+	m := &WebRTCManager{
 		hub:         hub,
 		config:      config,
-		peers:       make(map[string]*webrtc.Conn),
+		peers:       make(map[string]*webrtcPeer),
 		streamPeers: make(map[string]map[string]bool),
+		uncached:    make(map[string]bool),
 		logger:      logger,
 	}
+	m.keyframes = newKeyframeRequests(DefaultKeyframeRequestInterval, m.recoverPeers)
+	return m
+}
+
+// recoverPeers handles a coalesced keyframe request: peers that reported
+// loss get the cached GOP right away. FFmpeg can't be asked for an IDR at
+// runtime, so streams without a GOP cache recover at their next keyframe.
+func (m *WebRTCManager) recoverPeers(streamID string, peerIDs []string) {
+	recovered, unserved := 0, 0
+	for _, peerID := range peerIDs {
+		m.mu.RLock()
+		peer, ok := m.peers[peerID]
+		m.mu.RUnlock()
+
+		if !ok {
+			continue
+		}
+		var served bool
+		if peer.bundle != nil {
+			served = peer.bundle.recover(streamID)
+		} else {
+			served = m.hub.RecoverConsumer(peer.conn)
+		}
+		if served {
+			recovered++
+		} else {
+			unserved++
+		}
+	}
+
+	IncrementKeyframeRecoveries(streamID)
+	m.logger.Debug("Keyframe requested", "stream_id", streamID, "peers", len(peerIDs), "recovered_from_cache", recovered)
+
+	if unserved > 0 && m.markUncached(streamID) {
+		m.logger.Warn("No GOP cache to serve keyframe requests, viewers wait for the next keyframe", "stream_id", streamID)
+	}
+}
+
+// markUncached records that a stream couldn't serve a keyframe request and
+// reports whether this is the first time since the stream gained peers.
+func (m *WebRTCManager) markUncached(streamID string) bool {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	if m.uncached[streamID] {
+		return false
+	}
+	m.uncached[streamID] = true
+	return true
 }
 
 // generatePeerID generates a unique memorable peer ID.
@@ -54,22 +145,118 @@ func (m *WebRTCManager) generatePeerID() string {
 }
 
 // CreateConsumer creates a WebRTC consumer for a stream.
-// Takes an SDP offer from the browser and returns an SDP answer.
+// Takes an SDP offer from the browser and returns an SDP answer carrying all
+// local ICE candidates, waiting for gathering to complete.
 func (m *WebRTCManager) CreateConsumer(streamID, offer string) (string, error) {
+	_, answer, err := m.createPeer(streamID, offer, true)
+	return answer, err
+}
+
+// CreateSession creates a WHEP session for a stream and returns its ID with
+// the SDP answer. The answer is returned as soon as host candidates are
+// gathered (or WHEPGatherTimeout); the client trickles its own candidates
+// with AddRemoteCandidates.
+func (m *WebRTCManager) CreateSession(streamID, offer string) (sessionID, answer string, err error) {
+	return m.createPeer(streamID, offer, false)
+}
+
+// AddRemoteCandidates adds ICE candidates from a trickle-ice-sdpfrag body
+// (RFC 8840) to a WHEP session.
+func (m *WebRTCManager) AddRemoteCandidates(streamID, sessionID, fragment string) error {
+	peer, err := m.session(streamID, sessionID)
+	if err != nil {
+		return err
+	}
+
+	for _, candidate := range parseTrickleFragment(fragment) {
+		if err := peer.pc.AddICECandidate(candidate); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// parseTrickleFragment extracts the candidates of a trickle-ice-sdpfrag body.
+// Candidates before any a=mid line belong to the first (bundled) m-line.
+func parseTrickleFragment(fragment string) []pion.ICECandidateInit {
+	var candidates []pion.ICECandidateInit
+	var mid *string
+	for line := range strings.Lines(fragment) {
+		line = strings.TrimSpace(line)
+		switch {
+		case strings.HasPrefix(line, "a=mid:"):
+			value := strings.TrimPrefix(line, "a=mid:")
+			mid = &value
+		case strings.HasPrefix(line, "a=candidate:"):
+			candidate := pion.ICECandidateInit{Candidate: strings.TrimPrefix(line, "a=")}
+			if mid != nil {
+				candidate.SDPMid = mid
+			} else {
+				index := uint16(0)
+				candidate.SDPMLineIndex = &index
+			}
+			candidates = append(candidates, candidate)
+		}
+	}
+	return candidates
+}
+
+// CloseSession ends a WHEP session.
+func (m *WebRTCManager) CloseSession(streamID, sessionID string) error {
+	peer, err := m.session(streamID, sessionID)
+	if err != nil {
+		return err
+	}
+	return peer.close()
+}
+
+func (m *WebRTCManager) session(streamID, sessionID string) (*webrtcPeer, error) {
+	m.mu.RLock()
+	defer m.mu.RUnlock()
+
+	peer, ok := m.peers[sessionID]
+	if !ok || peer.streamID != streamID {
+		return nil, ErrSessionNotFound
+	}
+	return peer, nil
+}
+
+// api returns a per-peer WebRTC API built on the shared engine.
+// metricsStreamID labels the peer's RTCP metrics.
+func (m *WebRTCManager) api(metricsStreamID, peerID string, onKeyframeRequest func(mediaSSRC uint32), latency *peerLatency) (*pion.API, error) {
+	m.engineOnce.Do(func() {
+		m.engine, m.engineErr = newWebRTCEngine()
+	})
+	if m.engineErr != nil {
+		return nil, m.engineErr
+	}
+	return m.engine.newAPI(metricsStreamID, peerID, m.config, onKeyframeRequest, latency), nil
+}
+
+// createPeer sets up a peer for an offer and returns its ID and SDP answer.
+// With complete set, the answer waits for ICE gathering to finish.
+func (m *WebRTCManager) createPeer(streamID, offer string, complete bool) (string, string, error) {
 	// Generate peer ID first - it's used as ICE ufrag and for metrics
 	peerID := m.generatePeerID()
 
+	var latency *peerLatency
+	if m.hub.latencyTracingEnabled() {
+		latency = newPeerLatency(streamID, nil, m.hub.latencyTimeline)
+	}
+
 	// Create WebRTC API with optimized NACK buffer for high-bitrate streams
-	api, err := NewWebRTCAPI(streamID, peerID)
+	api, err := m.api(streamID, peerID, func(uint32) {
+		m.keyframes.request(streamID, peerID)
+	}, latency)
 	if err != nil {
-		return "", err
+		return "", "", err
 	}
 
 	pc, err := api.NewPeerConnection(pion.Configuration{
 		ICEServers: m.config.ICEServers,
 	})
 	if err != nil {
-		return "", err
+		return "", "", err
 	}
 
 	conn := webrtc.NewConn(pc)
@@ -77,28 +264,28 @@ func (m *WebRTCManager) CreateConsumer(streamID, offer string) (string, error) {
 
 	if err := conn.SetOffer(offer); err != nil {
 		_ = pc.Close()
-		return "", err
+		return "", "", err
 	}
 
 	if err := m.hub.WireConsumer(streamID, conn); err != nil {
 		_ = pc.Close()
-		return "", err
+		return "", "", err
 	}
 
-	answer, err := conn.GetCompleteAnswer(nil, nil)
+	var answer string
+	if complete {
+		answer, err = conn.GetCompleteAnswer(nil, nil)
+	} else {
+		answer, err = gatherPartialAnswer(conn, pc)
+	}
 	if err != nil {
 		_ = pc.Close()
-		return "", err
+		return "", "", err
 	}
 
 	m.mu.Lock()
-	m.peers[peerID] = conn
-	// Track stream -> peer mapping for bulk close on stream restart
-	if m.streamPeers[streamID] == nil {
-		m.streamPeers[streamID] = make(map[string]bool)
-	}
-	m.streamPeers[streamID][peerID] = true
-	streamPeerCount := len(m.streamPeers[streamID])
+	m.peers[peerID] = &webrtcPeer{streamID: streamID, conn: conn, pc: pc, latency: latency}
+	streamPeerCount := m.addStreamPeerLocked(streamID, peerID)
 	m.mu.Unlock()
 
 	SetActivePeers(streamID, streamPeerCount)
@@ -127,25 +314,66 @@ func (m *WebRTCManager) CreateConsumer(streamID, offer string) (string, error) {
 				pion.PeerConnectionStateClosed:
 				// Stop closes senders, removing them from producer's receivers
 				_ = conn.Stop()
+				m.hub.UnwireConsumer(conn)
 				m.mu.Lock()
 				delete(m.peers, peerID)
-				var remainingPeers int
-				if m.streamPeers[streamID] != nil {
-					delete(m.streamPeers[streamID], peerID)
-					remainingPeers = len(m.streamPeers[streamID])
-					if remainingPeers == 0 {
-						delete(m.streamPeers, streamID)
-					}
-				}
+				remainingPeers := m.removeStreamPeerLocked(streamID, peerID)
 				m.mu.Unlock()
-				SetActivePeers(streamID, remainingPeers)
-				DeletePeerMetrics(streamID, peerID)
+				m.streamPeerRemoved(streamID, remainingPeers)
 				m.logger.Info("WebRTC client disconnected", "stream_id", streamID, "peer_id", peerID, "state", state.String(), "stream_peers", remainingPeers)
 			}
 		}
 	})
 
-	return answer, nil
+	return peerID, answer, nil
+}
+
+// addStreamPeerLocked records a peer of a stream, for bulk close on stream
+// restart, and returns the stream's peer count. Caller must hold m.mu.
+func (m *WebRTCManager) addStreamPeerLocked(streamID, peerID string) int {
+	if m.streamPeers[streamID] == nil {
+		m.streamPeers[streamID] = make(map[string]bool)
+	}
+	m.streamPeers[streamID][peerID] = true
+	return len(m.streamPeers[streamID])
+}
+
+// removeStreamPeerLocked forgets a peer of a stream and returns the stream's
+// remaining peer count. Caller must hold m.mu.
+func (m *WebRTCManager) removeStreamPeerLocked(streamID, peerID string) int {
+	peers := m.streamPeers[streamID]
+	if peers == nil {
+		return 0
+	}
+	delete(peers, peerID)
+	if len(peers) == 0 {
+		delete(m.streamPeers, streamID)
+		delete(m.uncached, streamID)
+	}
+	return len(peers)
+}
+
+// streamPeerRemoved updates per-stream state after a peer left a stream.
+func (m *WebRTCManager) streamPeerRemoved(streamID string, remainingPeers int) {
+	if remainingPeers == 0 {
+		m.keyframes.remove(streamID)
+	}
+	SetActivePeers(streamID, remainingPeers)
+}
+
+// gatherPartialAnswer creates the SDP answer and returns it with the local
+// candidates gathered within WHEPGatherTimeout.
+func gatherPartialAnswer(conn *webrtc.Conn, pc *pion.PeerConnection) (string, error) {
+	gathered := pion.GatheringCompletePromise(pc)
+	if _, err := conn.GetAnswer(); err != nil {
+		return "", err
+	}
+
+	select {
+	case <-gathered:
+	case <-time.After(WHEPGatherTimeout):
+	}
+	return pc.LocalDescription().SDP, nil
 }
 
 // Stop closes all peer connections.
@@ -153,10 +381,14 @@ func (m *WebRTCManager) Stop() {
 	m.mu.Lock()
 	defer m.mu.Unlock()
 
-	for id, conn := range m.peers {
-		_ = conn.Stop()
+	for id, peer := range m.peers {
+		_ = peer.close()
 		delete(m.peers, id)
 	}
+
+	if m.config.UDPMux != nil {
+		_ = m.config.UDPMux.Close()
+	}
 }
 
 // PeerCount returns the number of active WebRTC peers.
@@ -168,6 +400,8 @@ func (m *WebRTCManager) PeerCount() int {
 
 // CloseStreamConsumers closes all WebRTC peers for a given stream.
 // Called when stream producer is replaced to trigger client reconnection.
+// Bundles carry other streams too, so they stay connected: only the stream's
+// slots move to its new producer, or wait for one (see ResumeStreamConsumers).
 func (m *WebRTCManager) CloseStreamConsumers(streamID string) {
 	m.mu.Lock()
 	peerIDs, exists := m.streamPeers[streamID]
@@ -188,12 +422,19 @@ func (m *WebRTCManager) CloseStreamConsumers(streamID string) {
 
 	for _, peerID := range toClose {
 		m.mu.RLock()
-		conn, ok := m.peers[peerID]
+		peer, ok := m.peers[peerID]
 		m.mu.RUnlock()
 
-		if ok && conn != nil {
-			m.logger.Debug("Closing WebRTC peer", "peer_id", peerID, "stream_id", streamID)
-			_ = conn.Stop()
+		if !ok {
+			continue
+		}
+		if peer.bundle != nil {
+			// The connection carries other streams: only move this one's slots
+			m.logger.Debug("Reattaching WebRTC bundle slots", "peer_id", peerID, "stream_id", streamID)
+			m.moveBundleStream(peerID, peer.bundle, streamID, peer.bundle.reattach)
+			continue
 		}
+		m.logger.Debug("Closing WebRTC peer", "peer_id", peerID, "stream_id", streamID)
+		_ = peer.close()
 	}
 }
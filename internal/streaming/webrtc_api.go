@@ -1,6 +1,8 @@
 package streaming
 
 import (
+	"math/bits"
+
 	"github.com/AlexxIT/go2rtc/pkg/core"
 	"github.com/pion/interceptor"
 	"github.com/pion/interceptor/pkg/nack"
@@ -27,19 +29,65 @@ const SRTPReplayProtectionWindow = 10000
 // sensitive to packet loss.
 // The peerID is used as the ICE username fragment (ice-ufrag), which is visible
 // to the client in the SDP answer for identification.
-func NewWebRTCAPI(streamID, peerID string) (*pion.API, error) {
+// A non-nil udpMux makes the peer share the mux's UDP port instead of
+// binding its own ephemeral sockets. onKeyframeRequest, if set, is called for
+// every PLI or FIR received from the peer, with the SSRC of the track that
+// needs a keyframe.
+//
+// Each call builds a new media engine and interceptor set; WebRTCManager
+// shares them across peers instead.
+func NewWebRTCAPI(streamID, peerID string, udpMux *UDPMux, onKeyframeRequest func(mediaSSRC uint32)) (*pion.API, error) {
+	engine, err := newWebRTCEngine()
+	if err != nil {
+		return nil, err
+	}
+	return engine.newAPI(streamID, peerID, WebRTCConfig{UDPMux: udpMux}, onKeyframeRequest, nil), nil
+}
+
+// webrtcEngine holds the parts of a WebRTC API that are the same for every
+// peer: the media engine with its codecs and RTCP feedback, and the
+// interceptor factories. Pion copies the media engine for each
+// PeerConnection and builds fresh interceptors from the factories, so both
+// are safe to share.
+type webrtcEngine struct {
+	mediaEngine  *pion.MediaEngine
+	interceptors []interceptor.Factory
+}
+
+func newWebRTCEngine() (*webrtcEngine, error) {
 	m := &pion.MediaEngine{}
 	if err := registerCodecs(m); err != nil {
 		return nil, err
 	}
 
-	i := &interceptor.Registry{}
-	if err := configureInterceptors(m, i); err != nil {
+	interceptors, err := configureInterceptors(m)
+	if err != nil {
+		return nil, err
+	}
+
+	// Capture times of traced frames, for the browser's frame callbacks
+	err = m.RegisterHeaderExtension(pion.RTPHeaderExtensionCapability{URI: absCaptureTimeURI}, pion.RTPCodecTypeVideo)
+	if err != nil {
 		return nil, err
 	}
 
+	return &webrtcEngine{mediaEngine: m, interceptors: interceptors}, nil
+}
+
+// newAPI creates the per-peer API: the shared engine plus the peer's ICE
+// credentials, network settings and RTCP monitor. A non-nil latency traces
+// the frames sent to the peer.
+func (e *webrtcEngine) newAPI(streamID, peerID string, config WebRTCConfig, onKeyframeRequest func(mediaSSRC uint32), latency *peerLatency) *pion.API {
+	i := &interceptor.Registry{}
+	for _, factory := range e.interceptors {
+		i.Add(factory)
+	}
+
 	// Add RTCP monitoring interceptor for Prometheus metrics
-	i.Add(&rtcpMonitorInterceptorFactory{streamID: streamID, peerID: peerID})
+	i.Add(&rtcpMonitorInterceptorFactory{streamID: streamID, onKeyframeRequest: onKeyframeRequest})
+	if latency != nil {
+		i.Add(&latencyInterceptorFactory{peer: latency})
+	}
 
 	s := pion.SettingEngine{}
 	s.SetDTLSInsecureSkipHelloVerify(true)
@@ -47,12 +95,20 @@ func NewWebRTCAPI(streamID, peerID string) (*pion.API, error) {
 	s.SetSRTPReplayProtectionWindow(SRTPReplayProtectionWindow)
 	// Set peer ID as ice-ufrag (visible to client in SDP answer)
 	s.SetICECredentials(peerID, generateICEPassword())
+	if config.UDPMux != nil {
+		s.SetICEUDPMux(config.UDPMux.mux)
+		s.SetNetworkTypes([]pion.NetworkType{pion.NetworkTypeUDP4})
+	}
+	if config.ICELite {
+		// Host candidates only, no STUN round trips: gathering finishes at once
+		s.SetLite(true)
+	}
 
 	return pion.NewAPI(
-		pion.WithMediaEngine(m),
+		pion.WithMediaEngine(e.mediaEngine),
 		pion.WithInterceptorRegistry(i),
 		pion.WithSettingEngine(s),
-	), nil
+	)
 }
 
 // generateICEPassword generates a secure password for ICE authentication.
@@ -174,13 +230,16 @@ func registerCodecs(m *pion.MediaEngine) error {
 	return nil
 }
 
-// configureInterceptors sets up NACK, RTCP reports, and TWCC with optimized
-// buffer sizes for high-bitrate streaming.
-func configureInterceptors(m *pion.MediaEngine, i *interceptor.Registry) error {
+// configureInterceptors registers RTCP feedback and returns the interceptor
+// factories for NACK, RTCP reports, and TWCC with optimized buffer sizes for
+// high-bitrate streaming.
+func configureInterceptors(m *pion.MediaEngine) ([]interceptor.Factory, error) {
+	var factories []interceptor.Factory
+
 	// NACK generator (for requesting retransmissions)
 	generator, err := nack.NewGeneratorInterceptor()
 	if err != nil {
-		return err
+		return nil, err
 	}
 
 	// NACK responder with large buffer for high-bitrate streams
@@ -188,32 +247,30 @@ func configureInterceptors(m *pion.MediaEngine, i *interceptor.Registry) error {
 		nack.ResponderSize(NACKBufferSize),
 	)
 	if err != nil {
-		return err
+		return nil, err
 	}
 
 	m.RegisterFeedback(pion.RTCPFeedback{Type: "nack"}, pion.RTPCodecTypeVideo)
 	m.RegisterFeedback(pion.RTCPFeedback{Type: "nack", Parameter: "pli"}, pion.RTPCodecTypeVideo)
-	i.Add(responder)
-	i.Add(generator)
+	factories = append(factories, responder, generator)
 
 	// RTCP sender/receiver reports
 	receiver, err := report.NewReceiverInterceptor()
 	if err != nil {
-		return err
+		return nil, err
 	}
 	sender, err := report.NewSenderInterceptor()
 	if err != nil {
-		return err
+		return nil, err
 	}
-	i.Add(receiver)
-	i.Add(sender)
+	factories = append(factories, receiver, sender)
 
 	// Stats interceptor
 	statsInterceptor, err := stats.NewInterceptor()
 	if err != nil {
-		return err
+		return nil, err
 	}
-	i.Add(statsInterceptor)
+	factories = append(factories, statsInterceptor)
 
 	// TWCC for congestion control
 	m.RegisterFeedback(pion.RTCPFeedback{Type: pion.TypeRTCPFBTransportCC}, pion.RTPCodecTypeVideo)
@@ -221,40 +278,45 @@ func configureInterceptors(m *pion.MediaEngine, i *interceptor.Registry) error {
 
 	twccGenerator, err := twcc.NewSenderInterceptor()
 	if err != nil {
-		return err
+		return nil, err
 	}
-	i.Add(twccGenerator)
+	factories = append(factories, twccGenerator)
 
-	return nil
+	return factories, nil
 }
 
 // rtcpMonitorInterceptorFactory creates RTCP monitoring interceptors for metrics.
 type rtcpMonitorInterceptorFactory struct {
-	streamID string
-	peerID   string
+	streamID          string
+	onKeyframeRequest func(mediaSSRC uint32)
 }
 
 // NewInterceptor creates a new RTCP monitoring interceptor.
 func (f *rtcpMonitorInterceptorFactory) NewInterceptor(_ string) (interceptor.Interceptor, error) {
-	return &rtcpMonitorInterceptor{streamID: f.streamID, peerID: f.peerID}, nil
+	return &rtcpMonitorInterceptor{streamID: f.streamID, onKeyframeRequest: f.onKeyframeRequest}, nil
 }
 
-// rtcpMonitorInterceptor monitors RTCP packets and updates Prometheus metrics.
+// rtcpMonitorInterceptor monitors RTCP packets, updates Prometheus metrics
+// and reports keyframe requests.
 type rtcpMonitorInterceptor struct {
 	interceptor.NoOp
-	streamID string
-	peerID   string
+	streamID          string
+	onKeyframeRequest func(mediaSSRC uint32)
 }
 
 // BindRTCPReader wraps the RTCP reader to monitor incoming packets.
 func (r *rtcpMonitorInterceptor) BindRTCPReader(reader interceptor.RTCPReader) interceptor.RTCPReader {
-	return &rtcpMonitorReader{reader: reader, streamID: r.streamID, peerID: r.peerID}
+	return &rtcpMonitorReader{
+		reader:            reader,
+		counters:          newRTCPCounters(r.streamID),
+		onKeyframeRequest: r.onKeyframeRequest,
+	}
 }
 
 type rtcpMonitorReader struct {
-	reader   interceptor.RTCPReader
-	streamID string
-	peerID   string
+	reader            interceptor.RTCPReader
+	counters          rtcpCounters
+	onKeyframeRequest func(mediaSSRC uint32)
 }
 
 func (r *rtcpMonitorReader) Read(b []byte, a interceptor.Attributes) (int, interceptor.Attributes, error) {
@@ -269,24 +331,36 @@ func (r *rtcpMonitorReader) Read(b []byte, a interceptor.Attributes) (int, inter
 	}
 
 	for _, pkt := range packets {
-		IncrementRTCPPackets(r.streamID, r.peerID)
+		r.counters.packets.Inc()
 		switch p := pkt.(type) {
 		case *rtcp.TransportLayerNack:
 			count := 0
 			for _, nack := range p.Nacks {
-				count += len(nack.PacketList())
+				// PacketID plus one per bit in the loss bitmask, without
+				// building the list PacketList would allocate
+				count += 1 + bits.OnesCount16(uint16(nack.LostPackets))
 			}
-			IncrementNACKs(r.streamID, r.peerID, count)
+			r.counters.addNACKs(count)
 		case *rtcp.PictureLossIndication:
-			IncrementPLIs(r.streamID, r.peerID)
+			r.counters.addPLI()
+			r.requestKeyframe(p.MediaSSRC)
 		case *rtcp.FullIntraRequest:
-			IncrementFIRs(r.streamID, r.peerID)
+			r.counters.firs.Inc()
+			for _, entry := range p.FIR {
+				r.requestKeyframe(entry.SSRC)
+			}
 		case *rtcp.ReceiverReport:
 			for _, report := range p.Reports {
-				RecordJitter(r.streamID, r.peerID, report.Jitter)
+				r.counters.observeJitter(report.Jitter)
 			}
 		}
 	}
 
 	return n, attr, err
 }
+
+func (r *rtcpMonitorReader) requestKeyframe(mediaSSRC uint32) {
+	if r.onKeyframeRequest != nil {
+		r.onKeyframeRequest(mediaSSRC)
+	}
+}
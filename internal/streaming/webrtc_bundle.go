@@ -0,0 +1,589 @@
+package streaming
+
+import (
+	"encoding/hex"
+	"errors"
+	"slices"
+	"strings"
+	"sync"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	"github.com/pion/rtp"
+	pion "github.com/pion/webrtc/v4"
+	"github.com/smazurov/videonode/internal/logging"
+)
+
+// BundleMetricsStreamID is the stream_id label of per-peer RTCP metrics for
+// bundled peers, whose feedback covers several streams.
+const BundleMetricsStreamID = "bundle"
+
+// ErrCodecNotSupported is returned when a stream's codec can't be sent over
+// WebRTC without transcoding.
+var ErrCodecNotSupported = errors.New("codec not supported")
+
+// webrtcBundle is a WebRTC consumer carrying several streams over one
+// PeerConnection, so a dashboard grid needs one ICE/DTLS session instead of
+// one per tile.
+//
+// Each m-line of the browser's offer is a slot. The k-th video m-line plays
+// the k-th stream of the bundle, and so does the k-th audio m-line if the
+// browser offered one. A renegotiation with a new stream list reassigns the
+// slots; m-lines are never removed, an unused slot just goes quiet until it
+// is given a stream again.
+//
+// A slot whose stream can't continue on a new producer (codec change, no
+// producer within the handover timeout) is moved over to the stream's next
+// producer on its own, without closing the connection (see reattach and
+// resume), so one camera restarting doesn't interrupt the rest of the grid.
+//
+// Unlike single-stream peers, bundles write to their own pion tracks and
+// attach to the hub with AttachTrack, since slots change streams while the
+// connection lives.
+type webrtcBundle struct {
+	hub    *Hub
+	api    *pion.API
+	pc     *pion.PeerConnection
+	logger logging.Logger
+
+	mu     sync.Mutex // serializes negotiation
+	slots  []*bundleSlot
+	closed bool
+}
+
+// bundleSlot is one sending m-line of a bundle.
+type bundleSlot struct {
+	transceiver *pion.RTPTransceiver
+	kind        string
+
+	mu         sync.Mutex       // guards the fields below against the write path
+	attachment *TrackAttachment // nil while the slot has no stream
+	streamID   string           // stream playing on the slot
+	wanted     string           // stream the browser assigned, even while it can't play
+	generation int              // bumped on every reassignment, drops stale packets
+	track      *pion.TrackLocalStaticRTP
+	ssrc       uint32
+	rewriter   rtpRewriter
+	counters   streamSendCounters
+}
+
+func newWebRTCBundle(hub *Hub, api *pion.API, pc *pion.PeerConnection, logger logging.Logger) *webrtcBundle {
+	return &webrtcBundle{hub: hub, api: api, pc: pc, logger: logger}
+}
+
+// negotiate applies an offer and assigns streamIDs to the offer's m-lines
+// (see assignBundleSlots). An empty stream ID leaves its slot unused.
+// Streams that can't be played are logged and leave their slot unused, so
+// one offline camera doesn't fail the whole grid.
+func (b *webrtcBundle) negotiate(offer string, streamIDs []string) (string, error) {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+
+	if err := b.pc.SetRemoteDescription(pion.SessionDescription{Type: pion.SDPTypeOffer, SDP: offer}); err != nil {
+		return "", err
+	}
+
+	// Renegotiation offers keep the existing m-lines and may append new ones
+	for _, transceiver := range b.pc.GetTransceivers()[len(b.slots):] {
+		b.slots = append(b.slots, &bundleSlot{
+			transceiver: transceiver,
+			kind:        transceiver.Kind().String(),
+		})
+	}
+
+	kinds := make([]string, len(b.slots))
+	for i, slot := range b.slots {
+		kinds[i] = slot.kind
+	}
+
+	for i, streamID := range assignBundleSlots(kinds, streamIDs) {
+		if err := b.assign(b.slots[i], streamID); err != nil {
+			b.logger.Warn("Bundle slot unavailable", "stream_id", streamID, "kind", b.slots[i].kind, "error", err)
+		}
+	}
+
+	answer, err := b.pc.CreateAnswer(nil)
+	if err != nil {
+		return "", err
+	}
+	gathered := pion.GatheringCompletePromise(b.pc)
+	if err := b.pc.SetLocalDescription(answer); err != nil {
+		return "", err
+	}
+	<-gathered // no-op on renegotiation
+	return b.pc.LocalDescription().SDP, nil
+}
+
+// assign switches a slot to a stream, keeping the slot's track when the new
+// stream's codec matches so the browser sees one continuous RTP stream.
+func (b *webrtcBundle) assign(slot *bundleSlot, streamID string) error {
+	slot.mu.Lock()
+	slot.wanted = streamID
+	unchanged := slot.streamID == streamID
+	slot.mu.Unlock()
+	if unchanged {
+		return nil
+	}
+
+	b.release(slot)
+	if streamID == "" {
+		return nil
+	}
+
+	// Packets are dropped until the slot is switched over below
+	slot.mu.Lock()
+	generation := slot.generation + 1
+	slot.mu.Unlock()
+
+	attachment, err := b.hub.AttachTrack(streamID, slot.kind, func(packet *rtp.Packet) {
+		slot.write(generation, packet)
+	})
+	if err != nil {
+		return err
+	}
+
+	capability, err := trackCapability(attachment.Codec)
+	if err != nil {
+		attachment.Close()
+		return err
+	}
+
+	track := slot.track
+	ssrc := slot.ssrc
+	if track == nil || !capabilitiesMatch(track.Codec(), capability) {
+		track, err = pion.NewTrackLocalStaticRTP(capability, slot.kind, "slot-"+slot.transceiver.Mid())
+		if err == nil {
+			ssrc, err = b.setTrack(slot.transceiver, track)
+		}
+		if err != nil {
+			attachment.Close()
+			return err
+		}
+	}
+
+	slot.mu.Lock()
+	slot.attachment = attachment
+	slot.generation = generation
+	slot.streamID = streamID
+	slot.track = track
+	slot.ssrc = ssrc
+	slot.rewriter.clockRate = attachment.Codec.ClockRate
+	slot.rewriter.rebase()
+	slot.counters = newStreamSendCounters(streamID)
+	slot.mu.Unlock()
+	return nil
+}
+
+// setTrack makes a transceiver send a track and returns the sender's SSRC.
+func (b *webrtcBundle) setTrack(transceiver *pion.RTPTransceiver, track *pion.TrackLocalStaticRTP) (uint32, error) {
+	sender := transceiver.Sender()
+	if sender != nil {
+		if err := sender.ReplaceTrack(track); err != nil {
+			return 0, err
+		}
+	} else {
+		var err error
+		if sender, err = b.api.NewRTPSender(track, b.pc.SCTP().Transport()); err != nil {
+			return 0, err
+		}
+		if err := transceiver.SetSender(sender, track); err != nil {
+			_ = sender.Stop()
+			return 0, err
+		}
+
+		// Drain RTCP so the interceptors see NACK/PLI from the browser
+		go func() {
+			for {
+				if _, _, err := sender.ReadRTCP(); err != nil {
+					return
+				}
+			}
+		}()
+	}
+
+	var ssrc uint32
+	if encodings := sender.GetParameters().Encodings; len(encodings) > 0 {
+		ssrc = uint32(encodings[0].SSRC)
+	}
+	return ssrc, nil
+}
+
+// release detaches a slot from its stream. The slot's track stays in place.
+func (b *webrtcBundle) release(slot *bundleSlot) {
+	slot.mu.Lock()
+	attachment := slot.attachment
+	slot.attachment = nil
+	slot.streamID = ""
+	slot.generation++
+	slot.mu.Unlock()
+
+	// Outside the lock: closing may wait for a handler blocked in write
+	if attachment != nil {
+		attachment.Close()
+	}
+}
+
+// reattach moves the slots assigned to streamID to the stream's current
+// producer, with a new track if its codec changed. Their old attachments
+// belong to fan-outs the hub closed. Slots stay silent if the stream has no
+// producer; resume retries them once it does. Caller must hold b.mu.
+func (b *webrtcBundle) reattach(streamID string) {
+	for _, slot := range b.slots {
+		slot.mu.Lock()
+		wanted := slot.wanted
+		slot.mu.Unlock()
+		if wanted != streamID {
+			continue
+		}
+
+		b.release(slot)
+		if err := b.assign(slot, streamID); err != nil {
+			b.logger.Info("Bundle slot waiting for stream", "stream_id", streamID, "kind", slot.kind, "error", err)
+		}
+	}
+}
+
+// resume attaches the slots assigned to streamID that aren't playing it.
+// Caller must hold b.mu.
+func (b *webrtcBundle) resume(streamID string) {
+	for _, slot := range b.slots {
+		slot.mu.Lock()
+		waiting := slot.wanted == streamID && slot.streamID != streamID
+		slot.mu.Unlock()
+		if !waiting {
+			continue
+		}
+
+		if err := b.assign(slot, streamID); err != nil {
+			b.logger.Info("Bundle slot waiting for stream", "stream_id", streamID, "kind", slot.kind, "error", err)
+		}
+	}
+}
+
+// write sends a packet of the slot's current stream.
+func (s *bundleSlot) write(generation int, packet *rtp.Packet) {
+	s.mu.Lock()
+	if generation != s.generation {
+		s.mu.Unlock()
+		return // a packet of the previous stream still in flight
+	}
+	out := *packet // fan-out packets are shared with other peers
+	s.rewriter.rewrite(&out)
+	track := s.track
+	counters := s.counters
+	s.mu.Unlock()
+
+	counters.add(out.MarshalSize())
+	_ = track.WriteRTP(&out)
+}
+
+// streams returns the stream IDs currently playing in the bundle, without
+// duplicates.
+func (b *webrtcBundle) streams() []string {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	return b.streamsLocked()
+}
+
+// streamsLocked is streams for callers holding b.mu.
+func (b *webrtcBundle) streamsLocked() []string {
+	var streamIDs []string
+	for _, slot := range b.slots {
+		slot.mu.Lock()
+		streamID := slot.streamID
+		slot.mu.Unlock()
+		if streamID != "" && !slices.Contains(streamIDs, streamID) {
+			streamIDs = append(streamIDs, streamID)
+		}
+	}
+	return streamIDs
+}
+
+// streamForSSRC returns the stream playing on the track with the given SSRC.
+func (b *webrtcBundle) streamForSSRC(ssrc uint32) string {
+	for _, slot := range b.slotsSnapshot() {
+		slot.mu.Lock()
+		streamID, slotSSRC := slot.streamID, slot.ssrc
+		slot.mu.Unlock()
+		if slotSSRC == ssrc {
+			return streamID
+		}
+	}
+	return ""
+}
+
+// recover replays the cached GOP on every slot playing a stream. Returns
+// false if the stream has no GOP cache.
+func (b *webrtcBundle) recover(streamID string) bool {
+	recovered := false
+	for _, slot := range b.slotsSnapshot() {
+		slot.mu.Lock()
+		attachment := slot.attachment
+		if slot.streamID != streamID {
+			attachment = nil
+		}
+		slot.mu.Unlock()
+		if attachment != nil && attachment.Recover() {
+			recovered = true
+		}
+	}
+	return recovered
+}
+
+func (b *webrtcBundle) slotsSnapshot() []*bundleSlot {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	return append([]*bundleSlot(nil), b.slots...)
+}
+
+// close detaches every slot. The PeerConnection is closed by the caller.
+func (b *webrtcBundle) close() {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	b.closed = true
+	for _, slot := range b.slots {
+		b.release(slot)
+	}
+}
+
+// assignBundleSlots maps a bundle's stream list onto its m-lines, given the
+// media kind of each m-line in offer order: the k-th m-line of each kind gets
+// streamIDs[k], or "" past the end of the list.
+func assignBundleSlots(kinds, streamIDs []string) []string {
+	assigned := make([]string, len(kinds))
+	seen := make(map[string]int, 2)
+	for i, kind := range kinds {
+		if k := seen[kind]; k < len(streamIDs) {
+			assigned[i] = streamIDs[k]
+		}
+		seen[kind]++
+	}
+	return assigned
+}
+
+// ParseBundleStreams splits a comma-separated stream list. Empty entries are
+// kept: they mark slots the client isn't using.
+func ParseBundleStreams(list string) []string {
+	streamIDs := strings.Split(list, ",")
+	for i := range streamIDs {
+		streamIDs[i] = strings.TrimSpace(streamIDs[i])
+	}
+	return streamIDs
+}
+
+// trackCapability returns the pion codec capability for sending a stream's
+// track as-is.
+func trackCapability(codec *core.Codec) (pion.RTPCodecCapability, error) {
+	switch codec.Name {
+	case core.CodecH264:
+		fmtp := "level-asymmetry-allowed=1;packetization-mode=1"
+		if id := h264ProfileLevelID(codec); id != "" {
+			fmtp += ";profile-level-id=" + id
+		}
+		return pion.RTPCodecCapability{MimeType: pion.MimeTypeH264, ClockRate: 90000, SDPFmtpLine: fmtp}, nil
+	case core.CodecH265:
+		return pion.RTPCodecCapability{MimeType: pion.MimeTypeH265, ClockRate: 90000}, nil
+	case core.CodecOpus:
+		return pion.RTPCodecCapability{MimeType: pion.MimeTypeOpus, ClockRate: 48000, Channels: 2}, nil
+	case core.CodecPCMU:
+		return pion.RTPCodecCapability{MimeType: pion.MimeTypePCMU, ClockRate: 8000}, nil
+	case core.CodecPCMA:
+		return pion.RTPCodecCapability{MimeType: pion.MimeTypePCMA, ClockRate: 8000}, nil
+	}
+	return pion.RTPCodecCapability{}, ErrCodecNotSupported
+}
+
+// h264ProfileLevelID returns the profile-level-id of an H264 codec, from its
+// fmtp line or its SPS.
+func h264ProfileLevelID(codec *core.Codec) string {
+	if id := fmtpValue(codec.FmtpLine, "profile-level-id="); len(id) == 6 {
+		return strings.ToLower(id)
+	}
+	if sps, _ := parseSpsPps(codec.FmtpLine); len(sps) >= 4 {
+		return hex.EncodeToString(sps[1:4])
+	}
+	return ""
+}
+
+// capabilitiesMatch reports whether a slot's track can carry another stream
+// without renegotiating its codec.
+func capabilitiesMatch(a, b pion.RTPCodecCapability) bool {
+	return strings.EqualFold(a.MimeType, b.MimeType) &&
+		a.ClockRate == b.ClockRate &&
+		a.Channels == b.Channels &&
+		a.SDPFmtpLine == b.SDPFmtpLine
+}
+
+// CreateBundle creates a WebRTC consumer carrying several streams over one
+// PeerConnection and returns its session ID with the SDP answer. The offer's
+// m-lines are assigned to streamIDs as described on webrtcBundle; empty
+// entries leave a slot unused. Like CreateConsumer, the answer waits for ICE
+// gathering to complete.
+func (m *WebRTCManager) CreateBundle(streamIDs []string, offer string) (string, string, error) {
+	peerID := m.generatePeerID()
+
+	var bundle *webrtcBundle
+	var latency *peerLatency
+	if m.hub.latencyTracingEnabled() {
+		latency = newPeerLatency("", func(ssrc uint32) string { return bundle.streamForSSRC(ssrc) }, m.hub.latencyTimeline)
+	}
+	api, err := m.api(BundleMetricsStreamID, peerID, func(mediaSSRC uint32) {
+		if streamID := bundle.streamForSSRC(mediaSSRC); streamID != "" {
+			m.keyframes.request(streamID, peerID)
+		}
+	}, latency)
+	if err != nil {
+		return "", "", err
+	}
+
+	pc, err := api.NewPeerConnection(pion.Configuration{
+		ICEServers: m.config.ICEServers,
+	})
+	if err != nil {
+		return "", "", err
+	}
+	bundle = newWebRTCBundle(m.hub, api, pc, m.logger)
+
+	answer, err := bundle.negotiate(offer, streamIDs)
+	if err == nil && len(bundle.streams()) == 0 {
+		err = ErrStreamNotFound
+	}
+	if err != nil {
+		bundle.close()
+		_ = pc.Close()
+		return "", "", err
+	}
+
+	m.mu.Lock()
+	m.peers[peerID] = &webrtcPeer{bundle: bundle, pc: pc, latency: latency}
+	m.mu.Unlock()
+	playing := m.updateBundleStreams(peerID, nil, bundle.streams())
+
+	m.logger.Info("WebRTC bundle connected", "peer_id", peerID, "streams", playing)
+
+	pc.OnConnectionStateChange(func(state pion.PeerConnectionState) {
+		switch state {
+		case pion.PeerConnectionStateDisconnected,
+			pion.PeerConnectionStateFailed,
+			pion.PeerConnectionStateClosed:
+			m.removeBundle(peerID, bundle, state)
+		}
+	})
+
+	return peerID, answer, nil
+}
+
+// moveBundleStream updates a bundle's slots for streamID with update, under
+// the bundle's negotiation lock, and its stream memberships after.
+func (m *WebRTCManager) moveBundleStream(peerID string, bundle *webrtcBundle, streamID string, update func(streamID string)) {
+	bundle.mu.Lock()
+	if bundle.closed {
+		bundle.mu.Unlock()
+		return
+	}
+	before := bundle.streamsLocked()
+	update(streamID)
+	after := bundle.streamsLocked()
+	bundle.mu.Unlock()
+
+	m.updateBundleStreams(peerID, before, after)
+}
+
+// ResumeStreamConsumers attaches bundle slots waiting for a stream, after its
+// consumers were closed without a producer to continue on (see
+// CloseStreamConsumers). Call when the stream has a new producer.
+func (m *WebRTCManager) ResumeStreamConsumers(streamID string) {
+	m.mu.RLock()
+	bundles := make(map[string]*webrtcBundle)
+	for peerID, peer := range m.peers {
+		if peer.bundle != nil {
+			bundles[peerID] = peer.bundle
+		}
+	}
+	m.mu.RUnlock()
+
+	for peerID, bundle := range bundles {
+		m.moveBundleStream(peerID, bundle, streamID, bundle.resume)
+	}
+}
+
+// RenegotiateBundle applies a new offer to a bundle, reassigning its slots
+// to streamIDs, and returns the SDP answer. Streams no longer listed stop;
+// new ones start on the slots they are assigned to.
+func (m *WebRTCManager) RenegotiateBundle(sessionID string, streamIDs []string, offer string) (string, error) {
+	bundle, err := m.bundleSession(sessionID)
+	if err != nil {
+		return "", err
+	}
+
+	before := bundle.streams()
+	answer, err := bundle.negotiate(offer, streamIDs)
+	if err != nil {
+		return "", err
+	}
+	playing := m.updateBundleStreams(sessionID, before, bundle.streams())
+
+	m.logger.Debug("WebRTC bundle renegotiated", "peer_id", sessionID, "streams", playing)
+	return answer, nil
+}
+
+// CloseBundle ends a bundle session.
+func (m *WebRTCManager) CloseBundle(sessionID string) error {
+	bundle, err := m.bundleSession(sessionID)
+	if err != nil {
+		return err
+	}
+	return bundle.pc.Close()
+}
+
+func (m *WebRTCManager) bundleSession(sessionID string) (*webrtcBundle, error) {
+	m.mu.RLock()
+	defer m.mu.RUnlock()
+
+	peer, ok := m.peers[sessionID]
+	if !ok || peer.bundle == nil {
+		return nil, ErrSessionNotFound
+	}
+	return peer.bundle, nil
+}
+
+// updateBundleStreams moves a bundle's stream memberships from before to
+// after and returns after.
+func (m *WebRTCManager) updateBundleStreams(peerID string, before, after []string) []string {
+	for _, streamID := range before {
+		if slices.Contains(after, streamID) {
+			continue
+		}
+		m.mu.Lock()
+		remainingPeers := m.removeStreamPeerLocked(streamID, peerID)
+		m.mu.Unlock()
+		m.streamPeerRemoved(streamID, remainingPeers)
+	}
+	for _, streamID := range after {
+		if slices.Contains(before, streamID) {
+			continue
+		}
+		m.mu.Lock()
+		streamPeerCount := m.addStreamPeerLocked(streamID, peerID)
+		m.mu.Unlock()
+		SetActivePeers(streamID, streamPeerCount)
+	}
+	return after
+}
+
+func (m *WebRTCManager) removeBundle(peerID string, bundle *webrtcBundle, state pion.PeerConnectionState) {
+	m.mu.Lock()
+	peer, ok := m.peers[peerID]
+	if ok && peer.bundle == bundle {
+		delete(m.peers, peerID)
+	}
+	m.mu.Unlock()
+
+	streamIDs := bundle.streams()
+	bundle.close()
+	_ = bundle.pc.Close()
+	m.updateBundleStreams(peerID, streamIDs, nil)
+
+	if ok {
+		m.logger.Info("WebRTC bundle disconnected", "peer_id", peerID, "state", state.String(), "streams", streamIDs)
+	}
+}
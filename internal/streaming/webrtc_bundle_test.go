@@ -0,0 +1,110 @@
+package streaming
+
+import (
+	"slices"
+	"testing"
+
+	"github.com/AlexxIT/go2rtc/pkg/core"
+	pion "github.com/pion/webrtc/v4"
+)
+
+func TestAssignBundleSlots(t *testing.T) {
+	tests := []struct {
+		name      string
+		kinds     []string
+		streamIDs []string
+		want      []string
+	}{
+		{
+			name:      "video only",
+			kinds:     []string{"video", "video", "video"},
+			streamIDs: []string{"a", "b", "c"},
+			want:      []string{"a", "b", "c"},
+		},
+		{
+			name:      "audio follows video",
+			kinds:     []string{"video", "audio", "video", "audio"},
+			streamIDs: []string{"a", "b"},
+			want:      []string{"a", "a", "b", "b"},
+		},
+		{
+			name:      "unused slot",
+			kinds:     []string{"video", "video", "video"},
+			streamIDs: []string{"a", "", "c"},
+			want:      []string{"a", "", "c"},
+		},
+		{
+			name:      "more m-lines than streams",
+			kinds:     []string{"video", "video"},
+			streamIDs: []string{"a"},
+			want:      []string{"a", ""},
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := assignBundleSlots(tt.kinds, tt.streamIDs); !slices.Equal(got, tt.want) {
+				t.Errorf("assignBundleSlots() = %q, want %q", got, tt.want)
+			}
+		})
+	}
+}
+
+func TestParseBundleStreams(t *testing.T) {
+	got := ParseBundleStreams("cam1, ,cam3")
+	want := []string{"cam1", "", "cam3"}
+	if !slices.Equal(got, want) {
+		t.Errorf("ParseBundleStreams() = %q, want %q", got, want)
+	}
+}
+
+func TestTrackCapability(t *testing.T) {
+	tests := []struct {
+		name     string
+		codec    *core.Codec
+		wantMime string
+		wantFmtp string
+		wantErr  bool
+	}{
+		{
+			name:     "h264 profile from fmtp",
+			codec:    &core.Codec{Name: core.CodecH264, ClockRate: 90000, FmtpLine: "packetization-mode=1;profile-level-id=640028"},
+			wantMime: pion.MimeTypeH264,
+			wantFmtp: "level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=640028",
+		},
+		{
+			name:     "h264 profile from sps",
+			codec:    &core.Codec{Name: core.CodecH264, ClockRate: 90000, FmtpLine: "sprop-parameter-sets=Z0IAKeKQFAe2AtwEBAaQeJEV,aM48gA=="},
+			wantMime: pion.MimeTypeH264,
+			wantFmtp: "level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=420029",
+		},
+		{
+			name:     "opus",
+			codec:    &core.Codec{Name: core.CodecOpus, ClockRate: 48000, Channels: 2},
+			wantMime: pion.MimeTypeOpus,
+		},
+		{
+			name:    "aac needs transcoding",
+			codec:   &core.Codec{Name: core.CodecAAC, ClockRate: 48000},
+			wantErr: true,
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			got, err := trackCapability(tt.codec)
+			if tt.wantErr {
+				if err == nil {
+					t.Fatal("expected error")
+				}
+				return
+			}
+			if err != nil {
+				t.Fatalf("unexpected error: %v", err)
+			}
+			if got.MimeType != tt.wantMime || got.SDPFmtpLine != tt.wantFmtp {
+				t.Errorf("trackCapability() = %s %q, want %s %q", got.MimeType, got.SDPFmtpLine, tt.wantMime, tt.wantFmtp)
+			}
+		})
+	}
+}
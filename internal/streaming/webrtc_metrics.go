@@ -1,6 +1,9 @@
 package streaming
 
 import (
+	"sync"
+	"sync/atomic"
+
 	"github.com/prometheus/client_golang/prometheus"
 	"github.com/prometheus/client_golang/prometheus/promauto"
 )
@@ -29,85 +32,213 @@ var (
 		Help:      "Number of active WebRTC peers per stream",
 	}, []string{"stream_id"})
 
-	// Per-peer RTCP feedback counters.
-	webrtcPeerRTCPPackets = promauto.NewCounterVec(prometheus.CounterOpts{
+	// Per-stream RTCP feedback counters, summed over the stream's peers.
+	// Peers are not labeled: every connection gets a fresh peer ID, so a
+	// peer_id label would add series with every viewer. Per-stream rates are
+	// kept in the metrics history for the UI instead.
+	webrtcRTCPPackets = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "webrtc",
+		Name:      "rtcp_packets_total",
+		Help:      "RTCP packets received from peers per stream",
+	}, []string{"stream_id"})
+
+	webrtcNACKs = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "webrtc",
+		Name:      "nacks_total",
+		Help:      "NACK requests from peers per stream (indicates packet loss)",
+	}, []string{"stream_id"})
+
+	webrtcPLIs = promauto.NewCounterVec(prometheus.CounterOpts{
+		Namespace: "videonode",
+		Subsystem: "webrtc",
+		Name:      "plis_total",
+		Help:      "PLI requests from peers per stream (picture loss indication)",
+	}, []string{"stream_id"})
+
+	webrtcFIRs = promauto.NewCounterVec(prometheus.CounterOpts{
 		Namespace: "videonode",
 		Subsystem: "webrtc",
-		Name:      "peer_rtcp_packets_total",
-		Help:      "RTCP packets received per peer",
-	}, []string{"stream_id", "peer_id"})
+		Name:      "firs_total",
+		Help:      "FIR requests from peers per stream (full intra request)",
+	}, []string{"stream_id"})
 
-	webrtcPeerNACKs = promauto.NewCounterVec(prometheus.CounterOpts{
+	// Per-stream keyframe recoveries (coalesced, rate-limited PLI/FIR).
+	webrtcKeyframeRecoveries = promauto.NewCounterVec(prometheus.CounterOpts{
 		Namespace: "videonode",
 		Subsystem: "webrtc",
-		Name:      "peer_nacks_total",
-		Help:      "NACK requests per peer (indicates packet loss)",
-	}, []string{"stream_id", "peer_id"})
+		Name:      "keyframe_recoveries_total",
+		Help:      "Keyframe recoveries issued per stream after coalescing PLI/FIR across peers",
+	}, []string{"stream_id"})
 
-	webrtcPeerPLIs = promauto.NewCounterVec(prometheus.CounterOpts{
+	// Shared UDP mux egress counters.
+	webrtcUDPBatches = promauto.NewCounter(prometheus.CounterOpts{
 		Namespace: "videonode",
 		Subsystem: "webrtc",
-		Name:      "peer_plis_total",
-		Help:      "PLI requests per peer (picture loss indication)",
-	}, []string{"stream_id", "peer_id"})
+		Name:      "udp_send_batches_total",
+		Help:      "sendmmsg calls issued by the shared UDP mux",
+	})
 
-	webrtcPeerFIRs = promauto.NewCounterVec(prometheus.CounterOpts{
+	webrtcUDPMessages = promauto.NewCounter(prometheus.CounterOpts{
 		Namespace: "videonode",
 		Subsystem: "webrtc",
-		Name:      "peer_firs_total",
-		Help:      "FIR requests per peer (full intra request)",
-	}, []string{"stream_id", "peer_id"})
+		Name:      "udp_send_messages_total",
+		Help:      "Messages sent by the shared UDP mux (a GSO message carries several datagrams)",
+	})
 
-	// Per-peer jitter gauge (from RTCP Receiver Reports).
-	webrtcPeerJitter = promauto.NewGaugeVec(prometheus.GaugeOpts{
+	webrtcUDPSendErrors = promauto.NewCounter(prometheus.CounterOpts{
 		Namespace: "videonode",
 		Subsystem: "webrtc",
-		Name:      "peer_jitter",
-		Help:      "Interarrival jitter per peer (RTP timestamp units, divide by 90000 for seconds)",
-	}, []string{"stream_id", "peer_id"})
+		Name:      "udp_send_errors_total",
+		Help:      "Messages the shared UDP mux dropped because the kernel refused to send them",
+	})
+
+	// Per-stream jitter distribution over the Receiver Reports of all peers.
+	webrtcJitter = promauto.NewHistogramVec(prometheus.HistogramOpts{
+		Namespace: "videonode",
+		Subsystem: "webrtc",
+		Name:      "jitter_seconds",
+		Help:      "Interarrival jitter reported by peers per stream",
+		Buckets:   prometheus.ExponentialBuckets(0.001, 2, 10), // 1ms to 512ms
+	}, []string{"stream_id"})
+
+	// Per-stream running totals, read by the metrics history sampler.
+	egressTotals   = make(map[string]*streamTotals)
+	egressTotalsMu sync.Mutex
 )
 
-// IncrementRTCPPackets records RTCP packets received from a peer.
-func IncrementRTCPPackets(streamID, peerID string) {
-	webrtcPeerRTCPPackets.WithLabelValues(streamID, peerID).Inc()
+// jitterClockRate converts RTP timestamp units of video to seconds.
+const jitterClockRate = 90000
+
+// StreamEgress is a snapshot of the totals of a stream since startup.
+type StreamEgress struct {
+	BytesSent uint64 // RTP bytes sent to all consumers
+	NACKs     uint64 // packets peers requested again
+	PLIs      uint64 // picture loss indications from peers
+	Peers     int    // currently connected peers
 }
 
-// IncrementNACKs records NACK requests received from a peer.
-func IncrementNACKs(streamID, peerID string, count int) {
-	webrtcPeerNACKs.WithLabelValues(streamID, peerID).Add(float64(count))
+// streamTotals are the running totals of one stream. Updated without locks
+// from the packet and RTCP paths, which resolve them once.
+type streamTotals struct {
+	bytes atomic.Uint64
+	nacks atomic.Uint64
+	plis  atomic.Uint64
+	peers atomic.Int64
 }
 
-// IncrementPLIs records PLI requests received from a peer.
-func IncrementPLIs(streamID, peerID string) {
-	webrtcPeerPLIs.WithLabelValues(streamID, peerID).Inc()
+// totalsFor returns the totals of a stream, creating them.
+func totalsFor(streamID string) *streamTotals {
+	egressTotalsMu.Lock()
+	defer egressTotalsMu.Unlock()
+	t, ok := egressTotals[streamID]
+	if !ok {
+		t = &streamTotals{}
+		egressTotals[streamID] = t
+	}
+	return t
 }
 
-// IncrementFIRs records FIR requests received from a peer.
-func IncrementFIRs(streamID, peerID string) {
-	webrtcPeerFIRs.WithLabelValues(streamID, peerID).Inc()
+// EgressSnapshot returns the totals of every stream that sent packets or had
+// peers.
+func EgressSnapshot() map[string]StreamEgress {
+	egressTotalsMu.Lock()
+	defer egressTotalsMu.Unlock()
+	result := make(map[string]StreamEgress, len(egressTotals))
+	for streamID, t := range egressTotals {
+		result[streamID] = StreamEgress{
+			BytesSent: t.bytes.Load(),
+			NACKs:     t.nacks.Load(),
+			PLIs:      t.plis.Load(),
+			Peers:     int(t.peers.Load()),
+		}
+	}
+	return result
 }
 
-// RecordJitter records interarrival jitter from RTCP Receiver Reports.
-func RecordJitter(streamID, peerID string, jitter uint32) {
-	webrtcPeerJitter.WithLabelValues(streamID, peerID).Set(float64(jitter))
+// IncrementPacketsSent records packets and bytes sent for a stream.
+// Per-packet callers should resolve streamSendCounters once instead.
+func IncrementPacketsSent(streamID string, bytes int) {
+	newStreamSendCounters(streamID).add(bytes)
 }
 
-// DeletePeerMetrics removes all metrics for a peer when disconnected.
-func DeletePeerMetrics(streamID, peerID string) {
-	webrtcPeerRTCPPackets.DeleteLabelValues(streamID, peerID)
-	webrtcPeerNACKs.DeleteLabelValues(streamID, peerID)
-	webrtcPeerPLIs.DeleteLabelValues(streamID, peerID)
-	webrtcPeerFIRs.DeleteLabelValues(streamID, peerID)
-	webrtcPeerJitter.DeleteLabelValues(streamID, peerID)
+// streamSendCounters holds the egress counters of one stream, resolved once
+// so the per-packet path skips the label hash lookups of WithLabelValues.
+type streamSendCounters struct {
+	packets prometheus.Counter
+	bytes   prometheus.Counter
+	totals  *streamTotals
 }
 
-// IncrementPacketsSent records packets and bytes sent for a stream.
-func IncrementPacketsSent(streamID string, bytes int) {
-	webrtcStreamPackets.WithLabelValues(streamID).Inc()
-	webrtcStreamBytes.WithLabelValues(streamID).Add(float64(bytes))
+func newStreamSendCounters(streamID string) streamSendCounters {
+	return streamSendCounters{
+		packets: webrtcStreamPackets.WithLabelValues(streamID),
+		bytes:   webrtcStreamBytes.WithLabelValues(streamID),
+		totals:  totalsFor(streamID),
+	}
+}
+
+func (c streamSendCounters) add(bytes int) {
+	c.packets.Inc()
+	c.bytes.Add(float64(bytes))
+	c.totals.bytes.Add(uint64(bytes))
+}
+
+// rtcpCounters holds the RTCP feedback metrics of a peer's stream, resolved
+// once when the peer's interceptor is bound.
+type rtcpCounters struct {
+	packets prometheus.Counter
+	nacks   prometheus.Counter
+	plis    prometheus.Counter
+	firs    prometheus.Counter
+	jitter  prometheus.Observer
+	totals  *streamTotals
+}
+
+func newRTCPCounters(streamID string) rtcpCounters {
+	return rtcpCounters{
+		packets: webrtcRTCPPackets.WithLabelValues(streamID),
+		nacks:   webrtcNACKs.WithLabelValues(streamID),
+		plis:    webrtcPLIs.WithLabelValues(streamID),
+		firs:    webrtcFIRs.WithLabelValues(streamID),
+		jitter:  webrtcJitter.WithLabelValues(streamID),
+		totals:  totalsFor(streamID),
+	}
+}
+
+func (c rtcpCounters) addNACKs(count int) {
+	c.nacks.Add(float64(count))
+	c.totals.nacks.Add(uint64(count))
+}
+
+func (c rtcpCounters) addPLI() {
+	c.plis.Inc()
+	c.totals.plis.Add(1)
+}
+
+func (c rtcpCounters) observeJitter(jitter uint32) {
+	c.jitter.Observe(float64(jitter) / jitterClockRate)
+}
+
+// IncrementKeyframeRecoveries records one coalesced keyframe recovery for a stream.
+func IncrementKeyframeRecoveries(streamID string) {
+	webrtcKeyframeRecoveries.WithLabelValues(streamID).Inc()
+}
+
+// IncrementUDPBatches records one batched send of the given message count.
+func IncrementUDPBatches(messages int) {
+	webrtcUDPBatches.Inc()
+	webrtcUDPMessages.Add(float64(messages))
+}
+
+// IncrementUDPSendErrors records a message the shared UDP mux dropped.
+func IncrementUDPSendErrors() {
+	webrtcUDPSendErrors.Inc()
 }
 
 // SetActivePeers sets the current number of active peers for a stream.
 func SetActivePeers(streamID string, count int) {
 	webrtcActivePeers.WithLabelValues(streamID).Set(float64(count))
+	totalsFor(streamID).peers.Store(int64(count))
 }
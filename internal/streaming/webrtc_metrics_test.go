@@ -0,0 +1,19 @@
+package streaming
+
+import "testing"
+
+func BenchmarkIncrementPacketsSent(b *testing.B) {
+	b.ReportAllocs()
+	for b.Loop() {
+		IncrementPacketsSent("bench", 1200)
+	}
+}
+
+func BenchmarkStreamSendCounters(b *testing.B) {
+	counters := newStreamSendCounters("bench")
+
+	b.ReportAllocs()
+	for b.Loop() {
+		counters.add(1200)
+	}
+}
@@ -0,0 +1,37 @@
+package streaming
+
+import "testing"
+
+func TestParseTrickleFragment(t *testing.T) {
+	fragment := "a=ice-ufrag:EsAw\r\n" +
+		"a=ice-pwd:P2uYro0UCOQ4zxjKXaWCBui1\r\n" +
+		"a=candidate:1387637174 1 udp 2122260223 192.0.2.1 61764 typ host generation 0\r\n" +
+		"m=audio 9 UDP/TLS/RTP/SAVPF 111\r\n" +
+		"a=mid:1\r\n" +
+		"a=candidate:3471623853 1 udp 2122194687 198.51.100.2 61765 typ host generation 0\r\n" +
+		"a=end-of-candidates\r\n"
+
+	candidates := parseTrickleFragment(fragment)
+	if len(candidates) != 2 {
+		t.Fatalf("expected 2 candidates, got %d", len(candidates))
+	}
+
+	first := candidates[0]
+	if first.Candidate != "candidate:1387637174 1 udp 2122260223 192.0.2.1 61764 typ host generation 0" {
+		t.Errorf("unexpected candidate: %q", first.Candidate)
+	}
+	if first.SDPMid != nil || first.SDPMLineIndex == nil || *first.SDPMLineIndex != 0 {
+		t.Error("candidate before any a=mid should target m-line 0")
+	}
+
+	second := candidates[1]
+	if second.SDPMid == nil || *second.SDPMid != "1" {
+		t.Errorf("second candidate mid = %v, want 1", second.SDPMid)
+	}
+}
+
+func TestParseTrickleFragment_Empty(t *testing.T) {
+	if got := parseTrickleFragment("a=end-of-candidates\r\n"); len(got) != 0 {
+		t.Errorf("expected no candidates, got %d", len(got))
+	}
+}
@@ -0,0 +1,8 @@
+//go:build darwin
+
+package streams
+
+// isDeviceReady reports devices as ready: there is no V4L2 on macOS.
+func isDeviceReady(_ string) bool {
+	return true
+}
@@ -0,0 +1,11 @@
+//go:build linux
+
+package streams
+
+import "github.com/smazurov/videonode/pkg/linuxav/v4l2"
+
+// isDeviceReady reports whether a V4L2 device is ready to capture: it has a
+// signal (HDMI capture) or exists (webcam).
+func isDeviceReady(devicePath string) bool {
+	return v4l2.IsDeviceReady(devicePath)
+}
@@ -9,6 +9,7 @@ import (
 	"github.com/smazurov/videonode/internal/events"
 	"github.com/smazurov/videonode/internal/ffmpeg"
 	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/metrics"
 	"github.com/smazurov/videonode/internal/process"
 )
 
@@ -59,6 +60,10 @@ type StreamProcessManager interface {
 
 	// IsCrashed returns true if stream is in crashed state showing CRASH pattern.
 	IsCrashed(streamID string) bool
+
+	// OnFirstPacket records that a stream's producer delivered its first
+	// packet, ending its startup.
+	OnFirstPacket(streamID string)
 }
 
 // streamProcessManager wraps process.Pool with stream-specific behavior.
@@ -69,14 +74,25 @@ type streamProcessManager struct {
 	eventBus       *events.Bus
 	logger         logging.Logger
 	crashedStreams map[string]bool
+	slatePlayer    SlatePlayer
+	slates         *slateEncoder
+	slating        map[string][]string // stream ID -> stream IDs playing its slates
+	scheduler      *startupScheduler
+	deviceReady    func(devicePath string) bool
+	launchedAt     map[string]time.Time // FFmpeg launches waiting for their first packet
 	mu             sync.Mutex
 }
 
 // ProcessManagerOptions contains options for creating a StreamProcessManager.
 type ProcessManagerOptions struct {
-	Store     Store
-	Processor *processor
-	EventBus  *events.Bus
+	Store       Store
+	Processor   *processor
+	EventBus    *events.Bus
+	SlatePlayer SlatePlayer // Serves no-signal/crash slates instead of FFmpeg (optional)
+
+	// StartupConcurrency is how many streams may initialize FFmpeg at once
+	// (0 = unlimited)
+	StartupConcurrency int
 }
 
 // NewStreamProcessManager creates a new StreamProcessManager.
@@ -89,6 +105,12 @@ func NewStreamProcessManager(opts *ProcessManagerOptions) StreamProcessManager {
 		eventBus:       opts.EventBus,
 		logger:         logger,
 		crashedStreams: make(map[string]bool),
+		slatePlayer:    opts.SlatePlayer,
+		slates:         newSlateEncoder(),
+		slating:        make(map[string][]string),
+		scheduler:      newStartupScheduler(opts.StartupConcurrency),
+		deviceReady:    isDeviceReady,
+		launchedAt:     make(map[string]time.Time),
 	}
 
 	spm.pool = process.NewPool(&process.PoolOptions{
@@ -125,7 +147,9 @@ func (m *streamProcessManager) onStateChange(id string, _, newState process.Stat
 	if newState == process.StateError {
 		m.mu.Lock()
 		m.crashedStreams[id] = true
+		delete(m.launchedAt, id)
 		m.mu.Unlock()
+		m.scheduler.release(id)
 
 		m.logger.Warn("Stream exited unexpectedly, restarting", "stream_id", id)
 
@@ -142,7 +166,7 @@ func (m *streamProcessManager) onStateChange(id string, _, newState process.Stat
 
 		// Restart asynchronously (callback shouldn't block)
 		go func() {
-			if err := m.pool.Restart(id); err != nil {
+			if err := m.restart(id); err != nil {
 				m.logger.Error("Failed to restart stream", "stream_id", id, "error", err)
 			}
 		}()
@@ -154,13 +178,33 @@ func (m *streamProcessManager) configureProcess(streamID string, proc *process.P
 	proc.SetLogParser(logging.GetLogger("ffmpeg").With("stream_id", streamID), ffmpeg.ParseLogLevel)
 }
 
-// Start starts the FFmpeg process for a stream.
+// Start starts the FFmpeg process for a stream, or its slate if it has no
+// signal. FFmpeg is launched once the stream gets a startup slot.
 func (m *streamProcessManager) Start(streamID string) error {
-	return m.pool.Start(streamID)
+	if m.pool.IsRunning(streamID) {
+		return fmt.Errorf("process %s already running", streamID)
+	}
+	if m.playSlate(streamID) {
+		return nil
+	}
+	m.scheduleLaunch(streamID, false)
+	return nil
 }
 
-// Stop gracefully stops the FFmpeg process for a stream.
+// Stop gracefully stops the FFmpeg process or slate of a stream, and cancels
+// a launch that is still waiting to start.
 func (m *streamProcessManager) Stop(streamID string) error {
+	m.scheduler.release(streamID)
+
+	m.mu.Lock()
+	slateIDs := m.slating[streamID]
+	delete(m.slating, streamID)
+	delete(m.launchedAt, streamID)
+	m.mu.Unlock()
+
+	for _, id := range slateIDs {
+		m.slatePlayer.StopSlate(id)
+	}
 	return m.pool.Stop(streamID)
 }
 
@@ -170,7 +214,151 @@ func (m *streamProcessManager) Restart(streamID string) error {
 	m.mu.Lock()
 	delete(m.crashedStreams, streamID)
 	m.mu.Unlock()
-	return m.pool.Restart(streamID)
+	return m.restart(streamID)
+}
+
+// restart switches a stream to its slate or restarts FFmpeg. A slate keeps
+// playing until the restarted FFmpeg connects and replaces it, so viewers
+// don't see a gap.
+func (m *streamProcessManager) restart(streamID string) error {
+	if m.playSlate(streamID) {
+		m.scheduler.release(streamID)
+		return m.pool.Stop(streamID)
+	}
+
+	m.scheduleLaunch(streamID, true)
+	return nil
+}
+
+// scheduleLaunch starts or restarts a stream's FFmpeg once it gets a startup
+// slot and its device reports ready. The running process, or slate, keeps
+// serving the stream until then.
+func (m *streamProcessManager) scheduleLaunch(streamID string, restart bool) {
+	var priority int
+	if spec, ok := m.store.GetStream(streamID); ok {
+		priority = spec.StartupPriority
+	}
+
+	m.scheduler.schedule(streamID, priority, func(released <-chan struct{}) {
+		if !m.waitForDevice(streamID, released) {
+			return // stopped while waiting
+		}
+
+		m.mu.Lock()
+		delete(m.slating, streamID)
+		m.launchedAt[streamID] = time.Now()
+		m.mu.Unlock()
+
+		var err error
+		if restart {
+			err = m.pool.Restart(streamID)
+		} else {
+			err = m.pool.Start(streamID)
+		}
+		if err != nil {
+			m.logger.Error("Failed to start stream", "stream_id", streamID, "error", err)
+			m.scheduler.release(streamID)
+		}
+	})
+}
+
+// waitForDevice waits until a stream's capture device reports ready, or for
+// deviceReadyTimeout. Devices that just appeared or locked onto a signal can
+// take a moment before they accept format negotiation. Returns false if
+// released is closed first.
+func (m *streamProcessManager) waitForDevice(streamID string, released <-chan struct{}) bool {
+	devicePath := m.processor.sourceDevice(streamID)
+	if devicePath == "" {
+		return true
+	}
+
+	deadline := time.Now().Add(deviceReadyTimeout)
+	for !m.deviceReady(devicePath) {
+		if time.Now().After(deadline) {
+			m.logger.Warn("Device not ready, starting stream anyway", "stream_id", streamID, "device", devicePath)
+			return true
+		}
+
+		select {
+		case <-released:
+			return false
+		case <-time.After(deviceReadyPollInterval):
+		}
+	}
+	return true
+}
+
+// OnFirstPacket records a stream's time to first packet and frees its
+// startup slot for the next stream.
+func (m *streamProcessManager) OnFirstPacket(streamID string) {
+	m.mu.Lock()
+	launchedAt, ok := m.launchedAt[streamID]
+	delete(m.launchedAt, streamID)
+	m.mu.Unlock()
+
+	if !ok {
+		return // extra output, or a producer this manager didn't launch
+	}
+
+	timeToFirstPacket := time.Since(launchedAt)
+	metrics.ObserveStreamStartup(streamID, timeToFirstPacket.Seconds())
+	m.logger.Info("Stream live", "stream_id", streamID, "time_to_first_packet", timeToFirstPacket.Round(time.Millisecond))
+
+	m.scheduler.release(streamID)
+}
+
+// playSlate serves a stream's no-signal or crash slate from the slate player
+// instead of running FFmpeg. Slates are pre-encoded once with the stream's
+// encoder settings. Returns false if the stream should run FFmpeg: it has a
+// signal, there is no slate player, or its slate can't be pre-encoded, in
+// which case FFmpeg renders the pattern live.
+func (m *streamProcessManager) playSlate(streamID string) bool {
+	if m.slatePlayer == nil || m.processor.noSignalReason(streamID) == "" {
+		return false
+	}
+
+	processed, err := m.processor.processStream(streamID)
+	if err != nil || processed.Params == nil || processed.NoSignalReason == "" {
+		return false
+	}
+
+	var playing []string
+	for i, target := range slateTargets(streamID, processed.Params) {
+		clip, err := m.slates.encode(target.params)
+		if err == nil {
+			err = m.slatePlayer.PlaySlate(target.streamID, clip.codec, clip.data, clip.fps)
+		}
+		if err != nil {
+			m.logger.Warn("Failed to play slate", "stream_id", target.streamID, "error", err)
+			if i == 0 {
+				return false // the stream itself needs FFmpeg, which renders every output
+			}
+			continue
+		}
+		playing = append(playing, target.streamID)
+	}
+
+	m.mu.Lock()
+	m.slating[streamID] = playing
+	m.mu.Unlock()
+
+	m.logger.Info("Stream serving slate", "stream_id", streamID, "reason", processed.NoSignalReason)
+	if m.eventBus != nil {
+		m.eventBus.Publish(events.StreamStateChangedEvent{
+			StreamID:  streamID,
+			Enabled:   true,
+			Timestamp: time.Now().Format(time.RFC3339),
+		})
+	}
+	return true
+}
+
+// isSlating reports whether a stream is serving its slate.
+func (m *streamProcessManager) isSlating(streamID string) bool {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	_, ok := m.slating[streamID]
+	return ok
 }
 
 // IsCrashed returns true if the stream is in crashed state.
@@ -183,6 +371,14 @@ func (m *streamProcessManager) IsCrashed(streamID string) bool {
 // GetStatus returns the current state of a stream's process.
 func (m *streamProcessManager) GetStatus(streamID string) (*ProcessInfo, error) {
 	info := m.pool.GetStatus(streamID)
+	if m.isSlating(streamID) {
+		// Served without a process
+		return &ProcessInfo{
+			StreamID:     info.ID,
+			State:        ProcessStateRunning,
+			RestartCount: info.RestartCount,
+		}, nil
+	}
 	return &ProcessInfo{
 		StreamID:     info.ID,
 		State:        ProcessState(info.State),
@@ -194,14 +390,14 @@ func (m *streamProcessManager) GetStatus(streamID string) (*ProcessInfo, error)
 
 // IsRunning checks if a stream's process is currently running.
 func (m *streamProcessManager) IsRunning(streamID string) bool {
-	return m.pool.IsRunning(streamID)
+	return m.pool.IsRunning(streamID) || m.isSlating(streamID)
 }
 
 // StartAll starts all enabled streams. Called on daemon startup.
 func (m *streamProcessManager) StartAll() error {
 	allStreams := m.store.GetAllStreams()
 
-	m.logger.Info("Starting all enabled streams", "total_streams", len(allStreams))
+	m.logger.Info("Starting all enabled streams", "total_streams", len(allStreams), "startup_concurrency", m.scheduler.limit)
 
 	var startErrors []error
 
@@ -10,8 +10,10 @@ import (
 
 // ProcessedStream represents a stream with its FFmpeg command ready to run.
 type ProcessedStream struct {
-	StreamID      string
-	FFmpegCommand string
+	StreamID       string
+	FFmpegCommand  string
+	Params         *ffmpeg.Params // Params the command was built from (nil for custom commands)
+	NoSignalReason string         // Set when the command renders a no-signal or crash pattern
 }
 
 // encoderSelector is a function that selects the best encoder for a given codec.
@@ -32,6 +34,8 @@ type processor struct {
 	deviceResolver  deviceResolver
 	getStreamState  func(streamID string) (*Stream, bool) // Get runtime state
 	isCrashed       func(streamID string) bool            // Check if stream crashed
+	nativeAudio     bool                                  // Device audio is captured by the streaming hub, not FFmpeg
+	latencyTracing  bool                                  // Device inputs carry capture times for latency tracing
 	logger          logging.Logger
 }
 
@@ -78,6 +82,18 @@ func (p *processor) setStreamStateGetter(getter func(streamID string) (*Stream,
 	p.getStreamState = getter
 }
 
+// setNativeAudio leaves ALSA capture out of generated commands when the
+// streaming hub captures stream audio itself.
+func (p *processor) setNativeAudio(enabled bool) {
+	p.nativeAudio = enabled
+}
+
+// setLatencyTracing makes generated device commands carry capture times for
+// the streaming hub's latency tracing.
+func (p *processor) setLatencyTracing(enabled bool) {
+	p.latencyTracing = enabled
+}
+
 // setIsCrashed sets the function to check if a stream is in crashed state.
 func (p *processor) setIsCrashed(fn func(streamID string) bool) {
 	p.isCrashed = fn
@@ -110,6 +126,22 @@ func (p *processor) applyStreamSettingsToFFmpegParams(ffmpegParams *ffmpeg.Param
 	case streamConfig.TestMode:
 		ffmpegParams.OverlayText = "TEST MODE"
 	}
+
+	// Device audio comes from the hub's native capture; overlays keep their
+	// generated tone
+	if p.nativeAudio && ffmpegParams.OverlayText == "" {
+		ffmpegParams.AudioDevice = ""
+		ffmpegParams.AudioFilters = ""
+	}
+
+	// Timestamps stay wallclock instead of starting at zero, so audio keeps
+	// its own first timestamp
+	if p.latencyTracing && ffmpegParams.OverlayText == "" {
+		ffmpegParams.CaptureTimestamps = true
+		if ffmpegParams.AudioFilters != "" {
+			ffmpegParams.AudioFilters = "aresample=async=1:min_hard_comp=0.100000"
+		}
+	}
 }
 
 // processStream processes a single stream and injects runtime data.
@@ -124,19 +156,7 @@ func (p *processor) processStreamWithEncoder(streamID string, encoderOverride st
 		return nil, fmt.Errorf("stream %s not found", streamID)
 	}
 
-	// Get runtime state (enabled status)
-	streamState, hasState := p.getStreamState(streamID)
-	enabled := false
-	if hasState {
-		enabled = streamState.Enabled
-	}
-
-	// Check if stream is in crashed state - force test pattern with CRASH overlay
-	var noSignalReason string
-	if p.isCrashed != nil && p.isCrashed(streamID) {
-		noSignalReason = "crashed"
-		enabled = false
-	}
+	enabled, devicePath, noSignalReason := p.resolveSource(streamID, &streamConfig)
 
 	// Priority order:
 	// 1. NO SIGNAL (device offline) - absolute precedence
@@ -156,20 +176,6 @@ func (p *processor) processStreamWithEncoder(streamID string, encoderOverride st
 	// Determine if we should use test source (either TestMode or device not enabled)
 	useTestSource := streamConfig.TestMode || !enabled
 
-	// Resolve device path (skip if using test source)
-	var devicePath string
-	if !useTestSource {
-		devicePath = p.deviceResolver(streamConfig.Device)
-		if devicePath == "" {
-			// Device not found - treat as offline
-			noSignalReason = "device_not_found"
-			enabled = false
-			useTestSource = true
-		}
-	} else if !enabled && noSignalReason == "" {
-		noSignalReason = "device_not_ready"
-	}
-
 	// Log the source mode decision
 	if useTestSource {
 		if streamConfig.TestMode && enabled {
@@ -227,11 +233,107 @@ func (p *processor) processStreamWithEncoder(streamID string, encoderOverride st
 	// Apply common stream settings to FFmpeg params
 	p.applyStreamSettingsToFFmpegParams(ffmpegParams, &streamConfig, streamID, devicePath, socketPath, enabled, noSignalReason)
 
+	// Extra outputs share the capture and get their own encoder
+	ffmpegParams.Outputs = p.outputParams(&streamConfig, useTestSource)
+
 	// Build FFmpeg command using the new Params struct
 	ffmpegCmd := ffmpeg.BuildCommand(ffmpegParams)
 
 	return &ProcessedStream{
-		StreamID:      streamID,
-		FFmpegCommand: ffmpegCmd,
+		StreamID:       streamID,
+		FFmpegCommand:  ffmpegCmd,
+		Params:         ffmpegParams,
+		NoSignalReason: noSignalReason,
 	}, nil
 }
+
+// resolveSource decides what a stream captures. A stream with a signal is
+// enabled, with its device path resolved unless it runs a custom command or
+// test mode. A stream without one gets the reason for its no-signal pattern:
+// "crashed", "device_not_ready" or "device_not_found".
+func (p *processor) resolveSource(streamID string, streamConfig *StreamSpec) (enabled bool, devicePath string, noSignalReason string) {
+	// Check if stream is in crashed state - force test pattern with CRASH overlay
+	if p.isCrashed != nil && p.isCrashed(streamID) {
+		return false, "", "crashed"
+	}
+
+	// Get runtime state (enabled status)
+	if streamState, hasState := p.getStreamState(streamID); !hasState || !streamState.Enabled {
+		return false, "", "device_not_ready"
+	}
+
+	// Custom commands and test mode don't capture from the device
+	if streamConfig.CustomFFmpegCommand != "" || streamConfig.TestMode {
+		return true, "", ""
+	}
+
+	devicePath = p.deviceResolver(streamConfig.Device)
+	if devicePath == "" {
+		// Device not found - treat as offline
+		return false, "", "device_not_found"
+	}
+	return true, devicePath, ""
+}
+
+// noSignalReason returns why a stream shows a no-signal pattern, or "" if it
+// has a signal. Unlike processStream it doesn't select encoders.
+func (p *processor) noSignalReason(streamID string) string {
+	streamConfig, exists := p.store.GetStream(streamID)
+	if !exists {
+		return ""
+	}
+	_, _, noSignalReason := p.resolveSource(streamID, &streamConfig)
+	return noSignalReason
+}
+
+// sourceDevice returns the device path a stream captures from, or "" if it
+// has no signal or doesn't capture from a device.
+func (p *processor) sourceDevice(streamID string) string {
+	streamConfig, exists := p.store.GetStream(streamID)
+	if !exists {
+		return ""
+	}
+	_, devicePath, _ := p.resolveSource(streamID, &streamConfig)
+	return devicePath
+}
+
+// outputParams selects an encoder for each extra output of a stream.
+func (p *processor) outputParams(streamConfig *StreamSpec, useTestSource bool) []ffmpeg.Output {
+	if len(streamConfig.Outputs) == 0 {
+		return nil
+	}
+
+	inputFormat := streamConfig.FFmpeg.InputFormat
+	if useTestSource {
+		inputFormat = "testsrc"
+	}
+
+	outputs := make([]ffmpeg.Output, 0, len(streamConfig.Outputs))
+	seen := map[string]bool{streamConfig.ID: true}
+	for _, output := range streamConfig.Outputs {
+		// Two producers on one stream ID would keep replacing each other
+		if _, isStream := p.store.GetStream(output.ID); output.ID == "" || seen[output.ID] || isStream {
+			p.logger.Warn("Skipping output with missing or duplicate stream ID",
+				"stream_id", streamConfig.ID,
+				"output_id", output.ID)
+			continue
+		}
+		seen[output.ID] = true
+
+		codec := output.Codec
+		if codec == "" {
+			codec = streamConfig.FFmpeg.Codec
+		}
+		params := p.encoderSelector(codec, inputFormat, output.QualityParams, "")
+		if params.Preset == "" && (params.Encoder == "libx264" || params.Encoder == "libx265") {
+			params.Preset = "fast"
+		}
+		params.OutputURL = fmt.Sprintf("rtsp://127.0.0.1:8554/%s", output.ID)
+
+		outputs = append(outputs, ffmpeg.Output{
+			Resolution: output.Resolution,
+			Params:     params,
+		})
+	}
+	return outputs
+}
@@ -11,6 +11,7 @@ import (
 // mockStore is a test implementation of Store.
 type mockStore struct {
 	streams map[string]StreamSpec
+	next    map[string]StreamSpec // What Reload finds in storage
 }
 
 func (m *mockStore) Load() error                       { return nil }
@@ -20,6 +21,17 @@ func (m *mockStore) UpdateStream(id string, stream StreamSpec) error {
 	m.streams[id] = stream
 	return nil
 }
+func (m *mockStore) Reload() (SpecDiff, error) {
+	diff := DiffSpecs(m.streams, m.next)
+	m.streams = m.next
+	return diff, nil
+}
+func (m *mockStore) SaveStreams(streams []StreamSpec) error {
+	for _, stream := range streams {
+		m.streams[stream.ID] = stream
+	}
+	return nil
+}
 func (m *mockStore) RemoveStream(id string) error                    { delete(m.streams, id); return nil }
 func (m *mockStore) GetStream(id string) (StreamSpec, bool)          { s, ok := m.streams[id]; return s, ok }
 func (m *mockStore) GetAllStreams() map[string]StreamSpec            { return m.streams }
@@ -225,6 +237,81 @@ func TestPrecedenceTestModeWhenOnlineNoCustomCommand(t *testing.T) {
 	}
 }
 
+func TestProcessorNativeAudioLeavesALSAOutOfCommand(t *testing.T) {
+	repo := &mockStore{streams: make(map[string]StreamSpec)}
+	stream := StreamSpec{
+		ID:     "test",
+		Device: "usb-test",
+		FFmpeg: FFmpegConfig{
+			Codec:       "h264",
+			InputFormat: "yuyv422",
+			AudioDevice: "hw:1,0",
+		},
+	}
+	if err := repo.AddStream(stream); err != nil {
+		t.Fatalf("AddStream failed: %v", err)
+	}
+
+	for _, native := range []bool{false, true} {
+		processor := newProcessor(repo)
+		processor.setNativeAudio(native)
+		processor.setDeviceResolver(func(_ string) string {
+			return "/dev/video0"
+		})
+		processor.setStreamStateGetter(func(streamID string) (*Stream, bool) {
+			return &Stream{ID: streamID, Enabled: true}, true
+		})
+
+		processed, err := processor.processStream("test")
+		if err != nil {
+			t.Fatalf("ProcessStream failed: %v", err)
+		}
+
+		hasALSA := strings.Contains(processed.FFmpegCommand, "-f alsa")
+		if hasALSA == native {
+			t.Errorf("native audio %v: command has ALSA input = %v: %s", native, hasALSA, processed.FFmpegCommand)
+		}
+		if native && (strings.Contains(processed.FFmpegCommand, "libopus") || strings.Contains(processed.FFmpegCommand, "aresample")) {
+			t.Errorf("native audio: command still encodes audio: %s", processed.FFmpegCommand)
+		}
+	}
+}
+
+func TestProcessorLatencyTracingCarriesCaptureTimes(t *testing.T) {
+	repo := &mockStore{streams: make(map[string]StreamSpec)}
+	stream := StreamSpec{
+		ID:     "test",
+		Device: "usb-test",
+		FFmpeg: FFmpegConfig{
+			Codec:       "h264",
+			AudioDevice: "hw:1,0",
+		},
+	}
+	if err := repo.AddStream(stream); err != nil {
+		t.Fatalf("AddStream failed: %v", err)
+	}
+
+	processor := newProcessor(repo)
+	processor.setLatencyTracing(true)
+	processor.setDeviceResolver(func(_ string) string {
+		return "/dev/video0"
+	})
+	processor.setStreamStateGetter(func(streamID string) (*Stream, bool) {
+		return &Stream{ID: streamID, Enabled: true}, true
+	})
+
+	processed, err := processor.processStream("test")
+	if err != nil {
+		t.Fatalf("ProcessStream failed: %v", err)
+	}
+	if !processed.Params.CaptureTimestamps || !strings.Contains(processed.FFmpegCommand, "-ts mono2abs") {
+		t.Errorf("device command should carry capture times: %s", processed.FFmpegCommand)
+	}
+	if strings.Contains(processed.FFmpegCommand, "first_pts=0") {
+		t.Errorf("audio should keep its wallclock timestamps: %s", processed.FFmpegCommand)
+	}
+}
+
 func TestPrecedenceTestModeIgnoredWhenCustomCommand(t *testing.T) {
 	repo := &mockStore{streams: make(map[string]StreamSpec)}
 	customCmd := "ffmpeg -f v4l2 -i /dev/video0 -c:v copy -f rtsp rtsp://localhost:8554/test"
@@ -259,3 +346,56 @@ func TestPrecedenceTestModeIgnoredWhenCustomCommand(t *testing.T) {
 		t.Errorf("Expected custom command to override test mode, got: %s", processed.FFmpegCommand)
 	}
 }
+
+func TestProcessorBuildsExtraOutputs(t *testing.T) {
+	repo := &mockStore{streams: make(map[string]StreamSpec)}
+	stream := StreamSpec{
+		ID:     "cam",
+		Device: "usb-test",
+		FFmpeg: FFmpegConfig{
+			Codec:       "h264",
+			InputFormat: "yuyv422",
+			Resolution:  "1920x1080",
+		},
+		Outputs: []OutputSpec{
+			{ID: "cam-sub", Resolution: "640x360"},
+			{ID: "cam"},   // collides with the main stream
+			{ID: "other"}, // collides with another stream
+		},
+	}
+	for _, spec := range []StreamSpec{stream, {ID: "other", Device: "usb-other"}} {
+		if err := repo.AddStream(spec); err != nil {
+			t.Fatalf("AddStream failed: %v", err)
+		}
+	}
+
+	processor := newProcessor(repo)
+	processor.setDeviceResolver(func(_ string) string {
+		return "/dev/video0"
+	})
+	processor.setStreamStateGetter(func(streamID string) (*Stream, bool) {
+		return &Stream{ID: streamID, Enabled: true}, true
+	})
+
+	processed, err := processor.processStream("cam")
+	if err != nil {
+		t.Fatalf("ProcessStream failed: %v", err)
+	}
+	cmd := processed.FFmpegCommand
+
+	// One capture, split to both outputs
+	if n := strings.Count(cmd, "-i /dev/video0"); n != 1 {
+		t.Errorf("Expected the device to be opened once, got %d in command: %s", n, cmd)
+	}
+	if !strings.Contains(cmd, "split=2") || !strings.Contains(cmd, "scale=640:360") {
+		t.Errorf("Expected split to a scaled sub-stream, got: %s", cmd)
+	}
+	for _, url := range []string{"rtsp://127.0.0.1:8554/cam", "rtsp://127.0.0.1:8554/cam-sub"} {
+		if !strings.Contains(cmd, "-f rtsp "+url) {
+			t.Errorf("Expected output %s, got: %s", url, cmd)
+		}
+	}
+	if strings.Contains(cmd, "rtsp://127.0.0.1:8554/other") {
+		t.Errorf("Output colliding with another stream should be skipped, got: %s", cmd)
+	}
+}
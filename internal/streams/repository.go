@@ -12,12 +12,19 @@ type Store interface {
 	// Save saves the configuration to storage
 	Save() error
 
+	// Reload reads the configuration from storage again, replacing the
+	// streams in memory, and returns how they changed
+	Reload() (SpecDiff, error)
+
 	// AddStream adds a new stream to the configuration
 	AddStream(stream StreamSpec) error
 
 	// UpdateStream updates an existing stream configuration
 	UpdateStream(id string, stream StreamSpec) error
 
+	// SaveStreams adds or replaces several streams with a single write
+	SaveStreams(streams []StreamSpec) error
+
 	// RemoveStream removes a stream from the configuration
 	RemoveStream(id string) error
 
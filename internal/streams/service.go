@@ -11,6 +11,7 @@ import (
 	"github.com/smazurov/videonode/internal/events"
 	"github.com/smazurov/videonode/internal/ffmpeg"
 	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/metrics"
 	"github.com/smazurov/videonode/internal/types"
 )
 
@@ -20,6 +21,19 @@ type ServiceOptions struct {
 	EncoderSelector encoders.Selector    // Custom encoder selector
 	EventBus        *events.Bus          // Event bus for broadcasting state changes
 	ProcessManager  StreamProcessManager // Process manager for FFmpeg subprocesses (optional, created if nil)
+	SlatePlayer     SlatePlayer          // Serves no-signal/crash slates (optional, FFmpeg renders them if nil)
+
+	// StartupConcurrency is how many streams may initialize FFmpeg at once
+	// (0 = unlimited)
+	StartupConcurrency int
+
+	// NativeAudio leaves audio devices out of FFmpeg commands, for audio
+	// captured by the streaming hub instead
+	NativeAudio bool
+
+	// LatencyTracing makes device commands carry V4L2 capture times, for the
+	// streaming hub's glass-to-glass latency tracing
+	LatencyTracing bool
 }
 
 // service implements the StreamService interface.
@@ -57,6 +71,8 @@ func NewStreamService(opts *ServiceOptions) StreamService {
 	encoderSelector := makeEncoderSelector(logger, opts, repo)
 	processor.setEncoderSelector(makeEncoderSelectorFunc(encoderSelector, logger))
 	processor.setDeviceResolver(makeDeviceResolver(logger))
+	processor.setNativeAudio(opts.NativeAudio)
+	processor.setLatencyTracing(opts.LatencyTracing)
 
 	// Create service
 	svc := &service{
@@ -78,9 +94,11 @@ func NewStreamService(opts *ServiceOptions) StreamService {
 		svc.processManager = opts.ProcessManager
 	} else {
 		svc.processManager = NewStreamProcessManager(&ProcessManagerOptions{
-			Store:     repo,
-			Processor: processor,
-			EventBus:  opts.EventBus,
+			Store:              repo,
+			Processor:          processor,
+			EventBus:           opts.EventBus,
+			SlatePlayer:        opts.SlatePlayer,
+			StartupConcurrency: opts.StartupConcurrency,
 		})
 	}
 
@@ -92,10 +110,51 @@ func NewStreamService(opts *ServiceOptions) StreamService {
 
 // CreateStream creates a new video stream.
 func (s *service) CreateStream(_ context.Context, params StreamCreateParams) (*Stream, error) {
+	streamConfigTOML, err := s.buildStreamSpec(params)
+	if err != nil {
+		return nil, err
+	}
+	streamID := streamConfigTOML.ID
+
+	// Initialize the stream with all integrations FIRST (so it's in memory)
+	if err := s.InitializeStream(streamConfigTOML); err != nil {
+		return nil, NewStreamError(ErrCodeMonitoringError,
+			"failed to initialize stream", err)
+	}
+
+	// Set initial enabled state to true since device was validated as available
+	s.streamsMutex.Lock()
+	if stream, found := s.streams[streamID]; found {
+		stream.Enabled = true
+	}
+	s.streamsMutex.Unlock()
+
+	// Save to persistent TOML config
+	if s.store != nil {
+		if err := s.store.AddStream(streamConfigTOML); err != nil {
+			s.logger.Warn("Failed to save stream to TOML config", "stream_id", streamID, "error", err)
+		} else {
+			s.logger.Info("Saved stream to persistent TOML config", "stream_id", streamID)
+
+			// Start FFmpeg process via process manager
+			if s.processManager != nil {
+				if err := s.processManager.Start(streamID); err != nil {
+					s.logger.Warn("Failed to start stream process", "stream_id", streamID, "error", err)
+				}
+			}
+		}
+	}
+
+	return s.createdStream(streamID)
+}
+
+// buildStreamSpec validates create parameters and builds the spec of the
+// new stream.
+func (s *service) buildStreamSpec(params StreamCreateParams) (StreamSpec, error) {
 	// Validate device ID using processor's device resolver
 	devicePath := s.processor.deviceResolver(params.DeviceID)
 	if devicePath == "" {
-		return nil, NewStreamError(ErrCodeDeviceNotFound,
+		return StreamSpec{}, NewStreamError(ErrCodeDeviceNotFound,
 			fmt.Sprintf("device %s not found or not available", params.DeviceID), nil)
 	}
 
@@ -105,7 +164,7 @@ func (s *service) CreateStream(_ context.Context, params StreamCreateParams) (*S
 	// Check if stream already exists
 	_, exists := s.getStreamSafe(streamID)
 	if exists {
-		return nil, NewStreamError(ErrCodeStreamExists,
+		return StreamSpec{}, NewStreamError(ErrCodeStreamExists,
 			fmt.Sprintf("stream %s already exists", streamID), nil)
 	}
 
@@ -115,7 +174,7 @@ func (s *service) CreateStream(_ context.Context, params StreamCreateParams) (*S
 
 	// Validate and build stream configuration
 	if err := validateCodec(params.Codec); err != nil {
-		return nil, NewStreamError(ErrCodeInvalidParams, err.Error(), nil)
+		return StreamSpec{}, NewStreamError(ErrCodeInvalidParams, err.Error(), nil)
 	}
 
 	qualityParams := buildQualityParams(params.Bitrate)
@@ -123,7 +182,7 @@ func (s *service) CreateStream(_ context.Context, params StreamCreateParams) (*S
 
 	// Create stream configuration with FFmpeg section
 	// Store only the generic codec, not the specific encoder
-	streamConfigTOML := StreamSpec{
+	return StreamSpec{
 		ID:     streamID,
 		Name:   streamID,
 		Device: params.DeviceID, // Store stable device ID
@@ -137,54 +196,32 @@ func (s *service) CreateStream(_ context.Context, params StreamCreateParams) (*S
 			AudioDevice:   params.AudioDevice, // Pass through audio device if specified
 		},
 		CreatedAt: time.Now(),
-	}
-
-	// Initialize the stream with all integrations FIRST (so it's in memory)
-	if err := s.InitializeStream(streamConfigTOML); err != nil {
-		return nil, NewStreamError(ErrCodeMonitoringError,
-			"failed to initialize stream", err)
-	}
-
-	// Set initial enabled state to true since device was validated as available
-	s.streamsMutex.Lock()
-	if stream, found := s.streams[streamID]; found {
-		stream.Enabled = true
-	}
-	s.streamsMutex.Unlock()
-
-	// Save to persistent TOML config
-	if s.store != nil {
-		if err := s.store.AddStream(streamConfigTOML); err != nil {
-			s.logger.Warn("Failed to save stream to TOML config", "stream_id", streamID, "error", err)
-		} else {
-			s.logger.Info("Saved stream to persistent TOML config", "stream_id", streamID)
-
-			// Start FFmpeg process via process manager
-			if s.processManager != nil {
-				if err := s.processManager.Start(streamID); err != nil {
-					s.logger.Warn("Failed to start stream process", "stream_id", streamID, "error", err)
-				}
-			}
-		}
-	}
+	}, nil
+}
 
+// createdStream announces a stream that was just created and returns a copy
+// of its runtime state.
+func (s *service) createdStream(streamID string) (*Stream, error) {
 	// Get the created stream from memory
 	stream, exists := s.getStreamSafe(streamID)
 	if !exists {
 		return nil, NewStreamError(ErrCodeStreamNotFound,
 			fmt.Sprintf("stream %s was created but not found in memory", streamID), nil)
 	}
+	return s.announceStream(stream), nil
+}
 
-	// Emit stream state changed event
+// announceStream emits the enabled state of a created stream and returns a
+// copy of its runtime state.
+func (s *service) announceStream(stream *Stream) *Stream {
 	if s.eventBus != nil {
 		s.eventBus.Publish(events.StreamStateChangedEvent{
-			StreamID:  streamID,
+			StreamID:  stream.ID,
 			Enabled:   true,
 			Timestamp: time.Now().Format(time.RFC3339),
 		})
 	}
-
-	return copyStream(stream), nil
+	return copyStream(stream)
 }
 
 // UpdateStream updates an existing stream with new parameters.
@@ -202,10 +239,57 @@ func (s *service) UpdateStream(_ context.Context, streamID string, params Stream
 			fmt.Sprintf("stream %s not found in memory", streamID), nil)
 	}
 
+	applyUpdateParams(&streamConfig, params)
+
+	// Save config to store
+	if err := s.store.UpdateStream(streamID, streamConfig); err != nil {
+		return nil, fmt.Errorf("failed to save updated stream: %w", err)
+	}
+
+	return s.updatedStream(streamID, stream, params), nil
+}
+
+// updatedStream applies a saved update to a stream's runtime state and
+// process, and returns a copy of the runtime state.
+func (s *service) updatedStream(streamID string, stream *Stream, params StreamUpdateParams) *Stream {
 	// Track if enabled state changed for event emission
 	oldEnabled := stream.Enabled
 	enabledChanged := false
 
+	// Update runtime state in-memory
+	s.streamsMutex.Lock()
+	stream.StartTime = time.Now() // Reset StartTime (stream is effectively restarted)
+	if params.Enabled != nil {
+		stream.Enabled = *params.Enabled
+		if oldEnabled != *params.Enabled {
+			enabledChanged = true
+		}
+	}
+	s.streamsMutex.Unlock()
+
+	// Restart FFmpeg process with new config via process manager
+	if s.processManager != nil {
+		if err := s.processManager.Restart(streamID); err != nil {
+			s.logger.Warn("Failed to restart stream process", "stream_id", streamID, "error", err)
+		}
+	}
+
+	// Emit stream state changed event if enabled state was modified
+	if enabledChanged && s.eventBus != nil {
+		s.eventBus.Publish(events.StreamStateChangedEvent{
+			StreamID:  streamID,
+			Enabled:   stream.Enabled,
+			Timestamp: time.Now().Format(time.RFC3339),
+		})
+	}
+
+	s.logger.Info("Stream updated successfully", "stream_id", streamID)
+
+	return copyStream(stream)
+}
+
+// applyUpdateParams sets the provided update parameters on a stream spec.
+func applyUpdateParams(streamConfig *StreamSpec, params StreamUpdateParams) {
 	// Update stream configuration with provided parameters
 	if params.Codec != nil {
 		streamConfig.FFmpeg.Codec = *params.Codec
@@ -230,12 +314,20 @@ func (s *service) UpdateStream(_ context.Context, streamID string, params Stream
 		}
 		streamConfig.FFmpeg.Options = ffmpegOptions
 	}
-	if params.Bitrate != nil {
-		// Update quality params
-		if streamConfig.FFmpeg.QualityParams == nil {
-			streamConfig.FFmpeg.QualityParams = &types.QualityParams{}
+	if params.Bitrate != nil || params.KeyframeInterval != nil {
+		// Update a copy of the quality params, the stored ones are shared
+		// with the spec until it's saved
+		var quality types.QualityParams
+		if streamConfig.FFmpeg.QualityParams != nil {
+			quality = *streamConfig.FFmpeg.QualityParams
+		}
+		if params.Bitrate != nil {
+			quality.TargetBitrate = params.Bitrate
 		}
-		streamConfig.FFmpeg.QualityParams.TargetBitrate = params.Bitrate
+		if params.KeyframeInterval != nil {
+			quality.KeyframeInterval = params.KeyframeInterval
+		}
+		streamConfig.FFmpeg.QualityParams = &quality
 	}
 	if params.CustomFFmpegCommand != nil {
 		streamConfig.CustomFFmpegCommand = *params.CustomFFmpegCommand
@@ -246,42 +338,93 @@ func (s *service) UpdateStream(_ context.Context, streamID string, params Stream
 
 	// Update timestamp
 	streamConfig.UpdatedAt = time.Now()
+}
 
-	// Save config to store
-	if err := s.store.UpdateStream(streamID, streamConfig); err != nil {
-		return nil, fmt.Errorf("failed to save updated stream: %w", err)
+// ApplyBatch creates and updates several streams with a single write to
+// streams.toml. All parameters are validated and the created streams
+// initialized before the write: if any step fails, the initialized streams
+// are released and no stream is changed. Nothing can fail after the write,
+// so created streams are then started and updates applied as by
+// UpdateStream. The returned streams are the created ones followed by the
+// updated ones, in request order.
+func (s *service) ApplyBatch(_ context.Context, params StreamBatchParams) ([]Stream, error) {
+	specs := make([]StreamSpec, 0, len(params.Create)+len(params.Update))
+	batched := make(map[string]bool, cap(specs))
+	for _, create := range params.Create {
+		spec, err := s.buildStreamSpec(create)
+		if err != nil {
+			return nil, err
+		}
+		specs = append(specs, spec)
 	}
 
-	// Update runtime state in-memory
-	s.streamsMutex.Lock()
-	stream.StartTime = time.Now() // Reset StartTime (stream is effectively restarted)
-	if params.Enabled != nil {
-		stream.Enabled = *params.Enabled
-		if oldEnabled != *params.Enabled {
-			enabledChanged = true
+	running := make([]*Stream, len(params.Update))
+	for i, update := range params.Update {
+		streamConfig, exists := s.store.GetStream(update.StreamID)
+		stream, streamExists := s.getStreamSafe(update.StreamID)
+		if !exists || !streamExists {
+			return nil, NewStreamError(ErrCodeStreamNotFound,
+				fmt.Sprintf("stream %s not found", update.StreamID), nil)
 		}
+		applyUpdateParams(&streamConfig, update.Params)
+		specs = append(specs, streamConfig)
+		running[i] = stream
 	}
-	s.streamsMutex.Unlock()
 
-	// Restart FFmpeg process with new config via process manager
-	if s.processManager != nil {
-		if err := s.processManager.Restart(streamID); err != nil {
-			s.logger.Warn("Failed to restart stream process", "stream_id", streamID, "error", err)
+	for _, spec := range specs {
+		if batched[spec.ID] {
+			return nil, NewStreamError(ErrCodeInvalidParams,
+				fmt.Sprintf("stream %s appears more than once in the batch", spec.ID), nil)
 		}
+		batched[spec.ID] = true
 	}
 
-	// Emit stream state changed event if enabled state was modified
-	if enabledChanged && s.eventBus != nil {
-		s.eventBus.Publish(events.StreamStateChangedEvent{
-			StreamID:  streamID,
-			Enabled:   stream.Enabled,
-			Timestamp: time.Now().Format(time.RFC3339),
-		})
+	created := make([]*Stream, 0, len(params.Create))
+	release := func() {
+		for _, stream := range created {
+			s.releaseStream(stream.ID)
+		}
+	}
+	for _, spec := range specs[:len(params.Create)] {
+		if err := s.InitializeStream(spec); err != nil {
+			release()
+			return nil, NewStreamError(ErrCodeMonitoringError,
+				fmt.Sprintf("failed to initialize stream %s", spec.ID), err)
+		}
+		stream, exists := s.getStreamSafe(spec.ID)
+		if !exists {
+			release()
+			return nil, NewStreamError(ErrCodeStreamNotFound,
+				fmt.Sprintf("stream %s was created but not found in memory", spec.ID), nil)
+		}
+		created = append(created, stream)
 	}
 
-	s.logger.Info("Stream updated successfully", "stream_id", streamID)
+	if err := s.store.SaveStreams(specs); err != nil {
+		release()
+		return nil, NewStreamError(ErrCodeConfigError, "failed to save streams", err)
+	}
 
-	return copyStream(stream), nil
+	result := make([]Stream, 0, len(specs))
+	for _, stream := range created {
+		// Enabled since the device was validated as available
+		s.streamsMutex.Lock()
+		stream.Enabled = true
+		s.streamsMutex.Unlock()
+
+		if s.processManager != nil {
+			if err := s.processManager.Start(stream.ID); err != nil {
+				s.logger.Warn("Failed to start stream process", "stream_id", stream.ID, "error", err)
+			}
+		}
+		result = append(result, *s.announceStream(stream))
+	}
+	for i, update := range params.Update {
+		result = append(result, *s.updatedStream(update.StreamID, running[i], update.Params))
+	}
+
+	s.logger.Info("Stream batch applied", "created", len(params.Create), "updated", len(params.Update))
+	return result, nil
 }
 
 // DeleteStream removes a stream.
@@ -306,6 +449,14 @@ func (s *service) DeleteStream(_ context.Context, streamID string) error {
 			"failed to delete stream from configuration", err)
 	}
 
+	s.releaseStream(streamID)
+
+	s.logger.Info("Stream deleted successfully", "stream_id", streamID)
+	return nil
+}
+
+// releaseStream drops the runtime state of a stream whose process is stopped.
+func (s *service) releaseStream(streamID string) {
 	// Get stream reference before removing from memory
 	stream, _ := s.getStreamSafe(streamID)
 
@@ -321,8 +472,7 @@ func (s *service) DeleteStream(_ context.Context, streamID string) error {
 		}
 	}
 
-	s.logger.Info("Stream deleted successfully", "stream_id", streamID)
-	return nil
+	metrics.DeleteStreamStartup(streamID)
 }
 
 // RestartStream restarts a stream's FFmpeg process and updates StartTime.
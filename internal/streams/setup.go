@@ -5,11 +5,13 @@ import (
 	"fmt"
 	"time"
 
+	"github.com/smazurov/videonode/internal/events"
 	"github.com/smazurov/videonode/internal/metrics/collectors"
 )
 
 // LoadStreamsFromConfig loads existing streams from TOML config into memory.
-// Called only at startup - runtime management is via CRUD APIs.
+// Called only at startup - runtime management is via CRUD APIs, and edits
+// of the file are applied by ReloadStreams.
 func (s *service) LoadStreamsFromConfig() error {
 	if s.store == nil {
 		return fmt.Errorf("repository not initialized")
@@ -43,6 +45,73 @@ func (s *service) LoadStreamsFromConfig() error {
 	return nil
 }
 
+// ReloadStreams re-reads streams.toml after it changed on disk and applies
+// the difference: removed streams are stopped, added ones started, and of
+// the changed ones only those with FFmpeg changes are restarted. Settings
+// read on demand (GOP cache, recording) need nothing here. Streams whose
+// spec didn't change, including after the service's own writes, are left
+// alone. The diff is returned for the hub-side consumers of stream settings.
+func (s *service) ReloadStreams() (SpecDiff, error) {
+	diff, err := s.store.Reload()
+	if err != nil {
+		return SpecDiff{}, fmt.Errorf("failed to reload streams configuration: %w", err)
+	}
+	if diff.Empty() {
+		s.logger.Debug("Streams configuration reloaded, no changes")
+		return diff, nil
+	}
+
+	for _, streamID := range diff.Removed {
+		if s.processManager != nil {
+			if err := s.processManager.Stop(streamID); err != nil {
+				s.logger.Warn("Failed to stop stream process", "stream_id", streamID, "error", err)
+			}
+		}
+		s.releaseStream(streamID)
+		if s.eventBus != nil {
+			s.eventBus.Publish(events.StreamDeletedEvent{
+				StreamID:  streamID,
+				Action:    "deleted",
+				Timestamp: time.Now().Format(time.RFC3339),
+			})
+		}
+	}
+
+	for _, streamID := range diff.Added {
+		streamConfig, _ := s.store.GetStream(streamID)
+		if err := s.InitializeStream(streamConfig); err != nil {
+			s.logger.Warn("Failed to initialize stream", "stream_id", streamID, "error", err)
+			continue
+		}
+		if s.processManager != nil {
+			if err := s.processManager.Start(streamID); err != nil {
+				s.logger.Warn("Failed to start stream process", "stream_id", streamID, "error", err)
+			}
+		}
+	}
+
+	for _, streamID := range diff.ChangedIDs() {
+		if s.processManager == nil {
+			break
+		}
+		switch change := diff.Changed[streamID]; {
+		case change.Has(SpecChangeRestart):
+			s.streamsMutex.Lock()
+			if stream, ok := s.streams[streamID]; ok {
+				stream.StartTime = time.Now()
+			}
+			s.streamsMutex.Unlock()
+			if err := s.processManager.Restart(streamID); err != nil {
+				s.logger.Warn("Failed to restart stream process", "stream_id", streamID, "error", err)
+			}
+		}
+	}
+
+	s.logger.Info("Streams configuration reloaded",
+		"added", len(diff.Added), "removed", len(diff.Removed), "changed", len(diff.Changed))
+	return diff, nil
+}
+
 // InitializeStream initializes a single stream with all integrations.
 func (s *service) InitializeStream(streamConfig StreamSpec) error {
 	socketPath := getSocketPath(streamConfig.ID)
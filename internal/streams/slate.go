@@ -0,0 +1,141 @@
+package streams
+
+import (
+	"bytes"
+	"context"
+	"fmt"
+	"math"
+	"os/exec"
+	"path"
+	"strconv"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/smazurov/videonode/internal/ffmpeg"
+)
+
+// slateEncodeTimeout bounds the one-off FFmpeg run that pre-encodes a slate.
+const slateEncodeTimeout = 30 * time.Second
+
+// SlatePlayer plays pre-encoded slates in place of a stream's FFmpeg
+// producer, so streams without a signal don't keep an encoder busy rendering
+// a static image. *streaming.Hub implements it.
+type SlatePlayer interface {
+	// PlaySlate loops an Annex B clip ("h264" or "h265") as the stream until
+	// its FFmpeg producer connects again or StopSlate is called
+	PlaySlate(streamID, codec string, data []byte, fps int) error
+
+	// StopSlate stops the stream's slate, if it plays one
+	StopSlate(streamID string)
+}
+
+// slateClip is a pre-encoded slate.
+type slateClip struct {
+	codec string
+	data  []byte
+	fps   int
+}
+
+// slateEncoder pre-encodes slates with FFmpeg and caches them by command,
+// so each slate is encoded once per text, resolution and encoder settings.
+type slateEncoder struct {
+	mu    sync.Mutex // held while encoding, so a slate is never encoded twice
+	clips map[string]*slateClip
+	run   func(ctx context.Context, command string) ([]byte, error)
+}
+
+func newSlateEncoder() *slateEncoder {
+	return &slateEncoder{
+		clips: make(map[string]*slateClip),
+		run:   runSlateCommand,
+	}
+}
+
+// encode returns the slate for params, encoding it on first use.
+func (e *slateEncoder) encode(params *ffmpeg.Params) (*slateClip, error) {
+	codec := ffmpeg.SlateCodec(params.Encoder)
+	if codec == "" {
+		return nil, fmt.Errorf("encoder %s can't pre-encode slates", params.Encoder)
+	}
+	command := ffmpeg.BuildSlateCommand(params)
+
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if clip, ok := e.clips[command]; ok {
+		return clip, nil
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), slateEncodeTimeout)
+	defer cancel()
+
+	data, err := e.run(ctx, command)
+	if err != nil {
+		return nil, err
+	}
+
+	clip := &slateClip{codec: codec, data: data, fps: slateFPS(params.FPS)}
+	e.clips[command] = clip
+	return clip, nil
+}
+
+// runSlateCommand runs an FFmpeg slate command and returns its output.
+func runSlateCommand(ctx context.Context, command string) ([]byte, error) {
+	var stdout, stderr bytes.Buffer
+	cmd := exec.CommandContext(ctx, "sh", "-c", command)
+	cmd.Stdout = &stdout
+	cmd.Stderr = &stderr
+
+	if err := cmd.Run(); err != nil {
+		return nil, fmt.Errorf("failed to encode slate: %w: %s", err, lastLine(stderr.String()))
+	}
+	if stdout.Len() == 0 {
+		return nil, fmt.Errorf("failed to encode slate: no output")
+	}
+	return stdout.Bytes(), nil
+}
+
+// lastLine returns the last non-empty line of FFmpeg's log output.
+func lastLine(output string) string {
+	output = strings.TrimSpace(output)
+	if i := strings.LastIndexByte(output, '\n'); i >= 0 {
+		return output[i+1:]
+	}
+	return output
+}
+
+// slateFPS parses a stream's frame rate, defaulting to the slate builder's 30.
+func slateFPS(fps string) int {
+	if rate, err := strconv.ParseFloat(fps, 64); err == nil && rate >= 1 {
+		return int(math.Round(rate))
+	}
+	return 30
+}
+
+// slateTarget is a stream ID and the params of the slate it shows.
+type slateTarget struct {
+	streamID string
+	params   *ffmpeg.Params
+}
+
+// slateTargets returns the slates of a stream's no-signal command: the
+// stream itself and each extra output, at the output's resolution with its
+// own encoder.
+func slateTargets(streamID string, params *ffmpeg.Params) []slateTarget {
+	targets := []slateTarget{{streamID: streamID, params: params}}
+	for _, output := range params.Outputs {
+		outputParams := *output.Params
+		outputParams.Resolution = params.Resolution
+		if output.Resolution != "" {
+			outputParams.Resolution = output.Resolution
+		}
+		outputParams.FPS = params.FPS
+		outputParams.OverlayText = params.OverlayText
+		targets = append(targets, slateTarget{
+			streamID: path.Base(output.Params.OutputURL),
+			params:   &outputParams,
+		})
+	}
+	return targets
+}
@@ -0,0 +1,90 @@
+package streams
+
+import (
+	"context"
+	"testing"
+
+	"github.com/smazurov/videonode/internal/ffmpeg"
+)
+
+func TestSlateEncoderCachesClips(t *testing.T) {
+	var runs int
+	encoder := newSlateEncoder()
+	encoder.run = func(context.Context, string) ([]byte, error) {
+		runs++
+		return []byte{0, 0, 0, 1, 0x65}, nil
+	}
+
+	params := &ffmpeg.Params{Encoder: "libx264", Resolution: "1280x720", FPS: "25", OverlayText: "NO SIGNAL"}
+	for range 2 {
+		clip, err := encoder.encode(params)
+		if err != nil {
+			t.Fatalf("encode() error = %v", err)
+		}
+		if clip.codec != "h264" || clip.fps != 25 {
+			t.Errorf("clip = %s at %d fps, want h264 at 25 fps", clip.codec, clip.fps)
+		}
+	}
+	if runs != 1 {
+		t.Errorf("slate encoded %d times, want once", runs)
+	}
+
+	crashed := *params
+	crashed.OverlayText = "CRASHED"
+	if _, err := encoder.encode(&crashed); err != nil {
+		t.Fatalf("encode() error = %v", err)
+	}
+	if runs != 2 {
+		t.Errorf("different slate text reused a cached clip")
+	}
+
+	if _, err := encoder.encode(&ffmpeg.Params{Encoder: "mjpeg"}); err == nil {
+		t.Error("encode() with an encoder that doesn't produce H264/H265 should fail")
+	}
+}
+
+func TestSlateTargets(t *testing.T) {
+	params := &ffmpeg.Params{
+		Encoder:     "h264_vaapi",
+		Resolution:  "1920x1080",
+		FPS:         "30",
+		OverlayText: "NO SIGNAL",
+		Outputs: []ffmpeg.Output{
+			{Resolution: "640x360", Params: &ffmpeg.Params{Encoder: "h264_vaapi", OutputURL: "rtsp://localhost:8554/cam_sub"}},
+			{Params: &ffmpeg.Params{Encoder: "libx265", OutputURL: "rtsp://localhost:8554/cam_hevc"}},
+		},
+	}
+
+	targets := slateTargets("cam", params)
+	want := []struct {
+		streamID   string
+		encoder    string
+		resolution string
+	}{
+		{"cam", "h264_vaapi", "1920x1080"},
+		{"cam_sub", "h264_vaapi", "640x360"},
+		{"cam_hevc", "libx265", "1920x1080"},
+	}
+	if len(targets) != len(want) {
+		t.Fatalf("got %d targets, want %d", len(targets), len(want))
+	}
+	for i, w := range want {
+		got := targets[i]
+		if got.streamID != w.streamID || got.params.Encoder != w.encoder || got.params.Resolution != w.resolution {
+			t.Errorf("target %d = %s %s %s, want %s %s %s", i,
+				got.streamID, got.params.Encoder, got.params.Resolution, w.streamID, w.encoder, w.resolution)
+		}
+		if got.params.FPS != "30" || got.params.OverlayText != "NO SIGNAL" {
+			t.Errorf("target %d = %s fps %q, want the main stream's", i, got.params.FPS, got.params.OverlayText)
+		}
+	}
+}
+
+func TestSlateFPS(t *testing.T) {
+	tests := map[string]int{"30": 30, "29.97": 30, "15": 15, "": 30, "abc": 30, "0": 30}
+	for fps, want := range tests {
+		if got := slateFPS(fps); got != want {
+			t.Errorf("slateFPS(%q) = %d, want %d", fps, got, want)
+		}
+	}
+}
@@ -31,6 +31,26 @@ type StreamSpec struct {
 	// FFmpeg contains all FFmpeg-specific configuration for this stream
 	FFmpeg FFmpegConfig `toml:"ffmpeg" json:"ffmpeg"`
 
+	// Outputs are extra encoded outputs (rungs) of this stream, such as a
+	// low-bitrate sub-stream. They are encoded by the stream's FFmpeg process
+	// from the same capture and published under their own stream IDs.
+	Outputs []OutputSpec `toml:"outputs,omitempty" json:"outputs,omitempty"`
+
+	// GOPCache enables replaying the most recent keyframe group to late-joining
+	// WebRTC viewers for instant first frame, and to viewers that report loss
+	// with PLI/FIR. Nil disables the cache; such viewers then wait for the
+	// stream's next keyframe.
+	GOPCache *GOPCacheConfig `toml:"gop_cache,omitempty" json:"gop_cache,omitempty"`
+
+	// Recording writes the stream to disk as fragmented MP4 segments,
+	// remuxed from the streaming hub without transcoding. Nil disables it.
+	Recording *RecordingConfig `toml:"recording,omitempty" json:"recording,omitempty"`
+
+	// StartupPriority orders stream startup when more streams are launched
+	// than the startup concurrency allows: higher priorities start first.
+	// Streams of equal priority start in the order they were launched.
+	StartupPriority int `toml:"startup_priority,omitempty" json:"startup_priority,omitempty"`
+
 	// CustomFFmpegCommand is an optional override for the entire FFmpeg command
 	// When set, this completely bypasses automatic command generation
 	CustomFFmpegCommand string `toml:"custom_ffmpeg_command,omitempty" json:"custom_ffmpeg_command,omitempty"`
@@ -67,3 +87,46 @@ type FFmpegConfig struct {
 	// QualityParams stores the quality/rate control settings
 	QualityParams *types.QualityParams `toml:"quality_params,omitempty" json:"quality_params,omitempty"`
 }
+
+// OutputSpec is an extra encoded output of a stream.
+type OutputSpec struct {
+	// ID is the stream ID the output is published as (RTSP path)
+	// It must not collide with another stream or output
+	ID string `toml:"id" json:"id"`
+
+	// Resolution scales the output to WIDTHxHEIGHT
+	// If not specified, the capture resolution is kept
+	Resolution string `toml:"resolution,omitempty" json:"resolution,omitempty"`
+
+	// Codec specifies the codec standard ("h264", "h265")
+	// If not specified, the stream's codec is used
+	Codec string `toml:"codec,omitempty" json:"codec,omitempty"`
+
+	// QualityParams stores the quality/rate control settings for this output
+	QualityParams *types.QualityParams `toml:"quality_params,omitempty" json:"quality_params,omitempty"`
+}
+
+// RecordingConfig sets the segment length and retention of a stream's
+// recordings. Zero values fall back to the streaming defaults.
+type RecordingConfig struct {
+	// SegmentSeconds is the length of each segment file; segments end on
+	// the first keyframe past it
+	SegmentSeconds int `toml:"segment_seconds,omitempty" json:"segment_seconds,omitempty"`
+
+	// RetentionHours deletes segments older than this (0 = no age limit)
+	RetentionHours float64 `toml:"retention_hours,omitempty" json:"retention_hours,omitempty"`
+
+	// MaxBytes deletes the oldest segments while the stream's recordings
+	// exceed it (0 = no size limit)
+	MaxBytes int64 `toml:"max_bytes,omitempty" json:"max_bytes,omitempty"`
+}
+
+// GOPCacheConfig bounds the per-stream GOP cache kept by the streaming hub.
+// Zero values fall back to the hub defaults.
+type GOPCacheConfig struct {
+	// MaxPackets caps the number of RTP packets cached for one GOP
+	MaxPackets int `toml:"max_packets,omitempty" json:"max_packets,omitempty"`
+
+	// MaxBytes caps the payload bytes cached for one GOP
+	MaxBytes int `toml:"max_bytes,omitempty" json:"max_bytes,omitempty"`
+}
@@ -0,0 +1,125 @@
+package streams
+
+import (
+	"reflect"
+	"sort"
+	"time"
+
+	"github.com/smazurov/videonode/internal/types"
+)
+
+// SpecChange is the set of ways a stream's spec changed between two
+// versions of streams.toml. Each flag maps to how the change is applied.
+type SpecChange uint8
+
+const (
+	// SpecChangeRuntime covers settings read on demand while the stream runs
+	// (name, startup priority, GOP cache). Nothing is restarted.
+	SpecChangeRuntime SpecChange = 1 << iota
+
+	// SpecChangeRecording covers the [recording] settings. The stream's
+	// recorder is restarted, its FFmpeg process isn't.
+	SpecChangeRecording
+
+	// SpecChangeRestart covers everything else (device, format, codec,
+	// resolution, outputs, ...), applied with a restart.
+	SpecChangeRestart
+)
+
+// Has reports whether c includes all of flags.
+func (c SpecChange) Has(flags SpecChange) bool {
+	return c&flags == flags
+}
+
+// SpecDiff is the per-stream difference between two sets of stream specs.
+// Streams that are absent from all three are unchanged.
+type SpecDiff struct {
+	Added   []string              // Stream IDs only in the new set, sorted
+	Removed []string              // Stream IDs only in the old set, sorted
+	Changed map[string]SpecChange // Streams in both sets whose spec changed
+}
+
+// Empty reports whether the two sets of specs were equivalent.
+func (d SpecDiff) Empty() bool {
+	return len(d.Added) == 0 && len(d.Removed) == 0 && len(d.Changed) == 0
+}
+
+// ChangedIDs returns the IDs of changed streams, sorted.
+func (d SpecDiff) ChangedIDs() []string {
+	ids := make([]string, 0, len(d.Changed))
+	for id := range d.Changed {
+		ids = append(ids, id)
+	}
+	sort.Strings(ids)
+	return ids
+}
+
+// DiffSpecs compares two sets of stream specs keyed by stream ID.
+func DiffSpecs(old, updated map[string]StreamSpec) SpecDiff {
+	diff := SpecDiff{Changed: make(map[string]SpecChange)}
+	for id, oldSpec := range old {
+		newSpec, exists := updated[id]
+		if !exists {
+			diff.Removed = append(diff.Removed, id)
+			continue
+		}
+		if change := DiffSpec(oldSpec, newSpec); change != 0 {
+			diff.Changed[id] = change
+		}
+	}
+	for id := range updated {
+		if _, exists := old[id]; !exists {
+			diff.Added = append(diff.Added, id)
+		}
+	}
+	sort.Strings(diff.Added)
+	sort.Strings(diff.Removed)
+	return diff
+}
+
+// DiffSpec classifies how a stream's spec changed. Timestamps are ignored,
+// as are differences TOML doesn't preserve (nil vs empty lists and quality
+// params). Returns 0 if the specs are equivalent.
+func DiffSpec(old, updated StreamSpec) SpecChange {
+	old, updated = normalizeSpec(old), normalizeSpec(updated)
+
+	var change SpecChange
+	if old.Name != updated.Name || old.StartupPriority != updated.StartupPriority ||
+		!reflect.DeepEqual(old.GOPCache, updated.GOPCache) {
+		change |= SpecChangeRuntime
+	}
+	if !reflect.DeepEqual(old.Recording, updated.Recording) {
+		change |= SpecChangeRecording
+	}
+
+	// What's left once the fields above are cleared needs a restart
+	for _, spec := range []*StreamSpec{&old, &updated} {
+		spec.Name, spec.StartupPriority = "", 0
+		spec.GOPCache, spec.Recording = nil, nil
+	}
+	if !reflect.DeepEqual(old, updated) {
+		change |= SpecChangeRestart
+	}
+	return change
+}
+
+// normalizeSpec returns a copy of spec with its own quality params, with
+// timestamps cleared and empty values in the form a TOML round trip leaves
+// them.
+func normalizeSpec(spec StreamSpec) StreamSpec {
+	spec.CreatedAt, spec.UpdatedAt = time.Time{}, time.Time{}
+	if len(spec.FFmpeg.Options) == 0 {
+		spec.FFmpeg.Options = nil
+	}
+	if len(spec.Outputs) == 0 {
+		spec.Outputs = nil
+	}
+	if spec.FFmpeg.QualityParams != nil {
+		quality := *spec.FFmpeg.QualityParams
+		spec.FFmpeg.QualityParams = &quality
+		if quality == (types.QualityParams{}) {
+			spec.FFmpeg.QualityParams = nil
+		}
+	}
+	return spec
+}
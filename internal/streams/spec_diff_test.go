@@ -0,0 +1,206 @@
+package streams
+
+import (
+	"context"
+	"errors"
+	"slices"
+	"testing"
+	"time"
+
+	"github.com/smazurov/videonode/internal/ffmpeg"
+	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/types"
+)
+
+func TestDiffSpec(t *testing.T) {
+	bitrate, lower := 4.0, 2.0
+	gop := 60
+	preset := "fast"
+	base := StreamSpec{
+		ID:     "cam",
+		Name:   "Camera",
+		Device: "usb-1",
+		FFmpeg: FFmpegConfig{
+			Codec:         "h264",
+			Resolution:    "1920x1080",
+			Options:       []ffmpeg.OptionType{},
+			QualityParams: &types.QualityParams{Mode: types.RateControlCBR, TargetBitrate: &bitrate},
+		},
+		CreatedAt: time.Now(),
+	}
+
+	tests := []struct {
+		name   string
+		modify func(spec *StreamSpec)
+		want   SpecChange
+	}{
+		{"unchanged", func(*StreamSpec) {}, 0},
+		{"timestamps", func(spec *StreamSpec) { spec.CreatedAt, spec.UpdatedAt = time.Time{}, time.Now() }, 0},
+		{"nil options", func(spec *StreamSpec) { spec.FFmpeg.Options = nil }, 0},
+		{"name", func(spec *StreamSpec) { spec.Name = "Front door" }, SpecChangeRuntime},
+		{"gop cache", func(spec *StreamSpec) { spec.GOPCache = &GOPCacheConfig{MaxPackets: 100} }, SpecChangeRuntime},
+		{"recording", func(spec *StreamSpec) { spec.Recording = &RecordingConfig{SegmentSeconds: 60} }, SpecChangeRecording},
+		{"bitrate", func(spec *StreamSpec) { spec.FFmpeg.QualityParams.TargetBitrate = &lower }, SpecChangeRestart},
+		{"keyframe interval", func(spec *StreamSpec) { spec.FFmpeg.QualityParams.KeyframeInterval = &gop }, SpecChangeRestart},
+		{"preset", func(spec *StreamSpec) { spec.FFmpeg.QualityParams.Preset = &preset }, SpecChangeRestart},
+		{"resolution", func(spec *StreamSpec) { spec.FFmpeg.Resolution = "1280x720" }, SpecChangeRestart},
+		{"device", func(spec *StreamSpec) { spec.Device = "usb-2" }, SpecChangeRestart},
+		{"outputs", func(spec *StreamSpec) { spec.Outputs = []OutputSpec{{ID: "cam-sub"}} }, SpecChangeRestart},
+		{
+			"bitrate and resolution",
+			func(spec *StreamSpec) {
+				spec.FFmpeg.QualityParams.TargetBitrate = &lower
+				spec.FFmpeg.Resolution = "1280x720"
+			},
+			SpecChangeRestart,
+		},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			updated := base
+			quality := *base.FFmpeg.QualityParams
+			updated.FFmpeg.QualityParams = &quality
+			tt.modify(&updated)
+
+			if got := DiffSpec(base, updated); got != tt.want {
+				t.Errorf("DiffSpec() = %04b, want %04b", got, tt.want)
+			}
+		})
+	}
+
+	if base.FFmpeg.QualityParams.TargetBitrate != &bitrate || base.CreatedAt.IsZero() {
+		t.Error("DiffSpec modified its input")
+	}
+}
+
+func TestDiffSpecs(t *testing.T) {
+	old := map[string]StreamSpec{
+		"kept":    {ID: "kept", Device: "usb-1"},
+		"renamed": {ID: "renamed", Device: "usb-2"},
+		"gone":    {ID: "gone", Device: "usb-3"},
+	}
+	updated := map[string]StreamSpec{
+		"kept":    {ID: "kept", Device: "usb-1"},
+		"renamed": {ID: "renamed", Name: "Renamed", Device: "usb-2"},
+		"new-b":   {ID: "new-b", Device: "usb-4"},
+		"new-a":   {ID: "new-a", Device: "usb-5"},
+	}
+
+	diff := DiffSpecs(old, updated)
+	if !slices.Equal(diff.Added, []string{"new-a", "new-b"}) {
+		t.Errorf("Added = %v, want [new-a new-b]", diff.Added)
+	}
+	if !slices.Equal(diff.Removed, []string{"gone"}) {
+		t.Errorf("Removed = %v, want [gone]", diff.Removed)
+	}
+	if len(diff.Changed) != 1 || diff.Changed["renamed"] != SpecChangeRuntime {
+		t.Errorf("Changed = %v, want only renamed as a runtime change", diff.Changed)
+	}
+	if diff.Empty() || !DiffSpecs(old, old).Empty() {
+		t.Error("Empty() doesn't match the diffs")
+	}
+}
+
+// recordingProcessManager records the process operations of a service.
+type recordingProcessManager struct {
+	StreamProcessManager
+	calls []string
+}
+
+func (m *recordingProcessManager) Start(id string) error {
+	m.calls = append(m.calls, "start "+id)
+	return nil
+}
+
+func (m *recordingProcessManager) Stop(id string) error {
+	m.calls = append(m.calls, "stop "+id)
+	return nil
+}
+
+func (m *recordingProcessManager) Restart(id string) error {
+	m.calls = append(m.calls, "restart "+id)
+	return nil
+}
+
+func TestServiceReloadStreamsTouchesOnlyChangedStreams(t *testing.T) {
+	bitrate, lower := 4.0, 2.0
+	specs := map[string]StreamSpec{
+		"idle":     {ID: "idle", Device: "usb-1"},
+		"renamed":  {ID: "renamed", Device: "usb-2"},
+		"tuned":    {ID: "tuned", Device: "usb-3", FFmpeg: FFmpegConfig{QualityParams: &types.QualityParams{TargetBitrate: &bitrate}}},
+		"resized":  {ID: "resized", Device: "usb-4", FFmpeg: FFmpegConfig{Resolution: "1920x1080"}},
+		"removed":  {ID: "removed", Device: "usb-5"},
+		"recorded": {ID: "recorded", Device: "usb-6"},
+	}
+	next := make(map[string]StreamSpec, len(specs))
+	for id, spec := range specs {
+		next[id] = spec
+	}
+	delete(next, "removed")
+	next["renamed"] = StreamSpec{ID: "renamed", Name: "Renamed", Device: "usb-2"}
+	next["tuned"] = StreamSpec{ID: "tuned", Device: "usb-3", FFmpeg: FFmpegConfig{QualityParams: &types.QualityParams{TargetBitrate: &lower}}}
+	next["resized"] = StreamSpec{ID: "resized", Device: "usb-4", FFmpeg: FFmpegConfig{Resolution: "1280x720"}}
+	next["recorded"] = StreamSpec{ID: "recorded", Device: "usb-6", Recording: &RecordingConfig{}}
+
+	pm := &recordingProcessManager{}
+	svc := &service{
+		store:          &mockStore{streams: specs, next: next},
+		streams:        make(map[string]*Stream),
+		processManager: pm,
+		logger:         logging.GetLogger("streams"),
+	}
+	for id := range specs {
+		svc.streams[id] = &Stream{ID: id}
+	}
+
+	diff, err := svc.ReloadStreams()
+	if err != nil {
+		t.Fatalf("ReloadStreams failed: %v", err)
+	}
+	if diff.Changed["recorded"] != SpecChangeRecording {
+		t.Errorf("recorded change = %04b, want recording", diff.Changed["recorded"])
+	}
+
+	want := []string{"stop removed", "restart resized", "restart tuned"}
+	if !slices.Equal(pm.calls, want) {
+		t.Errorf("process calls = %v, want %v", pm.calls, want)
+	}
+	if _, exists := svc.streams["removed"]; exists {
+		t.Error("removed stream is still in memory")
+	}
+}
+
+// failingSaveStore is a store whose batch write fails.
+type failingSaveStore struct {
+	*mockStore
+}
+
+func (m failingSaveStore) SaveStreams([]StreamSpec) error { return errors.New("disk full") }
+
+func TestServiceApplyBatchFailedSaveAppliesNone(t *testing.T) {
+	bitrate := 4.0
+	repo := &mockStore{streams: map[string]StreamSpec{"cam": {ID: "cam", Device: "usb-1"}}}
+	pm := &recordingProcessManager{}
+	svc := &service{
+		store:          failingSaveStore{repo},
+		processor:      newProcessor(repo),
+		streams:        map[string]*Stream{"cam": {ID: "cam"}},
+		processManager: pm,
+		logger:         logging.GetLogger("streams"),
+	}
+
+	_, err := svc.ApplyBatch(context.Background(), StreamBatchParams{
+		Create: []StreamCreateParams{{StreamID: "new", DeviceID: "usb-2", Codec: "h264"}},
+		Update: []StreamBatchUpdate{{StreamID: "cam", Params: StreamUpdateParams{Bitrate: &bitrate}}},
+	})
+	if err == nil {
+		t.Fatal("ApplyBatch succeeded with a failing write")
+	}
+	if _, exists := svc.streams["new"]; exists {
+		t.Error("created stream kept in memory after the write failed")
+	}
+	if len(pm.calls) != 0 {
+		t.Errorf("process calls = %v, want none", pm.calls)
+	}
+}
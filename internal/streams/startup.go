@@ -0,0 +1,142 @@
+package streams
+
+import (
+	"cmp"
+	"slices"
+	"sync"
+	"time"
+)
+
+// DefaultStartupConcurrency is how many streams may initialize FFmpeg (V4L2
+// format negotiation, encoder setup) at once.
+const DefaultStartupConcurrency = 4
+
+const (
+	// startupSlotTimeout releases the startup slot of a stream whose producer
+	// hasn't delivered a packet by then, so a stuck stream can't block others.
+	startupSlotTimeout = 20 * time.Second
+
+	// deviceReadyTimeout bounds how long a launch waits for its device to
+	// report ready before FFmpeg is started anyway.
+	deviceReadyTimeout = 10 * time.Second
+
+	// deviceReadyPollInterval is how often device readiness is checked.
+	deviceReadyPollInterval = 250 * time.Millisecond
+)
+
+// startupEntry is a stream waiting for or holding a startup slot.
+type startupEntry struct {
+	streamID string
+	priority int
+	seq      uint64 // Order of arrival, breaks priority ties
+	launch   func(released <-chan struct{})
+	timer    *time.Timer   // Slot timeout while active
+	released chan struct{} // Closed when the slot is freed
+}
+
+// startupScheduler bounds how many streams initialize at once. A stream holds
+// its slot from launch until release (first producer packet) or the slot
+// timeout. Waiting streams are launched by priority, highest first, then in
+// order of arrival.
+type startupScheduler struct {
+	mu          sync.Mutex
+	limit       int // <= 0 means unlimited
+	slotTimeout time.Duration
+	active      map[string]*startupEntry
+	queue       []*startupEntry
+	seq         uint64
+}
+
+func newStartupScheduler(limit int) *startupScheduler {
+	return &startupScheduler{
+		limit:       limit,
+		slotTimeout: startupSlotTimeout,
+		active:      make(map[string]*startupEntry),
+	}
+}
+
+// schedule queues launch for a stream and runs it in its own goroutine once
+// the stream gets a slot. The channel passed to launch is closed when the slot
+// is freed, so a launch still waiting for its device can give up. A stream
+// that is already queued keeps its place and runs the new launch. One that
+// already holds a slot gives it up and queues again.
+func (s *startupScheduler) schedule(streamID string, priority int, launch func(released <-chan struct{})) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	if i := s.queuedLocked(streamID); i >= 0 {
+		s.queue[i].launch = launch
+		s.queue[i].priority = priority
+		return
+	}
+	s.releaseLocked(streamID)
+
+	s.seq++
+	s.queue = append(s.queue, &startupEntry{
+		streamID: streamID,
+		priority: priority,
+		seq:      s.seq,
+		launch:   launch,
+		released: make(chan struct{}),
+	})
+	s.dispatchLocked()
+}
+
+// release frees a stream's slot, or removes it from the queue.
+func (s *startupScheduler) release(streamID string) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	if i := s.queuedLocked(streamID); i >= 0 {
+		s.queue = slices.Delete(s.queue, i, i+1)
+		return
+	}
+	s.releaseLocked(streamID)
+	s.dispatchLocked()
+}
+
+// queuedLocked returns the queue index of a stream, or -1. Caller must hold s.mu.
+func (s *startupScheduler) queuedLocked(streamID string) int {
+	return slices.IndexFunc(s.queue, func(e *startupEntry) bool { return e.streamID == streamID })
+}
+
+// releaseLocked frees a stream's slot, if it holds one. Caller must hold s.mu.
+func (s *startupScheduler) releaseLocked(streamID string) {
+	if entry, ok := s.active[streamID]; ok {
+		entry.timer.Stop()
+		close(entry.released)
+		delete(s.active, streamID)
+	}
+}
+
+// dispatchLocked launches waiting streams while slots are free. Caller must
+// hold s.mu.
+func (s *startupScheduler) dispatchLocked() {
+	slices.SortStableFunc(s.queue, func(a, b *startupEntry) int {
+		if c := cmp.Compare(b.priority, a.priority); c != 0 {
+			return c
+		}
+		return cmp.Compare(a.seq, b.seq)
+	})
+
+	for len(s.queue) > 0 && (s.limit <= 0 || len(s.active) < s.limit) {
+		entry := s.queue[0]
+		s.queue = s.queue[1:]
+
+		s.active[entry.streamID] = entry
+		entry.timer = time.AfterFunc(s.slotTimeout, func() { s.expire(entry) })
+		go entry.launch(entry.released)
+	}
+}
+
+// expire frees the slot of a stream that didn't go live in time.
+func (s *startupScheduler) expire(entry *startupEntry) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	if s.active[entry.streamID] != entry {
+		return // released or rescheduled meanwhile
+	}
+	s.releaseLocked(entry.streamID)
+	s.dispatchLocked()
+}
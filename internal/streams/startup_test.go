@@ -0,0 +1,152 @@
+package streams
+
+import (
+	"slices"
+	"sync"
+	"testing"
+	"time"
+)
+
+// launchRecorder records the order in which the scheduler launches streams.
+type launchRecorder struct {
+	mu       sync.Mutex
+	launched []string
+	signal   chan string
+}
+
+func newLaunchRecorder() *launchRecorder {
+	return &launchRecorder{signal: make(chan string, 16)}
+}
+
+func (r *launchRecorder) launch(streamID string) func(<-chan struct{}) {
+	return func(<-chan struct{}) {
+		r.mu.Lock()
+		r.launched = append(r.launched, streamID)
+		r.mu.Unlock()
+		r.signal <- streamID
+	}
+}
+
+// wait returns the next launched stream ID.
+func (r *launchRecorder) wait(t *testing.T) string {
+	t.Helper()
+	select {
+	case id := <-r.signal:
+		return id
+	case <-time.After(time.Second):
+		t.Fatal("timed out waiting for a launch")
+		return ""
+	}
+}
+
+// expectIdle fails if a stream is launched.
+func (r *launchRecorder) expectIdle(t *testing.T) {
+	t.Helper()
+	select {
+	case id := <-r.signal:
+		t.Fatalf("unexpected launch of %s", id)
+	case <-time.After(50 * time.Millisecond):
+	}
+}
+
+func TestStartupScheduler_LimitsAndOrdersByPriority(t *testing.T) {
+	scheduler := newStartupScheduler(2)
+	recorder := newLaunchRecorder()
+
+	scheduler.schedule("low", 0, recorder.launch("low"))
+	scheduler.schedule("first", 0, recorder.launch("first"))
+	scheduler.schedule("second", 0, recorder.launch("second"))
+	scheduler.schedule("high", 10, recorder.launch("high"))
+	scheduler.schedule("mid", 5, recorder.launch("mid"))
+
+	// The first two take the free slots in order of arrival
+	got := []string{recorder.wait(t), recorder.wait(t)}
+	slices.Sort(got)
+	if !slices.Equal(got, []string{"first", "low"}) {
+		t.Fatalf("first launches = %v, want [first low]", got)
+	}
+	recorder.expectIdle(t)
+
+	// Each release launches the highest priority waiting stream
+	for _, want := range []string{"high", "mid", "second"} {
+		scheduler.release(recorder.launched[0])
+		recorder.mu.Lock()
+		recorder.launched = recorder.launched[1:]
+		recorder.mu.Unlock()
+		if got := recorder.wait(t); got != want {
+			t.Errorf("next launch = %s, want %s", got, want)
+		}
+	}
+}
+
+func TestStartupScheduler_ReleaseRemovesQueuedStream(t *testing.T) {
+	scheduler := newStartupScheduler(1)
+	recorder := newLaunchRecorder()
+
+	scheduler.schedule("a", 0, recorder.launch("a"))
+	scheduler.schedule("b", 0, recorder.launch("b"))
+	scheduler.schedule("c", 0, recorder.launch("c"))
+	recorder.wait(t)
+
+	scheduler.release("b") // stopped while queued
+	scheduler.release("a")
+	if got := recorder.wait(t); got != "c" {
+		t.Errorf("next launch = %s, want c", got)
+	}
+	recorder.expectIdle(t)
+}
+
+func TestStartupScheduler_RescheduleReleasesSlot(t *testing.T) {
+	scheduler := newStartupScheduler(1)
+	recorder := newLaunchRecorder()
+
+	var released <-chan struct{}
+	scheduler.schedule("a", 0, func(r <-chan struct{}) {
+		released = r
+		recorder.signal <- "a"
+	})
+	scheduler.schedule("b", 0, recorder.launch("b"))
+	recorder.wait(t)
+
+	// A restart of a starting stream queues it behind the waiting ones
+	scheduler.schedule("a", 0, recorder.launch("a"))
+	select {
+	case <-released:
+	default:
+		t.Error("first launch of a was not released")
+	}
+	if got := recorder.wait(t); got != "b" {
+		t.Errorf("next launch = %s, want b", got)
+	}
+	scheduler.release("b")
+	if got := recorder.wait(t); got != "a" {
+		t.Errorf("next launch = %s, want a", got)
+	}
+}
+
+func TestStartupScheduler_SlotTimeout(t *testing.T) {
+	scheduler := newStartupScheduler(1)
+	scheduler.slotTimeout = 20 * time.Millisecond
+	recorder := newLaunchRecorder()
+
+	scheduler.schedule("stuck", 0, recorder.launch("stuck"))
+	scheduler.schedule("next", 0, recorder.launch("next"))
+	recorder.wait(t)
+
+	// The stuck stream never releases; its slot expires
+	if got := recorder.wait(t); got != "next" {
+		t.Errorf("next launch = %s, want next", got)
+	}
+}
+
+func TestStartupScheduler_Unlimited(t *testing.T) {
+	scheduler := newStartupScheduler(0)
+	recorder := newLaunchRecorder()
+
+	for _, id := range []string{"a", "b", "c", "d", "e"} {
+		scheduler.schedule(id, 0, recorder.launch(id))
+	}
+	for range 5 {
+		recorder.wait(t)
+	}
+}
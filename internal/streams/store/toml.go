@@ -1,9 +1,12 @@
 package store
 
 import (
+	"errors"
 	"fmt"
+	"maps"
 	"os"
 	"path/filepath"
+	"sync"
 
 	"github.com/pelletier/go-toml/v2"
 	"github.com/smazurov/videonode/internal/streams"
@@ -20,6 +23,7 @@ type config struct {
 // tomlStore implements Store using TOML file storage.
 type tomlStore struct {
 	configPath string
+	mu         sync.RWMutex
 	config     *config
 }
 
@@ -40,6 +44,9 @@ func NewTOML(configPath string) streams.Store {
 
 // Load loads the streams configuration from file.
 func (s *tomlStore) Load() error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
 	// Check if file exists
 	if _, err := os.Stat(s.configPath); os.IsNotExist(err) {
 		// File doesn't exist, use empty config
@@ -54,22 +61,63 @@ func (s *tomlStore) Load() error {
 	if err := toml.Unmarshal(data, s.config); err != nil {
 		return fmt.Errorf("failed to parse streams config: %w", err)
 	}
+	initConfig(s.config)
+
+	return nil
+}
 
+// Reload reads the streams configuration from file again and replaces the
+// one in memory, returning the per-stream changes. Unlike Load, a missing
+// file is an error rather than an empty configuration, so a file caught
+// mid-replace doesn't remove every stream.
+//
+// The file is read under s.mu, which writers hold while saving, so a reload
+// racing an API change sees the saved file instead of replacing it with
+// older content.
+func (s *tomlStore) Reload() (streams.SpecDiff, error) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	data, err := os.ReadFile(s.configPath)
+	if err != nil {
+		return streams.SpecDiff{}, fmt.Errorf("failed to read streams config: %w", err)
+	}
+
+	fresh := &config{}
+	if err := toml.Unmarshal(data, fresh); err != nil {
+		return streams.SpecDiff{}, fmt.Errorf("failed to parse streams config: %w", err)
+	}
+	initConfig(fresh)
+
+	diff := streams.DiffSpecs(s.config.Streams, fresh.Streams)
+	s.config = fresh
+	return diff, nil
+}
+
+// initConfig fills in what a parsed configuration may lack.
+func initConfig(c *config) {
 	// Initialize streams map if nil
-	if s.config.Streams == nil {
-		s.config.Streams = make(map[string]streams.StreamSpec)
+	if c.Streams == nil {
+		c.Streams = make(map[string]streams.StreamSpec)
 	}
 
 	// Set version if not set
-	if s.config.Version == 0 {
-		s.config.Version = 1
+	if c.Version == 0 {
+		c.Version = 1
 	}
-
-	return nil
 }
 
 // Save saves the streams configuration to file.
 func (s *tomlStore) Save() error {
+	s.mu.RLock()
+	defer s.mu.RUnlock()
+	return s.saveLocked()
+}
+
+// saveLocked writes the configuration to a temporary file and renames it
+// over the config file, so readers (and the config watcher) never see a
+// partly written file. Caller must hold s.mu.
+func (s *tomlStore) saveLocked() error {
 	// Ensure directory exists
 	dir := filepath.Dir(s.configPath)
 	if err := os.MkdirAll(dir, 0o755); err != nil {
@@ -81,7 +129,20 @@ func (s *tomlStore) Save() error {
 		return fmt.Errorf("failed to marshal streams config: %w", err)
 	}
 
-	if err := os.WriteFile(s.configPath, data, 0o644); err != nil {
+	tmp, err := os.CreateTemp(dir, "."+filepath.Base(s.configPath)+".*.tmp")
+	if err != nil {
+		return fmt.Errorf("failed to write streams config: %w", err)
+	}
+	_, err = tmp.Write(data)
+	if err == nil {
+		err = tmp.Sync()
+	}
+	err = errors.Join(err, tmp.Chmod(0o644), tmp.Close())
+	if err == nil {
+		err = os.Rename(tmp.Name(), s.configPath)
+	}
+	if err != nil {
+		_ = os.Remove(tmp.Name())
 		return fmt.Errorf("failed to write streams config: %w", err)
 	}
 
@@ -90,40 +151,71 @@ func (s *tomlStore) Save() error {
 
 // AddStream adds a new stream to the configuration.
 func (s *tomlStore) AddStream(stream streams.StreamSpec) error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
 	s.config.Streams[stream.ID] = stream
-	return s.Save()
+	return s.saveLocked()
 }
 
 // UpdateStream updates an existing stream configuration.
 func (s *tomlStore) UpdateStream(id string, updates streams.StreamSpec) error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
 	s.config.Streams[id] = updates
-	return s.Save()
+	return s.saveLocked()
+}
+
+// SaveStreams adds or replaces several streams and writes the file once.
+// If the write fails, none of them are applied.
+func (s *tomlStore) SaveStreams(specs []streams.StreamSpec) error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	previous := maps.Clone(s.config.Streams)
+	for _, spec := range specs {
+		s.config.Streams[spec.ID] = spec
+	}
+	if err := s.saveLocked(); err != nil {
+		s.config.Streams = previous
+		return err
+	}
+	return nil
 }
 
 // RemoveStream removes a stream from the configuration.
 func (s *tomlStore) RemoveStream(id string) error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
 	delete(s.config.Streams, id)
-	return s.Save()
+	return s.saveLocked()
 }
 
 // GetStream retrieves a stream by ID.
 func (s *tomlStore) GetStream(id string) (streams.StreamSpec, bool) {
+	s.mu.RLock()
+	defer s.mu.RUnlock()
 	stream, exists := s.config.Streams[id]
 	return stream, exists
 }
 
-// GetAllStreams returns all streams.
+// GetAllStreams returns a snapshot of all streams.
 func (s *tomlStore) GetAllStreams() map[string]streams.StreamSpec {
-	return s.config.Streams
+	s.mu.RLock()
+	defer s.mu.RUnlock()
+	return maps.Clone(s.config.Streams)
 }
 
 // GetValidation returns the current validation data.
 func (s *tomlStore) GetValidation() *types.ValidationResults {
+	s.mu.RLock()
+	defer s.mu.RUnlock()
 	return s.config.Validation
 }
 
 // UpdateValidation updates the validation data in the configuration.
 func (s *tomlStore) UpdateValidation(validation *types.ValidationResults) error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
 	s.config.Validation = validation
-	return s.Save()
+	return s.saveLocked()
 }
@@ -1,6 +1,7 @@
 package store
 
 import (
+	"fmt"
 	"os"
 	"path/filepath"
 	"testing"
@@ -480,6 +481,178 @@ func TestStreamTimestamps(t *testing.T) {
 	}
 }
 
+func TestReload(t *testing.T) {
+	repo, testFile := setupTestRepo(t)
+
+	bitrate := 4.0
+	kept := streams.StreamSpec{ID: "kept", Device: "dev-1", CreatedAt: time.Now()}
+	tuned := streams.StreamSpec{ID: "tuned", Device: "dev-2", FFmpeg: streams.FFmpegConfig{
+		QualityParams: &types.QualityParams{TargetBitrate: &bitrate},
+	}}
+	moved := streams.StreamSpec{ID: "moved", Device: "dev-3"}
+	gone := streams.StreamSpec{ID: "gone", Device: "dev-4"}
+	if err := repo.SaveStreams([]streams.StreamSpec{kept, tuned, moved, gone}); err != nil {
+		t.Fatalf("SaveStreams failed: %v", err)
+	}
+
+	// A reload of the store's own write changes nothing
+	diff, err := repo.Reload()
+	if err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if !diff.Empty() {
+		t.Errorf("reload of an unchanged file = %+v, want no changes", diff)
+	}
+
+	// Edit the file the way a user would
+	editor := NewTOML(testFile).(*tomlStore)
+	if err := editor.Load(); err != nil {
+		t.Fatalf("Load failed: %v", err)
+	}
+	lower := 2.0
+	tuned.FFmpeg.QualityParams = &types.QualityParams{TargetBitrate: &lower}
+	moved.Device = "dev-5"
+	delete(editor.config.Streams, "gone")
+	editor.config.Streams["tuned"] = tuned
+	editor.config.Streams["moved"] = moved
+	editor.config.Streams["added"] = streams.StreamSpec{ID: "added", Device: "dev-6"}
+	if err := editor.Save(); err != nil {
+		t.Fatalf("Save failed: %v", err)
+	}
+
+	diff, err = repo.Reload()
+	if err != nil {
+		t.Fatalf("Reload failed: %v", err)
+	}
+	if len(diff.Added) != 1 || diff.Added[0] != "added" {
+		t.Errorf("Added = %v, want [added]", diff.Added)
+	}
+	if len(diff.Removed) != 1 || diff.Removed[0] != "gone" {
+		t.Errorf("Removed = %v, want [gone]", diff.Removed)
+	}
+	want := map[string]streams.SpecChange{
+		"tuned": streams.SpecChangeRestart,
+		"moved": streams.SpecChangeRestart,
+	}
+	if len(diff.Changed) != len(want) {
+		t.Errorf("Changed = %v, want %v", diff.Changed, want)
+	}
+	for id, change := range want {
+		if diff.Changed[id] != change {
+			t.Errorf("Changed[%s] = %b, want %b", id, diff.Changed[id], change)
+		}
+	}
+	if spec, _ := repo.GetStream("moved"); spec.Device != "dev-5" {
+		t.Errorf("reloaded device = %s, want dev-5", spec.Device)
+	}
+}
+
+func TestReloadDuringSave(t *testing.T) {
+	repo, _ := setupTestRepo(t)
+	if err := repo.Save(); err != nil {
+		t.Fatalf("Save failed: %v", err)
+	}
+
+	// The config watcher reloads after each save the API makes
+	stop := make(chan struct{})
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		for {
+			select {
+			case <-stop:
+				return
+			default:
+			}
+			if _, err := repo.Reload(); err != nil {
+				t.Errorf("Reload failed: %v", err)
+				return
+			}
+		}
+	}()
+	for i := range 100 {
+		id := fmt.Sprintf("stream-%d", i)
+		if err := repo.AddStream(streams.StreamSpec{ID: id}); err != nil {
+			t.Fatalf("AddStream failed: %v", err)
+		}
+	}
+	close(stop)
+	<-done
+
+	for i := range 100 {
+		if _, exists := repo.GetStream(fmt.Sprintf("stream-%d", i)); !exists {
+			t.Errorf("stream-%d was lost to a concurrent reload", i)
+		}
+	}
+}
+
+func TestReloadMissingFile(t *testing.T) {
+	repo, _ := setupTestRepo(t)
+	repo.config.Streams["test"] = streams.StreamSpec{ID: "test"}
+
+	if _, err := repo.Reload(); err == nil {
+		t.Error("Reload should fail without a file")
+	}
+	if _, exists := repo.GetStream("test"); !exists {
+		t.Error("failed reload dropped streams")
+	}
+}
+
+func TestSaveStreams(t *testing.T) {
+	repo, testFile := setupTestRepo(t)
+
+	batch := []streams.StreamSpec{
+		{ID: "stream-1", Device: "dev-1"},
+		{ID: "stream-2", Device: "dev-2"},
+	}
+	if err := repo.SaveStreams(batch); err != nil {
+		t.Fatalf("SaveStreams failed: %v", err)
+	}
+
+	repo2 := NewTOML(testFile).(*tomlStore)
+	if err := repo2.Load(); err != nil {
+		t.Fatalf("Load failed: %v", err)
+	}
+	if len(repo2.config.Streams) != 2 {
+		t.Errorf("expected 2 persisted streams, got %d", len(repo2.config.Streams))
+	}
+
+	// Only the config file is left behind
+	entries, err := os.ReadDir(filepath.Dir(testFile))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(entries) != 1 {
+		t.Errorf("expected only the config file, got %d entries", len(entries))
+	}
+}
+
+func TestSaveStreamsFailureAppliesNone(t *testing.T) {
+	tmpDir := t.TempDir()
+	unwritableDir := filepath.Join(tmpDir, "unwritable")
+	if err := os.Mkdir(unwritableDir, 0o555); err != nil {
+		t.Fatalf("failed to create dir: %v", err)
+	}
+	defer func() { _ = os.Chmod(unwritableDir, 0o755) }()
+
+	repo := NewTOML(filepath.Join(unwritableDir, "test.toml")).(*tomlStore)
+	repo.config.Streams["existing"] = streams.StreamSpec{ID: "existing", Device: "dev-1"}
+
+	err := repo.SaveStreams([]streams.StreamSpec{
+		{ID: "existing", Device: "dev-2"},
+		{ID: "new", Device: "dev-3"},
+	})
+	if err == nil {
+		t.Skip("directory is writable (running as root?)")
+	}
+	if spec := repo.config.Streams["existing"]; spec.Device != "dev-1" {
+		t.Errorf("failed batch changed existing stream to %s", spec.Device)
+	}
+	if _, exists := repo.config.Streams["new"]; exists {
+		t.Error("failed batch added a stream")
+	}
+}
+
 func TestLoadInvalidTOML(t *testing.T) {
 	repo, testFile := setupTestRepo(t)
 
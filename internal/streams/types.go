@@ -18,9 +18,17 @@ type StreamService interface {
 	ListStreams(ctx context.Context) ([]Stream, error)
 	GetFFmpegCommand(ctx context.Context, streamID string, encoderOverride string) (string, bool, error)
 
+	// ApplyBatch creates and updates several streams with one atomic write
+	// to streams.toml
+	ApplyBatch(ctx context.Context, params StreamBatchParams) ([]Stream, error)
+
 	// Initialization
 	LoadStreamsFromConfig() error
 
+	// ReloadStreams re-reads streams.toml and applies only what changed in
+	// each stream's spec
+	ReloadStreams() (SpecDiff, error)
+
 	// Process management
 	GetProcessManager() StreamProcessManager
 
@@ -62,6 +70,7 @@ type StreamUpdateParams struct {
 	Codec               *string  // Optional, video codec
 	InputFormat         *string  // Optional, input format
 	Bitrate             *float64 // Optional, in Mbps
+	KeyframeInterval    *int     // Optional, GOP size in frames
 	Width               *int     // Optional, video width
 	Height              *int     // Optional, video height
 	Framerate           *int     // Optional, video framerate
@@ -71,3 +80,15 @@ type StreamUpdateParams struct {
 	TestMode            *bool    // Optional, enable test pattern mode
 	Enabled             *bool    // Optional, manual override of runtime enabled state
 }
+
+// StreamBatchParams contains the streams to create and update in one batch.
+type StreamBatchParams struct {
+	Create []StreamCreateParams
+	Update []StreamBatchUpdate
+}
+
+// StreamBatchUpdate is an update of one stream in a batch.
+type StreamBatchUpdate struct {
+	StreamID string
+	Params   StreamUpdateParams
+}
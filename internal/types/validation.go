@@ -32,6 +32,18 @@ type ValidationResults struct {
 	TestResolution string          `toml:"test_resolution" json:"test_resolution"`
 	H264           CodecValidation `toml:"h264" json:"h264"`
 	H265           CodecValidation `toml:"h265" json:"h265"`
+	ZeroCopy       []string        `toml:"zero_copy" json:"zero_copy"` // Working zero-copy paths, see ZeroCopyPath
+
+	// Fingerprints maps each encoder to the environment (FFmpeg version,
+	// kernel, device and driver) it was validated in. Results are reused
+	// while the fingerprint stays the same.
+	Fingerprints map[string]string `toml:"fingerprints,omitempty" json:"fingerprints,omitempty"`
+}
+
+// ZeroCopyPath identifies a validated zero-copy path from an input format
+// into an encoder, e.g. "h264_vaapi:mjpeg".
+func ZeroCopyPath(encoder string, inputFormat string) string {
+	return encoder + ":" + inputFormat
 }
 
 // CodecValidation represents validation results for a specific codec.
@@ -88,6 +88,18 @@ func (m *Manager) IsEncoderWorking(encoder string) bool {
 	return slices.Contains(m.validation.H265.Working, encoder)
 }
 
+// IsZeroCopyWorking checks if the zero-copy path from an input format into an encoder was validated.
+func (m *Manager) IsZeroCopyWorking(encoder string, inputFormat string) bool {
+	m.mu.RLock()
+	defer m.mu.RUnlock()
+
+	if m.validation == nil {
+		return false
+	}
+
+	return slices.Contains(m.validation.ZeroCopy, types.ZeroCopyPath(encoder, inputFormat))
+}
+
 // GetWorkingEncodersForCodec returns working encoders for a specific codec type.
 func (m *Manager) GetWorkingEncodersForCodec(codecType string) []string {
 	m.mu.RLock()
@@ -6,6 +6,8 @@ import (
 	"log/slog"
 	"net/http"
 	"os"
+	"strings"
+	"time"
 
 	"github.com/danielgtaylor/huma/v2/humacli"
 	"github.com/prometheus/client_golang/prometheus/promhttp"
@@ -15,8 +17,10 @@ import (
 	"github.com/smazurov/videonode/internal/events"
 	"github.com/smazurov/videonode/internal/led"
 	"github.com/smazurov/videonode/internal/logging"
+	"github.com/smazurov/videonode/internal/metrics"
 	"github.com/smazurov/videonode/internal/metrics/collectors"
 	"github.com/smazurov/videonode/internal/metrics/exporters"
+	"github.com/smazurov/videonode/internal/metrics/history"
 	"github.com/smazurov/videonode/internal/streaming"
 	"github.com/smazurov/videonode/internal/streams"
 	"github.com/smazurov/videonode/internal/streams/store"
@@ -31,10 +35,17 @@ type Options struct {
 	Port string `help:"Port to listen on" short:"p" default:":8090" toml:"server.port" env:"SERVER_PORT"`
 
 	// Streams settings
-	StreamsConfigFile string `help:"Stream definitions file" default:"streams.toml" toml:"streams.config_file" env:"STREAMS_CONFIG_FILE"`
+	StreamsConfigFile         string `help:"Stream definitions file" default:"streams.toml" toml:"streams.config_file" env:"STREAMS_CONFIG_FILE"`
+	StreamsStartupConcurrency int    `help:"Streams initializing FFmpeg at once (0 = unlimited)" default:"4" toml:"streams.startup_concurrency" env:"STREAMS_STARTUP_CONCURRENCY"`
 
 	// Streaming server settings
-	StreamingRTSPPort string `help:"RTSP server port" default:":8554" toml:"streaming.rtsp_port" env:"STREAMING_RTSP_PORT"`
+	StreamingRTSPPort       string `help:"RTSP server port" default:":8554" toml:"streaming.rtsp_port" env:"STREAMING_RTSP_PORT"`
+	StreamingWebRTCUDPPort  string `help:"Shared WebRTC UDP port (empty for per-peer ports)" default:"" toml:"streaming.webrtc_udp_port" env:"STREAMING_WEBRTC_UDP_PORT"`
+	StreamingWebRTCICELite  bool   `help:"Answer WebRTC offers as an ICE-lite agent" default:"false" toml:"streaming.webrtc_ice_lite" env:"STREAMING_WEBRTC_ICE_LITE"`
+	StreamingRecordingDir   string `help:"Directory for stream recordings" default:"recordings" toml:"streaming.recording_dir" env:"STREAMING_RECORDING_DIR"`
+	StreamingRelays         string `help:"Streams to pull from upstream nodes, comma-separated stream_id=url (rtsp://, srt://, rtp:// or udp://)" default:"" toml:"streaming.relays" env:"STREAMING_RELAYS"`
+	StreamingNativeAudio    bool   `help:"Capture stream audio from ALSA in process instead of in FFmpeg" default:"false" toml:"streaming.native_audio" env:"STREAMING_NATIVE_AUDIO"`
+	StreamingLatencyTracing bool   `help:"Trace frame latency from V4L2 capture to browser display" default:"false" toml:"streaming.latency_tracing" env:"STREAMING_LATENCY_TRACING"`
 
 	// Metrics settings
 	SSEEnabled bool `help:"Enable SSE metrics" default:"true" toml:"metrics.sse_enabled" env:"METRICS_SSE_ENABLED"`
@@ -81,20 +92,13 @@ func main() {
 		// Create SSE exporter if enabled
 		var sseExporter *exporters.SSEExporter
 
+		// Keep a short history of stream metrics for the UI's charts
+		metricsHistory := history.NewStore()
+		historySampler := history.NewSampler(metricsHistory, readStreamMetrics)
+
 		// Create event bus for in-process event handling
 		eventBus := events.New()
 
-		// Set up log callback to publish log entries to event bus for SSE streaming
-		logging.SetLogCallback(func(entry logging.LogEntry) {
-			eventBus.Publish(events.LogEntryEvent{
-				Timestamp:  entry.Timestamp.Format("2006-01-02T15:04:05.000Z07:00"),
-				Level:      entry.Level,
-				Module:     entry.Module,
-				Message:    entry.Message,
-				Attributes: entry.Attributes,
-			})
-		})
-
 		// Initialize LED control if enabled
 		var ledManager *led.Manager
 		var ledController led.Controller
@@ -109,13 +113,42 @@ func main() {
 		// Initialize streaming server (RTSP + WebRTC)
 		streamingLogger := logging.GetLogger("streaming")
 		streamingHub := streaming.NewHub(streamingLogger)
+		streamingHub.SetLatencyTracing(opts.StreamingLatencyTracing)
 		streamingServer := streaming.NewServer(streamingHub, streamingLogger)
-		webrtcManager := streaming.NewWebRTCManager(streamingHub, streaming.WebRTCConfig{}, logging.GetLogger("webrtc"))
+		webrtcConfig := streaming.WebRTCConfig{ICELite: opts.StreamingWebRTCICELite}
+		if opts.StreamingWebRTCUDPPort != "" {
+			udpMux, err := streaming.ListenUDPMux(opts.StreamingWebRTCUDPPort, streamingLogger)
+			if err != nil {
+				logger.Warn("Failed to open shared WebRTC UDP port, using per-peer ports", "error", err)
+			} else {
+				webrtcConfig.UDPMux = udpMux
+			}
+		}
+		webrtcManager := streaming.NewWebRTCManager(streamingHub, webrtcConfig, logging.GetLogger("webrtc"))
+		recordings := streaming.NewRecordings(streamingHub, logging.GetLogger("recording"))
+		relays := streaming.NewRelays(streamingHub, opts.StreamingRTSPPort, logging.GetLogger("relay"))
+		audioCaptures := streaming.NewAudioCaptures(streamingHub, logging.GetLogger("audio"))
+		var relaySources []streaming.RelaySource
+		for relay := range strings.SplitSeq(opts.StreamingRelays, ",") {
+			if strings.TrimSpace(relay) == "" {
+				continue
+			}
+			source, err := streaming.ParseRelaySource(relay)
+			if err != nil {
+				logger.Warn("Ignoring relay", "error", err)
+				continue
+			}
+			relaySources = append(relaySources, source)
+		}
 
-		// Close WebRTC consumers when stream producer is replaced (enables client reconnection)
+		// Close WebRTC consumers when a new producer can't continue their stream
+		// (codec change or no producer within the handover timeout). Bundles
+		// only move the stream's slots and stay connected
 		streamingHub.SetOnProducerReplaced(func(streamID string) {
-			streamingLogger.Info("Producer replaced, closing WebRTC consumers", "stream_id", streamID)
+			streamingLogger.Info("Producer changed, closing WebRTC consumers", "stream_id", streamID)
 			webrtcManager.CloseStreamConsumers(streamID)
+			recordings.Restart(streamID)
+			audioCaptures.Start(streamID) // stops the capture of deleted streams
 		})
 
 		// Default command starts the server using existing API server
@@ -124,19 +157,102 @@ func main() {
 
 		// Create stream service
 		serviceOpts := &streams.ServiceOptions{
-			Store:    streamStore,
-			EventBus: eventBus,
+			Store:              streamStore,
+			EventBus:           eventBus,
+			SlatePlayer:        streamingHub, // Hub loops no-signal slates instead of FFmpeg rendering them
+			StartupConcurrency: opts.StreamsStartupConcurrency,
+			NativeAudio:        opts.StreamingNativeAudio,
+			LatencyTracing:     opts.StreamingLatencyTracing,
 		}
 
 		streamService := streams.NewStreamService(serviceOpts)
 
+		// Resolve per-stream GOP cache settings from streams.toml
+		streamingHub.SetGOPCacheResolver(func(streamID string) (streaming.GOPCacheConfig, bool) {
+			spec, err := streamService.GetStreamSpec(context.Background(), streamID)
+			if err != nil || spec.GOPCache == nil {
+				return streaming.GOPCacheConfig{}, false
+			}
+			return streaming.GOPCacheConfig{
+				MaxPackets: spec.GOPCache.MaxPackets,
+				MaxBytes:   spec.GOPCache.MaxBytes,
+			}, true
+		})
+
+		// Record streams with [recording] settings from the hub, without transcoding
+		recordings.SetResolver(func(streamID string) (streaming.RecordingConfig, bool) {
+			spec, err := streamService.GetStreamSpec(context.Background(), streamID)
+			if err != nil || spec.Recording == nil {
+				return streaming.RecordingConfig{}, false
+			}
+			return streaming.RecordingConfig{
+				Dir:             opts.StreamingRecordingDir,
+				SegmentDuration: time.Duration(spec.Recording.SegmentSeconds) * time.Second,
+				MaxAge:          time.Duration(spec.Recording.RetentionHours * float64(time.Hour)),
+				MaxBytes:        spec.Recording.MaxBytes,
+			}, true
+		})
+
+		// Capture the audio devices of streams in process, leaving FFmpeg to
+		// video. Test mode and custom commands keep their FFmpeg audio
+		if opts.StreamingNativeAudio {
+			audioCaptures.SetResolver(func(streamID string) (streaming.AudioCaptureConfig, bool) {
+				spec, err := streamService.GetStreamSpec(context.Background(), streamID)
+				if err != nil || spec.FFmpeg.AudioDevice == "" || spec.TestMode || spec.CustomFFmpegCommand != "" {
+					return streaming.AudioCaptureConfig{}, false
+				}
+				return streaming.AudioCaptureConfig{Device: spec.FFmpeg.AudioDevice}, true
+			})
+			// Recorders pick their tracks when they start
+			audioCaptures.SetOnSourceReady(recordings.Restart)
+		}
+
+		// End stream startup (and free its startup slot) on the first producer
+		// packet, start recording and capturing audio of the now live stream, and
+		// resume bundle slots left waiting for it by a handover timeout
+		pm := streamService.GetProcessManager()
+		streamingHub.SetOnFirstPacket(func(streamID string) {
+			if pm != nil {
+				pm.OnFirstPacket(streamID)
+			}
+			recordings.Start(streamID)
+			audioCaptures.Start(streamID)
+			webrtcManager.ResumeStreamConsumers(streamID)
+		})
+
 		// Load existing streams from TOML config into memory at startup
 		// This must happen after stream service is created so OBS callbacks are registered
-		// Runtime stream management should use CRUD APIs (not reload)
+		// Runtime stream management should use CRUD APIs, edits of the file are
+		// applied per stream by the watcher below
 		if err := streamService.LoadStreamsFromConfig(); err != nil {
 			logger.Warn("Failed to load existing streams from config", "error", err)
 		}
 
+		// Hot-reload streams.toml: the service restarts only streams with
+		// structural changes, the hub side follows recording and audio changes
+		streamsWatcher := config.NewConfigWatcher(
+			opts.StreamsConfigFile,
+			func(string) (streams.SpecDiff, error) { return streamService.ReloadStreams() },
+			logging.GetLogger("config"),
+		)
+		streamsWatcher.OnReload(func(diff streams.SpecDiff) {
+			for _, streamID := range diff.Removed {
+				recordings.Stop(streamID)
+				audioCaptures.Start(streamID) // stops the capture of deleted streams
+			}
+			for streamID, change := range diff.Changed {
+				if change.Has(streams.SpecChangeRecording) {
+					recordings.Stop(streamID)
+					if streamingHub.HasProducer(streamID) {
+						recordings.Start(streamID)
+					}
+				}
+				if change.Has(streams.SpecChangeRestart) {
+					audioCaptures.Start(streamID)
+				}
+			}
+		})
+
 		// Initialize update service if enabled
 		var updateService updater.Service
 		if opts.UpdateEnabled {
@@ -161,8 +277,10 @@ func main() {
 			StreamService:         streamService,
 			EventBus:              eventBus,
 			WebRTCManager:         webrtcManager,
+			StreamingHub:          streamingHub,
 			PrometheusHandler:     promhttp.Handler(), // Prometheus metrics via promauto
 			UpdateService:         updateService,
+			MetricsHistory:        metricsHistory,
 		}
 
 		// Add LED controller if available
@@ -170,13 +288,14 @@ func main() {
 			apiOpts.LEDController = ledController
 		}
 
-		server := api.NewServer(apiOpts)
-
 		// Create SSE exporter if enabled
 		if opts.SSEEnabled {
 			sseExporter = exporters.NewSSEExporter(eventBus)
+			apiOpts.SSEExporter = sseExporter
 		}
 
+		server := api.NewServer(apiOpts)
+
 		hooks.OnStart(func() {
 			// Start RTSP streaming server first (must be ready for FFmpeg)
 			if err := streamingServer.Start(opts.StreamingRTSPPort); err != nil {
@@ -184,10 +303,18 @@ func main() {
 				os.Exit(1)
 			}
 
+			// Pull relayed streams from upstream nodes into the hub
+			relays.Start(context.Background(), relaySources)
+
+			if err := streamsWatcher.Start(); err != nil {
+				logger.Warn("Failed to watch streams config, hot-reload disabled", "error", err)
+			}
+
 			// Start SSE exporter if enabled
 			if sseExporter != nil {
 				sseExporter.Start(context.Background())
 			}
+			historySampler.Start(context.Background())
 
 			// Start LED manager if enabled
 			if ledManager != nil {
@@ -207,6 +334,15 @@ func main() {
 				logger.Error("Error stopping HTTP server", "error", err)
 			}
 
+			if err := streamsWatcher.Stop(); err != nil {
+				logger.Warn("Error stopping streams config watcher", "error", err)
+			}
+
+			// Complete open recording segments before their producers go away
+			recordings.StopAll()
+			relays.Stop()
+			audioCaptures.StopAll()
+
 			// Stop all FFmpeg processes (after HTTP server stops accepting new requests)
 			if pm := streamService.GetProcessManager(); pm != nil {
 				logger.Info("Stopping all stream processes")
@@ -227,6 +363,7 @@ func main() {
 			if sseExporter != nil {
 				sseExporter.Stop()
 			}
+			historySampler.Stop()
 			if mppCollector != nil {
 				_ = mppCollector.Stop()
 			}
@@ -246,6 +383,32 @@ func main() {
 	streamCmd := cmd.CreateStreamCmd()
 	cli.Root().AddCommand(streamCmd)
 
+	// Add bench command
+	benchCmd := cmd.CreateBenchCmd()
+	cli.Root().AddCommand(benchCmd)
+
 	// Run the CLI
 	cli.Run()
 }
+
+// readStreamMetrics merges the encoder and WebRTC egress metrics of every
+// stream for the metrics history.
+func readStreamMetrics() map[string]history.Reading {
+	readings := make(map[string]history.Reading)
+	for streamID, m := range metrics.GetAllFFmpegMetrics() {
+		readings[streamID] = history.Reading{
+			FPS:           m.FPS,
+			Speed:         m.Speed,
+			DroppedFrames: m.DroppedFrames,
+		}
+	}
+	for streamID, egress := range streaming.EgressSnapshot() {
+		r := readings[streamID]
+		r.BytesSent = egress.BytesSent
+		r.NACKs = egress.NACKs
+		r.PLIs = egress.PLIs
+		r.Peers = egress.Peers
+		readings[streamID] = r
+	}
+	return readings
+}
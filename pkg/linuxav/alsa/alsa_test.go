@@ -2,7 +2,10 @@
 
 package alsa
 
-import "testing"
+import (
+	"math"
+	"testing"
+)
 
 func TestFormatALSADevice(t *testing.T) {
 	tests := []struct {
@@ -180,3 +183,37 @@ func TestFormatName(t *testing.T) {
 		})
 	}
 }
+
+func TestAvailFrames(t *testing.T) {
+	boundary := pointerBoundary(960)
+	tests := []struct {
+		name    string
+		hwPtr   uint64
+		applPtr uint64
+		want    uint64
+	}{
+		{name: "nothing captured", hwPtr: 480, applPtr: 480, want: 0},
+		{name: "one period", hwPtr: 720, applPtr: 480, want: 240},
+		{name: "hw pointer wrapped", hwPtr: 100, applPtr: boundary - 140, want: 240},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := availFrames(tt.hwPtr, tt.applPtr, boundary); got != tt.want {
+				t.Errorf("availFrames(%d, %d) = %d, want %d", tt.hwPtr, tt.applPtr, got, tt.want)
+			}
+		})
+	}
+}
+
+func TestPointerBoundary(t *testing.T) {
+	for _, buffer := range []uint64{960, 1024, 4410} {
+		boundary := pointerBoundary(buffer)
+		if boundary%buffer != 0 {
+			t.Errorf("boundary %d for buffer %d isn't a multiple of it", boundary, buffer)
+		}
+		if boundary > math.MaxInt64-buffer || boundary*2 <= math.MaxInt64-buffer {
+			t.Errorf("boundary %d for buffer %d isn't the largest that fits", boundary, buffer)
+		}
+	}
+}
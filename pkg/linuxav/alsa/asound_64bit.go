@@ -12,6 +12,8 @@ var (
 	_ [32]byte  = [unsafe.Sizeof(sndMask{})]byte{}
 	_ [12]byte  = [unsafe.Sizeof(sndInterval{})]byte{}
 	_ [608]byte = [unsafe.Sizeof(sndPCMHwParams{})]byte{}
+	_ [136]byte = [unsafe.Sizeof(sndPCMSwParams{})]byte{}
+	_ [136]byte = [unsafe.Sizeof(sndPCMSyncPtr{})]byte{}
 )
 
 // IOCTL constants for 64-bit architectures.
@@ -27,6 +29,9 @@ const (
 	sndrvPCMIoctlHwParams = 0xc2604111
 	sndrvPCMIoctlSwParams = 0xc0884113
 	sndrvPCMIoctlPrepare  = 0x00004140
+	sndrvPCMIoctlSyncPtr  = 0xc0884123
+	sndrvPCMIoctlStart    = 0x00004142
+	sndrvPCMIoctlDrop     = 0x00004143
 )
 
 // Hardware parameter constants.
@@ -53,7 +58,27 @@ const (
 
 	sndrvMaskMax = 256
 
-	sndrvPCMAccessRwInterleaved = 3
+	sndrvPCMAccessMmapInterleaved = 0
+	sndrvPCMAccessRwInterleaved   = 3
+	sndrvPCMSubformatStd          = 0
+
+	sndrvIntervalInteger = 1 << 2 // snd_interval integer bit field
+
+	sndrvPCMMmapOffsetData = 0
+)
+
+// PCM states (snd_pcm_state_t).
+const (
+	sndrvPCMStateXrun         = 4
+	sndrvPCMStateSuspended    = 7
+	sndrvPCMStateDisconnected = 8
+)
+
+// snd_pcm_sync_ptr flags.
+const (
+	sndrvPCMSyncPtrHwsync   = 1 << 0 // update hw_ptr from the hardware first
+	sndrvPCMSyncPtrAppl     = 1 << 1 // read appl_ptr instead of setting it
+	sndrvPCMSyncPtrAvailMin = 1 << 2 // read avail_min instead of setting it
 )
 
 // sndCtlCardInfo has size 376 bytes.
@@ -115,6 +140,51 @@ type sndPCMHwParams struct {
 	reserved  [64]byte                                                                    // offset 544
 }
 
+// sndPCMSwParams has size 136 bytes.
+type sndPCMSwParams struct {
+	tstampMode       int32    // offset 0
+	periodStep       uint32   // offset 4
+	sleepMin         uint32   // offset 8
+	_                [4]byte  // padding
+	availMin         uint64   // offset 16
+	xferAlign        uint64   // offset 24
+	startThreshold   uint64   // offset 32
+	stopThreshold    uint64   // offset 40
+	silenceThreshold uint64   // offset 48
+	silenceSize      uint64   // offset 56
+	boundary         uint64   // offset 64
+	proto            uint32   // offset 72
+	tstampType       uint32   // offset 76
+	reserved         [56]byte // offset 80
+}
+
+// sndPCMMmapStatus has size 56 bytes.
+type sndPCMMmapStatus struct {
+	state          int32    // offset 0
+	_              [4]byte  // padding
+	hwPtr          uint64   // offset 8
+	tstamp         [2]int64 // offset 16
+	suspendedState int32    // offset 32
+	_              [4]byte  // padding
+	audioTstamp    [2]int64 // offset 40
+}
+
+// sndPCMMmapControl has size 16 bytes.
+type sndPCMMmapControl struct {
+	applPtr  uint64 // offset 0
+	availMin uint64 // offset 8
+}
+
+// sndPCMSyncPtr has size 136 bytes.
+type sndPCMSyncPtr struct {
+	flags   uint32            // offset 0
+	_       [4]byte           // padding
+	status  sndPCMMmapStatus  // offset 8, in a 64 byte union
+	_       [8]byte           // rest of the union
+	control sndPCMMmapControl // offset 72, in a 64 byte union
+	_       [48]byte          // rest of the union
+}
+
 // Helper methods for sndPCMHwParams.
 func (p *sndPCMHwParams) init() {
 	for i := range p.masks {
@@ -139,6 +209,11 @@ func (p *sndPCMHwParams) checkMask(param, val uint32) bool {
 	return p.masks[param].bits[val>>5]&(1<<(val&0x1F)) > 0
 }
 
+func (p *sndPCMHwParams) setInterval(param, val uint32) {
+	idx := param - sndrvPCMHwParamFirstInterval
+	p.intervals[idx] = sndInterval{minVal: val, maxVal: val, bit: sndrvIntervalInteger}
+}
+
 func (p *sndPCMHwParams) getInterval(param uint32) (minVal, maxVal uint32) {
 	idx := param - sndrvPCMHwParamFirstInterval
 	return p.intervals[idx].minVal, p.intervals[idx].maxVal
@@ -0,0 +1,317 @@
+//go:build linux
+
+package alsa
+
+import (
+	"errors"
+	"fmt"
+	"math"
+	"os"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+// Capture defaults used when CaptureConfig fields are zero.
+const (
+	DefaultCaptureRate     = 48000
+	DefaultCaptureChannels = 2
+	DefaultPeriodFrames    = 240 // 5 ms at 48 kHz
+	DefaultPeriods         = 4
+)
+
+// ErrReadTimeout is returned by Capture.Read when no frames arrive in time.
+var ErrReadTimeout = errors.New("alsa: timed out waiting for frames")
+
+// ErrOverrun is returned by Capture.Read after the ring buffer overflowed
+// and capture was restarted. Frames captured during the overrun are lost.
+var ErrOverrun = errors.New("alsa: capture overrun")
+
+// ErrDisconnected is returned by Capture.Read once the device is gone.
+var ErrDisconnected = errors.New("alsa: device disconnected")
+
+// CaptureConfig selects the capture format of a Capture. Samples are always
+// interleaved S16_LE.
+type CaptureConfig struct {
+	Rate     int // DefaultCaptureRate if zero
+	Channels int // DefaultCaptureChannels if zero
+
+	// PeriodFrames is the wakeup granularity, and with Periods sizes the
+	// ring buffer. The driver may round both to what it supports; check
+	// Capture.PeriodFrames and Capture.BufferFrames.
+	PeriodFrames int // DefaultPeriodFrames if zero
+	Periods      int // DefaultPeriods if zero
+}
+
+// Capture records from an ALSA PCM device through its memory-mapped ring
+// buffer (MMAP_INTERLEAVED access), with a small period size for low
+// latency. Hardware and application pointers are exchanged with
+// SNDRV_PCM_IOCTL_SYNC_PTR, which works on drivers that can't map their
+// status and control records.
+//
+// A Capture is not safe for concurrent use.
+type Capture struct {
+	fd           int
+	rate         int
+	channels     int
+	frameBytes   int
+	periodFrames uint64
+	bufferFrames uint64
+	boundary     uint64
+	data         []byte // the mapped ring buffer
+	sync         sndPCMSyncPtr
+	started      bool
+}
+
+// OpenCapture opens an ALSA device ("hw:X,Y") for capture and configures
+// it. Capture starts with the first Read.
+func OpenCapture(alsaDevice string, config CaptureConfig) (*Capture, error) {
+	var cardNum, devNum int
+	if _, err := fmt.Sscanf(alsaDevice, "hw:%d,%d", &cardNum, &devNum); err != nil {
+		return nil, fmt.Errorf("invalid ALSA device %q: %w", alsaDevice, err)
+	}
+	pcmPath := fmt.Sprintf("/dev/snd/pcmC%dD%dc", cardNum, devNum)
+
+	// Opened non-blocking so a busy device fails instead of waiting
+	fd, err := syscall.Open(pcmPath, syscall.O_RDWR|syscall.O_NONBLOCK|syscall.O_CLOEXEC, 0)
+	if err != nil {
+		return nil, fmt.Errorf("failed to open %s: %w", pcmPath, err)
+	}
+
+	c := &Capture{fd: fd}
+	if err := c.setHwParams(config); err != nil {
+		_ = syscall.Close(fd)
+		return nil, err
+	}
+	if err := c.setSwParams(); err != nil {
+		_ = syscall.Close(fd)
+		return nil, err
+	}
+
+	size := int(c.bufferFrames) * c.frameBytes
+	pageSize := os.Getpagesize()
+	size = (size + pageSize - 1) / pageSize * pageSize
+	c.data, err = syscall.Mmap(fd, sndrvPCMMmapOffsetData, size, syscall.PROT_READ, syscall.MAP_SHARED)
+	if err != nil {
+		_ = syscall.Close(fd)
+		return nil, fmt.Errorf("failed to map ring buffer: %w", err)
+	}
+
+	if err := ioctl(uintptr(fd), sndrvPCMIoctlPrepare, nil); err != nil {
+		_ = c.Close()
+		return nil, fmt.Errorf("failed to prepare: %w", err)
+	}
+	return c, nil
+}
+
+// setHwParams negotiates access, format, rate and channels exactly, and the
+// period and buffer sizes as close to the request as the driver allows.
+func (c *Capture) setHwParams(config CaptureConfig) error {
+	c.rate = orDefault(config.Rate, DefaultCaptureRate)
+	c.channels = orDefault(config.Channels, DefaultCaptureChannels)
+	periodFrames := orDefault(config.PeriodFrames, DefaultPeriodFrames)
+	periods := orDefault(config.Periods, DefaultPeriods)
+
+	params := sndPCMHwParams{}
+	params.init()
+	params.setMask(sndrvPCMHwParamAccess, sndrvPCMAccessMmapInterleaved)
+	params.setMask(sndrvPCMHwParamFormat, FormatS16LE)
+	params.setMask(sndrvPCMHwParamSubformat, sndrvPCMSubformatStd)
+	params.setInterval(sndrvPCMHwParamChannels, uint32(c.channels))
+	params.setInterval(sndrvPCMHwParamRate, uint32(c.rate))
+	if err := ioctl(uintptr(c.fd), sndrvPCMIoctlHwRefine, unsafe.Pointer(&params)); err != nil {
+		return fmt.Errorf("device doesn't support mmap capture of S16_LE %d Hz %d channels: %w", c.rate, c.channels, err)
+	}
+
+	minPeriod, maxPeriod := params.getInterval(sndrvPCMHwParamPeriodSize)
+	params.setInterval(sndrvPCMHwParamPeriodSize, clamp(uint32(periodFrames), minPeriod, maxPeriod))
+	minPeriods, maxPeriods := params.getInterval(sndrvPCMHwParamPeriods)
+	params.setInterval(sndrvPCMHwParamPeriods, clamp(uint32(periods), minPeriods, maxPeriods))
+	params.rmask = 0xFFFFFFFF
+	if err := ioctl(uintptr(c.fd), sndrvPCMIoctlHwParams, unsafe.Pointer(&params)); err != nil {
+		return fmt.Errorf("failed to set hw params: %w", err)
+	}
+
+	period, _ := params.getInterval(sndrvPCMHwParamPeriodSize)
+	buffer, _ := params.getInterval(sndrvPCMHwParamBufferSize)
+	c.periodFrames, c.bufferFrames = uint64(period), uint64(buffer)
+	c.frameBytes = c.channels * 2
+	c.boundary = pointerBoundary(c.bufferFrames)
+	return nil
+}
+
+// setSwParams wakes readers once a period is captured and stops capture on
+// overrun, so Read can report it.
+func (c *Capture) setSwParams() error {
+	params := sndPCMSwParams{
+		periodStep:     1,
+		availMin:       c.periodFrames,
+		startThreshold: 1,
+		stopThreshold:  c.bufferFrames,
+		boundary:       c.boundary,
+	}
+	if err := ioctl(uintptr(c.fd), sndrvPCMIoctlSwParams, unsafe.Pointer(&params)); err != nil {
+		return fmt.Errorf("failed to set sw params: %w", err)
+	}
+	return nil
+}
+
+// Rate returns the sample rate in Hz.
+func (c *Capture) Rate() int { return c.rate }
+
+// Channels returns the number of interleaved channels.
+func (c *Capture) Channels() int { return c.channels }
+
+// PeriodFrames returns the period size negotiated with the driver.
+func (c *Capture) PeriodFrames() int { return int(c.periodFrames) }
+
+// BufferFrames returns the ring buffer size negotiated with the driver.
+func (c *Capture) BufferFrames() int { return int(c.bufferFrames) }
+
+// Read waits up to timeout for captured frames and copies as many whole
+// frames as fit into p, returning the number of bytes copied. It returns as
+// soon as a period is available. A zero timeout waits forever.
+func (c *Capture) Read(p []byte, timeout time.Duration) (int, error) {
+	if !c.started {
+		if err := ioctl(uintptr(c.fd), sndrvPCMIoctlStart, nil); err != nil {
+			return 0, fmt.Errorf("failed to start capture: %w", err)
+		}
+		c.started = true
+	}
+
+	var deadline time.Time
+	if timeout > 0 {
+		deadline = time.Now().Add(timeout)
+	}
+
+	for {
+		if err := c.syncPtr(sndrvPCMSyncPtrHwsync | sndrvPCMSyncPtrAppl | sndrvPCMSyncPtrAvailMin); err != nil {
+			return 0, fmt.Errorf("failed to sync pointers: %w", err)
+		}
+		switch c.sync.status.state {
+		case sndrvPCMStateXrun:
+			return 0, c.recover()
+		case sndrvPCMStateSuspended, sndrvPCMStateDisconnected:
+			return 0, ErrDisconnected
+		}
+
+		avail := availFrames(c.sync.status.hwPtr, c.sync.control.applPtr, c.boundary)
+		if avail >= c.periodFrames {
+			return c.copyFrames(p, avail)
+		}
+		if err := c.wait(deadline); err != nil {
+			return 0, err
+		}
+	}
+}
+
+// copyFrames copies frames from the ring buffer at the application pointer
+// and hands the space back to the driver.
+func (c *Capture) copyFrames(p []byte, avail uint64) (int, error) {
+	frames := min(avail, uint64(len(p)/c.frameBytes))
+	if frames == 0 {
+		return 0, nil
+	}
+
+	offset := c.sync.control.applPtr % c.bufferFrames
+	first := min(frames, c.bufferFrames-offset) // up to the end of the ring
+	n := copy(p, c.data[offset*uint64(c.frameBytes):(offset+first)*uint64(c.frameBytes)])
+	if first < frames {
+		n += copy(p[n:], c.data[:(frames-first)*uint64(c.frameBytes)])
+	}
+
+	c.sync.control.applPtr = (c.sync.control.applPtr + frames) % c.boundary
+	c.sync.control.availMin = c.periodFrames
+	if err := c.syncPtr(0); err != nil {
+		return 0, fmt.Errorf("failed to advance application pointer: %w", err)
+	}
+	return n, nil
+}
+
+// recover restarts capture after an overrun.
+func (c *Capture) recover() error {
+	if err := ioctl(uintptr(c.fd), sndrvPCMIoctlPrepare, nil); err != nil {
+		return fmt.Errorf("failed to recover from overrun: %w", err)
+	}
+	if err := ioctl(uintptr(c.fd), sndrvPCMIoctlStart, nil); err != nil {
+		return fmt.Errorf("failed to restart capture: %w", err)
+	}
+	return ErrOverrun
+}
+
+func (c *Capture) syncPtr(flags uint32) error {
+	c.sync.flags = flags
+	return ioctl(uintptr(c.fd), sndrvPCMIoctlSyncPtr, unsafe.Pointer(&c.sync))
+}
+
+// wait blocks until a period is captured or the deadline passes.
+func (c *Capture) wait(deadline time.Time) error {
+	var readFds syscall.FdSet
+	readFds.Bits[c.fd/64] |= 1 << (uint(c.fd) % 64)
+
+	var tv *syscall.Timeval
+	if !deadline.IsZero() {
+		remaining := time.Until(deadline)
+		if remaining <= 0 {
+			return ErrReadTimeout
+		}
+		timeval := syscall.NsecToTimeval(remaining.Nanoseconds())
+		tv = &timeval
+	}
+
+	n, err := syscall.Select(c.fd+1, &readFds, nil, nil, tv)
+	if errors.Is(err, syscall.EINTR) {
+		return nil
+	}
+	if err != nil {
+		return err
+	}
+	if n == 0 {
+		return ErrReadTimeout
+	}
+	return nil
+}
+
+// Close stops capturing and releases the ring buffer and the device.
+func (c *Capture) Close() error {
+	if c.started {
+		_ = ioctl(uintptr(c.fd), sndrvPCMIoctlDrop, nil)
+		c.started = false
+	}
+	if c.data != nil {
+		_ = syscall.Munmap(c.data)
+		c.data = nil
+	}
+	return syscall.Close(c.fd)
+}
+
+// availFrames is the number of captured frames not yet read. Both pointers
+// wrap at boundary.
+func availFrames(hwPtr, applPtr, boundary uint64) uint64 {
+	if hwPtr >= applPtr {
+		return hwPtr - applPtr
+	}
+	return hwPtr + boundary - applPtr
+}
+
+// pointerBoundary is where the kernel wraps the hardware and application
+// pointers: the largest power-of-two multiple of the buffer size that fits
+// a snd_pcm_uframes_t with room for one more buffer.
+func pointerBoundary(bufferFrames uint64) uint64 {
+	boundary := bufferFrames
+	for boundary*2 <= math.MaxInt64-bufferFrames {
+		boundary *= 2
+	}
+	return boundary
+}
+
+func orDefault(v, def int) int {
+	if v <= 0 {
+		return def
+	}
+	return v
+}
+
+func clamp(v, lo, hi uint32) uint32 {
+	return min(max(v, lo), hi)
+}
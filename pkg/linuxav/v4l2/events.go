@@ -0,0 +1,304 @@
+//go:build linux
+
+package v4l2
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"sync"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+// EventKind identifies what an event from an EventMux reports.
+type EventKind int
+
+// Event kinds.
+const (
+	// EventSourceChange reports a change of the incoming signal, like an HDMI
+	// source locking, losing lock or switching resolution.
+	EventSourceChange EventKind = iota
+	// EventPowerPresent reports 5V power appearing or disappearing on an
+	// HDMI input, i.e. a cable or source being (dis)connected.
+	EventPowerPresent
+	// EventDeviceGone reports that the device went away. The mux has already
+	// removed it.
+	EventDeviceGone
+)
+
+// SourceChangeResolution is the change flag set when the detected
+// resolution or timings changed (V4L2_EVENT_SRC_CH_RESOLUTION).
+const SourceChangeResolution = 0x0001
+
+// DeviceEvent is an event from a device registered with an EventMux.
+type DeviceEvent struct {
+	DevicePath string
+	Kind       EventKind
+	Changes    uint32    // source change flags, for EventSourceChange
+	Value      int64     // control value, for EventPowerPresent (nonzero = power present)
+	Time       time.Time // when the event was dequeued
+}
+
+// EventHandler receives events from an EventMux. It runs on the mux's
+// goroutine and should not block.
+type EventHandler func(DeviceEvent)
+
+// muxDevice is a device registered with an EventMux.
+type muxDevice struct {
+	path string
+	fd   int
+}
+
+// EventMux waits for V4L2 events on many devices with a single epoll
+// instance and one goroutine, instead of a blocked goroutine per device.
+//
+// Each registered device is kept open and subscribed to source change and,
+// where supported, power present events. Events are dispatched as soon as
+// the kernel queues them.
+//
+//	mux, _ := v4l2.NewEventMux(func(e v4l2.DeviceEvent) { ... })
+//	go mux.Run(ctx)
+//	_ = mux.Add("/dev/video0")
+type EventMux struct {
+	epfd    int
+	wakeR   int // read end of the pipe that interrupts epoll_wait on Close
+	wakeW   int
+	handler EventHandler
+
+	mu      sync.Mutex
+	byFD    map[int]*muxDevice
+	byPath  map[string]*muxDevice
+	closed  bool
+	running bool // Run owns epfd and the wake pipe and closes them on return
+}
+
+// NewEventMux creates an event multiplexer that delivers events to handler.
+func NewEventMux(handler EventHandler) (*EventMux, error) {
+	epfd, err := syscall.EpollCreate1(syscall.EPOLL_CLOEXEC)
+	if err != nil {
+		return nil, fmt.Errorf("epoll_create1: %w", err)
+	}
+
+	var pipe [2]int
+	if err := syscall.Pipe2(pipe[:], syscall.O_CLOEXEC|syscall.O_NONBLOCK); err != nil {
+		_ = syscall.Close(epfd)
+		return nil, fmt.Errorf("pipe2: %w", err)
+	}
+
+	ev := syscall.EpollEvent{Events: syscall.EPOLLIN, Fd: int32(pipe[0])}
+	if err := syscall.EpollCtl(epfd, syscall.EPOLL_CTL_ADD, pipe[0], &ev); err != nil {
+		_ = syscall.Close(pipe[0])
+		_ = syscall.Close(pipe[1])
+		_ = syscall.Close(epfd)
+		return nil, fmt.Errorf("epoll_ctl wake pipe: %w", err)
+	}
+
+	return &EventMux{
+		epfd:    epfd,
+		wakeR:   pipe[0],
+		wakeW:   pipe[1],
+		handler: handler,
+		byFD:    make(map[int]*muxDevice),
+		byPath:  make(map[string]*muxDevice),
+	}, nil
+}
+
+// Add registers a device. It returns ErrEventsNotSupported if the device
+// has no source change events. Adding a registered device is a no-op.
+func (m *EventMux) Add(devicePath string) error {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	if m.closed {
+		return errors.New("event mux closed")
+	}
+	if _, exists := m.byPath[devicePath]; exists {
+		return nil
+	}
+
+	fd, err := open(devicePath)
+	if err != nil {
+		return err
+	}
+
+	sub := v4l2EventSubscription{typ: v4l2EventSourceChange}
+	if err := ioctl(fd, vidiocSubscribeEvent, unsafe.Pointer(&sub)); err != nil {
+		_ = closefd(fd)
+		if errors.Is(err, syscall.ENOTTY) || errors.Is(err, syscall.EINVAL) {
+			return ErrEventsNotSupported
+		}
+		return err
+	}
+
+	// Best effort: not every receiver exposes the power present control
+	ctrl := v4l2EventSubscription{typ: v4l2EventCtrl, id: v4l2CidDVRxPowerPresent}
+	_ = ioctl(fd, vidiocSubscribeEvent, unsafe.Pointer(&ctrl))
+
+	ev := syscall.EpollEvent{Events: syscall.EPOLLPRI | syscall.EPOLLERR | syscall.EPOLLHUP, Fd: int32(fd)}
+	if err := syscall.EpollCtl(m.epfd, syscall.EPOLL_CTL_ADD, fd, &ev); err != nil {
+		_ = closefd(fd)
+		return fmt.Errorf("epoll_ctl add %s: %w", devicePath, err)
+	}
+
+	dev := &muxDevice{path: devicePath, fd: fd}
+	m.byFD[fd] = dev
+	m.byPath[devicePath] = dev
+	return nil
+}
+
+// Remove unregisters a device and closes it. Removing an unknown device is
+// a no-op.
+func (m *EventMux) Remove(devicePath string) {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+
+	if dev, exists := m.byPath[devicePath]; exists {
+		m.removeLocked(dev)
+	}
+}
+
+// removeLocked unregisters dev. Caller holds mu.
+func (m *EventMux) removeLocked(dev *muxDevice) {
+	_ = syscall.EpollCtl(m.epfd, syscall.EPOLL_CTL_DEL, dev.fd, nil)
+	// Closing the fd drops its event subscriptions
+	_ = closefd(dev.fd)
+	delete(m.byFD, dev.fd)
+	delete(m.byPath, dev.path)
+}
+
+// Has reports whether a device is registered.
+func (m *EventMux) Has(devicePath string) bool {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	_, exists := m.byPath[devicePath]
+	return exists
+}
+
+// Run waits for events and dispatches them until ctx is done or Close is
+// called. It must be called once.
+func (m *EventMux) Run(ctx context.Context) error {
+	m.mu.Lock()
+	if m.closed || m.running {
+		m.mu.Unlock()
+		return errors.New("event mux closed or already running")
+	}
+	m.running = true
+	m.mu.Unlock()
+	defer m.release()
+
+	stop := context.AfterFunc(ctx, m.wake)
+	defer stop()
+
+	events := make([]syscall.EpollEvent, 16)
+	for {
+		n, err := syscall.EpollWait(m.epfd, events, -1)
+		if errors.Is(err, syscall.EINTR) {
+			continue
+		}
+		if err != nil {
+			return fmt.Errorf("epoll_wait: %w", err)
+		}
+
+		for i := range events[:n] {
+			fd := int(events[i].Fd)
+			if fd == m.wakeR {
+				if ctx.Err() != nil {
+					return ctx.Err()
+				}
+				return nil
+			}
+			m.dispatch(fd, events[i].Events)
+		}
+	}
+}
+
+// dispatch dequeues all pending events of fd and hands them to the handler.
+func (m *EventMux) dispatch(fd int, ready uint32) {
+	m.mu.Lock()
+	dev, exists := m.byFD[fd]
+	if !exists {
+		// Removed after epoll_wait returned
+		m.mu.Unlock()
+		return
+	}
+	path := dev.path
+
+	var pending []DeviceEvent
+	if ready&syscall.EPOLLPRI != 0 {
+		for {
+			var raw v4l2Event
+			if err := ioctl(fd, vidiocDqevent, unsafe.Pointer(&raw)); err != nil {
+				if errors.Is(err, syscall.ENODEV) {
+					ready |= syscall.EPOLLERR
+				}
+				break
+			}
+			pending = append(pending, translateEvent(path, &raw))
+			if raw.pending == 0 {
+				break
+			}
+		}
+	}
+
+	gone := ready&(syscall.EPOLLERR|syscall.EPOLLHUP) != 0
+	if gone {
+		m.removeLocked(dev)
+		pending = append(pending, DeviceEvent{DevicePath: path, Kind: EventDeviceGone, Time: time.Now()})
+	}
+	m.mu.Unlock()
+
+	// Deliver outside the lock so the handler may call Add/Remove
+	for _, e := range pending {
+		m.handler(e)
+	}
+}
+
+// translateEvent converts a dequeued kernel event.
+func translateEvent(path string, raw *v4l2Event) DeviceEvent {
+	e := DeviceEvent{DevicePath: path, Time: time.Now()}
+	switch raw.typ {
+	case v4l2EventCtrl:
+		e.Kind = EventPowerPresent
+		e.Value = raw.getCtrlValue()
+	default:
+		e.Kind = EventSourceChange
+		e.Changes = raw.getSrcChangeChanges()
+	}
+	return e
+}
+
+// wake interrupts epoll_wait so Run returns.
+func (m *EventMux) wake() {
+	_, _ = syscall.Write(m.wakeW, []byte{0})
+}
+
+// Close stops Run, if running, and closes all registered devices.
+func (m *EventMux) Close() error {
+	m.mu.Lock()
+	if m.closed {
+		m.mu.Unlock()
+		return nil
+	}
+	m.closed = true
+	for _, dev := range m.byPath {
+		m.removeLocked(dev)
+	}
+	running := m.running
+	m.mu.Unlock()
+
+	if running {
+		m.wake()
+	} else {
+		m.release()
+	}
+	return nil
+}
+
+// release closes the epoll instance and the wake pipe.
+func (m *EventMux) release() {
+	_ = syscall.Close(m.wakeR)
+	_ = syscall.Close(m.wakeW)
+	_ = syscall.Close(m.epfd)
+}
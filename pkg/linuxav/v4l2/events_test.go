@@ -0,0 +1,85 @@
+//go:build linux
+
+package v4l2
+
+import (
+	"context"
+	"errors"
+	"testing"
+	"time"
+)
+
+func TestEventMux_AddUnsupportedDevice(t *testing.T) {
+	mux, err := NewEventMux(func(DeviceEvent) {})
+	if err != nil {
+		t.Fatalf("NewEventMux: %v", err)
+	}
+	defer mux.Close()
+
+	// /dev/null opens fine but has no V4L2 ioctls
+	if err := mux.Add("/dev/null"); !errors.Is(err, ErrEventsNotSupported) {
+		t.Errorf("Add(/dev/null) = %v, want ErrEventsNotSupported", err)
+	}
+	if mux.Has("/dev/null") {
+		t.Error("unsupported device should not stay registered")
+	}
+}
+
+func TestEventMux_RunStops(t *testing.T) {
+	tests := []struct {
+		name    string
+		stop    func(cancel context.CancelFunc, mux *EventMux)
+		wantErr error
+	}{
+		{"context cancel", func(cancel context.CancelFunc, _ *EventMux) { cancel() }, context.Canceled},
+		{"close", func(_ context.CancelFunc, mux *EventMux) { _ = mux.Close() }, nil},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			mux, err := NewEventMux(func(DeviceEvent) {})
+			if err != nil {
+				t.Fatalf("NewEventMux: %v", err)
+			}
+			defer mux.Close()
+
+			ctx, cancel := context.WithCancel(context.Background())
+			defer cancel()
+
+			done := make(chan error, 1)
+			go func() { done <- mux.Run(ctx) }()
+
+			time.Sleep(10 * time.Millisecond)
+			tt.stop(cancel, mux)
+
+			select {
+			case err := <-done:
+				if !errors.Is(err, tt.wantErr) {
+					t.Errorf("Run() = %v, want %v", err, tt.wantErr)
+				}
+			case <-time.After(time.Second):
+				t.Fatal("Run did not return")
+			}
+		})
+	}
+}
+
+func TestTranslateEvent(t *testing.T) {
+	var src v4l2Event
+	src.typ = v4l2EventSourceChange
+	src.u[0] = SourceChangeResolution
+
+	e := translateEvent("/dev/video0", &src)
+	if e.Kind != EventSourceChange || e.Changes != SourceChangeResolution {
+		t.Errorf("source change event = %+v", e)
+	}
+
+	var ctrl v4l2Event
+	ctrl.typ = v4l2EventCtrl
+	ctrl.u[8] = 1 // value64 = 1, power present
+
+	e = translateEvent("/dev/video0", &ctrl)
+	if e.Kind != EventPowerPresent || e.Value != 1 {
+		t.Errorf("power present event = %+v", e)
+	}
+}
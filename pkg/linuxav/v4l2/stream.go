@@ -0,0 +1,370 @@
+//go:build linux
+
+package v4l2
+
+import (
+	"errors"
+	"fmt"
+	"syscall"
+	"time"
+	"unsafe"
+)
+
+// DefaultStreamBuffers is the number of driver buffers a Stream requests
+// when StreamConfig.Buffers is zero.
+const DefaultStreamBuffers = 4
+
+// ErrFrameTimeout is returned by Stream.Next when no frame arrives in time.
+var ErrFrameTimeout = errors.New("v4l2: timed out waiting for frame")
+
+// ErrMultiPlanarFormat is returned for formats that store planes in
+// separate buffers (NV12M and similar), which Stream doesn't support.
+var ErrMultiPlanarFormat = errors.New("v4l2: formats with several memory planes are not supported")
+
+// StreamConfig selects the capture format of a Stream.
+type StreamConfig struct {
+	// PixelFormat, Width and Height are requested with VIDIOC_S_FMT. The
+	// driver may pick the closest supported format; check Stream.Format.
+	// A zero PixelFormat keeps the device's current format.
+	PixelFormat uint32
+	Width       uint32
+	Height      uint32
+
+	// Buffers is the number of driver buffers (DefaultStreamBuffers if zero).
+	Buffers int
+
+	// ExportDMABuf exports every buffer as a DMABUF file descriptor, for
+	// handing frames to hardware encoders without copying. Drivers that
+	// can't export leave Frame.DMABufFD at -1.
+	ExportDMABuf bool
+}
+
+// StreamFormat is the format a Stream captures in.
+type StreamFormat struct {
+	PixelFormat  uint32
+	Width        uint32
+	Height       uint32
+	BytesPerLine uint32
+	SizeImage    uint32
+}
+
+// Frame is a captured frame. Data is a view into the driver's buffer,
+// valid until Release; copy it to keep it longer.
+type Frame struct {
+	Data     []byte
+	Sequence uint32 // driver frame counter, gaps mean dropped frames
+
+	// Timestamp is the kernel capture time, on the CLOCK_MONOTONIC clock
+	// when Monotonic is set.
+	Timestamp time.Duration
+	Monotonic bool
+
+	// DMABufFD is the buffer's DMABUF file descriptor, or -1. It is owned by
+	// the Stream and stays valid until Close.
+	DMABufFD int
+
+	stream *Stream
+	index  uint32
+	queued bool
+}
+
+// Release hands the frame's buffer back to the driver.
+func (f *Frame) Release() error {
+	return f.stream.queue(f)
+}
+
+// Stream captures frames from a V4L2 device with memory-mapped driver
+// buffers (VIDIOC_REQBUFS/QBUF/DQBUF), without copying frame data.
+//
+// A Stream is not safe for concurrent use. Frames returned by Next must be
+// released before the driver runs out of buffers; holding all of them stalls
+// capture.
+type Stream struct {
+	fd      int
+	bufType uint32
+	format  StreamFormat
+	frames  []Frame
+	mapped  [][]byte
+	planes  []v4l2Plane // scratch plane for multi-planar buffer ioctls
+	started bool
+}
+
+// OpenStream opens a device for streaming capture and sets up its buffers.
+// Call Start to begin capturing.
+func OpenStream(devicePath string, config StreamConfig) (*Stream, error) {
+	fd, err := open(devicePath)
+	if err != nil {
+		return nil, fmt.Errorf("failed to open device: %w", err)
+	}
+
+	s := &Stream{
+		fd:      fd,
+		bufType: getCaptureBufType(fd),
+		planes:  make([]v4l2Plane, 1),
+	}
+	if err := s.setFormat(config); err != nil {
+		_ = closefd(fd)
+		return nil, err
+	}
+	if err := s.mapBuffers(config); err != nil {
+		_ = s.Close()
+		return nil, err
+	}
+	return s, nil
+}
+
+// Format returns the format negotiated with the driver.
+func (s *Stream) Format() StreamFormat {
+	return s.format
+}
+
+func (s *Stream) mplane() bool {
+	return s.bufType == v4l2BufTypeVideoCaptureMplane
+}
+
+// setFormat applies the requested format, or reads the current one.
+func (s *Stream) setFormat(config StreamConfig) error {
+	format := v4l2Format{typ: s.bufType}
+	if err := ioctl(s.fd, vidiocGFmt, unsafe.Pointer(&format)); err != nil {
+		return fmt.Errorf("failed to get format: %w", err)
+	}
+
+	if config.PixelFormat != 0 {
+		if s.mplane() {
+			pix := format.pixMp()
+			pix.pixelformat = config.PixelFormat
+			pix.width, pix.height = config.Width, config.Height
+		} else {
+			pix := format.pix()
+			pix.pixelformat = config.PixelFormat
+			pix.width, pix.height = config.Width, config.Height
+		}
+		if err := ioctl(s.fd, vidiocSFmt, unsafe.Pointer(&format)); err != nil {
+			return fmt.Errorf("failed to set format %s %dx%d: %w",
+				FormatFourCC(config.PixelFormat), config.Width, config.Height, err)
+		}
+	}
+
+	if s.mplane() {
+		pix := format.pixMp()
+		if pix.numPlanes > 1 {
+			return ErrMultiPlanarFormat
+		}
+		s.format = StreamFormat{
+			PixelFormat:  pix.pixelformat,
+			Width:        pix.width,
+			Height:       pix.height,
+			BytesPerLine: pix.planeFmt[0].bytesperline,
+			SizeImage:    pix.planeFmt[0].sizeimage,
+		}
+	} else {
+		pix := format.pix()
+		s.format = StreamFormat{
+			PixelFormat:  pix.pixelformat,
+			Width:        pix.width,
+			Height:       pix.height,
+			BytesPerLine: pix.bytesperline,
+			SizeImage:    pix.sizeimage,
+		}
+	}
+	return nil
+}
+
+// mapBuffers requests driver buffers and maps them into memory.
+func (s *Stream) mapBuffers(config StreamConfig) error {
+	count := config.Buffers
+	if count <= 0 {
+		count = DefaultStreamBuffers
+	}
+
+	req := v4l2RequestBuffers{count: uint32(count), typ: s.bufType, memory: v4l2MemoryMmap}
+	if err := ioctl(s.fd, vidiocReqbufs, unsafe.Pointer(&req)); err != nil {
+		return fmt.Errorf("failed to request buffers: %w", err)
+	}
+	if req.count == 0 {
+		return fmt.Errorf("failed to request buffers: driver allocated none")
+	}
+
+	s.frames = make([]Frame, req.count)
+	s.mapped = make([][]byte, 0, req.count)
+	for i := range s.frames {
+		buf := s.buffer(uint32(i))
+		if err := ioctl(s.fd, vidiocQuerybuf, unsafe.Pointer(&buf)); err != nil {
+			return fmt.Errorf("failed to query buffer %d: %w", i, err)
+		}
+
+		offset, length := s.bufferLocation(&buf)
+		data, err := syscall.Mmap(s.fd, offset, length, syscall.PROT_READ|syscall.PROT_WRITE, syscall.MAP_SHARED)
+		if err != nil {
+			return fmt.Errorf("failed to map buffer %d: %w", i, err)
+		}
+		s.mapped = append(s.mapped, data)
+
+		s.frames[i] = Frame{stream: s, index: uint32(i), DMABufFD: -1}
+		if config.ExportDMABuf {
+			s.frames[i].DMABufFD = s.exportBuffer(uint32(i))
+		}
+	}
+	return nil
+}
+
+// exportBuffer returns a DMABUF file descriptor for a buffer, or -1 if the
+// driver doesn't support VIDIOC_EXPBUF.
+func (s *Stream) exportBuffer(index uint32) int {
+	export := v4l2ExportBuffer{typ: s.bufType, index: index, flags: syscall.O_CLOEXEC | syscall.O_RDONLY}
+	if err := ioctl(s.fd, vidiocExpbuf, unsafe.Pointer(&export)); err != nil {
+		return -1
+	}
+	return int(export.fd)
+}
+
+// buffer returns a buffer descriptor for an ioctl. Multi-planar buffers
+// point at the stream's scratch plane.
+func (s *Stream) buffer(index uint32) v4l2Buffer {
+	buf := v4l2Buffer{index: index, typ: s.bufType, memory: v4l2MemoryMmap}
+	if s.mplane() {
+		s.planes[0] = v4l2Plane{}
+		// The planes slice is owned by the Stream, so the pointer stays valid
+		buf.m = uintptr(unsafe.Pointer(&s.planes[0]))
+		buf.length = uint32(len(s.planes))
+	}
+	return buf
+}
+
+// bufferLocation returns the mmap offset and length of a queried buffer.
+func (s *Stream) bufferLocation(buf *v4l2Buffer) (int64, int) {
+	if s.mplane() {
+		return int64(uint32(s.planes[0].m)), int(s.planes[0].length)
+	}
+	return int64(uint32(buf.m)), int(buf.length)
+}
+
+// Start queues all buffers and starts capturing.
+func (s *Stream) Start() error {
+	if s.started {
+		return nil
+	}
+	for i := range s.frames {
+		if err := s.queue(&s.frames[i]); err != nil {
+			return err
+		}
+	}
+
+	bufType := s.bufType
+	if err := ioctl(s.fd, vidiocStreamon, unsafe.Pointer(&bufType)); err != nil {
+		return fmt.Errorf("failed to start streaming: %w", err)
+	}
+	s.started = true
+	return nil
+}
+
+func (s *Stream) queue(frame *Frame) error {
+	if frame.queued {
+		return nil
+	}
+	buf := s.buffer(frame.index)
+	if err := ioctl(s.fd, vidiocQbuf, unsafe.Pointer(&buf)); err != nil {
+		return fmt.Errorf("failed to queue buffer %d: %w", frame.index, err)
+	}
+	frame.queued = true
+	frame.Data = nil
+	return nil
+}
+
+// Next waits up to timeout for the next frame. A zero timeout waits
+// forever. Frames the driver marks as corrupted are requeued and skipped.
+// The returned frame must be released with Frame.Release.
+func (s *Stream) Next(timeout time.Duration) (*Frame, error) {
+	var deadline time.Time
+	if timeout > 0 {
+		deadline = time.Now().Add(timeout)
+	}
+
+	for {
+		buf := s.buffer(0)
+		err := ioctl(s.fd, vidiocDqbuf, unsafe.Pointer(&buf))
+		if errors.Is(err, syscall.EAGAIN) {
+			if err := s.wait(deadline); err != nil {
+				return nil, err
+			}
+			continue
+		}
+		if err != nil {
+			return nil, fmt.Errorf("failed to dequeue buffer: %w", err)
+		}
+
+		frame := &s.frames[buf.index]
+		frame.queued = false
+		if buf.flags&v4l2BufFlagError != 0 {
+			if err := s.queue(frame); err != nil {
+				return nil, err
+			}
+			continue
+		}
+
+		used := buf.bytesused
+		if s.mplane() {
+			used = s.planes[0].bytesused
+		}
+		frame.Data = s.mapped[buf.index][:used]
+		frame.Sequence = buf.sequence
+		frame.Timestamp = time.Duration(buf.timestamp.Nano())
+		frame.Monotonic = buf.flags&v4l2BufFlagTimestampMask == v4l2BufFlagTimestampMono
+		return frame, nil
+	}
+}
+
+// wait blocks until the device has a frame ready or the deadline passes.
+func (s *Stream) wait(deadline time.Time) error {
+	var readFds syscall.FdSet
+	readFds.Bits[s.fd/64] |= 1 << (uint(s.fd) % 64)
+
+	var tv *syscall.Timeval
+	if !deadline.IsZero() {
+		remaining := time.Until(deadline)
+		if remaining <= 0 {
+			return ErrFrameTimeout
+		}
+		tv = makeTimeval(int(remaining.Milliseconds()) + 1)
+	}
+
+	n, err := syscall.Select(s.fd+1, &readFds, nil, nil, tv)
+	if errors.Is(err, syscall.EINTR) {
+		return nil
+	}
+	if err != nil {
+		return err
+	}
+	if n == 0 {
+		return ErrFrameTimeout
+	}
+	return nil
+}
+
+// Close stops capturing and releases the buffers and the device.
+// Frames from Next must not be used afterwards.
+func (s *Stream) Close() error {
+	if s.started {
+		bufType := s.bufType
+		_ = ioctl(s.fd, vidiocStreamoff, unsafe.Pointer(&bufType))
+		s.started = false
+	}
+
+	for i := range s.frames {
+		if s.frames[i].DMABufFD >= 0 {
+			_ = closefd(s.frames[i].DMABufFD)
+			s.frames[i].DMABufFD = -1
+		}
+		s.frames[i].Data = nil
+	}
+	for _, data := range s.mapped {
+		_ = syscall.Munmap(data)
+	}
+	s.mapped = nil
+
+	// Free the driver buffers so the device can be reconfigured
+	req := v4l2RequestBuffers{count: 0, typ: s.bufType, memory: v4l2MemoryMmap}
+	_ = ioctl(s.fd, vidiocReqbufs, unsafe.Pointer(&req))
+
+	return closefd(s.fd)
+}
@@ -97,6 +97,15 @@ const (
 	v4l2PixFmtNV12  = 0x3231564E // 'NV12'
 )
 
+// Pixel formats for StreamConfig.
+const (
+	PixelFormatYUYV  uint32 = v4l2PixFmtYUYV
+	PixelFormatMJPEG uint32 = v4l2PixFmtMJPEG
+	PixelFormatH264  uint32 = v4l2PixFmtH264
+	PixelFormatHEVC  uint32 = v4l2PixFmtHEVC
+	PixelFormatNV12  uint32 = v4l2PixFmtNV12
+)
+
 // Frame size types.
 const (
 	v4l2FrmsizeTypeDiscrete   = 1
@@ -117,7 +126,30 @@ const (
 	v4l2BufTypeVideoCaptureMplane = 9
 )
 
+// Memory types.
+const (
+	v4l2MemoryMmap = 1
+)
+
+// Buffer flags.
+const (
+	v4l2BufFlagError         = 0x00000040
+	v4l2BufFlagTimestampMask = 0x0000e000
+	v4l2BufFlagTimestampMono = 0x00002000
+)
+
 // Event types.
 const (
+	v4l2EventCtrl         = 3
 	v4l2EventSourceChange = 5
 )
+
+// Event subscription flags.
+const (
+	v4l2EventSubFlSendInitial = 0x0001
+)
+
+// Controls watched for events.
+const (
+	v4l2CidDVRxPowerPresent = 0x00a00964 // V4L2_CID_DV_CLASS_BASE + 100
+)
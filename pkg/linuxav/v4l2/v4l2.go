@@ -1,7 +1,8 @@
 //go:build linux
 
 // Package v4l2 provides pure Go bindings to the Video4Linux2 (V4L2) API
-// for device enumeration, format queries, and signal detection.
+// for device enumeration, format queries, signal detection and streaming
+// capture.
 //
 // This package does not use cgo, enabling simple cross-compilation for
 // different Linux architectures (amd64, arm64, arm).
@@ -44,4 +45,27 @@
 //	if err == nil && changes > 0 {
 //	    // Resolution or signal changed
 //	}
+//
+// To watch many devices, register them with an EventMux. One goroutine
+// and one epoll instance wait for source change and 5V power events on all
+// of them:
+//
+//	mux, _ := v4l2.NewEventMux(func(e v4l2.DeviceEvent) {
+//	    // e.DevicePath changed, query its timings
+//	})
+//	go mux.Run(ctx)
+//	_ = mux.Add("/dev/video0")
+//
+// # Streaming Capture
+//
+// Capture frames from memory-mapped driver buffers without copying:
+//
+//	stream, err := v4l2.OpenStream("/dev/video0", v4l2.StreamConfig{
+//	    PixelFormat: v4l2.PixelFormatMJPEG, Width: 1280, Height: 720,
+//	})
+//	defer stream.Close()
+//	_ = stream.Start()
+//	frame, err := stream.Next(time.Second)
+//	// frame.Data is valid until Release
+//	_ = frame.Release()
 package v4l2
@@ -7,6 +7,7 @@ import (
 	"math"
 	"syscall"
 	"testing"
+	"unsafe"
 )
 
 // TestErrnoComparison verifies that errors.Is works correctly with syscall.Errno.
@@ -424,3 +425,43 @@ func TestCalculateFPS(t *testing.T) {
 		})
 	}
 }
+
+func TestStreamBufferDescriptor(t *testing.T) {
+	tests := []struct {
+		name       string
+		bufType    uint32
+		wantPlanes uint32
+	}{
+		{name: "single-planar carries no planes", bufType: v4l2BufTypeVideoCapture, wantPlanes: 0},
+		{name: "multiplanar points at scratch plane", bufType: v4l2BufTypeVideoCaptureMplane, wantPlanes: 1},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			s := &Stream{bufType: tt.bufType, planes: make([]v4l2Plane, 1)}
+			buf := s.buffer(3)
+
+			if buf.index != 3 || buf.typ != tt.bufType || buf.memory != v4l2MemoryMmap {
+				t.Errorf("buffer(3) = index %d type %d memory %d", buf.index, buf.typ, buf.memory)
+			}
+			if buf.length != tt.wantPlanes {
+				t.Errorf("length = %d, want %d", buf.length, tt.wantPlanes)
+			}
+			if tt.wantPlanes > 0 && buf.m != uintptr(unsafe.Pointer(&s.planes[0])) {
+				t.Error("multiplanar buffer should point at the stream's plane array")
+			}
+		})
+	}
+}
+
+func TestStreamBufferLocation(t *testing.T) {
+	s := &Stream{bufType: v4l2BufTypeVideoCaptureMplane, planes: []v4l2Plane{{length: 4096, m: 0x1000}}}
+	if offset, length := s.bufferLocation(&v4l2Buffer{}); offset != 0x1000 || length != 4096 {
+		t.Errorf("multiplanar location = %#x/%d, want 0x1000/4096", offset, length)
+	}
+
+	s = &Stream{bufType: v4l2BufTypeVideoCapture}
+	if offset, length := s.bufferLocation(&v4l2Buffer{m: 0x2000, length: 8192}); offset != 0x2000 || length != 8192 {
+		t.Errorf("single-planar location = %#x/%d, want 0x2000/8192", offset, length)
+	}
+}
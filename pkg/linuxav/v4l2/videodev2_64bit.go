@@ -2,7 +2,10 @@
 
 package v4l2
 
-import "unsafe"
+import (
+	"syscall"
+	"unsafe"
+)
 
 // Compile-time struct size and offset assertions.
 // These fail at compile time if struct layout doesn't match kernel ABI.
@@ -19,10 +22,22 @@ var (
 	_ [0]struct{} = [unsafe.Sizeof(v4l2BTTimings{}) - 128]struct{}{}
 	_ [0]struct{} = [unsafe.Sizeof(v4l2DVTimings{}) - 132]struct{}{}
 	_ [0]struct{} = [unsafe.Sizeof(v4l2EventSubscription{}) - 32]struct{}{}
-	_ [0]struct{} = [unsafe.Sizeof(v4l2Event{}) - 132]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2Event{}) - 136]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2PixFormat{}) - 48]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2PixFormatMplane{}) - 192]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2Format{}) - 208]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2RequestBuffers{}) - 20]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2Buffer{}) - 88]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2Plane{}) - 64]struct{}{}
+	_ [0]struct{} = [unsafe.Sizeof(v4l2ExportBuffer{}) - 64]struct{}{}
 
 	// Offset assertions - must match kernel packed struct layout.
 	_ [0]struct{} = [unsafe.Offsetof(v4l2DVTimings{}.btRaw) - 4]struct{}{}
+	_ [0]struct{} = [unsafe.Offsetof(v4l2Format{}.raw) - 8]struct{}{}
+	_ [0]struct{} = [unsafe.Offsetof(v4l2PixFormatMplane{}.numPlanes) - 180]struct{}{}
+	_ [0]struct{} = [unsafe.Offsetof(v4l2Buffer{}.timestamp) - 24]struct{}{}
+	_ [0]struct{} = [unsafe.Offsetof(v4l2Buffer{}.m) - 64]struct{}{}
+	_ [0]struct{} = [unsafe.Offsetof(v4l2Plane{}.m) - 8]struct{}{}
 )
 
 // IOCTL constants for 64-bit architectures.
@@ -36,6 +51,15 @@ const (
 	vidiocSubscribeEvent     = 0x4020565a
 	vidiocUnsubscribeEvent   = 0x4020565b
 	vidiocDqevent            = 0x80885659
+	vidiocGFmt               = 0xc0d05604
+	vidiocSFmt               = 0xc0d05605
+	vidiocReqbufs            = 0xc0145608
+	vidiocQuerybuf           = 0xc0585609
+	vidiocQbuf               = 0xc058560f
+	vidiocExpbuf             = 0xc0405610
+	vidiocDqbuf              = 0xc0585611
+	vidiocStreamon           = 0x40045612
+	vidiocStreamoff          = 0x40045613
 )
 
 // v4l2Capability has size 104 bytes.
@@ -160,6 +184,7 @@ type v4l2Event struct {
 	timestamp [16]byte  // offset 80 - struct timespec
 	id        uint32    // offset 96
 	reserved  [8]uint32 // offset 100
+	_         [4]byte   // offset 132 - tail padding, the kernel struct is 8-byte aligned
 }
 
 // getSrcChangeChanges extracts the changes field from the event union.
@@ -167,3 +192,129 @@ func (e *v4l2Event) getSrcChangeChanges() uint32 {
 	// The changes field is at the start of the union
 	return uint32(e.u[0]) | uint32(e.u[1])<<8 | uint32(e.u[2])<<16 | uint32(e.u[3])<<24
 }
+
+// getCtrlValue extracts the value field of a control event from the union.
+// struct v4l2_event_ctrl: changes at offset 0, type at 4, value64 at 8.
+func (e *v4l2Event) getCtrlValue() int64 {
+	var v uint64
+	for i := 7; i >= 0; i-- {
+		v = v<<8 | uint64(e.u[8+i])
+	}
+	return int64(v)
+}
+
+// v4l2PixFormat has size 48 bytes.
+type v4l2PixFormat struct {
+	width        uint32 // offset 0
+	height       uint32 // offset 4
+	pixelformat  uint32 // offset 8
+	field        uint32 // offset 12
+	bytesperline uint32 // offset 16
+	sizeimage    uint32 // offset 20
+	colorspace   uint32 // offset 24
+	priv         uint32 // offset 28
+	flags        uint32 // offset 32
+	ycbcrEnc     uint32 // offset 36
+	quantization uint32 // offset 40
+	xferFunc     uint32 // offset 44
+}
+
+// v4l2PlanePixFormat has size 20 bytes.
+type v4l2PlanePixFormat struct {
+	sizeimage    uint32    // offset 0
+	bytesperline uint32    // offset 4
+	reserved     [6]uint16 // offset 8
+}
+
+// v4l2PixFormatMplane has size 192 bytes.
+type v4l2PixFormatMplane struct {
+	width        uint32                // offset 0
+	height       uint32                // offset 4
+	pixelformat  uint32                // offset 8
+	field        uint32                // offset 12
+	colorspace   uint32                // offset 16
+	planeFmt     [8]v4l2PlanePixFormat // offset 20
+	numPlanes    uint8                 // offset 180
+	flags        uint8                 // offset 181
+	ycbcrEnc     uint8                 // offset 182
+	quantization uint8                 // offset 183
+	xferFunc     uint8                 // offset 184
+	reserved     [7]uint8              // offset 185
+}
+
+// v4l2Format has size 208 bytes. The kernel union holds pointers, so it
+// starts 8-byte aligned after the type field.
+type v4l2Format struct {
+	typ uint32    // offset 0
+	_   [4]byte   // padding
+	raw [200]byte // offset 8 - union of pix, pix_mp and others
+}
+
+// pix returns the union as a single-planar pixel format.
+func (f *v4l2Format) pix() *v4l2PixFormat {
+	return (*v4l2PixFormat)(unsafe.Pointer(&f.raw[0]))
+}
+
+// pixMp returns the union as a multi-planar pixel format.
+func (f *v4l2Format) pixMp() *v4l2PixFormatMplane {
+	return (*v4l2PixFormatMplane)(unsafe.Pointer(&f.raw[0]))
+}
+
+// v4l2RequestBuffers has size 20 bytes.
+type v4l2RequestBuffers struct {
+	count        uint32   // offset 0
+	typ          uint32   // offset 4
+	memory       uint32   // offset 8
+	capabilities uint32   // offset 12
+	flags        uint8    // offset 16
+	reserved     [3]uint8 // offset 17
+}
+
+// v4l2Timecode has size 16 bytes.
+type v4l2Timecode struct {
+	typ      uint32
+	flags    uint32
+	frames   uint8
+	seconds  uint8
+	minutes  uint8
+	hours    uint8
+	userbits [4]uint8
+}
+
+// v4l2Buffer has size 88 bytes.
+type v4l2Buffer struct {
+	index     uint32          // offset 0
+	typ       uint32          // offset 4
+	bytesused uint32          // offset 8
+	flags     uint32          // offset 12
+	field     uint32          // offset 16
+	_         [4]byte         // padding
+	timestamp syscall.Timeval // offset 24
+	timecode  v4l2Timecode    // offset 40
+	sequence  uint32          // offset 56
+	memory    uint32          // offset 60
+	m         uintptr         // offset 64 - union of offset, userptr, planes and fd
+	length    uint32          // offset 72
+	reserved2 uint32          // offset 76
+	requestFD int32           // offset 80
+	_         [4]byte         // padding
+}
+
+// v4l2Plane has size 64 bytes.
+type v4l2Plane struct {
+	bytesused  uint32     // offset 0
+	length     uint32     // offset 4
+	m          uintptr    // offset 8 - union of mem_offset, userptr and fd
+	dataOffset uint32     // offset 16
+	reserved   [11]uint32 // offset 20
+}
+
+// v4l2ExportBuffer has size 64 bytes.
+type v4l2ExportBuffer struct {
+	typ      uint32     // offset 0
+	index    uint32     // offset 4
+	plane    uint32     // offset 8
+	flags    uint32     // offset 12
+	fd       int32      // offset 16
+	reserved [11]uint32 // offset 20
+}
@@ -0,0 +1,93 @@
+import { useEffect, useState } from 'react';
+import { Card } from './Card';
+import { StreamThumbnail } from './StreamThumbnail';
+import { LiveStreamData, getLiveStreams } from '../lib/api';
+
+const POLL_INTERVAL_MS = 10000;
+
+// RelayedStreams lists the streams this node pulls from upstream nodes,
+// with the upstream each one originates from. Relays are configured in
+// config.toml, so they aren't part of the stream store.
+export function RelayedStreams() {
+  const [relays, setRelays] = useState<LiveStreamData[]>([]);
+
+  useEffect(() => {
+    let cancelled = false;
+    const load = async () => {
+      try {
+        const data = await getLiveStreams();
+        if (!cancelled) setRelays(data.origins.filter((stream) => stream.origin === 'relay'));
+      } catch (error) {
+        console.warn('Failed to fetch live streams:', error);
+      }
+    };
+    load();
+    const timer = window.setInterval(load, POLL_INTERVAL_MS);
+    return () => {
+      cancelled = true;
+      clearInterval(timer);
+    };
+  }, []);
+
+  if (relays.length === 0) return null;
+
+  return (
+    <div className="space-y-4">
+      <div>
+        <h2 className="text-2xl font-bold text-gray-900 dark:text-white">Relayed Streams</h2>
+        <p className="text-gray-600 dark:text-gray-300 mt-1">
+          Pulled from upstream nodes and served to viewers from this node
+        </p>
+      </div>
+
+      <div className="grid grid-cols-1 md:grid-cols-2 lg:grid-cols-3 xl:grid-cols-4 gap-6">
+        {relays.map((relay) => (
+          <Card key={relay.stream_id} className="h-full">
+            <Card.Header className="pb-3">
+              <div className="flex items-center justify-between">
+                <h3 className="text-lg font-semibold text-gray-900 dark:text-white truncate">
+                  {relay.stream_id}
+                </h3>
+                <span className="text-xs bg-amber-100 dark:bg-amber-900 text-amber-800 dark:text-amber-200 px-2 py-1 rounded">
+                  Relay
+                </span>
+              </div>
+            </Card.Header>
+            <Card.Content className="space-y-4">
+              <div className="aspect-video bg-gray-100 dark:bg-gray-800 rounded-lg overflow-hidden">
+                <StreamThumbnail streamId={relay.stream_id} className="w-full h-full" />
+              </div>
+
+              <div className="space-y-2 text-sm">
+                <div className="flex justify-between gap-2">
+                  <span className="text-gray-600 dark:text-gray-300 shrink-0">Origin:</span>
+                  <span className="text-gray-900 dark:text-white font-medium font-mono truncate" title={relay.upstream}>
+                    {relay.upstream}
+                  </span>
+                </div>
+                <div className="flex justify-between">
+                  <span className="text-gray-600 dark:text-gray-300">Codecs:</span>
+                  <span className="text-gray-900 dark:text-white font-medium font-mono uppercase">
+                    {relay.codecs.join(', ')}
+                  </span>
+                </div>
+              </div>
+
+              <div className="flex items-center space-x-2">
+                <a
+                  href={`/video?stream=${encodeURIComponent(relay.stream_id)}`}
+                  className="text-xs bg-blue-100 dark:bg-blue-900 text-blue-800 dark:text-blue-200 px-2 py-1 rounded"
+                >
+                  WebRTC
+                </a>
+                <code className="text-xs text-gray-600 dark:text-gray-300 truncate flex-1">
+                  {`${window.location.origin}/video?stream=${relay.stream_id}`}
+                </code>
+              </div>
+            </Card.Content>
+          </Card>
+        ))}
+      </div>
+    </div>
+  );
+}
@@ -1,9 +1,10 @@
 import { useState, useCallback } from 'react';
 import { Card } from './Card';
-import { WebRTCPlayer } from './webrtc';
+import { BundledPlayer, WebRTCPlayer, useWebRTCBundle } from './webrtc';
 import { FFmpegCommandSheet } from './FFmpegCommandSheet';
 import { StreamCardActions } from './StreamCardActions';
 import { StreamMetrics } from './StreamMetrics';
+import { StreamThumbnail } from './StreamThumbnail';
 import { buildStreamURL } from '../lib/api';
 import { useStreamStore } from '../hooks/useStreamStore';
 
@@ -18,6 +19,8 @@ interface StreamCardProps {
 export function StreamCard({ streamId, onDelete, onRefresh, showVideo = true, className = '' }: Readonly<StreamCardProps>) {
   // Subscribe directly to this stream - only re-renders when THIS stream changes
   const stream = useStreamStore((state) => state.streamsById[streamId]);
+  // Inside a grid, all cards share one bundled connection
+  const bundle = useWebRTCBundle();
 
   const [showFFmpegSheet, setShowFFmpegSheet] = useState(false);
   const [refreshKey, setRefreshKey] = useState(0);
@@ -57,12 +60,23 @@ export function StreamCard({ streamId, onDelete, onRefresh, showVideo = true, cl
         {/* WebRTC Preview Area */}
         {showVideo && (
           <div className="aspect-video bg-gray-100 dark:bg-gray-800 rounded-lg overflow-hidden">
-            <WebRTCPlayer
-              key={refreshKey}
-              streamId={stream.stream_id}
-              className="w-full h-full"
-              showStats={false}
-            />
+            {bundle ? (
+              <BundledPlayer streamId={stream.stream_id} className="w-full h-full" />
+            ) : (
+              <WebRTCPlayer
+                key={refreshKey}
+                streamId={stream.stream_id}
+                className="w-full h-full"
+                showStats={false}
+              />
+            )}
+          </div>
+        )}
+
+        {/* Periodic snapshot when live video is off */}
+        {!showVideo && (
+          <div className="aspect-video bg-gray-100 dark:bg-gray-800 rounded-lg overflow-hidden">
+            <StreamThumbnail streamId={stream.stream_id} className="w-full h-full" />
           </div>
         )}
 
@@ -1,5 +1,9 @@
 import { useEffect, useState } from 'react';
 import { useStreamStore } from '../hooks/useStreamStore';
+import { getMetricsHistory, MetricsHistoryData } from '../lib/api';
+import { BAR_WIDTH, SeriesHistoryBar, getFrameColor } from './webrtc/HistoryBars';
+
+const HISTORY_POLL_MS = 5000;
 
 interface StreamMetricsProps {
   streamId: string;
@@ -26,10 +30,44 @@ function calculateUptime(startTime?: string): string {
   }
 }
 
+function formatBitrate(bps: number): string {
+  if (bps >= 1_000_000) return `${(bps / 1_000_000).toFixed(1)} Mbps`;
+  if (bps >= 1_000) return `${(bps / 1_000).toFixed(0)} Kbps`;
+  return `${bps.toFixed(0)} bps`;
+}
+
+// useMetricsHistory polls the server's history of a stream, so the bars
+// survive reloads and don't depend on how long the page was open.
+function useMetricsHistory(streamId: string): MetricsHistoryData | null {
+  const [history, setHistory] = useState<MetricsHistoryData | null>(null);
+
+  useEffect(() => {
+    let cancelled = false;
+    const load = () => {
+      getMetricsHistory(streamId, BAR_WIDTH, BAR_WIDTH)
+        .then((data) => { if (!cancelled) setHistory(data); })
+        .catch(() => { /* history is optional, keep the last one */ });
+    };
+    load();
+    const interval = setInterval(load, HISTORY_POLL_MS);
+    return () => {
+      cancelled = true;
+      clearInterval(interval);
+    };
+  }, [streamId]);
+
+  return history;
+}
+
 export function StreamMetrics({ streamId }: Readonly<StreamMetricsProps>) {
   const metrics = useStreamStore((state) => state.metricsById[streamId]);
   const startTime = useStreamStore((state) => state.streamsById[streamId]?.start_time);
   const [uptime, setUptime] = useState(() => calculateUptime(startTime));
+  const history = useMetricsHistory(streamId);
+  const fpsHistory = history?.series.fps ?? [];
+  const bitrateHistory = history?.series.egress_bitrate ?? [];
+  const peakBitrate = Math.max(0, ...bitrateHistory);
+  const latestBitrate = bitrateHistory[bitrateHistory.length - 1] ?? 0;
 
   useEffect(() => {
     const interval = setInterval(() => {
@@ -52,12 +90,25 @@ export function StreamMetrics({ streamId }: Readonly<StreamMetricsProps>) {
       {metrics?.fps && (
         <div className="flex justify-between">
           <span className="text-gray-600 dark:text-gray-300">FPS:</span>
-          <span className="text-gray-900 dark:text-white font-medium font-mono">
+          <span className="flex items-center text-gray-900 dark:text-white font-medium font-mono">
+            {fpsHistory.length > 0 && (
+              <SeriesHistoryBar values={fpsHistory} maxValue={30} getColor={getFrameColor} inline />
+            )}
             {metrics.fps}
           </span>
         </div>
       )}
 
+      {peakBitrate > 0 && (
+        <div className="flex justify-between">
+          <span className="text-gray-600 dark:text-gray-300">Egress:</span>
+          <span className="flex items-center text-gray-900 dark:text-white font-medium font-mono">
+            <SeriesHistoryBar values={bitrateHistory} maxValue={peakBitrate} getColor={() => 'bg-blue-500'} inline />
+            {formatBitrate(latestBitrate)}
+          </span>
+        </div>
+      )}
+
       {hasDroppedOrDuplicate && (
         <div className="flex justify-between">
           <span className="text-gray-600 dark:text-gray-300">Dropped / Duplicate:</span>
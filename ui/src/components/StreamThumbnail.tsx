@@ -0,0 +1,44 @@
+import { useEffect, useState } from 'react';
+import { buildThumbnailURL } from '../lib/api';
+
+const REFRESH_INTERVAL_MS = 10000;
+
+interface Props {
+  readonly streamId: string;
+  readonly className?: string;
+}
+
+// StreamThumbnail shows a periodically refreshed snapshot of a stream. The
+// server renders it from the stream's latest keyframe, so polling never
+// touches the capture device.
+export function StreamThumbnail({ streamId, className = '' }: Props) {
+  const [refresh, setRefresh] = useState(() => Date.now());
+  const [failed, setFailed] = useState(false);
+
+  useEffect(() => {
+    const timer = window.setInterval(() => setRefresh(Date.now()), REFRESH_INTERVAL_MS);
+    return () => clearInterval(timer);
+  }, []);
+
+  const url = buildThumbnailURL(streamId, refresh);
+
+  return (
+    <div className={`relative ${className}`} style={{ background: '#000' }}>
+      {url && (
+        <img
+          src={url}
+          alt={`${streamId} preview`}
+          className="w-full h-full object-contain"
+          style={{ visibility: failed ? 'hidden' : 'visible' }}
+          onLoad={() => setFailed(false)}
+          onError={() => setFailed(true)}
+        />
+      )}
+      {(failed || !url) && (
+        <div className="absolute inset-0 flex items-center justify-center">
+          <span className="text-gray-400 text-sm">No preview</span>
+        </div>
+      )}
+    </div>
+  );
+}
@@ -2,6 +2,7 @@ import { useState, useEffect } from 'react';
 import { StreamCard } from './StreamCard';
 import { Button } from './Button';
 import { Card } from './Card';
+import { WebRTCBundleProvider } from './webrtc';
 
 const SHOW_VIDEOS_KEY = 'streamGrid.showVideos';
 
@@ -33,18 +34,21 @@ export function StreamsGrid({
     localStorage.setItem(SHOW_VIDEOS_KEY, String(showVideos));
   }, [showVideos]);
 
+  // All previews share one bundled WebRTC connection
   const renderGridView = () => (
-    <div className="grid grid-cols-1 md:grid-cols-2 lg:grid-cols-3 xl:grid-cols-4 gap-6">
-      {streamIds.map((streamId) => (
-        <StreamCard
-          key={streamId}
-          streamId={streamId}
-          showVideo={showVideos}
-          {...(onDeleteStream && { onDelete: onDeleteStream })}
-          {...(onRefresh && { onRefresh })}
-        />
-      ))}
-    </div>
+    <WebRTCBundleProvider streamIds={showVideos ? streamIds : []}>
+      <div className="grid grid-cols-1 md:grid-cols-2 lg:grid-cols-3 xl:grid-cols-4 gap-6">
+        {streamIds.map((streamId) => (
+          <StreamCard
+            key={streamId}
+            streamId={streamId}
+            showVideo={showVideos}
+            {...(onDeleteStream && { onDelete: onDeleteStream })}
+            {...(onRefresh && { onRefresh })}
+          />
+        ))}
+      </div>
+    </WebRTCBundleProvider>
   );
 
 
@@ -1,6 +1,6 @@
 import type { StatsSample, QualityScore } from './types';
 
-const BAR_WIDTH = 16;
+export const BAR_WIDTH = 16;
 
 function getQualityColor(quality: QualityScore): string {
   switch (quality) {
@@ -12,7 +12,7 @@ function getQualityColor(quality: QualityScore): string {
   }
 }
 
-function getFrameColor(frames: number): string {
+export function getFrameColor(frames: number): string {
   if (frames >= 25) return 'bg-green-500';
   if (frames >= 15) return 'bg-yellow-500';
   if (frames > 0) return 'bg-red-500';
@@ -28,33 +28,29 @@ interface HistoryBarProps {
   readonly inline?: boolean;
 }
 
-export function HistoryBar({
-  samples,
-  getValue,
-  maxValue,
-  getColor = (s) => getQualityColor(s.quality),
-  label,
-  inline,
-}: HistoryBarProps) {
-  const recentSamples = samples.slice(-BAR_WIDTH);
-  const emptySlots = Math.max(0, BAR_WIDTH - recentSamples.length);
+interface BarsProps {
+  readonly ratios: number[];
+  readonly colors: string[];
+  readonly inline?: boolean;
+}
 
-  const bars = (
+function Bars({ ratios, colors, inline }: BarsProps) {
+  const emptySlots = Math.max(0, BAR_WIDTH - ratios.length);
+  return (
     <div className={`flex h-3 ${inline ? 'mr-2 inline-flex' : ''}`}>
       {Array.from({ length: emptySlots }).map((_, i) => (
         <div key={`empty-${i}`} className="w-2 h-full bg-gray-700" />
       ))}
-      {recentSamples.map((sample, i) => {
-        const ratio = Math.min(getValue(sample) / maxValue, 1);
-        return (
-          <div key={`sample-${i}`} className="w-2 h-full bg-gray-700 overflow-hidden flex flex-col-reverse">
-            <div className={`w-full ${getColor(sample)}`} style={{ height: `${ratio * 100}%` }} />
-          </div>
-        );
-      })}
+      {ratios.map((ratio, i) => (
+        <div key={`sample-${i}`} className="w-2 h-full bg-gray-700 overflow-hidden flex flex-col-reverse">
+          <div className={`w-full ${colors[i]}`} style={{ height: `${ratio * 100}%` }} />
+        </div>
+      ))}
     </div>
   );
+}
 
+function withLabel(bars: React.ReactNode, label?: string) {
   if (!label) return bars;
 
   return (
@@ -65,6 +61,46 @@ export function HistoryBar({
   );
 }
 
+export function HistoryBar({
+  samples,
+  getValue,
+  maxValue,
+  getColor = (s) => getQualityColor(s.quality),
+  label,
+  inline,
+}: HistoryBarProps) {
+  const recentSamples = samples.slice(-BAR_WIDTH);
+  const bars = (
+    <Bars
+      ratios={recentSamples.map((s) => Math.min(getValue(s) / maxValue, 1))}
+      colors={recentSamples.map(getColor)}
+      inline={inline}
+    />
+  );
+  return withLabel(bars, label);
+}
+
+interface SeriesHistoryBarProps {
+  readonly values: number[];
+  readonly maxValue: number;
+  readonly getColor: (value: number) => string;
+  readonly label?: string;
+  readonly inline?: boolean;
+}
+
+// SeriesHistoryBar draws the latest points of a server-side metrics history series.
+export function SeriesHistoryBar({ values, maxValue, getColor, label, inline }: SeriesHistoryBarProps) {
+  const recentValues = values.slice(-BAR_WIDTH);
+  const bars = (
+    <Bars
+      ratios={recentValues.map((v) => (maxValue > 0 ? Math.min(v / maxValue, 1) : 0))}
+      colors={recentValues.map(getColor)}
+      inline={inline}
+    />
+  );
+  return withLabel(bars, label);
+}
+
 export function FramesHistoryBar({ samples }: { readonly samples: StatsSample[] }) {
   return (
     <HistoryBar
@@ -0,0 +1,230 @@
+import { createContext, useContext, useEffect, useRef, useState } from 'react';
+import type { ReactNode } from 'react';
+import { closeWebRTCBundle, webrtcBundleRenegotiate, webrtcBundleSignaling } from '../../lib/api';
+
+const RECONNECT_DELAY_MS = 2000;
+const ICE_GATHER_TIMEOUT_MS = 2000;
+
+type ConnectionState = 'connecting' | 'connected' | 'offline';
+
+interface BundleContextValue {
+  state: ConnectionState;
+  streams: Readonly<Record<string, MediaStream>>;
+}
+
+const BundleContext = createContext<BundleContextValue | null>(null);
+
+// useWebRTCBundle returns the enclosing bundle, or null outside a provider.
+export function useWebRTCBundle(): BundleContextValue | null {
+  return useContext(BundleContext);
+}
+
+// assignSlots keeps streams on the slot they already play on, so their video
+// doesn't blink, and puts new streams on free slots before adding new ones.
+function assignSlots(current: readonly string[], streamIds: readonly string[]): string[] {
+  const slots = current.map((id) => (streamIds.includes(id) ? id : ''));
+  for (const id of streamIds) {
+    if (slots.includes(id)) continue;
+    const free = slots.indexOf('');
+    if (free >= 0) slots[free] = id;
+    else slots.push(id);
+  }
+  return slots;
+}
+
+function waitForIceGathering(pc: RTCPeerConnection, timeoutMs: number): Promise<void> {
+  return new Promise((resolve) => {
+    if (pc.iceGatheringState === 'complete') {
+      resolve();
+      return;
+    }
+    const onStateChange = () => {
+      if (pc.iceGatheringState === 'complete') {
+        pc.removeEventListener('icegatheringstatechange', onStateChange);
+        resolve();
+      }
+    };
+    pc.addEventListener('icegatheringstatechange', onStateChange);
+    setTimeout(resolve, timeoutMs);
+  });
+}
+
+interface Props {
+  readonly streamIds: readonly string[];
+  readonly children: ReactNode;
+}
+
+// WebRTCBundleProvider plays all streamIds over a single PeerConnection, one
+// video transceiver per slot. Changing streamIds renegotiates the connection
+// instead of opening a new one per stream.
+export function WebRTCBundleProvider({ streamIds, children }: Props) {
+  const pcRef = useRef<RTCPeerConnection | null>(null);
+  const sessionUrlRef = useRef<string | null>(null);
+  const slotsRef = useRef<string[]>([]);
+  const slotStreamsRef = useRef<Map<string, MediaStream>>(new Map()); // mid -> stream
+  const queueRef = useRef<Promise<void>>(Promise.resolve());
+  const cancelledRef = useRef(false);
+  const reconnectTimerRef = useRef<number | null>(null);
+  const wantedRef = useRef<readonly string[]>(streamIds);
+
+  const [state, setState] = useState<ConnectionState>('connecting');
+  const [streams, setStreams] = useState<Record<string, MediaStream>>({});
+
+  const key = streamIds.join(',');
+
+  useEffect(() => {
+    cancelledRef.current = false;
+    return () => {
+      cancelledRef.current = true;
+      if (reconnectTimerRef.current) clearTimeout(reconnectTimerRef.current);
+      pcRef.current?.close();
+      pcRef.current = null;
+      if (sessionUrlRef.current) void closeWebRTCBundle(sessionUrlRef.current);
+      sessionUrlRef.current = null;
+    };
+  }, []);
+
+  useEffect(() => {
+    wantedRef.current = streamIds;
+
+    const publishStreams = (pc: RTCPeerConnection) => {
+      const next: Record<string, MediaStream> = {};
+      const videoTransceivers = pc.getTransceivers().filter((t) => t.receiver.track.kind === 'video');
+      videoTransceivers.forEach((transceiver, slot) => {
+        const id = slotsRef.current[slot];
+        const stream = transceiver.mid ? slotStreamsRef.current.get(transceiver.mid) : undefined;
+        if (id && stream) next[id] = stream;
+      });
+      setStreams(next);
+    };
+
+    const reset = () => {
+      pcRef.current?.close();
+      pcRef.current = null;
+      if (sessionUrlRef.current) void closeWebRTCBundle(sessionUrlRef.current);
+      sessionUrlRef.current = null;
+      slotsRef.current = [];
+      slotStreamsRef.current.clear();
+      setStreams({});
+    };
+
+    const scheduleReconnect = () => {
+      if (reconnectTimerRef.current || cancelledRef.current) return;
+      reconnectTimerRef.current = window.setTimeout(() => {
+        reconnectTimerRef.current = null;
+        if (cancelledRef.current) return;
+        reset();
+        queueRef.current = queueRef.current.then(sync);
+      }, RECONNECT_DELAY_MS);
+    };
+
+    const createConnection = (): RTCPeerConnection => {
+      const pc = new RTCPeerConnection({ iceServers: [] });
+      pc.ontrack = (e) => {
+        if (!e.transceiver.mid) return;
+        slotStreamsRef.current.set(e.transceiver.mid, new MediaStream([e.track]));
+        publishStreams(pc);
+      };
+      pc.onconnectionstatechange = () => {
+        if (cancelledRef.current || pcRef.current !== pc) return;
+        if (pc.connectionState === 'connected') {
+          setState('connected');
+        } else if (pc.connectionState === 'failed' || pc.connectionState === 'disconnected') {
+          setState('offline');
+          scheduleReconnect();
+        }
+      };
+      return pc;
+    };
+
+    // sync brings the connection in line with the latest wanted streams.
+    // Calls are chained through queueRef so offers never overlap.
+    async function sync(): Promise<void> {
+      const wanted = wantedRef.current;
+      if (cancelledRef.current) return;
+      if (wanted.length === 0 && !pcRef.current) return;
+
+      const slots = assignSlots(slotsRef.current, wanted);
+      if (pcRef.current && slots.join(',') === slotsRef.current.join(',')) return;
+
+      const pc = pcRef.current ?? createConnection();
+      const isNew = pcRef.current === null;
+      pcRef.current = pc;
+
+      const videoCount = pc.getTransceivers().filter((t) => t.receiver.track.kind === 'video').length;
+      for (let i = videoCount; i < slots.length; i++) {
+        pc.addTransceiver('video', { direction: 'recvonly' });
+      }
+
+      try {
+        const offer = await pc.createOffer();
+        await pc.setLocalDescription(offer);
+        await waitForIceGathering(pc, ICE_GATHER_TIMEOUT_MS);
+        if (cancelledRef.current || pcRef.current !== pc) return;
+
+        let answer: string;
+        if (isNew) {
+          setState('connecting');
+          const result = await webrtcBundleSignaling(slots, pc.localDescription!.sdp);
+          sessionUrlRef.current = result.sessionUrl;
+          answer = result.answer;
+        } else {
+          answer = await webrtcBundleRenegotiate(sessionUrlRef.current!, slots, pc.localDescription!.sdp);
+        }
+        if (cancelledRef.current || pcRef.current !== pc) return;
+
+        await pc.setRemoteDescription({ type: 'answer', sdp: answer });
+        slotsRef.current = slots;
+        publishStreams(pc);
+      } catch (error_) {
+        console.error('WebRTC bundle: negotiation failed', error_);
+        if (!cancelledRef.current) {
+          setState('offline');
+          scheduleReconnect();
+        }
+      }
+    }
+
+    queueRef.current = queueRef.current.then(sync);
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [key]);
+
+  return <BundleContext.Provider value={{ state, streams }}>{children}</BundleContext.Provider>;
+}
+
+interface PlayerProps {
+  readonly streamId: string;
+  readonly className?: string;
+}
+
+// BundledPlayer shows one stream of the enclosing WebRTCBundleProvider.
+export function BundledPlayer({ streamId, className = '' }: PlayerProps) {
+  const bundle = useWebRTCBundle();
+  const videoRef = useRef<HTMLVideoElement>(null);
+  const stream = bundle?.streams[streamId] ?? null;
+
+  useEffect(() => {
+    const video = videoRef.current;
+    if (!video || video.srcObject === stream) return;
+    video.srcObject = stream;
+    if (stream) video.play().catch(() => undefined);
+  }, [stream]);
+
+  const state = bundle?.state ?? 'offline';
+
+  return (
+    <div className={`relative ${className}`} style={{ background: '#000' }}>
+      <video ref={videoRef} autoPlay playsInline muted className="w-full h-full object-contain" />
+      {state === 'offline' && (
+        <div className="absolute inset-0 flex items-center justify-center">
+          <span className="text-gray-400 text-sm">Stream offline</span>
+        </div>
+      )}
+      {state === 'connecting' && (
+        <div className="absolute inset-0 flex items-center justify-center">
+          <span className="text-gray-400 text-sm">Connecting...</span>
+        </div>
+      )}
+    </div>
+  );
+}
@@ -1,6 +1,7 @@
 import { useEffect, useRef, useState } from 'react';
 import { webrtcSignaling } from '../../lib/api';
 import { StatsOverlay } from './StatsOverlay';
+import { useLatencyReporter } from './useLatencyReporter';
 
 const RECONNECT_DELAY_MS = 2000;
 const ICE_GATHER_TIMEOUT_MS = 2000;
@@ -101,6 +102,8 @@ export function WebRTCPlayer({ streamId, className = '', muted = true, showStats
   const [connectionState, setConnectionState] = useState<ConnectionState>('connecting');
   const [playBlocked, setPlayBlocked] = useState(false);
 
+  useLatencyReporter(videoRef, peerId, connectionState === 'connected');
+
   useEffect(() => {
     if (typeof RTCPeerConnection === 'undefined') {
       queueMicrotask(() => setError('WebRTC not supported in this browser'));
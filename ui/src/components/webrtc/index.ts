@@ -1,3 +1,4 @@
 export { WebRTCPlayer } from './WebRTCPlayer';
+export { WebRTCBundleProvider, BundledPlayer, useWebRTCBundle } from './WebRTCBundle';
 export { StatsOverlay } from './StatsOverlay';
 export type { WebRTCStats, QualityScore, StatsSample } from './types';
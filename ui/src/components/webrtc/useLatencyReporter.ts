@@ -0,0 +1,78 @@
+import { useEffect } from 'react';
+import { reportWebRTCLatency, type LatencySampleReport } from '../../lib/api';
+
+const REPORT_INTERVAL_MS = 2000;
+const MAX_SAMPLES_PER_REPORT = 240;
+
+// Reports when each frame of a WebRTC session was received, decoded and
+// displayed, from requestVideoFrameCallback, so the server can complete its
+// glass-to-glass latency metrics. Times are converted to the server's clock
+// with an offset estimated from the report round trips (the one with the
+// lowest round trip wins). Stops once the server declines a report, e.g.
+// when latency tracing is disabled.
+export function useLatencyReporter(
+  videoRef: React.RefObject<HTMLVideoElement | null>,
+  peerId: string | null,
+  enabled: boolean
+): void {
+  useEffect(() => {
+    const video = videoRef.current;
+    if (!enabled || !peerId || !video || !('requestVideoFrameCallback' in video)) return;
+
+    let stopped = false;
+    let frameHandle = 0;
+    let samples: LatencySampleReport[] = [];
+    let clockOffset: number | null = null; // server minus browser wallclock, in ms
+    let bestRoundTrip = Infinity;
+    let timer = 0;
+
+    const toServerTime = (t: DOMHighResTimeStamp) => performance.timeOrigin + t + (clockOffset ?? 0);
+
+    const onFrame = (_now: DOMHighResTimeStamp, metadata: VideoFrameCallbackMetadata) => {
+      if (stopped) return;
+      // Only WebRTC frames carry RTP timestamps and receive times
+      if (
+        clockOffset !== null &&
+        metadata.rtpTimestamp !== undefined &&
+        metadata.receiveTime !== undefined &&
+        samples.length < MAX_SAMPLES_PER_REPORT
+      ) {
+        samples.push({
+          rtp_timestamp: metadata.rtpTimestamp,
+          received_at: toServerTime(metadata.receiveTime),
+          displayed_at: toServerTime(metadata.expectedDisplayTime),
+          decode_ms: (metadata.processingDuration ?? 0) * 1000,
+        });
+      }
+      frameHandle = video.requestVideoFrameCallback(onFrame);
+    };
+
+    const stop = () => {
+      stopped = true;
+      window.clearInterval(timer);
+      video.cancelVideoFrameCallback(frameHandle);
+    };
+
+    const report = async () => {
+      const batch = samples;
+      samples = [];
+      const sentAt = performance.now();
+      try {
+        const { server_time: serverTime } = await reportWebRTCLatency({ session_id: peerId, samples: batch });
+        const receivedAt = performance.now();
+        if (receivedAt - sentAt <= bestRoundTrip) {
+          bestRoundTrip = receivedAt - sentAt;
+          clockOffset = serverTime - (performance.timeOrigin + (sentAt + receivedAt) / 2);
+        }
+      } catch {
+        stop();
+      }
+    };
+
+    timer = window.setInterval(report, REPORT_INTERVAL_MS);
+    frameHandle = video.requestVideoFrameCallback(onFrame);
+    report(); // the first, empty report estimates the clock offset
+
+    return stop;
+  }, [videoRef, peerId, enabled]);
+}
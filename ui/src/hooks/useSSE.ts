@@ -5,6 +5,8 @@ export interface UseSSEOptions {
   endpoint: string;
   onMessage?: (event: MessageEvent) => void;
   onConnect?: () => void;
+  // Extra query parameters, evaluated on every (re)connect
+  query?: () => Record<string, string>;
   enabled?: boolean;
 }
 
@@ -15,18 +17,20 @@ export interface UseSSEResult {
 }
 
 export function useSSE(options: UseSSEOptions): UseSSEResult {
-  const { endpoint, onMessage, onConnect, enabled = true } = options;
+  const { endpoint, onMessage, onConnect, query, enabled = true } = options;
   const [status, setStatus] = useState<SSEStatus>('disconnected');
   const clientRef = useRef<SSEClient | null>(null);
 
   // Store callbacks in refs to avoid recreating client on callback changes
   const onMessageRef = useRef(onMessage);
   const onConnectRef = useRef(onConnect);
+  const queryRef = useRef(query);
 
   // Sync refs in effect to avoid updating during render
   useEffect(() => {
     onMessageRef.current = onMessage;
     onConnectRef.current = onConnect;
+    queryRef.current = query;
   });
 
   useEffect(() => {
@@ -36,6 +40,7 @@ export function useSSE(options: UseSSEOptions): UseSSEResult {
       endpoint,
       onStatusChange: setStatus,
       onConnect: () => onConnectRef.current?.(),
+      query: () => queryRef.current?.() ?? {},
     });
 
     if (onMessageRef.current) {
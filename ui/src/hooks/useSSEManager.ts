@@ -36,11 +36,17 @@ interface StreamUpdatedData {
   timestamp: string;
 }
 
-interface StreamMetricsData {
-  stream_id: string;
-  fps?: string;
-  dropped_frames?: string;
-  duplicate_frames?: string;
+// Metrics of one stream in a batch; fields that didn't change are omitted
+interface StreamMetricsDelta {
+  fps?: number;
+  dropped_frames?: number;
+  duplicate_frames?: number;
+}
+
+interface StreamMetricsBatchData {
+  full?: boolean;
+  streams: Record<string, StreamMetricsDelta>;
+  removed?: string[];
 }
 
 // Global SSE client instance
@@ -112,16 +118,18 @@ function setupGlobalSSE(): void {
     }
   });
 
-  globalClient.on<StreamMetricsData>('stream-metrics', (data) => {
-    const event: SSEStreamMetricsEvent = {
-      type: 'stream-metrics',
-      stream_id: data.stream_id,
-      ...(data.fps !== undefined && { fps: data.fps }),
-      ...(data.dropped_frames !== undefined && { dropped_frames: data.dropped_frames }),
-      ...(data.duplicate_frames !== undefined && { duplicate_frames: data.duplicate_frames }),
-    };
-    for (const handler of globalStreamMetricsHandlers) {
-      handler(event);
+  globalClient.on<StreamMetricsBatchData>('stream-metrics', (data) => {
+    for (const [streamId, delta] of Object.entries(data.streams ?? {})) {
+      const event: SSEStreamMetricsEvent = {
+        type: 'stream-metrics',
+        stream_id: streamId,
+        ...(delta.fps !== undefined && { fps: delta.fps.toFixed(2) }),
+        ...(delta.dropped_frames !== undefined && { dropped_frames: delta.dropped_frames.toFixed(0) }),
+        ...(delta.duplicate_frames !== undefined && { duplicate_frames: delta.duplicate_frames.toFixed(0) }),
+      };
+      for (const handler of globalStreamMetricsHandlers) {
+        handler(event);
+      }
     }
   });
 
@@ -177,6 +177,23 @@ export async function getStreams(): Promise<StreamListData> {
   return apiGet<StreamListData>('/api/streams');
 }
 
+// Streams with a live producer on this node and where each originates
+export interface LiveStreamData {
+  stream_id: string;
+  origin: 'local' | 'relay' | 'slate';
+  upstream?: string;
+  codecs: string[];
+}
+
+export interface LiveStreamListData {
+  streams: string[];
+  origins: LiveStreamData[];
+}
+
+export async function getLiveStreams(): Promise<LiveStreamListData> {
+  return apiGet<LiveStreamListData>('/api/streams/live');
+}
+
 export async function createStream(request: StreamRequestData): Promise<StreamData> {
   return apiPost<StreamData>('/api/streams', request);
 }
@@ -431,6 +448,29 @@ export async function restartStream(streamId: string): Promise<void> {
   await makeApiRequest(`/api/streams/${streamId}/restart`, { method: 'POST' });
 }
 
+// Stream metrics history, kept by the server for its last day
+export interface MetricsHistoryData {
+  stream_id: string;
+  resolution_seconds: number;
+  timestamps: number[];
+  series: Record<string, number[]>;
+}
+
+export async function getMetricsHistory(streamId: string, seconds: number, maxPoints = 300): Promise<MetricsHistoryData> {
+  const params = new URLSearchParams({ seconds: String(seconds), max_points: String(maxPoints) });
+  return apiGet<MetricsHistoryData>(`/api/streams/${encodeURIComponent(streamId)}/metrics/history?${params.toString()}`);
+}
+
+// Stream thumbnail URL for <img> tags, which can't send an Authorization
+// header. The server caches thumbnails for a few seconds; refresh busts the
+// browser cache between polls.
+export function buildThumbnailURL(streamId: string, refresh: number, width = 320): string | null {
+  const credentials = localStorage.getItem('auth_credentials');
+  if (!credentials) return null;
+  const params = new URLSearchParams({ width: String(width), auth: credentials, t: String(refresh) });
+  return `${API_BASE_URL}/api/streams/${encodeURIComponent(streamId)}/thumbnail?${params.toString()}`;
+}
+
 // WebRTC signaling - sends SDP offer, receives SDP answer
 // Auth is optional since the backend /api/webrtc endpoint is public
 export async function webrtcSignaling(streamId: string, offer: string, signal?: AbortSignal): Promise<string> {
@@ -463,4 +503,94 @@ export async function webrtcSignaling(streamId: string, offer: string, signal?:
   return response.text();
 }
 
+// Latency tracing - frame timings a player reports for a WebRTC session.
+// Times are Unix milliseconds on the server's clock.
+export interface LatencySampleReport {
+  rtp_timestamp: number;
+  received_at: number;
+  displayed_at: number;
+  decode_ms?: number;
+}
+
+export interface LatencyReport {
+  session_id: string;
+  stream_id?: string;
+  samples: LatencySampleReport[];
+}
+
+// Resolves with the server's clock in Unix milliseconds, for estimating the
+// browser's clock offset. Rejects when the server doesn't trace latency.
+export async function reportWebRTCLatency(report: LatencyReport): Promise<{ server_time: number }> {
+  const credentials = localStorage.getItem('auth_credentials');
+
+  const headers: HeadersInit = {
+    'Content-Type': 'application/json',
+  };
+
+  if (credentials) {
+    headers['Authorization'] = `Basic ${credentials}`;
+  }
+
+  const response = await fetch(`${API_BASE_URL}/api/webrtc/latency`, {
+    method: 'POST',
+    headers,
+    body: JSON.stringify(report),
+  });
+  if (!response.ok) {
+    throw new ApiError(response.status, `Latency report failed: ${response.statusText}`);
+  }
+  return response.json();
+}
+
+// WebRTC bundle signaling - several streams over one PeerConnection.
+// The k-th video m-line of the offer plays streamIds[k]; empty entries leave
+// a slot unused. Returns the session URL for renegotiation and the SDP answer.
+async function bundleSdpRequest(url: string, method: 'POST' | 'PUT', offer: string): Promise<Response> {
+  const credentials = localStorage.getItem('auth_credentials');
+
+  const headers: HeadersInit = {
+    'Content-Type': 'application/sdp',
+  };
+
+  if (credentials) {
+    headers['Authorization'] = `Basic ${credentials}`;
+  }
+
+  const response = await fetch(url, { method, headers, body: offer });
+  if (!response.ok) {
+    throw new ApiError(response.status, `WebRTC bundle signaling failed: ${response.statusText}`);
+  }
+  return response;
+}
+
+function bundleStreamsParam(streamIds: readonly string[]): string {
+  return `streams=${streamIds.map(encodeURIComponent).join(',')}`;
+}
+
+export async function webrtcBundleSignaling(
+  streamIds: readonly string[],
+  offer: string
+): Promise<{ sessionUrl: string; answer: string }> {
+  const response = await bundleSdpRequest(
+    `${API_BASE_URL}/api/webrtc/bundle?${bundleStreamsParam(streamIds)}`,
+    'POST',
+    offer
+  );
+  const location = response.headers.get('Location') ?? '';
+  return { sessionUrl: `${API_BASE_URL}${location}`, answer: await response.text() };
+}
+
+export async function webrtcBundleRenegotiate(
+  sessionUrl: string,
+  streamIds: readonly string[],
+  offer: string
+): Promise<string> {
+  const response = await bundleSdpRequest(`${sessionUrl}?${bundleStreamsParam(streamIds)}`, 'PUT', offer);
+  return response.text();
+}
+
+export async function closeWebRTCBundle(sessionUrl: string): Promise<void> {
+  await fetch(sessionUrl, { method: 'DELETE' }).catch(() => undefined);
+}
+
 export type SSEEvent = SSEDeviceDiscoveryEvent | SSEStreamLifecycleEvent | SSEStreamMetricsEvent;
\ No newline at end of file
@@ -12,6 +12,8 @@ export interface SSEClientConfig {
   onStatusChange?: (status: SSEStatus) => void;
   onConnect?: () => void;
   onError?: (willReconnect: boolean) => void;
+  // Extra query parameters, evaluated on every (re)connect
+  query?: () => Record<string, string>;
 }
 
 type MessageHandler = (event: MessageEvent) => void;
@@ -38,7 +40,8 @@ export class SSEClient {
 
     this.setStatus('connecting');
 
-    const sseUrl = `${API_BASE_URL}${this.config.endpoint}?auth=${encodeURIComponent(credentials)}`;
+    const params = new URLSearchParams({ ...this.config.query?.(), auth: credentials });
+    const sseUrl = `${API_BASE_URL}${this.config.endpoint}?${params.toString()}`;
     this.eventSource = new EventSource(sseUrl);
 
     this.eventSource.onopen = () => {
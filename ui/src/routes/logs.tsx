@@ -51,6 +51,7 @@ function loadLogSettings(): LogSettings {
 }
 
 interface LogEventData {
+  seq: number;
   timestamp: string;
   level: string;
   module: string;
@@ -62,6 +63,7 @@ function isLogEventData(data: unknown): data is LogEventData {
   return (
     typeof data === 'object' &&
     data !== null &&
+    'seq' in data &&
     'timestamp' in data &&
     'level' in data &&
     'module' in data &&
@@ -98,7 +100,8 @@ function mapConnectionStatus(status: SSEStatus): 'connecting' | 'connected' | 'd
 export default function Logs() {
   const { logout } = useAuthStore();
   const scrollRef = useRef<HTMLDivElement>(null);
-  const newestTimestampRef = useRef<string>('');
+  // Sequence number of the newest server log entry, used to resume the stream
+  const lastSeqRef = useRef(0);
 
   // Core state
   const [logs, setLogs] = useState<LogEntry[]>([]);
@@ -120,19 +123,11 @@ export default function Logs() {
 
   // Flush buffer to state
   const flushBuffer = useCallback(() => {
-    const buffer = bufferRef.current;
-    // Filter out duplicates: keep logs newer than last seen
-    const toFlush = buffer.filter(log =>
-      !newestTimestampRef.current || log.timestamp > newestTimestampRef.current
-    );
+    const toFlush = bufferRef.current;
     bufferRef.current = [];
     flushTimeoutRef.current = null;
 
     if (toFlush.length > 0) {
-      const timestamps = toFlush.map(log => log.timestamp).filter(t => t);
-      if (timestamps.length > 0) {
-        newestTimestampRef.current = timestamps.reduce((a, b) => a > b ? a : b, '');
-      }
       setLogs(prev => [...prev, ...toFlush].slice(-MAX_LOGS));
     }
   }, []);
@@ -146,6 +141,8 @@ export default function Logs() {
   // SSE connection using the abstracted hook
   const { status } = useSSE({
     endpoint: '/api/logs/stream',
+    // Resume after the last entry we have, the server only sends newer ones
+    query: () => (lastSeqRef.current > 0 ? { since: String(lastSeqRef.current) } : {}),
     onConnect: () => {
       // Inject synthetic log entry to mark connection
       bufferRef.current.push({
@@ -165,6 +162,7 @@ export default function Logs() {
           console.error('Invalid log data format:', event.data);
           return;
         }
+        lastSeqRef.current = data.seq;
         bufferRef.current.push({
           id: String(++idCounterRef.current),
           timestamp: data.timestamp,
@@ -8,6 +8,7 @@ import { useSSEManager } from '../hooks/useSSEManager';
 import { DashboardLayout } from '../components/DashboardLayout';
 import { InfoBar } from '../components/InfoBar';
 import { StreamsGrid } from '../components/StreamsGrid';
+import { RelayedStreams } from '../components/RelayedStreams';
 import {
   SSEStreamLifecycleEvent,
   SSEStreamMetricsEvent
@@ -106,6 +107,7 @@ export default function Streams() {
           onDeleteStream={handleDeleteStream}
           onCreateStream={handleCreateStream}
         />
+        <RelayedStreams />
       </DashboardLayout.MainContent>
     </DashboardLayout>
   );